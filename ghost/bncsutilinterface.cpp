@@ -24,30 +24,199 @@
 
 #include <bncsutil/bncsutil.h>
 
+#include <boost/bind.hpp>
+#include <boost/filesystem.hpp>
+
+//
+// CCheckRevisionCache
+//
+
+CCheckRevisionCache :: CCheckRevisionCache( string nFile )
+{
+	m_File = nFile;
+
+	if( m_File.empty( ) )
+		return;
+
+	// each line is: key <tab> exe version <tab> exe version hash <tab> exe info
+
+	ifstream in;
+	in.open( m_File.c_str( ) );
+
+	if( in.fail( ) )
+		return;
+
+	string Line;
+
+	while( getline( in, Line ) )
+	{
+		vector<string> Fields;
+		string :: size_type Start = 0;
+		string :: size_type Tab;
+
+		while( ( Tab = Line.find( '\t', Start ) ) != string :: npos )
+		{
+			Fields.push_back( Line.substr( Start, Tab - Start ) );
+			Start = Tab + 1;
+		}
+
+		Fields.push_back( Line.substr( Start ) );
+
+		if( Fields.size( ) != 4 )
+			continue;
+
+		CCheckRevisionResult Result;
+		Result.m_EXEVersion = UTIL_ToUInt32( Fields[1] );
+		Result.m_EXEVersionHash = UTIL_ToUInt32( Fields[2] );
+		Result.m_EXEInfo = Fields[3];
+		m_Results[Fields[0]] = Result;
+	}
+
+	in.close( );
+	CONSOLE_Print( "[BNCSUI] loaded " + UTIL_ToString( m_Results.size( ) ) + " cached revision checks from [" + m_File + "]" );
+}
+
+CCheckRevisionCache :: ~CCheckRevisionCache( )
+{
+
+}
+
+bool CCheckRevisionCache :: Get( string key, CCheckRevisionResult &result )
+{
+	boost :: mutex :: scoped_lock Lock( m_Mutex );
+	map<string, CCheckRevisionResult> :: iterator i = m_Results.find( key );
+
+	if( i == m_Results.end( ) )
+		return false;
+
+	result = i->second;
+	return true;
+}
+
+void CCheckRevisionCache :: Put( string key, CCheckRevisionResult &result )
+{
+	boost :: mutex :: scoped_lock Lock( m_Mutex );
+
+	// battle.net only uses a handful of formulas per MPQ so the cache shouldn't grow much, but don't let a misbehaving server fill the disk
+
+	if( m_Results.size( ) >= 4096 || m_Results.find( key ) != m_Results.end( ) || result.m_EXEInfo.find_first_of( "\t\r\n" ) != string :: npos )
+		return;
+
+	m_Results[key] = result;
+
+	if( m_File.empty( ) )
+		return;
+
+	ofstream out;
+	out.open( m_File.c_str( ), ios :: app );
+
+	if( out.fail( ) )
+		return;
+
+	out << key << "\t" << result.m_EXEVersion << "\t" << result.m_EXEVersionHash << "\t" << result.m_EXEInfo << endl;
+	out.close( );
+}
+
 //
 // CBNCSUtilInterface
 //
 
-CBNCSUtilInterface :: CBNCSUtilInterface( string userName, string userPassword )
+CBNCSUtilInterface :: CBNCSUtilInterface( string userName, string userPassword, CCheckRevisionCache *nCache )
 {
 	// m_nls = (void *)nls_init( userName.c_str( ), userPassword.c_str( ) );
 	m_NLS = new NLS( userName, userPassword );
+	m_Cache = nCache;
+	m_Thread = NULL;
+	m_Job = BNCSUTIL_JOB_NONE;
+	m_JobResult = false;
+	m_JobReady = false;
 }
 
 CBNCSUtilInterface :: ~CBNCSUtilInterface( )
 {
+	WaitForJob( );
+
 	// nls_free( (nls_t *)m_nls );
 	delete (NLS *)m_NLS;
 }
 
 void CBNCSUtilInterface :: Reset( string userName, string userPassword )
 {
+	// the helper thread might be using m_NLS so we have to wait for it to finish
+	// this only blocks if we were disconnected in the middle of logging in
+
+	WaitForJob( );
+
 	// nls_free( (nls_t *)m_nls );
 	// m_nls = (void *)nls_init( userName.c_str( ), userPassword.c_str( ) );
 	delete (NLS *)m_NLS;
 	m_NLS = new NLS( userName, userPassword );
 }
 
+void CBNCSUtilInterface :: StartSID_AUTH_CHECK( bool TFT, string war3Path, string keyROC, string keyTFT, string valueStringFormula, string mpqFileName, BYTEARRAY clientToken, BYTEARRAY serverToken )
+{
+	StartJob( BNCSUTIL_JOB_SID_AUTH_CHECK, boost :: bind( &CBNCSUtilInterface :: HELP_SID_AUTH_CHECK, this, TFT, war3Path, keyROC, keyTFT, valueStringFormula, mpqFileName, clientToken, serverToken ) );
+}
+
+void CBNCSUtilInterface :: StartSID_AUTH_ACCOUNTLOGON( )
+{
+	StartJob( BNCSUTIL_JOB_SID_AUTH_ACCOUNTLOGON, boost :: bind( &CBNCSUtilInterface :: HELP_SID_AUTH_ACCOUNTLOGON, this ) );
+}
+
+void CBNCSUtilInterface :: StartSID_AUTH_ACCOUNTLOGONPROOF( BYTEARRAY salt, BYTEARRAY serverKey )
+{
+	StartJob( BNCSUTIL_JOB_SID_AUTH_ACCOUNTLOGONPROOF, boost :: bind( &CBNCSUtilInterface :: HELP_SID_AUTH_ACCOUNTLOGONPROOF, this, salt, serverKey ) );
+}
+
+uint32_t CBNCSUtilInterface :: GetFinishedJob( bool *result )
+{
+	if( m_Job == BNCSUTIL_JOB_NONE || !m_JobReady )
+		return BNCSUTIL_JOB_NONE;
+
+	uint32_t Job = m_Job;
+	WaitForJob( );
+	*result = m_JobResult;
+	return Job;
+}
+
+void CBNCSUtilInterface :: StartJob( uint32_t job, boost :: function<bool( )> function )
+{
+	WaitForJob( );
+	m_Job = job;
+	m_JobResult = false;
+	m_JobReady = false;
+
+	try
+	{
+		m_Thread = new boost :: thread( boost :: bind( &CBNCSUtilInterface :: RunJob, this, function ) );
+	}
+	catch( boost :: thread_resource_error & )
+	{
+		// we couldn't create a thread so just do the work on the main thread
+
+		CONSOLE_Print( "[BNCSUI] error spawning helper thread, running on the main thread" );
+		RunJob( function );
+	}
+}
+
+void CBNCSUtilInterface :: RunJob( boost :: function<bool( )> function )
+{
+	m_JobResult = function( );
+	m_JobReady = true;
+}
+
+void CBNCSUtilInterface :: WaitForJob( )
+{
+	if( m_Thread )
+	{
+		m_Thread->join( );
+		delete m_Thread;
+		m_Thread = NULL;
+	}
+
+	m_Job = BNCSUTIL_JOB_NONE;
+}
+
 bool CBNCSUtilInterface :: HELP_SID_AUTH_CHECK( bool TFT, string war3Path, string keyROC, string keyTFT, string valueStringFormula, string mpqFileName, BYTEARRAY clientToken, BYTEARRAY serverToken )
 {
 	// set m_EXEVersion, m_EXEVersionHash, m_EXEInfo, m_InfoROC, m_InfoTFT
@@ -65,16 +234,38 @@ bool CBNCSUtilInterface :: HELP_SID_AUTH_CHECK( bool TFT, string war3Path, strin
 
 	if( ExistsWar3EXE && ExistsStormDLL && ExistsGameDLL )
 	{
-		// todotodo: check getExeInfo return value to ensure 1024 bytes was enough
-
-		char buf[1024];
-		uint32_t EXEVersion;
-		getExeInfo( FileWar3EXE.c_str( ), (char *)&buf, 1024, (uint32_t *)&EXEVersion, BNCSUTIL_PLATFORM_X86 );
-		m_EXEInfo = buf;
-		m_EXEVersion = UTIL_CreateByteArray( EXEVersion, false );
-		uint32_t EXEVersionHash;
-		checkRevisionFlat( valueStringFormula.c_str( ), FileWar3EXE.c_str( ), FileStormDLL.c_str( ), FileGameDLL.c_str( ), extractMPQNumber( mpqFileName.c_str( ) ), (unsigned long *)&EXEVersionHash );
-		m_EXEVersionHash = UTIL_CreateByteArray( EXEVersionHash, false );
+		int MPQNumber = extractMPQNumber( mpqFileName.c_str( ) );
+		string KeyWar3EXE = GetFileKey( FileWar3EXE );
+		string KeyStormDLL = GetFileKey( FileStormDLL );
+		string KeyGameDLL = GetFileKey( FileGameDLL );
+		string Key = valueStringFormula + "|" + UTIL_ToString( MPQNumber ) + "|" + KeyWar3EXE + "|" + KeyStormDLL + "|" + KeyGameDLL;
+		bool UseCache = m_Cache && !KeyWar3EXE.empty( ) && !KeyStormDLL.empty( ) && !KeyGameDLL.empty( ) && Key.find_first_of( "\t\r\n" ) == string :: npos;
+		CCheckRevisionResult Result;
+
+		if( UseCache && m_Cache->Get( Key, Result ) )
+			CONSOLE_Print( "[BNCSUI] using cached revision check" );
+		else
+		{
+			// todotodo: check getExeInfo return value to ensure 1024 bytes was enough
+
+			char buf[1024];
+			uint32_t EXEVersion;
+			getExeInfo( FileWar3EXE.c_str( ), (char *)&buf, 1024, (uint32_t *)&EXEVersion, BNCSUTIL_PLATFORM_X86 );
+			unsigned long EXEVersionHash = 0;
+			int Success = checkRevisionFlat( valueStringFormula.c_str( ), FileWar3EXE.c_str( ), FileStormDLL.c_str( ), FileGameDLL.c_str( ), MPQNumber, &EXEVersionHash );
+			Result.m_EXEVersion = EXEVersion;
+			Result.m_EXEVersionHash = (uint32_t)EXEVersionHash;
+			Result.m_EXEInfo = buf;
+
+			// only cache successful revision checks, a failure might be temporary (e.g. the files are being patched)
+
+			if( UseCache && Success )
+				m_Cache->Put( Key, Result );
+		}
+
+		m_EXEInfo = Result.m_EXEInfo;
+		m_EXEVersion = UTIL_CreateByteArray( Result.m_EXEVersion, false );
+		m_EXEVersionHash = UTIL_CreateByteArray( Result.m_EXEVersionHash, false );
 		m_KeyInfoROC = CreateKeyInfo( keyROC, UTIL_ByteArrayToUInt32( clientToken, false ), UTIL_ByteArrayToUInt32( serverToken, false ) );
 
 		if( TFT )
@@ -138,6 +329,21 @@ bool CBNCSUtilInterface :: HELP_PvPGNPasswordHash( string userPassword )
 	return true;
 }
 
+string CBNCSUtilInterface :: GetFileKey( string file )
+{
+	// identify a file by its name, modification time and size (returns an empty string if the file can't be examined)
+
+	try
+	{
+		boost :: filesystem :: path FilePath( file );
+		return file + ":" + UTIL_ToString( (unsigned long)boost :: filesystem :: last_write_time( FilePath ) ) + ":" + UTIL_ToString( (unsigned long)boost :: filesystem :: file_size( FilePath ) );
+	}
+	catch( const exception & )
+	{
+		return string( );
+	}
+}
+
 BYTEARRAY CBNCSUtilInterface :: CreateKeyInfo( string key, uint32_t clientToken, uint32_t serverToken )
 {
 	unsigned char Zeros[] = { 0, 0, 0, 0 };
@@ -21,14 +21,64 @@
 #ifndef BNCSUTIL_INTERFACE_H
 #define BNCSUTIL_INTERFACE_H
 
+#include <boost/atomic.hpp>
+#include <boost/function.hpp>
+#include <boost/thread.hpp>
+
+//
+// CCheckRevisionCache
+//
+
+// the revision check reads and hashes war3.exe, storm.dll and game.dll which takes anywhere from 100ms to a few seconds
+// the result only depends on the value string formula, the MPQ number and the files themselves so we remember it (in memory and on disk)
+// the key includes the modification time and size of each file so patching Warcraft III invalidates the cache automatically
+// note: this is shared by every realm and used from the helper threads so everything is protected by a mutex
+
+class CCheckRevisionResult
+{
+public:
+	uint32_t m_EXEVersion;
+	uint32_t m_EXEVersionHash;
+	string m_EXEInfo;
+};
+
+class CCheckRevisionCache
+{
+private:
+	boost :: mutex m_Mutex;
+	string m_File;									// the cache file (empty = don't save the cache to disk)
+	map<string, CCheckRevisionResult> m_Results;	// the cached results keyed by the formula, the MPQ number, and each file's modification time and size
+
+public:
+	CCheckRevisionCache( string nFile );
+	~CCheckRevisionCache( );
+
+	bool Get( string key, CCheckRevisionResult &result );
+	void Put( string key, CCheckRevisionResult &result );
+};
+
 //
 // CBNCSUtilInterface
 //
 
+// the revision check and the NLS (SRP) calculations can each take long enough to stall every game so they run on a helper thread
+// the caller starts a job with one of the Start* functions and polls GetFinishedJob every update
+// only one job can be running at a time, the results are available through the usual getters once the job has finished
+
+#define BNCSUTIL_JOB_NONE						0
+#define BNCSUTIL_JOB_SID_AUTH_CHECK				1
+#define BNCSUTIL_JOB_SID_AUTH_ACCOUNTLOGON		2
+#define BNCSUTIL_JOB_SID_AUTH_ACCOUNTLOGONPROOF	3
+
 class CBNCSUtilInterface
 {
 private:
 	void *m_NLS;
+	CCheckRevisionCache *m_Cache;	// the shared revision check cache (may be NULL)
+	boost :: thread *m_Thread;		// the helper thread running the current job
+	uint32_t m_Job;					// the current job (BNCSUTIL_JOB_*)
+	bool m_JobResult;				// the return value of the current job's HELP_ function
+	boost :: atomic<bool> m_JobReady;	// set by the helper thread when the current job has finished
 	BYTEARRAY m_EXEVersion;			// set in HELP_SID_AUTH_CHECK
 	BYTEARRAY m_EXEVersionHash;		// set in HELP_SID_AUTH_CHECK
 	string m_EXEInfo;				// set in HELP_SID_AUTH_CHECK
@@ -39,7 +89,7 @@ private:
 	BYTEARRAY m_PvPGNPasswordHash;	// set in HELP_PvPGNPasswordHash
 
 public:
-	CBNCSUtilInterface( string userName, string userPassword );
+	CBNCSUtilInterface( string userName, string userPassword, CCheckRevisionCache *nCache );
 	~CBNCSUtilInterface( );
 
 	BYTEARRAY GetEXEVersion( )								{ return m_EXEVersion; }
@@ -56,6 +106,14 @@ public:
 
 	void Reset( string userName, string userPassword );
 
+	// asynchronous versions of the HELP_ functions below
+
+	void StartSID_AUTH_CHECK( bool TFT, string war3Path, string keyROC, string keyTFT, string valueStringFormula, string mpqFileName, BYTEARRAY clientToken, BYTEARRAY serverToken );
+	void StartSID_AUTH_ACCOUNTLOGON( );
+	void StartSID_AUTH_ACCOUNTLOGONPROOF( BYTEARRAY salt, BYTEARRAY serverKey );
+	uint32_t GetFinishedJob( bool *result );
+	bool GetBusy( )											{ return m_Job != BNCSUTIL_JOB_NONE; }
+
 	bool HELP_SID_AUTH_CHECK( bool TFT, string war3Path, string keyROC, string keyTFT, string valueStringFormula, string mpqFileName, BYTEARRAY clientToken, BYTEARRAY serverToken );
 	bool HELP_SID_AUTH_ACCOUNTLOGON( );
 	bool HELP_SID_AUTH_ACCOUNTLOGONPROOF( BYTEARRAY salt, BYTEARRAY serverKey );
@@ -63,6 +121,10 @@ public:
 
 private:
 	BYTEARRAY CreateKeyInfo( string key, uint32_t clientToken, uint32_t serverToken );
+	string GetFileKey( string file );
+	void StartJob( uint32_t job, boost :: function<bool( )> function );
+	void RunJob( boost :: function<bool( )> function );
+	void WaitForJob( );
 };
 
 #endif
@@ -28,13 +28,16 @@
 #include "bncsutilinterface.h"
 #include "bnlsclient.h"
 #include "bnetprotocol.h"
+#include "floodcontrol.h"
 #include "bnet.h"
 #include "map.h"
 #include "packed.h"
 #include "savegame.h"
 #include "replay.h"
 #include "gameprotocol.h"
+#include "timerwheel.h"
 #include "game_base.h"
+#include "summarycache.h"
 
 #include <boost/filesystem.hpp>
 
@@ -52,7 +55,7 @@ CBNET :: CBNET( CGHost *nGHost, string nServer, string nServerAlias, string nBNL
 	m_Socket = new CTCPClient( );
 	m_Protocol = new CBNETProtocol( );
 	m_BNLSClient = NULL;
-	m_BNCSUtil = new CBNCSUtilInterface( nUserName, nUserPassword );
+	m_BNCSUtil = new CBNCSUtilInterface( nUserName, nUserPassword, m_GHost->m_CheckRevisionCache );
 	m_Exiting = false;
 	m_Server = nServer;
 	string LowerServer = m_Server;
@@ -120,7 +123,9 @@ CBNET :: CBNET( CGHost *nGHost, string nServer, string nServerAlias, string nBNL
 	m_LastConnectionAttemptTime = 0;
 	m_LastNullTime = 0;
 	m_LastOutPacketTicks = 0;
-	m_LastOutPacketSize = 0;
+	m_NextOutPacketHandle = 1;
+	m_NextOutPacketSequence = 0;
+	m_FloodControl = new CFloodControl( m_GHost->m_BNETFloodRate, m_GHost->m_BNETFloodBurst, m_GHost->m_BNETFloodOverhead, GetTicks( ) );
 	m_LastAdminRefreshTime = GetTime( );
 	m_LastBanRefreshTime = GetTime( );
 	m_FirstConnect = true;
@@ -145,18 +150,13 @@ CBNET :: ~CBNET( )
 	}
 
 	delete m_BNCSUtil;
+	delete m_FloodControl;
 
 	for( vector<CIncomingFriendList *> :: iterator i = m_Friends.begin( ); i != m_Friends.end( ); i++ )
 		delete *i;
 
 	for( vector<CIncomingClanList *> :: iterator i = m_Clans.begin( ); i != m_Clans.end( ); i++ )
 		delete *i;
-
-	for( vector<PairedGPSCheck> :: iterator i = m_PairedGPSChecks.begin( ); i != m_PairedGPSChecks.end( ); i++ )
-		m_GHost->m_Callables.push_back( i->second );
-
-	for( vector<PairedDPSCheck> :: iterator i = m_PairedDPSChecks.begin( ); i != m_PairedDPSChecks.end( ); i++ )
-		m_GHost->m_Callables.push_back( i->second );
 }
 
 BYTEARRAY CBNET :: GetUniqueName( )
@@ -188,17 +188,15 @@ bool CBNET :: Update( void *fd, void *send_fd )
     
 	for( vector<PairedGPSCheck> :: iterator i = m_PairedGPSChecks.begin( ); i != m_PairedGPSChecks.end( ); )
 	{
-		if( i->second->GetReady( ) )
-		{
-			CDBGamePlayerSummary *GamePlayerSummary = i->second->GetResult( );
+		CDBGamePlayerSummary *GamePlayerSummary = NULL;
 
+		if( m_GHost->m_SummaryCache->GetGamePlayerSummary( i->second, &GamePlayerSummary ) == SUMMARY_READY )
+		{
 			if( GamePlayerSummary )
-				QueueChatCommand( m_GHost->m_Language->HasPlayedGamesWithThisBot( i->second->GetName( ), GamePlayerSummary->GetFirstGameDateTime( ), GamePlayerSummary->GetLastGameDateTime( ), UTIL_ToString( GamePlayerSummary->GetTotalGames( ) ), UTIL_ToString( (float)GamePlayerSummary->GetAvgLoadingTime( ) / 1000, 2 ), UTIL_ToString( GamePlayerSummary->GetAvgLeftPercent( ) ) ), i->first, !i->first.empty( ) );
+				QueueChatCommand( m_GHost->m_Language->HasPlayedGamesWithThisBot( i->second, GamePlayerSummary->GetFirstGameDateTime( ), GamePlayerSummary->GetLastGameDateTime( ), UTIL_ToString( GamePlayerSummary->GetTotalGames( ) ), UTIL_ToString( (float)GamePlayerSummary->GetAvgLoadingTime( ) / 1000, 2 ), UTIL_ToString( GamePlayerSummary->GetAvgLeftPercent( ) ) ), i->first, !i->first.empty( ) );
 			else
-				QueueChatCommand( m_GHost->m_Language->HasntPlayedGamesWithThisBot( i->second->GetName( ) ), i->first, !i->first.empty( ) );
+				QueueChatCommand( m_GHost->m_Language->HasntPlayedGamesWithThisBot( i->second ), i->first, !i->first.empty( ) );
 
-			m_GHost->m_DB->RecoverCallable( i->second );
-			delete i->second;
 			i = m_PairedGPSChecks.erase( i );
 		}
 		else
@@ -207,13 +205,13 @@ bool CBNET :: Update( void *fd, void *send_fd )
 
 	for( vector<PairedDPSCheck> :: iterator i = m_PairedDPSChecks.begin( ); i != m_PairedDPSChecks.end( ); )
 	{
-		if( i->second->GetReady( ) )
-		{
-			CDBDotAPlayerSummary *DotAPlayerSummary = i->second->GetResult( );
+		CDBDotAPlayerSummary *DotAPlayerSummary = NULL;
 
+		if( m_GHost->m_SummaryCache->GetDotAPlayerSummary( i->second, &DotAPlayerSummary ) == SUMMARY_READY )
+		{
 			if( DotAPlayerSummary )
 			{
-				string Summary = m_GHost->m_Language->HasPlayedDotAGamesWithThisBot(	i->second->GetName( ),
+				string Summary = m_GHost->m_Language->HasPlayedDotAGamesWithThisBot(	i->second,
 																						UTIL_ToString( DotAPlayerSummary->GetTotalGames( ) ),
 																						UTIL_ToString( DotAPlayerSummary->GetTotalWins( ) ),
 																						UTIL_ToString( DotAPlayerSummary->GetTotalLosses( ) ),
@@ -239,10 +237,8 @@ bool CBNET :: Update( void *fd, void *send_fd )
 				QueueChatCommand( Summary, i->first, !i->first.empty( ) );
 			}
 			else
-				QueueChatCommand( m_GHost->m_Language->HasntPlayedDotAGamesWithThisBot( i->second->GetName( ) ), i->first, !i->first.empty( ) );
+				QueueChatCommand( m_GHost->m_Language->HasntPlayedDotAGamesWithThisBot( i->second ), i->first, !i->first.empty( ) );
 
-			m_GHost->m_DB->RecoverCallable( i->second );
-			delete i->second;
 			i = m_PairedDPSChecks.erase( i );
 		}
 		else
@@ -300,6 +296,7 @@ bool CBNET :: Update( void *fd, void *send_fd )
 		m_Socket->DoRecv( (fd_set *)fd );
 		ExtractPackets( );
 		ProcessPackets( );
+		UpdateBNCSUtil( );
 
 		// update the BNLS client
 
@@ -320,34 +317,35 @@ bool CBNET :: Update( void *fd, void *send_fd )
 			}
 		}
 
-		// check if at least one packet is waiting to be sent and if we've waited long enough to prevent flooding
-		// this formula has changed many times but currently we wait 1 second if the last packet was "small", 3.5 seconds if it was "medium", and 4 seconds if it was "big"
+		// send queued packets in priority order for as long as the flood control token bucket allows it
+		// every packet costs its size plus a fixed overhead so a few short messages can be sent quickly but long messages are spaced out (see CFloodControl)
 
-		uint32_t WaitTicks = 0;
+		m_FloodControl->Refill( GetTicks( ) );
 
-		if( m_LastOutPacketSize < 10 )
-			WaitTicks = 1000;
-		else if( m_LastOutPacketSize < 100 )
-			WaitTicks = 3500;
-		else
-			WaitTicks = 4000;
+		CQueuedBNETPacket *Packet = GetNextOutPacket( );
 
-		if( !m_OutPackets.empty( ) && GetTicks( ) - m_LastOutPacketTicks >= WaitTicks )
+		while( Packet )
 		{
-			if( m_OutPackets.size( ) > 7 )
-				CONSOLE_Print( "[BNET: " + m_ServerAlias + "] packet queue warning - there are " + UTIL_ToString( m_OutPackets.size( ) ) + " packets waiting to be sent" );
+			if( !m_FloodControl->CanSend( ) )
+				break;
+
+			if( GetOutPacketsQueued( ) > 7 )
+				CONSOLE_Print( "[BNET: " + m_ServerAlias + "] packet queue warning - there are " + UTIL_ToString( GetOutPacketsQueued( ) ) + " packets waiting to be sent" );
 
-			m_Socket->PutBytes( m_OutPackets.front( ) );
-			m_LastOutPacketSize = m_OutPackets.front( ).size( );
-			m_OutPackets.pop( );
+			m_Socket->PutBytes( Packet->m_Packet );
+			m_FloodControl->Sent( Packet->m_Packet.size( ) );
 			m_LastOutPacketTicks = GetTicks( );
+			UnqueuePacket( Packet->m_Handle );
+			Packet = GetNextOutPacket( );
 		}
 
 		// send a null packet every 60 seconds to detect disconnects
 
 		if( GetTime( ) - m_LastNullTime >= 60 && GetTicks( ) - m_LastOutPacketTicks >= 60000 )
 		{
-			m_Socket->PutBytes( m_Protocol->SEND_SID_NULL( ) );
+			BYTEARRAY NullPacket = m_Protocol->SEND_SID_NULL( );
+			m_Socket->PutBytes( NullPacket );
+			m_FloodControl->Sent( NullPacket.size( ) );
 			m_LastNullTime = GetTime( );
 		}
 
@@ -370,9 +368,8 @@ bool CBNET :: Update( void *fd, void *send_fd )
 			m_Socket->DoSend( (fd_set *)send_fd );
 			m_LastNullTime = GetTime( );
 			m_LastOutPacketTicks = GetTicks( );
-
-			while( !m_OutPackets.empty( ) )
-				m_OutPackets.pop( );
+			m_FloodControl->Reset( GetTicks( ) );
+			ClearOutPackets( );
 
 			return m_Exiting;
 		}
@@ -556,48 +553,9 @@ void CBNET :: ProcessPackets( )
 			case CBNETProtocol :: SID_AUTH_INFO:
 				if( m_Protocol->RECEIVE_SID_AUTH_INFO( Packet->GetData( ) ) )
 				{
-					if( m_BNCSUtil->HELP_SID_AUTH_CHECK( m_GHost->m_TFT, m_GHost->m_Warcraft3Path, m_CDKeyROC, m_CDKeyTFT, m_Protocol->GetValueStringFormulaString( ), m_Protocol->GetIX86VerFileNameString( ), m_Protocol->GetClientToken( ), m_Protocol->GetServerToken( ) ) )
-					{
-						// override the exe information generated by bncsutil if specified in the config file
-						// apparently this is useful for pvpgn users
-
-						if( m_EXEVersion.size( ) == 4 )
-						{
-							CONSOLE_Print( "[BNET: " + m_ServerAlias + "] using custom exe version bnet_custom_exeversion = " + UTIL_ToString( m_EXEVersion[0] ) + " " + UTIL_ToString( m_EXEVersion[1] ) + " " + UTIL_ToString( m_EXEVersion[2] ) + " " + UTIL_ToString( m_EXEVersion[3] ) );
-							m_BNCSUtil->SetEXEVersion( m_EXEVersion );
-						}
-
-						if( m_EXEVersionHash.size( ) == 4 )
-						{
-							CONSOLE_Print( "[BNET: " + m_ServerAlias + "] using custom exe version hash bnet_custom_exeversionhash = " + UTIL_ToString( m_EXEVersionHash[0] ) + " " + UTIL_ToString( m_EXEVersionHash[1] ) + " " + UTIL_ToString( m_EXEVersionHash[2] ) + " " + UTIL_ToString( m_EXEVersionHash[3] ) );
-							m_BNCSUtil->SetEXEVersionHash( m_EXEVersionHash );
-						}
-
-						if( m_GHost->m_TFT )
-							CONSOLE_Print( "[BNET: " + m_ServerAlias + "] attempting to auth as Warcraft III: The Frozen Throne" );
-						else
-							CONSOLE_Print( "[BNET: " + m_ServerAlias + "] attempting to auth as Warcraft III: Reign of Chaos" );							
-
-						m_Socket->PutBytes( m_Protocol->SEND_SID_AUTH_CHECK( m_GHost->m_TFT, m_Protocol->GetClientToken( ), m_BNCSUtil->GetEXEVersion( ), m_BNCSUtil->GetEXEVersionHash( ), m_BNCSUtil->GetKeyInfoROC( ), m_BNCSUtil->GetKeyInfoTFT( ), m_BNCSUtil->GetEXEInfo( ), "GHost" ) );
-
-						// the Warden seed is the first 4 bytes of the ROC key hash
-						// initialize the Warden handler
-
-						if( !m_BNLSServer.empty( ) )
-						{
-							CONSOLE_Print( "[BNET: " + m_ServerAlias + "] creating BNLS client" );
-							delete m_BNLSClient;
-							m_BNLSClient = new CBNLSClient( m_BNLSServer, m_BNLSPort, m_BNLSWardenCookie );
-							m_BNLSClient->QueueWardenSeed( UTIL_ByteArrayToUInt32( m_BNCSUtil->GetKeyInfoROC( ), false, 16 ) );
-						}
-					}
-					else
-					{
-						CONSOLE_Print( "[BNET: " + m_ServerAlias + "] logon failed - bncsutil key hash failed (check your Warcraft 3 path and cd keys), disconnecting" );
-						m_Socket->Disconnect( );
-						delete Packet;
-						return;
-					}
+					// the revision check runs on a helper thread, see UpdateBNCSUtil for the rest
+
+					m_BNCSUtil->StartSID_AUTH_CHECK( m_GHost->m_TFT, m_GHost->m_Warcraft3Path, m_CDKeyROC, m_CDKeyTFT, m_Protocol->GetValueStringFormulaString( ), m_Protocol->GetIX86VerFileNameString( ), m_Protocol->GetClientToken( ), m_Protocol->GetServerToken( ) );
 				}
 
 				break;
@@ -608,8 +566,7 @@ void CBNET :: ProcessPackets( )
 					// cd keys accepted
 
 					CONSOLE_Print( "[BNET: " + m_ServerAlias + "] cd keys accepted" );
-					m_BNCSUtil->HELP_SID_AUTH_ACCOUNTLOGON( );
-					m_Socket->PutBytes( m_Protocol->SEND_SID_AUTH_ACCOUNTLOGON( m_BNCSUtil->GetClientKey( ), m_UserName ) );
+					m_BNCSUtil->StartSID_AUTH_ACCOUNTLOGON( );
 				}
 				else
 				{
@@ -659,8 +616,7 @@ void CBNET :: ProcessPackets( )
 						// battle.net logon
 
 						CONSOLE_Print( "[BNET: " + m_ServerAlias + "] using battle.net logon type (for official battle.net servers only)" );
-						m_BNCSUtil->HELP_SID_AUTH_ACCOUNTLOGONPROOF( m_Protocol->GetSalt( ), m_Protocol->GetServerPublicKey( ) );
-						m_Socket->PutBytes( m_Protocol->SEND_SID_AUTH_ACCOUNTLOGONPROOF( m_BNCSUtil->GetM1( ) ) );
+						m_BNCSUtil->StartSID_AUTH_ACCOUNTLOGONPROOF( m_Protocol->GetSalt( ), m_Protocol->GetServerPublicKey( ) );
 					}
 				}
 				else
@@ -741,6 +697,62 @@ void CBNET :: ProcessPackets( )
 	}
 }
 
+void CBNET :: UpdateBNCSUtil( )
+{
+	// continue logging in when the helper thread has finished the revision check or the NLS calculations
+
+	bool Result = false;
+	uint32_t Job = m_BNCSUtil->GetFinishedJob( &Result );
+
+	if( Job == BNCSUTIL_JOB_SID_AUTH_CHECK )
+	{
+		if( Result )
+		{
+			// override the exe information generated by bncsutil if specified in the config file
+			// apparently this is useful for pvpgn users
+
+			if( m_EXEVersion.size( ) == 4 )
+			{
+				CONSOLE_Print( "[BNET: " + m_ServerAlias + "] using custom exe version bnet_custom_exeversion = " + UTIL_ToString( m_EXEVersion[0] ) + " " + UTIL_ToString( m_EXEVersion[1] ) + " " + UTIL_ToString( m_EXEVersion[2] ) + " " + UTIL_ToString( m_EXEVersion[3] ) );
+				m_BNCSUtil->SetEXEVersion( m_EXEVersion );
+			}
+
+			if( m_EXEVersionHash.size( ) == 4 )
+			{
+				CONSOLE_Print( "[BNET: " + m_ServerAlias + "] using custom exe version hash bnet_custom_exeversionhash = " + UTIL_ToString( m_EXEVersionHash[0] ) + " " + UTIL_ToString( m_EXEVersionHash[1] ) + " " + UTIL_ToString( m_EXEVersionHash[2] ) + " " + UTIL_ToString( m_EXEVersionHash[3] ) );
+				m_BNCSUtil->SetEXEVersionHash( m_EXEVersionHash );
+			}
+
+			if( m_GHost->m_TFT )
+				CONSOLE_Print( "[BNET: " + m_ServerAlias + "] attempting to auth as Warcraft III: The Frozen Throne" );
+			else
+				CONSOLE_Print( "[BNET: " + m_ServerAlias + "] attempting to auth as Warcraft III: Reign of Chaos" );
+
+			m_Socket->PutBytes( m_Protocol->SEND_SID_AUTH_CHECK( m_GHost->m_TFT, m_Protocol->GetClientToken( ), m_BNCSUtil->GetEXEVersion( ), m_BNCSUtil->GetEXEVersionHash( ), m_BNCSUtil->GetKeyInfoROC( ), m_BNCSUtil->GetKeyInfoTFT( ), m_BNCSUtil->GetEXEInfo( ), "GHost" ) );
+
+			// the Warden seed is the first 4 bytes of the ROC key hash
+			// initialize the Warden handler
+
+			if( !m_BNLSServer.empty( ) )
+			{
+				CONSOLE_Print( "[BNET: " + m_ServerAlias + "] creating BNLS client" );
+				delete m_BNLSClient;
+				m_BNLSClient = new CBNLSClient( m_BNLSServer, m_BNLSPort, m_BNLSWardenCookie );
+				m_BNLSClient->QueueWardenSeed( UTIL_ByteArrayToUInt32( m_BNCSUtil->GetKeyInfoROC( ), false, 16 ) );
+			}
+		}
+		else
+		{
+			CONSOLE_Print( "[BNET: " + m_ServerAlias + "] logon failed - bncsutil key hash failed (check your Warcraft 3 path and cd keys), disconnecting" );
+			m_Socket->Disconnect( );
+		}
+	}
+	else if( Job == BNCSUTIL_JOB_SID_AUTH_ACCOUNTLOGON )
+		m_Socket->PutBytes( m_Protocol->SEND_SID_AUTH_ACCOUNTLOGON( m_BNCSUtil->GetClientKey( ), m_UserName ) );
+	else if( Job == BNCSUTIL_JOB_SID_AUTH_ACCOUNTLOGONPROOF )
+		m_Socket->PutBytes( m_Protocol->SEND_SID_AUTH_ACCOUNTLOGONPROOF( m_BNCSUtil->GetM1( ) ) );
+}
+
 void CBNET :: ProcessChatEvent( CIncomingChatEvent *chatEvent )
 {
 	CBNETProtocol :: IncomingChatEvent Event = chatEvent->GetChatEvent( );
@@ -873,13 +885,13 @@ void CBNET :: SendGetClanList( )
 void CBNET :: QueueEnterChat( )
 {
 	if( m_LoggedIn )
-		m_OutPackets.push( m_Protocol->SEND_SID_ENTERCHAT( ) );
+		QueuePacket( m_Protocol->SEND_SID_ENTERCHAT( ), BNET_PRIORITY_CONTROL );
 }
 
-void CBNET :: QueueChatCommand( string chatCommand )
+uint32_t CBNET :: QueueChatCommand( string chatCommand )
 {
 	if( chatCommand.empty( ) )
-		return;
+		return 0;
 
 	if( m_LoggedIn )
 	{
@@ -889,27 +901,33 @@ void CBNET :: QueueChatCommand( string chatCommand )
 		if( chatCommand.size( ) > 255 )
 			chatCommand = chatCommand.substr( 0, 255 );
 
-		if( m_OutPackets.size( ) > 10 )
-			CONSOLE_Print( "[BNET: " + m_ServerAlias + "] attempted to queue chat command [" + chatCommand + "] but there are too many (" + UTIL_ToString( m_OutPackets.size( ) ) + ") packets queued, discarding" );
+		// whispers and commands are directed at someone (often an admin waiting for a reply or a player waiting for a spoof check) so they're sent before public chat
+
+		unsigned char Priority = chatCommand[0] == '/' ? BNET_PRIORITY_WHISPER : BNET_PRIORITY_CHAT;
+
+		if( m_OutPackets[Priority].size( ) > 10 )
+			CONSOLE_Print( "[BNET: " + m_ServerAlias + "] attempted to queue chat command [" + chatCommand + "] but there are too many (" + UTIL_ToString( m_OutPackets[Priority].size( ) ) + ") packets queued, discarding" );
 		else
 		{
 			CONSOLE_Print( "[QUEUED: " + m_ServerAlias + "] " + chatCommand );
-			m_OutPackets.push( m_Protocol->SEND_SID_CHATCOMMAND( chatCommand ) );
+			return QueuePacket( m_Protocol->SEND_SID_CHATCOMMAND( chatCommand ), Priority );
 		}
 	}
+
+	return 0;
 }
 
-void CBNET :: QueueChatCommand( string chatCommand, string user, bool whisper )
+uint32_t CBNET :: QueueChatCommand( string chatCommand, string user, bool whisper )
 {
 	if( chatCommand.empty( ) )
-		return;
+		return 0;
 
 	// if whisper is true send the chat command as a whisper to user, otherwise just queue the chat command
 
 	if( whisper )
-		QueueChatCommand( "/w " + user + " " + chatCommand );
+		return QueueChatCommand( "/w " + user + " " + chatCommand );
 	else
-		QueueChatCommand( chatCommand );
+		return QueueChatCommand( chatCommand );
 }
 
 void CBNET :: QueueGameCreate( unsigned char state, string gameName, string hostName, CMap *map, CSaveGame *savegame, uint32_t hostCounter )
@@ -937,6 +955,18 @@ void CBNET :: QueueGameRefresh( unsigned char state, string gameName, string hos
 
 	if( m_LoggedIn && map )
 	{
+		// every refresh of the same game is identical except for the time since creation so we only build the packet when something else changed
+		// every game (and every rehost) gets a new host counter so together with the state and names it identifies the packet
+
+		string RefreshKey = UTIL_ToString( state ) + "|" + UTIL_ToString( hostCounter ) + "|" + ( m_GHost->m_Reconnect ? "1" : "0" ) + "|" + gameName + "|" + hostName;
+
+		if( RefreshKey == m_RefreshKey && !m_RefreshPacket.empty( ) )
+		{
+			m_Protocol->SetSID_STARTADVEX3UpTime( m_RefreshPacket, upTime );
+			QueueRefreshPacket( m_RefreshPacket );
+			return;
+		}
+
 		// construct a fixed host counter which will be used to identify players from this realm
 		// the fixed host counter's 4 most significant bits will contain a 4 bit ID (0-15)
 		// the rest of the fixed host counter will contain the 28 least significant bits of the actual host counter
@@ -965,9 +995,9 @@ void CBNET :: QueueGameRefresh( unsigned char state, string gameName, string hos
 			MapHeight.push_back( 7 );
 
 			if( m_GHost->m_Reconnect )
-				m_OutPackets.push( m_Protocol->SEND_SID_STARTADVEX3( state, UTIL_CreateByteArray( MapGameType, false ), map->GetMapGameFlags( ), MapWidth, MapHeight, gameName, hostName, upTime, "Save\\Multiplayer\\" + saveGame->GetFileNameNoPath( ), saveGame->GetMagicNumber( ), map->GetMapSHA1( ), FixedHostCounter ) );
+				m_RefreshPacket = m_Protocol->SEND_SID_STARTADVEX3( state, UTIL_CreateByteArray( MapGameType, false ), map->GetMapGameFlags( ), MapWidth, MapHeight, gameName, hostName, upTime, "Save\\Multiplayer\\" + saveGame->GetFileNameNoPath( ), saveGame->GetMagicNumber( ), map->GetMapSHA1( ), FixedHostCounter );
 			else
-				m_OutPackets.push( m_Protocol->SEND_SID_STARTADVEX3( state, UTIL_CreateByteArray( MapGameType, false ), map->GetMapGameFlags( ), UTIL_CreateByteArray( (uint16_t)0, false ), UTIL_CreateByteArray( (uint16_t)0, false ), gameName, hostName, upTime, "Save\\Multiplayer\\" + saveGame->GetFileNameNoPath( ), saveGame->GetMagicNumber( ), map->GetMapSHA1( ), FixedHostCounter ) );
+				m_RefreshPacket = m_Protocol->SEND_SID_STARTADVEX3( state, UTIL_CreateByteArray( MapGameType, false ), map->GetMapGameFlags( ), UTIL_CreateByteArray( (uint16_t)0, false ), UTIL_CreateByteArray( (uint16_t)0, false ), gameName, hostName, upTime, "Save\\Multiplayer\\" + saveGame->GetFileNameNoPath( ), saveGame->GetMagicNumber( ), map->GetMapSHA1( ), FixedHostCounter );
 		}
 		else
 		{
@@ -987,70 +1017,103 @@ void CBNET :: QueueGameRefresh( unsigned char state, string gameName, string hos
 			MapHeight.push_back( 7 );
 
 			if( m_GHost->m_Reconnect )
-				m_OutPackets.push( m_Protocol->SEND_SID_STARTADVEX3( state, UTIL_CreateByteArray( MapGameType, false ), map->GetMapGameFlags( ), MapWidth, MapHeight, gameName, hostName, upTime, m_GHost->m_MapPath + "/" + map->GetMapLocalPath( ), map->GetMapCRC( ), map->GetMapSHA1( ), FixedHostCounter ) );
+				m_RefreshPacket = m_Protocol->SEND_SID_STARTADVEX3( state, UTIL_CreateByteArray( MapGameType, false ), map->GetMapGameFlags( ), MapWidth, MapHeight, gameName, hostName, upTime, m_GHost->m_MapPath + "/" + map->GetMapLocalPath( ), map->GetMapCRC( ), map->GetMapSHA1( ), FixedHostCounter );
 			else
-				m_OutPackets.push( m_Protocol->SEND_SID_STARTADVEX3( state, UTIL_CreateByteArray( MapGameType, false ), map->GetMapGameFlags( ), map->GetMapWidth( ), map->GetMapHeight( ), gameName, hostName, upTime, m_GHost->m_MapPath + "/" + map->GetMapLocalPath( ), map->GetMapCRC( ), map->GetMapSHA1( ), FixedHostCounter ) );
+				m_RefreshPacket = m_Protocol->SEND_SID_STARTADVEX3( state, UTIL_CreateByteArray( MapGameType, false ), map->GetMapGameFlags( ), map->GetMapWidth( ), map->GetMapHeight( ), gameName, hostName, upTime, m_GHost->m_MapPath + "/" + map->GetMapLocalPath( ), map->GetMapCRC( ), map->GetMapSHA1( ), FixedHostCounter );
 		}
+
+		m_RefreshKey = RefreshKey;
+		QueueRefreshPacket( m_RefreshPacket );
 	}
 }
 
-void CBNET :: QueueGameUncreate( )
+uint32_t CBNET :: QueuePacket( BYTEARRAY packet, unsigned char priority )
 {
-	if( m_LoggedIn )
-		m_OutPackets.push( m_Protocol->SEND_SID_STOPADV( ) );
+	CQueuedBNETPacket Packet;
+	Packet.m_Packet = packet;
+	Packet.m_Handle = m_NextOutPacketHandle++;
+	Packet.m_Sequence = m_NextOutPacketSequence++;
+	Packet.m_Priority = priority;
+
+	if( m_NextOutPacketHandle == 0 )
+		m_NextOutPacketHandle = 1;
+
+	m_OutPacketHandles[Packet.m_Handle] = m_OutPackets[priority].insert( m_OutPackets[priority].end( ), Packet );
+	return Packet.m_Handle;
 }
 
-void CBNET :: UnqueuePackets( unsigned char type )
+void CBNET :: QueueRefreshPacket( BYTEARRAY &packet )
 {
-	queue<BYTEARRAY> Packets;
-	uint32_t Unqueued = 0;
+	// if an older refresh hasn't been sent yet just replace it since the new one supersedes it
+	// but only if no control packet was queued after it, otherwise the new refresh would be sent before e.g. a SID_STOPADV meant to follow it
 
-	while( !m_OutPackets.empty( ) )
-	{
-		// todotodo: it's very inefficient to have to copy all these packets while searching the queue
+	list<CQueuedBNETPacket> &Refreshes = m_OutPackets[BNET_PRIORITY_REFRESH];
+	list<CQueuedBNETPacket> &Controls = m_OutPackets[BNET_PRIORITY_CONTROL];
+
+	if( !Refreshes.empty( ) && ( Controls.empty( ) || Controls.back( ).m_Sequence < Refreshes.back( ).m_Sequence ) )
+		Refreshes.back( ).m_Packet = packet;
+	else
+		QueuePacket( packet, BNET_PRIORITY_REFRESH );
+}
 
-		BYTEARRAY Packet = m_OutPackets.front( );
-		m_OutPackets.pop( );
+CQueuedBNETPacket *CBNET :: GetNextOutPacket( )
+{
+	// control packets are sent first unless a refresh was queued before them (see the comment in bnet.h)
 
-		if( Packet.size( ) >= 2 && Packet[1] == type )
-			Unqueued++;
-		else
-			Packets.push( Packet );
+	list<CQueuedBNETPacket> &Refreshes = m_OutPackets[BNET_PRIORITY_REFRESH];
+	list<CQueuedBNETPacket> &Controls = m_OutPackets[BNET_PRIORITY_CONTROL];
+
+	if( !Controls.empty( ) && ( Refreshes.empty( ) || Controls.front( ).m_Sequence < Refreshes.front( ).m_Sequence ) )
+		return &Controls.front( );
+
+	for( unsigned char i = BNET_PRIORITY_REFRESH; i < BNET_PRIORITIES; i++ )
+	{
+		if( !m_OutPackets[i].empty( ) )
+			return &m_OutPackets[i].front( );
 	}
 
-	m_OutPackets = Packets;
+	return NULL;
+}
 
-	if( Unqueued > 0 )
-		CONSOLE_Print( "[BNET: " + m_ServerAlias + "] unqueued " + UTIL_ToString( Unqueued ) + " packets of type " + UTIL_ToString( type ) );
+void CBNET :: QueueGameUncreate( )
+{
+	if( m_LoggedIn )
+		QueuePacket( m_Protocol->SEND_SID_STOPADV( ), BNET_PRIORITY_CONTROL );
 }
 
-void CBNET :: UnqueueChatCommand( string chatCommand )
+bool CBNET :: UnqueuePacket( uint32_t handle )
 {
-	// hackhack: this is ugly code
-	// generate the packet that would be sent for this chat command
-	// then search the queue for that exact packet
+	map<uint32_t, list<CQueuedBNETPacket> :: iterator> :: iterator i = m_OutPacketHandles.find( handle );
 
-	BYTEARRAY PacketToUnqueue = m_Protocol->SEND_SID_CHATCOMMAND( chatCommand );
-	queue<BYTEARRAY> Packets;
-	uint32_t Unqueued = 0;
+	if( i == m_OutPacketHandles.end( ) )
+		return false;
 
-	while( !m_OutPackets.empty( ) )
-	{
-		// todotodo: it's very inefficient to have to copy all these packets while searching the queue
+	m_OutPackets[i->second->m_Priority].erase( i->second );
+	m_OutPacketHandles.erase( i );
+	return true;
+}
 
-		BYTEARRAY Packet = m_OutPackets.front( );
-		m_OutPackets.pop( );
+void CBNET :: UnqueuePackets( unsigned char type )
+{
+	uint32_t Unqueued = 0;
 
-		if( Packet == PacketToUnqueue )
-			Unqueued++;
-		else
-			Packets.push( Packet );
+	for( unsigned char i = 0; i < BNET_PRIORITIES; i++ )
+	{
+		for( list<CQueuedBNETPacket> :: iterator j = m_OutPackets[i].begin( ); j != m_OutPackets[i].end( ); )
+		{
+			if( j->m_Packet.size( ) >= 2 && j->m_Packet[1] == type )
+			{
+				m_OutPacketHandles.erase( j->m_Handle );
+				j = m_OutPackets[i].erase( j );
+				Unqueued++;
+			}
+			else
+				j++;
+		}
 	}
 
-	m_OutPackets = Packets;
-
 	if( Unqueued > 0 )
-		CONSOLE_Print( "[BNET: " + m_ServerAlias + "] unqueued " + UTIL_ToString( Unqueued ) + " chat command packets" );
+		CONSOLE_Print( "[BNET: " + m_ServerAlias + "] unqueued " + UTIL_ToString( Unqueued ) + " packets of type " + UTIL_ToString( type ) );
 }
 
 void CBNET :: UnqueueGameRefreshes( )
@@ -1058,6 +1121,14 @@ void CBNET :: UnqueueGameRefreshes( )
 	UnqueuePackets( CBNETProtocol :: SID_STARTADVEX3 );
 }
 
+void CBNET :: ClearOutPackets( )
+{
+	for( unsigned char i = 0; i < BNET_PRIORITIES; i++ )
+		m_OutPackets[i].clear( );
+
+	m_OutPacketHandles.clear( );
+}
+
 bool CBNET :: IsAdmin( string name )
 {
 	transform( name.begin( ), name.end( ), name.begin( ), (int(*)(int))tolower );
@@ -21,6 +21,28 @@
 #ifndef BNET_H
 #define BNET_H
 
+//
+// CQueuedBNETPacket
+//
+
+// outgoing packets are queued in one of these priority classes and a lower number is always sent first
+// the exception is that control packets never overtake a game refresh queued before them because battle.net interprets SID_ENTERCHAT and SID_STOPADV relative to the game we're advertising
+
+#define BNET_PRIORITY_CONTROL	0		// SID_ENTERCHAT, SID_STOPADV
+#define BNET_PRIORITY_REFRESH	1		// SID_STARTADVEX3
+#define BNET_PRIORITY_WHISPER	2		// whispers and other commands (e.g. spoof checks and replies to whispered admin commands)
+#define BNET_PRIORITY_CHAT		3		// public chat
+#define BNET_PRIORITIES			4
+
+class CQueuedBNETPacket
+{
+public:
+	BYTEARRAY m_Packet;
+	uint32_t m_Handle;					// identifies the packet for UnqueuePacket
+	uint32_t m_Sequence;				// the order the packet was queued in across all priority classes
+	unsigned char m_Priority;			// BNET_PRIORITY_*
+};
+
 //
 // CBNET
 //
@@ -30,15 +52,14 @@ class CCommandPacket;
 class CBNCSUtilInterface;
 class CBNETProtocol;
 class CBNLSClient;
+class CFloodControl;
 class CIncomingFriendList;
 class CIncomingClanList;
 class CIncomingChatEvent;
-class CCallableGamePlayerSummaryCheck;
-class CCallableDotAPlayerSummaryCheck;
 class CDBBan;
 
-typedef pair<string,CCallableGamePlayerSummaryCheck *> PairedGPSCheck;
-typedef pair<string,CCallableDotAPlayerSummaryCheck *> PairedDPSCheck;
+typedef pair<string,string> PairedGPSCheck;
+typedef pair<string,string> PairedDPSCheck;
 
 class CBNET
 {
@@ -51,11 +72,17 @@ private:
 	CBNLSClient *m_BNLSClient;						// the BNLS client (for external warden handling)
 	queue<CCommandPacket *> m_Packets;				// queue of incoming packets
 	CBNCSUtilInterface *m_BNCSUtil;					// the interface to the bncsutil library (used for logging into battle.net)
-	queue<BYTEARRAY> m_OutPackets;					// queue of outgoing packets to be sent (to prevent getting kicked for flooding)
+	list<CQueuedBNETPacket> m_OutPackets[BNET_PRIORITIES];	// queues of outgoing packets to be sent, one per priority class (to prevent getting kicked for flooding)
+	map<uint32_t, list<CQueuedBNETPacket> :: iterator> m_OutPacketHandles;	// every queued packet by handle
+	uint32_t m_NextOutPacketHandle;					// the handle of the next packet to be queued (0 is never used)
+	uint32_t m_NextOutPacketSequence;				// the sequence number of the next packet to be queued
+	CFloodControl *m_FloodControl;					// the flood control token bucket for m_OutPackets
+	BYTEARRAY m_RefreshPacket;						// the last game refresh packet we built, resent with only the time since creation changed
+	string m_RefreshKey;							// the parameters m_RefreshPacket was built with
 	vector<CIncomingFriendList *> m_Friends;		// vector of friends
 	vector<CIncomingClanList *> m_Clans;			// vector of clan members
-	vector<PairedGPSCheck> m_PairedGPSChecks;		// vector of paired threaded database game player summary checks in progress
-	vector<PairedDPSCheck> m_PairedDPSChecks;		// vector of paired threaded database DotA player summary checks in progress
+	vector<PairedGPSCheck> m_PairedGPSChecks;		// vector of paired game player summary requests waiting for the summary cache (requester, name)
+	vector<PairedDPSCheck> m_PairedDPSChecks;		// vector of paired DotA player summary requests waiting for the summary cache (requester, name)
 	bool m_Exiting;									// set to true and this class will be deleted next update
 	string m_Server;								// battle.net server to connect to
 	string m_ServerIP;								// battle.net server to connect to (the IP address so we don't have to resolve it every time we connect)
@@ -85,7 +112,6 @@ private:
 	uint32_t m_LastConnectionAttemptTime;			// GetTime when we last attempted to connect to battle.net
 	uint32_t m_LastNullTime;						// GetTime when the last null packet was sent for detecting disconnects
 	uint32_t m_LastOutPacketTicks;					// GetTicks when the last packet was sent for the m_OutPackets queue
-	uint32_t m_LastOutPacketSize;
 	uint32_t m_LastAdminRefreshTime;				// GetTime when the admin list was last refreshed from the database
 	uint32_t m_LastBanRefreshTime;					// GetTime when the ban list was last refreshed from the database
 	bool m_FirstConnect;							// if we haven't tried to connect to battle.net yet
@@ -121,7 +147,7 @@ public:
 	bool GetHoldFriends( )				{ return m_HoldFriends; }
 	bool GetHoldClan( )					{ return m_HoldClan; }
 	bool GetPublicCommands( )			{ return m_PublicCommands; }
-	uint32_t GetOutPacketsQueued( )		{ return m_OutPackets.size( ); }
+	uint32_t GetOutPacketsQueued( )		{ return m_OutPacketHandles.size( ); }
 	BYTEARRAY GetUniqueName( );
 
 	// processing functions
@@ -130,6 +156,7 @@ public:
 	bool Update( void *fd, void *send_fd );
 	void ExtractPackets( );
 	void ProcessPackets( );
+	void UpdateBNCSUtil( );
 	void ProcessChatEvent( CIncomingChatEvent *chatEvent );
 
 	// functions to send packets to battle.net
@@ -138,15 +165,19 @@ public:
 	void SendGetFriendsList( );
 	void SendGetClanList( );
 	void QueueEnterChat( );
-	void QueueChatCommand( string chatCommand );
-	void QueueChatCommand( string chatCommand, string user, bool whisper );
+	uint32_t QueueChatCommand( string chatCommand );
+	uint32_t QueueChatCommand( string chatCommand, string user, bool whisper );
 	void QueueGameCreate( unsigned char state, string gameName, string hostName, CMap *map, CSaveGame *saveGame, uint32_t hostCounter );
 	void QueueGameRefresh( unsigned char state, string gameName, string hostName, CMap *map, CSaveGame *saveGame, uint32_t upTime, uint32_t hostCounter );
 	void QueueGameUncreate( );
 
+	uint32_t QueuePacket( BYTEARRAY packet, unsigned char priority );
+	void QueueRefreshPacket( BYTEARRAY &packet );
+	CQueuedBNETPacket *GetNextOutPacket( );
+	bool UnqueuePacket( uint32_t handle );
 	void UnqueuePackets( unsigned char type );
-	void UnqueueChatCommand( string chatCommand );
 	void UnqueueGameRefreshes( );
+	void ClearOutPackets( );
 
 	// other functions
 
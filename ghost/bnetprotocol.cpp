@@ -21,6 +21,7 @@
 #include "ghost.h"
 #include "util.h"
 #include "bnetprotocol.h"
+#include "packetschema.h"
 
 CBNETProtocol :: CBNETProtocol( )
 {
@@ -37,101 +38,125 @@ CBNETProtocol :: ~CBNETProtocol( )
 // RECEIVE FUNCTIONS //
 ///////////////////////
 
+// SID_NULL and SID_CHECKAD
+
+typedef CPacketSchema<	CFieldHeader<BNET_HEADER_CONSTANT, CBNETProtocol :: SID_NULL> > SIDNullSchema;
+typedef CPacketSchema<	CFieldHeader<BNET_HEADER_CONSTANT, CBNETProtocol :: SID_CHECKAD> > SIDCheckAdSchema;
+
 bool CBNETProtocol :: RECEIVE_SID_NULL( BYTEARRAY data )
 {
 	// DEBUG_Print( "RECEIVED SID_NULL" );
 	// DEBUG_Print( data );
 
-	// 2 bytes					-> Header
-	// 2 bytes					-> Length
-
-	return ValidateLength( data );
+	CPacketNoFields Packet;
+	return SIDNullSchema :: Decode( Packet, data );
 }
 
+// SID_GETADVLISTEX
+
+class CSIDGetAdvListEx
+{
+public:
+	uint32_t m_GamesFound;
+	uint16_t m_Port;
+	CPacketBytes m_IP;
+	CPacketBytes m_GameName;
+	CPacketBytes m_HostCounter;
+};
+
+typedef CPacketSchema<	CFieldHeader<BNET_HEADER_CONSTANT, CBNETProtocol :: SID_GETADVLISTEX>,
+						CFieldUInt32<CSIDGetAdvListEx, &CSIDGetAdvListEx :: m_GamesFound>,			// GamesFound
+						CFieldSkip<10>,																// ???
+						CFieldUInt16<CSIDGetAdvListEx, &CSIDGetAdvListEx :: m_Port>,				// Port
+						CFieldBytes<CSIDGetAdvListEx, 4, &CSIDGetAdvListEx :: m_IP>,				// IP
+						CFieldCString<CSIDGetAdvListEx, &CSIDGetAdvListEx :: m_GameName>,			// GameName
+						CFieldSkip<2>,																// ???
+						CFieldBytes<CSIDGetAdvListEx, 8, &CSIDGetAdvListEx :: m_HostCounter> > SIDGetAdvListExSchema;	// HostCounter (8 hex characters)
+
 CIncomingGameHost *CBNETProtocol :: RECEIVE_SID_GETADVLISTEX( BYTEARRAY data )
 {
 	// DEBUG_Print( "RECEIVED SID_GETADVLISTEX" );
 	// DEBUG_Print( data );
 
-	// 2 bytes					-> Header
-	// 2 bytes					-> Length
-	// 4 bytes					-> GamesFound
-	// if( GamesFound > 0 )
-	//		10 bytes			-> ???
-	//		2 bytes				-> Port
-	//		4 bytes				-> IP
-	//		null term string	-> GameName
-	//		2 bytes				-> ???
-	//		8 bytes				-> HostCounter
-
-	if( ValidateLength( data ) && data.size( ) >= 8 )
-	{
-		BYTEARRAY GamesFound = BYTEARRAY( data.begin( ) + 4, data.begin( ) + 8 );
+	// the schema only covers the first game and we only ever ask for one game
+	// if no games were found the packet ends after GamesFound so it doesn't match the schema either
 
-		if( UTIL_ByteArrayToUInt32( GamesFound, false ) > 0 && data.size( ) >= 25 )
-		{
-			BYTEARRAY Port = BYTEARRAY( data.begin( ) + 18, data.begin( ) + 20 );
-			BYTEARRAY IP = BYTEARRAY( data.begin( ) + 20, data.begin( ) + 24 );
-			BYTEARRAY GameName = UTIL_ExtractCString( data, 24 );
-
-			if( data.size( ) >= GameName.size( ) + 35 )
-			{
-				BYTEARRAY HostCounter;
-				HostCounter.push_back( UTIL_ExtractHex( data, GameName.size( ) + 27, true ) );
-				HostCounter.push_back( UTIL_ExtractHex( data, GameName.size( ) + 29, true ) );
-				HostCounter.push_back( UTIL_ExtractHex( data, GameName.size( ) + 31, true ) );
-				HostCounter.push_back( UTIL_ExtractHex( data, GameName.size( ) + 33, true ) );
-				return new CIncomingGameHost(	IP,
-												UTIL_ByteArrayToUInt16( Port, false ),
-												string( GameName.begin( ), GameName.end( ) ),
-												HostCounter );
-			}
-		}
+	CSIDGetAdvListEx Packet;
+
+	if( SIDGetAdvListExSchema :: Decode( Packet, data ) && Packet.m_GamesFound > 0 )
+	{
+		BYTEARRAY IP = Packet.m_IP.GetByteArray( );
+		BYTEARRAY HostCounterHex = Packet.m_HostCounter.GetByteArray( );
+		BYTEARRAY HostCounter;
+		HostCounter.push_back( UTIL_ExtractHex( HostCounterHex, 0, true ) );
+		HostCounter.push_back( UTIL_ExtractHex( HostCounterHex, 2, true ) );
+		HostCounter.push_back( UTIL_ExtractHex( HostCounterHex, 4, true ) );
+		HostCounter.push_back( UTIL_ExtractHex( HostCounterHex, 6, true ) );
+		return new CIncomingGameHost(	IP,
+										Packet.m_Port,
+										Packet.m_GameName.GetString( ),
+										HostCounter );
 	}
 
 	return NULL;
 }
 
+// SID_ENTERCHAT
+
+class CSIDEnterChat
+{
+public:
+	CPacketBytes m_UniqueName;
+};
+
+typedef CPacketSchema<	CFieldHeader<BNET_HEADER_CONSTANT, CBNETProtocol :: SID_ENTERCHAT>,
+						CFieldCString<CSIDEnterChat, &CSIDEnterChat :: m_UniqueName> > SIDEnterChatSchema;	// UniqueName
+
 bool CBNETProtocol :: RECEIVE_SID_ENTERCHAT( BYTEARRAY data )
 {
 	// DEBUG_Print( "RECEIVED SID_ENTERCHAT" );
 	// DEBUG_Print( data );
 
-	// 2 bytes					-> Header
-	// 2 bytes					-> Length
-	// null terminated string	-> UniqueName
+	CSIDEnterChat Packet;
 
-	if( ValidateLength( data ) && data.size( ) >= 5 )
+	if( SIDEnterChatSchema :: Decode( Packet, data ) )
 	{
-		m_UniqueName = UTIL_ExtractCString( data, 4 );
+		m_UniqueName = Packet.m_UniqueName.GetByteArray( );
 		return true;
 	}
 
 	return false;
 }
 
+// SID_CHATEVENT
+
+class CSIDChatEvent
+{
+public:
+	uint32_t m_EventID;
+	uint32_t m_Ping;
+	CPacketBytes m_User;
+	CPacketBytes m_Message;
+};
+
+typedef CPacketSchema<	CFieldHeader<BNET_HEADER_CONSTANT, CBNETProtocol :: SID_CHATEVENT>,
+						CFieldUInt32<CSIDChatEvent, &CSIDChatEvent :: m_EventID>,				// EventID
+						CFieldSkip<4>,															// ???
+						CFieldUInt32<CSIDChatEvent, &CSIDChatEvent :: m_Ping>,					// Ping
+						CFieldSkip<12>,															// ???
+						CFieldCString<CSIDChatEvent, &CSIDChatEvent :: m_User>,					// User
+						CFieldTrailingCString<CSIDChatEvent, &CSIDChatEvent :: m_Message> > SIDChatEventSchema;	// Message
+
 CIncomingChatEvent *CBNETProtocol :: RECEIVE_SID_CHATEVENT( BYTEARRAY data )
 {
 	// DEBUG_Print( "RECEIVED SID_CHATEVENT" );
 	// DEBUG_Print( data );
 
-	// 2 bytes					-> Header
-	// 2 bytes					-> Length
-	// 4 bytes					-> EventID
-	// 4 bytes					-> ???
-	// 4 bytes					-> Ping
-	// 12 bytes					-> ???
-	// null terminated string	-> User
-	// null terminated string	-> Message
+	CSIDChatEvent Packet;
 
-	if( ValidateLength( data ) && data.size( ) >= 29 )
+	if( SIDChatEventSchema :: Decode( Packet, data ) )
 	{
-		BYTEARRAY EventID = BYTEARRAY( data.begin( ) + 4, data.begin( ) + 8 );
-		BYTEARRAY Ping = BYTEARRAY( data.begin( ) + 12, data.begin( ) + 16 );
-		BYTEARRAY User = UTIL_ExtractCString( data, 28 );
-		BYTEARRAY Message = UTIL_ExtractCString( data, User.size( ) + 29 );
-
-		switch( UTIL_ByteArrayToUInt32( EventID, false ) )
+		switch( Packet.m_EventID )
 		{
 		case CBNETProtocol :: EID_SHOWUSER:
 		case CBNETProtocol :: EID_JOIN:
@@ -148,10 +173,10 @@ CIncomingChatEvent *CBNETProtocol :: RECEIVE_SID_CHATEVENT( BYTEARRAY data )
 		case CBNETProtocol :: EID_INFO:
 		case CBNETProtocol :: EID_ERROR:
 		case CBNETProtocol :: EID_EMOTE:
-			return new CIncomingChatEvent(	(CBNETProtocol :: IncomingChatEvent)UTIL_ByteArrayToUInt32( EventID, false ),
-												UTIL_ByteArrayToUInt32( Ping, false ),
-												string( User.begin( ), User.end( ) ),
-												string( Message.begin( ), Message.end( ) ) );
+			return new CIncomingChatEvent(	(CBNETProtocol :: IncomingChatEvent)Packet.m_EventID,
+												Packet.m_Ping,
+												Packet.m_User.GetString( ),
+												Packet.m_Message.GetString( ) );
 		}
 
 	}
@@ -164,43 +189,60 @@ bool CBNETProtocol :: RECEIVE_SID_CHECKAD( BYTEARRAY data )
 	// DEBUG_Print( "RECEIVED SID_CHECKAD" );
 	// DEBUG_Print( data );
 
-	// 2 bytes					-> Header
-	// 2 bytes					-> Length
-
-	return ValidateLength( data );
+	CPacketNoFields Packet;
+	return SIDCheckAdSchema :: Decode( Packet, data );
 }
 
+// SID_STARTADVEX3, SID_LOGONRESPONSE and SID_AUTH_ACCOUNTLOGONPROOF (received)
+
+class CSIDStatus
+{
+public:
+	uint32_t m_Status;
+};
+
+typedef CPacketSchema<	CFieldHeader<BNET_HEADER_CONSTANT, CBNETProtocol :: SID_STARTADVEX3>,
+						CFieldUInt32<CSIDStatus, &CSIDStatus :: m_Status> > SIDStartAdvEx3StatusSchema;			// Status
+
+typedef CPacketSchema<	CFieldHeader<BNET_HEADER_CONSTANT, CBNETProtocol :: SID_LOGONRESPONSE>,
+						CFieldUInt32<CSIDStatus, &CSIDStatus :: m_Status> > SIDLogonResponseStatusSchema;		// Status
+
+typedef CPacketSchema<	CFieldHeader<BNET_HEADER_CONSTANT, CBNETProtocol :: SID_AUTH_ACCOUNTLOGONPROOF>,
+						CFieldUInt32<CSIDStatus, &CSIDStatus :: m_Status> > SIDAuthAccountLogonProofStatusSchema;	// Status
+
 bool CBNETProtocol :: RECEIVE_SID_STARTADVEX3( BYTEARRAY data )
 {
 	// DEBUG_Print( "RECEIVED SID_STARTADVEX3" );
 	// DEBUG_Print( data );
 
-	// 2 bytes					-> Header
-	// 2 bytes					-> Length
-	// 4 bytes					-> Status
-
-	if( ValidateLength( data ) && data.size( ) >= 8 )
-	{
-		BYTEARRAY Status = BYTEARRAY( data.begin( ) + 4, data.begin( ) + 8 );
+	CSIDStatus Packet;
 
-		if( UTIL_ByteArrayToUInt32( Status, false ) == 0 )
-			return true;
-	}
+	if( SIDStartAdvEx3StatusSchema :: Decode( Packet, data ) && Packet.m_Status == 0 )
+		return true;
 
 	return false;
 }
 
+// SID_PING
+
+class CSIDPing
+{
+public:
+	CPacketBytes m_Ping;
+};
+
+typedef CPacketSchema<	CFieldHeader<BNET_HEADER_CONSTANT, CBNETProtocol :: SID_PING>,
+						CFieldBytes<CSIDPing, 4, &CSIDPing :: m_Ping> > SIDPingSchema;	// Ping
+
 BYTEARRAY CBNETProtocol :: RECEIVE_SID_PING( BYTEARRAY data )
 {
 	// DEBUG_Print( "RECEIVED SID_PING" );
 	// DEBUG_Print( data );
 
-	// 2 bytes					-> Header
-	// 2 bytes					-> Length
-	// 4 bytes					-> Ping
+	CSIDPing Packet;
 
-	if( ValidateLength( data ) && data.size( ) >= 8 )
-		return BYTEARRAY( data.begin( ) + 4, data.begin( ) + 8 );
+	if( SIDPingSchema :: Decode( Packet, data ) )
+		return Packet.m_Ping.GetByteArray( );
 
 	return BYTEARRAY( );
 }
@@ -210,92 +252,115 @@ bool CBNETProtocol :: RECEIVE_SID_LOGONRESPONSE( BYTEARRAY data )
 	// DEBUG_Print( "RECEIVED SID_LOGONRESPONSE" );
 	// DEBUG_Print( data );
 
-	// 2 bytes					-> Header
-	// 2 bytes					-> Length
-	// 4 bytes					-> Status
+	CSIDStatus Packet;
 
-	if( ValidateLength( data ) && data.size( ) >= 8 )
-	{
-		BYTEARRAY Status = BYTEARRAY( data.begin( ) + 4, data.begin( ) + 8 );
-
-		if( UTIL_ByteArrayToUInt32( Status, false ) == 1 )
-			return true;
-	}
+	if( SIDLogonResponseStatusSchema :: Decode( Packet, data ) && Packet.m_Status == 1 )
+		return true;
 
 	return false;
 }
 
+// SID_AUTH_INFO
+
+class CSIDAuthInfo
+{
+public:
+	CPacketBytes m_LogonType;
+	CPacketBytes m_ServerToken;
+	CPacketBytes m_MPQFileTime;
+	CPacketBytes m_IX86VerFileName;
+	CPacketBytes m_ValueStringFormula;
+};
+
+typedef CPacketSchema<	CFieldHeader<BNET_HEADER_CONSTANT, CBNETProtocol :: SID_AUTH_INFO>,
+						CFieldBytes<CSIDAuthInfo, 4, &CSIDAuthInfo :: m_LogonType>,						// LogonType
+						CFieldBytes<CSIDAuthInfo, 4, &CSIDAuthInfo :: m_ServerToken>,					// ServerToken
+						CFieldSkip<4>,																	// ???
+						CFieldBytes<CSIDAuthInfo, 8, &CSIDAuthInfo :: m_MPQFileTime>,					// MPQFileTime
+						CFieldCString<CSIDAuthInfo, &CSIDAuthInfo :: m_IX86VerFileName>,				// IX86VerFileName
+						CFieldTrailingCString<CSIDAuthInfo, &CSIDAuthInfo :: m_ValueStringFormula> > SIDAuthInfoSchema;	// ValueStringFormula
+
 bool CBNETProtocol :: RECEIVE_SID_AUTH_INFO( BYTEARRAY data )
 {
 	// DEBUG_Print( "RECEIVED SID_AUTH_INFO" );
 	// DEBUG_Print( data );
 
-	// 2 bytes					-> Header
-	// 2 bytes					-> Length
-	// 4 bytes					-> LogonType
-	// 4 bytes					-> ServerToken
-	// 4 bytes					-> ???
-	// 8 bytes					-> MPQFileTime
-	// null terminated string	-> IX86VerFileName
-	// null terminated string	-> ValueStringFormula
+	CSIDAuthInfo Packet;
 
-	if( ValidateLength( data ) && data.size( ) >= 25 )
+	if( SIDAuthInfoSchema :: Decode( Packet, data ) )
 	{
-		m_LogonType = BYTEARRAY( data.begin( ) + 4, data.begin( ) + 8 );
-		m_ServerToken = BYTEARRAY( data.begin( ) + 8, data.begin( ) + 12 );
-		m_MPQFileTime = BYTEARRAY( data.begin( ) + 16, data.begin( ) + 24 );
-		m_IX86VerFileName = UTIL_ExtractCString( data, 24 );
-		m_ValueStringFormula = UTIL_ExtractCString( data, m_IX86VerFileName.size( ) + 25 );
+		m_LogonType = Packet.m_LogonType.GetByteArray( );
+		m_ServerToken = Packet.m_ServerToken.GetByteArray( );
+		m_MPQFileTime = Packet.m_MPQFileTime.GetByteArray( );
+		m_IX86VerFileName = Packet.m_IX86VerFileName.GetByteArray( );
+		m_ValueStringFormula = Packet.m_ValueStringFormula.GetByteArray( );
 		return true;
 	}
 
 	return false;
 }
 
+// SID_AUTH_CHECK (received)
+
+class CSIDAuthCheckResult
+{
+public:
+	CPacketBytes m_KeyState;
+	CPacketBytes m_KeyStateDescription;
+};
+
+typedef CPacketSchema<	CFieldHeader<BNET_HEADER_CONSTANT, CBNETProtocol :: SID_AUTH_CHECK>,
+						CFieldBytes<CSIDAuthCheckResult, 4, &CSIDAuthCheckResult :: m_KeyState>,					// KeyState
+						CFieldCString<CSIDAuthCheckResult, &CSIDAuthCheckResult :: m_KeyStateDescription> > SIDAuthCheckResultSchema;	// KeyStateDescription
+
 bool CBNETProtocol :: RECEIVE_SID_AUTH_CHECK( BYTEARRAY data )
 {
 	// DEBUG_Print( "RECEIVED SID_AUTH_CHECK" );
 	// DEBUG_Print( data );
 
-	// 2 bytes					-> Header
-	// 2 bytes					-> Length
-	// 4 bytes					-> KeyState
-	// null terminated string	-> KeyStateDescription
+	CSIDAuthCheckResult Packet;
 
-	if( ValidateLength( data ) && data.size( ) >= 9 )
+	if( SIDAuthCheckResultSchema :: Decode( Packet, data ) )
 	{
-		m_KeyState = BYTEARRAY( data.begin( ) + 4, data.begin( ) + 8 );
-		m_KeyStateDescription = UTIL_ExtractCString( data, 8 );
+		m_KeyState = Packet.m_KeyState.GetByteArray( );
+		m_KeyStateDescription = Packet.m_KeyStateDescription.GetByteArray( );
 
-		if( UTIL_ByteArrayToUInt32( m_KeyState, false ) == KR_GOOD )
+		if( PACKET_GetUInt32( Packet.m_KeyState.m_Data ) == KR_GOOD )
 			return true;
 	}
 
 	return false;
 }
 
+// SID_AUTH_ACCOUNTLOGON (received)
+
+class CSIDAuthAccountLogonResult
+{
+public:
+	uint32_t m_Status;
+	CPacketBytes m_Salt;
+	CPacketBytes m_ServerPublicKey;
+};
+
+typedef CPacketSchema<	CFieldHeader<BNET_HEADER_CONSTANT, CBNETProtocol :: SID_AUTH_ACCOUNTLOGON>,
+						CFieldUInt32<CSIDAuthAccountLogonResult, &CSIDAuthAccountLogonResult :: m_Status>,					// Status
+						CFieldBytes<CSIDAuthAccountLogonResult, 32, &CSIDAuthAccountLogonResult :: m_Salt>,					// Salt (only if Status == 0)
+						CFieldBytes<CSIDAuthAccountLogonResult, 32, &CSIDAuthAccountLogonResult :: m_ServerPublicKey> > SIDAuthAccountLogonResultSchema;	// ServerPublicKey (only if Status == 0)
+
 bool CBNETProtocol :: RECEIVE_SID_AUTH_ACCOUNTLOGON( BYTEARRAY data )
 {
 	// DEBUG_Print( "RECEIVED SID_AUTH_ACCOUNTLOGON" );
 	// DEBUG_Print( data );
 
-	// 2 bytes					-> Header
-	// 2 bytes					-> Length
-	// 4 bytes					-> Status
-	// if( Status == 0 )
-	//		32 bytes			-> Salt
-	//		32 bytes			-> ServerPublicKey
+	// if the logon failed the packet ends after the status so it doesn't match the schema
 
-	if( ValidateLength( data ) && data.size( ) >= 8 )
-	{
-		BYTEARRAY status = BYTEARRAY( data.begin( ) + 4, data.begin( ) + 8 );
+	CSIDAuthAccountLogonResult Packet;
 
-		if( UTIL_ByteArrayToUInt32( status, false ) == 0 && data.size( ) >= 72 )
-		{
-			m_Salt = BYTEARRAY( data.begin( ) + 8, data.begin( ) + 40 );
-			m_ServerPublicKey = BYTEARRAY( data.begin( ) + 40, data.begin( ) + 72 );
-			return true;
-		}
+	if( SIDAuthAccountLogonResultSchema :: Decode( Packet, data ) && Packet.m_Status == 0 )
+	{
+		m_Salt = Packet.m_Salt.GetByteArray( );
+		m_ServerPublicKey = Packet.m_ServerPublicKey.GetByteArray( );
+		return true;
 	}
 
 	return false;
@@ -306,166 +371,177 @@ bool CBNETProtocol :: RECEIVE_SID_AUTH_ACCOUNTLOGONPROOF( BYTEARRAY data )
 	// DEBUG_Print( "RECEIVED SID_AUTH_ACCOUNTLOGONPROOF" );
 	// DEBUG_Print( data );
 
-	// 2 bytes					-> Header
-	// 2 bytes					-> Length
-	// 4 bytes					-> Status
-
-	if( ValidateLength( data ) && data.size( ) >= 8 )
-	{
-		uint32_t Status = UTIL_ByteArrayToUInt32( BYTEARRAY( data.begin( ) + 4, data.begin( ) + 8 ), false );
+	CSIDStatus Packet;
 
-		if( Status == 0 || Status == 0xE )
-			return true;
-	}
+	if( SIDAuthAccountLogonProofStatusSchema :: Decode( Packet, data ) && ( Packet.m_Status == 0 || Packet.m_Status == 0xE ) )
+		return true;
 
 	return false;
 }
 
+// SID_WARDEN
+
+class CSIDWarden
+{
+public:
+	CPacketBytes m_Data;
+};
+
+typedef CPacketSchema<	CFieldHeader<BNET_HEADER_CONSTANT, CBNETProtocol :: SID_WARDEN>,
+						CFieldRaw<CSIDWarden, &CSIDWarden :: m_Data> > SIDWardenSchema;	// Data
+
 BYTEARRAY CBNETProtocol :: RECEIVE_SID_WARDEN( BYTEARRAY data )
 {
 	// DEBUG_Print( "RECEIVED SID_WARDEN" );
 	// DEBUG_PRINT( data );
 
-	// 2 bytes					-> Header
-	// 2 bytes					-> Length
-	// n bytes					-> Data
+	CSIDWarden Packet;
 
-	if( ValidateLength( data ) && data.size( ) >= 4 )
-		return BYTEARRAY( data.begin( ) + 4, data.end( ) );
+	if( SIDWardenSchema :: Decode( Packet, data ) )
+		return Packet.m_Data.GetByteArray( );
 
 	return BYTEARRAY( );
 }
 
+// SID_FRIENDSLIST (received)
+
+class CSIDFriendsList
+{
+public:
+	unsigned char m_Total;
+	CPacketBytes m_Friends;
+};
+
+class CSIDFriend
+{
+public:
+	CPacketBytes m_Account;
+	unsigned char m_Status;
+	unsigned char m_Area;
+	CPacketBytes m_Location;
+};
+
+typedef CPacketSchema<	CFieldHeader<BNET_HEADER_CONSTANT, CBNETProtocol :: SID_FRIENDSLIST>,
+						CFieldUInt8<CSIDFriendsList, &CSIDFriendsList :: m_Total>,			// Total
+						CFieldRaw<CSIDFriendsList, &CSIDFriendsList :: m_Friends> > SIDFriendsListSchema;	// Total times SIDFriendSchema
+
+typedef CPacketSchema<	CFieldCString<CSIDFriend, &CSIDFriend :: m_Account>,				// Account
+						CFieldUInt8<CSIDFriend, &CSIDFriend :: m_Status>,					// Status
+						CFieldUInt8<CSIDFriend, &CSIDFriend :: m_Area>,						// Area
+						CFieldSkip<4>,														// ???
+						CFieldCString<CSIDFriend, &CSIDFriend :: m_Location> > SIDFriendSchema;	// Location
+
 vector<CIncomingFriendList *> CBNETProtocol :: RECEIVE_SID_FRIENDSLIST( BYTEARRAY data )
 {
 	// DEBUG_Print( "RECEIVED SID_FRIENDSLIST" );
 	// DEBUG_Print( data );
 
-	// 2 bytes					-> Header
-	// 2 bytes					-> Length
-	// 1 byte					-> Total
-	// for( 1 .. Total )
-	//		null term string	-> Account
-	//		1 byte				-> Status
-	//		1 byte				-> Area
-	//		4 bytes				-> ???
-	//		null term string	-> Location
-
 	vector<CIncomingFriendList *> Friends;
+	CSIDFriendsList Packet;
 
-	if( ValidateLength( data ) && data.size( ) >= 5 )
+	if( SIDFriendsListSchema :: Decode( Packet, data ) )
 	{
-		unsigned int i = 5;
-		unsigned char Total = data[4];
+		const unsigned char *Data = Packet.m_Friends.m_Data;
+		const unsigned char *End = Data + Packet.m_Friends.m_Size;
 
-		while( Total > 0 )
+		for( unsigned char i = 0; i < Packet.m_Total; i++ )
 		{
-			Total--;
-
-			if( data.size( ) < i + 1 )
-				break;
+			CSIDFriend Friend;
 
-			BYTEARRAY Account = UTIL_ExtractCString( data, i );
-			i += Account.size( ) + 1;
-
-			if( data.size( ) < i + 7 )
+			if( !SIDFriendSchema :: Decode( Friend, Data, End ) )
 				break;
 
-			unsigned char Status = data[i];
-			unsigned char Area = data[i + 1];
-			i += 6;
-			BYTEARRAY Location = UTIL_ExtractCString( data, i );
-			i += Location.size( ) + 1;
-			Friends.push_back( new CIncomingFriendList(	string( Account.begin( ), Account.end( ) ),
-														Status,
-														Area,
-														string( Location.begin( ), Location.end( ) ) ) );
+			Friends.push_back( new CIncomingFriendList(	Friend.m_Account.GetString( ),
+														Friend.m_Status,
+														Friend.m_Area,
+														Friend.m_Location.GetString( ) ) );
 		}
 	}
 
 	return Friends;
 }
 
+// SID_CLANMEMBERLIST (received)
+
+class CSIDClanMemberList
+{
+public:
+	unsigned char m_Total;
+	CPacketBytes m_Members;
+};
+
+class CSIDClanMember
+{
+public:
+	CPacketBytes m_Name;
+	unsigned char m_Rank;
+	unsigned char m_Status;
+	CPacketBytes m_Location;
+};
+
+typedef CPacketSchema<	CFieldHeader<BNET_HEADER_CONSTANT, CBNETProtocol :: SID_CLANMEMBERLIST>,
+						CFieldSkip<4>,																	// ???
+						CFieldUInt8<CSIDClanMemberList, &CSIDClanMemberList :: m_Total>,				// Total
+						CFieldRaw<CSIDClanMemberList, &CSIDClanMemberList :: m_Members> > SIDClanMemberListSchema;	// Total times SIDClanMemberSchema
+
+typedef CPacketSchema<	CFieldCString<CSIDClanMember, &CSIDClanMember :: m_Name>,				// Name
+						CFieldUInt8<CSIDClanMember, &CSIDClanMember :: m_Rank>,					// Rank
+						CFieldUInt8<CSIDClanMember, &CSIDClanMember :: m_Status>,				// Status
+						CFieldCString<CSIDClanMember, &CSIDClanMember :: m_Location> > SIDClanMemberSchema;	// Location
+
 vector<CIncomingClanList *> CBNETProtocol :: RECEIVE_SID_CLANMEMBERLIST( BYTEARRAY data )
 {
 	// DEBUG_Print( "RECEIVED SID_CLANMEMBERLIST" );
 	// DEBUG_Print( data );
 
-	// 2 bytes					-> Header
-	// 2 bytes					-> Length
-	// 4 bytes					-> ???
-	// 1 byte					-> Total
-	// for( 1 .. Total )
-	//		null term string	-> Name
-	//		1 byte				-> Rank
-	//		1 byte				-> Status
-	//		null term string	-> Location
-
 	vector<CIncomingClanList *> ClanList;
+	CSIDClanMemberList Packet;
 
-	if( ValidateLength( data ) && data.size( ) >= 9 )
+	if( SIDClanMemberListSchema :: Decode( Packet, data ) )
 	{
-		unsigned int i = 9;
-		unsigned char Total = data[8];
+		const unsigned char *Data = Packet.m_Members.m_Data;
+		const unsigned char *End = Data + Packet.m_Members.m_Size;
 
-		while( Total > 0 )
+		for( unsigned char i = 0; i < Packet.m_Total; i++ )
 		{
-			Total--;
+			CSIDClanMember Member;
 
-			if( data.size( ) < i + 1 )
+			if( !SIDClanMemberSchema :: Decode( Member, Data, End ) )
 				break;
 
-			BYTEARRAY Name = UTIL_ExtractCString( data, i );
-			i += Name.size( ) + 1;
-
-			if( data.size( ) < i + 3 )
-				break;
-
-			unsigned char Rank = data[i];
-			unsigned char Status = data[i + 1];
-			i += 2;
-
 			// in the original VB source the location string is read but discarded, so that's what I do here
 
-			BYTEARRAY Location = UTIL_ExtractCString( data, i );
-			i += Location.size( ) + 1;
-			ClanList.push_back( new CIncomingClanList(	string( Name.begin( ), Name.end( ) ),
-														Rank,
-														Status ) );
+			ClanList.push_back( new CIncomingClanList(	Member.m_Name.GetString( ),
+														Member.m_Rank,
+														Member.m_Status ) );
 		}
 	}
 
 	return ClanList;
 }
 
+// SID_CLANMEMBERSTATUSCHANGE
+
+typedef CPacketSchema<	CFieldHeader<BNET_HEADER_CONSTANT, CBNETProtocol :: SID_CLANMEMBERSTATUSCHANGE>,
+						CFieldCString<CSIDClanMember, &CSIDClanMember :: m_Name>,						// Name
+						CFieldUInt8<CSIDClanMember, &CSIDClanMember :: m_Rank>,							// Rank
+						CFieldUInt8<CSIDClanMember, &CSIDClanMember :: m_Status>,						// Status
+						CFieldTrailingCString<CSIDClanMember, &CSIDClanMember :: m_Location> > SIDClanMemberStatusChangeSchema;	// Location
+
 CIncomingClanList *CBNETProtocol :: RECEIVE_SID_CLANMEMBERSTATUSCHANGE( BYTEARRAY data )
 {
 	// DEBUG_Print( "RECEIVED SID_CLANMEMBERSTATUSCHANGE" );
 	// DEBUG_Print( data );
 
-	// 2 bytes					-> Header
-	// 2 bytes					-> Length
-	// null terminated string	-> Name
-	// 1 byte					-> Rank
-	// 1 byte					-> Status
-	// null terminated string	-> Location
+	CSIDClanMember Packet;
 
-	if( ValidateLength( data ) && data.size( ) >= 5 )
+	if( SIDClanMemberStatusChangeSchema :: Decode( Packet, data ) )
 	{
-		BYTEARRAY Name = UTIL_ExtractCString( data, 4 );
-
-		if( data.size( ) >= Name.size( ) + 7 )
-		{
-			unsigned char Rank = data[Name.size( ) + 5];
-			unsigned char Status = data[Name.size( ) + 6];
+		// in the original VB source the location string is read but discarded, so that's what I do here
 
-			// in the original VB source the location string is read but discarded, so that's what I do here
-
-			BYTEARRAY Location = UTIL_ExtractCString( data, Name.size( ) + 7 );
-			return new CIncomingClanList(	string( Name.begin( ), Name.end( ) ),
-											Rank,
-											Status );
-		}
+		return new CIncomingClanList(	Packet.m_Name.GetString( ),
+										Packet.m_Rank,
+										Packet.m_Status );
 	}
 
 	return NULL;
@@ -475,6 +551,11 @@ CIncomingClanList *CBNETProtocol :: RECEIVE_SID_CLANMEMBERSTATUSCHANGE( BYTEARRA
 // SEND FUNCTIONS //
 ////////////////////
 
+// the product ID sent in SID_AUTH_INFO
+
+#define SID_PRODUCTID_ROC	1463898675	// "WAR3"
+#define SID_PRODUCTID_TFT	1462982736	// "W3XP"
+
 BYTEARRAY CBNETProtocol :: SEND_PROTOCOL_INITIALIZE_SELECTOR( )
 {
 	BYTEARRAY packet;
@@ -486,126 +567,153 @@ BYTEARRAY CBNETProtocol :: SEND_PROTOCOL_INITIALIZE_SELECTOR( )
 
 BYTEARRAY CBNETProtocol :: SEND_SID_NULL( )
 {
-	BYTEARRAY packet;
-	packet.push_back( BNET_HEADER_CONSTANT );	// BNET header constant
-	packet.push_back( SID_NULL );				// SID_NULL
-	packet.push_back( 0 );						// packet length will be assigned later
-	packet.push_back( 0 );						// packet length will be assigned later
-	AssignLength( packet );
+	BYTEARRAY packet = SIDNullSchema :: Encode( CPacketNoFields( ) );
 	// DEBUG_Print( "SENT SID_NULL" );
 	// DEBUG_Print( packet );
 	return packet;
 }
 
+// SID_STOPADV
+
+typedef CPacketSchema<	CFieldHeader<BNET_HEADER_CONSTANT, CBNETProtocol :: SID_STOPADV> > SIDStopAdvSchema;
+
 BYTEARRAY CBNETProtocol :: SEND_SID_STOPADV( )
 {
-	BYTEARRAY packet;
-	packet.push_back( BNET_HEADER_CONSTANT );	// BNET header constant
-	packet.push_back( SID_STOPADV );			// SID_STOPADV
-	packet.push_back( 0 );						// packet length will be assigned later
-	packet.push_back( 0 );						// packet length will be assigned later
-	AssignLength( packet );
+	BYTEARRAY packet = SIDStopAdvSchema :: Encode( CPacketNoFields( ) );
 	// DEBUG_Print( "SENT SID_STOPADV" );
 	// DEBUG_Print( packet );
 	return packet;
 }
 
-BYTEARRAY CBNETProtocol :: SEND_SID_GETADVLISTEX( string gameName )
+// SID_GETADVLISTEX (sent)
+
+class CSIDGetAdvListExRequest
 {
-	unsigned char MapFilter1[]	= { 255, 3, 0, 0 };
-	unsigned char MapFilter2[]	= { 255, 3, 0, 0 };
-	unsigned char MapFilter3[]	= {   0, 0, 0, 0 };
-	unsigned char NumGames[]	= {   1, 0, 0, 0 };
+public:
+	CPacketBytes m_GameName;
+};
+
+typedef CPacketSchema<	CFieldHeader<BNET_HEADER_CONSTANT, CBNETProtocol :: SID_GETADVLISTEX>,
+						CFieldConst32<1023>,																// Map Filter
+						CFieldConst32<1023>,																// Map Filter
+						CFieldConst32<0>,																	// Map Filter
+						CFieldConst32<1>,																	// maximum number of games to list
+						CFieldCString<CSIDGetAdvListExRequest, &CSIDGetAdvListExRequest :: m_GameName>,		// Game Name
+						CFieldConst8<0>,																	// Game Password is NULL
+						CFieldConst8<0> > SIDGetAdvListExRequestSchema;										// Game Stats is NULL
 
-	BYTEARRAY packet;
-	packet.push_back( BNET_HEADER_CONSTANT );			// BNET header constant
-	packet.push_back( SID_GETADVLISTEX );				// SID_GETADVLISTEX
-	packet.push_back( 0 );								// packet length will be assigned later
-	packet.push_back( 0 );								// packet length will be assigned later
-	UTIL_AppendByteArray( packet, MapFilter1, 4 );		// Map Filter
-	UTIL_AppendByteArray( packet, MapFilter2, 4 );		// Map Filter
-	UTIL_AppendByteArray( packet, MapFilter3, 4 );		// Map Filter
-	UTIL_AppendByteArray( packet, NumGames, 4 );		// maximum number of games to list
-	UTIL_AppendByteArrayFast( packet, gameName );		// Game Name
-	packet.push_back( 0 );								// Game Password is NULL
-	packet.push_back( 0 );								// Game Stats is NULL
-	AssignLength( packet );
+BYTEARRAY CBNETProtocol :: SEND_SID_GETADVLISTEX( string gameName )
+{
+	CSIDGetAdvListExRequest Packet;
+	Packet.m_GameName = gameName;
+	BYTEARRAY packet = SIDGetAdvListExRequestSchema :: Encode( Packet );
 	// DEBUG_Print( "SENT SID_GETADVLISTEX" );
 	// DEBUG_Print( packet );
 	return packet;
 }
 
+// SID_ENTERCHAT (sent)
+
+typedef CPacketSchema<	CFieldHeader<BNET_HEADER_CONSTANT, CBNETProtocol :: SID_ENTERCHAT>,
+						CFieldConst8<0>,										// Account Name is NULL on Warcraft III/The Frozen Throne
+						CFieldConst8<0> > SIDEnterChatRequestSchema;			// Stat String is NULL on CDKEY'd products
+
 BYTEARRAY CBNETProtocol :: SEND_SID_ENTERCHAT( )
 {
-	BYTEARRAY packet;
-	packet.push_back( BNET_HEADER_CONSTANT );	// BNET header constant
-	packet.push_back( SID_ENTERCHAT );			// SID_ENTERCHAT
-	packet.push_back( 0 );						// packet length will be assigned later
-	packet.push_back( 0 );						// packet length will be assigned later
-	packet.push_back( 0 );						// Account Name is NULL on Warcraft III/The Frozen Throne
-	packet.push_back( 0 );						// Stat String is NULL on CDKEY'd products
-	AssignLength( packet );
+	BYTEARRAY packet = SIDEnterChatRequestSchema :: Encode( CPacketNoFields( ) );
 	// DEBUG_Print( "SENT SID_ENTERCHAT" );
 	// DEBUG_Print( packet );
 	return packet;
 }
 
-BYTEARRAY CBNETProtocol :: SEND_SID_JOINCHANNEL( string channel )
+// SID_JOINCHANNEL
+
+class CSIDJoinChannel
 {
-	unsigned char NoCreateJoin[]	= { 2, 0, 0, 0 };
-	unsigned char FirstJoin[]		= { 1, 0, 0, 0 };
+public:
+	uint32_t m_Flags;
+	CPacketBytes m_Channel;
+};
 
-	BYTEARRAY packet;
-	packet.push_back( BNET_HEADER_CONSTANT );				// BNET header constant
-	packet.push_back( SID_JOINCHANNEL );					// SID_JOINCHANNEL
-	packet.push_back( 0 );									// packet length will be assigned later
-	packet.push_back( 0 );									// packet length will be assigned later
+typedef CPacketSchema<	CFieldHeader<BNET_HEADER_CONSTANT, CBNETProtocol :: SID_JOINCHANNEL>,
+						CFieldUInt32<CSIDJoinChannel, &CSIDJoinChannel :: m_Flags>,				// flags (2 = no create join, 1 = first join)
+						CFieldCString<CSIDJoinChannel, &CSIDJoinChannel :: m_Channel> > SIDJoinChannelSchema;	// channel
+
+BYTEARRAY CBNETProtocol :: SEND_SID_JOINCHANNEL( string channel )
+{
+	CSIDJoinChannel Packet;
 
 	if( channel.size( ) > 0 )
-		UTIL_AppendByteArray( packet, NoCreateJoin, 4 );	// flags for no create join
+		Packet.m_Flags = 2;
 	else
-		UTIL_AppendByteArray( packet, FirstJoin, 4 );		// flags for first join
+		Packet.m_Flags = 1;
 
-	UTIL_AppendByteArrayFast( packet, channel );
-	AssignLength( packet );
+	Packet.m_Channel = channel;
+	BYTEARRAY packet = SIDJoinChannelSchema :: Encode( Packet );
 	// DEBUG_Print( "SENT SID_JOINCHANNEL" );
 	// DEBUG_Print( packet );
 	return packet;
 }
 
+// SID_CHATCOMMAND
+
+class CSIDChatCommand
+{
+public:
+	CPacketBytes m_Command;
+};
+
+typedef CPacketSchema<	CFieldHeader<BNET_HEADER_CONSTANT, CBNETProtocol :: SID_CHATCOMMAND>,
+						CFieldCString<CSIDChatCommand, &CSIDChatCommand :: m_Command> > SIDChatCommandSchema;	// Message
+
 BYTEARRAY CBNETProtocol :: SEND_SID_CHATCOMMAND( string command )
 {
-	BYTEARRAY packet;
-	packet.push_back( BNET_HEADER_CONSTANT );		// BNET header constant
-	packet.push_back( SID_CHATCOMMAND );			// SID_CHATCOMMAND
-	packet.push_back( 0 );							// packet length will be assigned later
-	packet.push_back( 0 );							// packet length will be assigned later
-	UTIL_AppendByteArrayFast( packet, command );	// Message
-	AssignLength( packet );
+	CSIDChatCommand Packet;
+	Packet.m_Command = command;
+	BYTEARRAY packet = SIDChatCommandSchema :: Encode( Packet );
 	// DEBUG_Print( "SENT SID_CHATCOMMAND" );
 	// DEBUG_Print( packet );
 	return packet;
 }
 
+// SID_CHECKAD (sent)
+
+typedef CPacketSchema<	CFieldHeader<BNET_HEADER_CONSTANT, CBNETProtocol :: SID_CHECKAD>,
+						CFieldSkip<16> > SIDCheckAdRequestSchema;		// ???
+
 BYTEARRAY CBNETProtocol :: SEND_SID_CHECKAD( )
 {
-	unsigned char Zeros[] = { 0, 0, 0, 0 };
-
-	BYTEARRAY packet;
-	packet.push_back( BNET_HEADER_CONSTANT );	// BNET header constant
-	packet.push_back( SID_CHECKAD );			// SID_CHECKAD
-	packet.push_back( 0 );						// packet length will be assigned later
-	packet.push_back( 0 );						// packet length will be assigned later
-	UTIL_AppendByteArray( packet, Zeros, 4 );	// ???
-	UTIL_AppendByteArray( packet, Zeros, 4 );	// ???
-	UTIL_AppendByteArray( packet, Zeros, 4 );	// ???
-	UTIL_AppendByteArray( packet, Zeros, 4 );	// ???
-	AssignLength( packet );
+	BYTEARRAY packet = SIDCheckAdRequestSchema :: Encode( CPacketNoFields( ) );
 	// DEBUG_Print( "SENT SID_CHECKAD" );
 	// DEBUG_Print( packet );
 	return packet;
 }
 
+// SID_STARTADVEX3 (sent)
+
+class CSIDStartAdvEx3
+{
+public:
+	uint32_t m_State;
+	uint32_t m_UpTime;
+	CPacketBytes m_GameType;
+	CPacketBytes m_GameName;
+	CPacketBytes m_HostCounter;
+	CPacketBytes m_StatString;
+};
+
+typedef CPacketSchema<	CFieldHeader<BNET_HEADER_CONSTANT, CBNETProtocol :: SID_STARTADVEX3>,
+						CFieldUInt32<CSIDStartAdvEx3, &CSIDStartAdvEx3 :: m_State>,				// State (16 = public, 17 = private, 18 = close)
+						CFieldUInt32<CSIDStartAdvEx3, &CSIDStartAdvEx3 :: m_UpTime>,			// time since creation
+						CFieldBytes<CSIDStartAdvEx3, 4, &CSIDStartAdvEx3 :: m_GameType>,		// Game Type, Parameter
+						CFieldConst32<1023>,													// ???
+						CFieldConst32<0>,														// Custom Game
+						CFieldCString<CSIDStartAdvEx3, &CSIDStartAdvEx3 :: m_GameName>,			// Game Name
+						CFieldConst8<0>,														// Game Password is NULL
+						CFieldConst8<98>,														// Slots Free (ascii 98 = char 'b' = 11 slots free) - note: do not reduce this as this is the # of PID's Warcraft III will allocate
+						CFieldBytes<CSIDStartAdvEx3, 8, &CSIDStartAdvEx3 :: m_HostCounter>,		// Host Counter
+						CFieldCString<CSIDStartAdvEx3, &CSIDStartAdvEx3 :: m_StatString> > SIDStartAdvEx3Schema;	// Stat String (the stat string is encoded to remove all even numbers i.e. zeros)
+
 BYTEARRAY CBNETProtocol :: SEND_SID_STARTADVEX3( unsigned char state, BYTEARRAY mapGameType, BYTEARRAY mapFlags, BYTEARRAY mapWidth, BYTEARRAY mapHeight, string gameName, string hostName, uint32_t upTime, string mapPath, BYTEARRAY mapCRC, BYTEARRAY mapSHA1, uint32_t hostCounter )
 {
 	// todotodo: sort out how GameType works, the documentation is horrendous
@@ -634,9 +742,6 @@ Flags:
 
 */
 
-	unsigned char Unknown[]		= { 255,  3,  0,  0 };
-	unsigned char CustomGame[]	= {   0,  0,  0,  0 };
-
 	string HostCounterString = UTIL_ToHexString( hostCounter );
 
 	if( HostCounterString.size( ) < 8 )
@@ -664,25 +769,14 @@ Flags:
 	{
 		// make the rest of the packet
 
-		packet.push_back( BNET_HEADER_CONSTANT );						// BNET header constant
-		packet.push_back( SID_STARTADVEX3 );							// SID_STARTADVEX3
-		packet.push_back( 0 );											// packet length will be assigned later
-		packet.push_back( 0 );											// packet length will be assigned later
-		packet.push_back( state );										// State (16 = public, 17 = private, 18 = close)
-		packet.push_back( 0 );											// State continued...
-		packet.push_back( 0 );											// State continued...
-		packet.push_back( 0 );											// State continued...
-		UTIL_AppendByteArray( packet, upTime, false );					// time since creation
-		UTIL_AppendByteArrayFast( packet, mapGameType );				// Game Type, Parameter
-		UTIL_AppendByteArray( packet, Unknown, 4 );						// ???
-		UTIL_AppendByteArray( packet, CustomGame, 4 );					// Custom Game
-		UTIL_AppendByteArrayFast( packet, gameName );					// Game Name
-		packet.push_back( 0 );											// Game Password is NULL
-		packet.push_back( 98 );											// Slots Free (ascii 98 = char 'b' = 11 slots free) - note: do not reduce this as this is the # of PID's Warcraft III will allocate
-		UTIL_AppendByteArrayFast( packet, HostCounterString, false );	// Host Counter
-		UTIL_AppendByteArrayFast( packet, StatString );					// Stat String
-		packet.push_back( 0 );											// Stat String null terminator (the stat string is encoded to remove all even numbers i.e. zeros)
-		AssignLength( packet );
+		CSIDStartAdvEx3 Packet;
+		Packet.m_State = state;
+		Packet.m_UpTime = upTime;
+		Packet.m_GameType = mapGameType;
+		Packet.m_GameName = gameName;
+		Packet.m_HostCounter = HostCounterString;
+		Packet.m_StatString = StatString;
+		packet = SIDStartAdvEx3Schema :: Encode( Packet );
 	}
 	else
 		CONSOLE_Print( "[BNETPROTO] invalid parameters passed to SEND_SID_STARTADVEX3" );
@@ -692,21 +786,25 @@ Flags:
 	return packet;
 }
 
-BYTEARRAY CBNETProtocol :: SEND_SID_NOTIFYJOIN( string gameName )
+// SID_NOTIFYJOIN
+
+class CSIDNotifyJoin
 {
-	unsigned char ProductID[]		= {  0, 0, 0, 0 };
-	unsigned char ProductVersion[]	= { 14, 0, 0, 0 };	// Warcraft III is 14
+public:
+	CPacketBytes m_GameName;
+};
 
-	BYTEARRAY packet;
-	packet.push_back( BNET_HEADER_CONSTANT );			// BNET header constant
-	packet.push_back( SID_NOTIFYJOIN );					// SID_NOTIFYJOIN
-	packet.push_back( 0 );								// packet length will be assigned later
-	packet.push_back( 0 );								// packet length will be assigned later
-	UTIL_AppendByteArray( packet, ProductID, 4 );		// Product ID
-	UTIL_AppendByteArray( packet, ProductVersion, 4 );	// Product Version
-	UTIL_AppendByteArrayFast( packet, gameName );		// Game Name
-	packet.push_back( 0 );								// Game Password is NULL
-	AssignLength( packet );
+typedef CPacketSchema<	CFieldHeader<BNET_HEADER_CONSTANT, CBNETProtocol :: SID_NOTIFYJOIN>,
+						CFieldConst32<0>,														// Product ID
+						CFieldConst32<14>,														// Product Version (Warcraft III is 14)
+						CFieldCString<CSIDNotifyJoin, &CSIDNotifyJoin :: m_GameName>,			// Game Name
+						CFieldConst8<0> > SIDNotifyJoinSchema;									// Game Password is NULL
+
+BYTEARRAY CBNETProtocol :: SEND_SID_NOTIFYJOIN( string gameName )
+{
+	CSIDNotifyJoin Packet;
+	Packet.m_GameName = gameName;
+	BYTEARRAY packet = SIDNotifyJoinSchema :: Encode( Packet );
 	// DEBUG_Print( "SENT SID_NOTIFYJOIN" );
 	// DEBUG_Print( packet );
 	return packet;
@@ -718,12 +816,9 @@ BYTEARRAY CBNETProtocol :: SEND_SID_PING( BYTEARRAY pingValue )
 
 	if( pingValue.size( ) == 4 )
 	{
-		packet.push_back( BNET_HEADER_CONSTANT );		// BNET header constant
-		packet.push_back( SID_PING );					// SID_PING
-		packet.push_back( 0 );							// packet length will be assigned later
-		packet.push_back( 0 );							// packet length will be assigned later
-		UTIL_AppendByteArrayFast( packet, pingValue );	// Ping Value
-		AssignLength( packet );
+		CSIDPing Packet;
+		Packet.m_Ping = pingValue;
+		packet = SIDPingSchema :: Encode( Packet );
 	}
 	else
 		CONSOLE_Print( "[BNETPROTO] invalid parameters passed to SEND_SID_PING" );
@@ -733,107 +828,147 @@ BYTEARRAY CBNETProtocol :: SEND_SID_PING( BYTEARRAY pingValue )
 	return packet;
 }
 
+// SID_LOGONRESPONSE (sent)
+
+class CSIDLogonResponse
+{
+public:
+	CPacketBytes m_ClientToken;
+	CPacketBytes m_ServerToken;
+	CPacketBytes m_PasswordHash;
+	CPacketBytes m_AccountName;
+};
+
+typedef CPacketSchema<	CFieldHeader<BNET_HEADER_CONSTANT, CBNETProtocol :: SID_LOGONRESPONSE>,
+						CFieldRaw<CSIDLogonResponse, &CSIDLogonResponse :: m_ClientToken>,				// Client Token
+						CFieldRaw<CSIDLogonResponse, &CSIDLogonResponse :: m_ServerToken>,				// Server Token
+						CFieldRaw<CSIDLogonResponse, &CSIDLogonResponse :: m_PasswordHash>,				// Password Hash
+						CFieldCString<CSIDLogonResponse, &CSIDLogonResponse :: m_AccountName> > SIDLogonResponseSchema;	// Account Name
+
 BYTEARRAY CBNETProtocol :: SEND_SID_LOGONRESPONSE( BYTEARRAY clientToken, BYTEARRAY serverToken, BYTEARRAY passwordHash, string accountName )
 {
 	// todotodo: check that the passed BYTEARRAY sizes are correct (don't know what they should be right now so I can't do this today)
 
-	BYTEARRAY packet;
-	packet.push_back( BNET_HEADER_CONSTANT );			// BNET header constant
-	packet.push_back( SID_LOGONRESPONSE );				// SID_LOGONRESPONSE
-	packet.push_back( 0 );								// packet length will be assigned later
-	packet.push_back( 0 );								// packet length will be assigned later
-	UTIL_AppendByteArrayFast( packet, clientToken );	// Client Token
-	UTIL_AppendByteArrayFast( packet, serverToken );	// Server Token
-	UTIL_AppendByteArrayFast( packet, passwordHash );	// Password Hash
-	UTIL_AppendByteArrayFast( packet, accountName );	// Account Name
-	AssignLength( packet );
+	CSIDLogonResponse Packet;
+	Packet.m_ClientToken = clientToken;
+	Packet.m_ServerToken = serverToken;
+	Packet.m_PasswordHash = passwordHash;
+	Packet.m_AccountName = accountName;
+	BYTEARRAY packet = SIDLogonResponseSchema :: Encode( Packet );
 	// DEBUG_Print( "SENT SID_LOGONRESPONSE" );
 	// DEBUG_Print( packet );
 	return packet;
 }
 
+// SID_NETGAMEPORT
+
+class CSIDNetGamePort
+{
+public:
+	uint16_t m_ServerPort;
+};
+
+typedef CPacketSchema<	CFieldHeader<BNET_HEADER_CONSTANT, CBNETProtocol :: SID_NETGAMEPORT>,
+						CFieldUInt16<CSIDNetGamePort, &CSIDNetGamePort :: m_ServerPort> > SIDNetGamePortSchema;	// local game server port
+
 BYTEARRAY CBNETProtocol :: SEND_SID_NETGAMEPORT( uint16_t serverPort )
 {
-	BYTEARRAY packet;
-	packet.push_back( BNET_HEADER_CONSTANT );			// BNET header constant
-	packet.push_back( SID_NETGAMEPORT );				// SID_NETGAMEPORT
-	packet.push_back( 0 );								// packet length will be assigned later
-	packet.push_back( 0 );								// packet length will be assigned later
-	UTIL_AppendByteArray( packet, serverPort, false );	// local game server port
-	AssignLength( packet );
+	CSIDNetGamePort Packet;
+	Packet.m_ServerPort = serverPort;
+	BYTEARRAY packet = SIDNetGamePortSchema :: Encode( Packet );
 	// DEBUG_Print( "SENT SID_NETGAMEPORT" );
 	// DEBUG_Print( packet );
 	return packet;
 }
 
-BYTEARRAY CBNETProtocol :: SEND_SID_AUTH_INFO( unsigned char ver, bool TFT, uint32_t localeID, string countryAbbrev, string country )
+// SID_AUTH_INFO (sent)
+
+class CSIDAuthInfoRequest
 {
-	unsigned char ProtocolID[]		= {   0,   0,   0,   0 };
-	unsigned char PlatformID[]		= {  54,  56,  88,  73 };	// "IX86"
-	unsigned char ProductID_ROC[]	= {  51,  82,  65,  87 };	// "WAR3"
-	unsigned char ProductID_TFT[]	= {  80,  88,  51,  87 };	// "W3XP"
-	unsigned char Version[]			= { ver,   0,   0,   0 };
-	unsigned char Language[]		= {  83,  85, 110, 101 };	// "enUS"
-	unsigned char LocalIP[]			= { 127,   0,   0,   1 };
-	unsigned char TimeZoneBias[]	= {  44,   1,   0,   0 };	// 300 minutes (GMT -0500)
+public:
+	uint32_t m_ProductID;
+	uint32_t m_Version;
+	uint32_t m_LocaleID;
+	CPacketBytes m_CountryAbbrev;
+	CPacketBytes m_Country;
+};
+
+typedef CPacketSchema<	CFieldHeader<BNET_HEADER_CONSTANT, CBNETProtocol :: SID_AUTH_INFO>,
+						CFieldConst32<0>,																// Protocol ID
+						CFieldConst32<1230518326>,														// Platform ID ("IX86")
+						CFieldUInt32<CSIDAuthInfoRequest, &CSIDAuthInfoRequest :: m_ProductID>,			// Product ID
+						CFieldUInt32<CSIDAuthInfoRequest, &CSIDAuthInfoRequest :: m_Version>,			// Version
+						CFieldConst32<1701729619>,														// Language ("enUS", hardcoded to ensure battle.net sends the bot messages in English)
+						CFieldConst32<16777343>,														// Local IP for NAT compatibility (127.0.0.1)
+						CFieldConst32<300>,																// Time Zone Bias (300 minutes = GMT -0500)
+						CFieldUInt32<CSIDAuthInfoRequest, &CSIDAuthInfoRequest :: m_LocaleID>,			// Locale ID
+						CFieldUInt32<CSIDAuthInfoRequest, &CSIDAuthInfoRequest :: m_LocaleID>,			// Language ID (copying the locale ID should be sufficient since we don't care about sublanguages)
+						CFieldCString<CSIDAuthInfoRequest, &CSIDAuthInfoRequest :: m_CountryAbbrev>,	// Country Abbreviation
+						CFieldCString<CSIDAuthInfoRequest, &CSIDAuthInfoRequest :: m_Country> > SIDAuthInfoRequestSchema;	// Country
 
-	BYTEARRAY packet;
-	packet.push_back( BNET_HEADER_CONSTANT );				// BNET header constant
-	packet.push_back( SID_AUTH_INFO );						// SID_AUTH_INFO
-	packet.push_back( 0 );									// packet length will be assigned later
-	packet.push_back( 0 );									// packet length will be assigned later
-	UTIL_AppendByteArray( packet, ProtocolID, 4 );			// Protocol ID
-	UTIL_AppendByteArray( packet, PlatformID, 4 );			// Platform ID
-
-	if( TFT )
-		UTIL_AppendByteArray( packet, ProductID_TFT, 4 );	// Product ID (TFT)
-	else
-		UTIL_AppendByteArray( packet, ProductID_ROC, 4 );	// Product ID (ROC)
-
-	UTIL_AppendByteArray( packet, Version, 4 );				// Version
-	UTIL_AppendByteArray( packet, Language, 4 );			// Language (hardcoded as enUS to ensure battle.net sends the bot messages in English)
-	UTIL_AppendByteArray( packet, LocalIP, 4 );				// Local IP for NAT compatibility
-	UTIL_AppendByteArray( packet, TimeZoneBias, 4 );		// Time Zone Bias
-	UTIL_AppendByteArray( packet, localeID, false );		// Locale ID
-	UTIL_AppendByteArray( packet, localeID, false );		// Language ID (copying the locale ID should be sufficient since we don't care about sublanguages)
-	UTIL_AppendByteArrayFast( packet, countryAbbrev );		// Country Abbreviation
-	UTIL_AppendByteArrayFast( packet, country );			// Country
-	AssignLength( packet );
+BYTEARRAY CBNETProtocol :: SEND_SID_AUTH_INFO( unsigned char ver, bool TFT, uint32_t localeID, string countryAbbrev, string country )
+{
+	CSIDAuthInfoRequest Packet;
+	Packet.m_ProductID = TFT ? SID_PRODUCTID_TFT : SID_PRODUCTID_ROC;
+	Packet.m_Version = ver;
+	Packet.m_LocaleID = localeID;
+	Packet.m_CountryAbbrev = countryAbbrev;
+	Packet.m_Country = country;
+	BYTEARRAY packet = SIDAuthInfoRequestSchema :: Encode( Packet );
 	// DEBUG_Print( "SENT SID_AUTH_INFO" );
 	// DEBUG_Print( packet );
 	return packet;
 }
 
-BYTEARRAY CBNETProtocol :: SEND_SID_AUTH_CHECK( bool TFT, BYTEARRAY clientToken, BYTEARRAY exeVersion, BYTEARRAY exeVersionHash, BYTEARRAY keyInfoROC, BYTEARRAY keyInfoTFT, string exeInfo, string keyOwnerName )
-{
-	uint32_t NumKeys = 0;
+// SID_AUTH_CHECK (sent)
 
-	if( TFT )
-		NumKeys = 2;
-	else
-		NumKeys = 1;
+class CSIDAuthCheck
+{
+public:
+	CPacketBytes m_ClientToken;
+	CPacketBytes m_EXEVersion;
+	CPacketBytes m_EXEVersionHash;
+	uint32_t m_NumKeys;
+	CPacketBytes m_KeyInfoROC;
+	CPacketBytes m_KeyInfoTFT;
+	CPacketBytes m_EXEInfo;
+	CPacketBytes m_KeyOwnerName;
+};
+
+typedef CPacketSchema<	CFieldHeader<BNET_HEADER_CONSTANT, CBNETProtocol :: SID_AUTH_CHECK>,
+						CFieldBytes<CSIDAuthCheck, 4, &CSIDAuthCheck :: m_ClientToken>,			// Client Token
+						CFieldBytes<CSIDAuthCheck, 4, &CSIDAuthCheck :: m_EXEVersion>,			// EXE Version
+						CFieldBytes<CSIDAuthCheck, 4, &CSIDAuthCheck :: m_EXEVersionHash>,		// EXE Version Hash
+						CFieldUInt32<CSIDAuthCheck, &CSIDAuthCheck :: m_NumKeys>,				// number of keys in this packet
+						CFieldConst32<0>,														// boolean Using Spawn (32 bit)
+						CFieldBytes<CSIDAuthCheck, 36, &CSIDAuthCheck :: m_KeyInfoROC>,			// ROC Key Info
+						CFieldRaw<CSIDAuthCheck, &CSIDAuthCheck :: m_KeyInfoTFT>,				// TFT Key Info (only on TFT)
+						CFieldCString<CSIDAuthCheck, &CSIDAuthCheck :: m_EXEInfo>,				// EXE Info
+						CFieldCString<CSIDAuthCheck, &CSIDAuthCheck :: m_KeyOwnerName> > SIDAuthCheckSchema;	// CD Key Owner Name
 
+BYTEARRAY CBNETProtocol :: SEND_SID_AUTH_CHECK( bool TFT, BYTEARRAY clientToken, BYTEARRAY exeVersion, BYTEARRAY exeVersionHash, BYTEARRAY keyInfoROC, BYTEARRAY keyInfoTFT, string exeInfo, string keyOwnerName )
+{
 	BYTEARRAY packet;
 
 	if( clientToken.size( ) == 4 && exeVersion.size( ) == 4 && exeVersionHash.size( ) == 4 && keyInfoROC.size( ) == 36 && ( !TFT || keyInfoTFT.size( ) == 36 ) )
 	{
-		packet.push_back( BNET_HEADER_CONSTANT );			// BNET header constant
-		packet.push_back( SID_AUTH_CHECK );					// SID_AUTH_CHECK
-		packet.push_back( 0 );								// packet length will be assigned later
-		packet.push_back( 0 );								// packet length will be assigned later
-		UTIL_AppendByteArrayFast( packet, clientToken );	// Client Token
-		UTIL_AppendByteArrayFast( packet, exeVersion );		// EXE Version
-		UTIL_AppendByteArrayFast( packet, exeVersionHash );	// EXE Version Hash
-		UTIL_AppendByteArray( packet, NumKeys, false );		// number of keys in this packet
-		UTIL_AppendByteArray( packet, (uint32_t)0, false );	// boolean Using Spawn (32 bit)
-		UTIL_AppendByteArrayFast( packet, keyInfoROC );		// ROC Key Info
+		CSIDAuthCheck Packet;
+		Packet.m_ClientToken = clientToken;
+		Packet.m_EXEVersion = exeVersion;
+		Packet.m_EXEVersionHash = exeVersionHash;
+		Packet.m_KeyInfoROC = keyInfoROC;
 
 		if( TFT )
-			UTIL_AppendByteArrayFast( packet, keyInfoTFT );	// TFT Key Info
+		{
+			Packet.m_NumKeys = 2;
+			Packet.m_KeyInfoTFT = keyInfoTFT;
+		}
+		else
+			Packet.m_NumKeys = 1;
 
-		UTIL_AppendByteArrayFast( packet, exeInfo );		// EXE Info
-		UTIL_AppendByteArrayFast( packet, keyOwnerName );	// CD Key Owner Name
-		AssignLength( packet );
+		Packet.m_EXEInfo = exeInfo;
+		Packet.m_KeyOwnerName = keyOwnerName;
+		packet = SIDAuthCheckSchema :: Encode( Packet );
 	}
 	else
 		CONSOLE_Print( "[BNETPROTO] invalid parameters passed to SEND_SID_AUTH_CHECK" );
@@ -843,19 +978,29 @@ BYTEARRAY CBNETProtocol :: SEND_SID_AUTH_CHECK( bool TFT, BYTEARRAY clientToken,
 	return packet;
 }
 
+// SID_AUTH_ACCOUNTLOGON (sent)
+
+class CSIDAuthAccountLogon
+{
+public:
+	CPacketBytes m_ClientPublicKey;
+	CPacketBytes m_AccountName;
+};
+
+typedef CPacketSchema<	CFieldHeader<BNET_HEADER_CONSTANT, CBNETProtocol :: SID_AUTH_ACCOUNTLOGON>,
+						CFieldBytes<CSIDAuthAccountLogon, 32, &CSIDAuthAccountLogon :: m_ClientPublicKey>,		// Client Key
+						CFieldCString<CSIDAuthAccountLogon, &CSIDAuthAccountLogon :: m_AccountName> > SIDAuthAccountLogonSchema;	// Account Name
+
 BYTEARRAY CBNETProtocol :: SEND_SID_AUTH_ACCOUNTLOGON( BYTEARRAY clientPublicKey, string accountName )
 {
 	BYTEARRAY packet;
 
 	if( clientPublicKey.size( ) == 32 )
 	{
-		packet.push_back( BNET_HEADER_CONSTANT );				// BNET header constant
-		packet.push_back( SID_AUTH_ACCOUNTLOGON );				// SID_AUTH_ACCOUNTLOGON
-		packet.push_back( 0 );									// packet length will be assigned later
-		packet.push_back( 0 );									// packet length will be assigned later
-		UTIL_AppendByteArrayFast( packet, clientPublicKey );	// Client Key
-		UTIL_AppendByteArrayFast( packet, accountName );		// Account Name
-		AssignLength( packet );
+		CSIDAuthAccountLogon Packet;
+		Packet.m_ClientPublicKey = clientPublicKey;
+		Packet.m_AccountName = accountName;
+		packet = SIDAuthAccountLogonSchema :: Encode( Packet );
 	}
 	else
 		CONSOLE_Print( "[BNETPROTO] invalid parameters passed to SEND_SID_AUTH_ACCOUNTLOGON" );
@@ -865,18 +1010,26 @@ BYTEARRAY CBNETProtocol :: SEND_SID_AUTH_ACCOUNTLOGON( BYTEARRAY clientPublicKey
 	return packet;
 }
 
+// SID_AUTH_ACCOUNTLOGONPROOF (sent)
+
+class CSIDAuthAccountLogonProof
+{
+public:
+	CPacketBytes m_ClientPasswordProof;
+};
+
+typedef CPacketSchema<	CFieldHeader<BNET_HEADER_CONSTANT, CBNETProtocol :: SID_AUTH_ACCOUNTLOGONPROOF>,
+						CFieldBytes<CSIDAuthAccountLogonProof, 20, &CSIDAuthAccountLogonProof :: m_ClientPasswordProof> > SIDAuthAccountLogonProofSchema;	// Client Password Proof
+
 BYTEARRAY CBNETProtocol :: SEND_SID_AUTH_ACCOUNTLOGONPROOF( BYTEARRAY clientPasswordProof )
 {
 	BYTEARRAY packet;
 
 	if( clientPasswordProof.size( ) == 20 )
 	{
-		packet.push_back( BNET_HEADER_CONSTANT );					// BNET header constant
-		packet.push_back( SID_AUTH_ACCOUNTLOGONPROOF );				// SID_AUTH_ACCOUNTLOGONPROOF
-		packet.push_back( 0 );										// packet length will be assigned later
-		packet.push_back( 0 );										// packet length will be assigned later
-		UTIL_AppendByteArrayFast( packet, clientPasswordProof );	// Client Password Proof
-		AssignLength( packet );
+		CSIDAuthAccountLogonProof Packet;
+		Packet.m_ClientPasswordProof = clientPasswordProof;
+		packet = SIDAuthAccountLogonProofSchema :: Encode( Packet );
 	}
 	else
 		CONSOLE_Print( "[BNETPROTO] invalid parameters passed to SEND_SID_AUTH_ACCOUNTLOGON" );
@@ -888,42 +1041,34 @@ BYTEARRAY CBNETProtocol :: SEND_SID_AUTH_ACCOUNTLOGONPROOF( BYTEARRAY clientPass
 
 BYTEARRAY CBNETProtocol :: SEND_SID_WARDEN( BYTEARRAY wardenResponse )
 {
-	BYTEARRAY packet;
-	packet.push_back( BNET_HEADER_CONSTANT );			// BNET header constant
-	packet.push_back( SID_WARDEN );						// SID_WARDEN
-	packet.push_back( 0 );								// packet length will be assigned later
-	packet.push_back( 0 );								// packet length will be assigned later
-	UTIL_AppendByteArrayFast( packet, wardenResponse );	// warden response
-	AssignLength( packet );
+	CSIDWarden Packet;
+	Packet.m_Data = wardenResponse;
+	BYTEARRAY packet = SIDWardenSchema :: Encode( Packet );
 	// DEBUG_Print( "SENT SID_WARDEN" );
 	// DEBUG_Print( packet );
 	return packet;
 }
 
+// SID_FRIENDSLIST (sent)
+
+typedef CPacketSchema<	CFieldHeader<BNET_HEADER_CONSTANT, CBNETProtocol :: SID_FRIENDSLIST> > SIDFriendsListRequestSchema;
+
 BYTEARRAY CBNETProtocol :: SEND_SID_FRIENDSLIST( )
 {
-	BYTEARRAY packet;
-	packet.push_back( BNET_HEADER_CONSTANT );	// BNET header constant
-	packet.push_back( SID_FRIENDSLIST );		// SID_FRIENDSLIST
-	packet.push_back( 0 );						// packet length will be assigned later
-	packet.push_back( 0 );						// packet length will be assigned later
-	AssignLength( packet );
+	BYTEARRAY packet = SIDFriendsListRequestSchema :: Encode( CPacketNoFields( ) );
 	// DEBUG_Print( "SENT SID_FRIENDSLIST" );
 	// DEBUG_Print( packet );
 	return packet;
 }
 
+// SID_CLANMEMBERLIST (sent)
+
+typedef CPacketSchema<	CFieldHeader<BNET_HEADER_CONSTANT, CBNETProtocol :: SID_CLANMEMBERLIST>,
+						CFieldConst32<0> > SIDClanMemberListRequestSchema;		// cookie
+
 BYTEARRAY CBNETProtocol :: SEND_SID_CLANMEMBERLIST( )
 {
-	unsigned char Cookie[] = { 0, 0, 0, 0 };
-
-	BYTEARRAY packet;
-	packet.push_back( BNET_HEADER_CONSTANT );	// BNET header constant
-	packet.push_back( SID_CLANMEMBERLIST );		// SID_CLANMEMBERLIST
-	packet.push_back( 0 );						// packet length will be assigned later
-	packet.push_back( 0 );						// packet length will be assigned later
-	UTIL_AppendByteArray( packet, Cookie, 4 );	// cookie
-	AssignLength( packet );
+	BYTEARRAY packet = SIDClanMemberListRequestSchema :: Encode( CPacketNoFields( ) );
 	// DEBUG_Print( "SENT SID_CLANMEMBERLIST" );
 	// DEBUG_Print( packet );
 	return packet;
@@ -933,41 +1078,13 @@ BYTEARRAY CBNETProtocol :: SEND_SID_CLANMEMBERLIST( )
 // OTHER FUNCTIONS //
 /////////////////////
 
-bool CBNETProtocol :: AssignLength( BYTEARRAY &content )
+void CBNETProtocol :: SetSID_STARTADVEX3UpTime( BYTEARRAY &packet, uint32_t upTime )
 {
-	// insert the actual length of the content array into bytes 3 and 4 (indices 2 and 3)
+	// the time since creation is the only field of a game refresh that changes between refreshes so we can patch it instead of building the packet again
+	// it follows the 4 byte header and the 4 byte state (see SIDStartAdvEx3Schema)
 
-	BYTEARRAY LengthBytes;
-
-	if( content.size( ) >= 4 && content.size( ) <= 65535 )
-	{
-		LengthBytes = UTIL_CreateByteArray( (uint16_t)content.size( ), false );
-		content[2] = LengthBytes[0];
-		content[3] = LengthBytes[1];
-		return true;
-	}
-
-	return false;
-}
-
-bool CBNETProtocol :: ValidateLength( BYTEARRAY &content )
-{
-	// verify that bytes 3 and 4 (indices 2 and 3) of the content array describe the length
-
-	uint16_t Length;
-	BYTEARRAY LengthBytes;
-
-	if( content.size( ) >= 4 && content.size( ) <= 65535 )
-	{
-		LengthBytes.push_back( content[2] );
-		LengthBytes.push_back( content[3] );
-		Length = UTIL_ByteArrayToUInt16( LengthBytes, false );
-
-		if( Length == content.size( ) )
-			return true;
-	}
-
-	return false;
+	if( packet.size( ) >= 12 && packet[1] == SID_STARTADVEX3 )
+		PACKET_PutUInt32( &packet[8], upTime );
 }
 
 //
@@ -162,9 +162,7 @@ public:
 
 	// other functions
 
-private:
-	bool AssignLength( BYTEARRAY &content );
-	bool ValidateLength( BYTEARRAY &content );
+	void SetSID_STARTADVEX3UpTime( BYTEARRAY &packet, uint32_t upTime );
 };
 
 //
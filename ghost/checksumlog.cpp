@@ -0,0 +1,188 @@
+/*
+
+   Copyright [2008] [Trevor Hogan]
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+   CODE PORTED FROM THE ORIGINAL GHOST PROJECT: http://ghost.pwner.org/
+
+*/
+
+#include "ghost.h"
+#include "util.h"
+#include "checksumlog.h"
+
+#include <string.h>
+
+//
+// CCheckSumLog
+//
+
+CCheckSumLog :: CCheckSumLog( )
+{
+	m_Frames.resize( CHECKSUMLOG_HISTORY * 2 );
+	memset( m_Indexes, CHECKSUMLOG_MAXPLAYERS, sizeof( m_Indexes ) );
+	memset( m_PIDs, 0, sizeof( m_PIDs ) );
+	m_NumPlayers = 0;
+	m_Expected = 0;
+	m_FirstFrame = 0;
+	m_NextFrame = 0;
+	m_EndFrame = 0;
+}
+
+bool CCheckSumLog :: AddPlayer( unsigned char PID, string name )
+{
+	if( m_NumPlayers >= CHECKSUMLOG_MAXPLAYERS || m_Indexes[PID] != CHECKSUMLOG_MAXPLAYERS )
+		return false;
+
+	m_Indexes[PID] = m_NumPlayers;
+	m_PIDs[m_NumPlayers] = PID;
+	m_Names[m_NumPlayers] = name;
+	m_Expected |= 1 << m_NumPlayers;
+	m_NumPlayers++;
+	return true;
+}
+
+void CCheckSumLog :: RemovePlayer( unsigned char PID )
+{
+	// the player keeps their index so their checksums still show up in the log
+	// the frames they haven't sent a checksum for yet are no longer waiting for them
+
+	if( m_Indexes[PID] != CHECKSUMLOG_MAXPLAYERS )
+		m_Expected &= ~( 1 << m_Indexes[PID] );
+}
+
+void CCheckSumLog :: Add( unsigned char PID, uint32_t frame, uint32_t checkSum )
+{
+	unsigned char Index = m_Indexes[PID];
+
+	if( Index == CHECKSUMLOG_MAXPLAYERS || !( m_Expected & ( 1 << Index ) ) || frame < m_NextFrame )
+		return;
+
+	if( frame - m_FirstFrame >= m_Frames.size( ) )
+		Grow( frame );
+
+	uint32_t Mask = m_Frames.size( ) - 1;
+
+	// the slots between the newest frame and this one are being reused, anything left in them fell out of the history long ago
+
+	while( m_EndFrame <= frame )
+		m_Frames[m_EndFrame++ & Mask].m_Filled = 0;
+
+	CCheckSumFrame &Frame = m_Frames[frame & Mask];
+	Frame.m_CheckSums[Index] = checkSum;
+	Frame.m_Filled |= 1 << Index;
+}
+
+bool CCheckSumLog :: GetCompleteFrame( uint32_t *frame )
+{
+	if( m_NextFrame == m_EndFrame )
+		return false;
+
+	if( ( m_Frames[m_NextFrame & ( m_Frames.size( ) - 1 )].m_Filled & m_Expected ) != m_Expected )
+		return false;
+
+	*frame = m_NextFrame++;
+
+	if( m_NextFrame - m_FirstFrame > CHECKSUMLOG_HISTORY )
+		m_FirstFrame = m_NextFrame - CHECKSUMLOG_HISTORY;
+
+	return true;
+}
+
+bool CCheckSumLog :: GetCheckSum( uint32_t frame, unsigned char PID, uint32_t *checkSum )
+{
+	unsigned char Index = m_Indexes[PID];
+
+	if( Index == CHECKSUMLOG_MAXPLAYERS || frame < m_FirstFrame || frame >= m_EndFrame )
+		return false;
+
+	CCheckSumFrame &Frame = m_Frames[frame & ( m_Frames.size( ) - 1 )];
+
+	if( !( Frame.m_Filled & ( 1 << Index ) ) )
+		return false;
+
+	*checkSum = Frame.m_CheckSums[Index];
+	return true;
+}
+
+string CCheckSumLog :: GetLog( )
+{
+	string Log = "frame";
+
+	for( uint32_t i = 0; i < m_NumPlayers; i++ )
+	{
+		Log += "\t" + m_Names[i] + " (";
+		UTIL_AppendUInt( Log, m_PIDs[i] );
+		Log += ")";
+	}
+
+	Log += "\n";
+	uint32_t Mask = m_Frames.size( ) - 1;
+
+	for( uint32_t i = m_FirstFrame; i != m_EndFrame; i++ )
+	{
+		CCheckSumFrame &Frame = m_Frames[i & Mask];
+		bool FoundCheckSum = false;
+		bool Mismatch = false;
+		uint32_t FirstCheckSum = 0;
+		UTIL_AppendUInt( Log, i );
+
+		for( uint32_t j = 0; j < m_NumPlayers; j++ )
+		{
+			if( Frame.m_Filled & ( 1 << j ) )
+			{
+				Log += "\t";
+				UTIL_AppendHex( Log, Frame.m_CheckSums[j], 8 );
+
+				if( !FoundCheckSum )
+				{
+					FoundCheckSum = true;
+					FirstCheckSum = Frame.m_CheckSums[j];
+				}
+				else if( Frame.m_CheckSums[j] != FirstCheckSum )
+					Mismatch = true;
+			}
+			else
+				Log += "\t--------";
+		}
+
+		if( i >= m_NextFrame )
+			Log += "\tpending";
+
+		if( Mismatch )
+			Log += "\tmismatch";
+
+		Log += "\n";
+	}
+
+	return Log;
+}
+
+void CCheckSumLog :: Grow( uint32_t frame )
+{
+	// a player is so far ahead of the oldest frame in the ring that their checksum doesn't fit
+	// this only happens if someone is lagging by more than the ring can hold so it's very rare
+
+	uint32_t Size = m_Frames.size( );
+
+	while( frame - m_FirstFrame >= Size )
+		Size *= 2;
+
+	vector<CCheckSumFrame> Frames( Size );
+
+	for( uint32_t i = m_FirstFrame; i != m_EndFrame; i++ )
+		Frames[i & ( Size - 1 )] = m_Frames[i & ( m_Frames.size( ) - 1 )];
+
+	m_Frames.swap( Frames );
+}
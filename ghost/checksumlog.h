@@ -0,0 +1,80 @@
+/*
+
+   Copyright [2008] [Trevor Hogan]
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+   CODE PORTED FROM THE ORIGINAL GHOST PROJECT: http://ghost.pwner.org/
+
+*/
+
+#ifndef CHECKSUMLOG_H
+#define CHECKSUMLOG_H
+
+//
+// CCheckSumLog
+//
+
+// every player sends a checksum of their game state with each keepalive and the n-th keepalive belongs to the n-th frame (action packet) we sent
+// the checksum log keeps these in a ring indexed by frame with one slot per player and a bitmask of the slots which have been filled
+// a frame is complete as soon as every player who is still expected has sent their checksum for it, so each frame is verified exactly once
+// the last few verified frames stay in the ring so the log leading up to a desync can be written out for post-mortem debugging
+// note: this is only used from the main thread
+
+#define CHECKSUMLOG_MAXPLAYERS	12
+#define CHECKSUMLOG_HISTORY		64			// the number of verified frames to keep in the ring
+
+class CCheckSumFrame
+{
+public:
+	uint32_t m_CheckSums[CHECKSUMLOG_MAXPLAYERS];	// indexed by player index
+	uint16_t m_Filled;								// bit n is set once the player with index n has sent their checksum for this frame
+
+	CCheckSumFrame( ) : m_Filled( 0 ) { }
+};
+
+class CCheckSumLog
+{
+private:
+	vector<CCheckSumFrame> m_Frames;				// the ring, the size is always a power of two
+	unsigned char m_Indexes[256];					// PID -> player index (CHECKSUMLOG_MAXPLAYERS if the player isn't tracked)
+	unsigned char m_PIDs[CHECKSUMLOG_MAXPLAYERS];	// player index -> PID
+	string m_Names[CHECKSUMLOG_MAXPLAYERS];			// player index -> name
+	uint32_t m_NumPlayers;							// the number of players added so far (including players who have been removed)
+	uint16_t m_Expected;							// bit n is set if the player with index n is still expected to send checksums
+	uint32_t m_FirstFrame;							// the oldest frame in the ring
+	uint32_t m_NextFrame;							// the oldest frame which hasn't been verified yet
+	uint32_t m_EndFrame;							// one past the newest frame anyone has sent a checksum for
+
+public:
+	CCheckSumLog( );
+
+	bool AddPlayer( unsigned char PID, string name );
+	void RemovePlayer( unsigned char PID );
+	void Add( unsigned char PID, uint32_t frame, uint32_t checkSum );
+
+	// returns true and takes the oldest unverified frame out of the pending frames if every expected player has sent their checksum for it
+	// the frame stays readable with GetCheckSum until it falls out of the history
+
+	bool GetCompleteFrame( uint32_t *frame );
+	bool GetCheckSum( uint32_t frame, unsigned char PID, uint32_t *checkSum );
+
+	// one line per frame in the ring with the checksum each player sent (or dashes if it hasn't arrived yet)
+
+	string GetLog( );
+
+private:
+	void Grow( uint32_t frame );
+};
+
+#endif
@@ -1,17 +1,119 @@
 #include "ghost.h"
 #include "crc32.h"
 
+#ifdef CRC32_PCLMUL
+ #ifdef WIN32
+  #include <intrin.h>
+ #else
+  #include <cpuid.h>
+ #endif
+
+ #include <emmintrin.h>
+ #include <smmintrin.h>
+ #include <wmmintrin.h>
+
+ #ifdef __GNUC__
+  #define CRC32_FOLD_TARGET __attribute__(( target( "sse4.1,pclmul" ) ))
+ #else
+  #define CRC32_FOLD_TARGET
+ #endif
+#endif
+
 void CCRC32 :: Initialize( )
 {
 	for( int iCodes = 0; iCodes <= 0xFF; iCodes++ )
 	{
-		ulTable[iCodes] = Reflect( iCodes, 8 ) << 24;
+		ulTable[0][iCodes] = Reflect( iCodes, 8 ) << 24;
 
 		for( int iPos = 0; iPos < 8; iPos++ )
-			ulTable[iCodes] = ( ulTable[iCodes] << 1 ) ^ ( ulTable[iCodes] & (1 << 31) ? CRC32_POLYNOMIAL : 0 );
+			ulTable[0][iCodes] = ( ulTable[0][iCodes] << 1 ) ^ ( ulTable[0][iCodes] & (1 << 31) ? CRC32_POLYNOMIAL : 0 );
+
+		ulTable[0][iCodes] = Reflect( ulTable[0][iCodes], 32 );
+	}
+
+	// slice-by-8 tables
+	// ulTable[n][i] is the CRC of byte i followed by n zero bytes
+
+	for( int iCodes = 0; iCodes <= 0xFF; iCodes++ )
+	{
+		for( int iSlice = 1; iSlice < 8; iSlice++ )
+			ulTable[iSlice][iCodes] = ( ulTable[iSlice - 1][iCodes] >> 8 ) ^ ulTable[0][ulTable[iSlice - 1][iCodes] & 0xFF];
+	}
+
+	// pick the fastest implementation the CPU supports
+	// if the fast implementation doesn't match the table on the self test (a broken CPU or compiler?) fall back to the table because a wrong CRC corrupts map downloads and replays
+
+	m_FoldSupported = false;
+
+#ifdef CRC32_PCLMUL
+ #ifdef WIN32
+	int CPUInfo[4];
+	__cpuid( CPUInfo, 1 );
+
+	if( ( CPUInfo[2] & ( 1 << 1 ) ) && ( CPUInfo[2] & ( 1 << 19 ) ) )
+		m_FoldSupported = true;
+ #else
+	unsigned int EAX, EBX, ECX, EDX;
+
+	if( __get_cpuid( 1, &EAX, &EBX, &ECX, &EDX ) && ( ECX & bit_PCLMUL ) && ( ECX & bit_SSE4_1 ) )
+		m_FoldSupported = true;
+ #endif
+#endif
+
+	if( !SelfTest( ) )
+		m_Implementation = CRC32_TABLE;
+	else if( m_FoldSupported )
+		m_Implementation = CRC32_FOLD;
+	else
+		m_Implementation = CRC32_SLICE8;
+}
+
+bool CCRC32 :: SetImplementation( uint32_t nImplementation )
+{
+	if( nImplementation > CRC32_FOLD || ( nImplementation == CRC32_FOLD && !m_FoldSupported ) )
+		return false;
+
+	m_Implementation = nImplementation;
+	return true;
+}
 
-		ulTable[iCodes] = Reflect( ulTable[iCodes], 32 );
+bool CCRC32 :: SelfTest( )
+{
+	// compare the selected implementation against the table over every length up to 300 bytes and a few unaligned starting offsets
+
+	unsigned char Data[320];
+	uint32_t Seed = 0x12345678;
+
+	for( int i = 0; i < 320; i++ )
+	{
+		Seed = Seed * 1103515245 + 12345;
+		Data[i] = (unsigned char)( Seed >> 16 );
 	}
+
+	for( uint32_t Offset = 0; Offset < 8; Offset += 3 )
+	{
+		for( uint32_t Length = 0; Length <= 300; Length++ )
+		{
+			uint32_t Expected = 0xFFFFFFFF;
+			uint32_t Actual = 0xFFFFFFFF;
+			PartialCRCTable( &Expected, Data + Offset, Length );
+			PartialCRCSlice8( &Actual, Data + Offset, Length );
+
+			if( Actual != Expected )
+				return false;
+
+			if( m_FoldSupported )
+			{
+				Actual = 0xFFFFFFFF;
+				PartialCRCFold( &Actual, Data + Offset, Length );
+
+				if( Actual != Expected )
+					return false;
+			}
+		}
+	}
+
+	return true;
 }
 
 uint32_t CCRC32 :: Reflect( uint32_t ulReflect, char cChar )
@@ -37,7 +139,154 @@ uint32_t CCRC32 :: FullCRC( unsigned char *sData, uint32_t ulLength )
 }
 
 void CCRC32 :: PartialCRC( uint32_t *ulInCRC, unsigned char *sData, uint32_t ulLength )
+{
+	if( m_Implementation == CRC32_FOLD )
+		PartialCRCFold( ulInCRC, sData, ulLength );
+	else if( m_Implementation == CRC32_SLICE8 )
+		PartialCRCSlice8( ulInCRC, sData, ulLength );
+	else
+		PartialCRCTable( ulInCRC, sData, ulLength );
+}
+
+void CCRC32 :: PartialCRCTable( uint32_t *ulInCRC, unsigned char *sData, uint32_t ulLength )
 {
 	while( ulLength-- )
-		*ulInCRC = ( *ulInCRC >> 8 ) ^ ulTable[( *ulInCRC & 0xFF ) ^ *sData++];
+		*ulInCRC = ( *ulInCRC >> 8 ) ^ ulTable[0][( *ulInCRC & 0xFF ) ^ *sData++];
+}
+
+void CCRC32 :: PartialCRCSlice8( uint32_t *ulInCRC, unsigned char *sData, uint32_t ulLength )
+{
+	// process 8 bytes per iteration with 8 independent table lookups
+	// the words are assembled byte by byte so this works regardless of alignment and endianness
+
+	uint32_t ulCRC = *ulInCRC;
+
+	while( ulLength >= 8 )
+	{
+		uint32_t One = ulCRC ^ ( (uint32_t)sData[0] | (uint32_t)sData[1] << 8 | (uint32_t)sData[2] << 16 | (uint32_t)sData[3] << 24 );
+		uint32_t Two = (uint32_t)sData[4] | (uint32_t)sData[5] << 8 | (uint32_t)sData[6] << 16 | (uint32_t)sData[7] << 24;
+
+		ulCRC = ulTable[7][One & 0xFF] ^ ulTable[6][( One >> 8 ) & 0xFF] ^ ulTable[5][( One >> 16 ) & 0xFF] ^ ulTable[4][One >> 24] ^
+			ulTable[3][Two & 0xFF] ^ ulTable[2][( Two >> 8 ) & 0xFF] ^ ulTable[1][( Two >> 16 ) & 0xFF] ^ ulTable[0][Two >> 24];
+
+		sData += 8;
+		ulLength -= 8;
+	}
+
+	while( ulLength-- )
+		ulCRC = ( ulCRC >> 8 ) ^ ulTable[0][( ulCRC & 0xFF ) ^ *sData++];
+
+	*ulInCRC = ulCRC;
+}
+
+#ifdef CRC32_PCLMUL
+
+// carry-less multiplication folding as described in Intel's "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction"
+// the constants are for the bit reflected CRC32 polynomial 0xEDB88320 (the same ones zlib uses)
+// this requires at least 64 bytes and processes a multiple of 16 bytes
+
+CRC32_FOLD_TARGET static uint32_t FoldCRC( uint32_t ulCRC, unsigned char *sData, uint32_t ulLength )
+{
+	const __m128i K1K2 = _mm_set_epi64x( 0x01c6e41596LL, 0x0154442bd4LL );
+	const __m128i K3K4 = _mm_set_epi64x( 0x00ccaa009eLL, 0x01751997d0LL );
+	const __m128i K5K0 = _mm_set_epi64x( 0, 0x0163cd6124LL );
+	const __m128i Poly = _mm_set_epi64x( 0x01f7011641LL, 0x01db710641LL );
+	const __m128i Mask = _mm_setr_epi32( ~0, 0, ~0, 0 );
+
+	__m128i X1 = _mm_loadu_si128( (__m128i *)( sData + 0x00 ) );
+	__m128i X2 = _mm_loadu_si128( (__m128i *)( sData + 0x10 ) );
+	__m128i X3 = _mm_loadu_si128( (__m128i *)( sData + 0x20 ) );
+	__m128i X4 = _mm_loadu_si128( (__m128i *)( sData + 0x30 ) );
+	__m128i X5, X6, X7, X8;
+
+	X1 = _mm_xor_si128( X1, _mm_cvtsi32_si128( ulCRC ) );
+	sData += 64;
+	ulLength -= 64;
+
+	// fold 4 x 128 bits in parallel
+
+	while( ulLength >= 64 )
+	{
+		X5 = _mm_clmulepi64_si128( X1, K1K2, 0x00 );
+		X6 = _mm_clmulepi64_si128( X2, K1K2, 0x00 );
+		X7 = _mm_clmulepi64_si128( X3, K1K2, 0x00 );
+		X8 = _mm_clmulepi64_si128( X4, K1K2, 0x00 );
+
+		X1 = _mm_clmulepi64_si128( X1, K1K2, 0x11 );
+		X2 = _mm_clmulepi64_si128( X2, K1K2, 0x11 );
+		X3 = _mm_clmulepi64_si128( X3, K1K2, 0x11 );
+		X4 = _mm_clmulepi64_si128( X4, K1K2, 0x11 );
+
+		X1 = _mm_xor_si128( _mm_xor_si128( X1, X5 ), _mm_loadu_si128( (__m128i *)( sData + 0x00 ) ) );
+		X2 = _mm_xor_si128( _mm_xor_si128( X2, X6 ), _mm_loadu_si128( (__m128i *)( sData + 0x10 ) ) );
+		X3 = _mm_xor_si128( _mm_xor_si128( X3, X7 ), _mm_loadu_si128( (__m128i *)( sData + 0x20 ) ) );
+		X4 = _mm_xor_si128( _mm_xor_si128( X4, X8 ), _mm_loadu_si128( (__m128i *)( sData + 0x30 ) ) );
+
+		sData += 64;
+		ulLength -= 64;
+	}
+
+	// fold the 4 x 128 bits into 128 bits
+
+	X5 = _mm_clmulepi64_si128( X1, K3K4, 0x00 );
+	X1 = _mm_clmulepi64_si128( X1, K3K4, 0x11 );
+	X1 = _mm_xor_si128( _mm_xor_si128( X1, X2 ), X5 );
+
+	X5 = _mm_clmulepi64_si128( X1, K3K4, 0x00 );
+	X1 = _mm_clmulepi64_si128( X1, K3K4, 0x11 );
+	X1 = _mm_xor_si128( _mm_xor_si128( X1, X3 ), X5 );
+
+	X5 = _mm_clmulepi64_si128( X1, K3K4, 0x00 );
+	X1 = _mm_clmulepi64_si128( X1, K3K4, 0x11 );
+	X1 = _mm_xor_si128( _mm_xor_si128( X1, X4 ), X5 );
+
+	// fold any remaining 16 byte blocks
+
+	while( ulLength >= 16 )
+	{
+		X5 = _mm_clmulepi64_si128( X1, K3K4, 0x00 );
+		X1 = _mm_clmulepi64_si128( X1, K3K4, 0x11 );
+		X1 = _mm_xor_si128( _mm_xor_si128( X1, _mm_loadu_si128( (__m128i *)sData ) ), X5 );
+		sData += 16;
+		ulLength -= 16;
+	}
+
+	// fold 128 bits into 64 bits
+
+	X2 = _mm_clmulepi64_si128( X1, K3K4, 0x10 );
+	X1 = _mm_xor_si128( _mm_srli_si128( X1, 8 ), X2 );
+
+	X2 = _mm_srli_si128( X1, 4 );
+	X1 = _mm_and_si128( X1, Mask );
+	X1 = _mm_clmulepi64_si128( X1, K5K0, 0x00 );
+	X1 = _mm_xor_si128( X1, X2 );
+
+	// Barrett reduction to 32 bits
+
+	X2 = _mm_and_si128( X1, Mask );
+	X2 = _mm_clmulepi64_si128( X2, Poly, 0x10 );
+	X2 = _mm_and_si128( X2, Mask );
+	X2 = _mm_clmulepi64_si128( X2, Poly, 0x00 );
+	X1 = _mm_xor_si128( X1, X2 );
+
+	return (uint32_t)_mm_extract_epi32( X1, 1 );
+}
+
+#endif
+
+void CCRC32 :: PartialCRCFold( uint32_t *ulInCRC, unsigned char *sData, uint32_t ulLength )
+{
+#ifdef CRC32_PCLMUL
+	// folding has a fixed setup cost so it's only worth it for larger buffers (the map parts are 1442 bytes)
+
+	if( m_FoldSupported && ulLength >= 64 )
+	{
+		uint32_t ulFoldLength = ulLength & ~15;
+		*ulInCRC = FoldCRC( *ulInCRC, sData, ulFoldLength );
+		sData += ulFoldLength;
+		ulLength -= ulFoldLength;
+	}
+#endif
+
+	PartialCRCSlice8( ulInCRC, sData, ulLength );
 }
@@ -3,6 +3,17 @@
 
 #define CRC32_POLYNOMIAL 0x04c11db7
 
+// the PCLMULQDQ implementation is only available on x86 and x64 and is selected at runtime if the CPU supports it
+// every other platform uses slice-by-8 which is portable and still about 4x faster than the byte at a time table
+
+#if defined( __x86_64__ ) || defined( __i386__ ) || defined( _M_X64 ) || defined( _M_IX86 )
+ #define CRC32_PCLMUL
+#endif
+
+#define CRC32_TABLE		0		// byte at a time
+#define CRC32_SLICE8	1		// slice-by-8
+#define CRC32_FOLD		2		// PCLMULQDQ folding (slice-by-8 for the leftover bytes)
+
 class CCRC32
 {
 public:
@@ -10,9 +21,22 @@ public:
 	uint32_t FullCRC( unsigned char *sData, uint32_t ulLength );
 	void PartialCRC( uint32_t *ulInCRC, unsigned char *sData, uint32_t ulLength );
 
+	// these are public so the implementations can be compared against each other
+	// they all calculate exactly the same CRC, PartialCRC just calls the fastest one the CPU supports
+
+	void PartialCRCTable( uint32_t *ulInCRC, unsigned char *sData, uint32_t ulLength );
+	void PartialCRCSlice8( uint32_t *ulInCRC, unsigned char *sData, uint32_t ulLength );
+	void PartialCRCFold( uint32_t *ulInCRC, unsigned char *sData, uint32_t ulLength );
+
+	uint32_t GetImplementation( )					{ return m_Implementation; }
+	bool SetImplementation( uint32_t nImplementation );
+
 private:
 	uint32_t Reflect( uint32_t ulReflect, char cChar );
-	uint32_t ulTable[256];
+	bool SelfTest( );
+	uint32_t ulTable[8][256];
+	uint32_t m_Implementation;				// CRC32_TABLE, CRC32_SLICE8 or CRC32_FOLD
+	bool m_FoldSupported;					// if the CPU supports PCLMULQDQ and SSE4.1 or not
 };
 
 #endif
@@ -0,0 +1,63 @@
+/*
+
+   Copyright [2008] [Trevor Hogan]
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+   CODE PORTED FROM THE ORIGINAL GHOST PROJECT: http://ghost.pwner.org/
+
+*/
+
+#include "ghost.h"
+#include "floodcontrol.h"
+
+//
+// CFloodControl
+//
+
+CFloodControl :: CFloodControl( uint32_t nRate, uint32_t nBurst, uint32_t nOverhead, uint32_t ticks )
+{
+	m_Rate = nRate;
+	m_Burst = nBurst;
+	m_Overhead = nOverhead;
+	m_Tokens = 0;
+	m_LastTicks = ticks;
+}
+
+void CFloodControl :: Reset( uint32_t ticks )
+{
+	m_Tokens = (int64_t)m_Burst * 1000;
+	m_LastTicks = ticks;
+}
+
+void CFloodControl :: Refill( uint32_t ticks )
+{
+	m_Tokens += (int64_t)( ticks - m_LastTicks ) * m_Rate;
+	m_LastTicks = ticks;
+
+	if( m_Tokens > (int64_t)m_Burst * 1000 )
+		m_Tokens = (int64_t)m_Burst * 1000;
+}
+
+bool CFloodControl :: CanSend( )
+{
+	return m_Tokens >= 0;
+}
+
+void CFloodControl :: Sent( uint32_t size )
+{
+	m_Tokens -= ( (int64_t)size + m_Overhead ) * 1000;
+
+	if( m_Tokens < -(int64_t)m_Rate * FLOODCONTROL_MAXDEBT )
+		m_Tokens = -(int64_t)m_Rate * FLOODCONTROL_MAXDEBT;
+}
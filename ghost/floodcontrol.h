@@ -0,0 +1,54 @@
+/*
+
+   Copyright [2008] [Trevor Hogan]
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+   CODE PORTED FROM THE ORIGINAL GHOST PROJECT: http://ghost.pwner.org/
+
+*/
+
+#ifndef FLOODCONTROL_H
+#define FLOODCONTROL_H
+
+//
+// CFloodControl
+//
+
+// the battle.net flood control token bucket, every packet costs its size plus a fixed overhead and the bucket refills at a fixed rate
+// a packet can be sent whenever the bucket isn't in debt and its cost is taken out afterwards, so how long the next packet waits depends on the packet before it like it did with the old fixed delays
+// a few short messages can be sent at once after being idle but long messages are spaced out
+// the debt is limited to 4 seconds worth of refill (the longest the old fixed delays ever waited) so a 255 character message doesn't hold up the next one for twice as long
+// the defaults are tuned so no message waits longer than the old fixed delays did (1 second after a packet under 10 bytes, 3.5 seconds under 100 bytes and 4 seconds otherwise)
+
+#define FLOODCONTROL_MAXDEBT	4000		// the longest a single packet can hold up the next one in milliseconds
+
+class CFloodControl
+{
+private:
+	uint32_t m_Rate;						// how many bytes per second we can send
+	uint32_t m_Burst;						// the size of the bucket in bytes
+	uint32_t m_Overhead;					// how many bytes each packet costs on top of its size
+	int64_t m_Tokens;						// the bucket in thousandths of a byte, negative while in debt
+	uint32_t m_LastTicks;					// GetTicks when the bucket was last refilled
+
+public:
+	CFloodControl( uint32_t nRate, uint32_t nBurst, uint32_t nOverhead, uint32_t ticks );
+
+	void Reset( uint32_t ticks );						// fill the bucket (e.g. after connecting)
+	void Refill( uint32_t ticks );						// add the tokens for the time since the last refill
+	bool CanSend( );									// if a packet can be sent now (call Refill first)
+	void Sent( uint32_t size );							// take the cost of a packet of this size out of the bucket
+};
+
+#endif
@@ -30,16 +30,21 @@
 #include "savegame.h"
 #include "gameplayer.h"
 #include "gameprotocol.h"
+#include "timerwheel.h"
 #include "game_base.h"
 #include "game.h"
 #include "stats.h"
 #include "statsdota.h"
 #include "statsw3mmd.h"
+#include "statsworker.h"
+#include "summarycache.h"
 
 #include <cmath>
 #include <string.h>
 #include <time.h>
 
+#include <boost/unordered_map.hpp>
+
 //
 // sorting classes
 //
@@ -78,11 +83,22 @@ CGame :: CGame( CGHost *nGHost, CMap *nMap, CSaveGame *nSaveGame, uint16_t nHost
 	else
 		m_Stats = NULL;
 
+	m_StatsQueue = NULL;
 	m_CallableGameAdd = NULL;
 }
 
 CGame :: ~CGame( )
 {
+	// take the stats back from the stats worker and process whatever it hasn't got to yet before saving them
+
+	if( m_StatsQueue )
+	{
+		m_GHost->m_StatsWorker->Remove( m_StatsQueue );
+		m_StatsQueue->Drain( );
+		delete m_StatsQueue;
+		m_StatsQueue = NULL;
+	}
+
 	if( m_CallableGameAdd && m_CallableGameAdd->GetReady( ) )
 	{
 		if( m_CallableGameAdd->GetResult( ) > 0 )
@@ -90,14 +106,21 @@ CGame :: ~CGame( )
 			CONSOLE_Print( "[GAME: " + m_GameName + "] saving player/stats data to database" );
 
 			// store the CDBGamePlayers in the database
+			// this also makes any cached !stats results of these players out of date so the summary cache waits for these writes
 
 			for( vector<CDBGamePlayer *> :: iterator i = m_DBGamePlayers.begin( ); i != m_DBGamePlayers.end( ); i++ )
-				m_GHost->m_Callables.push_back( m_GHost->m_DB->ThreadedGamePlayerAdd( m_GameId, (*i)->GetName( ), (*i)->GetIP( ), (*i)->GetSpoofed( ), (*i)->GetSpoofedRealm( ), (*i)->GetReserved( ), (*i)->GetLoadingTime( ), (*i)->GetLeft( ), (*i)->GetLeftReason( ), (*i)->GetTeam( ), (*i)->GetColour( ), (*i)->GetPlayerId( ) ) );
+				m_GHost->m_SummaryCache->AddWrite( (*i)->GetName( ), m_GHost->m_DB->ThreadedGamePlayerAdd( m_GameId, (*i)->GetName( ), (*i)->GetIP( ), (*i)->GetSpoofed( ), (*i)->GetSpoofedRealm( ), (*i)->GetReserved( ), (*i)->GetLoadingTime( ), (*i)->GetLeft( ), (*i)->GetLeftReason( ), (*i)->GetTeam( ), (*i)->GetColour( ), (*i)->GetPlayerId( ) ) );
 
 			// store the stats in the database
+			// the realms are taken from the gameplayers because a player's spoof check might have completed after the game started
 
 			if( m_Stats )
+			{
+				for( vector<CDBGamePlayer *> :: iterator i = m_DBGamePlayers.begin( ); i != m_DBGamePlayers.end( ); i++ )
+					m_Stats->SetColourPlayer( (*i)->GetColour( ), (*i)->GetName( ), (*i)->GetSpoofedRealm( ) );
+
 				m_Stats->Save( m_GHost, m_GHost->m_DB, m_GameId );
+			}
 		}
 		else
 			CONSOLE_Print( "[GAME: " + m_GameName + "] unable to save player/stats data to database" );
@@ -113,12 +136,6 @@ CGame :: ~CGame( )
 	for( vector<PairedBanAdd> :: iterator i = m_PairedBanAdds.begin( ); i != m_PairedBanAdds.end( ); i++ )
 		m_GHost->m_Callables.push_back( i->second );
 
-	for( vector<PairedGPSCheck> :: iterator i = m_PairedGPSChecks.begin( ); i != m_PairedGPSChecks.end( ); i++ )
-		m_GHost->m_Callables.push_back( i->second );
-
-	for( vector<PairedDPSCheck> :: iterator i = m_PairedDPSChecks.begin( ); i != m_PairedDPSChecks.end( ); i++ )
-		m_GHost->m_Callables.push_back( i->second );
-
 	for( vector<CDBBan *> :: iterator i = m_DBBans.begin( ); i != m_DBBans.end( ); i++ )
 		delete *i;
 
@@ -179,37 +196,35 @@ bool CGame :: Update( void *fd, void *send_fd )
 
 	for( vector<PairedGPSCheck> :: iterator i = m_PairedGPSChecks.begin( ); i != m_PairedGPSChecks.end( ); )
 	{
-		if( i->second->GetReady( ) )
-		{
-			CDBGamePlayerSummary *GamePlayerSummary = i->second->GetResult( );
+		CDBGamePlayerSummary *GamePlayerSummary = NULL;
 
+		if( m_GHost->m_SummaryCache->GetGamePlayerSummary( i->second, &GamePlayerSummary ) == SUMMARY_READY )
+		{
 			if( GamePlayerSummary )
 			{
 				if( i->first.empty( ) )
-					SendAllChat( m_GHost->m_Language->HasPlayedGamesWithThisBot( i->second->GetName( ), GamePlayerSummary->GetFirstGameDateTime( ), GamePlayerSummary->GetLastGameDateTime( ), UTIL_ToString( GamePlayerSummary->GetTotalGames( ) ), UTIL_ToString( (float)GamePlayerSummary->GetAvgLoadingTime( ) / 1000, 2 ), UTIL_ToString( GamePlayerSummary->GetAvgLeftPercent( ) ) ) );
+					SendAllChat( m_GHost->m_Language->HasPlayedGamesWithThisBot( i->second, GamePlayerSummary->GetFirstGameDateTime( ), GamePlayerSummary->GetLastGameDateTime( ), UTIL_ToString( GamePlayerSummary->GetTotalGames( ) ), UTIL_ToString( (float)GamePlayerSummary->GetAvgLoadingTime( ) / 1000, 2 ), UTIL_ToString( GamePlayerSummary->GetAvgLeftPercent( ) ) ) );
 				else
 				{
 					CGamePlayer *Player = GetPlayerFromName( i->first, true );
 
 					if( Player )
-						SendChat( Player, m_GHost->m_Language->HasPlayedGamesWithThisBot( i->second->GetName( ), GamePlayerSummary->GetFirstGameDateTime( ), GamePlayerSummary->GetLastGameDateTime( ), UTIL_ToString( GamePlayerSummary->GetTotalGames( ) ), UTIL_ToString( (float)GamePlayerSummary->GetAvgLoadingTime( ) / 1000, 2 ), UTIL_ToString( GamePlayerSummary->GetAvgLeftPercent( ) ) ) );
+						SendChat( Player, m_GHost->m_Language->HasPlayedGamesWithThisBot( i->second, GamePlayerSummary->GetFirstGameDateTime( ), GamePlayerSummary->GetLastGameDateTime( ), UTIL_ToString( GamePlayerSummary->GetTotalGames( ) ), UTIL_ToString( (float)GamePlayerSummary->GetAvgLoadingTime( ) / 1000, 2 ), UTIL_ToString( GamePlayerSummary->GetAvgLeftPercent( ) ) ) );
 				}
 			}
 			else
 			{
 				if( i->first.empty( ) )
-					SendAllChat( m_GHost->m_Language->HasntPlayedGamesWithThisBot( i->second->GetName( ) ) );
+					SendAllChat( m_GHost->m_Language->HasntPlayedGamesWithThisBot( i->second ) );
 				else
 				{
 					CGamePlayer *Player = GetPlayerFromName( i->first, true );
 
 					if( Player )
-						SendChat( Player, m_GHost->m_Language->HasntPlayedGamesWithThisBot( i->second->GetName( ) ) );
+						SendChat( Player, m_GHost->m_Language->HasntPlayedGamesWithThisBot( i->second ) );
 				}
 			}
 
-			m_GHost->m_DB->RecoverCallable( i->second );
-			delete i->second;
 			i = m_PairedGPSChecks.erase( i );
 		}
 		else
@@ -218,13 +233,13 @@ bool CGame :: Update( void *fd, void *send_fd )
 
 	for( vector<PairedDPSCheck> :: iterator i = m_PairedDPSChecks.begin( ); i != m_PairedDPSChecks.end( ); )
 	{
-		if( i->second->GetReady( ) )
-		{
-			CDBDotAPlayerSummary *DotAPlayerSummary = i->second->GetResult( );
+		CDBDotAPlayerSummary *DotAPlayerSummary = NULL;
 
+		if( m_GHost->m_SummaryCache->GetDotAPlayerSummary( i->second, &DotAPlayerSummary ) == SUMMARY_READY )
+		{
 			if( DotAPlayerSummary )
 			{
-				string Summary = m_GHost->m_Language->HasPlayedDotAGamesWithThisBot(	i->second->GetName( ),
+				string Summary = m_GHost->m_Language->HasPlayedDotAGamesWithThisBot(	i->second,
 																						UTIL_ToString( DotAPlayerSummary->GetTotalGames( ) ),
 																						UTIL_ToString( DotAPlayerSummary->GetTotalWins( ) ),
 																						UTIL_ToString( DotAPlayerSummary->GetTotalLosses( ) ),
@@ -260,24 +275,37 @@ bool CGame :: Update( void *fd, void *send_fd )
 			else
 			{
 				if( i->first.empty( ) )
-					SendAllChat( m_GHost->m_Language->HasntPlayedDotAGamesWithThisBot( i->second->GetName( ) ) );
+					SendAllChat( m_GHost->m_Language->HasntPlayedDotAGamesWithThisBot( i->second ) );
 				else
 				{
 					CGamePlayer *Player = GetPlayerFromName( i->first, true );
 
 					if( Player )
-						SendChat( Player, m_GHost->m_Language->HasntPlayedDotAGamesWithThisBot( i->second->GetName( ) ) );
+						SendChat( Player, m_GHost->m_Language->HasntPlayedDotAGamesWithThisBot( i->second ) );
 				}
 			}
 
-			m_GHost->m_DB->RecoverCallable( i->second );
-			delete i->second;
 			i = m_PairedDPSChecks.erase( i );
 		}
 		else
 			i++;
 	}
 
+	// check if the stats worker has found out the game is over
+
+	if( m_StatsQueue )
+	{
+		m_StatsQueue->Flush( );
+
+		if( m_StatsQueue->GetGameOver( ) && m_GameOverTime == 0 )
+		{
+			CONSOLE_Print( "[GAME: " + m_GameName + "] gameover timer started (stats class reported game over)" );
+			SendEndMessage( );
+			m_GameOverTime = GetTime( );
+			m_GHost->m_Timers->ScheduleIn( &m_GameOverTimer, 60000 );
+		}
+	}
+
 	return CBaseGame :: Update( fd, send_fd );
 }
 
@@ -322,13 +350,97 @@ void CGame :: EventPlayerAction( CGamePlayer *player, CIncomingAction *action )
 	CBaseGame :: EventPlayerAction( player, action );
 
 	// give the stats class a chance to process the action
+	// if the stats worker is running the action is just copied into its queue and the result is checked in Update
 
-	if( m_Stats && m_Stats->ProcessAction( action ) && m_GameOverTime == 0 )
+	if( m_StatsQueue )
+		m_StatsQueue->Push( action );
+	else if( m_Stats && m_Stats->ProcessAction( action ) && m_GameOverTime == 0 )
 	{
 		CONSOLE_Print( "[GAME: " + m_GameName + "] gameover timer started (stats class reported game over)" );
 		SendEndMessage( );
 		m_GameOverTime = GetTime( );
+		m_GHost->m_Timers->ScheduleIn( &m_GameOverTimer, 60000 );
+	}
+}
+
+CBotCommand *CGame :: GetBotCommand( string command )
+{
+	// every command and alias is registered once in a hash table so looking up a command doesn't depend on how many commands there are
+	// note: the table is shared by all games and only ever used from the main thread
+
+	static boost :: unordered_map<string, CBotCommand> Commands;
+
+	if( Commands.empty( ) )
+	{
+		Commands["abort"] = CBotCommand( CBotCommand :: ABORT, BOTCOMMAND_ACCESS_ADMIN, BOTCOMMAND_IF_COUNTDOWN | BOTCOMMAND_IF_LOBBY );
+		Commands["a"] = CBotCommand( CBotCommand :: ABORT, BOTCOMMAND_ACCESS_ADMIN, BOTCOMMAND_IF_COUNTDOWN | BOTCOMMAND_IF_LOBBY );
+		Commands["addban"] = CBotCommand( CBotCommand :: ADDBAN, BOTCOMMAND_ACCESS_ADMIN, BOTCOMMAND_IF_PAYLOAD | BOTCOMMAND_IF_BNET );
+		Commands["ban"] = CBotCommand( CBotCommand :: ADDBAN, BOTCOMMAND_ACCESS_ADMIN, BOTCOMMAND_IF_PAYLOAD | BOTCOMMAND_IF_BNET );
+		Commands["announce"] = CBotCommand( CBotCommand :: ANNOUNCE, BOTCOMMAND_ACCESS_ADMIN, BOTCOMMAND_IF_NOTSTARTED );
+		Commands["autosave"] = CBotCommand( CBotCommand :: AUTOSAVE, BOTCOMMAND_ACCESS_ADMIN, 0 );
+		Commands["autostart"] = CBotCommand( CBotCommand :: AUTOSTART, BOTCOMMAND_ACCESS_ADMIN, BOTCOMMAND_IF_NOTSTARTED );
+		Commands["banlast"] = CBotCommand( CBotCommand :: BANLAST, BOTCOMMAND_ACCESS_ADMIN, BOTCOMMAND_IF_LOADED | BOTCOMMAND_IF_BNET );
+		Commands["check"] = CBotCommand( CBotCommand :: CHECK, BOTCOMMAND_ACCESS_ADMIN, 0 );
+		Commands["checkban"] = CBotCommand( CBotCommand :: CHECKBAN, BOTCOMMAND_ACCESS_ADMIN, BOTCOMMAND_IF_PAYLOAD | BOTCOMMAND_IF_BNET );
+		Commands["clearhcl"] = CBotCommand( CBotCommand :: CLEARHCL, BOTCOMMAND_ACCESS_ADMIN, BOTCOMMAND_IF_NOTSTARTED );
+		Commands["close"] = CBotCommand( CBotCommand :: CLOSE, BOTCOMMAND_ACCESS_ADMIN, BOTCOMMAND_IF_PAYLOAD | BOTCOMMAND_IF_LOBBY );
+		Commands["closeall"] = CBotCommand( CBotCommand :: CLOSEALL, BOTCOMMAND_ACCESS_ADMIN, BOTCOMMAND_IF_LOBBY );
+		Commands["comp"] = CBotCommand( CBotCommand :: COMP, BOTCOMMAND_ACCESS_ADMIN, BOTCOMMAND_IF_PAYLOAD | BOTCOMMAND_IF_LOBBY | BOTCOMMAND_IF_NOTSAVEGAME );
+		Commands["compcolour"] = CBotCommand( CBotCommand :: COMPCOLOUR, BOTCOMMAND_ACCESS_ADMIN, BOTCOMMAND_IF_PAYLOAD | BOTCOMMAND_IF_LOBBY | BOTCOMMAND_IF_NOTSAVEGAME );
+		Commands["comphandicap"] = CBotCommand( CBotCommand :: COMPHANDICAP, BOTCOMMAND_ACCESS_ADMIN, BOTCOMMAND_IF_PAYLOAD | BOTCOMMAND_IF_LOBBY | BOTCOMMAND_IF_NOTSAVEGAME );
+		Commands["comprace"] = CBotCommand( CBotCommand :: COMPRACE, BOTCOMMAND_ACCESS_ADMIN, BOTCOMMAND_IF_PAYLOAD | BOTCOMMAND_IF_LOBBY | BOTCOMMAND_IF_NOTSAVEGAME );
+		Commands["compteam"] = CBotCommand( CBotCommand :: COMPTEAM, BOTCOMMAND_ACCESS_ADMIN, BOTCOMMAND_IF_PAYLOAD | BOTCOMMAND_IF_LOBBY | BOTCOMMAND_IF_NOTSAVEGAME );
+		Commands["dbstatus"] = CBotCommand( CBotCommand :: DBSTATUS, BOTCOMMAND_ACCESS_ADMIN, 0 );
+		Commands["download"] = CBotCommand( CBotCommand :: DOWNLOAD, BOTCOMMAND_ACCESS_ADMIN, BOTCOMMAND_IF_PAYLOAD | BOTCOMMAND_IF_LOBBY );
+		Commands["dl"] = CBotCommand( CBotCommand :: DOWNLOAD, BOTCOMMAND_ACCESS_ADMIN, BOTCOMMAND_IF_PAYLOAD | BOTCOMMAND_IF_LOBBY );
+		Commands["drop"] = CBotCommand( CBotCommand :: DROP, BOTCOMMAND_ACCESS_ADMIN, BOTCOMMAND_IF_LOADED );
+		Commands["end"] = CBotCommand( CBotCommand :: END, BOTCOMMAND_ACCESS_ADMIN, BOTCOMMAND_IF_LOADED );
+		Commands["fakeplayer"] = CBotCommand( CBotCommand :: FAKEPLAYER, BOTCOMMAND_ACCESS_ADMIN, BOTCOMMAND_IF_NOTSTARTED );
+		Commands["fppause"] = CBotCommand( CBotCommand :: FPPAUSE, BOTCOMMAND_ACCESS_ADMIN, BOTCOMMAND_IF_LOADED );
+		Commands["fpresume"] = CBotCommand( CBotCommand :: FPRESUME, BOTCOMMAND_ACCESS_ADMIN, BOTCOMMAND_IF_LOADED );
+		Commands["from"] = CBotCommand( CBotCommand :: FROM, BOTCOMMAND_ACCESS_ADMIN, 0 );
+		Commands["hcl"] = CBotCommand( CBotCommand :: HCL, BOTCOMMAND_ACCESS_ADMIN, BOTCOMMAND_IF_NOTSTARTED );
+		Commands["hold"] = CBotCommand( CBotCommand :: HOLD, BOTCOMMAND_ACCESS_ADMIN, BOTCOMMAND_IF_PAYLOAD | BOTCOMMAND_IF_LOBBY );
+		Commands["kick"] = CBotCommand( CBotCommand :: KICK, BOTCOMMAND_ACCESS_ADMIN, BOTCOMMAND_IF_PAYLOAD );
+		Commands["latency"] = CBotCommand( CBotCommand :: LATENCY, BOTCOMMAND_ACCESS_ADMIN, 0 );
+		Commands["lock"] = CBotCommand( CBotCommand :: LOCK, BOTCOMMAND_ACCESS_ROOTADMIN, 0 );
+		Commands["messages"] = CBotCommand( CBotCommand :: MESSAGES, BOTCOMMAND_ACCESS_ADMIN, 0 );
+		Commands["mute"] = CBotCommand( CBotCommand :: MUTE, BOTCOMMAND_ACCESS_ADMIN, 0 );
+		Commands["muteall"] = CBotCommand( CBotCommand :: MUTEALL, BOTCOMMAND_ACCESS_ADMIN, BOTCOMMAND_IF_LOADED );
+		Commands["open"] = CBotCommand( CBotCommand :: OPEN, BOTCOMMAND_ACCESS_ADMIN, BOTCOMMAND_IF_PAYLOAD | BOTCOMMAND_IF_LOBBY );
+		Commands["openall"] = CBotCommand( CBotCommand :: OPENALL, BOTCOMMAND_ACCESS_ADMIN, BOTCOMMAND_IF_LOBBY );
+		Commands["owner"] = CBotCommand( CBotCommand :: OWNER, BOTCOMMAND_ACCESS_ADMIN, 0 );
+		Commands["ping"] = CBotCommand( CBotCommand :: PING, BOTCOMMAND_ACCESS_ADMIN, 0 );
+		Commands["priv"] = CBotCommand( CBotCommand :: PRIV, BOTCOMMAND_ACCESS_ADMIN, BOTCOMMAND_IF_PAYLOAD | BOTCOMMAND_IF_NOTSTARTED | BOTCOMMAND_IF_NOTSAVEGAME );
+		Commands["pub"] = CBotCommand( CBotCommand :: PUB, BOTCOMMAND_ACCESS_ADMIN, BOTCOMMAND_IF_PAYLOAD | BOTCOMMAND_IF_NOTSTARTED | BOTCOMMAND_IF_NOTSAVEGAME );
+		Commands["refresh"] = CBotCommand( CBotCommand :: REFRESH, BOTCOMMAND_ACCESS_ADMIN, BOTCOMMAND_IF_NOTSTARTED );
+		Commands["say"] = CBotCommand( CBotCommand :: SAY, BOTCOMMAND_ACCESS_ADMIN, BOTCOMMAND_IF_PAYLOAD );
+		Commands["sendlan"] = CBotCommand( CBotCommand :: SENDLAN, BOTCOMMAND_ACCESS_ADMIN, BOTCOMMAND_IF_PAYLOAD | BOTCOMMAND_IF_NOTSTARTED );
+		Commands["sp"] = CBotCommand( CBotCommand :: SP, BOTCOMMAND_ACCESS_ADMIN, BOTCOMMAND_IF_NOTSTARTED );
+		Commands["start"] = CBotCommand( CBotCommand :: START, BOTCOMMAND_ACCESS_ADMIN, BOTCOMMAND_IF_NOTSTARTED );
+		Commands["swap"] = CBotCommand( CBotCommand :: SWAP, BOTCOMMAND_ACCESS_ADMIN, BOTCOMMAND_IF_PAYLOAD | BOTCOMMAND_IF_LOBBY );
+		Commands["synclimit"] = CBotCommand( CBotCommand :: SYNCLIMIT, BOTCOMMAND_ACCESS_ADMIN, 0 );
+		Commands["unhost"] = CBotCommand( CBotCommand :: UNHOST, BOTCOMMAND_ACCESS_ADMIN, BOTCOMMAND_IF_NOTSTARTED );
+		Commands["unlock"] = CBotCommand( CBotCommand :: UNLOCK, BOTCOMMAND_ACCESS_ROOTADMIN, 0 );
+		Commands["unmute"] = CBotCommand( CBotCommand :: UNMUTE, BOTCOMMAND_ACCESS_ADMIN, 0 );
+		Commands["unmuteall"] = CBotCommand( CBotCommand :: UNMUTEALL, BOTCOMMAND_ACCESS_ADMIN, BOTCOMMAND_IF_LOADED );
+		Commands["virtualhost"] = CBotCommand( CBotCommand :: VIRTUALHOST, BOTCOMMAND_ACCESS_ADMIN, BOTCOMMAND_IF_PAYLOAD | BOTCOMMAND_IF_NOTSTARTED );
+		Commands["votecancel"] = CBotCommand( CBotCommand :: VOTECANCEL, BOTCOMMAND_ACCESS_ADMIN, 0 );
+		Commands["w"] = CBotCommand( CBotCommand :: W, BOTCOMMAND_ACCESS_ADMIN, BOTCOMMAND_IF_PAYLOAD );
+		Commands["checkme"] = CBotCommand( CBotCommand :: CHECKME, BOTCOMMAND_ACCESS_ANYONE, 0 );
+		Commands["stats"] = CBotCommand( CBotCommand :: STATS, BOTCOMMAND_ACCESS_ANYONE, 0 );
+		Commands["statsdota"] = CBotCommand( CBotCommand :: STATSDOTA, BOTCOMMAND_ACCESS_ANYONE, 0 );
+		Commands["version"] = CBotCommand( CBotCommand :: VERSION, BOTCOMMAND_ACCESS_ANYONE, 0 );
+		Commands["votekick"] = CBotCommand( CBotCommand :: VOTEKICK, BOTCOMMAND_ACCESS_ANYONE, BOTCOMMAND_IF_PAYLOAD );
+		Commands["yes"] = CBotCommand( CBotCommand :: YES, BOTCOMMAND_ACCESS_ANYONE, 0 );
 	}
+
+	boost :: unordered_map<string, CBotCommand> :: iterator i = Commands.find( command );
+
+	if( i != Commands.end( ) )
+		return &i->second;
+
+	return NULL;
 }
 
 bool CGame :: EventPlayerBotCommand( CGamePlayer *player, string command, string payload )
@@ -341,1277 +453,1320 @@ bool CGame :: EventPlayerBotCommand( CGamePlayer *player, string command, string
 	string Command = command;
 	string Payload = payload;
 
-	bool AdminCheck = IsAdmin( User );
-	bool PremiumCheck = IsPremium( User );
-	bool RootAdminCheck = IsRootAdmin( User );
+	// the admin level was resolved when the player joined so these checks don't need to look up the admin list
+
+	bool AdminCheck = player->GetAdminLevel( ) > 4;
+	bool RootAdminCheck = player->GetAdminLevel( ) > 9;
+	bool OwnerCheck = IsOwner( User );
+	uint32_t Access = BOTCOMMAND_ACCESS_ANYONE;
 
-	if( player->GetSpoofed( ) && ( AdminCheck || RootAdminCheck || IsOwner( User ) ) )
+	if( player->GetSpoofed( ) && ( AdminCheck || RootAdminCheck || OwnerCheck ) )
 	{
 		CONSOLE_Print( "[GAME: " + m_GameName + "] admin [" + User + "] sent command [" + Command + "] with payload [" + Payload + "]" );
 
-		if( !m_Locked || RootAdminCheck || IsOwner( User ) )
+		if( RootAdminCheck || OwnerCheck )
+			Access = BOTCOMMAND_ACCESS_ROOTADMIN;
+		else if( !m_Locked )
+			Access = BOTCOMMAND_ACCESS_ADMIN;
+		else
 		{
-			/*****************
-			* ADMIN COMMANDS *
-			******************/
-
-			//
-			// !ABORT (abort countdown)
-			// !A
-			//
+			CONSOLE_Print( "[GAME: " + m_GameName + "] admin command ignored, the game is locked" );
+			SendChat( player, m_GHost->m_Language->TheGameIsLocked( ) );
+		}
+	}
+	else
+	{
+		if( !player->GetSpoofed( ) )
+			CONSOLE_Print( "[GAME: " + m_GameName + "] non-spoofchecked user [" + User + "] sent command [" + Command + "] with payload [" + Payload + "]" );
+		else
+			CONSOLE_Print( "[GAME: " + m_GameName + "] non-admin [" + User + "] sent command [" + Command + "] with payload [" + Payload + "]" );
+	}
 
-			// we use "!a" as an alias for abort because you don't have much time to abort the countdown so it's useful for the abort command to be easy to type
+	CBotCommand *BotCommand = GetBotCommand( Command );
 
-			if( ( Command == "abort" || Command == "a" ) && m_CountDownStarted && !m_GameLoading && !m_GameLoaded )
-			{
-				SendAllChat( m_GHost->m_Language->CountDownAborted( ) );
-				m_CountDownStarted = false;
-			}
+	if( !BotCommand || BotCommand->m_Access > Access )
+		return HideCommand;
 
-			//
-			// !ADDBAN
-			// !BAN
-			//
+	// check the game state the command requires
 
-			if( ( Command == "addban" || Command == "ban" ) && !Payload.empty( ) && !m_GHost->m_BNETs.empty( ) )
-			{
-				// extract the victim and the reason
-				// e.g. "Varlock leaver after dying" -> victim: "Varlock", reason: "leaver after dying"
+	uint32_t Conditions = BotCommand->m_Conditions;
 
-				string Victim;
-				string Reason;
-				stringstream SS;
-				SS << Payload;
-				SS >> Victim;
+	if( ( ( Conditions & BOTCOMMAND_IF_PAYLOAD ) && Payload.empty( ) ) ||
+		( ( Conditions & BOTCOMMAND_IF_NOTSTARTED ) && m_CountDownStarted ) ||
+		( ( Conditions & BOTCOMMAND_IF_COUNTDOWN ) && !m_CountDownStarted ) ||
+		( ( Conditions & BOTCOMMAND_IF_LOBBY ) && ( m_GameLoading || m_GameLoaded ) ) ||
+		( ( Conditions & BOTCOMMAND_IF_LOADED ) && !m_GameLoaded ) ||
+		( ( Conditions & BOTCOMMAND_IF_NOTSAVEGAME ) && m_SaveGame ) ||
+		( ( Conditions & BOTCOMMAND_IF_BNET ) && m_GHost->m_BNETs.empty( ) ) )
+		return HideCommand;
 
-				if( !SS.eof( ) )
-				{
-					getline( SS, Reason );
-					string :: size_type Start = Reason.find_first_not_of( " " );
+	switch( BotCommand->m_ID )
+	{
+	/*****************
+	* ADMIN COMMANDS *
+	******************/
 
-					if( Start != string :: npos )
-						Reason = Reason.substr( Start );
-				}
+	//
+	// !ABORT (abort countdown)
+	// !A
+	//
 
-				if( m_GameLoaded )
-				{
-					string VictimLower = Victim;
-					transform( VictimLower.begin( ), VictimLower.end( ), VictimLower.begin( ), (int(*)(int))tolower );
-					uint32_t Matches = 0;
-					CDBBan *LastMatch = NULL;
+	// we use "!a" as an alias for abort because you don't have much time to abort the countdown so it's useful for the abort command to be easy to type
 
-					// try to match each player with the passed string (e.g. "Varlock" would be matched with "lock")
-					// we use the m_DBBans vector for this in case the player already left and thus isn't in the m_Players vector anymore
+	case CBotCommand :: ABORT:
+		SendAllChat( m_GHost->m_Language->CountDownAborted( ) );
+		m_CountDownStarted = false;
+		break;
 
-					for( vector<CDBBan *> :: iterator i = m_DBBans.begin( ); i != m_DBBans.end( ); i++ )
-					{
-						string TestName = (*i)->GetName( );
-						transform( TestName.begin( ), TestName.end( ), TestName.begin( ), (int(*)(int))tolower );
+	//
+	// !ADDBAN
+	// !BAN
+	//
 
-						if( TestName.find( VictimLower ) != string :: npos )
-						{
-							Matches++;
-							LastMatch = *i;
+	case CBotCommand :: ADDBAN:
+	{
+		// extract the victim and the reason
+		// e.g. "Varlock leaver after dying" -> victim: "Varlock", reason: "leaver after dying"
 
-							// if the name matches exactly stop any further matching
+		string Victim;
+		string Reason;
+		stringstream SS;
+		SS << Payload;
+		SS >> Victim;
 
-							if( TestName == VictimLower )
-							{
-								Matches = 1;
-								break;
-							}
-						}
-					}
+		if( !SS.eof( ) )
+		{
+			getline( SS, Reason );
+			string :: size_type Start = Reason.find_first_not_of( " " );
 
-					if( Matches == 0 )
-						SendAllChat( m_GHost->m_Language->UnableToBanNoMatchesFound( Victim ) );
-					else if( Matches == 1 )
-						m_PairedBanAdds.push_back( PairedBanAdd( User, m_GHost->m_DB->ThreadedBanAdd( LastMatch->GetServer( ), LastMatch->GetName( ), LastMatch->GetIP( ), m_GameName, User, Reason ) ) );
-					else
-						SendAllChat( m_GHost->m_Language->UnableToBanFoundMoreThanOneMatch( Victim ) );
-				}
-				else
-				{
-					CGamePlayer *LastMatch = NULL;
-					uint32_t Matches = GetPlayerFromNamePartial( Victim, &LastMatch );
+			if( Start != string :: npos )
+				Reason = Reason.substr( Start );
+		}
 
-					if( Matches == 0 )
-						SendAllChat( m_GHost->m_Language->UnableToBanNoMatchesFound( Victim ) );
-					else if( Matches == 1 )
-						m_PairedBanAdds.push_back( PairedBanAdd( User, m_GHost->m_DB->ThreadedBanAdd( LastMatch->GetJoinedRealm( ), LastMatch->GetName( ), LastMatch->GetExternalIPString( ), m_GameName, User, Reason ) ) );
-					else
-						SendAllChat( m_GHost->m_Language->UnableToBanFoundMoreThanOneMatch( Victim ) );
-				}
-			}
+		if( m_GameLoaded )
+		{
+			string VictimLower = Victim;
+			transform( VictimLower.begin( ), VictimLower.end( ), VictimLower.begin( ), (int(*)(int))tolower );
+			uint32_t Matches = 0;
+			CDBBan *LastMatch = NULL;
 
-			//
-			// !ANNOUNCE
-			//
+			// try to match each player with the passed string (e.g. "Varlock" would be matched with "lock")
+			// we use the m_DBBans vector for this in case the player already left and thus isn't in the m_Players vector anymore
 
-			if( Command == "announce" && !m_CountDownStarted )
+			for( vector<CDBBan *> :: iterator i = m_DBBans.begin( ); i != m_DBBans.end( ); i++ )
 			{
-				if( Payload.empty( ) || Payload == "off" )
-				{
-					SendAllChat( m_GHost->m_Language->AnnounceMessageDisabled( ) );
-					SetAnnounce( 0, string( ) );
-				}
-				else
+				string TestName = (*i)->GetName( );
+				transform( TestName.begin( ), TestName.end( ), TestName.begin( ), (int(*)(int))tolower );
+
+				if( TestName.find( VictimLower ) != string :: npos )
 				{
-					// extract the interval and the message
-					// e.g. "30 hello everyone" -> interval: "30", message: "hello everyone"
+					Matches++;
+					LastMatch = *i;
 
-					uint32_t Interval;
-					string Message;
-					stringstream SS;
-					SS << Payload;
-					SS >> Interval;
+					// if the name matches exactly stop any further matching
 
-					if( SS.fail( ) || Interval == 0 )
-						CONSOLE_Print( "[GAME: " + m_GameName + "] bad input #1 to announce command" );
-					else
+					if( TestName == VictimLower )
 					{
-						if( SS.eof( ) )
-							CONSOLE_Print( "[GAME: " + m_GameName + "] missing input #2 to announce command" );
-						else
-						{
-							getline( SS, Message );
-							string :: size_type Start = Message.find_first_not_of( " " );
-
-							if( Start != string :: npos )
-								Message = Message.substr( Start );
-
-							SendAllChat( m_GHost->m_Language->AnnounceMessageEnabled( ) );
-							SetAnnounce( Interval, Message );
-						}
+						Matches = 1;
+						break;
 					}
 				}
 			}
 
-			//
-			// !AUTOSAVE
-			//
+			if( Matches == 0 )
+				SendAllChat( m_GHost->m_Language->UnableToBanNoMatchesFound( Victim ) );
+			else if( Matches == 1 )
+				m_PairedBanAdds.push_back( PairedBanAdd( User, m_GHost->m_DB->ThreadedBanAdd( LastMatch->GetServer( ), LastMatch->GetName( ), LastMatch->GetIP( ), m_GameName, User, Reason ) ) );
+			else
+				SendAllChat( m_GHost->m_Language->UnableToBanFoundMoreThanOneMatch( Victim ) );
+		}
+		else
+		{
+			CGamePlayer *LastMatch = NULL;
+			uint32_t Matches = GetPlayerFromNamePartial( Victim, &LastMatch );
+
+			if( Matches == 0 )
+				SendAllChat( m_GHost->m_Language->UnableToBanNoMatchesFound( Victim ) );
+			else if( Matches == 1 )
+				m_PairedBanAdds.push_back( PairedBanAdd( User, m_GHost->m_DB->ThreadedBanAdd( LastMatch->GetJoinedRealm( ), LastMatch->GetName( ), LastMatch->GetExternalIPString( ), m_GameName, User, Reason ) ) );
+			else
+				SendAllChat( m_GHost->m_Language->UnableToBanFoundMoreThanOneMatch( Victim ) );
+		}
+		break;
+	}
 
-			if( Command == "autosave" )
-			{
-				if( Payload == "on" )
-				{
-					SendAllChat( m_GHost->m_Language->AutoSaveEnabled( ) );
-					m_AutoSave = true;
-				}
-				else if( Payload == "off" )
-				{
-					SendAllChat( m_GHost->m_Language->AutoSaveDisabled( ) );
-					m_AutoSave = false;
-				}
-			}
+	//
+	// !ANNOUNCE
+	//
 
-			//
-			// !AUTOSTART
-			//
+	case CBotCommand :: ANNOUNCE:
+		if( Payload.empty( ) || Payload == "off" )
+		{
+			SendAllChat( m_GHost->m_Language->AnnounceMessageDisabled( ) );
+			SetAnnounce( 0, string( ) );
+		}
+		else
+		{
+			// extract the interval and the message
+			// e.g. "30 hello everyone" -> interval: "30", message: "hello everyone"
 
-			if( Command == "autostart" && !m_CountDownStarted )
+			uint32_t Interval;
+			string Message;
+			stringstream SS;
+			SS << Payload;
+			SS >> Interval;
+
+			if( SS.fail( ) || Interval == 0 )
+				CONSOLE_Print( "[GAME: " + m_GameName + "] bad input #1 to announce command" );
+			else
 			{
-				if( Payload.empty( ) || Payload == "off" )
-				{
-					SendAllChat( m_GHost->m_Language->AutoStartDisabled( ) );
-					m_AutoStartPlayers = 0;
-				}
+				if( SS.eof( ) )
+					CONSOLE_Print( "[GAME: " + m_GameName + "] missing input #2 to announce command" );
 				else
 				{
-					uint32_t AutoStartPlayers = UTIL_ToUInt32( Payload );
+					getline( SS, Message );
+					string :: size_type Start = Message.find_first_not_of( " " );
 
-					if( AutoStartPlayers != 0 )
-					{
-						SendAllChat( m_GHost->m_Language->AutoStartEnabled( UTIL_ToString( AutoStartPlayers ) ) );
-						m_AutoStartPlayers = AutoStartPlayers;
-					}
+					if( Start != string :: npos )
+						Message = Message.substr( Start );
+
+					SendAllChat( m_GHost->m_Language->AnnounceMessageEnabled( ) );
+					SetAnnounce( Interval, Message );
 				}
 			}
+		}
+		break;
+
+	//
+	// !AUTOSAVE
+	//
 
-			//
-			// !BANLAST
-			//
+	case CBotCommand :: AUTOSAVE:
+		if( Payload == "on" )
+		{
+			SendAllChat( m_GHost->m_Language->AutoSaveEnabled( ) );
+			m_AutoSave = true;
+		}
+		else if( Payload == "off" )
+		{
+			SendAllChat( m_GHost->m_Language->AutoSaveDisabled( ) );
+			m_AutoSave = false;
+		}
+		break;
 
-			if( Command == "banlast" && m_GameLoaded && !m_GHost->m_BNETs.empty( ) && m_DBBanLast )
-				m_PairedBanAdds.push_back( PairedBanAdd( User, m_GHost->m_DB->ThreadedBanAdd( m_DBBanLast->GetServer( ), m_DBBanLast->GetName( ), m_DBBanLast->GetIP( ), m_GameName, User, Payload ) ) );
+	//
+	// !AUTOSTART
+	//
 
-			//
-			// !CHECK
-			//
+	case CBotCommand :: AUTOSTART:
+		if( Payload.empty( ) || Payload == "off" )
+		{
+			SendAllChat( m_GHost->m_Language->AutoStartDisabled( ) );
+			m_AutoStartPlayers = 0;
+		}
+		else
+		{
+			uint32_t AutoStartPlayers = UTIL_ToUInt32( Payload );
 
-			if( Command == "check" )
+			if( AutoStartPlayers != 0 )
 			{
-				if( !Payload.empty( ) )
-				{
-					CGamePlayer *LastMatch = NULL;
-					uint32_t Matches = GetPlayerFromNamePartial( Payload, &LastMatch );
+				SendAllChat( m_GHost->m_Language->AutoStartEnabled( UTIL_ToString( AutoStartPlayers ) ) );
+				m_AutoStartPlayers = AutoStartPlayers;
+			}
+		}
+		break;
 
-					if( Matches == 0 )
-						SendAllChat( m_GHost->m_Language->UnableToCheckPlayerNoMatchesFound( Payload ) );
-					else if( Matches == 1 )
-					{
-						bool LastMatchAdminCheck = IsAdmin( LastMatch->GetName() );
-						bool LastMatchRootAdminCheck = IsRootAdmin( LastMatch->GetName() );
+	//
+	// !BANLAST
+	//
 
-						SendAllChat( m_GHost->m_Language->CheckedPlayer( LastMatch->GetName( ), LastMatch->GetNumPings( ) > 0 ? UTIL_ToString( LastMatch->GetPing( m_GHost->m_LCPings ) ) + "ms" : "N/A", m_GHost->m_DBLocal->FromCheck( UTIL_ByteArrayToUInt32( LastMatch->GetExternalIP( ), true ) ), LastMatchAdminCheck || LastMatchRootAdminCheck ? "Yes" : "No", IsOwner( LastMatch->GetName( ) ) ? "Yes" : "No", LastMatch->GetSpoofed( ) ? "Yes" : "No", LastMatch->GetSpoofedRealm( ).empty( ) ? "N/A" : LastMatch->GetSpoofedRealm( ), LastMatch->GetReserved( ) ? "Yes" : "No" ) );
-					}
-					else
-						SendAllChat( m_GHost->m_Language->UnableToCheckPlayerFoundMoreThanOneMatch( Payload ) );
-				}
-				else
-					SendAllChat( m_GHost->m_Language->CheckedPlayer( User, player->GetNumPings( ) > 0 ? UTIL_ToString( player->GetPing( m_GHost->m_LCPings ) ) + "ms" : "N/A", m_GHost->m_DBLocal->FromCheck( UTIL_ByteArrayToUInt32( player->GetExternalIP( ), true ) ), AdminCheck || RootAdminCheck ? "Yes" : "No", IsOwner( User ) ? "Yes" : "No", player->GetSpoofed( ) ? "Yes" : "No", player->GetSpoofedRealm( ).empty( ) ? "N/A" : player->GetSpoofedRealm( ), player->GetReserved( ) ? "Yes" : "No" ) );
-			}
+	case CBotCommand :: BANLAST:
+		if( m_DBBanLast )
+			m_PairedBanAdds.push_back( PairedBanAdd( User, m_GHost->m_DB->ThreadedBanAdd( m_DBBanLast->GetServer( ), m_DBBanLast->GetName( ), m_DBBanLast->GetIP( ), m_GameName, User, Payload ) ) );
 
-			//
-			// !CHECKBAN
-			//
+		break;
 
-			if( Command == "checkban" && !Payload.empty( ) && !m_GHost->m_BNETs.empty( ) )
-			{
-				for( vector<CBNET *> :: iterator i = m_GHost->m_BNETs.begin( ); i != m_GHost->m_BNETs.end( ); i++ )
-					m_PairedBanChecks.push_back( PairedBanCheck( User, m_GHost->m_DB->ThreadedBanCheck( (*i)->GetServer( ), Payload, string( ) ) ) );
-			}
+	//
+	// !CHECK
+	//
 
-			//
-			// !CLEARHCL
-			//
+	case CBotCommand :: CHECK:
+		if( !Payload.empty( ) )
+		{
+			CGamePlayer *LastMatch = NULL;
+			uint32_t Matches = GetPlayerFromNamePartial( Payload, &LastMatch );
 
-			if( Command == "clearhcl" && !m_CountDownStarted )
+			if( Matches == 0 )
+				SendAllChat( m_GHost->m_Language->UnableToCheckPlayerNoMatchesFound( Payload ) );
+			else if( Matches == 1 )
 			{
-				m_HCLCommandString.clear( );
-				SendAllChat( m_GHost->m_Language->ClearingHCL( ) );
+				bool LastMatchAdminCheck = LastMatch->GetAdminLevel( ) > 4;
+				bool LastMatchRootAdminCheck = LastMatch->GetAdminLevel( ) > 9;
+
+				SendAllChat( m_GHost->m_Language->CheckedPlayer( LastMatch->GetName( ), LastMatch->GetNumPings( ) > 0 ? UTIL_ToString( LastMatch->GetPing( m_GHost->m_LCPings ) ) + "ms" : "N/A", m_GHost->m_DBLocal->FromCheck( UTIL_ByteArrayToUInt32( LastMatch->GetExternalIP( ), true ) ), LastMatchAdminCheck || LastMatchRootAdminCheck ? "Yes" : "No", IsOwner( LastMatch->GetName( ) ) ? "Yes" : "No", LastMatch->GetSpoofed( ) ? "Yes" : "No", LastMatch->GetSpoofedRealm( ).empty( ) ? "N/A" : LastMatch->GetSpoofedRealm( ), LastMatch->GetReserved( ) ? "Yes" : "No" ) );
 			}
+			else
+				SendAllChat( m_GHost->m_Language->UnableToCheckPlayerFoundMoreThanOneMatch( Payload ) );
+		}
+		else
+			SendAllChat( m_GHost->m_Language->CheckedPlayer( User, player->GetNumPings( ) > 0 ? UTIL_ToString( player->GetPing( m_GHost->m_LCPings ) ) + "ms" : "N/A", m_GHost->m_DBLocal->FromCheck( UTIL_ByteArrayToUInt32( player->GetExternalIP( ), true ) ), AdminCheck || RootAdminCheck ? "Yes" : "No", IsOwner( User ) ? "Yes" : "No", player->GetSpoofed( ) ? "Yes" : "No", player->GetSpoofedRealm( ).empty( ) ? "N/A" : player->GetSpoofedRealm( ), player->GetReserved( ) ? "Yes" : "No" ) );
+		break;
 
-			//
-			// !CLOSE (close slot)
-			//
+	//
+	// !CHECKBAN
+	//
 
-			if( Command == "close" && !Payload.empty( ) && !m_GameLoading && !m_GameLoaded )
-			{
-				// close as many slots as specified, e.g. "5 10" closes slots 5 and 10
+	case CBotCommand :: CHECKBAN:
+		for( vector<CBNET *> :: iterator i = m_GHost->m_BNETs.begin( ); i != m_GHost->m_BNETs.end( ); i++ )
+			m_PairedBanChecks.push_back( PairedBanCheck( User, m_GHost->m_DB->ThreadedBanCheck( (*i)->GetServer( ), Payload, string( ) ) ) );
+		break;
 
-				stringstream SS;
-				SS << Payload;
+	//
+	// !CLEARHCL
+	//
 
-				while( !SS.eof( ) )
-				{
-					uint32_t SID;
-					SS >> SID;
+	case CBotCommand :: CLEARHCL:
+		m_HCLCommandString.clear( );
+		SendAllChat( m_GHost->m_Language->ClearingHCL( ) );
+		break;
 
-					if( SS.fail( ) )
-					{
-						CONSOLE_Print( "[GAME: " + m_GameName + "] bad input to close command" );
-						break;
-					}
-					else
-						CloseSlot( (unsigned char)( SID - 1 ), true );
-				}
-			}
+	//
+	// !CLOSE (close slot)
+	//
 
-			//
-			// !CLOSEALL
-			//
+	case CBotCommand :: CLOSE:
+	{
+		// close as many slots as specified, e.g. "5 10" closes slots 5 and 10
 
-			if( Command == "closeall" && !m_GameLoading && !m_GameLoaded )
-				CloseAllSlots( );
+		stringstream SS;
+		SS << Payload;
 
-			//
-			// !COMP (computer slot)
-			//
+		while( !SS.eof( ) )
+		{
+			uint32_t SID;
+			SS >> SID;
 
-			if( Command == "comp" && !Payload.empty( ) && !m_GameLoading && !m_GameLoaded && !m_SaveGame )
+			if( SS.fail( ) )
 			{
-				// extract the slot and the skill
-				// e.g. "1 2" -> slot: "1", skill: "2"
+				CONSOLE_Print( "[GAME: " + m_GameName + "] bad input to close command" );
+				break;
+			}
+			else
+				CloseSlot( (unsigned char)( SID - 1 ), true );
+		}
+		break;
+	}
 
-				uint32_t Slot;
-				uint32_t Skill = 1;
-				stringstream SS;
-				SS << Payload;
-				SS >> Slot;
+	//
+	// !CLOSEALL
+	//
 
-				if( SS.fail( ) )
-					CONSOLE_Print( "[GAME: " + m_GameName + "] bad input #1 to comp command" );
-				else
-				{
-					if( !SS.eof( ) )
-						SS >> Skill;
+	case CBotCommand :: CLOSEALL:
+		CloseAllSlots( );
+		break;
 
-					if( SS.fail( ) )
-						CONSOLE_Print( "[GAME: " + m_GameName + "] bad input #2 to comp command" );
-					else
-						ComputerSlot( (unsigned char)( Slot - 1 ), (unsigned char)Skill, true );
-				}
-			}
+	//
+	// !COMP (computer slot)
+	//
 
-			//
-			// !COMPCOLOUR (computer colour change)
-			//
+	case CBotCommand :: COMP:
+	{
+		// extract the slot and the skill
+		// e.g. "1 2" -> slot: "1", skill: "2"
 
-			if( Command == "compcolour" && !Payload.empty( ) && !m_GameLoading && !m_GameLoaded && !m_SaveGame )
-			{
-				// extract the slot and the colour
-				// e.g. "1 2" -> slot: "1", colour: "2"
+		uint32_t Slot;
+		uint32_t Skill = 1;
+		stringstream SS;
+		SS << Payload;
+		SS >> Slot;
 
-				uint32_t Slot;
-				uint32_t Colour;
-				stringstream SS;
-				SS << Payload;
-				SS >> Slot;
+		if( SS.fail( ) )
+			CONSOLE_Print( "[GAME: " + m_GameName + "] bad input #1 to comp command" );
+		else
+		{
+			if( !SS.eof( ) )
+				SS >> Skill;
 
-				if( SS.fail( ) )
-					CONSOLE_Print( "[GAME: " + m_GameName + "] bad input #1 to compcolour command" );
-				else
-				{
-					if( SS.eof( ) )
-						CONSOLE_Print( "[GAME: " + m_GameName + "] missing input #2 to compcolour command" );
-					else
-					{
-						SS >> Colour;
+			if( SS.fail( ) )
+				CONSOLE_Print( "[GAME: " + m_GameName + "] bad input #2 to comp command" );
+			else
+				ComputerSlot( (unsigned char)( Slot - 1 ), (unsigned char)Skill, true );
+		}
+		break;
+	}
 
-						if( SS.fail( ) )
-							CONSOLE_Print( "[GAME: " + m_GameName + "] bad input #2 to compcolour command" );
-						else
-						{
-							unsigned char SID = (unsigned char)( Slot - 1 );
+	//
+	// !COMPCOLOUR (computer colour change)
+	//
 
-							if( !( m_Map->GetMapOptions( ) & MAPOPT_FIXEDPLAYERSETTINGS ) && Colour < 12 && SID < m_Slots.size( ) )
-							{
-								if( m_Slots[SID].GetSlotStatus( ) == SLOTSTATUS_OCCUPIED && m_Slots[SID].GetComputer( ) == 1 )
-									ColourSlot( SID, Colour );
-							}
-						}
-					}
-				}
-			}
+	case CBotCommand :: COMPCOLOUR:
+	{
+		// extract the slot and the colour
+		// e.g. "1 2" -> slot: "1", colour: "2"
 
-			//
-			// !COMPHANDICAP (computer handicap change)
-			//
+		uint32_t Slot;
+		uint32_t Colour;
+		stringstream SS;
+		SS << Payload;
+		SS >> Slot;
 
-			if( Command == "comphandicap" && !Payload.empty( ) && !m_GameLoading && !m_GameLoaded && !m_SaveGame )
+		if( SS.fail( ) )
+			CONSOLE_Print( "[GAME: " + m_GameName + "] bad input #1 to compcolour command" );
+		else
+		{
+			if( SS.eof( ) )
+				CONSOLE_Print( "[GAME: " + m_GameName + "] missing input #2 to compcolour command" );
+			else
 			{
-				// extract the slot and the handicap
-				// e.g. "1 50" -> slot: "1", handicap: "50"
-
-				uint32_t Slot;
-				uint32_t Handicap;
-				stringstream SS;
-				SS << Payload;
-				SS >> Slot;
+				SS >> Colour;
 
 				if( SS.fail( ) )
-					CONSOLE_Print( "[GAME: " + m_GameName + "] bad input #1 to comphandicap command" );
+					CONSOLE_Print( "[GAME: " + m_GameName + "] bad input #2 to compcolour command" );
 				else
 				{
-					if( SS.eof( ) )
-						CONSOLE_Print( "[GAME: " + m_GameName + "] missing input #2 to comphandicap command" );
-					else
-					{
-						SS >> Handicap;
+					unsigned char SID = (unsigned char)( Slot - 1 );
 
-						if( SS.fail( ) )
-							CONSOLE_Print( "[GAME: " + m_GameName + "] bad input #2 to comphandicap command" );
-						else
-						{
-							unsigned char SID = (unsigned char)( Slot - 1 );
-
-							if( !( m_Map->GetMapOptions( ) & MAPOPT_FIXEDPLAYERSETTINGS ) && ( Handicap == 50 || Handicap == 60 || Handicap == 70 || Handicap == 80 || Handicap == 90 || Handicap == 100 ) && SID < m_Slots.size( ) )
-							{
-								if( m_Slots[SID].GetSlotStatus( ) == SLOTSTATUS_OCCUPIED && m_Slots[SID].GetComputer( ) == 1 )
-								{
-									m_Slots[SID].SetHandicap( (unsigned char)Handicap );
-									SendAllSlotInfo( );
-								}
-							}
-						}
+					if( !( m_Map->GetMapOptions( ) & MAPOPT_FIXEDPLAYERSETTINGS ) && Colour < 12 && SID < m_Slots.size( ) )
+					{
+						if( m_Slots[SID].GetSlotStatus( ) == SLOTSTATUS_OCCUPIED && m_Slots[SID].GetComputer( ) == 1 )
+							ColourSlot( SID, Colour );
 					}
 				}
 			}
+		}
+		break;
+	}
+
+	//
+	// !COMPHANDICAP (computer handicap change)
+	//
 
-			//
-			// !COMPRACE (computer race change)
-			//
+	case CBotCommand :: COMPHANDICAP:
+	{
+		// extract the slot and the handicap
+		// e.g. "1 50" -> slot: "1", handicap: "50"
 
-			if( Command == "comprace" && !Payload.empty( ) && !m_GameLoading && !m_GameLoaded && !m_SaveGame )
-			{
-				// extract the slot and the race
-				// e.g. "1 human" -> slot: "1", race: "human"
+		uint32_t Slot;
+		uint32_t Handicap;
+		stringstream SS;
+		SS << Payload;
+		SS >> Slot;
 
-				uint32_t Slot;
-				string Race;
-				stringstream SS;
-				SS << Payload;
-				SS >> Slot;
+		if( SS.fail( ) )
+			CONSOLE_Print( "[GAME: " + m_GameName + "] bad input #1 to comphandicap command" );
+		else
+		{
+			if( SS.eof( ) )
+				CONSOLE_Print( "[GAME: " + m_GameName + "] missing input #2 to comphandicap command" );
+			else
+			{
+				SS >> Handicap;
 
 				if( SS.fail( ) )
-					CONSOLE_Print( "[GAME: " + m_GameName + "] bad input #1 to comprace command" );
+					CONSOLE_Print( "[GAME: " + m_GameName + "] bad input #2 to comphandicap command" );
 				else
 				{
-					if( SS.eof( ) )
-						CONSOLE_Print( "[GAME: " + m_GameName + "] missing input #2 to comprace command" );
-					else
-					{
-						getline( SS, Race );
-						string :: size_type Start = Race.find_first_not_of( " " );
-
-						if( Start != string :: npos )
-							Race = Race.substr( Start );
+					unsigned char SID = (unsigned char)( Slot - 1 );
 
-						transform( Race.begin( ), Race.end( ), Race.begin( ), (int(*)(int))tolower );
-						unsigned char SID = (unsigned char)( Slot - 1 );
-
-						if( !( m_Map->GetMapOptions( ) & MAPOPT_FIXEDPLAYERSETTINGS ) && !( m_Map->GetMapFlags( ) & MAPFLAG_RANDOMRACES ) && SID < m_Slots.size( ) )
+					if( !( m_Map->GetMapOptions( ) & MAPOPT_FIXEDPLAYERSETTINGS ) && ( Handicap == 50 || Handicap == 60 || Handicap == 70 || Handicap == 80 || Handicap == 90 || Handicap == 100 ) && SID < m_Slots.size( ) )
+					{
+						if( m_Slots[SID].GetSlotStatus( ) == SLOTSTATUS_OCCUPIED && m_Slots[SID].GetComputer( ) == 1 )
 						{
-							if( m_Slots[SID].GetSlotStatus( ) == SLOTSTATUS_OCCUPIED && m_Slots[SID].GetComputer( ) == 1 )
-							{
-								if( Race == "human" )
-								{
-									m_Slots[SID].SetRace( SLOTRACE_HUMAN | SLOTRACE_SELECTABLE );
-									SendAllSlotInfo( );
-								}
-								else if( Race == "orc" )
-								{
-									m_Slots[SID].SetRace( SLOTRACE_ORC | SLOTRACE_SELECTABLE );
-									SendAllSlotInfo( );
-								}
-								else if( Race == "night elf" )
-								{
-									m_Slots[SID].SetRace( SLOTRACE_NIGHTELF | SLOTRACE_SELECTABLE );
-									SendAllSlotInfo( );
-								}
-								else if( Race == "undead" )
-								{
-									m_Slots[SID].SetRace( SLOTRACE_UNDEAD | SLOTRACE_SELECTABLE );
-									SendAllSlotInfo( );
-								}
-								else if( Race == "random" )
-								{
-									m_Slots[SID].SetRace( SLOTRACE_RANDOM | SLOTRACE_SELECTABLE );
-									SendAllSlotInfo( );
-								}
-								else
-									CONSOLE_Print( "[GAME: " + m_GameName + "] unknown race [" + Race + "] sent to comprace command" );
-							}
+							m_Slots[SID].SetHandicap( (unsigned char)Handicap );
+							SendAllSlotInfo( );
 						}
 					}
 				}
 			}
+		}
+		break;
+	}
+
+	//
+	// !COMPRACE (computer race change)
+	//
+
+	case CBotCommand :: COMPRACE:
+	{
+		// extract the slot and the race
+		// e.g. "1 human" -> slot: "1", race: "human"
 
-			//
-			// !COMPTEAM (computer team change)
-			//
+		uint32_t Slot;
+		string Race;
+		stringstream SS;
+		SS << Payload;
+		SS >> Slot;
 
-			if( Command == "compteam" && !Payload.empty( ) && !m_GameLoading && !m_GameLoaded && !m_SaveGame )
+		if( SS.fail( ) )
+			CONSOLE_Print( "[GAME: " + m_GameName + "] bad input #1 to comprace command" );
+		else
+		{
+			if( SS.eof( ) )
+				CONSOLE_Print( "[GAME: " + m_GameName + "] missing input #2 to comprace command" );
+			else
 			{
-				// extract the slot and the team
-				// e.g. "1 2" -> slot: "1", team: "2"
+				getline( SS, Race );
+				string :: size_type Start = Race.find_first_not_of( " " );
 
-				uint32_t Slot;
-				uint32_t Team;
-				stringstream SS;
-				SS << Payload;
-				SS >> Slot;
+				if( Start != string :: npos )
+					Race = Race.substr( Start );
 
-				if( SS.fail( ) )
-					CONSOLE_Print( "[GAME: " + m_GameName + "] bad input #1 to compteam command" );
-				else
+				transform( Race.begin( ), Race.end( ), Race.begin( ), (int(*)(int))tolower );
+				unsigned char SID = (unsigned char)( Slot - 1 );
+
+				if( !( m_Map->GetMapOptions( ) & MAPOPT_FIXEDPLAYERSETTINGS ) && !( m_Map->GetMapFlags( ) & MAPFLAG_RANDOMRACES ) && SID < m_Slots.size( ) )
 				{
-					if( SS.eof( ) )
-						CONSOLE_Print( "[GAME: " + m_GameName + "] missing input #2 to compteam command" );
-					else
+					if( m_Slots[SID].GetSlotStatus( ) == SLOTSTATUS_OCCUPIED && m_Slots[SID].GetComputer( ) == 1 )
 					{
-						SS >> Team;
-
-						if( SS.fail( ) )
-							CONSOLE_Print( "[GAME: " + m_GameName + "] bad input #2 to compteam command" );
-						else
+						if( Race == "human" )
 						{
-							unsigned char SID = (unsigned char)( Slot - 1 );
-
-							if( !( m_Map->GetMapOptions( ) & MAPOPT_FIXEDPLAYERSETTINGS ) && Team < 12 && SID < m_Slots.size( ) )
-							{
-								if( m_Slots[SID].GetSlotStatus( ) == SLOTSTATUS_OCCUPIED && m_Slots[SID].GetComputer( ) == 1 )
-								{
-									m_Slots[SID].SetTeam( (unsigned char)( Team - 1 ) );
-									SendAllSlotInfo( );
-								}
-							}
+							m_Slots[SID].SetRace( SLOTRACE_HUMAN | SLOTRACE_SELECTABLE );
+							SendAllSlotInfo( );
 						}
+						else if( Race == "orc" )
+						{
+							m_Slots[SID].SetRace( SLOTRACE_ORC | SLOTRACE_SELECTABLE );
+							SendAllSlotInfo( );
+						}
+						else if( Race == "night elf" )
+						{
+							m_Slots[SID].SetRace( SLOTRACE_NIGHTELF | SLOTRACE_SELECTABLE );
+							SendAllSlotInfo( );
+						}
+						else if( Race == "undead" )
+						{
+							m_Slots[SID].SetRace( SLOTRACE_UNDEAD | SLOTRACE_SELECTABLE );
+							SendAllSlotInfo( );
+						}
+						else if( Race == "random" )
+						{
+							m_Slots[SID].SetRace( SLOTRACE_RANDOM | SLOTRACE_SELECTABLE );
+							SendAllSlotInfo( );
+						}
+						else
+							CONSOLE_Print( "[GAME: " + m_GameName + "] unknown race [" + Race + "] sent to comprace command" );
 					}
 				}
 			}
+		}
+		break;
+	}
 
-			//
-			// !DBSTATUS
-			//
+	//
+	// !COMPTEAM (computer team change)
+	//
 
-			if( Command == "dbstatus" )
-				SendAllChat( m_GHost->m_DB->GetStatus( ) );
+	case CBotCommand :: COMPTEAM:
+	{
+		// extract the slot and the team
+		// e.g. "1 2" -> slot: "1", team: "2"
 
-			//
-			// !DOWNLOAD
-			// !DL
-			//
+		uint32_t Slot;
+		uint32_t Team;
+		stringstream SS;
+		SS << Payload;
+		SS >> Slot;
 
-			if( ( Command == "download" || Command == "dl" ) && !Payload.empty( ) && !m_GameLoading && !m_GameLoaded )
+		if( SS.fail( ) )
+			CONSOLE_Print( "[GAME: " + m_GameName + "] bad input #1 to compteam command" );
+		else
+		{
+			if( SS.eof( ) )
+				CONSOLE_Print( "[GAME: " + m_GameName + "] missing input #2 to compteam command" );
+			else
 			{
-				CGamePlayer *LastMatch = NULL;
-				uint32_t Matches = GetPlayerFromNamePartial( Payload, &LastMatch );
+				SS >> Team;
 
-				if( Matches == 0 )
-					SendAllChat( m_GHost->m_Language->UnableToStartDownloadNoMatchesFound( Payload ) );
-				else if( Matches == 1 )
+				if( SS.fail( ) )
+					CONSOLE_Print( "[GAME: " + m_GameName + "] bad input #2 to compteam command" );
+				else
 				{
-					if( !LastMatch->GetDownloadStarted( ) && !LastMatch->GetDownloadFinished( ) )
-					{
-						unsigned char SID = GetSIDFromPID( LastMatch->GetPID( ) );
+					unsigned char SID = (unsigned char)( Slot - 1 );
 
-						if( SID < m_Slots.size( ) && m_Slots[SID].GetDownloadStatus( ) != 100 )
+					if( !( m_Map->GetMapOptions( ) & MAPOPT_FIXEDPLAYERSETTINGS ) && Team < 12 && SID < m_Slots.size( ) )
+					{
+						if( m_Slots[SID].GetSlotStatus( ) == SLOTSTATUS_OCCUPIED && m_Slots[SID].GetComputer( ) == 1 )
 						{
-							// inform the client that we are willing to send the map
-
-							CONSOLE_Print( "[GAME: " + m_GameName + "] map download started for player [" + LastMatch->GetName( ) + "]" );
-							Send( LastMatch, m_Protocol->SEND_W3GS_STARTDOWNLOAD( GetHostPID( ) ) );
-							LastMatch->SetDownloadAllowed( true );
-							LastMatch->SetDownloadStarted( true );
-							LastMatch->SetStartedDownloadingTicks( GetTicks( ) );
+							m_Slots[SID].SetTeam( (unsigned char)( Team - 1 ) );
+							SendAllSlotInfo( );
 						}
 					}
 				}
-				else
-					SendAllChat( m_GHost->m_Language->UnableToStartDownloadFoundMoreThanOneMatch( Payload ) );
 			}
+		}
+		break;
+	}
 
-			//
-			// !DROP
-			//
-
-			if( Command == "drop" && m_GameLoaded )
-				StopLaggers( "lagged out (dropped by admin)" );
+	//
+	// !DBSTATUS
+	//
 
-			//
-			// !END
-			//
+	case CBotCommand :: DBSTATUS:
+		SendAllChat( m_GHost->m_DB->GetStatus( ) );
+		break;
 
-			if( Command == "end" && m_GameLoaded )
-			{
-				CONSOLE_Print( "[GAME: " + m_GameName + "] is over (admin ended game)" );
-				StopPlayers( "was disconnected (admin ended game)" );
-			}
+	//
+	// !DOWNLOAD
+	// !DL
+	//
 
-			//
-			// !FAKEPLAYER
-			//
+	case CBotCommand :: DOWNLOAD:
+	{
+		CGamePlayer *LastMatch = NULL;
+		uint32_t Matches = GetPlayerFromNamePartial( Payload, &LastMatch );
 
-			if( Command == "fakeplayer" && !m_CountDownStarted )
+		if( Matches == 0 )
+			SendAllChat( m_GHost->m_Language->UnableToStartDownloadNoMatchesFound( Payload ) );
+		else if( Matches == 1 )
+		{
+			if( !LastMatch->GetDownloadStarted( ) && !LastMatch->GetDownloadFinished( ) )
 			{
-				if( m_FakePlayerPID == 255 )
-					CreateFakePlayer( );
-				else
-					DeleteFakePlayer( );
-			}
+				unsigned char SID = GetSIDFromPID( LastMatch->GetPID( ) );
 
-			//
-			// !FPPAUSE
-			//
+				if( SID < m_Slots.size( ) && m_Slots[SID].GetDownloadStatus( ) != 100 )
+				{
+					// inform the client that we are willing to send the map
 
-			if( Command == "fppause" && m_FakePlayerPID != 255 && m_GameLoaded )
-			{
-				BYTEARRAY CRC;
-				BYTEARRAY Action;
-				Action.push_back( 1 );
-				m_Actions.push( new CIncomingAction( m_FakePlayerPID, CRC, Action ) );
+					CONSOLE_Print( "[GAME: " + m_GameName + "] map download started for player [" + LastMatch->GetName( ) + "]" );
+					Send( LastMatch, m_Protocol->SEND_W3GS_STARTDOWNLOAD( GetHostPID( ) ) );
+					LastMatch->SetDownloadAllowed( true );
+					LastMatch->SetDownloadStarted( true );
+					LastMatch->SetStartedDownloadingTicks( GetTicks( ) );
+				}
 			}
+		}
+		else
+			SendAllChat( m_GHost->m_Language->UnableToStartDownloadFoundMoreThanOneMatch( Payload ) );
+		break;
+	}
 
-			//
-			// !FPRESUME
-			//
+	//
+	// !DROP
+	//
 
-			if( Command == "fpresume" && m_FakePlayerPID != 255 && m_GameLoaded )
-			{
-				BYTEARRAY CRC;
-				BYTEARRAY Action;
-				Action.push_back( 2 );
-				m_Actions.push( new CIncomingAction( m_FakePlayerPID, CRC, Action ) );
-			}
+	case CBotCommand :: DROP:
+		StopLaggers( "lagged out (dropped by admin)" );
+		break;
 
-			//
-			// !FROM
-			//
+	//
+	// !END
+	//
 
-			if( Command == "from" )
-			{
-				string Froms;
+	case CBotCommand :: END:
+		CONSOLE_Print( "[GAME: " + m_GameName + "] is over (admin ended game)" );
+		StopPlayers( "was disconnected (admin ended game)" );
+		break;
 
-				for( vector<CGamePlayer *> :: iterator i = m_Players.begin( ); i != m_Players.end( ); i++ )
-				{
-					// we reverse the byte order on the IP because it's stored in network byte order
+	//
+	// !FAKEPLAYER
+	//
 
-					Froms += (*i)->GetNameTerminated( );
-					Froms += ": (";
-					Froms += m_GHost->m_DBLocal->FromCheck( UTIL_ByteArrayToUInt32( (*i)->GetExternalIP( ), true ) );
-					Froms += ")";
+	case CBotCommand :: FAKEPLAYER:
+		if( m_FakePlayerPID == 255 )
+			CreateFakePlayer( );
+		else
+			DeleteFakePlayer( );
+		break;
 
-					if( i != m_Players.end( ) - 1 )
-						Froms += ", ";
+	//
+	// !FPPAUSE
+	//
 
-					if( ( m_GameLoading || m_GameLoaded ) && Froms.size( ) > 100 )
-					{
-						// cut the text into multiple lines ingame
+	case CBotCommand :: FPPAUSE:
+		if( m_FakePlayerPID != 255 )
+		{
+			BYTEARRAY CRC;
+			BYTEARRAY Action;
+			Action.push_back( 1 );
+			m_Actions.push( new CIncomingAction( m_FakePlayerPID, CRC, Action ) );
+		}
 
-						SendAllChat( Froms );
-						Froms.clear( );
-					}
-				}
+		break;
 
-				if( !Froms.empty( ) )
-					SendAllChat( Froms );
-			}
+	//
+	// !FPRESUME
+	//
 
-			//
-			// !HCL
-			//
+	case CBotCommand :: FPRESUME:
+		if( m_FakePlayerPID != 255 )
+		{
+			BYTEARRAY CRC;
+			BYTEARRAY Action;
+			Action.push_back( 2 );
+			m_Actions.push( new CIncomingAction( m_FakePlayerPID, CRC, Action ) );
+		}
 
-			if( Command == "hcl" && !m_CountDownStarted )
-			{
-				if( !Payload.empty( ) )
-				{
-					if( Payload.size( ) <= m_Slots.size( ) )
-					{
-						string HCLChars = "abcdefghijklmnopqrstuvwxyz0123456789 -=,.";
+		break;
 
-						if( Payload.find_first_not_of( HCLChars ) == string :: npos )
-						{
-							m_HCLCommandString = Payload;
-							SendAllChat( m_GHost->m_Language->SettingHCL( m_HCLCommandString ) );
-						}
-						else
-							SendAllChat( m_GHost->m_Language->UnableToSetHCLInvalid( ) );
-					}
-					else
-						SendAllChat( m_GHost->m_Language->UnableToSetHCLTooLong( ) );
-				}
-				else
-					SendAllChat( m_GHost->m_Language->TheHCLIs( m_HCLCommandString ) );
-			}
+	//
+	// !FROM
+	//
 
-			//
-			// !HOLD (hold a slot for someone)
-			//
+	case CBotCommand :: FROM:
+	{
+		string Froms;
 
-			if( Command == "hold" && !Payload.empty( ) && !m_GameLoading && !m_GameLoaded )
-			{
-				// hold as many players as specified, e.g. "Varlock Kilranin" holds players "Varlock" and "Kilranin"
+		for( vector<CGamePlayer *> :: iterator i = m_Players.begin( ); i != m_Players.end( ); i++ )
+		{
+			// we reverse the byte order on the IP because it's stored in network byte order
 
-				stringstream SS;
-				SS << Payload;
+			Froms += (*i)->GetNameTerminated( );
+			Froms += ": (";
+			Froms += m_GHost->m_DBLocal->FromCheck( UTIL_ByteArrayToUInt32( (*i)->GetExternalIP( ), true ) );
+			Froms += ")";
 
-				while( !SS.eof( ) )
-				{
-					string HoldName;
-					SS >> HoldName;
+			if( i != m_Players.end( ) - 1 )
+				Froms += ", ";
 
-					if( SS.fail( ) )
-					{
-						CONSOLE_Print( "[GAME: " + m_GameName + "] bad input to hold command" );
-						break;
-					}
-					else
-					{
-						SendAllChat( m_GHost->m_Language->AddedPlayerToTheHoldList( HoldName ) );
-						AddToReserved( HoldName );
-					}
-				}
+			if( ( m_GameLoading || m_GameLoaded ) && Froms.size( ) > 100 )
+			{
+				// cut the text into multiple lines ingame
+
+				SendAllChat( Froms );
+				Froms.clear( );
 			}
+		}
 
-			//
-			// !KICK (kick a player)
-			//
+		if( !Froms.empty( ) )
+			SendAllChat( Froms );
+		break;
+	}
+
+	//
+	// !HCL
+	//
 
-			if( Command == "kick" && !Payload.empty( ) )
+	case CBotCommand :: HCL:
+		if( !Payload.empty( ) )
+		{
+			if( Payload.size( ) <= m_Slots.size( ) )
 			{
-				CGamePlayer *LastMatch = NULL;
-				uint32_t Matches = GetPlayerFromNamePartial( Payload, &LastMatch );
+				string HCLChars = "abcdefghijklmnopqrstuvwxyz0123456789 -=,.";
 
-				if( Matches == 0 )
-					SendAllChat( m_GHost->m_Language->UnableToKickNoMatchesFound( Payload ) );
-				else if( Matches == 1 )
+				if( Payload.find_first_not_of( HCLChars ) == string :: npos )
 				{
-					LastMatch->SetDeleteMe( true );
-					LastMatch->SetLeftReason( m_GHost->m_Language->WasKickedByPlayer( User ) );
-
-					if( !m_GameLoading && !m_GameLoaded )
-						LastMatch->SetLeftCode( PLAYERLEAVE_LOBBY );
-					else
-						LastMatch->SetLeftCode( PLAYERLEAVE_LOST );
-
-					if( !m_GameLoading && !m_GameLoaded )
-						OpenSlot( GetSIDFromPID( LastMatch->GetPID( ) ), false );
+					m_HCLCommandString = Payload;
+					SendAllChat( m_GHost->m_Language->SettingHCL( m_HCLCommandString ) );
 				}
 				else
-					SendAllChat( m_GHost->m_Language->UnableToKickFoundMoreThanOneMatch( Payload ) );
+					SendAllChat( m_GHost->m_Language->UnableToSetHCLInvalid( ) );
 			}
+			else
+				SendAllChat( m_GHost->m_Language->UnableToSetHCLTooLong( ) );
+		}
+		else
+			SendAllChat( m_GHost->m_Language->TheHCLIs( m_HCLCommandString ) );
+		break;
 
-			//
-			// !LATENCY (set game latency)
-			//
+	//
+	// !HOLD (hold a slot for someone)
+	//
 
-			if( Command == "latency" )
-			{
-				if( Payload.empty( ) )
-					SendAllChat( m_GHost->m_Language->LatencyIs( UTIL_ToString( m_Latency ) ) );
-				else
-				{
-					m_Latency = UTIL_ToUInt32( Payload );
+	case CBotCommand :: HOLD:
+	{
+		// hold as many players as specified, e.g. "Varlock Kilranin" holds players "Varlock" and "Kilranin"
 
-					if( m_Latency <= 20 )
-					{
-						m_Latency = 20;
-						SendAllChat( m_GHost->m_Language->SettingLatencyToMinimum( "20" ) );
-					}
-					else if( m_Latency >= 500 )
-					{
-						m_Latency = 500;
-						SendAllChat( m_GHost->m_Language->SettingLatencyToMaximum( "500" ) );
-					}
-					else
-						SendAllChat( m_GHost->m_Language->SettingLatencyTo( UTIL_ToString( m_Latency ) ) );
-				}
-			}
+		stringstream SS;
+		SS << Payload;
 
-			//
-			// !LOCK
-			//
+		while( !SS.eof( ) )
+		{
+			string HoldName;
+			SS >> HoldName;
 
-			if( Command == "lock" && ( RootAdminCheck || IsOwner( User ) ) )
+			if( SS.fail( ) )
 			{
-				SendAllChat( m_GHost->m_Language->GameLocked( ) );
-				m_Locked = true;
+				CONSOLE_Print( "[GAME: " + m_GameName + "] bad input to hold command" );
+				break;
 			}
-
-			//
-			// !MESSAGES
-			//
-
-			if( Command == "messages" )
+			else
 			{
-				if( Payload == "on" )
-				{
-					SendAllChat( m_GHost->m_Language->LocalAdminMessagesEnabled( ) );
-					m_LocalAdminMessages = true;
-				}
-				else if( Payload == "off" )
-				{
-					SendAllChat( m_GHost->m_Language->LocalAdminMessagesDisabled( ) );
-					m_LocalAdminMessages = false;
-				}
+				SendAllChat( m_GHost->m_Language->AddedPlayerToTheHoldList( HoldName ) );
+				AddToReserved( HoldName );
 			}
+		}
+		break;
+	}
 
-			//
-			// !MUTE
-			//
-
-			if( Command == "mute" )
-			{
-				CGamePlayer *LastMatch = NULL;
-				uint32_t Matches = GetPlayerFromNamePartial( Payload, &LastMatch );
+	//
+	// !KICK (kick a player)
+	//
 
-				if( Matches == 0 )
-					SendAllChat( m_GHost->m_Language->UnableToMuteNoMatchesFound( Payload ) );
-				else if( Matches == 1 )
-				{
-					SendAllChat( m_GHost->m_Language->MutedPlayer( LastMatch->GetName( ), User ) );
-					LastMatch->SetMuted( true );
-				}
-				else
-					SendAllChat( m_GHost->m_Language->UnableToMuteFoundMoreThanOneMatch( Payload ) );
-			}
+	case CBotCommand :: KICK:
+	{
+		CGamePlayer *LastMatch = NULL;
+		uint32_t Matches = GetPlayerFromNamePartial( Payload, &LastMatch );
 
-			//
-			// !MUTEALL
-			//
+		if( Matches == 0 )
+			SendAllChat( m_GHost->m_Language->UnableToKickNoMatchesFound( Payload ) );
+		else if( Matches == 1 )
+		{
+			LastMatch->SetDeleteMe( true );
+			LastMatch->SetLeftReason( m_GHost->m_Language->WasKickedByPlayer( User ) );
 
-			if( Command == "muteall" && m_GameLoaded )
-			{
-				SendAllChat( m_GHost->m_Language->GlobalChatMuted( ) );
-				m_MuteAll = true;
-			}
+			if( !m_GameLoading && !m_GameLoaded )
+				LastMatch->SetLeftCode( PLAYERLEAVE_LOBBY );
+			else
+				LastMatch->SetLeftCode( PLAYERLEAVE_LOST );
 
-			//
-			// !OPEN (open slot)
-			//
+			if( !m_GameLoading && !m_GameLoaded )
+				OpenSlot( GetSIDFromPID( LastMatch->GetPID( ) ), false );
+		}
+		else
+			SendAllChat( m_GHost->m_Language->UnableToKickFoundMoreThanOneMatch( Payload ) );
+		break;
+	}
 
-			if( Command == "open" && !Payload.empty( ) && !m_GameLoading && !m_GameLoaded )
-			{
-				// open as many slots as specified, e.g. "5 10" opens slots 5 and 10
+	//
+	// !LATENCY (set game latency)
+	//
 
-				stringstream SS;
-				SS << Payload;
+	case CBotCommand :: LATENCY:
+		if( Payload.empty( ) )
+			SendAllChat( m_GHost->m_Language->LatencyIs( UTIL_ToString( m_Latency ) ) );
+		else
+		{
+			// setting the latency manually turns off the adaptive latency for this game
 
-				while( !SS.eof( ) )
-				{
-					uint32_t SID;
-					SS >> SID;
+			m_AdaptiveLatency = false;
+			m_Latency = UTIL_ToUInt32( Payload );
 
-					if( SS.fail( ) )
-					{
-						CONSOLE_Print( "[GAME: " + m_GameName + "] bad input to open command" );
-						break;
-					}
-					else
-						OpenSlot( (unsigned char)( SID - 1 ), true );
-				}
+			if( m_Latency <= 20 )
+			{
+				m_Latency = 20;
+				SendAllChat( m_GHost->m_Language->SettingLatencyToMinimum( "20" ) );
 			}
-
-			//
-			// !OPENALL
-			//
-
-			if( Command == "openall" && !m_GameLoading && !m_GameLoaded )
-				OpenAllSlots( );
-
-			//
-			// !OWNER (set game owner)
-			//
-
-			if( Command == "owner" )
+			else if( m_Latency >= 500 )
 			{
-				if( RootAdminCheck || IsOwner( User ) || !GetPlayerFromName( m_OwnerName, false ) )
-				{
-					if( !Payload.empty( ) )
-					{
-						SendAllChat( m_GHost->m_Language->SettingGameOwnerTo( Payload ) );
-						m_OwnerName = Payload;
-					}
-					else
-					{
-						SendAllChat( m_GHost->m_Language->SettingGameOwnerTo( User ) );
-						m_OwnerName = User;
-					}
-				}
-				else
-					SendAllChat( m_GHost->m_Language->UnableToSetGameOwner( m_OwnerName ) );
+				m_Latency = 500;
+				SendAllChat( m_GHost->m_Language->SettingLatencyToMaximum( "500" ) );
 			}
+			else
+				SendAllChat( m_GHost->m_Language->SettingLatencyTo( UTIL_ToString( m_Latency ) ) );
+		}
+		break;
 
-			//
-			// !PING
-			//
-
-			if( Command == "ping" )
-			{
-				// kick players with ping higher than payload if payload isn't empty
-				// we only do this if the game hasn't started since we don't want to kick players from a game in progress
+	//
+	// !LOCK
+	//
 
-				uint32_t Kicked = 0;
-				uint32_t KickPing = 0;
+	case CBotCommand :: LOCK:
+		SendAllChat( m_GHost->m_Language->GameLocked( ) );
+		m_Locked = true;
+		break;
 
-				if( !m_GameLoading && !m_GameLoaded && !Payload.empty( ) )
-					KickPing = UTIL_ToUInt32( Payload );
+	//
+	// !MESSAGES
+	//
 
-				// copy the m_Players vector so we can sort by descending ping so it's easier to find players with high pings
+	case CBotCommand :: MESSAGES:
+		if( Payload == "on" )
+		{
+			SendAllChat( m_GHost->m_Language->LocalAdminMessagesEnabled( ) );
+			m_LocalAdminMessages = true;
+		}
+		else if( Payload == "off" )
+		{
+			SendAllChat( m_GHost->m_Language->LocalAdminMessagesDisabled( ) );
+			m_LocalAdminMessages = false;
+		}
+		break;
 
-				vector<CGamePlayer *> SortedPlayers = m_Players;
-				sort( SortedPlayers.begin( ), SortedPlayers.end( ), CGamePlayerSortDescByPing( ) );
-				string Pings;
+	//
+	// !MUTE
+	//
 
-				for( vector<CGamePlayer *> :: iterator i = SortedPlayers.begin( ); i != SortedPlayers.end( ); i++ )
-				{
-					Pings += (*i)->GetNameTerminated( );
-					Pings += ": ";
+	case CBotCommand :: MUTE:
+	{
+		CGamePlayer *LastMatch = NULL;
+		uint32_t Matches = GetPlayerFromNamePartial( Payload, &LastMatch );
 
-					if( (*i)->GetNumPings( ) > 0 )
-					{
-						Pings += UTIL_ToString( (*i)->GetPing( m_GHost->m_LCPings ) );
+		if( Matches == 0 )
+			SendAllChat( m_GHost->m_Language->UnableToMuteNoMatchesFound( Payload ) );
+		else if( Matches == 1 )
+		{
+			SendAllChat( m_GHost->m_Language->MutedPlayer( LastMatch->GetName( ), User ) );
+			LastMatch->SetMuted( true );
+		}
+		else
+			SendAllChat( m_GHost->m_Language->UnableToMuteFoundMoreThanOneMatch( Payload ) );
+		break;
+	}
 
-						if( !m_GameLoading && !m_GameLoaded && !(*i)->GetReserved( ) && KickPing > 0 && (*i)->GetPing( m_GHost->m_LCPings ) > KickPing )
-						{
-							(*i)->SetDeleteMe( true );
-							(*i)->SetLeftReason( "was kicked for excessive ping " + UTIL_ToString( (*i)->GetPing( m_GHost->m_LCPings ) ) + " > " + UTIL_ToString( KickPing ) );
-							(*i)->SetLeftCode( PLAYERLEAVE_LOBBY );
-							OpenSlot( GetSIDFromPID( (*i)->GetPID( ) ), false );
-							Kicked++;
-						}
+	//
+	// !MUTEALL
+	//
 
-						Pings += "ms";
-					}
-					else
-						Pings += "N/A";
+	case CBotCommand :: MUTEALL:
+		SendAllChat( m_GHost->m_Language->GlobalChatMuted( ) );
+		m_MuteAll = true;
+		break;
 
-					if( i != SortedPlayers.end( ) - 1 )
-						Pings += ", ";
+	//
+	// !OPEN (open slot)
+	//
 
-					if( ( m_GameLoading || m_GameLoaded ) && Pings.size( ) > 100 )
-					{
-						// cut the text into multiple lines ingame
+	case CBotCommand :: OPEN:
+	{
+		// open as many slots as specified, e.g. "5 10" opens slots 5 and 10
 
-						SendAllChat( Pings );
-						Pings.clear( );
-					}
-				}
+		stringstream SS;
+		SS << Payload;
 
-				if( !Pings.empty( ) )
-					SendAllChat( Pings );
+		while( !SS.eof( ) )
+		{
+			uint32_t SID;
+			SS >> SID;
 
-				if( Kicked > 0 )
-					SendAllChat( m_GHost->m_Language->KickingPlayersWithPingsGreaterThan( UTIL_ToString( Kicked ), UTIL_ToString( KickPing ) ) );
+			if( SS.fail( ) )
+			{
+				CONSOLE_Print( "[GAME: " + m_GameName + "] bad input to open command" );
+				break;
 			}
+			else
+				OpenSlot( (unsigned char)( SID - 1 ), true );
+		}
+		break;
+	}
 
-			//
-			// !PRIV (rehost as private game)
-			//
-
-			if( Command == "priv" && !Payload.empty( ) && !m_CountDownStarted && !m_SaveGame )
-			{
-				if( Payload.length() < 31 )
-				{
-					CONSOLE_Print( "[GAME: " + m_GameName + "] trying to rehost as private game [" + Payload + "]" );
-					SendAllChat( m_GHost->m_Language->TryingToRehostAsPrivateGame( Payload ) );
-					m_GameState = GAME_PRIVATE;
-					m_LastGameName = m_GameName;
-					m_GameName = Payload;
-					m_HostCounter = m_GHost->m_HostCounter++;
-					m_RefreshError = false;
-					m_RefreshRehosted = true;
-
-					for( vector<CBNET *> :: iterator i = m_GHost->m_BNETs.begin( ); i != m_GHost->m_BNETs.end( ); i++ )
-					{
-						// unqueue any existing game refreshes because we're going to assume the next successful game refresh indicates that the rehost worked
-						// this ignores the fact that it's possible a game refresh was just sent and no response has been received yet
-						// we assume this won't happen very often since the only downside is a potential false positive
+	//
+	// !OPENALL
+	//
 
-						(*i)->UnqueueGameRefreshes( );
-						(*i)->QueueGameUncreate( );
-						(*i)->QueueEnterChat( );
+	case CBotCommand :: OPENALL:
+		OpenAllSlots( );
+		break;
 
-						// we need to send the game creation message now because private games are not refreshed
+	//
+	// !OWNER (set game owner)
+	//
 
-						(*i)->QueueGameCreate( m_GameState, m_GameName, string( ), m_Map, NULL, m_HostCounter );
+	case CBotCommand :: OWNER:
+		if( RootAdminCheck || IsOwner( User ) || !GetPlayerFromName( m_OwnerName, false ) )
+		{
+			if( !Payload.empty( ) )
+			{
+				SendAllChat( m_GHost->m_Language->SettingGameOwnerTo( Payload ) );
+				m_OwnerName = Payload;
+			}
+			else
+			{
+				SendAllChat( m_GHost->m_Language->SettingGameOwnerTo( User ) );
+				m_OwnerName = User;
+			}
+		}
+		else
+			SendAllChat( m_GHost->m_Language->UnableToSetGameOwner( m_OwnerName ) );
+		break;
 
-						if( (*i)->GetPasswordHashType( ) != "pvpgn" )
-							(*i)->QueueEnterChat( );
-					}
+	//
+	// !PING
+	//
 
-					m_CreationTime = GetTime( );
-					m_LastRefreshTime = GetTime( );
-				}
-				else
-					SendAllChat( m_GHost->m_Language->UnableToCreateGameNameTooLong( Payload ) );
-			}
+	case CBotCommand :: PING:
+	{
+		// kick players with ping higher than payload if payload isn't empty
+		// we only do this if the game hasn't started since we don't want to kick players from a game in progress
 
-			//
-			// !PUB (rehost as public game)
-			//
+		uint32_t Kicked = 0;
+		uint32_t KickPing = 0;
 
-			if( Command == "pub" && !Payload.empty( ) && !m_CountDownStarted && !m_SaveGame )
-			{
-				if( Payload.length() < 31 )
-				{
-					CONSOLE_Print( "[GAME: " + m_GameName + "] trying to rehost as public game [" + Payload + "]" );
-					SendAllChat( m_GHost->m_Language->TryingToRehostAsPublicGame( Payload ) );
-					m_GameState = GAME_PUBLIC;
-					m_LastGameName = m_GameName;
-					m_GameName = Payload;
-					m_HostCounter = m_GHost->m_HostCounter++;
-					m_RefreshError = false;
-					m_RefreshRehosted = true;
-
-					for( vector<CBNET *> :: iterator i = m_GHost->m_BNETs.begin( ); i != m_GHost->m_BNETs.end( ); i++ )
-					{
-						// unqueue any existing game refreshes because we're going to assume the next successful game refresh indicates that the rehost worked
-						// this ignores the fact that it's possible a game refresh was just sent and no response has been received yet
-						// we assume this won't happen very often since the only downside is a potential false positive
+		if( !m_GameLoading && !m_GameLoaded && !Payload.empty( ) )
+			KickPing = UTIL_ToUInt32( Payload );
 
-						(*i)->UnqueueGameRefreshes( );
-						(*i)->QueueGameUncreate( );
-						(*i)->QueueEnterChat( );
+		// copy the m_Players vector so we can sort by descending ping so it's easier to find players with high pings
 
-						// the game creation message will be sent on the next refresh
-					}
+		vector<CGamePlayer *> SortedPlayers = m_Players;
+		sort( SortedPlayers.begin( ), SortedPlayers.end( ), CGamePlayerSortDescByPing( ) );
+		string Pings;
 
-					m_CreationTime = GetTime( );
-					m_LastRefreshTime = GetTime( );
-				}
-				else
-					SendAllChat( m_GHost->m_Language->UnableToCreateGameNameTooLong( Payload ) );
-			}
-			//
-			// !REFRESH (turn on or off refresh messages)
-			//
+		for( vector<CGamePlayer *> :: iterator i = SortedPlayers.begin( ); i != SortedPlayers.end( ); i++ )
+		{
+			Pings += (*i)->GetNameTerminated( );
+			Pings += ": ";
 
-			if( Command == "refresh" && !m_CountDownStarted )
+			if( (*i)->GetNumPings( ) > 0 )
 			{
-				if( Payload == "on" )
-				{
-					SendAllChat( m_GHost->m_Language->RefreshMessagesEnabled( ) );
-					m_RefreshMessages = true;
-				}
-				else if( Payload == "off" )
+				Pings += UTIL_ToString( (*i)->GetPing( m_GHost->m_LCPings ) );
+
+				if( !m_GameLoading && !m_GameLoaded && !(*i)->GetReserved( ) && KickPing > 0 && (*i)->GetPing( m_GHost->m_LCPings ) > KickPing )
 				{
-					SendAllChat( m_GHost->m_Language->RefreshMessagesDisabled( ) );
-					m_RefreshMessages = false;
+					(*i)->SetDeleteMe( true );
+					(*i)->SetLeftReason( "was kicked for excessive ping " + UTIL_ToString( (*i)->GetPing( m_GHost->m_LCPings ) ) + " > " + UTIL_ToString( KickPing ) );
+					(*i)->SetLeftCode( PLAYERLEAVE_LOBBY );
+					OpenSlot( GetSIDFromPID( (*i)->GetPID( ) ), false );
+					Kicked++;
 				}
+
+				Pings += "ms";
 			}
+			else
+				Pings += "N/A";
 
-			//
-			// !SAY
-			//
+			if( i != SortedPlayers.end( ) - 1 )
+				Pings += ", ";
 
-			if( Command == "say" && !Payload.empty( ) )
+			if( ( m_GameLoading || m_GameLoaded ) && Pings.size( ) > 100 )
 			{
-				for( vector<CBNET *> :: iterator i = m_GHost->m_BNETs.begin( ); i != m_GHost->m_BNETs.end( ); i++ )
-					(*i)->QueueChatCommand( Payload );
+				// cut the text into multiple lines ingame
 
-				HideCommand = true;
+				SendAllChat( Pings );
+				Pings.clear( );
 			}
+		}
 
-			//
-			// !SENDLAN
-			//
+		if( !Pings.empty( ) )
+			SendAllChat( Pings );
 
-			if( Command == "sendlan" && !Payload.empty( ) && !m_CountDownStarted )
+		if( Kicked > 0 )
+			SendAllChat( m_GHost->m_Language->KickingPlayersWithPingsGreaterThan( UTIL_ToString( Kicked ), UTIL_ToString( KickPing ) ) );
+		break;
+	}
+
+	//
+	// !PRIV (rehost as private game)
+	//
+
+	case CBotCommand :: PRIV:
+		if( Payload.length() < 31 )
+		{
+			CONSOLE_Print( "[GAME: " + m_GameName + "] trying to rehost as private game [" + Payload + "]" );
+			SendAllChat( m_GHost->m_Language->TryingToRehostAsPrivateGame( Payload ) );
+			m_GameState = GAME_PRIVATE;
+			m_LastGameName = m_GameName;
+			m_GameName = Payload;
+			m_HostCounter = m_GHost->m_HostCounter++;
+			m_RefreshError = false;
+			m_RefreshRehosted = true;
+
+			for( vector<CBNET *> :: iterator i = m_GHost->m_BNETs.begin( ); i != m_GHost->m_BNETs.end( ); i++ )
 			{
-				// extract the ip and the port
-				// e.g. "1.2.3.4 6112" -> ip: "1.2.3.4", port: "6112"
+				// unqueue any existing game refreshes because we're going to assume the next successful game refresh indicates that the rehost worked
+				// this ignores the fact that it's possible a game refresh was just sent and no response has been received yet
+				// we assume this won't happen very often since the only downside is a potential false positive
 
-				string IP;
-				uint32_t Port = 6112;
-				stringstream SS;
-				SS << Payload;
-				SS >> IP;
+				(*i)->UnqueueGameRefreshes( );
+				(*i)->QueueGameUncreate( );
+				(*i)->QueueEnterChat( );
 
-				if( !SS.eof( ) )
-					SS >> Port;
+				// we need to send the game creation message now because private games are not refreshed
 
-				if( SS.fail( ) )
-					CONSOLE_Print( "[GAME: " + m_GameName + "] bad inputs to sendlan command" );
-				else
-				{
-					// we send 12 for SlotsTotal because this determines how many PID's Warcraft 3 allocates
-					// we need to make sure Warcraft 3 allocates at least SlotsTotal + 1 but at most 12 PID's
-					// this is because we need an extra PID for the virtual host player (but we always delete the virtual host player when the 12th person joins)
-					// however, we can't send 13 for SlotsTotal because this causes Warcraft 3 to crash when sharing control of units
-					// nor can we send SlotsTotal because then Warcraft 3 crashes when playing maps with less than 12 PID's (because of the virtual host player taking an extra PID)
-					// we also send 12 for SlotsOpen because Warcraft 3 assumes there's always at least one player in the game (the host)
-					// so if we try to send accurate numbers it'll always be off by one and results in Warcraft 3 assuming the game is full when it still needs one more player
-					// the easiest solution is to simply send 12 for both so the game will always show up as (1/12) players
-
-					if( m_SaveGame )
-					{
-						// note: the PrivateGame flag is not set when broadcasting to LAN (as you might expect)
-
-						uint32_t MapGameType = MAPGAMETYPE_SAVEDGAME;
-						BYTEARRAY MapWidth;
-						MapWidth.push_back( 0 );
-						MapWidth.push_back( 0 );
-						BYTEARRAY MapHeight;
-						MapHeight.push_back( 0 );
-						MapHeight.push_back( 0 );
-						m_GHost->m_UDPSocket->SendTo( IP, Port, m_Protocol->SEND_W3GS_GAMEINFO( m_GHost->m_TFT, m_GHost->m_LANWar3Version, UTIL_CreateByteArray( MapGameType, false ), m_Map->GetMapGameFlags( ), MapWidth, MapHeight, m_GameName, "Varlock", GetTime( ) - m_CreationTime, "Save\\Multiplayer\\" + m_SaveGame->GetFileNameNoPath( ), m_SaveGame->GetMagicNumber( ), 12, 12, m_HostPort, m_HostCounter ) );
-					}
-					else
-					{
-						// note: the PrivateGame flag is not set when broadcasting to LAN (as you might expect)
-						// note: we do not use m_Map->GetMapGameType because none of the filters are set when broadcasting to LAN (also as you might expect)
+				(*i)->QueueGameCreate( m_GameState, m_GameName, string( ), m_Map, NULL, m_HostCounter );
 
-						uint32_t MapGameType = MAPGAMETYPE_UNKNOWN0;
-						m_GHost->m_UDPSocket->SendTo( IP, Port, m_Protocol->SEND_W3GS_GAMEINFO( m_GHost->m_TFT, m_GHost->m_LANWar3Version, UTIL_CreateByteArray( MapGameType, false ), m_Map->GetMapGameFlags( ), m_Map->GetMapWidth( ), m_Map->GetMapHeight( ), m_GameName, "Varlock", GetTime( ) - m_CreationTime, m_GHost->m_MapPath + "/" + m_Map->GetMapLocalPath( ), m_Map->GetMapCRC( ), 12, 12, m_HostPort, m_HostCounter ) );
-					}
-				}
+				if( (*i)->GetPasswordHashType( ) != "pvpgn" )
+					(*i)->QueueEnterChat( );
 			}
 
-			//
-			// !SP
-			//
+			m_CreationTime = GetTime( );
+			m_GHost->m_Timers->ScheduleIn( &m_RefreshTimer, 3000 );
+		}
+		else
+			SendAllChat( m_GHost->m_Language->UnableToCreateGameNameTooLong( Payload ) );
+		break;
+
+	//
+	// !PUB (rehost as public game)
+	//
 
-			if( Command == "sp" && !m_CountDownStarted )
+	case CBotCommand :: PUB:
+		if( Payload.length() < 31 )
+		{
+			CONSOLE_Print( "[GAME: " + m_GameName + "] trying to rehost as public game [" + Payload + "]" );
+			SendAllChat( m_GHost->m_Language->TryingToRehostAsPublicGame( Payload ) );
+			m_GameState = GAME_PUBLIC;
+			m_LastGameName = m_GameName;
+			m_GameName = Payload;
+			m_HostCounter = m_GHost->m_HostCounter++;
+			m_RefreshError = false;
+			m_RefreshRehosted = true;
+
+			for( vector<CBNET *> :: iterator i = m_GHost->m_BNETs.begin( ); i != m_GHost->m_BNETs.end( ); i++ )
 			{
-				SendAllChat( m_GHost->m_Language->ShufflingPlayers( ) );
-				ShuffleSlots( );
+				// unqueue any existing game refreshes because we're going to assume the next successful game refresh indicates that the rehost worked
+				// this ignores the fact that it's possible a game refresh was just sent and no response has been received yet
+				// we assume this won't happen very often since the only downside is a potential false positive
+
+				(*i)->UnqueueGameRefreshes( );
+				(*i)->QueueGameUncreate( );
+				(*i)->QueueEnterChat( );
+
+				// the game creation message will be sent on the next refresh
 			}
 
-			//
-			// !START
-			//
+			m_CreationTime = GetTime( );
+			m_GHost->m_Timers->ScheduleIn( &m_RefreshTimer, 3000 );
+		}
+		else
+			SendAllChat( m_GHost->m_Language->UnableToCreateGameNameTooLong( Payload ) );
+		break;
 
-			if( Command == "start" && !m_CountDownStarted )
-			{
-				// if the player sent "!start force" skip the checks and start the countdown
-				// otherwise check that the game is ready to start
+	//
+	// !REFRESH (turn on or off refresh messages)
+	//
 
-				if( Payload == "force" )
-					StartCountDown( true );
-				else
-				{
-					if( GetTicks( ) - m_LastPlayerLeaveTicks >= 2000 )
-						StartCountDown( false );
-					else
-						SendAllChat( m_GHost->m_Language->CountDownAbortedSomeoneLeftRecently( ) );
-				}
-			}
+	case CBotCommand :: REFRESH:
+		if( Payload == "on" )
+		{
+			SendAllChat( m_GHost->m_Language->RefreshMessagesEnabled( ) );
+			m_RefreshMessages = true;
+		}
+		else if( Payload == "off" )
+		{
+			SendAllChat( m_GHost->m_Language->RefreshMessagesDisabled( ) );
+			m_RefreshMessages = false;
+		}
+		break;
 
-			//
-			// !SWAP (swap slots)
-			//
+	//
+	// !SAY
+	//
 
-			if( Command == "swap" && !Payload.empty( ) && !m_GameLoading && !m_GameLoaded )
-			{
-				uint32_t SID1;
-				uint32_t SID2;
-				stringstream SS;
-				SS << Payload;
-				SS >> SID1;
+	case CBotCommand :: SAY:
+		for( vector<CBNET *> :: iterator i = m_GHost->m_BNETs.begin( ); i != m_GHost->m_BNETs.end( ); i++ )
+			(*i)->QueueChatCommand( Payload );
 
-				if( SS.fail( ) )
-					CONSOLE_Print( "[GAME: " + m_GameName + "] bad input #1 to swap command" );
-				else
-				{
-					if( SS.eof( ) )
-						CONSOLE_Print( "[GAME: " + m_GameName + "] missing input #2 to swap command" );
-					else
-					{
-						SS >> SID2;
+		HideCommand = true;
+		break;
 
-						if( SS.fail( ) )
-							CONSOLE_Print( "[GAME: " + m_GameName + "] bad input #2 to swap command" );
-						else
-							SwapSlots( (unsigned char)( SID1 - 1 ), (unsigned char)( SID2 - 1 ) );
-					}
-				}
-			}
+	//
+	// !SENDLAN
+	//
+
+	case CBotCommand :: SENDLAN:
+	{
+		// extract the ip and the port
+		// e.g. "1.2.3.4 6112" -> ip: "1.2.3.4", port: "6112"
+
+		string IP;
+		uint32_t Port = 6112;
+		stringstream SS;
+		SS << Payload;
+		SS >> IP;
 
-			//
-			// !SYNCLIMIT
-			//
+		if( !SS.eof( ) )
+			SS >> Port;
 
-			if( Command == "synclimit" )
+		if( SS.fail( ) )
+			CONSOLE_Print( "[GAME: " + m_GameName + "] bad inputs to sendlan command" );
+		else
+		{
+			// we send 12 for SlotsTotal because this determines how many PID's Warcraft 3 allocates
+			// we need to make sure Warcraft 3 allocates at least SlotsTotal + 1 but at most 12 PID's
+			// this is because we need an extra PID for the virtual host player (but we always delete the virtual host player when the 12th person joins)
+			// however, we can't send 13 for SlotsTotal because this causes Warcraft 3 to crash when sharing control of units
+			// nor can we send SlotsTotal because then Warcraft 3 crashes when playing maps with less than 12 PID's (because of the virtual host player taking an extra PID)
+			// we also send 12 for SlotsOpen because Warcraft 3 assumes there's always at least one player in the game (the host)
+			// so if we try to send accurate numbers it'll always be off by one and results in Warcraft 3 assuming the game is full when it still needs one more player
+			// the easiest solution is to simply send 12 for both so the game will always show up as (1/12) players
+
+			if( m_SaveGame )
 			{
-				if( Payload.empty( ) )
-					SendAllChat( m_GHost->m_Language->SyncLimitIs( UTIL_ToString( m_SyncLimit ) ) );
-				else
-				{
-					m_SyncLimit = UTIL_ToUInt32( Payload );
+				// note: the PrivateGame flag is not set when broadcasting to LAN (as you might expect)
+
+				uint32_t MapGameType = MAPGAMETYPE_SAVEDGAME;
+				BYTEARRAY MapWidth;
+				MapWidth.push_back( 0 );
+				MapWidth.push_back( 0 );
+				BYTEARRAY MapHeight;
+				MapHeight.push_back( 0 );
+				MapHeight.push_back( 0 );
+				m_GHost->m_UDPSocket->SendTo( IP, Port, m_Protocol->SEND_W3GS_GAMEINFO( m_GHost->m_TFT, m_GHost->m_LANWar3Version, UTIL_CreateByteArray( MapGameType, false ), m_Map->GetMapGameFlags( ), MapWidth, MapHeight, m_GameName, "Varlock", GetTime( ) - m_CreationTime, "Save\\Multiplayer\\" + m_SaveGame->GetFileNameNoPath( ), m_SaveGame->GetMagicNumber( ), 12, 12, m_HostPort, m_HostCounter ) );
+			}
+			else
+			{
+				// note: the PrivateGame flag is not set when broadcasting to LAN (as you might expect)
+				// note: we do not use m_Map->GetMapGameType because none of the filters are set when broadcasting to LAN (also as you might expect)
 
-					if( m_SyncLimit <= 10 )
-					{
-						m_SyncLimit = 10;
-						SendAllChat( m_GHost->m_Language->SettingSyncLimitToMinimum( "10" ) );
-					}
-					else if( m_SyncLimit >= 10000 )
-					{
-						m_SyncLimit = 10000;
-						SendAllChat( m_GHost->m_Language->SettingSyncLimitToMaximum( "10000" ) );
-					}
-					else
-						SendAllChat( m_GHost->m_Language->SettingSyncLimitTo( UTIL_ToString( m_SyncLimit ) ) );
-				}
+				uint32_t MapGameType = MAPGAMETYPE_UNKNOWN0;
+				m_GHost->m_UDPSocket->SendTo( IP, Port, m_Protocol->SEND_W3GS_GAMEINFO( m_GHost->m_TFT, m_GHost->m_LANWar3Version, UTIL_CreateByteArray( MapGameType, false ), m_Map->GetMapGameFlags( ), m_Map->GetMapWidth( ), m_Map->GetMapHeight( ), m_GameName, "Varlock", GetTime( ) - m_CreationTime, m_GHost->m_MapPath + "/" + m_Map->GetMapLocalPath( ), m_Map->GetMapCRC( ), 12, 12, m_HostPort, m_HostCounter ) );
 			}
+		}
+		break;
+	}
 
-			//
-			// !UNHOST
-			//
+	//
+	// !SP
+	//
 
-			if( Command == "unhost" && !m_CountDownStarted )
-				m_Exiting = true;
+	case CBotCommand :: SP:
+		SendAllChat( m_GHost->m_Language->ShufflingPlayers( ) );
+		ShuffleSlots( );
+		break;
 
-			//
-			// !UNLOCK
-			//
+	//
+	// !START
+	//
 
-			if( Command == "unlock" && ( RootAdminCheck || IsOwner( User ) ) )
-			{
-				SendAllChat( m_GHost->m_Language->GameUnlocked( ) );
-				m_Locked = false;
-			}
+	case CBotCommand :: START:
+		// if the player sent "!start force" skip the checks and start the countdown
+		// otherwise check that the game is ready to start
 
-			//
-			// !UNMUTE
-			//
+		if( Payload == "force" )
+			StartCountDown( true );
+		else
+		{
+			if( GetTicks( ) - m_LastPlayerLeaveTicks >= 2000 )
+				StartCountDown( false );
+			else
+				SendAllChat( m_GHost->m_Language->CountDownAbortedSomeoneLeftRecently( ) );
+		}
+		break;
 
-			if( Command == "unmute" )
+	//
+	// !SWAP (swap slots)
+	//
+
+	case CBotCommand :: SWAP:
+	{
+		uint32_t SID1;
+		uint32_t SID2;
+		stringstream SS;
+		SS << Payload;
+		SS >> SID1;
+
+		if( SS.fail( ) )
+			CONSOLE_Print( "[GAME: " + m_GameName + "] bad input #1 to swap command" );
+		else
+		{
+			if( SS.eof( ) )
+				CONSOLE_Print( "[GAME: " + m_GameName + "] missing input #2 to swap command" );
+			else
 			{
-				CGamePlayer *LastMatch = NULL;
-				uint32_t Matches = GetPlayerFromNamePartial( Payload, &LastMatch );
+				SS >> SID2;
 
-				if( Matches == 0 )
-					SendAllChat( m_GHost->m_Language->UnableToMuteNoMatchesFound( Payload ) );
-				else if( Matches == 1 )
-				{
-					SendAllChat( m_GHost->m_Language->UnmutedPlayer( LastMatch->GetName( ), User ) );
-					LastMatch->SetMuted( false );
-				}
+				if( SS.fail( ) )
+					CONSOLE_Print( "[GAME: " + m_GameName + "] bad input #2 to swap command" );
 				else
-					SendAllChat( m_GHost->m_Language->UnableToMuteFoundMoreThanOneMatch( Payload ) );
+					SwapSlots( (unsigned char)( SID1 - 1 ), (unsigned char)( SID2 - 1 ) );
 			}
+		}
+		break;
+	}
 
-			//
-			// !UNMUTEALL
-			//
-
-			if( Command == "unmuteall" && m_GameLoaded )
-			{
-				SendAllChat( m_GHost->m_Language->GlobalChatUnmuted( ) );
-				m_MuteAll = false;
-			}
+	//
+	// !SYNCLIMIT
+	//
 
-			//
-			// !VIRTUALHOST
-			//
+	case CBotCommand :: SYNCLIMIT:
+		if( Payload.empty( ) )
+			SendAllChat( m_GHost->m_Language->SyncLimitIs( UTIL_ToString( m_SyncLimit ) ) );
+		else
+		{
+			m_SyncLimit = UTIL_ToUInt32( Payload );
 
-			if( Command == "virtualhost" && !Payload.empty( ) && Payload.size( ) <= 15 && !m_CountDownStarted )
+			if( m_SyncLimit <= 10 )
 			{
-				DeleteVirtualHost( );
-				m_VirtualHostName = Payload;
+				m_SyncLimit = 10;
+				SendAllChat( m_GHost->m_Language->SettingSyncLimitToMinimum( "10" ) );
 			}
-
-			//
-			// !VOTECANCEL
-			//
-
-			if( Command == "votecancel" && !m_KickVotePlayer.empty( ) )
+			else if( m_SyncLimit >= 10000 )
 			{
-				SendAllChat( m_GHost->m_Language->VoteKickCancelled( m_KickVotePlayer ) );
-				m_KickVotePlayer.clear( );
-				m_StartedKickVoteTime = 0;
+				m_SyncLimit = 10000;
+				SendAllChat( m_GHost->m_Language->SettingSyncLimitToMaximum( "10000" ) );
 			}
+			else
+				SendAllChat( m_GHost->m_Language->SettingSyncLimitTo( UTIL_ToString( m_SyncLimit ) ) );
+		}
+		break;
 
-			//
-			// !W
-			//
+	//
+	// !UNHOST
+	//
 
-			if( Command == "w" && !Payload.empty( ) )
-			{
-				// extract the name and the message
-				// e.g. "Varlock hello there!" -> name: "Varlock", message: "hello there!"
+	case CBotCommand :: UNHOST:
+		m_Exiting = true;
+		break;
 
-				string Name;
-				string Message;
-				string :: size_type MessageStart = Payload.find( " " );
+	//
+	// !UNLOCK
+	//
 
-				if( MessageStart != string :: npos )
-				{
-					Name = Payload.substr( 0, MessageStart );
-					Message = Payload.substr( MessageStart + 1 );
+	case CBotCommand :: UNLOCK:
+		SendAllChat( m_GHost->m_Language->GameUnlocked( ) );
+		m_Locked = false;
+		break;
 
-					for( vector<CBNET *> :: iterator i = m_GHost->m_BNETs.begin( ); i != m_GHost->m_BNETs.end( ); i++ )
-						(*i)->QueueChatCommand( Message, Name, true );
-				}
+	//
+	// !UNMUTE
+	//
 
-				HideCommand = true;
-			}
+	case CBotCommand :: UNMUTE:
+	{
+		CGamePlayer *LastMatch = NULL;
+		uint32_t Matches = GetPlayerFromNamePartial( Payload, &LastMatch );
+
+		if( Matches == 0 )
+			SendAllChat( m_GHost->m_Language->UnableToMuteNoMatchesFound( Payload ) );
+		else if( Matches == 1 )
+		{
+			SendAllChat( m_GHost->m_Language->UnmutedPlayer( LastMatch->GetName( ), User ) );
+			LastMatch->SetMuted( false );
 		}
 		else
+			SendAllChat( m_GHost->m_Language->UnableToMuteFoundMoreThanOneMatch( Payload ) );
+		break;
+	}
+
+	//
+	// !UNMUTEALL
+	//
+
+	case CBotCommand :: UNMUTEALL:
+		SendAllChat( m_GHost->m_Language->GlobalChatUnmuted( ) );
+		m_MuteAll = false;
+		break;
+
+	//
+	// !VIRTUALHOST
+	//
+
+	case CBotCommand :: VIRTUALHOST:
+		if( Payload.size( ) <= 15 )
 		{
-			CONSOLE_Print( "[GAME: " + m_GameName + "] admin command ignored, the game is locked" );
-			SendChat( player, m_GHost->m_Language->TheGameIsLocked( ) );
+			DeleteVirtualHost( );
+			m_VirtualHostName = Payload;
 		}
-	}
-	else
+
+		break;
+
+	//
+	// !VOTECANCEL
+	//
+
+	case CBotCommand :: VOTECANCEL:
+		if( !m_KickVotePlayer.empty( ) )
+		{
+			SendAllChat( m_GHost->m_Language->VoteKickCancelled( m_KickVotePlayer ) );
+			m_KickVotePlayer.clear( );
+			m_KickVoteTimer.Cancel( );
+		}
+
+		break;
+
+	//
+	// !W
+	//
+
+	case CBotCommand :: W:
 	{
-		if( !player->GetSpoofed( ) )
-			CONSOLE_Print( "[GAME: " + m_GameName + "] non-spoofchecked user [" + User + "] sent command [" + Command + "] with payload [" + Payload + "]" );
-		else
-			CONSOLE_Print( "[GAME: " + m_GameName + "] non-admin [" + User + "] sent command [" + Command + "] with payload [" + Payload + "]" );
+		// extract the name and the message
+		// e.g. "Varlock hello there!" -> name: "Varlock", message: "hello there!"
+
+		string Name;
+		string Message;
+		string :: size_type MessageStart = Payload.find( " " );
+
+		if( MessageStart != string :: npos )
+		{
+			Name = Payload.substr( 0, MessageStart );
+			Message = Payload.substr( MessageStart + 1 );
+
+			for( vector<CBNET *> :: iterator i = m_GHost->m_BNETs.begin( ); i != m_GHost->m_BNETs.end( ); i++ )
+				(*i)->QueueChatCommand( Message, Name, true );
+		}
+
+		HideCommand = true;
+		break;
 	}
 
 	/*********************
@@ -1622,143 +1777,156 @@ bool CGame :: EventPlayerBotCommand( CGamePlayer *player, string command, string
 	// !CHECKME
 	//
 
-	if( Command == "checkme" )
+	case CBotCommand :: CHECKME:
 		SendChat( player, m_GHost->m_Language->CheckedPlayer( User, player->GetNumPings( ) > 0 ? UTIL_ToString( player->GetPing( m_GHost->m_LCPings ) ) + "ms" : "N/A", m_GHost->m_DBLocal->FromCheck( UTIL_ByteArrayToUInt32( player->GetExternalIP( ), true ) ), AdminCheck || RootAdminCheck ? "Yes" : "No", IsOwner( User ) ? "Yes" : "No", player->GetSpoofed( ) ? "Yes" : "No", player->GetSpoofedRealm( ).empty( ) ? "N/A" : player->GetSpoofedRealm( ), player->GetReserved( ) ? "Yes" : "No" ) );
+		break;
 
 	//
 	// !STATS
 	//
 
-	if( Command == "stats" && GetTime( ) - player->GetStatsSentTime( ) >= 5 )
-	{
-		string StatsUser = User;
+	case CBotCommand :: STATS:
+		if( GetTime( ) - player->GetStatsSentTime( ) >= 5 )
+		{
+			string StatsUser = User;
 
-		if( !Payload.empty( ) )
-			StatsUser = Payload;
+			if( !Payload.empty( ) )
+				StatsUser = Payload;
 
-		if( player->GetSpoofed( ) && ( AdminCheck || RootAdminCheck || IsOwner( User ) ) )
-			m_PairedGPSChecks.push_back( PairedGPSCheck( string( ), m_GHost->m_DB->ThreadedGamePlayerSummaryCheck( StatsUser ) ) );
-		else
-			m_PairedGPSChecks.push_back( PairedGPSCheck( User, m_GHost->m_DB->ThreadedGamePlayerSummaryCheck( StatsUser ) ) );
+			if( player->GetSpoofed( ) && ( AdminCheck || RootAdminCheck || IsOwner( User ) ) )
+				m_PairedGPSChecks.push_back( PairedGPSCheck( string( ), StatsUser ) );
+			else
+				m_PairedGPSChecks.push_back( PairedGPSCheck( User, StatsUser ) );
 
-		player->SetStatsSentTime( GetTime( ) );
-	}
+			player->SetStatsSentTime( GetTime( ) );
+		}
+
+		break;
 
 	//
 	// !STATSDOTA
 	//
 
-	if( Command == "statsdota" && GetTime( ) - player->GetStatsDotASentTime( ) >= 5 )
-	{
-		string StatsUser = User;
+	case CBotCommand :: STATSDOTA:
+		if( GetTime( ) - player->GetStatsDotASentTime( ) >= 5 )
+		{
+			string StatsUser = User;
 
-		if( !Payload.empty( ) )
-			StatsUser = Payload;
+			if( !Payload.empty( ) )
+				StatsUser = Payload;
 
-		if( player->GetSpoofed( ) && ( AdminCheck || RootAdminCheck || IsOwner( User ) ) )
-			m_PairedDPSChecks.push_back( PairedDPSCheck( string( ), m_GHost->m_DB->ThreadedDotAPlayerSummaryCheck( StatsUser ) ) );
-		else
-			m_PairedDPSChecks.push_back( PairedDPSCheck( User, m_GHost->m_DB->ThreadedDotAPlayerSummaryCheck( StatsUser ) ) );
+			if( player->GetSpoofed( ) && ( AdminCheck || RootAdminCheck || IsOwner( User ) ) )
+				m_PairedDPSChecks.push_back( PairedDPSCheck( string( ), StatsUser ) );
+			else
+				m_PairedDPSChecks.push_back( PairedDPSCheck( User, StatsUser ) );
 
-		player->SetStatsDotASentTime( GetTime( ) );
-	}
+			player->SetStatsDotASentTime( GetTime( ) );
+		}
+
+		break;
 
 	//
 	// !VERSION
 	//
 
-	if( Command == "version" )
-	{
+	case CBotCommand :: VERSION:
 		if( player->GetSpoofed( ) && ( AdminCheck || RootAdminCheck || IsOwner( User ) ) )
 			SendChat( player, m_GHost->m_Language->VersionAdmin( m_GHost->m_Version ) );
 		else
 			SendChat( player, m_GHost->m_Language->VersionNotAdmin( m_GHost->m_Version ) );
-	}
+		break;
 
 	//
 	// !VOTEKICK
 	//
 
-	if( Command == "votekick" && m_GHost->m_VoteKickAllowed && !Payload.empty( ) )
-	{
-		if( !m_KickVotePlayer.empty( ) )
-			SendChat( player, m_GHost->m_Language->UnableToVoteKickAlreadyInProgress( ) );
-		else if( m_Players.size( ) == 2 )
-			SendChat( player, m_GHost->m_Language->UnableToVoteKickNotEnoughPlayers( ) );
-		else
+	case CBotCommand :: VOTEKICK:
+		if( m_GHost->m_VoteKickAllowed )
 		{
-			CGamePlayer *LastMatch = NULL;
-			uint32_t Matches = GetPlayerFromNamePartial( Payload, &LastMatch );
-
-			if( Matches == 0 )
-				SendChat( player, m_GHost->m_Language->UnableToVoteKickNoMatchesFound( Payload ) );
-			else if( Matches == 1 )
+			if( !m_KickVotePlayer.empty( ) )
+				SendChat( player, m_GHost->m_Language->UnableToVoteKickAlreadyInProgress( ) );
+			else if( m_Players.size( ) == 2 )
+				SendChat( player, m_GHost->m_Language->UnableToVoteKickNotEnoughPlayers( ) );
+			else
 			{
-				if( LastMatch->GetReserved( ) )
-					SendChat( player, m_GHost->m_Language->UnableToVoteKickPlayerIsReserved( LastMatch->GetName( ) ) );
-				else
+				CGamePlayer *LastMatch = NULL;
+				uint32_t Matches = GetPlayerFromNamePartial( Payload, &LastMatch );
+
+				if( Matches == 0 )
+					SendChat( player, m_GHost->m_Language->UnableToVoteKickNoMatchesFound( Payload ) );
+				else if( Matches == 1 )
 				{
-					m_KickVotePlayer = LastMatch->GetName( );
-					m_StartedKickVoteTime = GetTime( );
+					if( LastMatch->GetReserved( ) )
+						SendChat( player, m_GHost->m_Language->UnableToVoteKickPlayerIsReserved( LastMatch->GetName( ) ) );
+					else
+					{
+						m_KickVotePlayer = LastMatch->GetName( );
+						m_GHost->m_Timers->ScheduleIn( &m_KickVoteTimer, 60000 );
 
-					for( vector<CGamePlayer *> :: iterator i = m_Players.begin( ); i != m_Players.end( ); i++ )
-						(*i)->SetKickVote( false );
+						for( vector<CGamePlayer *> :: iterator i = m_Players.begin( ); i != m_Players.end( ); i++ )
+							(*i)->SetKickVote( false );
 
-					player->SetKickVote( true );
-					CONSOLE_Print( "[GAME: " + m_GameName + "] votekick against player [" + m_KickVotePlayer + "] started by player [" + User + "]" );
-					SendAllChat( m_GHost->m_Language->StartedVoteKick( LastMatch->GetName( ), User, UTIL_ToString( (uint32_t)ceil( ( GetNumHumanPlayers( ) - 1 ) * (float)m_GHost->m_VoteKickPercentage / 100 ) - 1 ) ) );
-					SendAllChat( m_GHost->m_Language->TypeYesToVote( string( 1, m_GHost->m_CommandTrigger ) ) );
+						player->SetKickVote( true );
+						CONSOLE_Print( "[GAME: " + m_GameName + "] votekick against player [" + m_KickVotePlayer + "] started by player [" + User + "]" );
+						SendAllChat( m_GHost->m_Language->StartedVoteKick( LastMatch->GetName( ), User, UTIL_ToString( (uint32_t)ceil( ( GetNumHumanPlayers( ) - 1 ) * (float)m_GHost->m_VoteKickPercentage / 100 ) - 1 ) ) );
+						SendAllChat( m_GHost->m_Language->TypeYesToVote( string( 1, m_GHost->m_CommandTrigger ) ) );
+					}
 				}
+				else
+					SendChat( player, m_GHost->m_Language->UnableToVoteKickFoundMoreThanOneMatch( Payload ) );
 			}
-			else
-				SendChat( player, m_GHost->m_Language->UnableToVoteKickFoundMoreThanOneMatch( Payload ) );
 		}
-	}
+
+		break;
 
 	//
 	// !YES
 	//
 
-	if( Command == "yes" && !m_KickVotePlayer.empty( ) && player->GetName( ) != m_KickVotePlayer && !player->GetKickVote( ) )
-	{
-		player->SetKickVote( true );
-		uint32_t VotesNeeded = (uint32_t)ceil( ( GetNumHumanPlayers( ) - 1 ) * (float)m_GHost->m_VoteKickPercentage / 100 );
-		uint32_t Votes = 0;
-
-		for( vector<CGamePlayer *> :: iterator i = m_Players.begin( ); i != m_Players.end( ); i++ )
+	case CBotCommand :: YES:
+		if( !m_KickVotePlayer.empty( ) && player->GetName( ) != m_KickVotePlayer && !player->GetKickVote( ) )
 		{
-			if( (*i)->GetKickVote( ) )
-				Votes++;
-		}
+			player->SetKickVote( true );
+			uint32_t VotesNeeded = (uint32_t)ceil( ( GetNumHumanPlayers( ) - 1 ) * (float)m_GHost->m_VoteKickPercentage / 100 );
+			uint32_t Votes = 0;
 
-		if( Votes >= VotesNeeded )
-		{
-			CGamePlayer *Victim = GetPlayerFromName( m_KickVotePlayer, true );
+			for( vector<CGamePlayer *> :: iterator i = m_Players.begin( ); i != m_Players.end( ); i++ )
+			{
+				if( (*i)->GetKickVote( ) )
+					Votes++;
+			}
 
-			if( Victim )
+			if( Votes >= VotesNeeded )
 			{
-				Victim->SetDeleteMe( true );
-				Victim->SetLeftReason( m_GHost->m_Language->WasKickedByVote( ) );
+				CGamePlayer *Victim = GetPlayerFromName( m_KickVotePlayer, true );
 
-				if( !m_GameLoading && !m_GameLoaded )
-					Victim->SetLeftCode( PLAYERLEAVE_LOBBY );
-				else
-					Victim->SetLeftCode( PLAYERLEAVE_LOST );
+				if( Victim )
+				{
+					Victim->SetDeleteMe( true );
+					Victim->SetLeftReason( m_GHost->m_Language->WasKickedByVote( ) );
 
-				if( !m_GameLoading && !m_GameLoaded )
-					OpenSlot( GetSIDFromPID( Victim->GetPID( ) ), false );
+					if( !m_GameLoading && !m_GameLoaded )
+						Victim->SetLeftCode( PLAYERLEAVE_LOBBY );
+					else
+						Victim->SetLeftCode( PLAYERLEAVE_LOST );
 
-				CONSOLE_Print( "[GAME: " + m_GameName + "] votekick against player [" + m_KickVotePlayer + "] passed with " + UTIL_ToString( Votes ) + "/" + UTIL_ToString( GetNumHumanPlayers( ) ) + " votes" );
-				SendAllChat( m_GHost->m_Language->VoteKickPassed( m_KickVotePlayer ) );
+					if( !m_GameLoading && !m_GameLoaded )
+						OpenSlot( GetSIDFromPID( Victim->GetPID( ) ), false );
+
+					CONSOLE_Print( "[GAME: " + m_GameName + "] votekick against player [" + m_KickVotePlayer + "] passed with " + UTIL_ToString( Votes ) + "/" + UTIL_ToString( GetNumHumanPlayers( ) ) + " votes" );
+					SendAllChat( m_GHost->m_Language->VoteKickPassed( m_KickVotePlayer ) );
+				}
+				else
+					SendAllChat( m_GHost->m_Language->ErrorVoteKickingPlayer( m_KickVotePlayer ) );
+
+				m_KickVotePlayer.clear( );
+				m_KickVoteTimer.Cancel( );
 			}
 			else
-				SendAllChat( m_GHost->m_Language->ErrorVoteKickingPlayer( m_KickVotePlayer ) );
-
-			m_KickVotePlayer.clear( );
-			m_StartedKickVoteTime = 0;
+				SendAllChat( m_GHost->m_Language->VoteKickAcceptedNeedMoreVotes( m_KickVotePlayer, User, UTIL_ToString( VotesNeeded - Votes ) ) );
 		}
-		else
-			SendAllChat( m_GHost->m_Language->VoteKickAcceptedNeedMoreVotes( m_KickVotePlayer, User, UTIL_ToString( VotesNeeded - Votes ) ) );
+
+		break;
 	}
 
 	return HideCommand;
@@ -1775,6 +1943,27 @@ void CGame :: EventGameStarted( )
 
 	for( vector<CGamePlayer *> :: iterator i = m_Players.begin( ); i != m_Players.end( ); i++ )
 		m_DBBans.push_back( new CDBBan( (*i)->GetJoinedRealm( ), (*i)->GetName( ), (*i)->GetExternalIPString( ), string( ), string( ), string( ), string( ) ) );
+
+	if( m_Stats )
+	{
+		// the stats class can't look up the game name or players by colour itself because it might be running on the stats worker thread
+
+		m_Stats->SetGameName( m_GameName );
+
+		for( vector<CGamePlayer *> :: iterator i = m_Players.begin( ); i != m_Players.end( ); i++ )
+		{
+			unsigned char SID = GetSIDFromPID( (*i)->GetPID( ) );
+
+			if( SID < m_Slots.size( ) )
+				m_Stats->SetColourPlayer( m_Slots[SID].GetColour( ), (*i)->GetName( ), (*i)->GetSpoofedRealm( ) );
+		}
+
+		if( m_GHost->m_StatsWorker )
+		{
+			m_StatsQueue = new CStatsQueue( m_Stats, 4096 );
+			m_GHost->m_StatsWorker->Add( m_StatsQueue );
+		}
+	}
 }
 
 bool CGame :: IsGameDataSaved( )
@@ -1790,36 +1979,15 @@ void CGame :: SaveGameData( )
 
 bool CGame :: IsRootAdmin( string username )
 {
-    bool IsRootAdmin = false;
-    transform( username.begin( ), username.end( ), username.begin( ), (int(*)(int))tolower );
-    
-    if(m_GHost->m_AdminList.find(username) != m_GHost->m_AdminList.end()) {
-        IsRootAdmin = m_GHost->m_AdminList[username] > 9;
-    }
-    
-    return IsRootAdmin;
+	return m_GHost->GetAdminLevel( username ) > 9;
 }
 
 bool CGame :: IsAdmin( string username )
 {
-    bool IsAdmin = false;
-    transform( username.begin( ), username.end( ), username.begin( ), (int(*)(int))tolower );
-    
-    if(m_GHost->m_AdminList.find(username) != m_GHost->m_AdminList.end()) {
-        IsAdmin = m_GHost->m_AdminList[username] > 4;
-    }
-    
-    return IsAdmin;
+	return m_GHost->GetAdminLevel( username ) > 4;
 }
 
 bool CGame :: IsPremium( string username )
 {
-    bool IsPremium = false;
-    transform( username.begin( ), username.end( ), username.begin( ), (int(*)(int))tolower );
-    
-    if(m_GHost->m_AdminList.find(username) != m_GHost->m_AdminList.end()) {
-        IsPremium = m_GHost->m_AdminList[username] > 2;
-    }
-    
-    return IsPremium;
-}
\ No newline at end of file
+	return m_GHost->GetAdminLevel( username ) > 2;
+}
@@ -21,6 +21,100 @@
 #ifndef GAME_H
 #define GAME_H
 
+//
+// CBotCommand
+//
+
+// who is allowed to use a command
+// note: there's no separate level for the game owner, the owner has the same access as a root admin (as with the old !lock and !unlock checks)
+// note: root admins and the game owner can use every command even if the game is locked
+
+#define BOTCOMMAND_ACCESS_ANYONE		0	// everyone
+#define BOTCOMMAND_ACCESS_ADMIN			1	// spoof checked admins, root admins and the game owner
+#define BOTCOMMAND_ACCESS_ROOTADMIN		2	// spoof checked root admins and the game owner
+
+// the game state a command requires, the command is silently ignored otherwise
+
+#define BOTCOMMAND_IF_PAYLOAD			1	// the payload isn't empty
+#define BOTCOMMAND_IF_NOTSTARTED		2	// the countdown hasn't started
+#define BOTCOMMAND_IF_COUNTDOWN			4	// the countdown has started
+#define BOTCOMMAND_IF_LOBBY				8	// the game isn't loading or loaded
+#define BOTCOMMAND_IF_LOADED			16	// the game is loaded
+#define BOTCOMMAND_IF_NOTSAVEGAME		32	// the game isn't a saved game
+#define BOTCOMMAND_IF_BNET				64	// we are connected to at least one battle.net server
+
+class CBotCommand
+{
+public:
+	enum ID {
+		ABORT,
+		ADDBAN,
+		ANNOUNCE,
+		AUTOSAVE,
+		AUTOSTART,
+		BANLAST,
+		CHECK,
+		CHECKBAN,
+		CLEARHCL,
+		CLOSE,
+		CLOSEALL,
+		COMP,
+		COMPCOLOUR,
+		COMPHANDICAP,
+		COMPRACE,
+		COMPTEAM,
+		DBSTATUS,
+		DOWNLOAD,
+		DROP,
+		END,
+		FAKEPLAYER,
+		FPPAUSE,
+		FPRESUME,
+		FROM,
+		HCL,
+		HOLD,
+		KICK,
+		LATENCY,
+		LOCK,
+		MESSAGES,
+		MUTE,
+		MUTEALL,
+		OPEN,
+		OPENALL,
+		OWNER,
+		PING,
+		PRIV,
+		PUB,
+		REFRESH,
+		SAY,
+		SENDLAN,
+		SP,
+		START,
+		SWAP,
+		SYNCLIMIT,
+		UNHOST,
+		UNLOCK,
+		UNMUTE,
+		UNMUTEALL,
+		VIRTUALHOST,
+		VOTECANCEL,
+		W,
+		CHECKME,
+		STATS,
+		STATSDOTA,
+		VERSION,
+		VOTEKICK,
+		YES
+	};
+
+	uint32_t m_ID;
+	uint32_t m_Access;						// BOTCOMMAND_ACCESS_*
+	uint32_t m_Conditions;					// BOTCOMMAND_IF_* flags
+
+	CBotCommand( ) : m_ID( 0 ), m_Access( BOTCOMMAND_ACCESS_ANYONE ), m_Conditions( 0 ) { }
+	CBotCommand( uint32_t nID, uint32_t nAccess, uint32_t nConditions ) : m_ID( nID ), m_Access( nAccess ), m_Conditions( nConditions ) { }
+};
+
 //
 // CGame
 //
@@ -29,16 +123,15 @@ class CDBBan;
 class CDBGame;
 class CDBGamePlayer;
 class CStats;
+class CStatsQueue;
 class CCallableBanCheck;
 class CCallableBanAdd;
 class CCallableGameAdd;
-class CCallableGamePlayerSummaryCheck;
-class CCallableDotAPlayerSummaryCheck;
 
 typedef pair<string,CCallableBanCheck *> PairedBanCheck;
 typedef pair<string,CCallableBanAdd *> PairedBanAdd;
-typedef pair<string,CCallableGamePlayerSummaryCheck *> PairedGPSCheck;
-typedef pair<string,CCallableDotAPlayerSummaryCheck *> PairedDPSCheck;
+typedef pair<string,string> PairedGPSCheck;
+typedef pair<string,string> PairedDPSCheck;
 
 class CGame : public CBaseGame
 {
@@ -48,11 +141,12 @@ protected:
 	CDBGame *m_DBGame;							// potential game data for the database
 	vector<CDBGamePlayer *> m_DBGamePlayers;	// vector of potential gameplayer data for the database
 	CStats *m_Stats;							// class to keep track of game stats such as kills/deaths/assists in dota
+	CStatsQueue *m_StatsQueue;					// the queue of actions waiting to be processed by the stats worker thread (NULL = the stats are processed on the main thread)
 	CCallableGameAdd *m_CallableGameAdd;		// threaded database game addition in progress
 	vector<PairedBanCheck> m_PairedBanChecks;	// vector of paired threaded database ban checks in progress
 	vector<PairedBanAdd> m_PairedBanAdds;		// vector of paired threaded database ban adds in progress
-	vector<PairedGPSCheck> m_PairedGPSChecks;	// vector of paired threaded database game player summary checks in progress
-	vector<PairedDPSCheck> m_PairedDPSChecks;	// vector of paired threaded database DotA player summary checks in progress
+	vector<PairedGPSCheck> m_PairedGPSChecks;	// vector of paired game player summary requests waiting for the summary cache (requester, name)
+	vector<PairedDPSCheck> m_PairedDPSChecks;	// vector of paired DotA player summary requests waiting for the summary cache (requester, name)
 
 public:
 	CGame( CGHost *nGHost, CMap *nMap, CSaveGame *nSaveGame, uint16_t nHostPort, unsigned char nGameState, string nGameName, string nOwnerName, string nCreatorName, string nCreatorServer, uint32_t nGameId );
@@ -62,6 +156,7 @@ public:
 	virtual void EventPlayerDeleted( CGamePlayer *player );
 	virtual void EventPlayerAction( CGamePlayer *player, CIncomingAction *action );
 	virtual bool EventPlayerBotCommand( CGamePlayer *player, string command, string payload );
+	static CBotCommand *GetBotCommand( string command );
 	virtual void EventGameStarted( );
 	virtual bool IsGameDataSaved( );
 	virtual void SaveGameData( );
@@ -31,7 +31,11 @@
 #include "replay.h"
 #include "gameplayer.h"
 #include "gameprotocol.h"
+#include "timerwheel.h"
 #include "game_base.h"
+#include "metrics.h"
+#include "playeridcache.h"
+#include "checksumlog.h"
 
 #include <cmath>
 #include <string.h>
@@ -89,31 +93,35 @@ CBaseGame :: CBaseGame( CGHost *nGHost, CMap *nMap, CSaveGame *nSaveGame, uint16
 	m_HCLCommandString = m_Map->GetMapDefaultHCL( );
 	m_RandomSeed = GetTicks( );
 	m_HostCounter = m_GHost->m_HostCounter++;
+	m_Metrics = new CGameMetrics( m_GHost->m_Metrics, CMetrics :: Label( "game", nGameName ) + "," + CMetrics :: Label( "id", UTIL_ToString( m_HostCounter ) ) );
+	m_CheckSumLog = new CCheckSumLog( );
 	m_Latency = m_GHost->m_Latency;
 	m_SyncLimit = m_GHost->m_SyncLimit;
 	m_SyncCounter = 0;
 	m_GameTicks = 0;
 	m_CreationTime = GetTime( );
-	m_LastPingTime = GetTime( );
-	m_LastRefreshTime = GetTime( );
-	m_LastDownloadTicks = GetTime( );
+	m_GHost->m_Timers->ScheduleIn( &m_PingTimer, 5000 );
+	m_GHost->m_Timers->ScheduleIn( &m_RefreshTimer, 3000 );
+	m_GHost->m_Timers->ScheduleIn( &m_DownloadTimer, 0 );
 	m_DownloadCounter = 0;
-	m_LastDownloadCounterResetTicks = GetTicks( );
-	m_LastAnnounceTime = 0;
+	m_GHost->m_Timers->ScheduleIn( &m_DownloadCounterTimer, 1000 );
 	m_AnnounceInterval = 0;
-	m_LastAutoStartTime = GetTime( );
+	m_GHost->m_Timers->ScheduleIn( &m_AutoStartTimer, 10000 );
 	m_AutoStartPlayers = 0;
-	m_LastCountDownTicks = 0;
 	m_CountDownCounter = 0;
 	m_StartedLoadingTicks = 0;
 	m_StartPlayers = 0;
-	m_LastLagScreenResetTime = 0;
 	m_LastActionSentTicks = 0;
 	m_LastActionLateBy = 0;
+	m_ActionTickSent = false;
+	m_LastAdaptiveLatencyTicks = 0;
+	m_AdaptiveActions = 0;
+	m_AdaptiveLateActions = 0;
+	m_AdaptiveMaxSyncLag = 0;
+	m_AdaptiveLagScreens = 0;
 	m_StartedLaggingTime = 0;
 	m_LastLagScreenTime = 0;
 	m_LastReservedSeen = GetTime( );
-	m_StartedKickVoteTime = 0;
 	m_GameOverTime = 0;
 	m_LastPlayerLeaveTicks = 0;
 	m_MinimumScore = 0.0;
@@ -130,9 +138,14 @@ CBaseGame :: CBaseGame( CGHost *nGHost, CMap *nMap, CSaveGame *nSaveGame, uint16
 	m_GameLoaded = false;
 	m_LoadInGame = m_Map->GetMapLoadInGame( );
 	m_Lagging = false;
+	m_AdaptiveLatency = m_GHost->m_AdaptiveLatency;
+	m_LANGameInfoHostCounter = 0;
+	memset( m_PlayersByPID, 0, sizeof( m_PlayersByPID ) );
+	memset( m_SIDByPID, 255, sizeof( m_SIDByPID ) );
+	memset( m_SIDByColour, 255, sizeof( m_SIDByColour ) );
 	m_AutoSave = m_GHost->m_AutoSave;
 	m_MatchMaking = false;
-    m_LastGameUpdateTime = GetTime();
+	m_GHost->m_Timers->ScheduleIn( &m_GameUpdateTimer, 3000 );
 
 	if( m_SaveGame )
 	{
@@ -224,38 +237,30 @@ CBaseGame :: ~CBaseGame( )
 		char Time[17];
 		memset( Time, 0, sizeof( char ) * 17 );
 		strftime( Time, sizeof( char ) * 17, "%Y-%m-%d %H-%M", localtime( &Now ) );
-		string MinString = UTIL_ToString( ( m_GameTicks / 1000 ) / 60 );
-		string SecString = UTIL_ToString( ( m_GameTicks / 1000 ) % 60 );
-
-		if( MinString.size( ) == 1 )
-			MinString.insert( 0, "0" );
-
-		if( SecString.size( ) == 1 )
-			SecString.insert( 0, "0" );
-
 		m_Replay->BuildReplay( m_GameName, m_StatString, m_GHost->m_ReplayWar3Version, m_GHost->m_ReplayBuildNumber );
-		m_Replay->Save( m_GHost->m_TFT, m_GHost->m_ReplayPath + UTIL_FileSafeName( "GHost++ " + string( Time ) + " " + m_GameName + " (" + MinString + "m" + SecString + "s).w3g" ) );
+		m_Replay->Save( m_GHost->m_TFT, m_GHost->m_ReplayPath + UTIL_FileSafeName( "GHost++ " + string( Time ) + " " + m_GameName + " (" + UTIL_MSToString( m_GameTicks ) + ").w3g" ) );
 	}
 
 	delete m_Socket;
 	delete m_Protocol;
 	delete m_Map;
 	delete m_Replay;
+	delete m_Metrics;
+	delete m_CheckSumLog;
 
 	for( vector<CPotentialPlayer *> :: iterator i = m_Potentials.begin( ); i != m_Potentials.end( ); i++ )
 		delete *i;
 
 	for( vector<CGamePlayer *> :: iterator i = m_Players.begin( ); i != m_Players.end( ); i++ )
+	{
+		if( (*i)->GetPlayerId( ) == 0 )
+			m_GHost->m_PlayerIdCache->Release( (*i)->GetName( ) );
+
 		delete *i;
+	}
 
 	for( vector<CCallableScoreCheck *> :: iterator i = m_ScoreChecks.begin( ); i != m_ScoreChecks.end( ); i++ )
 		m_GHost->m_Callables.push_back( *i );
-        
-	for( vector<CCallableGetPlayerId *> :: iterator i = m_PairedGetPlayerIds.begin( ); i != m_PairedGetPlayerIds.end( ); i++ )
-		m_GHost->m_Callables.push_back( *i );
-
-	for( vector<CCallableCreatePlayerId *> :: iterator i = m_PairedCreatePlayerIds.begin( ); i != m_PairedCreatePlayerIds.end( ); i++ )
-		m_GHost->m_Callables.push_back( *i );
 
     for( vector<PairedGameUpdate> :: iterator i = m_GameUpdates.begin( ); i != m_GameUpdates.end( ); ++i )
         m_GHost->m_Callables.push_back( i->second );
@@ -267,22 +272,35 @@ CBaseGame :: ~CBaseGame( )
 	}
 }
 
-uint32_t CBaseGame :: GetNextTimedActionTicks( )
+uint64_t CBaseGame :: GetNextTimedActionMicroTicks( )
 {
-	// return the number of ticks (ms) until the next "timed action", which for our purposes is the next game update
+	// return the number of microseconds until the next "timed action", which for our purposes is the next game update
 	// the main GHost++ loop will make sure the next loop update happens at or before this value
 	// note: there's no reason this function couldn't take into account the game's other timers too but they're far less critical
 	// warning: this function must take into account when actions are not being sent (e.g. during loading or lagging)
 
 	if( !m_GameLoaded || m_Lagging )
-		return 50;
+		return 50000;
+
+	// the game updates as soon as GetTicks( ) - m_LastActionSentTicks reaches m_Latency - m_LastActionLateBy
+	// on Linux GetTicks is just GetMicroTicks in milliseconds (both read CLOCK_MONOTONIC) so we know exactly when that millisecond starts
+	// elsewhere they read different clocks so we have to round down to a whole millisecond like we used to
+
+#if defined( WIN32 ) || defined( __APPLE__ )
+	uint32_t Ticks = GetTicks( );
+	uint32_t MicroTicksIntoTick = 0;
+#else
+	uint64_t MicroTicks = GetMicroTicks( );
+	uint32_t Ticks = (uint32_t)( MicroTicks / 1000 );
+	uint32_t MicroTicksIntoTick = (uint32_t)( MicroTicks % 1000 );
+#endif
 
-	uint32_t TicksSinceLastUpdate = GetTicks( ) - m_LastActionSentTicks;
+	uint32_t TicksSinceLastUpdate = Ticks - m_LastActionSentTicks;
 
-	if( TicksSinceLastUpdate > m_Latency - m_LastActionLateBy )
+	if( TicksSinceLastUpdate >= m_Latency - m_LastActionLateBy )
 		return 0;
 	else
-		return m_Latency - m_LastActionLateBy - TicksSinceLastUpdate;
+		return (uint64_t)( m_Latency - m_LastActionLateBy - TicksSinceLastUpdate ) * 1000 - MicroTicksIntoTick;
 }
 
 uint32_t CBaseGame :: GetSlotsOccupied( )
@@ -350,7 +368,7 @@ void CBaseGame :: SetAnnounce( uint32_t interval, string message )
 {
 	m_AnnounceInterval = interval;
 	m_AnnounceMessage = message;
-	m_LastAnnounceTime = GetTime( );
+	m_GHost->m_Timers->ScheduleIn( &m_AnnounceTimer, interval * 1000 );
 }
 
 unsigned int CBaseGame :: SetFD( void *fd, void *send_fd, int *nfds )
@@ -386,6 +404,11 @@ unsigned int CBaseGame :: SetFD( void *fd, void *send_fd, int *nfds )
 
 bool CBaseGame :: Update( void *fd, void *send_fd )
 {
+	CHistogramTimer UpdateTimer( &m_Metrics->m_UpdateMicroseconds );
+
+	// the periodic tasks below (pings, refreshes, map parts, etc...) are driven by timers in m_GHost->m_Timers which is advanced once per loop iteration
+	// they're scheduled relative to the clock cached by the wheel, only the action ticks still have to read the clock directly
+
 	// update callables
 
 	for( vector<CCallableScoreCheck *> :: iterator i = m_ScoreChecks.begin( ); i != m_ScoreChecks.end( ); )
@@ -408,50 +431,46 @@ bool CBaseGame :: Update( void *fd, void *send_fd )
 			i++;
 	}
 
-	for( vector<CCallableGetPlayerId *> :: iterator i = m_PairedGetPlayerIds.begin( ); i != m_PairedGetPlayerIds.end( ); )
+	// the player ids are looked up (and created) by the player id cache which is shared by every game
+	// every player without a player id is waiting for a request which was started when they joined and is released when they get one or leave
+	// we only have to check on those players and tell them what's happening
+
+	for( vector<CGamePlayer *> :: iterator i = m_Players.begin( ); i != m_Players.end( ); i++ )
 	{
-		if( (*i)->GetReady( ) )
-		{
-            CGamePlayer *player = GetPlayerFromName((*i)->GetUser(), true);
-            uint32_t id = (*i)->GetResult();
-            
-            if(id != 0){
-                SendChat(player, "Welcome back " + player->GetName() + "! Enjoy your stay and good luck for your game :-)");
-                player->SetPlayerId( id );
-            } else {
-                SendChat(player, "Hey you are new here! Please stand by, we shortly create an unique identifier for your.");
-                m_PairedCreatePlayerIds.push_back(m_GHost->m_DB->ThreadedCreatePlayerId(player->GetName(), player->GetExternalIPString(), player->GetSpoofedRealm()));
-            }
+		if( (*i)->GetPlayerId( ) != 0 || (*i)->GetDeleteMe( ) )
+			continue;
 
-			m_GHost->m_DB->RecoverCallable( *i );
-			delete *i;
-			i = m_PairedGetPlayerIds.erase( i );
-		}
-		else
-			i++;
-	}
+		uint32_t PlayerId = 0;
+		uint32_t State = m_GHost->m_PlayerIdCache->GetState( (*i)->GetName( ), &PlayerId );
+		uint32_t OldState = (*i)->GetPlayerIdState( );
 
-	for( vector<CCallableCreatePlayerId *> :: iterator i = m_PairedCreatePlayerIds.begin( ); i != m_PairedCreatePlayerIds.end( ); )
-	{
-		if( (*i)->GetReady( ) )
+		if( State == OldState )
+			continue;
+
+		// once the player has been told that we're retrying every retry starts with a lookup (and maybe a creation) again
+		// don't repeat the messages for those, the player only hears from us again when it succeeds or fails in a different way
+
+		if( ( OldState == PLAYERID_RETRYLOOKUP || OldState == PLAYERID_RETRYCREATE ) && ( State == PLAYERID_LOOKUP || State == PLAYERID_CREATING ) )
+			continue;
+
+		if( State == PLAYERID_FOUND )
 		{
-            CGamePlayer *player = GetPlayerFromName((*i)->GetUser(), true);
-            uint32_t id = (*i)->GetResult();
-            
-            if(id != 0) {
-                SendChat(player, "We have created your unique identifier: " + UTIL_ToString(id));
-                player->SetPlayerId(id);
-            } else {
-                SendChat(player, "We are sorry, there was an error creating your unique identifier. Retrying...");
-                m_PairedCreatePlayerIds.push_back(m_GHost->m_DB->ThreadedCreatePlayerId(player->GetName(), player->GetExternalIPString(), player->GetSpoofedRealm()));
-            }
+			if( OldState == PLAYERID_CREATING || OldState == PLAYERID_RETRYCREATE )
+				SendChat( *i, "We have created your unique identifier: " + UTIL_ToString( PlayerId ) );
+			else
+				SendChat( *i, "Welcome back " + (*i)->GetName( ) + "! Enjoy your stay and good luck for your game :-)" );
 
-			m_GHost->m_DB->RecoverCallable( *i );
-			delete *i;
-			i = m_PairedCreatePlayerIds.erase( i );
+			(*i)->SetPlayerId( PlayerId );
+			m_GHost->m_PlayerIdCache->Release( (*i)->GetName( ) );
 		}
-		else
-			i++;
+		else if( State == PLAYERID_CREATING )
+			SendChat( *i, "Hey you are new here! Please stand by, we shortly create an unique identifier for your." );
+		else if( State == PLAYERID_RETRYLOOKUP )
+			SendChat( *i, "We are sorry, there was an error looking up your unique identifier. Retrying..." );
+		else if( State == PLAYERID_RETRYCREATE )
+			SendChat( *i, "We are sorry, there was an error creating your unique identifier. Retrying..." );
+
+		(*i)->SetPlayerIdState( State );
 	}
     
     
@@ -472,6 +491,7 @@ bool CBaseGame :: Update( void *fd, void *send_fd )
 		if( (*i)->Update( fd ) )
 		{
 			EventPlayerDeleted( *i );
+			UnindexPlayer( *i );
 			delete *i;
 			i = m_Players.erase( i );
 		}
@@ -512,7 +532,7 @@ bool CBaseGame :: Update( void *fd, void *send_fd )
 	// changed this to ping during game loading as well to hopefully fix some problems with people disconnecting during loading
 	// changed this to ping during the game as well
 
-	if( GetTime( ) - m_LastPingTime >= 5 )
+	if( m_PingTimer.GetDue( ) )
 	{
 		// note: we must send pings to players who are downloading the map because Warcraft III disconnects from the lobby if it doesn't receive a ping every ~90 seconds
 		// so if the player takes longer than 90 seconds to download the map they would be disconnected unless we keep sending pings
@@ -536,7 +556,11 @@ bool CBaseGame :: Update( void *fd, void *send_fd )
 
 			uint32_t FixedHostCounter = m_HostCounter & 0x0FFFFFFF;
 
-			if( m_SaveGame )
+			// the broadcast is identical every time except for the time since creation so we only build it once per host counter (i.e. once per game and rehost)
+
+			if( !m_LANGameInfo.empty( ) && m_LANGameInfoHostCounter == m_HostCounter )
+				m_Protocol->SetW3GS_GAMEINFOUpTime( m_LANGameInfo, GetTime( ) - m_CreationTime );
+			else if( m_SaveGame )
 			{
 				// note: the PrivateGame flag is not set when broadcasting to LAN (as you might expect)
 
@@ -547,7 +571,8 @@ bool CBaseGame :: Update( void *fd, void *send_fd )
 				BYTEARRAY MapHeight;
 				MapHeight.push_back( 0 );
 				MapHeight.push_back( 0 );
-				m_GHost->m_UDPSocket->Broadcast( 6112, m_Protocol->SEND_W3GS_GAMEINFO( m_GHost->m_TFT, m_GHost->m_LANWar3Version, UTIL_CreateByteArray( MapGameType, false ), m_Map->GetMapGameFlags( ), MapWidth, MapHeight, m_GameName, "Varlock", GetTime( ) - m_CreationTime, "Save\\Multiplayer\\" + m_SaveGame->GetFileNameNoPath( ), m_SaveGame->GetMagicNumber( ), 12, 12, m_HostPort, FixedHostCounter ) );
+				m_LANGameInfo = m_Protocol->SEND_W3GS_GAMEINFO( m_GHost->m_TFT, m_GHost->m_LANWar3Version, UTIL_CreateByteArray( MapGameType, false ), m_Map->GetMapGameFlags( ), MapWidth, MapHeight, m_GameName, "Varlock", GetTime( ) - m_CreationTime, "Save\\Multiplayer\\" + m_SaveGame->GetFileNameNoPath( ), m_SaveGame->GetMagicNumber( ), 12, 12, m_HostPort, FixedHostCounter );
+				m_LANGameInfoHostCounter = m_HostCounter;
 			}
 			else
 			{
@@ -555,11 +580,14 @@ bool CBaseGame :: Update( void *fd, void *send_fd )
 				// note: we do not use m_Map->GetMapGameType because none of the filters are set when broadcasting to LAN (also as you might expect)
 
 				uint32_t MapGameType = MAPGAMETYPE_UNKNOWN0;
-				m_GHost->m_UDPSocket->Broadcast( 6112, m_Protocol->SEND_W3GS_GAMEINFO( m_GHost->m_TFT, m_GHost->m_LANWar3Version, UTIL_CreateByteArray( MapGameType, false ), m_Map->GetMapGameFlags( ), m_Map->GetMapWidth( ), m_Map->GetMapHeight( ), m_GameName, "Varlock", GetTime( ) - m_CreationTime, m_GHost->m_MapPath + "/" + m_Map->GetMapLocalPath( ), m_Map->GetMapCRC( ), 12, 12, m_HostPort, FixedHostCounter ) );
+				m_LANGameInfo = m_Protocol->SEND_W3GS_GAMEINFO( m_GHost->m_TFT, m_GHost->m_LANWar3Version, UTIL_CreateByteArray( MapGameType, false ), m_Map->GetMapGameFlags( ), m_Map->GetMapWidth( ), m_Map->GetMapHeight( ), m_GameName, "Varlock", GetTime( ) - m_CreationTime, m_GHost->m_MapPath + "/" + m_Map->GetMapLocalPath( ), m_Map->GetMapCRC( ), 12, 12, m_HostPort, FixedHostCounter );
+				m_LANGameInfoHostCounter = m_HostCounter;
 			}
+
+			m_GHost->m_UDPSocket->Broadcast( 6112, m_LANGameInfo );
 		}
 
-		m_LastPingTime = GetTime( );
+		m_GHost->m_Timers->ScheduleIn( &m_PingTimer, 5000 );
 	}
 
 	// auto rehost if there was a refresh error in autohosted games
@@ -587,13 +615,13 @@ bool CBaseGame :: Update( void *fd, void *send_fd )
 		}
 
 		m_CreationTime = GetTime( );
-		m_LastRefreshTime = GetTime( );
+		m_GHost->m_Timers->ScheduleIn( &m_RefreshTimer, 3000 );
 		DoGameUpdate(false);
 	}
 
 	// refresh every 3 seconds
 
-	if( !m_RefreshError && !m_CountDownStarted && m_GameState == GAME_PUBLIC && GetSlotsOpen( ) > 0 && GetTime( ) - m_LastRefreshTime >= 3 )
+	if( !m_RefreshError && !m_CountDownStarted && m_GameState == GAME_PUBLIC && GetSlotsOpen( ) > 0 && m_RefreshTimer.GetDue( ) )
 	{
 		// send a game refresh packet to each battle.net connection
 
@@ -601,7 +629,8 @@ bool CBaseGame :: Update( void *fd, void *send_fd )
 
 		for( vector<CBNET *> :: iterator i = m_GHost->m_BNETs.begin( ); i != m_GHost->m_BNETs.end( ); i++ )
 		{
-			// don't queue a game refresh message if the queue contains more than 1 packet because they're very low priority
+			// don't queue a game refresh message if the queue contains more than 1 packet
+			// refreshes are sent before chat once queued so this keeps them from using up the whole flood control budget while chat is waiting
 
 			if( (*i)->GetOutPacketsQueued( ) <= 1 )
 			{
@@ -615,12 +644,12 @@ bool CBaseGame :: Update( void *fd, void *send_fd )
 		if( m_RefreshMessages && Refreshed )
 			SendAllChat( m_GHost->m_Language->GameRefreshed( ) );
 
-		m_LastRefreshTime = GetTime( );
+		m_GHost->m_Timers->ScheduleIn( &m_RefreshTimer, 3000 );
 	}
 
 	// send more map data
 
-	if( !m_GameLoading && !m_GameLoaded && GetTicks( ) - m_LastDownloadCounterResetTicks >= 1000 )
+	if( !m_GameLoading && !m_GameLoaded && m_DownloadCounterTimer.GetDue( ) )
 	{
 		// hackhack: another timer hijack is in progress here
 		// since the download counter is reset once per second it's a great place to update the slot info if necessary
@@ -629,10 +658,10 @@ bool CBaseGame :: Update( void *fd, void *send_fd )
 			SendAllSlotInfo( );
 
 		m_DownloadCounter = 0;
-		m_LastDownloadCounterResetTicks = GetTicks( );
+		m_GHost->m_Timers->ScheduleIn( &m_DownloadCounterTimer, 1000 );
 	}
 
-	if( !m_GameLoading && !m_GameLoaded && GetTicks( ) - m_LastDownloadTicks >= 100 )
+	if( !m_GameLoading && !m_GameLoaded && m_DownloadTimer.GetDue( ) )
 	{
 		uint32_t Downloaders = 0;
 
@@ -650,9 +679,9 @@ bool CBaseGame :: Update( void *fd, void *send_fd )
 				// this is because we would have to wait the round trip time (the ping time) between sending every 1442 bytes of map data
 				// doing it this way allows us to send at least 140 KB in each round trip interval which is much more reasonable
 				// the theoretical throughput is [140 KB * 1000 / ping] in KB/sec so someone with 100 ping (round trip ping, not LC ping) could download at 1400 KB/sec
-				// note: this creates a queue of map data which clogs up the connection when the client is on a slower connection (e.g. dialup)
-				// in this case any changes to the lobby are delayed by the amount of time it takes to send the queued data (i.e. 140 KB, which could be 30 seconds or more)
-				// for example, players joining and leaving, slot changes, chat messages would all appear to happen much later for the low bandwidth player
+				// note: this used to create a queue of map data which clogged up the connection when the client was on a slower connection (e.g. dialup)
+				// so now map data is queued behind everything else on the socket and we only generate more while fewer than bot_maxsendqueue bytes are waiting to be sent
+				// this keeps the amount of memory used per player bounded and any changes to the lobby are only delayed by the data the operating system has already accepted
 				// note: the throughput is also limited by the number of times this code is executed each second
 				// e.g. if we send the maximum amount (140 KB) 10 times per second the theoretical throughput is 1400 KB/sec
 				// therefore the maximum throughput is 1400 KB/sec regardless of ping and this value slowly diminishes as the player's ping increases
@@ -660,6 +689,7 @@ bool CBaseGame :: Update( void *fd, void *send_fd )
 				// in summary: the actual throughput is MIN( 140 * 1000 / ping, 1400, bot_maxdownloadspeed ) in KB/sec assuming only one player is downloading the map
 
 				uint32_t MapSize = UTIL_ByteArrayToUInt32( m_Map->GetMapSize( ), false );
+				uint32_t Queued = (*i)->GetSocket( ) ? (*i)->GetSocket( )->GetSendBufferSize( ) + (*i)->GetSocket( )->GetKernelSendBufferSize( ) : 0;
 
 				while( (*i)->GetLastMapPartSent( ) < (*i)->GetLastMapPartAcked( ) + 1442 * 100 && (*i)->GetLastMapPartSent( ) < MapSize )
 				{
@@ -677,22 +707,29 @@ bool CBaseGame :: Update( void *fd, void *send_fd )
 					if( m_GHost->m_MaxDownloadSpeed > 0 && m_DownloadCounter > m_GHost->m_MaxDownloadSpeed * 1024 )
 						break;
 
-					Send( *i, m_Protocol->SEND_W3GS_MAPPART( GetHostPID( ), (*i)->GetPID( ), (*i)->GetLastMapPartSent( ), m_Map->GetMapData( ) ) );
+					// don't queue more map data if the player hasn't received what we've already sent yet
+
+					if( Queued >= m_GHost->m_MaxSendQueue )
+						break;
+
+					BYTEARRAY MapPart = m_Protocol->SEND_W3GS_MAPPART( GetHostPID( ), (*i)->GetPID( ), (*i)->GetLastMapPartSent( ), m_Map->GetMapData( ) );
+					Queued += MapPart.size( );
+					Send( *i, MapPart );
 					(*i)->SetLastMapPartSent( (*i)->GetLastMapPartSent( ) + 1442 );
 					m_DownloadCounter += 1442;
 				}
 			}
 		}
 
-		m_LastDownloadTicks = GetTicks( );
+		m_GHost->m_Timers->ScheduleIn( &m_DownloadTimer, 100 );
 	}
 
 	// announce every m_AnnounceInterval seconds
 
-	if( !m_AnnounceMessage.empty( ) && !m_CountDownStarted && GetTime( ) - m_LastAnnounceTime >= m_AnnounceInterval )
+	if( !m_AnnounceMessage.empty( ) && !m_CountDownStarted && m_AnnounceTimer.GetDue( ) )
 	{
 		SendAllChat( m_AnnounceMessage );
-		m_LastAnnounceTime = GetTime( );
+		m_GHost->m_Timers->ScheduleIn( &m_AnnounceTimer, m_AnnounceInterval * 1000 );
 	}
 
 	// kick players who don't spoof check within 20 seconds when spoof checks are required and the game is autohosted
@@ -713,15 +750,15 @@ bool CBaseGame :: Update( void *fd, void *send_fd )
 
 	// try to auto start every 10 seconds
 
-	if( !m_CountDownStarted && m_AutoStartPlayers != 0 && GetTime( ) - m_LastAutoStartTime >= 10 )
+	if( !m_CountDownStarted && m_AutoStartPlayers != 0 && m_AutoStartTimer.GetDue( ) )
 	{
 		StartCountDownAuto( m_GHost->m_RequireSpoofChecks );
-		m_LastAutoStartTime = GetTime( );
+		m_GHost->m_Timers->ScheduleIn( &m_AutoStartTimer, 10000 );
 	}
 
 	// countdown every 500 ms
 
-	if( m_CountDownStarted && GetTicks( ) - m_LastCountDownTicks >= 500 )
+	if( m_CountDownStarted && m_CountDownTimer.GetDue( ) )
 	{
 		if( m_CountDownCounter > 0 )
 		{
@@ -735,7 +772,7 @@ bool CBaseGame :: Update( void *fd, void *send_fd )
 		else if( !m_GameLoading && !m_GameLoaded )
 			EventGameStarted( );
 
-		m_LastCountDownTicks = GetTicks( );
+		m_GHost->m_Timers->ScheduleIn( &m_CountDownTimer, 500 );
 	}
 
 	// check if the lobby is "abandoned" and needs to be closed since it will never start
@@ -781,13 +818,22 @@ bool CBaseGame :: Update( void *fd, void *send_fd )
 			m_LastActionSentTicks = GetTicks( );
 			m_GameLoading = false;
 			m_GameLoaded = true;
+
+			// start the first adaptive latency period now rather than when the game was created
+			// otherwise the first adjustment would happen immediately and be based on whatever happened while loading
+
+			m_LastAdaptiveLatencyTicks = GetTicks( );
+			m_AdaptiveActions = 0;
+			m_AdaptiveLateActions = 0;
+			m_AdaptiveMaxSyncLag = 0;
+			m_AdaptiveLagScreens = 0;
 			EventGameLoaded( );
 		}
 		else
 		{
 			// reset the "lag" screen (the load-in-game screen) every 30 seconds
 
-			if( m_LoadInGame && GetTime( ) - m_LastLagScreenResetTime >= 30 )
+			if( m_LoadInGame && m_LagScreenResetTimer.GetDue( ) )
 			{
 				bool UsingGProxy = false;
 
@@ -868,7 +914,7 @@ bool CBaseGame :: Update( void *fd, void *send_fd )
 					m_SyncCounter += m_GProxyEmptyActions;
 
 				m_SyncCounter++; */
-				m_LastLagScreenResetTime = GetTime( );
+				m_GHost->m_Timers->ScheduleIn( &m_LagScreenResetTimer, 30000 );
 			}
 		}
 	}
@@ -905,7 +951,8 @@ bool CBaseGame :: Update( void *fd, void *send_fd )
 			{
 				// start the lag screen
 
-				CONSOLE_Print( "[GAME: " + m_GameName + "] started lagging on [" + LaggingString + "]" );
+				LOG_Print( LOG_DEBUG, "[GAME: " + m_GameName + "] started lagging on [" + LaggingString + "]" );
+				m_AdaptiveLagScreens++;
 				SendAll( m_Protocol->SEND_W3GS_START_LAG( m_Players ) );
 
 				// reset everyone's drop vote
@@ -913,7 +960,7 @@ bool CBaseGame :: Update( void *fd, void *send_fd )
 				for( vector<CGamePlayer *> :: iterator i = m_Players.begin( ); i != m_Players.end( ); i++ )
 					(*i)->SetDropVote( false );
 
-				m_LastLagScreenResetTime = GetTime( );
+				m_GHost->m_Timers->ScheduleIn( &m_LagScreenResetTimer, 60000 );
 			}
 		}
 
@@ -940,7 +987,7 @@ bool CBaseGame :: Update( void *fd, void *send_fd )
 			// another solution is to reset the lag screen the same way we reset it when using load-in-game
 			// this is required in order to give GProxy++ clients more time to reconnect
 
-			if( GetTime( ) - m_LastLagScreenResetTime >= 60 )
+			if( m_LagScreenResetTimer.GetDue( ) )
 			{
 				for( vector<CGamePlayer *> :: iterator i = m_Players.begin( ); i != m_Players.end( ); i++ )
 				{
@@ -991,7 +1038,7 @@ bool CBaseGame :: Update( void *fd, void *send_fd )
 					m_SyncCounter += m_GProxyEmptyActions;
 
 				m_SyncCounter++; */
-				m_LastLagScreenResetTime = GetTime( );
+				m_GHost->m_Timers->ScheduleIn( &m_LagScreenResetTimer, 60000 );
 			}
 
 			// check if anyone has stopped lagging normally
@@ -1003,7 +1050,7 @@ bool CBaseGame :: Update( void *fd, void *send_fd )
 				{
 					// stop the lag screen for this player
 
-					CONSOLE_Print( "[GAME: " + m_GameName + "] stopped lagging on [" + (*i)->GetName( ) + "]" );
+					LOG_Print( LOG_DEBUG, "[GAME: " + m_GameName + "] stopped lagging on [" + (*i)->GetName( ) + "]" );
 					SendAll( m_Protocol->SEND_W3GS_STOP_LAG( *i ) );
 					(*i)->SetLagging( false );
 					(*i)->SetStartedLaggingTicks( 0 );
@@ -1039,14 +1086,19 @@ bool CBaseGame :: Update( void *fd, void *send_fd )
 	if( m_GameLoaded && !m_Lagging && GetTicks( ) - m_LastActionSentTicks >= m_Latency - m_LastActionLateBy )
 		SendAllActions( );
 
+	// adjust the latency every 5 seconds
+
+	if( m_AdaptiveLatency && m_GameLoaded && GetTicks( ) - m_LastAdaptiveLatencyTicks >= 5000 )
+		UpdateAdaptiveLatency( );
+
 	// expire the votekick
 
-	if( !m_KickVotePlayer.empty( ) && GetTime( ) - m_StartedKickVoteTime >= 60 )
+	if( !m_KickVotePlayer.empty( ) && m_KickVoteTimer.GetDue( ) )
 	{
 		CONSOLE_Print( "[GAME: " + m_GameName + "] votekick against player [" + m_KickVotePlayer + "] expired" );
 		SendAllChat( m_GHost->m_Language->VoteKickExpired( m_KickVotePlayer ) );
 		m_KickVotePlayer.clear( );
-		m_StartedKickVoteTime = 0;
+		m_KickVoteTimer.Cancel( );
 	}
 
 	// start the gameover timer if there's only one player left
@@ -1055,18 +1107,19 @@ bool CBaseGame :: Update( void *fd, void *send_fd )
 	{
 		CONSOLE_Print( "[GAME: " + m_GameName + "] gameover timer started (one player left)" );
 		m_GameOverTime = GetTime( );
+		m_GHost->m_Timers->ScheduleIn( &m_GameOverTimer, 60000 );
 	}
     
     // game update if needed based on interval
 
-	if (GetTime() - m_LastGameUpdateTime > 3)
+	if( m_GameUpdateTimer.GetDue( ) )
 	{
 		DoGameUpdate(false);
 	}
 
 	// finish the gameover timer
 
-	if( m_GameOverTime != 0 && GetTime( ) - m_GameOverTime >= 60 )
+	if( m_GameOverTime != 0 && m_GameOverTimer.GetDue( ) )
 	{
 		bool AlreadyStopped = true;
 
@@ -1135,12 +1188,19 @@ void CBaseGame :: UpdatePost( void *send_fd )
 {
 	// we need to manually call DoSend on each player now because CGamePlayer :: Update doesn't do it
 	// this is in case player 2 generates a packet for player 1 during the update but it doesn't get sent because player 1 already finished updating
-	// in reality since we're queueing actions it might not make a big difference but oh well
+	// while the game is running smoothly everything else we send to the players (chat, GProxy++ acks, etc...) waits for the next action packet
+	// this way each player gets one send call (and usually one TCP segment) per action tick no matter how many packets were queued in between
+	// the lobby, the loading screen and the lag screen don't have a steady tick so we flush on every update there
 
-	for( vector<CGamePlayer *> :: iterator i = m_Players.begin( ); i != m_Players.end( ); i++ )
+	if( !m_GameLoaded || m_Lagging || m_ActionTickSent )
 	{
-		if( (*i)->GetSocket( ) )
-			(*i)->GetSocket( )->DoSend( (fd_set *)send_fd );
+		for( vector<CGamePlayer *> :: iterator i = m_Players.begin( ); i != m_Players.end( ); i++ )
+		{
+			if( (*i)->GetSocket( ) )
+				(*i)->GetSocket( )->DoSend( (fd_set *)send_fd );
+		}
+
+		m_ActionTickSent = false;
 	}
 
 	for( vector<CPotentialPlayer *> :: iterator i = m_Potentials.begin( ); i != m_Potentials.end( ); i++ )
@@ -1169,8 +1229,12 @@ void CBaseGame :: Send( BYTEARRAY PIDs, BYTEARRAY data )
 
 void CBaseGame :: SendAll( BYTEARRAY data )
 {
+	// queue the same buffer on every socket instead of copying it for each player
+
+	SHAREDBYTEARRAY Packet( new BYTEARRAY( data ) );
+
 	for( vector<CGamePlayer *> :: iterator i = m_Players.begin( ); i != m_Players.end( ); i++ )
-		(*i)->Send( data );
+		(*i)->Send( Packet );
 }
 
 void CBaseGame :: SendChat( unsigned char fromPID, CGamePlayer *player, string message )
@@ -1395,9 +1459,16 @@ void CBaseGame :: SendAllActions( )
 	uint32_t ActualSendInterval = GetTicks( ) - m_LastActionSentTicks;
 	uint32_t ExpectedSendInterval = m_Latency - m_LastActionLateBy;
 	m_LastActionLateBy = ActualSendInterval - ExpectedSendInterval;
+	m_Metrics->m_ActionsSent.Add( );
+	m_AdaptiveActions++;
+
+	if( m_LastActionLateBy > m_Latency / 4 )
+		m_AdaptiveLateActions++;
 
 	if( m_LastActionLateBy > m_Latency )
 	{
+		m_Metrics->m_ActionsLate.Add( );
+
 		// something is going terribly wrong - GHost++ is probably starved of resources
 		// print a message because even though this will take more resources it should provide some information to the administrator for future reference
 		// other solutions - dynamically modify the latency, request higher priority, terminate other games, ???
@@ -1406,7 +1477,71 @@ void CBaseGame :: SendAllActions( )
 		m_LastActionLateBy = m_Latency;
 	}
 
+	// record the clamped value so a single stall (or an early send wrapping around) doesn't land in a bucket far outside the normal range
+
+	m_Metrics->m_ActionLateByMilliseconds.Record( m_LastActionLateBy );
 	m_LastActionSentTicks = GetTicks( );
+	m_ActionTickSent = true;
+}
+
+void CBaseGame :: UpdateAdaptiveLatency( )
+{
+	// adjust the latency based on what happened since the last adjustment
+	// the latency is raised quickly when we're sending action packets late (the bot is starved of CPU) or players are falling behind (high ping)
+	// it's lowered slowly when everything went smoothly, but never below what the worst ping needs to stay ahead of the sync limit
+
+	uint32_t MinLatency = m_GHost->m_MinLatency;
+	uint32_t MaxLatency = m_GHost->m_MaxLatency;
+
+	if( MaxLatency < MinLatency )
+		MaxLatency = MinLatency;
+
+	uint32_t MaxPing = 0;
+
+	for( vector<CGamePlayer *> :: iterator i = m_Players.begin( ); i != m_Players.end( ); i++ )
+	{
+		if( !(*i)->GetLeftMessageSent( ) && (*i)->GetNumPings( ) > 0 && (*i)->GetPing( false ) > MaxPing )
+			MaxPing = (*i)->GetPing( false );
+	}
+
+	// a player's keepalive for an action packet arrives about one round trip after we send it
+	// so the round trip must fit into half of the sync limit's worth of action packets or the player will lag whenever the ping spikes
+
+	uint32_t Floor = MinLatency;
+
+	if( m_SyncLimit > 0 && ( 2 * MaxPing ) / m_SyncLimit > Floor )
+		Floor = ( 2 * MaxPing ) / m_SyncLimit;
+
+	if( Floor > MaxLatency )
+		Floor = MaxLatency;
+
+	uint32_t Latency = m_Latency;
+
+	if( ( m_AdaptiveActions > 0 && m_AdaptiveLateActions * 10 > m_AdaptiveActions ) || m_AdaptiveLagScreens > 0 || m_AdaptiveMaxSyncLag > m_SyncLimit / 4 )
+		Latency = m_Latency + max( m_Latency / 4, (uint32_t)5 );
+	else if( m_AdaptiveActions > 0 && m_AdaptiveLateActions == 0 && m_AdaptiveMaxSyncLag <= m_SyncLimit / 8 && m_Latency > Floor )
+		Latency = m_Latency - max( m_Latency / 10, (uint32_t)5 );
+
+	if( Latency < Floor )
+		Latency = Floor;
+
+	if( Latency > MaxLatency )
+		Latency = MaxLatency;
+
+	if( Latency != m_Latency )
+	{
+		CONSOLE_Print( "[GAME: " + m_GameName + "] adaptive latency changed from " + UTIL_ToString( m_Latency ) + "ms to " + UTIL_ToString( Latency ) + "ms (" + UTIL_ToString( m_AdaptiveLateActions ) + "/" + UTIL_ToString( m_AdaptiveActions ) + " late, " + UTIL_ToString( m_AdaptiveLagScreens ) + " lag screens, max sync lag " + UTIL_ToString( m_AdaptiveMaxSyncLag ) + ", max ping " + UTIL_ToString( MaxPing ) + "ms)" );
+		m_Latency = Latency;
+
+		if( m_LastActionLateBy > m_Latency )
+			m_LastActionLateBy = m_Latency;
+	}
+
+	m_LastAdaptiveLatencyTicks = GetTicks( );
+	m_AdaptiveActions = 0;
+	m_AdaptiveLateActions = 0;
+	m_AdaptiveMaxSyncLag = 0;
+	m_AdaptiveLagScreens = 0;
 }
 
 void CBaseGame :: SendWelcomeMessage( CGamePlayer *player )
@@ -1431,26 +1566,26 @@ void CBaseGame :: EventPlayerDeleted( CGamePlayer *player )
 
 	// remove any queued spoofcheck messages for this player
 
-	if( player->GetWhoisSent( ) && !player->GetJoinedRealm( ).empty( ) && player->GetSpoofedRealm( ).empty( ) )
+	if( player->GetWhoisSent( ) && player->GetWhoisHandle( ) != 0 && !player->GetJoinedRealm( ).empty( ) && player->GetSpoofedRealm( ).empty( ) )
 	{
 		for( vector<CBNET *> :: iterator i = m_GHost->m_BNETs.begin( ); i != m_GHost->m_BNETs.end( ); i++ )
 		{
-			if( (*i)->GetServer( ) == player->GetJoinedRealm( ) )
-			{
-				// hackhack: there must be a better way to do this
-
-				if( (*i)->GetPasswordHashType( ) == "pvpgn" )
-					(*i)->UnqueueChatCommand( "/whereis " + player->GetName( ) );
-				else
-					(*i)->UnqueueChatCommand( "/whois " + player->GetName( ) );
-
-				(*i)->UnqueueChatCommand( "/w " + player->GetName( ) + " " + m_GHost->m_Language->SpoofCheckByReplying( ) );
-			}
+			if( (*i)->GetServer( ) == player->GetJoinedRealm( ) && (*i)->UnqueuePacket( player->GetWhoisHandle( ) ) )
+				CONSOLE_Print( "[BNET: " + (*i)->GetServerAlias( ) + "] unqueued spoof check for player [" + player->GetName( ) + "]" );
 		}
 	}
 
 	m_LastPlayerLeaveTicks = GetTicks( );
 
+	// stop waiting for the player's player id
+
+	if( player->GetPlayerId( ) == 0 )
+		m_GHost->m_PlayerIdCache->Release( player->GetName( ) );
+
+	// stop waiting for this player's checksums
+
+	m_CheckSumLog->RemovePlayer( player->GetPID( ) );
+
 	// in some cases we're forced to send the left message early so don't send it again
 
 	if( player->GetLeftMessageSent( ) )
@@ -1537,7 +1672,7 @@ void CBaseGame :: EventPlayerDeleted( CGamePlayer *player )
     player->SetLeftTime( m_GameTicks / 1000 );
         
 	m_KickVotePlayer.clear( );
-	m_StartedKickVoteTime = 0;
+	m_KickVoteTimer.Cancel( );
 }
 
 void CBaseGame :: EventPlayerDisconnectTimedOut( CGamePlayer *player )
@@ -1957,9 +2092,10 @@ void CBaseGame :: EventPlayerJoined( CPotentialPlayer *potential, CIncomingJoinP
 
 	CONSOLE_Print( "[GAME: " + m_GameName + "] player [" + joinPlayer->GetName( ) + "|" + potential->GetExternalIPString( ) + "] joined the game" );
 	CGamePlayer *Player = new CGamePlayer( potential, m_SaveGame ? EnforcePID : GetNewPID( ), JoinedRealm, joinPlayer->GetName( ), joinPlayer->GetInternalIP( ), Reserved );
+	Player->SetAdminLevel( m_GHost->GetAdminLevel( joinPlayer->GetName( ) ) );
+
+	m_GHost->m_PlayerIdCache->Request( Player->GetName( ), Player->GetExternalIPString( ), Player->GetSpoofedRealm( ) );
 
-    m_PairedGetPlayerIds.push_back(m_GHost->m_DB->ThreadedGetPlayerId(Player->GetName()));
-    
 	// consider LAN players to have already spoof checked since they can't
 	// since so many people have trouble with this feature we now use the JoinedRealm to determine LAN status
 
@@ -1968,6 +2104,7 @@ void CBaseGame :: EventPlayerJoined( CPotentialPlayer *potential, CIncomingJoinP
 
 	Player->SetWhoisShouldBeSent( m_GHost->m_SpoofChecks == 1 || ( m_GHost->m_SpoofChecks == 2 && AnyAdminCheck ) );
 	m_Players.push_back( Player );
+	IndexPlayer( Player );
 	potential->SetSocket( NULL );
 	potential->SetDeleteMe( true );
 
@@ -2366,6 +2503,9 @@ void CBaseGame :: EventPlayerJoinedWithScore( CPotentialPlayer *potential, CInco
 
 	CONSOLE_Print( "[GAME: " + m_GameName + "] player [" + joinPlayer->GetName( ) + "|" + potential->GetExternalIPString( ) + "] joined the game" );
 	CGamePlayer *Player = new CGamePlayer( potential, GetNewPID( ), JoinedRealm, joinPlayer->GetName( ), joinPlayer->GetInternalIP( ), false );
+	Player->SetAdminLevel( m_GHost->GetAdminLevel( joinPlayer->GetName( ) ) );
+
+	m_GHost->m_PlayerIdCache->Request( Player->GetName( ), Player->GetExternalIPString( ), Player->GetSpoofedRealm( ) );
 
 	// consider LAN players to have already spoof checked since they can't
 	// since so many people have trouble with this feature we now use the JoinedRealm to determine LAN status
@@ -2376,6 +2516,7 @@ void CBaseGame :: EventPlayerJoinedWithScore( CPotentialPlayer *potential, CInco
 	Player->SetWhoisShouldBeSent( m_GHost->m_SpoofChecks == 1 || ( m_GHost->m_SpoofChecks == 2 && AnyAdminCheck ) );
 	Player->SetScore( score );
 	m_Players.push_back( Player );
+	IndexPlayer( Player );
 	potential->SetSocket( NULL );
 	potential->SetDeleteMe( true );
 	m_Slots[SID] = CGameSlot( Player->GetPID( ), 255, SLOTSTATUS_OCCUPIED, 0, m_Slots[SID].GetTeam( ), m_Slots[SID].GetColour( ), m_Slots[SID].GetRace( ) );
@@ -2618,41 +2759,48 @@ void CBaseGame :: EventPlayerAction( CGamePlayer *player, CIncomingAction *actio
 
 void CBaseGame :: EventPlayerKeepAlive( CGamePlayer *player, uint32_t checkSum )
 {
-	// check for desyncs
-	// however, it's possible that not every player has sent a checksum for this frame yet
-	// first we verify that we have enough checksums to work with otherwise we won't know exactly who desynced
+	if( m_SyncCounter - player->GetSyncCounter( ) > m_AdaptiveMaxSyncLag )
+		m_AdaptiveMaxSyncLag = m_SyncCounter - player->GetSyncCounter( );
 
-	for( vector<CGamePlayer *> :: iterator i = m_Players.begin( ); i != m_Players.end( ); i++ )
-	{
-		if( !(*i)->GetDeleteMe( ) && (*i)->GetCheckSums( )->empty( ) )
-			return;
-	}
-
-	// now we check for desyncs since we know that every player has at least one checksum waiting
+	// check for desyncs
+	// the n-th keepalive carries the player's checksum for the n-th frame so we can only check a frame once every player has sent their checksum for it
+	// normally exactly one frame is completed by the last player's keepalive but a player leaving can complete several frames at once
 
-	bool FoundPlayer = false;
-	uint32_t FirstCheckSum = 0;
+	m_CheckSumLog->Add( player->GetPID( ), player->GetSyncCounter( ) - 1, checkSum );
+	uint32_t Frame;
 
-	for( vector<CGamePlayer *> :: iterator i = m_Players.begin( ); i != m_Players.end( ); i++ )
+	while( m_CheckSumLog->GetCompleteFrame( &Frame ) )
 	{
-		if( !(*i)->GetDeleteMe( ) )
+		bool FoundPlayer = false;
+		bool Desynced = false;
+		uint32_t FirstCheckSum = 0;
+		uint32_t CheckSum;
+
+		for( vector<CGamePlayer *> :: iterator i = m_Players.begin( ); i != m_Players.end( ); i++ )
 		{
-			FoundPlayer = true;
-			FirstCheckSum = (*i)->GetCheckSums( )->front( );
-			break;
+			if( !(*i)->GetDeleteMe( ) && m_CheckSumLog->GetCheckSum( Frame, (*i)->GetPID( ), &CheckSum ) )
+			{
+				if( !FoundPlayer )
+				{
+					FoundPlayer = true;
+					FirstCheckSum = CheckSum;
+				}
+				else if( CheckSum != FirstCheckSum )
+				{
+					Desynced = true;
+					break;
+				}
+			}
 		}
-	}
 
-	if( !FoundPlayer )
-		return;
+		if( !FoundPlayer )
+			continue;
 
-	bool AddToReplay = true;
+		bool AddToReplay = true;
 
-	for( vector<CGamePlayer *> :: iterator i = m_Players.begin( ); i != m_Players.end( ); i++ )
-	{
-		if( !(*i)->GetDeleteMe( ) && (*i)->GetCheckSums( )->front( ) != FirstCheckSum )
+		if( Desynced )
 		{
-			CONSOLE_Print( "[GAME: " + m_GameName + "] desync detected" );
+			CONSOLE_Print( "[GAME: " + m_GameName + "] desync detected at frame " + UTIL_ToString( Frame ) );
 			SendAllChat( m_GHost->m_Language->DesyncDetected( ) );
 
 			// try to figure out who desynced
@@ -2663,8 +2811,8 @@ void CBaseGame :: EventPlayerKeepAlive( CGamePlayer *player, uint32_t checkSum )
 
 			for( vector<CGamePlayer *> :: iterator j = m_Players.begin( ); j != m_Players.end( ); j++ )
 			{
-				if( !(*j)->GetDeleteMe( ) )
-					Bins[(*j)->GetCheckSums( )->front( )].push_back( (*j)->GetPID( ) );
+				if( !(*j)->GetDeleteMe( ) && m_CheckSumLog->GetCheckSum( Frame, (*j)->GetPID( ), &CheckSum ) )
+					Bins[CheckSum].push_back( (*j)->GetPID( ) );
 			}
 
 			uint32_t StateNumber = 1;
@@ -2702,6 +2850,22 @@ void CBaseGame :: EventPlayerKeepAlive( CGamePlayer *player, uint32_t checkSum )
 
 			FirstCheckSum = (*LargestBin).first;
 
+			// write the checksum log for post-mortem debugging
+			// it has the last few frames before the desync and whatever has arrived for the frames after it
+
+			if( !m_GHost->m_CheckSumLogPath.empty( ) )
+			{
+				time_t Now = time( NULL );
+				char Time[17];
+				memset( Time, 0, sizeof( char ) * 17 );
+				strftime( Time, sizeof( char ) * 17, "%Y-%m-%d %H-%M", localtime( &Now ) );
+				string File = m_GHost->m_CheckSumLogPath + UTIL_FileSafeName( "GHost++ " + string( Time ) + " " + m_GameName + " (desync at frame " + UTIL_ToString( Frame ) + ").txt" );
+				string Log = m_CheckSumLog->GetLog( );
+
+				if( UTIL_FileWrite( File, (unsigned char *)Log.c_str( ), Log.size( ) ) )
+					CONSOLE_Print( "[GAME: " + m_GameName + "] wrote checksum log to [" + File + "]" );
+			}
+
 			if( Tied )
 			{
 				// there is a tie, which is unfortunate
@@ -2742,23 +2906,13 @@ void CBaseGame :: EventPlayerKeepAlive( CGamePlayer *player, uint32_t checkSum )
 					}
 				}
 			}
-
-			// don't continue looking for desyncs, we already found one!
-
-			break;
 		}
-	}
 
-	for( vector<CGamePlayer *> :: iterator i = m_Players.begin( ); i != m_Players.end( ); i++ )
-	{
-		if( !(*i)->GetDeleteMe( ) )
-			(*i)->GetCheckSums( )->pop( );
-	}
-
-	// add checksum to replay
+		// add checksum to replay
 
-	/* if( m_Replay && AddToReplay )
-		m_Replay->AddCheckSum( FirstCheckSum ); */
+		/* if( m_Replay && AddToReplay )
+			m_Replay->AddCheckSum( FirstCheckSum ); */
+	}
 }
 
 void CBaseGame :: EventPlayerChatToHost( CGamePlayer *player, CIncomingChatPlayer *chatPlayer )
@@ -2774,14 +2928,10 @@ void CBaseGame :: EventPlayerChatToHost( CGamePlayer *player, CIncomingChatPlaye
 
 			// calculate timestamp
 
-			string MinString = UTIL_ToString( ( m_GameTicks / 1000 ) / 60 );
-			string SecString = UTIL_ToString( ( m_GameTicks / 1000 ) % 60 );
-
-			if( MinString.size( ) == 1 )
-				MinString.insert( 0, "0" );
-
-			if( SecString.size( ) == 1 )
-				SecString.insert( 0, "0" );
+			string Timestamp;
+			UTIL_AppendUInt( Timestamp, ( m_GameTicks / 1000 ) / 60, 2 );
+			Timestamp.push_back( ':' );
+			UTIL_AppendUInt( Timestamp, ( m_GameTicks / 1000 ) % 60, 2 );
 
 			if( !ExtraFlags.empty( ) )
 			{
@@ -2789,7 +2939,7 @@ void CBaseGame :: EventPlayerChatToHost( CGamePlayer *player, CIncomingChatPlaye
 				{
 					// this is an ingame [All] message, print it to the console
 
-					CONSOLE_Print( "[GAME: " + m_GameName + "] (" + MinString + ":" + SecString + ") [All] [" + player->GetName( ) + "]: " + chatPlayer->GetMessage( ) );
+					CONSOLE_Print( "[GAME: " + m_GameName + "] (" + Timestamp + ") [All] [" + player->GetName( ) + "]: " + chatPlayer->GetMessage( ) );
 
 					// don't relay ingame messages targeted for all players if we're currently muting all
 					// note that commands will still be processed even when muting all because we only stop relaying the messages, the rest of the function is unaffected
@@ -2801,7 +2951,7 @@ void CBaseGame :: EventPlayerChatToHost( CGamePlayer *player, CIncomingChatPlaye
 				{
 					// this is an ingame [Obs/Ref] message, print it to the console
 
-					CONSOLE_Print( "[GAME: " + m_GameName + "] (" + MinString + ":" + SecString + ") [Obs/Ref] [" + player->GetName( ) + "]: " + chatPlayer->GetMessage( ) );
+					CONSOLE_Print( "[GAME: " + m_GameName + "] (" + Timestamp + ") [Obs/Ref] [" + player->GetName( ) + "]: " + chatPlayer->GetMessage( ) );
 				}
 
 				if( Relay )
@@ -3064,7 +3214,7 @@ void CBaseGame :: EventPlayerMapSize( CGamePlayer *player, CIncomingMapSize *map
 					{
 						// inform the client that we are willing to send the map
 
-						CONSOLE_Print( "[GAME: " + m_GameName + "] map download started for player [" + player->GetName( ) + "]" );
+						LOG_Print( LOG_DEBUG, "[GAME: " + m_GameName + "] map download started for player [" + player->GetName( ) + "]" );
 						Send( player, m_Protocol->SEND_W3GS_STARTDOWNLOAD( GetHostPID( ) ) );
 						player->SetDownloadStarted( true );
 						player->SetStartedDownloadingTicks( GetTicks( ) );
@@ -3097,7 +3247,7 @@ void CBaseGame :: EventPlayerMapSize( CGamePlayer *player, CIncomingMapSize *map
 
 			float Seconds = (float)( GetTicks( ) - player->GetStartedDownloadingTicks( ) ) / 1000;
 			float Rate = (float)MapSize / 1024 / Seconds;
-			CONSOLE_Print( "[GAME: " + m_GameName + "] map download finished for player [" + player->GetName( ) + "] in " + UTIL_ToString( Seconds, 1 ) + " seconds" );
+			LOG_Print( LOG_DEBUG, "[GAME: " + m_GameName + "] map download finished for player [" + player->GetName( ) + "] in " + UTIL_ToString( Seconds, 1 ) + " seconds" );
 			SendAllChat( m_GHost->m_Language->PlayerDownloadedTheMap( player->GetName( ), UTIL_ToString( Seconds, 1 ), UTIL_ToString( Rate, 1 ) ) );
 			player->SetDownloadFinished( true );
 			player->SetFinishedDownloadingTime( GetTime( ) );
@@ -3234,7 +3384,7 @@ void CBaseGame :: EventGameStarted( )
 		SendAllSlotInfo( );
 
 	m_StartedLoadingTicks = GetTicks( );
-	m_LastLagScreenResetTime = GetTime( );
+	m_GHost->m_Timers->ScheduleIn( &m_LagScreenResetTimer, 30000 );
 	m_GameLoading = true;
 
 	// since we use a fake countdown to deal with leavers during countdown the COUNTDOWN_START and COUNTDOWN_END packets are sent in quick succession
@@ -3259,6 +3409,14 @@ void CBaseGame :: EventGameStarted( )
 
 	m_StartPlayers = GetNumHumanPlayers( );
 
+	// start tracking the checksums of every player who is loading the game
+
+	for( vector<CGamePlayer *> :: iterator i = m_Players.begin( ); i != m_Players.end( ); i++ )
+	{
+		if( !m_CheckSumLog->AddPlayer( (*i)->GetPID( ), (*i)->GetName( ) ) )
+			CONSOLE_Print( "[GAME: " + m_GameName + "] too many players, not checking player [" + (*i)->GetName( ) + "] for desyncs" );
+	}
+
 	// close the listening socket
 
 	delete m_Socket;
@@ -3401,10 +3559,21 @@ unsigned char CBaseGame :: GetSIDFromPID( unsigned char PID )
 	if( m_Slots.size( ) > 255 )
 		return 255;
 
+	// check the slot we found this PID in last time before searching every slot
+	// PID 0 is shared by every open, closed and computer slot so it always needs a full search
+
+	unsigned char SID = m_SIDByPID[PID];
+
+	if( PID != 0 && SID < m_Slots.size( ) && m_Slots[SID].GetPID( ) == PID )
+		return SID;
+
 	for( unsigned char i = 0; i < m_Slots.size( ); i++ )
 	{
 		if( m_Slots[i].GetPID( ) == PID )
+		{
+			m_SIDByPID[PID] = i;
 			return i;
+		}
 	}
 
 	return 255;
@@ -3412,11 +3581,13 @@ unsigned char CBaseGame :: GetSIDFromPID( unsigned char PID )
 
 CGamePlayer *CBaseGame :: GetPlayerFromPID( unsigned char PID )
 {
-	for( vector<CGamePlayer *> :: iterator i = m_Players.begin( ); i != m_Players.end( ); i++ )
-	{
-		if( !(*i)->GetLeftMessageSent( ) && (*i)->GetPID( ) == PID )
-			return *i;
-	}
+	// a player who was kicked stays in m_Players until they are deleted but we must ignore them
+	// note: their PID (and name) might already be used by a new player in which case the index points to the new player
+
+	CGamePlayer *Player = m_PlayersByPID[PID];
+
+	if( Player && !Player->GetLeftMessageSent( ) )
+		return Player;
 
 	return NULL;
 }
@@ -3431,22 +3602,12 @@ CGamePlayer *CBaseGame :: GetPlayerFromSID( unsigned char SID )
 
 CGamePlayer *CBaseGame :: GetPlayerFromName( string name, bool sensitive )
 {
-	if( !sensitive )
-		transform( name.begin( ), name.end( ), name.begin( ), (int(*)(int))tolower );
-
-	for( vector<CGamePlayer *> :: iterator i = m_Players.begin( ); i != m_Players.end( ); i++ )
-	{
-		if( !(*i)->GetLeftMessageSent( ) )
-		{
-			string TestName = (*i)->GetName( );
-
-			if( !sensitive )
-				transform( TestName.begin( ), TestName.end( ), TestName.begin( ), (int(*)(int))tolower );
+	string LowerName = name;
+	transform( LowerName.begin( ), LowerName.end( ), LowerName.begin( ), (int(*)(int))tolower );
+	map<string, CGamePlayer *> :: iterator i = m_PlayersByName.find( LowerName );
 
-			if( TestName == name )
-				return *i;
-		}
-	}
+	if( i != m_PlayersByName.end( ) && !i->second->GetLeftMessageSent( ) && ( !sensitive || i->second->GetName( ) == name ) )
+		return i->second;
 
 	return NULL;
 }
@@ -3487,15 +3648,58 @@ uint32_t CBaseGame :: GetPlayerFromNamePartial( string name, CGamePlayer **playe
 
 CGamePlayer *CBaseGame :: GetPlayerFromColour( unsigned char colour )
 {
+	// check the slot we found this colour in last time before searching every slot
+	// observers all share colour 12 so only the player colours are remembered
+
+	unsigned char SID = m_SIDByColour[colour];
+
+	if( colour < 12 && SID < m_Slots.size( ) && m_Slots[SID].GetColour( ) == colour )
+		return GetPlayerFromSID( SID );
+
 	for( unsigned char i = 0; i < m_Slots.size( ); i++ )
 	{
 		if( m_Slots[i].GetColour( ) == colour )
+		{
+			if( colour < 12 )
+				m_SIDByColour[colour] = i;
+
 			return GetPlayerFromSID( i );
+		}
 	}
 
 	return NULL;
 }
 
+void CBaseGame :: IndexPlayer( CGamePlayer *player )
+{
+	string LowerName = player->GetName( );
+	transform( LowerName.begin( ), LowerName.end( ), LowerName.begin( ), (int(*)(int))tolower );
+	m_PlayersByPID[player->GetPID( )] = player;
+	m_PlayersByName[LowerName] = player;
+}
+
+void CBaseGame :: UnindexPlayer( CGamePlayer *player )
+{
+	// only remove the player if a new player hasn't taken their place in the index already
+
+	string LowerName = player->GetName( );
+	transform( LowerName.begin( ), LowerName.end( ), LowerName.begin( ), (int(*)(int))tolower );
+
+	if( m_PlayersByPID[player->GetPID( )] == player )
+		m_PlayersByPID[player->GetPID( )] = NULL;
+
+	map<string, CGamePlayer *> :: iterator i = m_PlayersByName.find( LowerName );
+
+	if( i != m_PlayersByName.end( ) && i->second == player )
+		m_PlayersByName.erase( i );
+}
+
+void CBaseGame :: UpdateAdminLevels( )
+{
+	for( vector<CGamePlayer *> :: iterator i = m_Players.begin( ); i != m_Players.end( ); i++ )
+		(*i)->SetAdminLevel( m_GHost->GetAdminLevel( (*i)->GetName( ) ) );
+}
+
 unsigned char CBaseGame :: GetNewPID( )
 {
 	// find an unused PID for a new player to use
@@ -4320,6 +4524,7 @@ void CBaseGame :: StartCountDown( bool force )
 		{
 			m_CountDownStarted = true;
 			m_CountDownCounter = 5;
+			m_GHost->m_Timers->ScheduleIn( &m_CountDownTimer, 0 );
 		}
 		else
 		{
@@ -4400,6 +4605,7 @@ void CBaseGame :: StartCountDown( bool force )
 			{
 				m_CountDownStarted = true;
 				m_CountDownCounter = 5;
+				m_GHost->m_Timers->ScheduleIn( &m_CountDownTimer, 0 );
 			}
 		}
 	}
@@ -4492,6 +4698,7 @@ void CBaseGame :: StartCountDownAuto( bool requireSpoofChecks )
 		{
 			m_CountDownStarted = true;
 			m_CountDownCounter = 10;
+			m_GHost->m_Timers->ScheduleIn( &m_CountDownTimer, 0 );
 		}
 	}
 }
@@ -4600,7 +4807,7 @@ void CBaseGame :: DoGameUpdate(bool reset) {
      else
 	    m_GameUpdates.push_back( PairedGameUpdate( string( ), m_GHost->m_DB->ThreadedGameUpdate( m_GameId, 0, "", 0, "", "", "", "", 0, 0, GetPlayerListOfGame( ))));
 
-    m_LastGameUpdateTime = GetTime( );
+	m_GHost->m_Timers->ScheduleIn( &m_GameUpdateTimer, 3000 );
 }
 
 vector<PlayerOfPlayerList> CBaseGame :: GetPlayerListOfGame( ) {
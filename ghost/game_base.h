@@ -43,6 +43,8 @@ class CCallableScoreCheck;
 class CCallableGetPlayerId;
 class CCallableCreatePlayerId;
 class CCallableGameUpdate;
+class CGameMetrics;
+class CCheckSumLog;
 
 typedef pair<string,CCallableGameUpdate *> PairedGameUpdate;
 
@@ -57,10 +59,12 @@ protected:
 	vector<CGameSlot> m_Slots;						// vector of slots
 	vector<CPotentialPlayer *> m_Potentials;		// vector of potential players (connections that haven't sent a W3GS_REQJOIN packet yet)
 	vector<CGamePlayer *> m_Players;				// vector of players
+	CGamePlayer *m_PlayersByPID[256];				// the player in m_Players with each PID (kept up to date by IndexPlayer and UnindexPlayer)
+	map<string, CGamePlayer *> m_PlayersByName;		// the player in m_Players with each lowercase name (kept up to date by IndexPlayer and UnindexPlayer)
+	unsigned char m_SIDByPID[256];					// the SID each PID was last found in, checked on every lookup since m_Slots changes in too many places to keep it up to date
+	unsigned char m_SIDByColour[256];				// the SID each colour was last found in, checked on every lookup since m_Slots changes in too many places to keep it up to date
 	vector<CCallableScoreCheck *> m_ScoreChecks;
     vector<PairedGameUpdate> m_GameUpdates;
-	vector<CCallableGetPlayerId *> m_PairedGetPlayerIds;		// vector of paired threaded database get player ids in progress
-	vector<CCallableCreatePlayerId *> m_PairedCreatePlayerIds;		// vector of paired threaded database get player ids in progress
 	queue<CIncomingAction *> m_Actions;				// queue of actions to be sent
 	vector<string> m_Reserved;						// vector of player names with reserved slots (from the !hold command)
 	set<string> m_IgnoredNames;						// set of player names to NOT print ban messages for when joining because they've already been printed
@@ -70,6 +74,8 @@ protected:
 	CMap *m_Map;									// map data
 	CSaveGame *m_SaveGame;							// savegame data (this is a pointer to global data)
 	CReplay *m_Replay;								// replay
+	CGameMetrics *m_Metrics;						// instrumentation
+	CCheckSumLog *m_CheckSumLog;					// the checksums the players sent with their keepalives (for detecting desyncs)
 	bool m_Exiting;									// set to true and this class will be deleted next update
 	bool m_Saving;									// if we're currently saving game data to the database
 	uint16_t m_HostPort;							// the port to host games on
@@ -94,27 +100,36 @@ protected:
 	uint32_t m_SyncCounter;							// the number of actions sent so far (for determining if anyone is lagging)
 	uint32_t m_GameTicks;							// ingame ticks
 	uint32_t m_CreationTime;						// GetTime when the game was created
-	uint32_t m_LastPingTime;						// GetTime when the last ping was sent
-	uint32_t m_LastRefreshTime;						// GetTime when the last game refresh was sent
-	uint32_t m_LastDownloadTicks;					// GetTicks when the last map download cycle was performed
+	CTimer m_PingTimer;								// due when the next ping should be sent (every 5 seconds)
+	BYTEARRAY m_LANGameInfo;						// the last W3GS_GAMEINFO we broadcast to the local network, resent with only the time since creation changed
+	uint32_t m_LANGameInfoHostCounter;				// the host counter m_LANGameInfo was built with
+	CTimer m_RefreshTimer;							// due when the next game refresh should be sent (every 3 seconds)
+	CTimer m_DownloadTimer;							// due when the next map download cycle should be performed (every 100ms)
 	uint32_t m_DownloadCounter;						// # of map bytes downloaded in the last second
-	uint32_t m_LastDownloadCounterResetTicks;		// GetTicks when the download counter was last reset
-	uint32_t m_LastAnnounceTime;					// GetTime when the last announce message was sent
+	CTimer m_DownloadCounterTimer;					// due when the download counter should be reset (every second)
+	CTimer m_AnnounceTimer;							// due when the next announce message should be sent (every m_AnnounceInterval seconds)
 	uint32_t m_AnnounceInterval;					// how many seconds to wait between sending the m_AnnounceMessage
-	uint32_t m_LastAutoStartTime;					// the last time we tried to auto start the game
+	CTimer m_AutoStartTimer;						// due when we should try to auto start the game again (every 10 seconds)
 	uint32_t m_AutoStartPlayers;					// auto start the game when there are this many players or more
-	uint32_t m_LastCountDownTicks;					// GetTicks when the last countdown message was sent
+	CTimer m_CountDownTimer;						// due when the next countdown message should be sent (every 500ms once the countdown started)
 	uint32_t m_CountDownCounter;					// the countdown is finished when this reaches zero
 	uint32_t m_StartedLoadingTicks;					// GetTicks when the game started loading
 	uint32_t m_StartPlayers;						// number of players when the game started
-	uint32_t m_LastLagScreenResetTime;				// GetTime when the "lag" screen was last reset
+	CTimer m_LagScreenResetTimer;					// due when the "lag" screen should be reset (30 seconds while loading with load-in-game, 60 seconds while lagging)
 	uint32_t m_LastActionSentTicks;					// GetTicks when the last action packet was sent
 	uint32_t m_LastActionLateBy;					// the number of ticks we were late sending the last action packet by
+	bool m_ActionTickSent;							// if we sent an action packet since the last time the player sockets were flushed
+	uint32_t m_LastAdaptiveLatencyTicks;			// GetTicks when the adaptive latency was last adjusted
+	uint32_t m_AdaptiveActions;						// adaptive latency: the number of action packets sent since the last adjustment
+	uint32_t m_AdaptiveLateActions;					// adaptive latency: the number of action packets sent late (by more than a quarter of the latency) since the last adjustment
+	uint32_t m_AdaptiveMaxSyncLag;					// adaptive latency: the largest number of keepalives a player was behind since the last adjustment
+	uint32_t m_AdaptiveLagScreens;					// adaptive latency: the number of lag screens since the last adjustment
 	uint32_t m_StartedLaggingTime;					// GetTime when the last lag screen started
 	uint32_t m_LastLagScreenTime;					// GetTime when the last lag screen was active (continuously updated)
 	uint32_t m_LastReservedSeen;					// GetTime when the last reserved player was seen in the lobby
-	uint32_t m_StartedKickVoteTime;					// GetTime when the kick vote was started
+	CTimer m_KickVoteTimer;							// due when the kick vote expires (60 seconds after it was started)
 	uint32_t m_GameOverTime;						// GetTime when the game was over
+	CTimer m_GameOverTimer;							// due when the gameover timer is finished (60 seconds after the game was over)
 	uint32_t m_LastPlayerLeaveTicks;				// GetTicks when the most recent player left the game
 	double m_MinimumScore;							// the minimum allowed score for matchmaking mode
 	double m_MaximumScore;							// the maximum allowed score for matchmaking mode
@@ -130,11 +145,12 @@ protected:
 	bool m_GameLoaded;								// if the game has loaded or not
 	bool m_LoadInGame;								// if the load-in-game feature is enabled or not
 	bool m_Lagging;									// if the lag screen is active or not
+	bool m_AdaptiveLatency;							// if the latency is adjusted automatically or not (disabled when the latency is set with !latency)
 	bool m_AutoSave;								// if we should auto save the game before someone disconnects
 	bool m_MatchMaking;								// if matchmaking mode is enabled
 	bool m_LocalAdminMessages;						// if local admin messages should be relayed or not
     uint32_t m_GameId;
-    uint32_t m_LastGameUpdateTime;
+    CTimer m_GameUpdateTimer;						// due when the game list entry in the database should be updated (every 3 seconds)
 
 public:
 	CBaseGame( CGHost *nGHost, CMap *nMap, CSaveGame *nSaveGame, uint16_t nHostPort, unsigned char nGameState, string nGameName, string nOwnerName, string nCreatorName, string nCreatorServer, uint32_t nGameId );
@@ -147,6 +163,8 @@ public:
 	virtual unsigned char GetGameState( )			{ return m_GameState; }
 	virtual unsigned char GetGProxyEmptyActions( )	{ return m_GProxyEmptyActions; }
 	virtual string GetGameName( )					{ return m_GameName; }
+	virtual uint32_t GetSyncCounter( )				{ return m_SyncCounter; }
+	virtual CGameMetrics *GetMetrics( )				{ return m_Metrics; }
 	virtual string GetLastGameName( )				{ return m_LastGameName; }
 	virtual string GetVirtualHostName( )			{ return m_VirtualHostName; }
 	virtual string GetOwnerName( )					{ return m_OwnerName; }
@@ -170,7 +188,7 @@ public:
 	virtual void SetRefreshError( bool nRefreshError )					{ m_RefreshError = nRefreshError; }
 	virtual void SetMatchMaking( bool nMatchMaking )					{ m_MatchMaking = nMatchMaking; }
 
-	virtual uint32_t GetNextTimedActionTicks( );
+	virtual uint64_t GetNextTimedActionMicroTicks( );
 	virtual uint32_t GetSlotsOccupied( );
 	virtual uint32_t GetSlotsOpen( );
 	virtual uint32_t GetNumPlayers( );
@@ -204,6 +222,7 @@ public:
 	virtual void SendVirtualHostPlayerInfo( CGamePlayer *player );
 	virtual void SendFakePlayerInfo( CGamePlayer *player );
 	virtual void SendAllActions( );
+	virtual void UpdateAdaptiveLatency( );
 	virtual void SendWelcomeMessage( CGamePlayer *player );
 	virtual void SendEndMessage( );
 
@@ -246,6 +265,9 @@ public:
 	virtual CGamePlayer *GetPlayerFromName( string name, bool sensitive );
 	virtual uint32_t GetPlayerFromNamePartial( string name, CGamePlayer **player );
 	virtual CGamePlayer *GetPlayerFromColour( unsigned char colour );
+	virtual void IndexPlayer( CGamePlayer *player );
+	virtual void UnindexPlayer( CGamePlayer *player );
+	virtual void UpdateAdminLevels( );
 	virtual unsigned char GetNewPID( );
 	virtual unsigned char GetNewColour( );
 	virtual BYTEARRAY GetPIDs( );
@@ -28,7 +28,9 @@
 #include "gameplayer.h"
 #include "gameprotocol.h"
 #include "gpsprotocol.h"
+#include "timerwheel.h"
 #include "game_base.h"
+#include "metrics.h"
 
 //
 // CPotentialPlayer
@@ -180,9 +182,19 @@ void CPotentialPlayer :: ProcessPackets( )
 }
 
 void CPotentialPlayer :: Send( BYTEARRAY data )
+{
+	Send( SHAREDBYTEARRAY( new BYTEARRAY( data ) ) );
+}
+
+void CPotentialPlayer :: Send( SHAREDBYTEARRAY data )
 {
 	if( m_Socket )
-		m_Socket->PutBytes( data );
+		m_Socket->PutBytes( data, GetSendLane( *data ) );
+}
+
+unsigned char CPotentialPlayer :: GetSendLane( BYTEARRAY &data )
+{
+	return CGameProtocol :: GetSendLane( data, m_Game->GetGameLoading( ) || m_Game->GetGameLoaded( ) );
 }
 
 //
@@ -216,6 +228,8 @@ CGamePlayer :: CGamePlayer( CGameProtocol *nProtocol, CBaseGame *nGame, CTCPSock
 	m_Reserved = nReserved;
 	m_WhoisShouldBeSent = false;
 	m_WhoisSent = false;
+	m_WhoisHandle = 0;
+	m_AdminLevel = 0;
 	m_DownloadAllowed = false;
 	m_DownloadStarted = false;
 	m_DownloadFinished = false;
@@ -230,6 +244,7 @@ CGamePlayer :: CGamePlayer( CGameProtocol *nProtocol, CBaseGame *nGame, CTCPSock
 	m_GProxyReconnectKey = GetTicks( );
 	m_LastGProxyAckTime = 0;
     m_PlayerId = 0;
+	m_PlayerIdState = 0;
     m_LeftTime = 0;
 }
 
@@ -270,6 +285,8 @@ CGamePlayer :: CGamePlayer( CPotentialPlayer *potential, unsigned char nPID, str
 	m_Reserved = nReserved;
 	m_WhoisShouldBeSent = false;
 	m_WhoisSent = false;
+	m_WhoisHandle = 0;
+	m_AdminLevel = 0;
 	m_DownloadAllowed = false;
 	m_DownloadStarted = false;
 	m_DownloadFinished = false;
@@ -284,12 +301,14 @@ CGamePlayer :: CGamePlayer( CPotentialPlayer *potential, unsigned char nPID, str
 	m_GProxyReconnectKey = GetTicks( );
 	m_LastGProxyAckTime = 0;
     m_PlayerId = 0;
+	m_PlayerIdState = 0;
     m_LeftTime = 0;
 }
 
 CGamePlayer :: ~CGamePlayer( )
 {
-
+	if( m_GProxy )
+		m_Game->m_GHost->RemoveGProxyPlayer( this );
 }
 
 string CGamePlayer :: GetNameTerminated( )
@@ -344,12 +363,12 @@ bool CGamePlayer :: Update( void *fd )
 				if( m_Game->GetGameState( ) == GAME_PUBLIC )
 				{
 					if( (*i)->GetPasswordHashType( ) == "pvpgn" )
-						(*i)->QueueChatCommand( "/whereis " + m_Name );
+						m_WhoisHandle = (*i)->QueueChatCommand( "/whereis " + m_Name );
 					else
-						(*i)->QueueChatCommand( "/whois " + m_Name );
+						m_WhoisHandle = (*i)->QueueChatCommand( "/whois " + m_Name );
 				}
 				else if( m_Game->GetGameState( ) == GAME_PRIVATE )
-					(*i)->QueueChatCommand( m_Game->m_GHost->m_Language->SpoofCheckByReplying( ), m_Name, true );
+					m_WhoisHandle = (*i)->QueueChatCommand( m_Game->m_GHost->m_Language->SpoofCheckByReplying( ), m_Name, true );
 			}
 		}
 
@@ -465,6 +484,8 @@ void CGamePlayer :: ProcessPackets( )
 	uint32_t CheckSum = 0;
 	uint32_t Pong = 0;
 
+	m_Game->GetMetrics( )->m_SendQueueBytes.Record( m_Socket->GetSendBufferSize( ) );
+
 	// process all the received packets in the m_Packets queue
 
 	while( !m_Packets.empty( ) )
@@ -509,8 +530,8 @@ void CGamePlayer :: ProcessPackets( )
 
 			case CGameProtocol :: W3GS_OUTGOING_KEEPALIVE:
 				CheckSum = m_Protocol->RECEIVE_W3GS_OUTGOING_KEEPALIVE( Packet->GetData( ) );
-				m_CheckSums.push( CheckSum );
 				m_SyncCounter++;
+				m_Game->GetMetrics( )->m_SyncLag.Record( m_Game->GetSyncCounter( ) - m_SyncCounter );
 				m_Game->EventPlayerKeepAlive( this, CheckSum );
 				break;
 
@@ -583,6 +604,7 @@ void CGamePlayer :: ProcessPackets( )
 				if( m_Game->m_GHost->m_Reconnect )
 				{
 					m_GProxy = true;
+					m_Game->m_GHost->AddGProxyPlayer( this );
 					m_Socket->PutBytes( m_Game->m_GHost->m_GPSProtocol->SEND_GPSS_INIT( m_Game->m_GHost->m_ReconnectPort, m_PID, m_GProxyReconnectKey, m_Game->GetGProxyEmptyActions( ) ) );
 					CONSOLE_Print( "[GAME: " + m_Game->GetGameName( ) + "] player [" + m_Name + "] is using GProxy++" );
 				}
@@ -623,6 +645,11 @@ void CGamePlayer :: ProcessPackets( )
 }
 
 void CGamePlayer :: Send( BYTEARRAY data )
+{
+	Send( SHAREDBYTEARRAY( new BYTEARRAY( data ) ) );
+}
+
+void CGamePlayer :: Send( SHAREDBYTEARRAY data )
 {
 	// must start counting packet total from beginning of connection
 	// but we can avoid buffering packets until we know the client is using GProxy++ since that'll be determined before the game starts
@@ -660,7 +687,7 @@ void CGamePlayer :: EventGProxyReconnect( CTCPSocket *NewSocket, uint32_t LastPa
 
 	// send remaining packets from buffer, preserve buffer
 
-	queue<BYTEARRAY> TempBuffer;
+	queue<SHAREDBYTEARRAY> TempBuffer;
 
 	while( !m_GProxyBuffer.empty( ) )
 	{
@@ -31,6 +31,14 @@ class CIncomingJoinPlayer;
 // CPotentialPlayer
 //
 
+// the socket lanes we queue packets in (see CGameProtocol :: GetSendLane)
+
+#define SEND_LANE_CONTROL		0	// GProxy++ packets
+#define SEND_LANE_LOBBY			1	// everything but chat and map data in the lobby
+#define SEND_LANE_CHAT			2	// chat in the lobby
+#define SEND_LANE_MAP			3	// map data
+#define SEND_LANE_GAME			3	// everything once the game is loading, the last lane so nothing queued in the lobby can be overtaken
+
 class CPotentialPlayer
 {
 public:
@@ -73,6 +81,8 @@ public:
 	// other functions
 
 	virtual void Send( BYTEARRAY data );
+	virtual void Send( SHAREDBYTEARRAY data );
+	virtual unsigned char GetSendLane( BYTEARRAY &data );
 };
 
 //
@@ -86,7 +96,6 @@ private:
 	string m_Name;								// the player's name
 	BYTEARRAY m_InternalIP;						// the player's internal IP address as reported by the player when connecting
 	vector<uint32_t> m_Pings;					// store the last few (20) pings received so we can take an average
-	queue<uint32_t> m_CheckSums;				// the last few checksums the player has sent (for detecting desyncs)
 	string m_LeftReason;						// the reason the player left the game
 	string m_SpoofedRealm;						// the realm the player last spoof checked on
 	string m_JoinedRealm;						// the realm the player joined on (probable, can be spoofed)
@@ -112,6 +121,8 @@ private:
 	bool m_Reserved;							// if the player is reserved (VIP) or not
 	bool m_WhoisShouldBeSent;					// if a battle.net /whois should be sent for this player or not
 	bool m_WhoisSent;							// if we've sent a battle.net /whois for this player yet (for spoof checking)
+	uint32_t m_AdminLevel;						// the player's level in the admin list, resolved when the player joined and whenever the admin list is reloaded
+	uint32_t m_WhoisHandle;						// the battle.net queue handle of the /whois (or spoof check whisper) for removing it from the queue if the player leaves before it's sent
 	bool m_DownloadAllowed;						// if we're allowed to download the map or not (used with permission based map downloads)
 	bool m_DownloadStarted;						// if we've started downloading the map or not
 	bool m_DownloadFinished;					// if we've finished downloading the map or not
@@ -123,10 +134,11 @@ private:
 	bool m_LeftMessageSent;						// if the playerleave message has been sent or not
 	bool m_GProxy;								// if the player is using GProxy++
 	bool m_GProxyDisconnectNoticeSent;			// if a disconnection notice has been sent or not when using GProxy++
-	queue<BYTEARRAY> m_GProxyBuffer;
+	queue<SHAREDBYTEARRAY> m_GProxyBuffer;
 	uint32_t m_GProxyReconnectKey;
 	uint32_t m_LastGProxyAckTime;
     uint32_t m_PlayerId;
+	uint32_t m_PlayerIdState;					// the last PLAYERID_ state of this player's player id we've seen, used for sending the right message when it changes
     uint32_t m_LeftTime;
 
 public:
@@ -138,8 +150,6 @@ public:
 	string GetName( )							{ return m_Name; }
 	BYTEARRAY GetInternalIP( )					{ return m_InternalIP; }
 	unsigned int GetNumPings( )					{ return m_Pings.size( ); }
-	unsigned int GetNumCheckSums( )				{ return m_CheckSums.size( ); }
-	queue<uint32_t> *GetCheckSums( )			{ return &m_CheckSums; }
 	string GetLeftReason( )						{ return m_LeftReason; }
 	string GetSpoofedRealm( )					{ return m_SpoofedRealm; }
 	string GetJoinedRealm( )					{ return m_JoinedRealm; }
@@ -163,6 +173,8 @@ public:
 	bool GetReserved( )							{ return m_Reserved; }
 	bool GetWhoisShouldBeSent( )				{ return m_WhoisShouldBeSent; }
 	bool GetWhoisSent( )						{ return m_WhoisSent; }
+	uint32_t GetWhoisHandle( )					{ return m_WhoisHandle; }
+	uint32_t GetAdminLevel( )					{ return m_AdminLevel; }
 	bool GetDownloadAllowed( )					{ return m_DownloadAllowed; }
 	bool GetDownloadStarted( )					{ return m_DownloadStarted; }
 	bool GetDownloadFinished( )					{ return m_DownloadFinished; }
@@ -176,6 +188,7 @@ public:
 	bool GetGProxyDisconnectNoticeSent( )		{ return m_GProxyDisconnectNoticeSent; }
 	uint32_t GetGProxyReconnectKey( )			{ return m_GProxyReconnectKey; }
     uint32_t GetPlayerId( )                     { return m_PlayerId; }
+	uint32_t GetPlayerIdState( )				{ return m_PlayerIdState; }
     uint32_t GetLeftTime( )                     { return m_LeftTime; }
 
 	void SetLeftReason( string nLeftReason )										{ m_LeftReason = nLeftReason; }
@@ -196,6 +209,7 @@ public:
 	void SetSpoofed( bool nSpoofed )												{ m_Spoofed = nSpoofed; }
 	void SetReserved( bool nReserved )												{ m_Reserved = nReserved; }
 	void SetWhoisShouldBeSent( bool nWhoisShouldBeSent )							{ m_WhoisShouldBeSent = nWhoisShouldBeSent; }
+	void SetAdminLevel( uint32_t nAdminLevel )										{ m_AdminLevel = nAdminLevel; }
 	void SetDownloadAllowed( bool nDownloadAllowed )								{ m_DownloadAllowed = nDownloadAllowed; }
 	void SetDownloadStarted( bool nDownloadStarted )								{ m_DownloadStarted = nDownloadStarted; }
 	void SetDownloadFinished( bool nDownloadFinished )								{ m_DownloadFinished = nDownloadFinished; }
@@ -206,6 +220,7 @@ public:
 	void SetLeftMessageSent( bool nLeftMessageSent )								{ m_LeftMessageSent = nLeftMessageSent; }
 	void SetGProxyDisconnectNoticeSent( bool nGProxyDisconnectNoticeSent )			{ m_GProxyDisconnectNoticeSent = nGProxyDisconnectNoticeSent; }
     void SetPlayerId( uint32_t nPLayerId )                                          { m_PlayerId = nPLayerId; }
+	void SetPlayerIdState( uint32_t nPlayerIdState )								{ m_PlayerIdState = nPlayerIdState; }
     void SetLeftTime( uint32_t nLeftTime )                                          { m_LeftTime = nLeftTime; }
 
 	string GetNameTerminated( );
@@ -222,6 +237,7 @@ public:
 	// other functions
 
 	virtual void Send( BYTEARRAY data );
+	virtual void Send( SHAREDBYTEARRAY data );
 	virtual void EventGProxyReconnect( CTCPSocket *NewSocket, uint32_t LastPacket );
 };
 
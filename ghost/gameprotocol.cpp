@@ -23,6 +23,8 @@
 #include "crc32.h"
 #include "gameplayer.h"
 #include "gameprotocol.h"
+#include "packetschema.h"
+#include "timerwheel.h"
 #include "game_base.h"
 
 //
@@ -43,170 +45,213 @@ CGameProtocol :: ~CGameProtocol( )
 // RECEIVE FUNCTIONS //
 ///////////////////////
 
+// W3GS_REQJOIN
+
+class CW3GSReqJoin
+{
+public:
+	uint32_t m_HostCounter;
+	CPacketBytes m_Name;
+	CPacketBytes m_InternalIP;
+};
+
+typedef CPacketSchema<	CFieldHeader<W3GS_HEADER_CONSTANT, CGameProtocol :: W3GS_REQJOIN>,
+						CFieldUInt32<CW3GSReqJoin, &CW3GSReqJoin :: m_HostCounter>,				// Host Counter (Game ID)
+						CFieldSkip<4>,															// Entry Key (used in LAN)
+						CFieldSkip<1>,															// ???
+						CFieldSkip<2>,															// Listen Port
+						CFieldSkip<4>,															// Peer Key
+						CFieldCString<CW3GSReqJoin, &CW3GSReqJoin :: m_Name>,					// Name
+						CFieldSkip<4>,															// ???
+						CFieldSkip<2>,															// InternalPort (???)
+						CFieldBytes<CW3GSReqJoin, 4, &CW3GSReqJoin :: m_InternalIP> > W3GSReqJoinSchema;	// InternalIP
+
 CIncomingJoinPlayer *CGameProtocol :: RECEIVE_W3GS_REQJOIN( BYTEARRAY data )
 {
 	// DEBUG_Print( "RECEIVED W3GS_REQJOIN" );
 	// DEBUG_Print( data );
 
-	// 2 bytes					-> Header
-	// 2 bytes					-> Length
-	// 4 bytes					-> Host Counter (Game ID)
-	// 4 bytes					-> Entry Key (used in LAN)
-	// 1 byte					-> ???
-	// 2 bytes					-> Listen Port
-	// 4 bytes					-> Peer Key
-	// null terminated string	-> Name
-	// 4 bytes					-> ???
-	// 2 bytes					-> InternalPort (???)
-	// 4 bytes					-> InternalIP
-
-	if( ValidateLength( data ) && data.size( ) >= 20 )
-	{
-		uint32_t HostCounter = UTIL_ByteArrayToUInt32( data, false, 4 );
-		BYTEARRAY Name = UTIL_ExtractCString( data, 19 );
+	CW3GSReqJoin Packet;
 
-		if( !Name.empty( ) && data.size( ) >= Name.size( ) + 30 )
-		{
-			BYTEARRAY InternalIP = BYTEARRAY( data.begin( ) + Name.size( ) + 26, data.begin( ) + Name.size( ) + 30 );
-			return new CIncomingJoinPlayer( HostCounter, string( Name.begin( ), Name.end( ) ), InternalIP );
-		}
+	if( W3GSReqJoinSchema :: Decode( Packet, data ) && Packet.m_Name.m_Size > 0 )
+	{
+		BYTEARRAY InternalIP = Packet.m_InternalIP.GetByteArray( );
+		return new CIncomingJoinPlayer( Packet.m_HostCounter, Packet.m_Name.GetString( ), InternalIP );
 	}
 
 	return NULL;
 }
 
+// W3GS_LEAVEGAME
+
+class CW3GSLeaveGame
+{
+public:
+	uint32_t m_Reason;
+};
+
+typedef CPacketSchema<	CFieldHeader<W3GS_HEADER_CONSTANT, CGameProtocol :: W3GS_LEAVEGAME>,
+						CFieldUInt32<CW3GSLeaveGame, &CW3GSLeaveGame :: m_Reason> > W3GSLeaveGameSchema;	// Reason
+
 uint32_t CGameProtocol :: RECEIVE_W3GS_LEAVEGAME( BYTEARRAY data )
 {
 	// DEBUG_Print( "RECEIVED W3GS_LEAVEGAME" );
 	// DEBUG_Print( data );
 
-	// 2 bytes					-> Header
-	// 2 bytes					-> Length
-	// 4 bytes					-> Reason
+	CW3GSLeaveGame Packet;
 
-	if( ValidateLength( data ) && data.size( ) >= 8 )
-		return UTIL_ByteArrayToUInt32( data, false, 4 );
+	if( W3GSLeaveGameSchema :: Decode( Packet, data ) )
+		return Packet.m_Reason;
 
 	return 0;
 }
 
+// W3GS_GAMELOADED_SELF
+
+typedef CPacketSchema<	CFieldHeader<W3GS_HEADER_CONSTANT, CGameProtocol :: W3GS_GAMELOADED_SELF> > W3GSGameLoadedSelfSchema;
+
 bool CGameProtocol :: RECEIVE_W3GS_GAMELOADED_SELF( BYTEARRAY data )
 {
 	// DEBUG_Print( "RECEIVED W3GS_GAMELOADED_SELF" );
 	// DEBUG_Print( data );
 
-	// 2 bytes					-> Header
-	// 2 bytes					-> Length
+	CPacketNoFields Packet;
+	return W3GSGameLoadedSelfSchema :: Decode( Packet, data );
+}
+
+// W3GS_OUTGOING_ACTION
 
-	if( ValidateLength( data ) )
-		return true;
+class CW3GSOutgoingAction
+{
+public:
+	CPacketBytes m_CRC;
+	CPacketBytes m_Action;
+};
 
-	return false;
-}
+typedef CPacketSchema<	CFieldHeader<W3GS_HEADER_CONSTANT, CGameProtocol :: W3GS_OUTGOING_ACTION>,
+						CFieldBytes<CW3GSOutgoingAction, 4, &CW3GSOutgoingAction :: m_CRC>,		// CRC
+						CFieldRaw<CW3GSOutgoingAction, &CW3GSOutgoingAction :: m_Action> > W3GSOutgoingActionSchema;	// Action (the remainder of the packet)
 
 CIncomingAction *CGameProtocol :: RECEIVE_W3GS_OUTGOING_ACTION( BYTEARRAY data, unsigned char PID )
 {
 	// DEBUG_Print( "RECEIVED W3GS_OUTGOING_ACTION" );
 	// DEBUG_Print( data );
 
-	// 2 bytes					-> Header
-	// 2 bytes					-> Length
-	// 4 bytes					-> CRC
-	// remainder of packet		-> Action
+	CW3GSOutgoingAction Packet;
 
-	if( PID != 255 && ValidateLength( data ) && data.size( ) >= 8 )
+	if( PID != 255 && W3GSOutgoingActionSchema :: Decode( Packet, data ) )
 	{
-		BYTEARRAY CRC = BYTEARRAY( data.begin( ) + 4, data.begin( ) + 8 );
-		BYTEARRAY Action = BYTEARRAY( data.begin( ) + 8, data.end( ) );
+		BYTEARRAY CRC = Packet.m_CRC.GetByteArray( );
+		BYTEARRAY Action = Packet.m_Action.GetByteArray( );
 		return new CIncomingAction( PID, CRC, Action );
 	}
 
 	return NULL;
 }
 
+// W3GS_OUTGOING_KEEPALIVE
+
+class CW3GSOutgoingKeepAlive
+{
+public:
+	uint32_t m_CheckSum;
+};
+
+typedef CPacketSchema<	CFieldHeader<W3GS_HEADER_CONSTANT, CGameProtocol :: W3GS_OUTGOING_KEEPALIVE>,
+						CFieldSkip<1>,																// ???
+						CFieldUInt32<CW3GSOutgoingKeepAlive, &CW3GSOutgoingKeepAlive :: m_CheckSum> > W3GSOutgoingKeepAliveSchema;	// CheckSum??? (used in replays)
+
 uint32_t CGameProtocol :: RECEIVE_W3GS_OUTGOING_KEEPALIVE( BYTEARRAY data )
 {
 	// DEBUG_Print( "RECEIVED W3GS_OUTGOING_KEEPALIVE" );
 	// DEBUG_Print( data );
 
-	// 2 bytes					-> Header
-	// 2 bytes					-> Length
-	// 1 byte					-> ???
-	// 4 bytes					-> CheckSum??? (used in replays)
+	CW3GSOutgoingKeepAlive Packet;
 
-	if( ValidateLength( data ) && data.size( ) == 9 )
-		return UTIL_ByteArrayToUInt32( data, false, 5 );
+	if( data.size( ) == W3GSOutgoingKeepAliveSchema :: MinSize && W3GSOutgoingKeepAliveSchema :: Decode( Packet, data ) )
+		return Packet.m_CheckSum;
 
 	return 0;
 }
 
+// W3GS_CHAT_TO_HOST
+// the rest of the packet depends on the flag so it's decoded with one of the schemas below
+
+class CW3GSChatToHost
+{
+public:
+	CPacketBytes m_ToPIDs;
+	unsigned char m_FromPID;
+	unsigned char m_Flag;
+	CPacketBytes m_Rest;
+	CPacketBytes m_Message;
+	unsigned char m_Byte;
+	CPacketBytes m_ExtraFlags;
+};
+
+typedef CPacketSchema<	CFieldHeader<W3GS_HEADER_CONSTANT, CGameProtocol :: W3GS_CHAT_TO_HOST>,
+						CFieldCounted<CW3GSChatToHost, unsigned char, &CW3GSChatToHost :: m_ToPIDs>,	// Total, ToPIDs
+						CFieldUInt8<CW3GSChatToHost, &CW3GSChatToHost :: m_FromPID>,					// FromPID
+						CFieldUInt8<CW3GSChatToHost, &CW3GSChatToHost :: m_Flag>,						// Flag
+						CFieldRaw<CW3GSChatToHost, &CW3GSChatToHost :: m_Rest> > W3GSChatToHostSchema;
+
+typedef CPacketSchema<	CFieldCString<CW3GSChatToHost, &CW3GSChatToHost :: m_Message> > W3GSChatToHostMessageSchema;		// Flag 16: Message
+
+typedef CPacketSchema<	CFieldUInt8<CW3GSChatToHost, &CW3GSChatToHost :: m_Byte> > W3GSChatToHostByteSchema;				// Flag 17 .. 20: Team, Colour, Race or Handicap
+
+typedef CPacketSchema<	CFieldBytes<CW3GSChatToHost, 4, &CW3GSChatToHost :: m_ExtraFlags>,								// Flag 32: ExtraFlags
+						CFieldCString<CW3GSChatToHost, &CW3GSChatToHost :: m_Message> > W3GSChatToHostMessageExtraSchema;	// Flag 32: Message
+
 CIncomingChatPlayer *CGameProtocol :: RECEIVE_W3GS_CHAT_TO_HOST( BYTEARRAY data )
 {
 	// DEBUG_Print( "RECEIVED W3GS_CHAT_TO_HOST" );
 	// DEBUG_Print( data );
 
-	// 2 bytes					-> Header
-	// 2 bytes					-> Length
-	// 1 byte					-> Total
-	// for( 1 .. Total )
-	//		1 byte				-> ToPID
-	// 1 byte					-> FromPID
-	// 1 byte					-> Flag
-	// if( Flag == 16 )
-	//		null term string	-> Message
-	// elseif( Flag == 17 )
-	//		1 byte				-> Team
-	// elseif( Flag == 18 )
-	//		1 byte				-> Colour
-	// elseif( Flag == 19 )
-	//		1 byte				-> Race
-	// elseif( Flag == 20 )
-	//		1 byte				-> Handicap
-	// elseif( Flag == 32 )
-	//		4 bytes				-> ExtraFlags
-	//		null term string	-> Message
-
-	if( ValidateLength( data ) )
+	CW3GSChatToHost Packet;
+
+	if( W3GSChatToHostSchema :: Decode( Packet, data ) && Packet.m_ToPIDs.m_Size > 0 )
 	{
-		unsigned int i = 5;
-		unsigned char Total = data[4];
+		BYTEARRAY ToPIDs = Packet.m_ToPIDs.GetByteArray( );
 
-		if( Total > 0 && data.size( ) >= i + Total )
+		if( Packet.m_Flag == 16 && W3GSChatToHostMessageSchema :: Decode( Packet, Packet.m_Rest ) )
 		{
-			BYTEARRAY ToPIDs = BYTEARRAY( data.begin( ) + i, data.begin( ) + i + Total );
-			i += Total;
-			unsigned char FromPID = data[i];
-			unsigned char Flag = data[i + 1];
-			i += 2;
-
-			if( Flag == 16 && data.size( ) >= i + 1 )
-			{
-				// chat message
+			// chat message
 
-				BYTEARRAY Message = UTIL_ExtractCString( data, i );
-				return new CIncomingChatPlayer( FromPID, ToPIDs, Flag, string( Message.begin( ), Message.end( ) ) );
-			}
-			else if( ( Flag >= 17 && Flag <= 20 ) && data.size( ) >= i + 1 )
-			{
-				// team/colour/race/handicap change request
+			return new CIncomingChatPlayer( Packet.m_FromPID, ToPIDs, Packet.m_Flag, Packet.m_Message.GetString( ) );
+		}
+		else if( ( Packet.m_Flag >= 17 && Packet.m_Flag <= 20 ) && W3GSChatToHostByteSchema :: Decode( Packet, Packet.m_Rest ) )
+		{
+			// team/colour/race/handicap change request
 
-				unsigned char Byte = data[i];
-				return new CIncomingChatPlayer( FromPID, ToPIDs, Flag, Byte );
-			}
-			else if( Flag == 32 && data.size( ) >= i + 5 )
-			{
-				// chat message with extra flags
+			return new CIncomingChatPlayer( Packet.m_FromPID, ToPIDs, Packet.m_Flag, Packet.m_Byte );
+		}
+		else if( Packet.m_Flag == 32 && W3GSChatToHostMessageExtraSchema :: Decode( Packet, Packet.m_Rest ) )
+		{
+			// chat message with extra flags
 
-				BYTEARRAY ExtraFlags = BYTEARRAY( data.begin( ) + i, data.begin( ) + i + 4 );
-				BYTEARRAY Message = UTIL_ExtractCString( data, i + 4 );
-				return new CIncomingChatPlayer( FromPID, ToPIDs, Flag, string( Message.begin( ), Message.end( ) ), ExtraFlags );
-			}
+			BYTEARRAY ExtraFlags = Packet.m_ExtraFlags.GetByteArray( );
+			return new CIncomingChatPlayer( Packet.m_FromPID, ToPIDs, Packet.m_Flag, Packet.m_Message.GetString( ), ExtraFlags );
 		}
 	}
 
 	return NULL;
 }
 
+// W3GS_SEARCHGAME
+
+class CW3GSSearchGame
+{
+public:
+	uint32_t m_ProductID;
+	uint32_t m_Version;
+	uint32_t m_Unknown;
+};
+
+typedef CPacketSchema<	CFieldHeader<W3GS_HEADER_CONSTANT, CGameProtocol :: W3GS_SEARCHGAME>,
+						CFieldUInt32<CW3GSSearchGame, &CW3GSSearchGame :: m_ProductID>,		// ProductID
+						CFieldUInt32<CW3GSSearchGame, &CW3GSSearchGame :: m_Version>,		// Version
+						CFieldUInt32<CW3GSSearchGame, &CW3GSSearchGame :: m_Unknown> > W3GSSearchGameSchema;	// ??? (Zero)
+
 bool CGameProtocol :: RECEIVE_W3GS_SEARCHGAME( BYTEARRAY data, unsigned char war3Version )
 {
 	uint32_t ProductID	= 1462982736;	// "W3XP"
@@ -215,77 +260,95 @@ bool CGameProtocol :: RECEIVE_W3GS_SEARCHGAME( BYTEARRAY data, unsigned char war
 	// DEBUG_Print( "RECEIVED W3GS_SEARCHGAME" );
 	// DEBUG_Print( data );
 
-	// 2 bytes					-> Header
-	// 2 bytes					-> Length
-	// 4 bytes					-> ProductID
-	// 4 bytes					-> Version
-	// 4 bytes					-> ??? (Zero)
+	CW3GSSearchGame Packet;
 
-	if( ValidateLength( data ) && data.size( ) >= 16 )
+	if( W3GSSearchGameSchema :: Decode( Packet, data ) )
 	{
-		if( UTIL_ByteArrayToUInt32( data, false, 4 ) == ProductID )
-		{
-			if( UTIL_ByteArrayToUInt32( data, false, 8 ) == Version )
-			{
-				if( UTIL_ByteArrayToUInt32( data, false, 12 ) == 0 )
-					return true;
-			}
-		}
+		if( Packet.m_ProductID == ProductID && Packet.m_Version == Version && Packet.m_Unknown == 0 )
+			return true;
 	}
 
 	return false;
 }
 
+// W3GS_MAPSIZE
+
+class CW3GSMapSize
+{
+public:
+	unsigned char m_SizeFlag;
+	uint32_t m_MapSize;
+};
+
+typedef CPacketSchema<	CFieldHeader<W3GS_HEADER_CONSTANT, CGameProtocol :: W3GS_MAPSIZE>,
+						CFieldSkip<4>,														// ???
+						CFieldUInt8<CW3GSMapSize, &CW3GSMapSize :: m_SizeFlag>,				// SizeFlag (1 = have map, 3 = continue download)
+						CFieldUInt32<CW3GSMapSize, &CW3GSMapSize :: m_MapSize> > W3GSMapSizeSchema;	// MapSize
+
 CIncomingMapSize *CGameProtocol :: RECEIVE_W3GS_MAPSIZE( BYTEARRAY data, BYTEARRAY mapSize )
 {
 	// DEBUG_Print( "RECEIVED W3GS_MAPSIZE" );
 	// DEBUG_Print( data );
 
-	// 2 bytes					-> Header
-	// 2 bytes					-> Length
-	// 4 bytes					-> ???
-	// 1 byte					-> SizeFlag (1 = have map, 3 = continue download)
-	// 4 bytes					-> MapSize
+	CW3GSMapSize Packet;
 
-	if( ValidateLength( data ) && data.size( ) >= 13 )
-		return new CIncomingMapSize( data[8], UTIL_ByteArrayToUInt32( data, false, 9 ) );
+	if( W3GSMapSizeSchema :: Decode( Packet, data ) )
+		return new CIncomingMapSize( Packet.m_SizeFlag, Packet.m_MapSize );
 
 	return NULL;
 }
 
+// W3GS_MAPPARTOK
+
+class CW3GSMapPartOK
+{
+public:
+	uint32_t m_MapSize;
+};
+
+typedef CPacketSchema<	CFieldHeader<W3GS_HEADER_CONSTANT, CGameProtocol :: W3GS_MAPPARTOK>,
+						CFieldSkip<1>,														// SenderPID
+						CFieldSkip<1>,														// ReceiverPID
+						CFieldSkip<4>,														// ???
+						CFieldUInt32<CW3GSMapPartOK, &CW3GSMapPartOK :: m_MapSize> > W3GSMapPartOKSchema;	// MapSize
+
 uint32_t CGameProtocol :: RECEIVE_W3GS_MAPPARTOK( BYTEARRAY data )
 {
 	// DEBUG_Print( "RECEIVED W3GS_MAPPARTOK" );
 	// DEBUG_Print( data );
 
-	// 2 bytes					-> Header
-	// 2 bytes					-> Length
-	// 1 byte					-> SenderPID
-	// 1 byte					-> ReceiverPID
-	// 4 bytes					-> ???
-	// 4 bytes					-> MapSize
+	CW3GSMapPartOK Packet;
 
-	if( ValidateLength( data ) && data.size( ) >= 14 )
-		return UTIL_ByteArrayToUInt32( data, false, 10 );
+	if( W3GSMapPartOKSchema :: Decode( Packet, data ) )
+		return Packet.m_MapSize;
 
 	return 0;
 }
 
+// W3GS_PONG_TO_HOST
+
+class CW3GSPongToHost
+{
+public:
+	uint32_t m_Pong;
+};
+
+typedef CPacketSchema<	CFieldHeader<W3GS_HEADER_CONSTANT, CGameProtocol :: W3GS_PONG_TO_HOST>,
+						CFieldUInt32<CW3GSPongToHost, &CW3GSPongToHost :: m_Pong> > W3GSPongToHostSchema;	// Pong
+
 uint32_t CGameProtocol :: RECEIVE_W3GS_PONG_TO_HOST( BYTEARRAY data )
 {
 	// DEBUG_Print( "RECEIVED W3GS_PONG_TO_HOST" );
 	// DEBUG_Print( data );
 
-	// 2 bytes					-> Header
-	// 2 bytes					-> Length
-	// 4 bytes					-> Pong
-
 	// the pong value is just a copy of whatever was sent in SEND_W3GS_PING_FROM_HOST which was GetTicks( ) at the time of sending
 	// so as long as we trust that the client isn't trying to fake us out and mess with the pong value we can find the round trip time by simple subtraction
 	// (the subtraction is done elsewhere because the very first pong value seems to be 1 and we want to discard that one)
 
-	if( ValidateLength( data ) && data.size( ) >= 8 )
-		return UTIL_ByteArrayToUInt32( data, false, 4 );
+	CW3GSPongToHost Packet;
+
+	if( W3GSPongToHostSchema :: Decode( Packet, data ) )
+		return Packet.m_Pong;
 
 	return 1;
 }
@@ -294,43 +357,64 @@ uint32_t CGameProtocol :: RECEIVE_W3GS_PONG_TO_HOST( BYTEARRAY data )
 // SEND FUNCTIONS //
 ////////////////////
 
+// the product ID sent in the LAN packets
+
+#define W3GS_PRODUCTID_ROC	1463898675	// "WAR3"
+#define W3GS_PRODUCTID_TFT	1462982736	// "W3XP"
+
+// W3GS_PING_FROM_HOST
+
+class CW3GSPingFromHost
+{
+public:
+	uint32_t m_Ping;
+};
+
+typedef CPacketSchema<	CFieldHeader<W3GS_HEADER_CONSTANT, CGameProtocol :: W3GS_PING_FROM_HOST>,
+						CFieldUInt32<CW3GSPingFromHost, &CW3GSPingFromHost :: m_Ping> > W3GSPingFromHostSchema;	// ping value
+
 BYTEARRAY CGameProtocol :: SEND_W3GS_PING_FROM_HOST( )
 {
-	BYTEARRAY packet;
-	packet.push_back( W3GS_HEADER_CONSTANT );				// W3GS header constant
-	packet.push_back( W3GS_PING_FROM_HOST );				// W3GS_PING_FROM_HOST
-	packet.push_back( 0 );									// packet length will be assigned later
-	packet.push_back( 0 );									// packet length will be assigned later
-	UTIL_AppendByteArray( packet, GetTicks( ), false );		// ping value
-	AssignLength( packet );
+	CW3GSPingFromHost Packet;
+	Packet.m_Ping = GetTicks( );
+	BYTEARRAY packet = W3GSPingFromHostSchema :: Encode( Packet );
 	// DEBUG_Print( "SENT W3GS_PING_FROM_HOST" );
 	// DEBUG_Print( packet );
 	return packet;
 }
 
-BYTEARRAY CGameProtocol :: SEND_W3GS_SLOTINFOJOIN( unsigned char PID, BYTEARRAY port, BYTEARRAY externalIP, vector<CGameSlot> &slots, uint32_t randomSeed, unsigned char layoutStyle, unsigned char playerSlots )
+// W3GS_SLOTINFOJOIN
+
+class CW3GSSlotInfoJoin
 {
-	unsigned char Zeros[] = { 0, 0, 0, 0 };
+public:
+	CPacketBytes m_SlotInfo;
+	unsigned char m_PID;
+	CPacketBytes m_Port;
+	CPacketBytes m_ExternalIP;
+};
+
+typedef CPacketSchema<	CFieldHeader<W3GS_HEADER_CONSTANT, CGameProtocol :: W3GS_SLOTINFOJOIN>,
+						CFieldCounted<CW3GSSlotInfoJoin, uint16_t, &CW3GSSlotInfoJoin :: m_SlotInfo>,	// SlotInfo length, SlotInfo
+						CFieldUInt8<CW3GSSlotInfoJoin, &CW3GSSlotInfoJoin :: m_PID>,					// PID
+						CFieldConst16<2>,																// AF_INET
+						CFieldBytes<CW3GSSlotInfoJoin, 2, &CW3GSSlotInfoJoin :: m_Port>,				// port
+						CFieldBytes<CW3GSSlotInfoJoin, 4, &CW3GSSlotInfoJoin :: m_ExternalIP>,			// external IP
+						CFieldSkip<8> > W3GSSlotInfoJoinSchema;											// ???
 
+BYTEARRAY CGameProtocol :: SEND_W3GS_SLOTINFOJOIN( unsigned char PID, BYTEARRAY port, BYTEARRAY externalIP, vector<CGameSlot> &slots, uint32_t randomSeed, unsigned char layoutStyle, unsigned char playerSlots )
+{
 	BYTEARRAY SlotInfo = EncodeSlotInfo( slots, randomSeed, layoutStyle, playerSlots );
 	BYTEARRAY packet;
 
 	if( port.size( ) == 2 && externalIP.size( ) == 4 )
 	{
-		packet.push_back( W3GS_HEADER_CONSTANT );									// W3GS header constant
-		packet.push_back( W3GS_SLOTINFOJOIN );										// W3GS_SLOTINFOJOIN
-		packet.push_back( 0 );														// packet length will be assigned later
-		packet.push_back( 0 );														// packet length will be assigned later
-		UTIL_AppendByteArray( packet, (uint16_t)SlotInfo.size( ), false );			// SlotInfo length
-		UTIL_AppendByteArrayFast( packet, SlotInfo );								// SlotInfo
-		packet.push_back( PID );													// PID
-		packet.push_back( 2 );														// AF_INET
-		packet.push_back( 0 );														// AF_INET continued...
-		UTIL_AppendByteArray( packet, port );										// port
-		UTIL_AppendByteArrayFast( packet, externalIP );								// external IP
-		UTIL_AppendByteArray( packet, Zeros, 4 );									// ???
-		UTIL_AppendByteArray( packet, Zeros, 4 );									// ???
-		AssignLength( packet );
+		CW3GSSlotInfoJoin Packet;
+		Packet.m_SlotInfo = SlotInfo;
+		Packet.m_PID = PID;
+		Packet.m_Port = port;
+		Packet.m_ExternalIP = externalIP;
+		packet = W3GSSlotInfoJoinSchema :: Encode( Packet );
 	}
 	else
 		CONSOLE_Print( "[GAMEPROTO] invalid parameters passed to SEND_W3GS_SLOTINFOJOIN" );
@@ -340,53 +424,64 @@ BYTEARRAY CGameProtocol :: SEND_W3GS_SLOTINFOJOIN( unsigned char PID, BYTEARRAY
 	return packet;
 }
 
+// W3GS_REJECTJOIN
+
+class CW3GSRejectJoin
+{
+public:
+	uint32_t m_Reason;
+};
+
+typedef CPacketSchema<	CFieldHeader<W3GS_HEADER_CONSTANT, CGameProtocol :: W3GS_REJECTJOIN>,
+						CFieldUInt32<CW3GSRejectJoin, &CW3GSRejectJoin :: m_Reason> > W3GSRejectJoinSchema;	// reason
+
 BYTEARRAY CGameProtocol :: SEND_W3GS_REJECTJOIN( uint32_t reason )
 {
-	BYTEARRAY packet;
-	packet.push_back( W3GS_HEADER_CONSTANT );				// W3GS header constant
-	packet.push_back( W3GS_REJECTJOIN );					// W3GS_REJECTJOIN
-	packet.push_back( 0 );									// packet length will be assigned later
-	packet.push_back( 0 );									// packet length will be assigned later
-	UTIL_AppendByteArray( packet, reason, false );			// reason
-	AssignLength( packet );
+	CW3GSRejectJoin Packet;
+	Packet.m_Reason = reason;
+	BYTEARRAY packet = W3GSRejectJoinSchema :: Encode( Packet );
 	// DEBUG_Print( "SENT W3GS_REJECTJOIN" );
 	// DEBUG_Print( packet );
 	return packet;
 }
 
-BYTEARRAY CGameProtocol :: SEND_W3GS_PLAYERINFO( unsigned char PID, string name, BYTEARRAY externalIP, BYTEARRAY internalIP )
+// W3GS_PLAYERINFO
+
+class CW3GSPlayerInfo
 {
-	unsigned char PlayerJoinCounter[]	= { 2, 0, 0, 0 };
-	unsigned char Zeros[]				= { 0, 0, 0, 0 };
+public:
+	unsigned char m_PID;
+	CPacketBytes m_Name;
+	CPacketBytes m_ExternalIP;
+	CPacketBytes m_InternalIP;
+};
+
+typedef CPacketSchema<	CFieldHeader<W3GS_HEADER_CONSTANT, CGameProtocol :: W3GS_PLAYERINFO>,
+						CFieldConst32<2>,															// player join counter
+						CFieldUInt8<CW3GSPlayerInfo, &CW3GSPlayerInfo :: m_PID>,					// PID
+						CFieldCString<CW3GSPlayerInfo, &CW3GSPlayerInfo :: m_Name>,					// player name
+						CFieldConst16<1>,															// ???
+						CFieldConst16<2>,															// AF_INET
+						CFieldSkip<2>,																// port
+						CFieldBytes<CW3GSPlayerInfo, 4, &CW3GSPlayerInfo :: m_ExternalIP>,			// external IP
+						CFieldSkip<8>,																// ???
+						CFieldConst16<2>,															// AF_INET
+						CFieldSkip<2>,																// port
+						CFieldBytes<CW3GSPlayerInfo, 4, &CW3GSPlayerInfo :: m_InternalIP>,			// internal IP
+						CFieldSkip<8> > W3GSPlayerInfoSchema;										// ???
 
+BYTEARRAY CGameProtocol :: SEND_W3GS_PLAYERINFO( unsigned char PID, string name, BYTEARRAY externalIP, BYTEARRAY internalIP )
+{
 	BYTEARRAY packet;
 
 	if( !name.empty( ) && name.size( ) <= 15 && externalIP.size( ) == 4 && internalIP.size( ) == 4 )
 	{
-		packet.push_back( W3GS_HEADER_CONSTANT );							// W3GS header constant
-		packet.push_back( W3GS_PLAYERINFO );								// W3GS_PLAYERINFO
-		packet.push_back( 0 );												// packet length will be assigned later
-		packet.push_back( 0 );												// packet length will be assigned later
-		UTIL_AppendByteArray( packet, PlayerJoinCounter, 4 );				// player join counter
-		packet.push_back( PID );											// PID
-		UTIL_AppendByteArrayFast( packet, name );							// player name
-		packet.push_back( 1 );												// ???
-		packet.push_back( 0 );												// ???
-		packet.push_back( 2 );												// AF_INET
-		packet.push_back( 0 );												// AF_INET continued...
-		packet.push_back( 0 );												// port
-		packet.push_back( 0 );												// port continued...
-		UTIL_AppendByteArrayFast( packet, externalIP );						// external IP
-		UTIL_AppendByteArray( packet, Zeros, 4 );							// ???
-		UTIL_AppendByteArray( packet, Zeros, 4 );							// ???
-		packet.push_back( 2 );												// AF_INET
-		packet.push_back( 0 );												// AF_INET continued...
-		packet.push_back( 0 );												// port
-		packet.push_back( 0 );												// port continued...
-		UTIL_AppendByteArrayFast( packet, internalIP );						// internal IP
-		UTIL_AppendByteArray( packet, Zeros, 4 );							// ???
-		UTIL_AppendByteArray( packet, Zeros, 4 );							// ???
-		AssignLength( packet );
+		CW3GSPlayerInfo Packet;
+		Packet.m_PID = PID;
+		Packet.m_Name = name;
+		Packet.m_ExternalIP = externalIP;
+		Packet.m_InternalIP = internalIP;
+		packet = W3GSPlayerInfoSchema :: Encode( Packet );
 	}
 	else
 		CONSOLE_Print( "[GAMEPROTO] invalid parameters passed to SEND_W3GS_PLAYERINFO" );
@@ -396,19 +491,29 @@ BYTEARRAY CGameProtocol :: SEND_W3GS_PLAYERINFO( unsigned char PID, string name,
 	return packet;
 }
 
+// W3GS_PLAYERLEAVE_OTHERS
+
+class CW3GSPlayerLeaveOthers
+{
+public:
+	unsigned char m_PID;
+	uint32_t m_LeftCode;
+};
+
+typedef CPacketSchema<	CFieldHeader<W3GS_HEADER_CONSTANT, CGameProtocol :: W3GS_PLAYERLEAVE_OTHERS>,
+						CFieldUInt8<CW3GSPlayerLeaveOthers, &CW3GSPlayerLeaveOthers :: m_PID>,				// PID
+						CFieldUInt32<CW3GSPlayerLeaveOthers, &CW3GSPlayerLeaveOthers :: m_LeftCode> > W3GSPlayerLeaveOthersSchema;	// left code (see PLAYERLEAVE_ constants in gameprotocol.h)
+
 BYTEARRAY CGameProtocol :: SEND_W3GS_PLAYERLEAVE_OTHERS( unsigned char PID, uint32_t leftCode )
 {
 	BYTEARRAY packet;
 
 	if( PID != 255 )
 	{
-		packet.push_back( W3GS_HEADER_CONSTANT );			// W3GS header constant
-		packet.push_back( W3GS_PLAYERLEAVE_OTHERS );		// W3GS_PLAYERLEAVE_OTHERS
-		packet.push_back( 0 );								// packet length will be assigned later
-		packet.push_back( 0 );								// packet length will be assigned later
-		packet.push_back( PID );							// PID
-		UTIL_AppendByteArray( packet, leftCode, false );	// left code (see PLAYERLEAVE_ constants in gameprotocol.h)
-		AssignLength( packet );
+		CW3GSPlayerLeaveOthers Packet;
+		Packet.m_PID = PID;
+		Packet.m_LeftCode = leftCode;
+		packet = W3GSPlayerLeaveOthersSchema :: Encode( Packet );
 	}
 	else
 		CONSOLE_Print( "[GAMEPROTO] invalid parameters passed to SEND_W3GS_PLAYERLEAVE_OTHERS" );
@@ -418,18 +523,26 @@ BYTEARRAY CGameProtocol :: SEND_W3GS_PLAYERLEAVE_OTHERS( unsigned char PID, uint
 	return packet;
 }
 
+// W3GS_GAMELOADED_OTHERS
+
+class CW3GSGameLoadedOthers
+{
+public:
+	unsigned char m_PID;
+};
+
+typedef CPacketSchema<	CFieldHeader<W3GS_HEADER_CONSTANT, CGameProtocol :: W3GS_GAMELOADED_OTHERS>,
+						CFieldUInt8<CW3GSGameLoadedOthers, &CW3GSGameLoadedOthers :: m_PID> > W3GSGameLoadedOthersSchema;	// PID
+
 BYTEARRAY CGameProtocol :: SEND_W3GS_GAMELOADED_OTHERS( unsigned char PID )
 {
 	BYTEARRAY packet;
 
 	if( PID != 255 )
 	{
-		packet.push_back( W3GS_HEADER_CONSTANT );		// W3GS header constant
-		packet.push_back( W3GS_GAMELOADED_OTHERS );		// W3GS_GAMELOADED_OTHERS
-		packet.push_back( 0 );							// packet length will be assigned later
-		packet.push_back( 0 );							// packet length will be assigned later
-		packet.push_back( PID );						// PID
-		AssignLength( packet );
+		CW3GSGameLoadedOthers Packet;
+		Packet.m_PID = PID;
+		packet = W3GSGameLoadedOthersSchema :: Encode( Packet );
 	}
 	else
 		CONSOLE_Print( "[GAMEPROTO] invalid parameters passed to SEND_W3GS_GAMELOADED_OTHERS" );
@@ -439,106 +552,165 @@ BYTEARRAY CGameProtocol :: SEND_W3GS_GAMELOADED_OTHERS( unsigned char PID )
 	return packet;
 }
 
+// W3GS_SLOTINFO
+
+class CW3GSSlotInfo
+{
+public:
+	CPacketBytes m_SlotInfo;
+};
+
+typedef CPacketSchema<	CFieldHeader<W3GS_HEADER_CONSTANT, CGameProtocol :: W3GS_SLOTINFO>,
+						CFieldCounted<CW3GSSlotInfo, uint16_t, &CW3GSSlotInfo :: m_SlotInfo> > W3GSSlotInfoSchema;	// SlotInfo length, SlotInfo
+
 BYTEARRAY CGameProtocol :: SEND_W3GS_SLOTINFO( vector<CGameSlot> &slots, uint32_t randomSeed, unsigned char layoutStyle, unsigned char playerSlots )
 {
 	BYTEARRAY SlotInfo = EncodeSlotInfo( slots, randomSeed, layoutStyle, playerSlots );
-	BYTEARRAY packet;
-	packet.push_back( W3GS_HEADER_CONSTANT );									// W3GS header constant
-	packet.push_back( W3GS_SLOTINFO );											// W3GS_SLOTINFO
-	packet.push_back( 0 );														// packet length will be assigned later
-	packet.push_back( 0 );														// packet length will be assigned later
-	UTIL_AppendByteArray( packet, (uint16_t)SlotInfo.size( ), false );			// SlotInfo length
-	UTIL_AppendByteArrayFast( packet, SlotInfo );								// SlotInfo
-	AssignLength( packet );
+	CW3GSSlotInfo Packet;
+	Packet.m_SlotInfo = SlotInfo;
+	BYTEARRAY packet = W3GSSlotInfoSchema :: Encode( Packet );
 	// DEBUG_Print( "SENT W3GS_SLOTINFO" );
 	// DEBUG_Print( packet );
 	return packet;
 }
 
+// W3GS_COUNTDOWN_START
+
+typedef CPacketSchema<	CFieldHeader<W3GS_HEADER_CONSTANT, CGameProtocol :: W3GS_COUNTDOWN_START> > W3GSCountdownStartSchema;
+
 BYTEARRAY CGameProtocol :: SEND_W3GS_COUNTDOWN_START( )
 {
-	BYTEARRAY packet;
-	packet.push_back( W3GS_HEADER_CONSTANT );		// W3GS header constant
-	packet.push_back( W3GS_COUNTDOWN_START );		// W3GS_COUNTDOWN_START
-	packet.push_back( 0 );							// packet length will be assigned later
-	packet.push_back( 0 );							// packet length will be assigned later
-	AssignLength( packet );
+	BYTEARRAY packet = W3GSCountdownStartSchema :: Encode( CPacketNoFields( ) );
 	// DEBUG_Print( "SENT W3GS_COUNTDOWN_START" );
 	// DEBUG_Print( packet );
 	return packet;
 }
 
+// W3GS_COUNTDOWN_END
+
+typedef CPacketSchema<	CFieldHeader<W3GS_HEADER_CONSTANT, CGameProtocol :: W3GS_COUNTDOWN_END> > W3GSCountdownEndSchema;
+
 BYTEARRAY CGameProtocol :: SEND_W3GS_COUNTDOWN_END( )
 {
-	BYTEARRAY packet;
-	packet.push_back( W3GS_HEADER_CONSTANT );		// W3GS header constant
-	packet.push_back( W3GS_COUNTDOWN_END );			// W3GS_COUNTDOWN_END
-	packet.push_back( 0 );							// packet length will be assigned later
-	packet.push_back( 0 );							// packet length will be assigned later
-	AssignLength( packet );
+	BYTEARRAY packet = W3GSCountdownEndSchema :: Encode( CPacketNoFields( ) );
 	// DEBUG_Print( "SENT W3GS_COUNTDOWN_END" );
 	// DEBUG_Print( packet );
 	return packet;
 }
 
-BYTEARRAY CGameProtocol :: SEND_W3GS_INCOMING_ACTION( queue<CIncomingAction *> actions, uint16_t sendInterval )
+// W3GS_INCOMING_ACTION and W3GS_INCOMING_ACTION2
+// the schemas only cover the start of the packet, the actions are appended as a subpacket by EncodeIncomingAction
+
+class CW3GSIncomingAction
 {
-	BYTEARRAY packet;
-	packet.push_back( W3GS_HEADER_CONSTANT );				// W3GS header constant
-	packet.push_back( W3GS_INCOMING_ACTION );				// W3GS_INCOMING_ACTION
-	packet.push_back( 0 );									// packet length will be assigned later
-	packet.push_back( 0 );									// packet length will be assigned later
-	UTIL_AppendByteArray( packet, sendInterval, false );	// send interval
+public:
+	uint16_t m_SendInterval;
+};
+
+typedef CPacketSchema<	CFieldHeader<W3GS_HEADER_CONSTANT, CGameProtocol :: W3GS_INCOMING_ACTION>,
+						CFieldUInt16<CW3GSIncomingAction, &CW3GSIncomingAction :: m_SendInterval> > W3GSIncomingActionSchema;	// send interval
+
+typedef CPacketSchema<	CFieldHeader<W3GS_HEADER_CONSTANT, CGameProtocol :: W3GS_INCOMING_ACTION2>,
+						CFieldSkip<2> > W3GSIncomingAction2Schema;																// ??? (send interval?)
+
+template<class S, class P>
+static BYTEARRAY EncodeIncomingAction( CCRC32 *crc, const P &fields, queue<CIncomingAction *> &actions )
+{
+	vector<CIncomingAction *> Actions;
+	uint32_t SubpacketSize = 0;
+
+	while( !actions.empty( ) )
+	{
+		Actions.push_back( actions.front( ) );
+		SubpacketSize += 3 + actions.front( )->GetAction( )->size( );
+		actions.pop( );
+	}
+
+	uint32_t FieldsSize = S :: GetSize( fields );
+	uint32_t Size = FieldsSize;
+
+	if( !Actions.empty( ) )
+		Size += 2 + SubpacketSize;
 
-	// create subpacket
+	// the packet only holds the fields while they're encoded and grows to its full size afterwards
+	// this way the compiler can see that the fields always fit (otherwise gcc warns that the size above might have wrapped around)
 
-	if( !actions.empty( ) )
+	BYTEARRAY packet;
+	packet.reserve( Size );
+	packet.resize( FieldsSize );
+	S :: EncodeFields( fields, &packet[0], Size );
+
+	if( !Actions.empty( ) )
 	{
-		BYTEARRAY subpacket;
+		// create subpacket
+
+		packet.resize( Size );
+		unsigned char *Subpacket = &packet[FieldsSize + 2];
+		unsigned char *Buffer = Subpacket;
 
-		while( !actions.empty( ) )
+		for( vector<CIncomingAction *> :: iterator i = Actions.begin( ); i != Actions.end( ); i++ )
 		{
-			CIncomingAction *Action = actions.front( );
-			actions.pop( );
-			subpacket.push_back( Action->GetPID( ) );
-			UTIL_AppendByteArray( subpacket, (uint16_t)Action->GetAction( )->size( ), false );
-			UTIL_AppendByteArrayFast( subpacket, *Action->GetAction( ) );
-		}
+			BYTEARRAY *Action = (*i)->GetAction( );
+			*Buffer++ = (*i)->GetPID( );
+			PACKET_PutUInt16( Buffer, (uint16_t)Action->size( ) );
+			Buffer += 2;
 
-		// calculate crc (we only care about the first 2 bytes though)
+			if( !Action->empty( ) )
+				memcpy( Buffer, &(*Action)[0], Action->size( ) );
 
-		BYTEARRAY crc32 = UTIL_CreateByteArray( m_GHost->m_CRC->FullCRC( (unsigned char *)string( subpacket.begin( ), subpacket.end( ) ).c_str( ), subpacket.size( ) ), false );
-		crc32.resize( 2 );
+			Buffer += Action->size( );
+		}
 
-		// finish subpacket
+		// calculate crc (we only care about the first 2 bytes though)
 
-		UTIL_AppendByteArrayFast( packet, crc32 );			// crc
-		UTIL_AppendByteArrayFast( packet, subpacket );		// subpacket
+		PACKET_PutUInt16( Subpacket - 2, (uint16_t)crc->FullCRC( Subpacket, SubpacketSize ) );
 	}
 
-	AssignLength( packet );
+	return packet;
+}
+
+BYTEARRAY CGameProtocol :: SEND_W3GS_INCOMING_ACTION( queue<CIncomingAction *> actions, uint16_t sendInterval )
+{
+	CW3GSIncomingAction Packet;
+	Packet.m_SendInterval = sendInterval;
+	BYTEARRAY packet = EncodeIncomingAction<W3GSIncomingActionSchema>( m_GHost->m_CRC, Packet, actions );
 	// DEBUG_Print( "SENT W3GS_INCOMING_ACTION" );
 	// DEBUG_Print( packet );
 	return packet;
 }
 
+// W3GS_CHAT_FROM_HOST
+
+class CW3GSChatFromHost
+{
+public:
+	CPacketBytes m_ToPIDs;
+	unsigned char m_FromPID;
+	unsigned char m_Flag;
+	CPacketBytes m_FlagExtra;
+	CPacketBytes m_Message;
+};
+
+typedef CPacketSchema<	CFieldHeader<W3GS_HEADER_CONSTANT, CGameProtocol :: W3GS_CHAT_FROM_HOST>,
+						CFieldCounted<CW3GSChatFromHost, unsigned char, &CW3GSChatFromHost :: m_ToPIDs>,	// number of receivers, receivers
+						CFieldUInt8<CW3GSChatFromHost, &CW3GSChatFromHost :: m_FromPID>,					// sender
+						CFieldUInt8<CW3GSChatFromHost, &CW3GSChatFromHost :: m_Flag>,						// flag
+						CFieldRaw<CW3GSChatFromHost, &CW3GSChatFromHost :: m_FlagExtra>,					// extra flag
+						CFieldCString<CW3GSChatFromHost, &CW3GSChatFromHost :: m_Message> > W3GSChatFromHostSchema;	// message
+
 BYTEARRAY CGameProtocol :: SEND_W3GS_CHAT_FROM_HOST( unsigned char fromPID, BYTEARRAY toPIDs, unsigned char flag, BYTEARRAY flagExtra, string message )
 {
 	BYTEARRAY packet;
 
 	if( !toPIDs.empty( ) && !message.empty( ) && message.size( ) < 255 )
 	{
-		packet.push_back( W3GS_HEADER_CONSTANT );		// W3GS header constant
-		packet.push_back( W3GS_CHAT_FROM_HOST );		// W3GS_CHAT_FROM_HOST
-		packet.push_back( 0 );							// packet length will be assigned later
-		packet.push_back( 0 );							// packet length will be assigned later
-		packet.push_back( toPIDs.size( ) );				// number of receivers
-		UTIL_AppendByteArrayFast( packet, toPIDs );		// receivers
-		packet.push_back( fromPID );					// sender
-		packet.push_back( flag );						// flag
-		UTIL_AppendByteArrayFast( packet, flagExtra );	// extra flag
-		UTIL_AppendByteArrayFast( packet, message );	// message
-		AssignLength( packet );
+		CW3GSChatFromHost Packet;
+		Packet.m_ToPIDs = toPIDs;
+		Packet.m_FromPID = fromPID;
+		Packet.m_Flag = flag;
+		Packet.m_FlagExtra = flagExtra;
+		Packet.m_Message = message;
+		packet = W3GSChatFromHostSchema :: Encode( Packet );
 	}
 	else
 		CONSOLE_Print( "[GAMEPROTO] invalid parameters passed to SEND_W3GS_CHAT_FROM_HOST" );
@@ -548,55 +720,54 @@ BYTEARRAY CGameProtocol :: SEND_W3GS_CHAT_FROM_HOST( unsigned char fromPID, BYTE
 	return packet;
 }
 
+// W3GS_START_LAG
+
+class CW3GSStartLag
+{
+public:
+	unsigned char m_NumLaggers;
+	CPacketBytes m_Laggers;
+};
+
+typedef CPacketSchema<	CFieldHeader<W3GS_HEADER_CONSTANT, CGameProtocol :: W3GS_START_LAG>,
+						CFieldUInt8<CW3GSStartLag, &CW3GSStartLag :: m_NumLaggers>,		// number of laggers
+						CFieldRaw<CW3GSStartLag, &CW3GSStartLag :: m_Laggers> > W3GSStartLagSchema;	// for each lagger: PID (1 byte), lag time (4 bytes)
+
 BYTEARRAY CGameProtocol :: SEND_W3GS_START_LAG( vector<CGamePlayer *> players, bool loadInGame )
 {
 	BYTEARRAY packet;
 
+	unsigned char Laggers[255 * 5];
 	unsigned char NumLaggers = 0;
 
-	for( vector<CGamePlayer *> :: iterator i = players.begin( ); i != players.end( ); i++ )
+	for( vector<CGamePlayer *> :: iterator i = players.begin( ); i != players.end( ) && NumLaggers < 255; i++ )
 	{
 		if( loadInGame )
 		{
 			if( !(*i)->GetFinishedLoading( ) )
+			{
+				Laggers[NumLaggers * 5] = (*i)->GetPID( );
+				PACKET_PutUInt32( Laggers + NumLaggers * 5 + 1, 0 );
 				NumLaggers++;
+			}
 		}
 		else
 		{
 			if( (*i)->GetLagging( ) )
+			{
+				Laggers[NumLaggers * 5] = (*i)->GetPID( );
+				PACKET_PutUInt32( Laggers + NumLaggers * 5 + 1, GetTicks( ) - (*i)->GetStartedLaggingTicks( ) );
 				NumLaggers++;
+			}
 		}
 	}
 
 	if( NumLaggers > 0 )
 	{
-		packet.push_back( W3GS_HEADER_CONSTANT );	// W3GS header constant
-		packet.push_back( W3GS_START_LAG );			// W3GS_START_LAG
-		packet.push_back( 0 );						// packet length will be assigned later
-		packet.push_back( 0 );						// packet length will be assigned later
-		packet.push_back( NumLaggers );
-
-		for( vector<CGamePlayer *> :: iterator i = players.begin( ); i != players.end( ); i++ )
-		{
-			if( loadInGame )
-			{
-				if( !(*i)->GetFinishedLoading( ) )
-				{
-					packet.push_back( (*i)->GetPID( ) );
-					UTIL_AppendByteArray( packet, (uint32_t)0, false );
-				}
-			}
-			else
-			{
-				if( (*i)->GetLagging( ) )
-				{
-					packet.push_back( (*i)->GetPID( ) );
-					UTIL_AppendByteArray( packet, GetTicks( ) - (*i)->GetStartedLaggingTicks( ), false );
-				}
-			}
-		}
-
-		AssignLength( packet );
+		CW3GSStartLag Packet;
+		Packet.m_NumLaggers = NumLaggers;
+		Packet.m_Laggers = CPacketBytes( Laggers, NumLaggers * 5 );
+		packet = W3GSStartLagSchema :: Encode( Packet );
 	}
 	else
 		CONSOLE_Print( "[GAMEPROTO] no laggers passed to SEND_W3GS_START_LAG" );
@@ -606,60 +777,83 @@ BYTEARRAY CGameProtocol :: SEND_W3GS_START_LAG( vector<CGamePlayer *> players, b
 	return packet;
 }
 
+// W3GS_STOP_LAG
+
+class CW3GSStopLag
+{
+public:
+	unsigned char m_PID;
+	uint32_t m_LagTime;
+};
+
+typedef CPacketSchema<	CFieldHeader<W3GS_HEADER_CONSTANT, CGameProtocol :: W3GS_STOP_LAG>,
+						CFieldUInt8<CW3GSStopLag, &CW3GSStopLag :: m_PID>,				// PID
+						CFieldUInt32<CW3GSStopLag, &CW3GSStopLag :: m_LagTime> > W3GSStopLagSchema;	// lag time
+
 BYTEARRAY CGameProtocol :: SEND_W3GS_STOP_LAG( CGamePlayer *player, bool loadInGame )
 {
-	BYTEARRAY packet;
-	packet.push_back( W3GS_HEADER_CONSTANT );	// W3GS header constant
-	packet.push_back( W3GS_STOP_LAG );			// W3GS_STOP_LAG
-	packet.push_back( 0 );						// packet length will be assigned later
-	packet.push_back( 0 );						// packet length will be assigned later
-	packet.push_back( player->GetPID( ) );
+	CW3GSStopLag Packet;
+	Packet.m_PID = player->GetPID( );
 
 	if( loadInGame )
-		UTIL_AppendByteArray( packet, (uint32_t)0, false );
+		Packet.m_LagTime = 0;
 	else
-		UTIL_AppendByteArray( packet, GetTicks( ) - player->GetStartedLaggingTicks( ), false );
+		Packet.m_LagTime = GetTicks( ) - player->GetStartedLaggingTicks( );
 
-	AssignLength( packet );
+	BYTEARRAY packet = W3GSStopLagSchema :: Encode( Packet );
 	// DEBUG_Print( "SENT W3GS_STOP_LAG" );
 	// DEBUG_Print( packet );
 	return packet;
 }
 
+// W3GS_SEARCHGAME (the schema is shared with RECEIVE_W3GS_SEARCHGAME)
+
 BYTEARRAY CGameProtocol :: SEND_W3GS_SEARCHGAME( bool TFT, unsigned char war3Version )
 {
-	unsigned char ProductID_ROC[]	= {          51, 82, 65, 87 };	// "WAR3"
-	unsigned char ProductID_TFT[]	= {          80, 88, 51, 87 };	// "W3XP"
-	unsigned char Version[]			= { war3Version,  0,  0,  0 };
-	unsigned char Unknown[]			= {           0,  0,  0,  0 };
-
-	BYTEARRAY packet;
-	packet.push_back( W3GS_HEADER_CONSTANT );				// W3GS header constant
-	packet.push_back( W3GS_SEARCHGAME );					// W3GS_SEARCHGAME
-	packet.push_back( 0 );									// packet length will be assigned later
-	packet.push_back( 0 );									// packet length will be assigned later
-
-	if( TFT )
-		UTIL_AppendByteArray( packet, ProductID_TFT, 4 );	// Product ID (TFT)
-	else
-		UTIL_AppendByteArray( packet, ProductID_ROC, 4 );	// Product ID (ROC)
-
-	UTIL_AppendByteArray( packet, Version, 4 );				// Version
-	UTIL_AppendByteArray( packet, Unknown, 4 );				// ???
-	AssignLength( packet );
+	CW3GSSearchGame Packet;
+	Packet.m_ProductID = TFT ? W3GS_PRODUCTID_TFT : W3GS_PRODUCTID_ROC;
+	Packet.m_Version = war3Version;
+	Packet.m_Unknown = 0;
+	BYTEARRAY packet = W3GSSearchGameSchema :: Encode( Packet );
 	// DEBUG_Print( "SENT W3GS_SEARCHGAME" );
 	// DEBUG_Print( packet );
 	return packet;
 }
 
-BYTEARRAY CGameProtocol :: SEND_W3GS_GAMEINFO( bool TFT, unsigned char war3Version, BYTEARRAY mapGameType, BYTEARRAY mapFlags, BYTEARRAY mapWidth, BYTEARRAY mapHeight, string gameName, string hostName, uint32_t upTime, string mapPath, BYTEARRAY mapCRC, uint32_t slotsTotal, uint32_t slotsOpen, uint16_t port, uint32_t hostCounter )
+// W3GS_GAMEINFO
+
+class CW3GSGameInfo
 {
-	unsigned char ProductID_ROC[]	= {          51, 82, 65, 87 };	// "WAR3"
-	unsigned char ProductID_TFT[]	= {          80, 88, 51, 87 };	// "W3XP"
-	unsigned char Version[]			= { war3Version,  0,  0,  0 };
-	unsigned char Unknown1[]		= {           1,  2,  3,  4 };
-	unsigned char Unknown2[]		= {           1,  0,  0,  0 };
+public:
+	uint32_t m_ProductID;
+	uint32_t m_Version;
+	uint32_t m_HostCounter;
+	CPacketBytes m_GameName;
+	CPacketBytes m_StatString;
+	uint32_t m_SlotsTotal;
+	CPacketBytes m_MapGameType;
+	uint32_t m_SlotsOpen;
+	uint32_t m_UpTime;
+	uint16_t m_Port;
+};
+
+typedef CPacketSchema<	CFieldHeader<W3GS_HEADER_CONSTANT, CGameProtocol :: W3GS_GAMEINFO>,
+						CFieldUInt32<CW3GSGameInfo, &CW3GSGameInfo :: m_ProductID>,				// Product ID
+						CFieldUInt32<CW3GSGameInfo, &CW3GSGameInfo :: m_Version>,				// Version
+						CFieldUInt32<CW3GSGameInfo, &CW3GSGameInfo :: m_HostCounter>,			// Host Counter
+						CFieldConst32<67305985>,												// ??? (this varies wildly even between two identical games created one after another)
+						CFieldCString<CW3GSGameInfo, &CW3GSGameInfo :: m_GameName>,				// Game Name
+						CFieldConst8<0>,														// ??? (maybe game password)
+						CFieldCString<CW3GSGameInfo, &CW3GSGameInfo :: m_StatString>,			// Stat String (the stat string is encoded to remove all even numbers i.e. zeros)
+						CFieldUInt32<CW3GSGameInfo, &CW3GSGameInfo :: m_SlotsTotal>,			// Slots Total
+						CFieldBytes<CW3GSGameInfo, 4, &CW3GSGameInfo :: m_MapGameType>,			// Game Type
+						CFieldConst32<1>,														// ???
+						CFieldUInt32<CW3GSGameInfo, &CW3GSGameInfo :: m_SlotsOpen>,				// Slots Open
+						CFieldUInt32<CW3GSGameInfo, &CW3GSGameInfo :: m_UpTime>,				// time since creation
+						CFieldUInt16<CW3GSGameInfo, &CW3GSGameInfo :: m_Port> > W3GSGameInfoSchema;	// port
 
+BYTEARRAY CGameProtocol :: SEND_W3GS_GAMEINFO( bool TFT, unsigned char war3Version, BYTEARRAY mapGameType, BYTEARRAY mapFlags, BYTEARRAY mapWidth, BYTEARRAY mapHeight, string gameName, string hostName, uint32_t upTime, string mapPath, BYTEARRAY mapCRC, uint32_t slotsTotal, uint32_t slotsOpen, uint16_t port, uint32_t hostCounter )
+{
 	BYTEARRAY packet;
 
 	if( mapGameType.size( ) == 4 && mapFlags.size( ) == 4 && mapWidth.size( ) == 2 && mapHeight.size( ) == 2 && !gameName.empty( ) && !hostName.empty( ) && !mapPath.empty( ) && mapCRC.size( ) == 4 )
@@ -679,30 +873,18 @@ BYTEARRAY CGameProtocol :: SEND_W3GS_GAMEINFO( bool TFT, unsigned char war3Versi
 
 		// make the rest of the packet
 
-		packet.push_back( W3GS_HEADER_CONSTANT );						// W3GS header constant
-		packet.push_back( W3GS_GAMEINFO );								// W3GS_GAMEINFO
-		packet.push_back( 0 );											// packet length will be assigned later
-		packet.push_back( 0 );											// packet length will be assigned later
-
-		if( TFT )
-			UTIL_AppendByteArray( packet, ProductID_TFT, 4 );			// Product ID (TFT)
-		else
-			UTIL_AppendByteArray( packet, ProductID_ROC, 4 );			// Product ID (ROC)
-
-		UTIL_AppendByteArray( packet, Version, 4 );						// Version
-		UTIL_AppendByteArray( packet, hostCounter, false );				// Host Counter
-		UTIL_AppendByteArray( packet, Unknown1, 4 );					// ??? (this varies wildly even between two identical games created one after another)
-		UTIL_AppendByteArrayFast( packet, gameName );					// Game Name
-		packet.push_back( 0 );											// ??? (maybe game password)
-		UTIL_AppendByteArrayFast( packet, StatString );					// Stat String
-		packet.push_back( 0 );											// Stat String null terminator (the stat string is encoded to remove all even numbers i.e. zeros)
-		UTIL_AppendByteArray( packet, slotsTotal, false );				// Slots Total
-		UTIL_AppendByteArrayFast( packet, mapGameType );				// Game Type
-		UTIL_AppendByteArray( packet, Unknown2, 4 );					// ???
-		UTIL_AppendByteArray( packet, slotsOpen, false );				// Slots Open
-		UTIL_AppendByteArray( packet, upTime, false );					// time since creation
-		UTIL_AppendByteArray( packet, port, false );					// port
-		AssignLength( packet );
+		CW3GSGameInfo Packet;
+		Packet.m_ProductID = TFT ? W3GS_PRODUCTID_TFT : W3GS_PRODUCTID_ROC;
+		Packet.m_Version = war3Version;
+		Packet.m_HostCounter = hostCounter;
+		Packet.m_GameName = gameName;
+		Packet.m_StatString = StatString;
+		Packet.m_SlotsTotal = slotsTotal;
+		Packet.m_MapGameType = mapGameType;
+		Packet.m_SlotsOpen = slotsOpen;
+		Packet.m_UpTime = upTime;
+		Packet.m_Port = port;
+		packet = W3GSGameInfoSchema :: Encode( Packet );
 	}
 	else
 		CONSOLE_Print( "[GAMEPROTO] invalid parameters passed to SEND_W3GS_GAMEINFO" );
@@ -712,85 +894,102 @@ BYTEARRAY CGameProtocol :: SEND_W3GS_GAMEINFO( bool TFT, unsigned char war3Versi
 	return packet;
 }
 
-BYTEARRAY CGameProtocol :: SEND_W3GS_CREATEGAME( bool TFT, unsigned char war3Version )
+// W3GS_CREATEGAME
+
+class CW3GSCreateGame
 {
-	unsigned char ProductID_ROC[]	= {          51, 82, 65, 87 };	// "WAR3"
-	unsigned char ProductID_TFT[]	= {          80, 88, 51, 87 };	// "W3XP"
-	unsigned char Version[]			= { war3Version,  0,  0,  0 };
-	unsigned char HostCounter[]		= {           1,  0,  0,  0 };
+public:
+	uint32_t m_ProductID;
+	uint32_t m_Version;
+};
 
-	BYTEARRAY packet;
-	packet.push_back( W3GS_HEADER_CONSTANT );				// W3GS header constant
-	packet.push_back( W3GS_CREATEGAME );					// W3GS_CREATEGAME
-	packet.push_back( 0 );									// packet length will be assigned later
-	packet.push_back( 0 );									// packet length will be assigned later
+typedef CPacketSchema<	CFieldHeader<W3GS_HEADER_CONSTANT, CGameProtocol :: W3GS_CREATEGAME>,
+						CFieldUInt32<CW3GSCreateGame, &CW3GSCreateGame :: m_ProductID>,		// Product ID
+						CFieldUInt32<CW3GSCreateGame, &CW3GSCreateGame :: m_Version>,		// Version
+						CFieldConst32<1> > W3GSCreateGameSchema;							// Host Counter
 
-	if( TFT )
-		UTIL_AppendByteArray( packet, ProductID_TFT, 4 );	// Product ID (TFT)
-	else
-		UTIL_AppendByteArray( packet, ProductID_ROC, 4 );	// Product ID (ROC)
-
-	UTIL_AppendByteArray( packet, Version, 4 );				// Version
-	UTIL_AppendByteArray( packet, HostCounter, 4 );			// Host Counter
-	AssignLength( packet );
+BYTEARRAY CGameProtocol :: SEND_W3GS_CREATEGAME( bool TFT, unsigned char war3Version )
+{
+	CW3GSCreateGame Packet;
+	Packet.m_ProductID = TFT ? W3GS_PRODUCTID_TFT : W3GS_PRODUCTID_ROC;
+	Packet.m_Version = war3Version;
+	BYTEARRAY packet = W3GSCreateGameSchema :: Encode( Packet );
 	// DEBUG_Print( "SENT W3GS_CREATEGAME" );
 	// DEBUG_Print( packet );
 	return packet;
 }
 
-BYTEARRAY CGameProtocol :: SEND_W3GS_REFRESHGAME( uint32_t players, uint32_t playerSlots )
+// W3GS_REFRESHGAME
+
+class CW3GSRefreshGame
 {
-	unsigned char HostCounter[]	= { 1, 0, 0, 0 };
+public:
+	uint32_t m_Players;
+	uint32_t m_PlayerSlots;
+};
 
-	BYTEARRAY packet;
-	packet.push_back( W3GS_HEADER_CONSTANT );			// W3GS header constant
-	packet.push_back( W3GS_REFRESHGAME );				// W3GS_REFRESHGAME
-	packet.push_back( 0 );								// packet length will be assigned later
-	packet.push_back( 0 );								// packet length will be assigned later
-	UTIL_AppendByteArray( packet, HostCounter, 4 );		// Host Counter
-	UTIL_AppendByteArray( packet, players, false );		// Players
-	UTIL_AppendByteArray( packet, playerSlots, false );	// Player Slots
-	AssignLength( packet );
+typedef CPacketSchema<	CFieldHeader<W3GS_HEADER_CONSTANT, CGameProtocol :: W3GS_REFRESHGAME>,
+						CFieldConst32<1>,														// Host Counter
+						CFieldUInt32<CW3GSRefreshGame, &CW3GSRefreshGame :: m_Players>,			// Players
+						CFieldUInt32<CW3GSRefreshGame, &CW3GSRefreshGame :: m_PlayerSlots> > W3GSRefreshGameSchema;	// Player Slots
+
+BYTEARRAY CGameProtocol :: SEND_W3GS_REFRESHGAME( uint32_t players, uint32_t playerSlots )
+{
+	CW3GSRefreshGame Packet;
+	Packet.m_Players = players;
+	Packet.m_PlayerSlots = playerSlots;
+	BYTEARRAY packet = W3GSRefreshGameSchema :: Encode( Packet );
 	// DEBUG_Print( "SENT W3GS_REFRESHGAME" );
 	// DEBUG_Print( packet );
 	return packet;
 }
 
+// W3GS_DECREATEGAME
+
+typedef CPacketSchema<	CFieldHeader<W3GS_HEADER_CONSTANT, CGameProtocol :: W3GS_DECREATEGAME>,
+						CFieldConst32<1> > W3GSDecreateGameSchema;		// Host Counter
+
 BYTEARRAY CGameProtocol :: SEND_W3GS_DECREATEGAME( )
 {
-	unsigned char HostCounter[]	= { 1, 0, 0, 0 };
-
-	BYTEARRAY packet;
-	packet.push_back( W3GS_HEADER_CONSTANT );			// W3GS header constant
-	packet.push_back( W3GS_DECREATEGAME );				// W3GS_DECREATEGAME
-	packet.push_back( 0 );								// packet length will be assigned later
-	packet.push_back( 0 );								// packet length will be assigned later
-	UTIL_AppendByteArray( packet, HostCounter, 4 );		// Host Counter
-	AssignLength( packet );
+	BYTEARRAY packet = W3GSDecreateGameSchema :: Encode( CPacketNoFields( ) );
 	// DEBUG_Print( "SENT W3GS_DECREATEGAME" );
 	// DEBUG_Print( packet );
 	return packet;
 }
 
-BYTEARRAY CGameProtocol :: SEND_W3GS_MAPCHECK( string mapPath, BYTEARRAY mapSize, BYTEARRAY mapInfo, BYTEARRAY mapCRC, BYTEARRAY mapSHA1 )
+// W3GS_MAPCHECK
+
+class CW3GSMapCheck
 {
-	unsigned char Unknown[] = { 1, 0, 0, 0 };
+public:
+	CPacketBytes m_MapPath;
+	CPacketBytes m_MapSize;
+	CPacketBytes m_MapInfo;
+	CPacketBytes m_MapCRC;
+	CPacketBytes m_MapSHA1;
+};
+
+typedef CPacketSchema<	CFieldHeader<W3GS_HEADER_CONSTANT, CGameProtocol :: W3GS_MAPCHECK>,
+						CFieldConst32<1>,													// ???
+						CFieldCString<CW3GSMapCheck, &CW3GSMapCheck :: m_MapPath>,			// map path
+						CFieldBytes<CW3GSMapCheck, 4, &CW3GSMapCheck :: m_MapSize>,			// map size
+						CFieldBytes<CW3GSMapCheck, 4, &CW3GSMapCheck :: m_MapInfo>,			// map info
+						CFieldBytes<CW3GSMapCheck, 4, &CW3GSMapCheck :: m_MapCRC>,			// map crc
+						CFieldBytes<CW3GSMapCheck, 20, &CW3GSMapCheck :: m_MapSHA1> > W3GSMapCheckSchema;	// map sha1
 
+BYTEARRAY CGameProtocol :: SEND_W3GS_MAPCHECK( string mapPath, BYTEARRAY mapSize, BYTEARRAY mapInfo, BYTEARRAY mapCRC, BYTEARRAY mapSHA1 )
+{
 	BYTEARRAY packet;
 
 	if( !mapPath.empty( ) && mapSize.size( ) == 4 && mapInfo.size( ) == 4 && mapCRC.size( ) == 4 && mapSHA1.size( ) == 20 )
 	{
-		packet.push_back( W3GS_HEADER_CONSTANT );		// W3GS header constant
-		packet.push_back( W3GS_MAPCHECK );				// W3GS_MAPCHECK
-		packet.push_back( 0 );							// packet length will be assigned later
-		packet.push_back( 0 );							// packet length will be assigned later
-		UTIL_AppendByteArray( packet, Unknown, 4 );		// ???
-		UTIL_AppendByteArrayFast( packet, mapPath );	// map path
-		UTIL_AppendByteArrayFast( packet, mapSize );	// map size
-		UTIL_AppendByteArrayFast( packet, mapInfo );	// map info
-		UTIL_AppendByteArrayFast( packet, mapCRC );		// map crc
-		UTIL_AppendByteArrayFast( packet, mapSHA1 );	// map sha1
-		AssignLength( packet );
+		CW3GSMapCheck Packet;
+		Packet.m_MapPath = mapPath;
+		Packet.m_MapSize = mapSize;
+		Packet.m_MapInfo = mapInfo;
+		Packet.m_MapCRC = mapCRC;
+		Packet.m_MapSHA1 = mapSHA1;
+		packet = W3GSMapCheckSchema :: Encode( Packet );
 	}
 	else
 		CONSOLE_Print( "[GAMEPROTO] invalid parameters passed to SEND_W3GS_MAPCHECK" );
@@ -800,40 +999,54 @@ BYTEARRAY CGameProtocol :: SEND_W3GS_MAPCHECK( string mapPath, BYTEARRAY mapSize
 	return packet;
 }
 
-BYTEARRAY CGameProtocol :: SEND_W3GS_STARTDOWNLOAD( unsigned char fromPID )
+// W3GS_STARTDOWNLOAD
+
+class CW3GSStartDownload
 {
-	unsigned char Unknown[] = { 1, 0, 0, 0 };
+public:
+	unsigned char m_FromPID;
+};
 
-	BYTEARRAY packet;
-	packet.push_back( W3GS_HEADER_CONSTANT );				// W3GS header constant
-	packet.push_back( W3GS_STARTDOWNLOAD );					// W3GS_STARTDOWNLOAD
-	packet.push_back( 0 );									// packet length will be assigned later
-	packet.push_back( 0 );									// packet length will be assigned later
-	UTIL_AppendByteArray( packet, Unknown, 4 );				// ???
-	packet.push_back( fromPID );							// from PID
-	AssignLength( packet );
+typedef CPacketSchema<	CFieldHeader<W3GS_HEADER_CONSTANT, CGameProtocol :: W3GS_STARTDOWNLOAD>,
+						CFieldConst32<1>,															// ???
+						CFieldUInt8<CW3GSStartDownload, &CW3GSStartDownload :: m_FromPID> > W3GSStartDownloadSchema;	// from PID
+
+BYTEARRAY CGameProtocol :: SEND_W3GS_STARTDOWNLOAD( unsigned char fromPID )
+{
+	CW3GSStartDownload Packet;
+	Packet.m_FromPID = fromPID;
+	BYTEARRAY packet = W3GSStartDownloadSchema :: Encode( Packet );
 	// DEBUG_Print( "SENT W3GS_STARTDOWNLOAD" );
 	// DEBUG_Print( packet );
 	return packet;
 }
 
-BYTEARRAY CGameProtocol :: SEND_W3GS_MAPPART( unsigned char fromPID, unsigned char toPID, uint32_t start, string *mapData )
+// W3GS_MAPPART
+
+class CW3GSMapPart
 {
-	unsigned char Unknown[] = { 1, 0, 0, 0 };
+public:
+	unsigned char m_ToPID;
+	unsigned char m_FromPID;
+	uint32_t m_Start;
+	uint32_t m_CRC;
+	CPacketBytes m_Data;
+};
+
+typedef CPacketSchema<	CFieldHeader<W3GS_HEADER_CONSTANT, CGameProtocol :: W3GS_MAPPART>,
+						CFieldUInt8<CW3GSMapPart, &CW3GSMapPart :: m_ToPID>,			// to PID
+						CFieldUInt8<CW3GSMapPart, &CW3GSMapPart :: m_FromPID>,			// from PID
+						CFieldConst32<1>,												// ???
+						CFieldUInt32<CW3GSMapPart, &CW3GSMapPart :: m_Start>,			// start position
+						CFieldUInt32<CW3GSMapPart, &CW3GSMapPart :: m_CRC>,				// crc
+						CFieldRaw<CW3GSMapPart, &CW3GSMapPart :: m_Data> > W3GSMapPartSchema;	// map data
 
+BYTEARRAY CGameProtocol :: SEND_W3GS_MAPPART( unsigned char fromPID, unsigned char toPID, uint32_t start, string *mapData )
+{
 	BYTEARRAY packet;
 
 	if( start < mapData->size( ) )
 	{
-		packet.push_back( W3GS_HEADER_CONSTANT );				// W3GS header constant
-		packet.push_back( W3GS_MAPPART );						// W3GS_MAPPART
-		packet.push_back( 0 );									// packet length will be assigned later
-		packet.push_back( 0 );									// packet length will be assigned later
-		packet.push_back( toPID );								// to PID
-		packet.push_back( fromPID );							// from PID
-		UTIL_AppendByteArray( packet, Unknown, 4 );				// ???
-		UTIL_AppendByteArray( packet, start, false );			// start position
-
 		// calculate end position (don't send more than 1442 map bytes in one packet)
 
 		uint32_t End = start + 1442;
@@ -841,16 +1054,15 @@ BYTEARRAY CGameProtocol :: SEND_W3GS_MAPPART( unsigned char fromPID, unsigned ch
 		if( End > mapData->size( ) )
 			End = mapData->size( );
 
-		// calculate crc
+		// the map data is copied straight from the map into the packet
 
-		BYTEARRAY crc32 = UTIL_CreateByteArray( m_GHost->m_CRC->FullCRC( (unsigned char *)mapData->c_str( ) + start, End - start ), false );
-		UTIL_AppendByteArrayFast( packet, crc32 );
-
-		// map data
-
-		BYTEARRAY Data = UTIL_CreateByteArray( (unsigned char *)mapData->c_str( ) + start, End - start );
-		UTIL_AppendByteArrayFast( packet, Data );
-		AssignLength( packet );
+		CW3GSMapPart Packet;
+		Packet.m_ToPID = toPID;
+		Packet.m_FromPID = fromPID;
+		Packet.m_Start = start;
+		Packet.m_Data = CPacketBytes( (const unsigned char *)mapData->data( ) + start, End - start );
+		Packet.m_CRC = m_GHost->m_CRC->FullCRC( (unsigned char *)mapData->data( ) + start, End - start );
+		packet = W3GSMapPartSchema :: Encode( Packet );
 	}
 	else
 		CONSOLE_Print( "[GAMEPROTO] invalid parameters passed to SEND_W3GS_MAPPART" );
@@ -862,41 +1074,7 @@ BYTEARRAY CGameProtocol :: SEND_W3GS_MAPPART( unsigned char fromPID, unsigned ch
 
 BYTEARRAY CGameProtocol :: SEND_W3GS_INCOMING_ACTION2( queue<CIncomingAction *> actions )
 {
-	BYTEARRAY packet;
-	packet.push_back( W3GS_HEADER_CONSTANT );				// W3GS header constant
-	packet.push_back( W3GS_INCOMING_ACTION2 );				// W3GS_INCOMING_ACTION2
-	packet.push_back( 0 );									// packet length will be assigned later
-	packet.push_back( 0 );									// packet length will be assigned later
-	packet.push_back( 0 );									// ??? (send interval?)
-	packet.push_back( 0 );									// ??? (send interval?)
-
-	// create subpacket
-
-	if( !actions.empty( ) )
-	{
-		BYTEARRAY subpacket;
-
-		while( !actions.empty( ) )
-		{
-			CIncomingAction *Action = actions.front( );
-			actions.pop( );
-			subpacket.push_back( Action->GetPID( ) );
-			UTIL_AppendByteArray( subpacket, (uint16_t)Action->GetAction( )->size( ), false );
-			UTIL_AppendByteArrayFast( subpacket, *Action->GetAction( ) );
-		}
-
-		// calculate crc (we only care about the first 2 bytes though)
-
-		BYTEARRAY crc32 = UTIL_CreateByteArray( m_GHost->m_CRC->FullCRC( (unsigned char *)string( subpacket.begin( ), subpacket.end( ) ).c_str( ), subpacket.size( ) ), false );
-		crc32.resize( 2 );
-
-		// finish subpacket
-
-		UTIL_AppendByteArrayFast( packet, crc32 );			// crc
-		UTIL_AppendByteArrayFast( packet, subpacket );		// subpacket
-	}
-
-	AssignLength( packet );
+	BYTEARRAY packet = EncodeIncomingAction<W3GSIncomingAction2Schema>( m_GHost->m_CRC, CPacketNoFields( ), actions );
 	// DEBUG_Print( "SENT W3GS_INCOMING_ACTION2" );
 	// DEBUG_Print( packet );
 	return packet;
@@ -906,41 +1084,36 @@ BYTEARRAY CGameProtocol :: SEND_W3GS_INCOMING_ACTION2( queue<CIncomingAction *>
 // OTHER FUNCTIONS //
 /////////////////////
 
-bool CGameProtocol :: AssignLength( BYTEARRAY &content )
+void CGameProtocol :: SetW3GS_GAMEINFOUpTime( BYTEARRAY &packet, uint32_t upTime )
 {
-	// insert the actual length of the content array into bytes 3 and 4 (indices 2 and 3)
+	// the time since creation is followed by the 2 byte port at the end of the packet (see W3GSGameInfoSchema)
 
-	BYTEARRAY LengthBytes;
-
-	if( content.size( ) >= 4 && content.size( ) <= 65535 )
-	{
-		LengthBytes = UTIL_CreateByteArray( (uint16_t)content.size( ), false );
-		content[2] = LengthBytes[0];
-		content[3] = LengthBytes[1];
-		return true;
-	}
-
-	return false;
+	if( packet.size( ) >= 10 && packet[1] == W3GS_GAMEINFO )
+		PACKET_PutUInt32( &packet[packet.size( ) - 6], upTime );
 }
 
-bool CGameProtocol :: ValidateLength( BYTEARRAY &content )
+unsigned char CGameProtocol :: GetSendLane( BYTEARRAY &data, bool gameStarted )
 {
-	// verify that bytes 3 and 4 (indices 2 and 3) of the content array describe the length
+	// once the game is loading every packet goes in one lane in the order it was sent
+	// every client must see the same packets in the same order (e.g. a player leaving relative to the action packets)
+	// and GProxy++ acknowledges packets by count so the GProxy++ buffer is only right if packets go out on the wire in the order they were buffered
+	// it's the last lane so anything still queued from the lobby goes out first
 
-	uint16_t Length;
-	BYTEARRAY LengthBytes;
+	if( gameStarted )
+		return SEND_LANE_GAME;
 
-	if( content.size( ) >= 4 && content.size( ) <= 65535 )
-	{
-		LengthBytes.push_back( content[2] );
-		LengthBytes.push_back( content[3] );
-		Length = UTIL_ByteArrayToUInt16( LengthBytes, false );
+	if( data.size( ) < 2 || data[0] != W3GS_HEADER_CONSTANT )
+		return SEND_LANE_CONTROL;
 
-		if( Length == content.size( ) )
-			return true;
-	}
+	// in the lobby map data and chat can be overtaken by everything else so a player downloading the map still sees the lobby change immediately
+	// everything else stays in one lane because e.g. the countdown must not arrive before the last slot change
 
-	return false;
+	if( data[1] == W3GS_MAPPART )
+		return SEND_LANE_MAP;
+	else if( data[1] == W3GS_CHAT_FROM_HOST )
+		return SEND_LANE_CHAT;
+
+	return SEND_LANE_LOBBY;
 }
 
 BYTEARRAY CGameProtocol :: EncodeSlotInfo( vector<CGameSlot> &slots, uint32_t randomSeed, unsigned char layoutStyle, unsigned char playerSlots )
@@ -957,7 +1130,6 @@ BYTEARRAY CGameProtocol :: EncodeSlotInfo( vector<CGameSlot> &slots, uint32_t ra
 	return SlotInfo;
 }
 
-//
 // CIncomingJoinPlayer
 //
 
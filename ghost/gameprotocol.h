@@ -144,9 +144,10 @@ public:
 
 	// other functions
 
+	void SetW3GS_GAMEINFOUpTime( BYTEARRAY &packet, uint32_t upTime );
+	static unsigned char GetSendLane( BYTEARRAY &data, bool gameStarted );	// the socket lane to queue a packet to a player in (see SEND_LANE_CONTROL)
+
 private:
-	bool AssignLength( BYTEARRAY &content );
-	bool ValidateLength( BYTEARRAY &content );
 	BYTEARRAY EncodeSlotInfo( vector<CGameSlot> &slots, uint32_t randomSeed, unsigned char layoutStyle, unsigned char playerSlots );
 };
 
@@ -26,7 +26,13 @@
 #include "language.h"
 #include "socket.h"
 #include "ghostdb.h"
+#include "metrics.h"
+#include "timerwheel.h"
+#include "statsworker.h"
+#include "playeridcache.h"
+#include "summarycache.h"
 #include "ghostdbmysql.h"
+#include "bncsutilinterface.h"
 #include "bnet.h"
 #include "map.h"
 #include "packed.h"
@@ -36,9 +42,11 @@
 #include "gpsprotocol.h"
 #include "game_base.h"
 #include "game.h"
+#include "logger.h"
 
 #include <signal.h>
 #include <stdlib.h>
+#include <string.h>
 
 #ifdef WIN32
  #include <ws2tcpip.h>		// for WSAIoctl
@@ -62,10 +70,21 @@
  #include <mach/mach_time.h>
 #endif
 
+// on Linux the next action tick is signalled by a timerfd (see CGHost :: Update)
+
+#ifdef __linux__
+ #define GHOST_TIMERFD
+
+ #include <sys/timerfd.h>
+ #include <unistd.h>
+#endif
+
 string gCFGFile;
 string gLogFile;
 uint32_t gLogMethod;
-ofstream *gLog = NULL;
+uint32_t gLogLevel = LOG_DEBUG;
+set<string> gLogIgnore;
+CLogger *gLogger = NULL;
 CGHost *gGHost = NULL;
 
 uint32_t GetTime( )
@@ -100,6 +119,34 @@ uint32_t GetTicks( )
 #endif
 }
 
+uint64_t GetMicroTicks( )
+{
+#ifdef WIN32
+	// QueryPerformanceCounter isn't guaranteed to be strictly increasing on some systems (see above) but that doesn't matter when measuring short intervals
+
+	static LARGE_INTEGER Frequency = { 0 };
+	LARGE_INTEGER Counter;
+
+	if( Frequency.QuadPart == 0 )
+		QueryPerformanceFrequency( &Frequency );
+
+	QueryPerformanceCounter( &Counter );
+	return (uint64_t)( Counter.QuadPart / ( Frequency.QuadPart / 1000000.0 ) );
+#elif __APPLE__
+	uint64_t current = mach_absolute_time( );
+	static mach_timebase_info_data_t info = { 0, 0 };
+	// get timebase info
+	if( info.denom == 0 )
+		mach_timebase_info( &info );
+	// convert ns to us
+	return current * info.numer / info.denom / 1000;
+#else
+	struct timespec t;
+	clock_gettime( CLOCK_MONOTONIC, &t );
+	return (uint64_t)t.tv_sec * 1000000 + t.tv_nsec / 1000;
+#endif
+}
+
 void SignalCatcher2( int s )
 {
 	CONSOLE_Print( "[!!!] caught signal " + UTIL_ToString( s ) + ", exiting NOW" );
@@ -128,51 +175,46 @@ void SignalCatcher( int s )
 		exit( 1 );
 }
 
-void CONSOLE_Print( string message )
+void LOG_Print( uint32_t level, string message )
 {
-	cout << message << endl;
+	// drop filtered messages as early as possible, before they're written to the console or queued for the log
 
-	// logging
+	if( level > gLogLevel )
+		return;
 
-	if( !gLogFile.empty( ) )
+	if( !gLogIgnore.empty( ) && !message.empty( ) && message[0] == '[' )
 	{
-		if( gLogMethod == 1 )
-		{
-			ofstream Log;
-			Log.open( gLogFile.c_str( ), ios :: app );
+		// the category is the tag at the start of the message, e.g. "[GAME: name] ..." is in the GAME category
 
-			if( !Log.fail( ) )
-			{
-				time_t Now = time( NULL );
-				string Time = asctime( localtime( &Now ) );
+		string :: size_type CategoryEnd = message.find_first_of( ":]", 1 );
 
-				// erase the newline
+		if( CategoryEnd != string :: npos && gLogIgnore.find( message.substr( 1, CategoryEnd - 1 ) ) != gLogIgnore.end( ) )
+			return;
+	}
 
-				Time.erase( Time.size( ) - 1 );
-				Log << "[" << Time << "] " << message << endl;
-				Log.close( );
-			}
-		}
-		else if( gLogMethod == 2 )
-		{
-			if( gLog && !gLog->fail( ) )
-			{
-				time_t Now = time( NULL );
-				string Time = asctime( localtime( &Now ) );
+	cout << message << endl;
 
-				// erase the newline
+	// logging
+	// the log file is written by the logger's own thread so all we need to do here is queue the message
 
-				Time.erase( Time.size( ) - 1 );
-				*gLog << "[" << Time << "] " << message << endl;
-				gLog->flush( );
-			}
-		}
-	}
+	if( gLogger )
+		gLogger->Write( message );
+}
+
+void CONSOLE_Print( string message )
+{
+	LOG_Print( LOG_INFO, message );
 }
 
 void DEBUG_Print( string message )
 {
-	cout << message << endl;
+	// debug messages have always been printed to the console without being logged
+	// keep it that way unless the log level asks for them
+
+	if( gLogLevel >= LOG_TRACE )
+		LOG_Print( LOG_TRACE, message );
+	else
+		cout << message << endl;
 }
 
 void DEBUG_Print( BYTEARRAY b )
@@ -203,23 +245,25 @@ int main( int argc, char **argv )
 	CFG.Read( gCFGFile );
 	gLogFile = CFG.GetString( "bot_log", string( ) );
 	gLogMethod = CFG.GetInt( "bot_logmethod", 1 );
+	gLogLevel = CFG.GetInt( "bot_loglevel", LOG_DEBUG );
+	vector<string> LogIgnore = UTIL_Tokenize( CFG.GetString( "bot_logignore", string( ) ), ' ' );
 
-	if( !gLogFile.empty( ) )
+	for( vector<string> :: iterator i = LogIgnore.begin( ); i != LogIgnore.end( ); i++ )
 	{
-		if( gLogMethod == 1 )
-		{
-			// log method 1: open, append, and close the log for every message
-			// this works well on Linux but poorly on Windows, particularly as the log file grows in size
-			// the log file can be edited/moved/deleted while GHost++ is running
-		}
-		else if( gLogMethod == 2 )
-		{
-			// log method 2: open the log on startup, flush the log for every message, close the log on shutdown
-			// the log file CANNOT be edited/moved/deleted while GHost++ is running
+		transform( (*i).begin( ), (*i).end( ), (*i).begin( ), (int(*)(int))toupper );
+		gLogIgnore.insert( *i );
+	}
 
-			gLog = new ofstream( );
-			gLog->open( gLogFile.c_str( ), ios :: app );
-		}
+	if( !gLogFile.empty( ) && ( gLogMethod == 1 || gLogMethod == 2 ) )
+	{
+		// log method 1: open, append, and close the log for every batch of messages
+		// this works well on Linux but poorly on Windows, particularly as the log file grows in size
+		// the log file can be edited/moved/deleted while GHost++ is running
+		// log method 2: open the log on startup, flush the log for every batch of messages, close the log on shutdown
+		// the log file CANNOT be edited/moved/deleted while GHost++ is running
+		// in both cases the file I/O happens on the logger's thread and never blocks the main loop
+
+		gLogger = new CLogger( gLogFile, gLogMethod, CFG.GetInt( "bot_logmaxsize", 0 ) * 1024, CFG.GetInt( "bot_logbackups", 5 ), CFG.GetInt( "bot_logqueuesize", 8192 ) );
 	}
 
 	CONSOLE_Print( "[GHOST] starting up" );
@@ -230,8 +274,12 @@ int main( int argc, char **argv )
 			CONSOLE_Print( "[GHOST] using log method 1, logging is enabled and [" + gLogFile + "] will not be locked" );
 		else if( gLogMethod == 2 )
 		{
-			if( gLog->fail( ) )
+			if( gLogger->GetFailed( ) )
+			{
 				CONSOLE_Print( "[GHOST] using log method 2 but unable to open [" + gLogFile + "] for appending, logging is disabled" );
+				delete gLogger;
+				gLogger = NULL;
+			}
 			else
 				CONSOLE_Print( "[GHOST] using log method 2, logging is enabled and [" + gLogFile + "] is now locked" );
 		}
@@ -334,12 +382,13 @@ int main( int argc, char **argv )
 	timeEndPeriod( TimerResolution );
 #endif
 
-	if( gLog )
-	{
-		if( !gLog->fail( ) )
-			gLog->close( );
+	// shutdown the logger (this writes any messages still in the queue)
 
-		delete gLog;
+	if( gLogger )
+	{
+		CLogger *Logger = gLogger;
+		gLogger = NULL;
+		delete Logger;
 	}
 
 	return 0;
@@ -356,6 +405,18 @@ CGHost :: CGHost( CConfig *CFG )
 	m_CRC = new CCRC32( );
 	m_CRC->Initialize( );
 	m_SHA = new CSHA1( );
+#ifdef GHOST_TIMERFD
+	m_ActionTimer = timerfd_create( CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC );
+
+	if( m_ActionTimer == -1 )
+		CONSOLE_Print( "[GHOST] error creating action timer, falling back to select timeouts" );
+#else
+	m_ActionTimer = -1;
+#endif
+
+	m_ActionTimerDeadline = 0;
+	m_Timers = new CTimerWheel( GetTicks( ) );
+	m_CheckRevisionCache = new CCheckRevisionCache( CFG->GetString( "bot_checkrevisioncache", "checkrevision.txt" ) );
 	m_CurrentGame = NULL;
     m_CallableGetGameId = NULL;
     m_CallableGetBotConfig = NULL;
@@ -363,9 +424,29 @@ CGHost :: CGHost( CConfig *CFG )
     m_CallableGetLanguages = NULL;
     m_NewGameId = 0;
     m_LastGameIdUpdate = GetTime( );
+	m_Metrics = new CMetrics( );
+	m_MetricsFile = CFG->GetString( "bot_metricsfile", string( ) );
+	m_MetricsInterval = CFG->GetInt( "bot_metricsinterval", 10 );
+	m_LastMetricsTime = GetTime( );
+	m_BNETFloodRate = CFG->GetInt( "bot_bnetfloodrate", 36 );
+	m_BNETFloodBurst = CFG->GetInt( "bot_bnetfloodburst", 60 );
+	m_BNETFloodOverhead = CFG->GetInt( "bot_bnetfloodoverhead", 25 );
+	m_MaxSendQueue = CFG->GetInt( "bot_maxsendqueue", 131072 );
+	m_DotAElo = CFG->GetInt( "bot_dotaelo", 1 ) == 0 ? false : true;
+	m_CheckSumLogPath = UTIL_AddPathSeperator( CFG->GetString( "bot_checksumlogpath", string( ) ) );
+	m_LanguageCode = CFG->GetString( "bot_languagecode", string( ) );
+
+	if( CFG->GetInt( "bot_statsworker", 1 ) == 0 )
+		m_StatsWorker = NULL;
+	else
+		m_StatsWorker = new CStatsWorker( );
+
 	CONSOLE_Print( "[GHOST] opening primary database" );
 
     m_DB = new CGHostDBMySQL( CFG );
+	m_DB->AddMetrics( m_Metrics );
+	m_PlayerIdCache = new CPlayerIdCache( this, CFG->GetInt( "bot_playeridcachesize", 10000 ) );
+	m_SummaryCache = new CSummaryCache( this, CFG->GetInt( "bot_statscachettl", 60 ) );
     
     /* load configs */
     m_CallableGetBotConfig = m_DB->ThreadedGetBotConfigs( );
@@ -446,6 +527,9 @@ CGHost :: CGHost( CConfig *CFG )
 	m_AutoHostMaximumScore = 0.0;
 	m_AllGamesFinished = false;
 	m_AllGamesFinishedTime = 0;
+	m_AdaptiveLatency = CFG->GetInt( "bot_adaptivelatency", 0 ) == 0 ? false : true;
+	m_MinLatency = CFG->GetInt( "bot_minlatency", 50 );
+	m_MaxLatency = CFG->GetInt( "bot_maxlatency", 200 );
 
 	if( m_TFT )
 		CONSOLE_Print( "[GHOST] acting as Warcraft III: The Frozen Throne" );
@@ -460,6 +544,11 @@ CGHost :: CGHost( CConfig *CFG )
 
 CGHost :: ~CGHost( )
 {
+#ifdef GHOST_TIMERFD
+	if( m_ActionTimer != -1 )
+		close( m_ActionTimer );
+#endif
+
 	delete m_UDPSocket;
 	delete m_ReconnectSocket;
 
@@ -473,12 +562,18 @@ CGHost :: ~CGHost( )
 	for( vector<CBNET *> :: iterator i = m_BNETs.begin( ); i != m_BNETs.end( ); i++ )
 		delete *i;
 
+	delete m_CheckRevisionCache;
 	delete m_CurrentGame;
 
 	for( vector<CBaseGame *> :: iterator i = m_Games.begin( ); i != m_Games.end( ); i++ )
 		delete *i;
 
+	delete m_StatsWorker;
+	delete m_PlayerIdCache;
+	delete m_SummaryCache;
 	delete m_DB;
+	delete m_Metrics;
+	delete m_Timers;
 
 	// warning: we don't delete any entries of m_Callables here because we can't be guaranteed that the associated threads have terminated
 	// this is fine if the program is currently exiting because the OS will clean up after us
@@ -529,13 +624,13 @@ bool CGHost :: Update( long usecBlock )
 			if( !m_AllGamesFinished )
 			{
 				CONSOLE_Print( "[GHOST] all games finished, waiting 60 seconds for threads to finish" );
-				CONSOLE_Print( "[GHOST] there are " + UTIL_ToString( m_Callables.size( ) ) + " threads in progress" );
+				CONSOLE_Print( "[GHOST] there are " + UTIL_ToString( m_Callables.size( ) + m_SummaryCache->GetNumWrites( ) ) + " threads in progress" );
 				m_AllGamesFinished = true;
 				m_AllGamesFinishedTime = GetTime( );
 			}
 			else
 			{
-				if( m_Callables.empty( ) )
+				if( m_Callables.empty( ) && m_SummaryCache->GetNumWrites( ) == 0 )
 				{
 					CONSOLE_Print( "[GHOST] all threads finished, exiting nicely" );
 					m_Exiting = true;
@@ -543,13 +638,21 @@ bool CGHost :: Update( long usecBlock )
 				else if( GetTime( ) - m_AllGamesFinishedTime >= 60 )
 				{
 					CONSOLE_Print( "[GHOST] waited 60 seconds for threads to finish, exiting anyway" );
-					CONSOLE_Print( "[GHOST] there are " + UTIL_ToString( m_Callables.size( ) ) + " threads still in progress which will be terminated" );
+					CONSOLE_Print( "[GHOST] there are " + UTIL_ToString( m_Callables.size( ) + m_SummaryCache->GetNumWrites( ) ) + " threads still in progress which will be terminated" );
 					m_Exiting = true;
 				}
 			}
 		}
 	}
 
+	// update player ids
+
+	m_PlayerIdCache->Update( );
+
+	// update player summaries
+
+	m_SummaryCache->Update( );
+
 	// update callables
 
 	for( vector<CBaseCallable *> :: iterator i = m_Callables.begin( ); i != m_Callables.end( ); )
@@ -635,19 +738,69 @@ bool CGHost :: Update( long usecBlock )
 	// however, in an effort to make game updates happen closer to the desired latency setting we now use a dynamic block interval
 	// note: we still use the passed usecBlock as a hard maximum
 
+	uint64_t NextActionMicroTicks = usecBlock;
+
 	for( vector<CBaseGame *> :: iterator i = m_Games.begin( ); i != m_Games.end( ); i++ )
-	{
-		if( (*i)->GetNextTimedActionTicks( ) * 1000 < usecBlock )
-			usecBlock = (*i)->GetNextTimedActionTicks( ) * 1000;
-	}
+		NextActionMicroTicks = min( NextActionMicroTicks, (*i)->GetNextTimedActionMicroTicks( ) );
 
-	// always block for at least 1ms just in case something goes wrong
+	// always wait for at least 0.1ms just in case something goes wrong
 	// this prevents the bot from sucking up all the available CPU if a game keeps asking for immediate updates
 	// it's a bit ridiculous to include this check since, in theory, the bot is programmed well enough to never make this mistake
 	// however, considering who programmed it, it's worthwhile to do it anyway
+	// note: this used to be 1ms but waking up a whole millisecond late is most of the action jitter we were trying to get rid of
 
-	if( usecBlock < 1000 )
-		usecBlock = 1000;
+	if( NextActionMicroTicks < 100 )
+		NextActionMicroTicks = 100;
+
+#ifdef GHOST_TIMERFD
+	if( m_ActionTimer != -1 )
+	{
+		// the timer is armed with an absolute CLOCK_MONOTONIC deadline (the same clock as GetMicroTicks) and wakes up select by becoming readable
+		// unlike a select timeout the deadline doesn't drift by the time spent between calculating it and blocking, and it's only rearmed when it changes
+		// if no game is waiting to send actions it's disarmed and we block for usecBlock
+
+		uint64_t Deadline = 0;
+
+		if( NextActionMicroTicks < (uint64_t)usecBlock )
+			Deadline = GetMicroTicks( ) + NextActionMicroTicks;
+
+		if( Deadline != m_ActionTimerDeadline )
+		{
+			struct itimerspec Timer;
+			memset( &Timer, 0, sizeof( Timer ) );
+			Timer.it_value.tv_sec = Deadline / 1000000;
+			Timer.it_value.tv_nsec = ( Deadline % 1000000 ) * 1000;
+			timerfd_settime( m_ActionTimer, TFD_TIMER_ABSTIME, &Timer, NULL );
+			m_ActionTimerDeadline = Deadline;
+		}
+
+		if( Deadline != 0 )
+		{
+			FD_SET( m_ActionTimer, &fd );
+
+			if( m_ActionTimer > nfds )
+				nfds = m_ActionTimer;
+		}
+	}
+	else
+		usecBlock = NextActionMicroTicks;
+#else
+	usecBlock = NextActionMicroTicks;
+#endif
+
+	// wake up in time for the next periodic timer as well
+	// the wheel's clock is from the start of this loop iteration so subtract the time that has passed since then
+
+	uint32_t TimerTicks;
+
+	if( m_Timers->GetTicksUntilNext( &TimerTicks ) )
+	{
+		uint32_t Elapsed = GetTicks( ) - m_Timers->GetTicks( );
+		uint64_t TimerMicroTicks = TimerTicks > Elapsed ? (uint64_t)( TimerTicks - Elapsed ) * 1000 : 100;
+
+		if( TimerMicroTicks < (uint64_t)usecBlock )
+			usecBlock = TimerMicroTicks;
+	}
 
 	struct timeval tv;
 	tv.tv_sec = 0;
@@ -665,6 +818,20 @@ bool CGHost :: Update( long usecBlock )
 	select( nfds + 1, NULL, &send_fd, NULL, &send_tv );
 #endif
 
+#ifdef GHOST_TIMERFD
+	if( m_ActionTimer != -1 && FD_ISSET( m_ActionTimer, &fd ) )
+	{
+		// the timer is one shot so it's disarmed now, make sure we arm it again even if the next deadline is the same
+
+		uint64_t Expirations;
+
+		if( read( m_ActionTimer, &Expirations, sizeof( Expirations ) ) != sizeof( Expirations ) )
+			CONSOLE_Print( "[GHOST] error reading action timer" );
+
+		m_ActionTimerDeadline = 0;
+	}
+#endif
+
 	if( NumFDs == 0 )
 	{
 		// we don't have any sockets (i.e. we aren't connected to battle.net maybe due to a lost connection and there aren't any games running)
@@ -673,6 +840,12 @@ bool CGHost :: Update( long usecBlock )
 		MILLISLEEP( 50 );
 	}
 
+	// read the clock once for the rest of this loop iteration and mark the timers which are due now
+	// the games' periodic tasks (pings, refreshes, map parts, etc...) check their timers instead of reading the clock themselves and schedule them relative to this cached clock
+	// the action ticks still read the clock directly because they need to be sent as close to the latency as possible
+
+	m_Timers->Advance( GetTicks( ) );
+
 	bool AdminExit = false;
 	bool BNETExit = false;
 
@@ -767,21 +940,7 @@ bool CGHost :: Update( long usecBlock )
 
 							// look for a matching player in a running game
 
-							CGamePlayer *Match = NULL;
-
-							for( vector<CBaseGame *> :: iterator j = m_Games.begin( ); j != m_Games.end( ); j++ )
-							{
-								if( (*j)->GetGameLoaded( ) )
-								{
-									CGamePlayer *Player = (*j)->GetPlayerFromPID( PID );
-
-									if( Player && Player->GetGProxy( ) && Player->GetGProxyReconnectKey( ) == ReconnectKey )
-									{
-										Match = Player;
-										break;
-									}
-								}
-							}
+							CGamePlayer *Match = GetGProxyPlayer( PID, ReconnectKey );
 
 							if( Match )
 							{
@@ -905,6 +1064,18 @@ bool CGHost :: Update( long usecBlock )
 		m_LastAutoHostTime = GetTime( );
 	}
     
+	// write a metrics snapshot
+
+	if( !m_MetricsFile.empty( ) && GetTime( ) - m_LastMetricsTime >= m_MetricsInterval )
+	{
+		m_DB->UpdateMetrics( );
+
+		if( !m_Metrics->WriteSnapshot( m_MetricsFile ) )
+			CONSOLE_Print( "[GHOST] warning - unable to write metrics snapshot to [" + m_MetricsFile + "]" );
+
+		m_LastMetricsTime = GetTime( );
+	}
+
     // load a new gameid
     if( m_NewGameId == 0 && m_LastGameIdUpdate != 0 && GetTime( ) - m_LastGameIdUpdate >= 5 )
     {
@@ -941,6 +1112,7 @@ bool CGHost :: Update( long usecBlock )
 
     if( m_CallableGetLanguages && m_CallableGetLanguages->GetReady( )) {
         m_Translations = m_CallableGetLanguages->GetResult( );
+        ApplyTranslations( );
         
         m_DB->RecoverCallable( m_CallableGetLanguages );
         delete m_CallableGetLanguages;
@@ -961,6 +1133,14 @@ bool CGHost :: Update( long usecBlock )
     if( m_CallableAdminLists && m_CallableAdminLists->GetReady( )) {
         m_AdminList = m_CallableAdminLists->GetResult( );
         CONSOLE_Print("[OHSystem] Loaded " + UTIL_ToString(m_AdminList.size()) + " users.");
+
+        // the players' admin levels are only resolved when they join so update everyone who is already in a game
+
+        if( m_CurrentGame )
+            m_CurrentGame->UpdateAdminLevels( );
+
+        for( vector<CBaseGame *> :: iterator i = m_Games.begin( ); i != m_Games.end( ); i++ )
+            (*i)->UpdateAdminLevels( );
         
         m_DB->RecoverCallable( m_CallableAdminLists );
         delete m_CallableAdminLists;
@@ -1057,6 +1237,42 @@ void CGHost :: EventGameDeleted( CBaseGame *game )
 	}
 }
 
+void CGHost :: AddGProxyPlayer( CGamePlayer *player )
+{
+	RemoveGProxyPlayer( player );
+	m_GProxyPlayers.insert( make_pair( ( (uint64_t)player->GetPID( ) << 32 ) | player->GetGProxyReconnectKey( ), player ) );
+}
+
+void CGHost :: RemoveGProxyPlayer( CGamePlayer *player )
+{
+	uint64_t Key = ( (uint64_t)player->GetPID( ) << 32 ) | player->GetGProxyReconnectKey( );
+
+	for( multimap<uint64_t, CGamePlayer *> :: iterator i = m_GProxyPlayers.lower_bound( Key ); i != m_GProxyPlayers.end( ) && i->first == Key; i++ )
+	{
+		if( i->second == player )
+		{
+			m_GProxyPlayers.erase( i );
+			return;
+		}
+	}
+}
+
+CGamePlayer *CGHost :: GetGProxyPlayer( unsigned char PID, uint32_t reconnectKey )
+{
+	// the reconnect key is just the time the player joined so two players in different games could have the same PID and key (but it's very unlikely)
+	// we only match players in a running game who haven't been kicked, i.e. players the game would still find with GetPlayerFromPID
+
+	uint64_t Key = ( (uint64_t)PID << 32 ) | reconnectKey;
+
+	for( multimap<uint64_t, CGamePlayer *> :: iterator i = m_GProxyPlayers.lower_bound( Key ); i != m_GProxyPlayers.end( ) && i->first == Key; i++ )
+	{
+		if( i->second->m_Game->GetGameLoaded( ) && i->second->m_Game->GetPlayerFromPID( PID ) == i->second )
+			return i->second;
+	}
+
+	return NULL;
+}
+
 void CGHost :: ReloadConfigs( )
 {
     m_CallableGetBotConfig = m_DB->ThreadedGetBotConfigs( );
@@ -1294,6 +1510,8 @@ void CGHost :: ParseConfigValues( map<string, string> configs )
         if(iterator->first == "bot_language") {
             delete m_Language;
             m_Language = new CLanguage( iterator->second );
+        } else if(iterator->first == "bot_languagecode") {
+            m_LanguageCode = iterator->second;
         } else if(iterator->first == "bot_tft") {
             m_TFT = UTIL_ToUInt32(iterator->second);
         } else if(iterator->first == "bot_bindaddress") {
@@ -1364,6 +1582,12 @@ void CGHost :: ParseConfigValues( map<string, string> configs )
             m_Latency = UTIL_ToUInt32(iterator->second);
         } else if(iterator->first == "bot_synclimit") {
             m_SyncLimit = UTIL_ToUInt32(iterator->second);
+        } else if(iterator->first == "bot_adaptivelatency") {
+            m_AdaptiveLatency = UTIL_ToUInt32(iterator->second);
+        } else if(iterator->first == "bot_minlatency") {
+            m_MinLatency = UTIL_ToUInt32(iterator->second);
+        } else if(iterator->first == "bot_maxlatency") {
+            m_MaxLatency = UTIL_ToUInt32(iterator->second);
         } else if(iterator->first == "bot_votekickallowed") {
             m_VoteKickAllowed = UTIL_ToUInt32(iterator->second);
         } else if(iterator->first == "bot_votekickpercentage") {
@@ -1404,6 +1628,9 @@ void CGHost :: ParseConfigValues( map<string, string> configs )
         }
     }
     
+    // the language may have been reloaded or the language code may have changed
+
+    ApplyTranslations( );
     ConnectToBNets( );
     
     if(! m_CurrentGame) {
@@ -1413,6 +1640,30 @@ void CGHost :: ParseConfigValues( map<string, string> configs )
     }
 }
 
+void CGHost :: ApplyTranslations( )
+{
+	if( !m_Language || m_LanguageCode.empty( ) )
+		return;
+
+	map<string, map<uint32_t, string> > :: iterator i = m_Translations.find( m_LanguageCode );
+
+	if( i != m_Translations.end( ) )
+		m_Language->SetTranslations( i->second );
+	else
+		m_Language->SetTranslations( map<uint32_t, string>( ) );
+}
+
+uint32_t CGHost :: GetAdminLevel( string name )
+{
+	transform( name.begin( ), name.end( ), name.begin( ), (int(*)(int))tolower );
+	map<string, uint32_t> :: iterator i = m_AdminList.find( name );
+
+	if( i != m_AdminList.end( ) )
+		return i->second;
+
+	return 0;
+}
+
 void CGHost :: ParseConfigTexts( map<string, vector<string>> texts )
 {
     typedef map<string, vector<string>>::iterator text_iterator;
@@ -34,10 +34,17 @@ class CGPSProtocol;
 class CCRC32;
 class CSHA1;
 class CBNET;
+class CCheckRevisionCache;
+class CPlayerIdCache;
+class CSummaryCache;
 class CBaseGame;
+class CGamePlayer;
 class CGHostDB;
 class CBaseCallable;
 class CLanguage;
+class CMetrics;
+class CTimerWheel;
+class CStatsWorker;
 class CMap;
 class CSaveGame;
 class CConfig;
@@ -55,14 +62,23 @@ public:
 	CUDPSocket *m_UDPSocket;				// a UDP socket for sending broadcasts and other junk (used with !sendlan)
 	CTCPServer *m_ReconnectSocket;			// listening socket for GProxy++ reliable reconnects
 	vector<CTCPSocket *> m_ReconnectSockets;// vector of sockets attempting to reconnect (connected but not identified yet)
+	int m_ActionTimer;						// a timerfd armed with the deadline of the next action tick (-1 if not available)
+	uint64_t m_ActionTimerDeadline;			// the GetMicroTicks deadline m_ActionTimer is armed with (0 = disarmed)
+	CTimerWheel *m_Timers;					// the periodic timers of every game (pings, refreshes, map parts, etc...) and the clock cached once per loop iteration
+	multimap<uint64_t, CGamePlayer *> m_GProxyPlayers;	// every player using GProxy++ by ( PID << 32 ) | reconnect key so reconnecting players are found without searching every game
 	CGPSProtocol *m_GPSProtocol;
 	CCRC32 *m_CRC;							// for calculating CRC's
 	CSHA1 *m_SHA;							// for calculating SHA1's
 	vector<CBNET *> m_BNETs;				// all our battle.net connections (there can be more than one)
+	CCheckRevisionCache *m_CheckRevisionCache;	// cached revision check results shared by every battle.net connection
 	CBaseGame *m_CurrentGame;				// this game is still in the lobby state
 	vector<CBaseGame *> m_Games;			// these games are in progress
 	CGHostDB *m_DB;							// database
 	CGHostDB *m_DBLocal;					// local database (for temporary data)
+	CMetrics *m_Metrics;					// instrumentation registry
+	CStatsWorker *m_StatsWorker;			// the thread that processes game stats off the main thread (NULL = process them on the main thread)
+	CPlayerIdCache *m_PlayerIdCache;		// the player ids of recently seen players and the player id lookups in progress
+	CSummaryCache *m_SummaryCache;			// the recently requested player summaries (!stats and !statsdota) and the queries in progress
     CCallableGetGameId *m_CallableGetGameId;
     CCallableGetBotConfigs *m_CallableGetBotConfig;
     CCallableGetBotConfigTexts *m_CallableGetBotConfigText;
@@ -95,6 +111,15 @@ public:
 	uint32_t m_AllGamesFinishedTime;		// GetTime when all games finished (used when exiting nicely)
 	string m_LanguageFile;					// config value: language file
 	string m_Warcraft3Path;					// config value: Warcraft 3 path
+	string m_MetricsFile;					// config value: file to write metrics snapshots to (empty = disabled)
+	uint32_t m_MetricsInterval;				// config value: how often to write a metrics snapshot (in seconds)
+	uint32_t m_LastMetricsTime;				// GetTime when the last metrics snapshot was written
+	uint32_t m_BNETFloodRate;				// config value: how many bytes per second we can send to battle.net without being kicked for flooding
+	uint32_t m_BNETFloodBurst;				// config value: how many bytes we can send to battle.net at once after being idle
+	uint32_t m_BNETFloodOverhead;			// config value: how many bytes each packet costs on top of its size for flood control
+	uint32_t m_MaxSendQueue;				// config value: only send more map data to a player while fewer than this many bytes are waiting to be sent to them
+	bool m_DotAElo;							// config value: update the dota elo ratings of the players when a dota game ends
+	string m_CheckSumLogPath;				// config value: path to write the checksum log of desynced games to (empty = disabled)
 	bool m_TFT;								// config value: TFT enabled or not
 	string m_BindAddress;					// config value: the address to host games on
 	uint16_t m_HostPort;					// config value: the port to host games on
@@ -128,6 +153,9 @@ public:
 	uint32_t m_LobbyTimeLimit;				// config value: auto close the game lobby after this many minutes without any reserved players
 	uint32_t m_Latency;						// config value: the latency (by default)
 	uint32_t m_SyncLimit;					// config value: the maximum number of packets a player can fall out of sync before starting the lag screen (by default)
+	bool m_AdaptiveLatency;					// config value: adjust the latency of each game automatically between m_MinLatency and m_MaxLatency
+	uint32_t m_MinLatency;					// config value: the minimum adaptive latency
+	uint32_t m_MaxLatency;					// config value: the maximum adaptive latency
 	bool m_VoteKickAllowed;					// config value: if votekicks are allowed or not
 	uint32_t m_VoteKickPercentage;			// config value: percentage of players required to vote yes for a votekick to pass
 	string m_DefaultMap;					// config value: default map (map.cfg)
@@ -143,6 +171,7 @@ public:
     vector<string> m_GameOver;
     map<int, map<string, string>> m_BNetCollection;
     map<string, map<uint32_t, string>> m_Translations;
+	string m_LanguageCode;					// config value: the language code of the database translations to use instead of the language file's messages (empty = none)
     map<string, uint32_t> m_AdminList;
     map<uint32_t, string> m_Aliases;
     uint32_t m_AliasId;
@@ -171,6 +200,9 @@ public:
 	// other functions
 
 	void ExtractScripts( );
+	void AddGProxyPlayer( CGamePlayer *player );
+	void RemoveGProxyPlayer( CGamePlayer *player );
+	CGamePlayer *GetGProxyPlayer( unsigned char PID, uint32_t reconnectKey );
     void ReloadConfigs( );
 	void CreateGame( CMap *map, unsigned char gameState, bool saveGame, string gameName, string ownerName, string creatorName, string creatorServer, bool whisper );
     
@@ -178,6 +210,8 @@ public:
     
     void ParseConfigValues( map<string, string> configs );
     void ParseConfigTexts( map<string, vector<string>> texts );
+	void ApplyTranslations( );
+	uint32_t GetAdminLevel( string name );
     void ConnectToBNets( );
 };
 
@@ -319,6 +319,11 @@ CCallableDotAPlayerSummaryCheck *CGHostDB :: ThreadedDotAPlayerSummaryCheck( str
 	return NULL;
 }
 
+CCallableDotAEloUpdate *CGHostDB :: ThreadedDotAEloUpdate( uint32_t, uint32_t, vector<string>, vector<string>, vector<uint32_t> )
+{
+	return NULL;
+}
+
 CCallableDownloadAdd *CGHostDB :: ThreadedDownloadAdd( string map, uint32_t mapsize, string name, string ip, uint32_t spoofed, string spoofedrealm, uint32_t downloadtime )
 {
 	return NULL;
@@ -394,6 +399,11 @@ CCallableGetAliases *CGHostDB :: ThreadedGetAliases( )
 	return NULL;
 }
 
+CCallableGetRecentPlayerIds *CGHostDB :: ThreadedGetRecentPlayerIds( uint32_t )
+{
+	return NULL;
+}
+
 //
 // Callables
 //
@@ -484,6 +494,11 @@ CCallableDotAPlayerAdd :: ~CCallableDotAPlayerAdd( )
 
 }
 
+CCallableDotAEloUpdate :: ~CCallableDotAEloUpdate( )
+{
+
+}
+
 CCallableDotAPlayerSummaryCheck :: ~CCallableDotAPlayerSummaryCheck( )
 {
 	delete m_Result;
@@ -554,6 +569,11 @@ CCallableGetAliases :: ~CCallableGetAliases( )
 
 }
 
+CCallableGetRecentPlayerIds :: ~CCallableGetRecentPlayerIds( )
+{
+
+}
+
 //
 // CDBBan
 //
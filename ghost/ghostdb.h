@@ -25,6 +25,7 @@
 // CGHostDB
 //
 
+class CMetrics;
 class CBaseCallable;
 class CCallableAdminCount;
 class CCallableAdminCheck;
@@ -42,6 +43,7 @@ class CCallableGamePlayerSummaryCheck;
 class CCallableDotAGameAdd;
 class CCallableDotAPlayerAdd;
 class CCallableDotAPlayerSummaryCheck;
+class CCallableDotAEloUpdate;
 class CCallableDownloadAdd;
 class CCallableScoreCheck;
 class CCallableW3MMDPlayerAdd;
@@ -55,6 +57,7 @@ class CCallableGetLanguages;
 class CCallableGetMapConfig;
 class CCallableGameUpdate;
 class CCallableGetAliases;
+class CCallableGetRecentPlayerIds;
 class CDBBan;
 class CDBGame;
 class CDBGamePlayer;
@@ -63,6 +66,7 @@ class CDBDotAPlayerSummary;
 struct PlayerOfPlayerList;
 
 typedef pair<uint32_t,string> VarP;
+typedef pair<string,uint32_t> PlayerIdP;
 
 class CGHostDB
 {
@@ -77,6 +81,8 @@ public:
 	bool HasError( )			{ return m_HasError; }
 	string GetError( )			{ return m_Error; }
 	virtual string GetStatus( )	{ return "DB STATUS --- OK"; }
+	virtual void AddMetrics( CMetrics * ) { }
+	virtual void UpdateMetrics( ) { }
 
 	virtual void RecoverCallable( CBaseCallable *callable );
 
@@ -140,6 +146,7 @@ public:
 	virtual CCallableDotAGameAdd *ThreadedDotAGameAdd( uint32_t gameid, uint32_t winner, uint32_t min, uint32_t sec );
 	virtual CCallableDotAPlayerAdd *ThreadedDotAPlayerAdd( uint32_t gameid, uint32_t colour, uint32_t kills, uint32_t deaths, uint32_t creepkills, uint32_t creepdenies, uint32_t assists, uint32_t gold, uint32_t neutralkills, string item1, string item2, string item3, string item4, string item5, string item6, string hero, uint32_t newcolour, uint32_t towerkills, uint32_t raxkills, uint32_t courierkills );
 	virtual CCallableDotAPlayerSummaryCheck *ThreadedDotAPlayerSummaryCheck( string name );
+	virtual CCallableDotAEloUpdate *ThreadedDotAEloUpdate( uint32_t gameid, uint32_t winner, vector<string> names, vector<string> servers, vector<uint32_t> teams );
 	virtual CCallableDownloadAdd *ThreadedDownloadAdd( string map, uint32_t mapsize, string name, string ip, uint32_t spoofed, string spoofedrealm, uint32_t downloadtime );
 	virtual CCallableScoreCheck *ThreadedScoreCheck( string category, string name, string server );
 	virtual CCallableW3MMDPlayerAdd *ThreadedW3MMDPlayerAdd( string category, uint32_t gameid, uint32_t pid, string name, string flag, uint32_t leaver, uint32_t practicing );
@@ -155,6 +162,7 @@ public:
     virtual CCallableGetMapConfig *ThreadedGetMapConfig( string configname );
     virtual CCallableGameUpdate *ThreadedGameUpdate( uint32_t hostcounter, uint32_t lobby, string map_type, uint32_t duration, string gamename, string ownername, string creatorname, string map, uint32_t players, uint32_t total, vector<PlayerOfPlayerList> playerlist );
     virtual CCallableGetAliases *ThreadedGetAliases( );
+	virtual CCallableGetRecentPlayerIds *ThreadedGetRecentPlayerIds( uint32_t count );
 };
 
 //
@@ -486,6 +494,24 @@ public:
 	virtual void SetResult( uint32_t nResult )	{ m_Result = nResult; }
 };
 
+class CCallableDotAEloUpdate : virtual public CBaseCallable
+{
+protected:
+	uint32_t m_GameID;
+	uint32_t m_Winner;				// 1 = sentinel, 2 = scourge
+	vector<string> m_Names;
+	vector<string> m_Servers;
+	vector<uint32_t> m_Teams;		// 0 = sentinel, 1 = scourge
+	bool m_Result;
+
+public:
+	CCallableDotAEloUpdate( uint32_t nGameID, uint32_t nWinner, vector<string> nNames, vector<string> nServers, vector<uint32_t> nTeams ) : CBaseCallable( ), m_GameID( nGameID ), m_Winner( nWinner ), m_Names( nNames ), m_Servers( nServers ), m_Teams( nTeams ), m_Result( false ) { }
+	virtual ~CCallableDotAEloUpdate( );
+
+	virtual bool GetResult( )				{ return m_Result; }
+	virtual void SetResult( bool nResult )	{ m_Result = nResult; }
+};
+
 class CCallableDotAPlayerSummaryCheck : virtual public CBaseCallable
 {
 protected:
@@ -725,6 +751,20 @@ public:
 	virtual void SetResult( map<uint32_t, string> nResult )	{ m_Result = nResult; }
 };
 
+class CCallableGetRecentPlayerIds : virtual public CBaseCallable
+{
+protected:
+	uint32_t m_Count;
+	vector<PlayerIdP> m_Result;		// lowercase name -> player id, most recent player first
+
+public:
+	CCallableGetRecentPlayerIds( uint32_t nCount ) : CBaseCallable( ), m_Count( nCount ) { }
+	virtual ~CCallableGetRecentPlayerIds( );
+
+	virtual vector<PlayerIdP> GetResult( )				{ return m_Result; }
+	virtual void SetResult( vector<PlayerIdP> nResult )	{ m_Result = nResult; }
+};
+
 //
 // CDBBan
 //
@@ -24,9 +24,12 @@
 #include "util.h"
 #include "config.h"
 #include "ghostdb.h"
+#include "metrics.h"
 #include "ghostdbmysql.h"
+#include "../update_dota_elo/elo.h"
 
 #include <signal.h>
+#include <string.h>
 
 #ifdef WIN32
  #include <winsock.h>
@@ -86,6 +89,7 @@ CGHostDBMySQL :: ~CGHostDBMySQL( )
 
 	while( !m_IdleConnections.empty( ) )
 	{
+		MySQLCloseStatements( m_IdleConnections.front( ) );
 		mysql_close( (MYSQL *)m_IdleConnections.front( ) );
 		m_IdleConnections.pop( );
 	}
@@ -98,7 +102,23 @@ CGHostDBMySQL :: ~CGHostDBMySQL( )
 
 string CGHostDBMySQL :: GetStatus( )
 {
-	return "DB STATUS --- Connections: " + UTIL_ToString( m_IdleConnections.size( ) ) + "/" + UTIL_ToString( m_NumConnections ) + " idle. Outstanding callables: " + UTIL_ToString( m_OutstandingCallables ) + ".";
+	return "DB STATUS --- Connections: " + UTIL_ToString( m_IdleConnections.size( ) ) + "/" + UTIL_ToString( m_NumConnections ) + " idle. Outstanding callables: " + UTIL_ToString( m_OutstandingCallables ) + ". Callable time (p50/p99/max): " + UTIL_ToString( m_CallableMilliseconds.GetPercentile( 0.5 ) ) + "/" + UTIL_ToString( m_CallableMilliseconds.GetPercentile( 0.99 ) ) + "/" + UTIL_ToString( m_CallableMilliseconds.GetMax( ) ) + "ms.";
+}
+
+void CGHostDBMySQL :: AddMetrics( CMetrics *metrics )
+{
+	metrics->AddHistogram( this, "ghost_db_callable_milliseconds", string( ), "time taken to execute a database callable", &m_CallableMilliseconds );
+	metrics->AddCounter( this, "ghost_db_callable_errors_total", string( ), "number of database callables that finished with an error", &m_CallableErrors );
+	metrics->AddGauge( this, "ghost_db_connections", string( ), "number of open MySQL connections", &m_ConnectionsGauge );
+	metrics->AddGauge( this, "ghost_db_idle_connections", string( ), "number of idle MySQL connections", &m_IdleConnectionsGauge );
+	metrics->AddGauge( this, "ghost_db_outstanding_callables", string( ), "number of database callables that haven't been recovered yet", &m_OutstandingCallablesGauge );
+}
+
+void CGHostDBMySQL :: UpdateMetrics( )
+{
+	m_ConnectionsGauge.Set( m_NumConnections );
+	m_IdleConnectionsGauge.Set( m_IdleConnections.size( ) );
+	m_OutstandingCallablesGauge.Set( m_OutstandingCallables );
 }
 
 void CGHostDBMySQL :: RecoverCallable( CBaseCallable *callable )
@@ -109,6 +129,7 @@ void CGHostDBMySQL :: RecoverCallable( CBaseCallable *callable )
 	{
 		if( m_IdleConnections.size( ) > 30 )
 		{
+			MySQLCloseStatements( MySQLCallable->GetConnection( ) );
 			mysql_close( (MYSQL *)MySQLCallable->GetConnection( ) );
 			m_NumConnections--;
 		}
@@ -120,8 +141,13 @@ void CGHostDBMySQL :: RecoverCallable( CBaseCallable *callable )
 		else
 			m_OutstandingCallables--;
 
+		m_CallableMilliseconds.Record( MySQLCallable->GetElapsed( ) );
+
 		if( !MySQLCallable->GetError( ).empty( ) )
+		{
 			CONSOLE_Print( "[MYSQL] error --- " + MySQLCallable->GetError( ) );
+			m_CallableErrors.Add( );
+		}
 	}
 	else
 		CONSOLE_Print( "[MYSQL] tried to recover a non-mysql callable" );
@@ -371,6 +397,19 @@ CCallableDotAPlayerSummaryCheck *CGHostDBMySQL :: ThreadedDotAPlayerSummaryCheck
 	return Callable;
 }
 
+CCallableDotAEloUpdate *CGHostDBMySQL :: ThreadedDotAEloUpdate( uint32_t gameid, uint32_t winner, vector<string> names, vector<string> servers, vector<uint32_t> teams )
+{
+	void *Connection = GetIdleConnection( );
+
+	if( !Connection )
+		m_NumConnections++;
+
+	CCallableDotAEloUpdate *Callable = new CMySQLCallableDotAEloUpdate( gameid, winner, names, servers, teams, Connection, m_BotID, m_Server, m_Database, m_User, m_Password, m_Port );
+	CreateThread( Callable );
+	m_OutstandingCallables++;
+	return Callable;
+}
+
 CCallableDownloadAdd *CGHostDBMySQL :: ThreadedDownloadAdd( string map, uint32_t mapsize, string name, string ip, uint32_t spoofed, string spoofedrealm, uint32_t downloadtime )
 {
 	void *Connection = GetIdleConnection( );
@@ -566,6 +605,19 @@ CCallableGetAliases *CGHostDBMySQL :: ThreadedGetAliases( )
 	return Callable;
 }
 
+CCallableGetRecentPlayerIds *CGHostDBMySQL :: ThreadedGetRecentPlayerIds( uint32_t count )
+{
+	void *Connection = GetIdleConnection( );
+
+	if( !Connection )
+		m_NumConnections++;
+
+	CCallableGetRecentPlayerIds *Callable = new CMySQLCallableGetRecentPlayerIds( count, Connection, m_BotID, m_Server, m_Database, m_User, m_Password, m_Port );
+	CreateThread( Callable );
+	m_OutstandingCallables++;
+	return Callable;
+}
+
 void *CGHostDBMySQL :: GetIdleConnection( )
 {
 	void *Connection = NULL;
@@ -615,6 +667,215 @@ vector<string> MySQLFetchRow( MYSQL_RES *res )
 	return Result;
 }
 
+//
+// prepared statements
+//
+
+// the hot queries with a fixed shape are prepared once per connection and then executed with bound parameters
+// this saves building, escaping and parsing the query (and materializing every row as strings) each time the query runs
+// a connection is only used by one thread at a time (the thread of the callable that owns it) so the statements themselves need no locking
+
+#define MYSQL_STATEMENT_BANCHECK		0
+#define MYSQL_STATEMENT_BANCHECKIP		1
+#define MYSQL_STATEMENT_GAMEPLAYERADD	2
+#define MYSQL_STATEMENT_DOTAPLAYERADD	3
+#define MYSQL_STATEMENT_SCORECHECK		4
+#define MYSQL_STATEMENT_GETPLAYERID		5
+#define MYSQL_STATEMENT_GAMEUPDATE		6
+#define MYSQL_STATEMENT_GAMEDELETE		7
+#define MYSQL_STATEMENTS				8
+
+const char *MySQLStatementQueries[MYSQL_STATEMENTS] = {
+	"SELECT name, ip, DATE(date), gamename, admin, reason FROM bans WHERE server=? AND name=?",
+	"SELECT name, ip, DATE(date), gamename, admin, reason FROM bans WHERE (server=? AND name=?) OR ip=?",
+	"INSERT INTO gameplayers ( botid, player_id, gameid, name, ip, spoofed, reserved, loadingtime, `left`, leftreason, team, colour, spoofedrealm ) VALUES ( ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ? )",
+	"INSERT INTO dotaplayers ( botid, gameid, colour, kills, deaths, creepkills, creepdenies, assists, gold, neutralkills, item1, item2, item3, item4, item5, item6, hero, newcolour, towerkills, raxkills, courierkills ) VALUES ( ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ? )",
+	"SELECT score FROM scores WHERE category=? AND name=? AND server=?",
+	"SELECT id FROM oh_stats_players WHERE player_lower=?",
+	"INSERT INTO oh_gamelist (botid, gameid, lobby, map_type, gamename, ownername, creatorname, map) VALUES (?, ?, ?, ?, ?, ?, ?, ?) ON DUPLICATE KEY UPDATE lobby=?, duration=?, ownername=?, players=?, total=?, users=?",
+	"DELETE FROM oh_gamelist WHERE botid=? AND ( gameid=? OR lobby = 1 )"
+};
+
+class CMySQLStatements
+{
+public:
+	unsigned long m_ThreadID;							// the connection's thread id when the statements were prepared
+	MYSQL_STMT *m_Statements[MYSQL_STATEMENTS];
+};
+
+boost :: mutex MySQLStatementsMutex;
+map<void *, CMySQLStatements *> MySQLStatements;
+
+MYSQL_STMT *MySQLGetStatement( void *conn, string *error, uint32_t statement )
+{
+	CMySQLStatements *Statements = NULL;
+
+	{
+		boost :: mutex :: scoped_lock Lock( MySQLStatementsMutex );
+		map<void *, CMySQLStatements *> :: iterator i = MySQLStatements.find( conn );
+
+		if( i == MySQLStatements.end( ) )
+		{
+			Statements = new CMySQLStatements( );
+			Statements->m_ThreadID = mysql_thread_id( (MYSQL *)conn );
+			MySQLStatements[conn] = Statements;
+		}
+		else
+			Statements = i->second;
+	}
+
+	// the thread id changes when the client library reconnects (we set MYSQL_OPT_RECONNECT) and the server forgets every prepared statement when that happens
+	// the client library has already detached the old statements from the connection so closing them only frees their memory
+
+	unsigned long ThreadID = mysql_thread_id( (MYSQL *)conn );
+
+	if( Statements->m_ThreadID != ThreadID )
+	{
+		for( uint32_t i = 0; i < MYSQL_STATEMENTS; i++ )
+		{
+			if( Statements->m_Statements[i] )
+			{
+				mysql_stmt_close( Statements->m_Statements[i] );
+				Statements->m_Statements[i] = NULL;
+			}
+		}
+
+		Statements->m_ThreadID = ThreadID;
+	}
+
+	if( !Statements->m_Statements[statement] )
+	{
+		MYSQL_STMT *Statement = mysql_stmt_init( (MYSQL *)conn );
+
+		if( !Statement )
+		{
+			*error = mysql_error( (MYSQL *)conn );
+			return NULL;
+		}
+
+		if( mysql_stmt_prepare( Statement, MySQLStatementQueries[statement], strlen( MySQLStatementQueries[statement] ) ) != 0 )
+		{
+			*error = mysql_stmt_error( Statement );
+			mysql_stmt_close( Statement );
+			return NULL;
+		}
+
+		Statements->m_Statements[statement] = Statement;
+	}
+
+	return Statements->m_Statements[statement];
+}
+
+void MySQLCloseStatements( void *conn )
+{
+	// this must be called before closing a connection because the pointer might be reused for a new connection
+
+	boost :: mutex :: scoped_lock Lock( MySQLStatementsMutex );
+	map<void *, CMySQLStatements *> :: iterator i = MySQLStatements.find( conn );
+
+	if( i != MySQLStatements.end( ) )
+	{
+		for( uint32_t j = 0; j < MYSQL_STATEMENTS; j++ )
+		{
+			if( i->second->m_Statements[j] )
+				mysql_stmt_close( i->second->m_Statements[j] );
+		}
+
+		delete i->second;
+		MySQLStatements.erase( i );
+	}
+}
+
+bool MySQLExecuteStatement( MYSQL_STMT *stmt, string *error, MYSQL_BIND *params, MYSQL_BIND *results )
+{
+	// if there are results they're buffered on the client (like mysql_store_result) and must be released with mysql_stmt_free_result
+
+	if( mysql_stmt_bind_param( stmt, params ) || mysql_stmt_execute( stmt ) || ( results && ( mysql_stmt_bind_result( stmt, results ) || mysql_stmt_store_result( stmt ) ) ) )
+	{
+		*error = mysql_stmt_error( stmt );
+
+		if( results )
+			mysql_stmt_free_result( stmt );
+
+		return false;
+	}
+
+	return true;
+}
+
+bool MySQLFetchStatement( MYSQL_STMT *stmt, string *error )
+{
+	// returns true if a row was fetched
+	// truncated strings are fine here, MySQLGetStatementString fetches them again with a larger buffer
+
+	int Result = mysql_stmt_fetch( stmt );
+
+	if( Result == 0 || Result == MYSQL_DATA_TRUNCATED )
+		return true;
+
+	if( Result == 1 )
+		*error = mysql_stmt_error( stmt );
+
+	return false;
+}
+
+void MySQLBindUInt32( MYSQL_BIND &bind, uint32_t *value )
+{
+	bind.buffer_type = MYSQL_TYPE_LONG;
+	bind.buffer = value;
+	bind.is_unsigned = 1;
+}
+
+void MySQLBindDouble( MYSQL_BIND &bind, double *value, my_bool *isNull )
+{
+	bind.buffer_type = MYSQL_TYPE_DOUBLE;
+	bind.buffer = value;
+	bind.is_null = isNull;
+}
+
+void MySQLBindString( MYSQL_BIND &bind, string &value )
+{
+	// input only, the client library uses buffer_length as the length when length is NULL
+
+	bind.buffer_type = MYSQL_TYPE_STRING;
+	bind.buffer = (void *)value.data( );
+	bind.buffer_length = value.size( );
+}
+
+void MySQLBindResultString( MYSQL_BIND &bind, char *buffer, unsigned long size, unsigned long *length, my_bool *isNull )
+{
+	bind.buffer_type = MYSQL_TYPE_STRING;
+	bind.buffer = buffer;
+	bind.buffer_length = size;
+	bind.length = length;
+	bind.is_null = isNull;
+}
+
+string MySQLGetStatementString( MYSQL_STMT *stmt, MYSQL_BIND *results, unsigned int column )
+{
+	MYSQL_BIND &Bind = results[column];
+
+	if( *Bind.is_null )
+		return string( );
+
+	if( *Bind.length <= Bind.buffer_length )
+		return string( (char *)Bind.buffer, *Bind.length );
+
+	// the value didn't fit in the buffer so fetch it again now that we know how long it is
+
+	string Value( *Bind.length, 0 );
+	MYSQL_BIND Long;
+	memset( &Long, 0, sizeof( MYSQL_BIND ) );
+	Long.buffer_type = MYSQL_TYPE_STRING;
+	Long.buffer = &Value[0];
+	Long.buffer_length = Value.size( );
+
+	if( mysql_stmt_fetch_column( stmt, &Long, column, 0 ) != 0 )
+		return string( (char *)Bind.buffer, Bind.buffer_length );
+
+	return Value;
+}
+
 //
 // global helper functions
 //
@@ -777,36 +1038,33 @@ uint32_t MySQLBanCount( void *conn, string *error, uint32_t botid, string server
 CDBBan *MySQLBanCheck( void *conn, string *error, uint32_t botid, string server, string user, string ip )
 {
 	transform( user.begin( ), user.end( ), user.begin( ), (int(*)(int))tolower );
-	string EscServer = MySQLEscapeString( conn, server );
-	string EscUser = MySQLEscapeString( conn, user );
-	string EscIP = MySQLEscapeString( conn, ip );
 	CDBBan *Ban = NULL;
-	string Query;
+	MYSQL_STMT *Statement = MySQLGetStatement( conn, error, ip.empty( ) ? MYSQL_STATEMENT_BANCHECK : MYSQL_STATEMENT_BANCHECKIP );
 
-	if( ip.empty( ) )
-		Query = "SELECT name, ip, DATE(date), gamename, admin, reason FROM bans WHERE server='" + EscServer + "' AND name='" + EscUser + "'";
-	else
-		Query = "SELECT name, ip, DATE(date), gamename, admin, reason FROM bans WHERE (server='" + EscServer + "' AND name='" + EscUser + "') OR ip='" + EscIP + "'";
+	if( !Statement )
+		return NULL;
 
-	if( mysql_real_query( (MYSQL *)conn, Query.c_str( ), Query.size( ) ) != 0 )
-		*error = mysql_error( (MYSQL *)conn );
-	else
-	{
-		MYSQL_RES *Result = mysql_store_result( (MYSQL *)conn );
+	MYSQL_BIND Params[3];
+	memset( Params, 0, sizeof( Params ) );
+	MySQLBindString( Params[0], server );
+	MySQLBindString( Params[1], user );
+	MySQLBindString( Params[2], ip );
 
-		if( Result )
-		{
-			vector<string> Row = MySQLFetchRow( Result );
+	char Buffers[6][256];
+	unsigned long Lengths[6];
+	my_bool IsNull[6];
+	MYSQL_BIND Results[6];
+	memset( Results, 0, sizeof( Results ) );
 
-			if( Row.size( ) == 6 )
-				Ban = new CDBBan( server, Row[0], Row[1], Row[2], Row[3], Row[4], Row[5] );
-			/* else
-				*error = "error checking ban [" + server + " : " + user + "] - row doesn't have 6 columns"; */
+	for( int i = 0; i < 6; i++ )
+		MySQLBindResultString( Results[i], Buffers[i], sizeof( Buffers[i] ), &Lengths[i], &IsNull[i] );
 
-			mysql_free_result( Result );
-		}
-		else
-			*error = mysql_error( (MYSQL *)conn );
+	if( MySQLExecuteStatement( Statement, error, Params, Results ) )
+	{
+		if( MySQLFetchStatement( Statement, error ) )
+			Ban = new CDBBan( server, MySQLGetStatementString( Statement, Results, 0 ), MySQLGetStatementString( Statement, Results, 1 ), MySQLGetStatementString( Statement, Results, 2 ), MySQLGetStatementString( Statement, Results, 3 ), MySQLGetStatementString( Statement, Results, 4 ), MySQLGetStatementString( Statement, Results, 5 ) );
+
+		mysql_stmt_free_result( Statement );
 	}
 
 	return Ban;
@@ -915,16 +1173,29 @@ uint32_t MySQLGamePlayerAdd( void *conn, string *error, uint32_t botid, uint32_t
 {
 	transform( name.begin( ), name.end( ), name.begin( ), (int(*)(int))tolower );
 	uint32_t RowID = 0;
-	string EscName = MySQLEscapeString( conn, name );
-	string EscIP = MySQLEscapeString( conn, ip );
-	string EscSpoofedRealm = MySQLEscapeString( conn, spoofedrealm );
-	string EscLeftReason = MySQLEscapeString( conn, leftreason );
-	string Query = "INSERT INTO gameplayers ( botid, player_id, gameid, name, ip, spoofed, reserved, loadingtime, `left`, leftreason, team, colour, spoofedrealm ) VALUES ( " + UTIL_ToString( botid ) + ", " + UTIL_ToString(playerid) + ", " + UTIL_ToString( gameid ) + ", '" + EscName + "', '" + EscIP + "', " + UTIL_ToString( spoofed ) + ", " + UTIL_ToString( reserved ) + ", " + UTIL_ToString( loadingtime ) + ", " + UTIL_ToString( left ) + ", '" + EscLeftReason + "', " + UTIL_ToString( team ) + ", " + UTIL_ToString( colour ) + ", '" + EscSpoofedRealm + "' )";
-
-	if( mysql_real_query( (MYSQL *)conn, Query.c_str( ), Query.size( ) ) != 0 )
-		*error = mysql_error( (MYSQL *)conn );
-	else
-		RowID = mysql_insert_id( (MYSQL *)conn );
+	MYSQL_STMT *Statement = MySQLGetStatement( conn, error, MYSQL_STATEMENT_GAMEPLAYERADD );
+
+	if( !Statement )
+		return RowID;
+
+	MYSQL_BIND Params[13];
+	memset( Params, 0, sizeof( Params ) );
+	MySQLBindUInt32( Params[0], &botid );
+	MySQLBindUInt32( Params[1], &playerid );
+	MySQLBindUInt32( Params[2], &gameid );
+	MySQLBindString( Params[3], name );
+	MySQLBindString( Params[4], ip );
+	MySQLBindUInt32( Params[5], &spoofed );
+	MySQLBindUInt32( Params[6], &reserved );
+	MySQLBindUInt32( Params[7], &loadingtime );
+	MySQLBindUInt32( Params[8], &left );
+	MySQLBindString( Params[9], leftreason );
+	MySQLBindUInt32( Params[10], &team );
+	MySQLBindUInt32( Params[11], &colour );
+	MySQLBindString( Params[12], spoofedrealm );
+
+	if( MySQLExecuteStatement( Statement, error, Params, NULL ) )
+		RowID = mysql_stmt_insert_id( Statement );
 
 	return RowID;
 }
@@ -990,21 +1261,252 @@ uint32_t MySQLDotAGameAdd( void *conn, string *error, uint32_t botid, uint32_t g
 uint32_t MySQLDotAPlayerAdd( void *conn, string *error, uint32_t botid, uint32_t gameid, uint32_t colour, uint32_t kills, uint32_t deaths, uint32_t creepkills, uint32_t creepdenies, uint32_t assists, uint32_t gold, uint32_t neutralkills, string item1, string item2, string item3, string item4, string item5, string item6, string hero, uint32_t newcolour, uint32_t towerkills, uint32_t raxkills, uint32_t courierkills )
 {
 	uint32_t RowID = 0;
-	string EscItem1 = MySQLEscapeString( conn, item1 );
-	string EscItem2 = MySQLEscapeString( conn, item2 );
-	string EscItem3 = MySQLEscapeString( conn, item3 );
-	string EscItem4 = MySQLEscapeString( conn, item4 );
-	string EscItem5 = MySQLEscapeString( conn, item5 );
-	string EscItem6 = MySQLEscapeString( conn, item6 );
-	string EscHero = MySQLEscapeString( conn, hero );
-	string Query = "INSERT INTO dotaplayers ( botid, gameid, colour, kills, deaths, creepkills, creepdenies, assists, gold, neutralkills, item1, item2, item3, item4, item5, item6, hero, newcolour, towerkills, raxkills, courierkills ) VALUES ( " + UTIL_ToString( botid ) + ", " + UTIL_ToString( gameid ) + ", " + UTIL_ToString( colour ) + ", " + UTIL_ToString( kills ) + ", " + UTIL_ToString( deaths ) + ", " + UTIL_ToString( creepkills ) + ", " + UTIL_ToString( creepdenies ) + ", " + UTIL_ToString( assists ) + ", " + UTIL_ToString( gold ) + ", " + UTIL_ToString( neutralkills ) + ", '" + EscItem1 + "', '" + EscItem2 + "', '" + EscItem3 + "', '" + EscItem4 + "', '" + EscItem5 + "', '" + EscItem6 + "', '" + EscHero + "', " + UTIL_ToString( newcolour ) + ", " + UTIL_ToString( towerkills ) + ", " + UTIL_ToString( raxkills ) + ", " + UTIL_ToString( courierkills ) + " )";
+	MYSQL_STMT *Statement = MySQLGetStatement( conn, error, MYSQL_STATEMENT_DOTAPLAYERADD );
+
+	if( !Statement )
+		return RowID;
+
+	MYSQL_BIND Params[21];
+	memset( Params, 0, sizeof( Params ) );
+	MySQLBindUInt32( Params[0], &botid );
+	MySQLBindUInt32( Params[1], &gameid );
+	MySQLBindUInt32( Params[2], &colour );
+	MySQLBindUInt32( Params[3], &kills );
+	MySQLBindUInt32( Params[4], &deaths );
+	MySQLBindUInt32( Params[5], &creepkills );
+	MySQLBindUInt32( Params[6], &creepdenies );
+	MySQLBindUInt32( Params[7], &assists );
+	MySQLBindUInt32( Params[8], &gold );
+	MySQLBindUInt32( Params[9], &neutralkills );
+	MySQLBindString( Params[10], item1 );
+	MySQLBindString( Params[11], item2 );
+	MySQLBindString( Params[12], item3 );
+	MySQLBindString( Params[13], item4 );
+	MySQLBindString( Params[14], item5 );
+	MySQLBindString( Params[15], item6 );
+	MySQLBindString( Params[16], hero );
+	MySQLBindUInt32( Params[17], &newcolour );
+	MySQLBindUInt32( Params[18], &towerkills );
+	MySQLBindUInt32( Params[19], &raxkills );
+	MySQLBindUInt32( Params[20], &courierkills );
+
+	if( MySQLExecuteStatement( Statement, error, Params, NULL ) )
+		RowID = mysql_stmt_insert_id( Statement );
 
-	if( mysql_real_query( (MYSQL *)conn, Query.c_str( ), Query.size( ) ) != 0 )
+	return RowID;
+}
+
+bool MySQLDotAEloUpdate( void *conn, string *error, uint32_t botid, uint32_t gameid, uint32_t winner, vector<string> names, vector<string> servers, vector<uint32_t> teams )
+{
+	// this does the same thing as update_dota_elo but for a single game as soon as it ends
+	// only the rows of the players in this game are read and written so the scores table is never rewritten (or locked) as a whole
+	// the tables are normally created by update_dota_elo but it might never have been run
+
+	string QCreate1 = "CREATE TABLE IF NOT EXISTS dota_elo_scores ( id INT NOT NULL AUTO_INCREMENT PRIMARY KEY, name VARCHAR(15) NOT NULL, server VARCHAR(100) NOT NULL, score REAL NOT NULL )";
+	string QCreate2 = "CREATE TABLE IF NOT EXISTS dota_elo_games_scored ( id INT NOT NULL AUTO_INCREMENT PRIMARY KEY, gameid INT NOT NULL, UNIQUE INDEX gameid ( gameid ) )";
+
+	if( mysql_real_query( (MYSQL *)conn, QCreate1.c_str( ), QCreate1.size( ) ) != 0 || mysql_real_query( (MYSQL *)conn, QCreate2.c_str( ), QCreate2.size( ) ) != 0 )
+	{
+		*error = mysql_error( (MYSQL *)conn );
+		return false;
+	}
+
+	// the unique index on gameid is what stops two scorers (the bot, another bot sharing the database or update_dota_elo) from scoring the same game twice
+	// older versions of update_dota_elo created the table without it so add it now, any duplicate rows have to go first or adding the index fails
+	// this has to happen outside the transaction because ALTER TABLE commits implicitly
+
+	string QIndex = "SHOW INDEX FROM dota_elo_games_scored WHERE Column_name='gameid' AND Non_unique=0";
+
+	if( mysql_real_query( (MYSQL *)conn, QIndex.c_str( ), QIndex.size( ) ) != 0 )
+	{
+		*error = mysql_error( (MYSQL *)conn );
+		return false;
+	}
+
+	MYSQL_RES *IndexResult = mysql_store_result( (MYSQL *)conn );
+
+	if( !IndexResult )
+	{
+		*error = mysql_error( (MYSQL *)conn );
+		return false;
+	}
+
+	bool HasIndex = mysql_num_rows( IndexResult ) > 0;
+	mysql_free_result( IndexResult );
+
+	if( !HasIndex )
+	{
+		string QDeleteDuplicates = "DELETE a FROM dota_elo_games_scored a JOIN dota_elo_games_scored b ON a.gameid=b.gameid AND a.id>b.id";
+		string QAddIndex = "ALTER TABLE dota_elo_games_scored ADD UNIQUE INDEX gameid ( gameid )";
+
+		// ER_DUP_KEYNAME (1061) means someone else added the index in the meantime
+
+		if( mysql_real_query( (MYSQL *)conn, QDeleteDuplicates.c_str( ), QDeleteDuplicates.size( ) ) != 0 || ( mysql_real_query( (MYSQL *)conn, QAddIndex.c_str( ), QAddIndex.size( ) ) != 0 && mysql_errno( (MYSQL *)conn ) != 1061 ) )
+		{
+			*error = mysql_error( (MYSQL *)conn );
+			return false;
+		}
+	}
+
+	// claim the game before reading any scores
+	// if someone else is scoring it right now the insert waits on the index entry until they commit (or roll back)
+	// no row was inserted if the game has already been scored, in that case there's nothing to do
+
+	string QBegin = "BEGIN";
+	string QInsertScored = "INSERT IGNORE INTO dota_elo_games_scored ( gameid ) VALUES ( " + UTIL_ToString( gameid ) + " )";
+	bool Scored = false;
+
+	if( mysql_real_query( (MYSQL *)conn, QBegin.c_str( ), QBegin.size( ) ) != 0 )
+	{
+		*error = mysql_error( (MYSQL *)conn );
+		return false;
+	}
+
+	if( mysql_real_query( (MYSQL *)conn, QInsertScored.c_str( ), QInsertScored.size( ) ) != 0 )
 		*error = mysql_error( (MYSQL *)conn );
 	else
-		RowID = mysql_insert_id( (MYSQL *)conn );
+		Scored = mysql_affected_rows( (MYSQL *)conn ) == 0;
 
-	return RowID;
+	uint32_t NumPlayers = names.size( );
+	vector<uint32_t> EloIDs( NumPlayers, 0 );
+	vector<uint32_t> ScoreIDs( NumPlayers, 0 );
+	vector<float> Ratings( NumPlayers, 1000.0 );
+	vector<int> Teams( NumPlayers, 0 );
+	map<string, uint32_t> Players;
+	string Where;
+
+	for( uint32_t i = 0; i < NumPlayers; i++ )
+	{
+		// names and servers are compared case insensitively just like MySQL does
+
+		string Key = names[i] + " " + servers[i];
+		transform( Key.begin( ), Key.end( ), Key.begin( ), (int(*)(int))tolower );
+		Players[Key] = i;
+		Teams[i] = teams[i];
+
+		if( i > 0 )
+			Where += " OR ";
+
+		Where += "( name='" + MySQLEscapeString( conn, names[i] ) + "' AND server='" + MySQLEscapeString( conn, servers[i] ) + "' )";
+	}
+
+	string QElo = "SELECT id, name, server, score FROM dota_elo_scores WHERE " + Where + " FOR UPDATE";
+	string QScores = "SELECT id, name, server FROM scores WHERE category='dota_elo' AND ( " + Where + " ) FOR UPDATE";
+
+	for( uint32_t Step = 0; Step < 2 && error->empty( ) && !Scored; Step++ )
+	{
+		string &Query = Step == 0 ? QElo : QScores;
+
+		if( mysql_real_query( (MYSQL *)conn, Query.c_str( ), Query.size( ) ) != 0 )
+		{
+			*error = mysql_error( (MYSQL *)conn );
+			break;
+		}
+
+		MYSQL_RES *Result = mysql_store_result( (MYSQL *)conn );
+
+		if( !Result )
+		{
+			*error = mysql_error( (MYSQL *)conn );
+			break;
+		}
+
+		vector<string> Row = MySQLFetchRow( Result );
+
+		while( !Row.empty( ) )
+		{
+			if( Row.size( ) >= 3 )
+			{
+				string Key = Row[1] + " " + Row[2];
+				transform( Key.begin( ), Key.end( ), Key.begin( ), (int(*)(int))tolower );
+				map<string, uint32_t> :: iterator j = Players.find( Key );
+
+				if( j != Players.end( ) )
+				{
+					if( Step == 0 && Row.size( ) == 4 )
+					{
+						EloIDs[j->second] = UTIL_ToUInt32( Row[0] );
+						Ratings[j->second] = (float)UTIL_ToDouble( Row[3] );
+					}
+					else if( Step == 1 )
+						ScoreIDs[j->second] = UTIL_ToUInt32( Row[0] );
+				}
+			}
+
+			Row = MySQLFetchRow( Result );
+		}
+
+		mysql_free_result( Result );
+	}
+
+	if( error->empty( ) && !Scored )
+	{
+		float TeamRatings[2] = { 0.0, 0.0 };
+		float TeamWinners[2] = { winner == 1 ? (float)1.0 : (float)0.0, winner == 2 ? (float)1.0 : (float)0.0 };
+		uint32_t TeamPlayers[2] = { 0, 0 };
+
+		for( uint32_t i = 0; i < NumPlayers; i++ )
+		{
+			TeamRatings[Teams[i]] += Ratings[i];
+			TeamPlayers[Teams[i]]++;
+		}
+
+		for( uint32_t i = 0; i < 2; i++ )
+		{
+			if( TeamPlayers[i] > 0 )
+				TeamRatings[i] /= TeamPlayers[i];
+		}
+
+		elo_recalculate_ratings( NumPlayers, &Ratings[0], &Teams[0], 2, TeamRatings, TeamWinners );
+
+		// write every changed rating with one statement per table
+		// rows we found are updated through their primary key (ON DUPLICATE KEY) and new players get a new row
+
+		string QEloUpsert = "INSERT INTO dota_elo_scores ( id, name, server, score ) VALUES ";
+		string QScoresUpsert = "INSERT INTO scores ( id, category, name, server, score ) VALUES ";
+
+		for( uint32_t i = 0; i < NumPlayers; i++ )
+		{
+			string EscName = MySQLEscapeString( conn, names[i] );
+			string EscServer = MySQLEscapeString( conn, servers[i] );
+			string Score = UTIL_ToString( Ratings[i], 2 );
+
+			if( i > 0 )
+			{
+				QEloUpsert += ", ";
+				QScoresUpsert += ", ";
+			}
+
+			QEloUpsert += "( ";
+			QScoresUpsert += "( ";
+
+			if( EloIDs[i] )
+				UTIL_AppendUInt( QEloUpsert, EloIDs[i] );
+			else
+				QEloUpsert += "NULL";
+
+			if( ScoreIDs[i] )
+				UTIL_AppendUInt( QScoresUpsert, ScoreIDs[i] );
+			else
+				QScoresUpsert += "NULL";
+
+			QEloUpsert += ", '" + EscName + "', '" + EscServer + "', " + Score + " )";
+			QScoresUpsert += ", 'dota_elo', '" + EscName + "', '" + EscServer + "', " + Score + " )";
+		}
+
+		QEloUpsert += " ON DUPLICATE KEY UPDATE score=VALUES(score)";
+		QScoresUpsert += " ON DUPLICATE KEY UPDATE score=VALUES(score)";
+
+		if( mysql_real_query( (MYSQL *)conn, QEloUpsert.c_str( ), QEloUpsert.size( ) ) != 0 || mysql_real_query( (MYSQL *)conn, QScoresUpsert.c_str( ), QScoresUpsert.size( ) ) != 0 )
+			*error = mysql_error( (MYSQL *)conn );
+	}
+
+	string QEnd = error->empty( ) ? "COMMIT" : "ROLLBACK";
+
+	if( mysql_real_query( (MYSQL *)conn, QEnd.c_str( ), QEnd.size( ) ) != 0 && error->empty( ) )
+		*error = mysql_error( (MYSQL *)conn );
+
+	return error->empty( );
 }
 
 CDBDotAPlayerSummary *MySQLDotAPlayerSummaryCheck( void *conn, string *error, uint32_t botid, string name )
@@ -1129,31 +1631,30 @@ bool MySQLDownloadAdd( void *conn, string *error, uint32_t botid, string map, ui
 double MySQLScoreCheck( void *conn, string *error, uint32_t botid, string category, string name, string server )
 {
 	transform( name.begin( ), name.end( ), name.begin( ), (int(*)(int))tolower );
-	string EscCategory = MySQLEscapeString( conn, category );
-	string EscName = MySQLEscapeString( conn, name );
-	string EscServer = MySQLEscapeString( conn, server );
 	double Score = -100000.0;
-	string Query = "SELECT score FROM scores WHERE category='" + EscCategory + "' AND name='" + EscName + "' AND server='" + EscServer + "'";
+	MYSQL_STMT *Statement = MySQLGetStatement( conn, error, MYSQL_STATEMENT_SCORECHECK );
 
-	if( mysql_real_query( (MYSQL *)conn, Query.c_str( ), Query.size( ) ) != 0 )
-		*error = mysql_error( (MYSQL *)conn );
-	else
-	{
-		MYSQL_RES *Result = mysql_store_result( (MYSQL *)conn );
+	if( !Statement )
+		return Score;
 
-		if( Result )
-		{
-			vector<string> Row = MySQLFetchRow( Result );
+	MYSQL_BIND Params[3];
+	memset( Params, 0, sizeof( Params ) );
+	MySQLBindString( Params[0], category );
+	MySQLBindString( Params[1], name );
+	MySQLBindString( Params[2], server );
 
-			if( Row.size( ) == 1 )
-				Score = UTIL_ToDouble( Row[0] );
-			/* else
-				*error = "error checking score [" + category + " : " + name + " : " + server + "] - row doesn't have 1 column"; */
+	double Value = 0.0;
+	my_bool IsNull = 0;
+	MYSQL_BIND Results[1];
+	memset( Results, 0, sizeof( Results ) );
+	MySQLBindDouble( Results[0], &Value, &IsNull );
 
-			mysql_free_result( Result );
-		}
-		else
-			*error = mysql_error( (MYSQL *)conn );
+	if( MySQLExecuteStatement( Statement, error, Params, Results ) )
+	{
+		if( MySQLFetchStatement( Statement, error ) )
+			Score = IsNull ? 0.0 : Value;
+
+		mysql_stmt_free_result( Statement );
 	}
 
 	return Score;
@@ -1182,16 +1683,24 @@ bool MySQLW3MMDVarAdd( void *conn, string *error, uint32_t botid, uint32_t gamei
 		return false;
 
 	bool Success = false;
-	string Query;
+	string Query = "INSERT INTO w3mmdvars ( botid, gameid, pid, varname, value_int ) VALUES ";
 
 	for( map<VarP,int32_t> :: iterator i = var_ints.begin( ); i != var_ints.end( ); i++ )
 	{
 		string EscVarName = MySQLEscapeString( conn, i->first.second );
 
-		if( Query.empty( ) )
-			Query = "INSERT INTO w3mmdvars ( botid, gameid, pid, varname, value_int ) VALUES ( " + UTIL_ToString( botid ) + ", " + UTIL_ToString( gameid ) + ", " + UTIL_ToString( i->first.first ) + ", '" + EscVarName + "', " + UTIL_ToString( i->second ) + " )";
-		else
-			Query += ", ( " + UTIL_ToString( botid ) + ", " + UTIL_ToString( gameid ) + ", " + UTIL_ToString( i->first.first ) + ", '" + EscVarName + "', " + UTIL_ToString( i->second ) + " )";
+		if( i != var_ints.begin( ) )
+			Query += ", ";
+
+		Query += "( ";
+		UTIL_AppendUInt( Query, botid );
+		Query += ", ";
+		UTIL_AppendUInt( Query, gameid );
+		Query += ", ";
+		UTIL_AppendUInt( Query, i->first.first );
+		Query += ", '" + EscVarName + "', ";
+		UTIL_AppendInt( Query, i->second );
+		Query += " )";
 	}
 
 	if( mysql_real_query( (MYSQL *)conn, Query.c_str( ), Query.size( ) ) != 0 )
@@ -1208,16 +1717,24 @@ bool MySQLW3MMDVarAdd( void *conn, string *error, uint32_t botid, uint32_t gamei
 		return false;
 
 	bool Success = false;
-	string Query;
+	string Query = "INSERT INTO w3mmdvars ( botid, gameid, pid, varname, value_real ) VALUES ";
 
 	for( map<VarP,double> :: iterator i = var_reals.begin( ); i != var_reals.end( ); i++ )
 	{
 		string EscVarName = MySQLEscapeString( conn, i->first.second );
 
-		if( Query.empty( ) )
-			Query = "INSERT INTO w3mmdvars ( botid, gameid, pid, varname, value_real ) VALUES ( " + UTIL_ToString( botid ) + ", " + UTIL_ToString( gameid ) + ", " + UTIL_ToString( i->first.first ) + ", '" + EscVarName + "', " + UTIL_ToString( i->second, 10 ) + " )";
-		else
-			Query += ", ( " + UTIL_ToString( botid ) + ", " + UTIL_ToString( gameid ) + ", " + UTIL_ToString( i->first.first ) + ", '" + EscVarName + "', " + UTIL_ToString( i->second, 10 ) + " )";
+		if( i != var_reals.begin( ) )
+			Query += ", ";
+
+		Query += "( ";
+		UTIL_AppendUInt( Query, botid );
+		Query += ", ";
+		UTIL_AppendUInt( Query, gameid );
+		Query += ", ";
+		UTIL_AppendUInt( Query, i->first.first );
+		Query += ", '" + EscVarName + "', ";
+		UTIL_AppendDouble( Query, i->second, 10 );
+		Query += " )";
 	}
 
 	if( mysql_real_query( (MYSQL *)conn, Query.c_str( ), Query.size( ) ) != 0 )
@@ -1234,17 +1751,23 @@ bool MySQLW3MMDVarAdd( void *conn, string *error, uint32_t botid, uint32_t gamei
 		return false;
 
 	bool Success = false;
-	string Query;
+	string Query = "INSERT INTO w3mmdvars ( botid, gameid, pid, varname, value_string ) VALUES ";
 
 	for( map<VarP,string> :: iterator i = var_strings.begin( ); i != var_strings.end( ); i++ )
 	{
 		string EscVarName = MySQLEscapeString( conn, i->first.second );
 		string EscValueString = MySQLEscapeString( conn, i->second );
 
-		if( Query.empty( ) )
-			Query = "INSERT INTO w3mmdvars ( botid, gameid, pid, varname, value_string ) VALUES ( " + UTIL_ToString( botid ) + ", " + UTIL_ToString( gameid ) + ", " + UTIL_ToString( i->first.first ) + ", '" + EscVarName + "', '" + EscValueString + "' )";
-		else
-			Query += ", ( " + UTIL_ToString( botid ) + ", " + UTIL_ToString( gameid ) + ", " + UTIL_ToString( i->first.first ) + ", '" + EscVarName + "', '" + EscValueString + "' )";
+		if( i != var_strings.begin( ) )
+			Query += ", ";
+
+		Query += "( ";
+		UTIL_AppendUInt( Query, botid );
+		Query += ", ";
+		UTIL_AppendUInt( Query, gameid );
+		Query += ", ";
+		UTIL_AppendUInt( Query, i->first.first );
+		Query += ", '" + EscVarName + "', '" + EscValueString + "' )";
 	}
 
 	if( mysql_real_query( (MYSQL *)conn, Query.c_str( ), Query.size( ) ) != 0 )
@@ -1258,16 +1781,30 @@ bool MySQLW3MMDVarAdd( void *conn, string *error, uint32_t botid, uint32_t gamei
 uint32_t MySQLGetPlayerId( void *conn, string *error, uint32_t botid, string user )
 {
 	transform( user.begin( ), user.end( ), user.begin( ), (int(*)(int))tolower );
-    string EscLowerName = MySQLEscapeString( conn, user );
-	uint32_t RowID = 0;
-	string Query = "SELECT id FROM oh_stats_players WHERE player_lower = '" + EscLowerName + "'";
+	uint32_t PlayerID = 0;
+	MYSQL_STMT *Statement = MySQLGetStatement( conn, error, MYSQL_STATEMENT_GETPLAYERID );
 
-	if( mysql_real_query( (MYSQL *)conn, Query.c_str( ), Query.size( ) ) != 0 )
-		*error = mysql_error( (MYSQL *)conn );
-	else
-		RowID = mysql_insert_id( (MYSQL *)conn );
+	if( !Statement )
+		return PlayerID;
 
-	return RowID;
+	MYSQL_BIND Params[1];
+	memset( Params, 0, sizeof( Params ) );
+	MySQLBindString( Params[0], user );
+
+	uint32_t Value = 0;
+	MYSQL_BIND Results[1];
+	memset( Results, 0, sizeof( Results ) );
+	MySQLBindUInt32( Results[0], &Value );
+
+	if( MySQLExecuteStatement( Statement, error, Params, Results ) )
+	{
+		if( MySQLFetchStatement( Statement, error ) )
+			PlayerID = Value;
+
+		mysql_stmt_free_result( Statement );
+	}
+
+	return PlayerID;
 }
 
 uint32_t MySQLCreatePlayerId( void *conn, string *error, uint32_t botid, string user, string ip, string realm )
@@ -1279,7 +1816,7 @@ uint32_t MySQLCreatePlayerId( void *conn, string *error, uint32_t botid, string
     string EscRealm = MySQLEscapeString( conn, realm );
     
 	uint32_t RowID = 0;
-	string Query = "INSERT INTO oh_stats_players (player, player_lower, ip, realm, player_language) VALUES ('"+EscName+"','"+EscLowerName+"','"+EscIP+"','"+EscRealm+"');";
+	string Query = "INSERT INTO oh_stats_players (player, player_lower, ip, realm) VALUES ('"+EscName+"','"+EscLowerName+"','"+EscIP+"','"+EscRealm+"');";
 
 	if( mysql_real_query( (MYSQL *)conn, Query.c_str( ), Query.size( ) ) != 0 )
 		*error = mysql_error( (MYSQL *)conn );
@@ -1391,6 +1928,7 @@ map<string, map<uint32_t, string> > MySQLGetLanguages( void *conn, string *error
             
 			while( Row.size( ) == 3 )
 			{
+				m_Languages[Row[1]][UTIL_ToUInt32( Row[0] )] = Row[2];
 				Row = MySQLFetchRow( Result );
 			}
 
@@ -1439,28 +1977,53 @@ map<string, string> MySQLGetMapConfig( void *conn, string *error, uint32_t botid
 string MySQLGameUpdate( void *conn, string *error, uint32_t botid, uint32_t hostcounter, uint32_t lobby, string map_type, uint32_t duration, string gamename, string ownername, string creatorname, string map, uint32_t players, uint32_t total, vector<PlayerOfPlayerList> playerlist )
 {
     if( !gamename.empty( ) ) {
-        string EscMapType = MySQLEscapeString( conn, map_type );
-        string EscGameName = MySQLEscapeString( conn, gamename );
-        string EscOwnerName = MySQLEscapeString( conn, ownername );
-        string EscCreatorName = MySQLEscapeString( conn, creatorname );
-        string EscMap = MySQLEscapeString( conn, map );
         string Users ="";
         string Splitter =",";
         string PlayerSlpitter="#";
         for( vector<PlayerOfPlayerList> :: iterator i = playerlist.begin( ); i != playerlist.end( ); ++i ) {
-            Users += UTIL_ToString(i->Slot)+Splitter+UTIL_ToString(i->Team)+Splitter+UTIL_ToString(i->Color)+Splitter+i->Username+Splitter+i->Realm+Splitter+UTIL_ToString(i->Ping)+Splitter+i->IP+Splitter+UTIL_ToString(i->LeftTime)+Splitter+i->LeftReason+PlayerSlpitter;
+            UTIL_AppendUInt( Users, i->Slot );
+            Users += Splitter;
+            UTIL_AppendUInt( Users, i->Team );
+            Users += Splitter;
+            UTIL_AppendUInt( Users, i->Color );
+            Users += Splitter + i->Username + Splitter + i->Realm + Splitter;
+            UTIL_AppendUInt( Users, i->Ping );
+            Users += Splitter + i->IP + Splitter;
+            UTIL_AppendUInt( Users, i->LeftTime );
+            Users += Splitter + i->LeftReason + PlayerSlpitter;
         }
-        string EscPlayerList = MySQLEscapeString( conn, Users );
 
-        string Query = "INSERT INTO oh_gamelist (botid, gameid, lobby, map_type, gamename, ownername, creatorname, map) VALUES ('" + UTIL_ToString( botid ) + "', '" + UTIL_ToString( hostcounter ) + "', '" + UTIL_ToString( lobby ) + "', '" + EscMapType + "', '" + EscGameName + "', '" + EscOwnerName + "', '" + EscCreatorName + "', '" + EscMap + "') ON DUPLICATE KEY UPDATE lobby = '" + UTIL_ToString( lobby ) + "', duration = '" + UTIL_ToString( duration ) + "', ownername = '" + EscOwnerName + "', players = '" + UTIL_ToString( players ) + "', total = '" + UTIL_ToString( total ) + "', users = '" + EscPlayerList + "'";
-
-        if( mysql_real_query( (MYSQL *)conn, Query.c_str( ), Query.size( ) ) != 0 )
-            *error = mysql_error( (MYSQL *)conn );
+        MYSQL_STMT *Statement = MySQLGetStatement( conn, error, MYSQL_STATEMENT_GAMEUPDATE );
+
+        if( Statement ) {
+            MYSQL_BIND Params[14];
+            memset( Params, 0, sizeof( Params ) );
+            MySQLBindUInt32( Params[0], &botid );
+            MySQLBindUInt32( Params[1], &hostcounter );
+            MySQLBindUInt32( Params[2], &lobby );
+            MySQLBindString( Params[3], map_type );
+            MySQLBindString( Params[4], gamename );
+            MySQLBindString( Params[5], ownername );
+            MySQLBindString( Params[6], creatorname );
+            MySQLBindString( Params[7], map );
+            MySQLBindUInt32( Params[8], &lobby );
+            MySQLBindUInt32( Params[9], &duration );
+            MySQLBindString( Params[10], ownername );
+            MySQLBindUInt32( Params[11], &players );
+            MySQLBindUInt32( Params[12], &total );
+            MySQLBindString( Params[13], Users );
+            MySQLExecuteStatement( Statement, error, Params, NULL );
+        }
     } else {
-        string Query = "DELETE FROM oh_gamelist WHERE botid = " + UTIL_ToString( botid ) + " AND ( gameid = " + UTIL_ToString( hostcounter ) + " OR lobby = 1 )";
-
-        if( mysql_real_query( (MYSQL *)conn, Query.c_str( ), Query.size( ) ) != 0 )
-            *error = mysql_error( (MYSQL *)conn );
+        MYSQL_STMT *Statement = MySQLGetStatement( conn, error, MYSQL_STATEMENT_GAMEDELETE );
+
+        if( Statement ) {
+            MYSQL_BIND Params[2];
+            memset( Params, 0, sizeof( Params ) );
+            MySQLBindUInt32( Params[0], &botid );
+            MySQLBindUInt32( Params[1], &hostcounter );
+            MySQLExecuteStatement( Statement, error, Params, NULL );
+        }
     }
     return "";
 }
@@ -1495,6 +2058,38 @@ map<uint32_t, string> MySQLGetAliases( void *conn, string *error, uint32_t botid
 	return m_Aliases;
 }
 
+vector<PlayerIdP> MySQLGetRecentPlayerIds( void *conn, string *error, uint32_t botid, uint32_t count )
+{
+	// there's no "last seen" column so the most recently created players are used instead
+
+	vector<PlayerIdP> PlayerIds;
+	string Query = "SELECT player_lower, id FROM oh_stats_players ORDER BY id DESC LIMIT " + UTIL_ToString( count );
+
+	if( mysql_real_query( (MYSQL *)conn, Query.c_str( ), Query.size( ) ) != 0 )
+		*error = mysql_error( (MYSQL *)conn );
+	else
+	{
+		MYSQL_RES *Result = mysql_store_result( (MYSQL *)conn );
+
+		if( Result )
+		{
+			vector<string> Row = MySQLFetchRow( Result );
+
+			while( Row.size( ) == 2 )
+			{
+				PlayerIds.push_back( PlayerIdP( Row[0], UTIL_ToUInt32( Row[1] ) ) );
+				Row = MySQLFetchRow( Result );
+			}
+
+			mysql_free_result( Result );
+		}
+		else
+			*error = mysql_error( (MYSQL *)conn );
+	}
+
+	return PlayerIds;
+}
+
 //
 // MySQL Callables
 //
@@ -1699,6 +2294,16 @@ void CMySQLCallableDotAPlayerSummaryCheck :: operator( )( )
 	Close( );
 }
 
+void CMySQLCallableDotAEloUpdate :: operator( )( )
+{
+	Init( );
+
+	if( m_Error.empty( ) )
+		m_Result = MySQLDotAEloUpdate( m_Connection, &m_Error, m_SQLBotID, m_GameID, m_Winner, m_Names, m_Servers, m_Teams );
+
+	Close( );
+}
+
 void CMySQLCallableDownloadAdd :: operator( )( )
 {
 	Init( );
@@ -1836,4 +2441,14 @@ void CMySQLCallableGetAliases :: operator( )( )
 	Close( );
 }
 
+void CMySQLCallableGetRecentPlayerIds :: operator( )( )
+{
+	Init( );
+
+	if( m_Error.empty( ) )
+		m_Result = MySQLGetRecentPlayerIds( m_Connection, &m_Error, m_SQLBotID, m_Count );
+
+	Close( );
+}
+
 #endif
@@ -39,12 +39,19 @@ private:
 	queue<void *> m_IdleConnections;
 	uint32_t m_NumConnections;
 	uint32_t m_OutstandingCallables;
+	CHistogram m_CallableMilliseconds;		// how long each callable took to execute (from Init to Close)
+	CCounter m_CallableErrors;				// the number of callables that finished with an error
+	CGauge m_ConnectionsGauge;
+	CGauge m_IdleConnectionsGauge;
+	CGauge m_OutstandingCallablesGauge;
 
 public:
 	CGHostDBMySQL( CConfig *CFG );
 	virtual ~CGHostDBMySQL( );
 
 	virtual string GetStatus( );
+	virtual void AddMetrics( CMetrics *metrics );
+	virtual void UpdateMetrics( );
 
 	virtual void RecoverCallable( CBaseCallable *callable );
 
@@ -68,6 +75,7 @@ public:
 	virtual CCallableDotAGameAdd *ThreadedDotAGameAdd( uint32_t gameid, uint32_t winner, uint32_t min, uint32_t sec );
 	virtual CCallableDotAPlayerAdd *ThreadedDotAPlayerAdd( uint32_t gameid, uint32_t colour, uint32_t kills, uint32_t deaths, uint32_t creepkills, uint32_t creepdenies, uint32_t assists, uint32_t gold, uint32_t neutralkills, string item1, string item2, string item3, string item4, string item5, string item6, string hero, uint32_t newcolour, uint32_t towerkills, uint32_t raxkills, uint32_t courierkills );
 	virtual CCallableDotAPlayerSummaryCheck *ThreadedDotAPlayerSummaryCheck( string name );
+	virtual CCallableDotAEloUpdate *ThreadedDotAEloUpdate( uint32_t gameid, uint32_t winner, vector<string> names, vector<string> servers, vector<uint32_t> teams );
 	virtual CCallableDownloadAdd *ThreadedDownloadAdd( string map, uint32_t mapsize, string name, string ip, uint32_t spoofed, string spoofedrealm, uint32_t downloadtime );
 	virtual CCallableScoreCheck *ThreadedScoreCheck( string category, string name, string server );
 	virtual CCallableW3MMDPlayerAdd *ThreadedW3MMDPlayerAdd( string category, uint32_t gameid, uint32_t pid, string name, string flag, uint32_t leaver, uint32_t practicing );
@@ -85,6 +93,7 @@ public:
     virtual CCallableGetMapConfig *ThreadedGetMapConfig( string configname );
     virtual CCallableGameUpdate *ThreadedGameUpdate( uint32_t hostcounter, uint32_t lobby, string map_type, uint32_t duration, string gamename, string ownername, string creatorname, string map, uint32_t players, uint32_t total, vector<PlayerOfPlayerList> playerlist );
     virtual CCallableGetAliases *ThreadedGetAliases( );
+	virtual CCallableGetRecentPlayerIds *ThreadedGetRecentPlayerIds( uint32_t count );
    
 	virtual void *GetIdleConnection( );
 };
@@ -93,6 +102,7 @@ public:
 // global helper functions
 //
 
+void MySQLCloseStatements( void *conn );
 uint32_t MySQLAdminCount( void *conn, string *error, uint32_t botid, string server );
 bool MySQLAdminCheck( void *conn, string *error, uint32_t botid, string server, string user );
 bool MySQLAdminAdd( void *conn, string *error, uint32_t botid, string server, string user );
@@ -110,6 +120,7 @@ CDBGamePlayerSummary *MySQLGamePlayerSummaryCheck( void *conn, string *error, ui
 uint32_t MySQLDotAGameAdd( void *conn, string *error, uint32_t botid, uint32_t gameid, uint32_t winner, uint32_t min, uint32_t sec );
 uint32_t MySQLDotAPlayerAdd( void *conn, string *error, uint32_t botid, uint32_t gameid, uint32_t colour, uint32_t kills, uint32_t deaths, uint32_t creepkills, uint32_t creepdenies, uint32_t assists, uint32_t gold, uint32_t neutralkills, string item1, string item2, string item3, string item4, string item5, string item6, string hero, uint32_t newcolour, uint32_t towerkills, uint32_t raxkills, uint32_t courierkills );
 CDBDotAPlayerSummary *MySQLDotAPlayerSummaryCheck( void *conn, string *error, uint32_t botid, string name );
+bool MySQLDotAEloUpdate( void *conn, string *error, uint32_t botid, uint32_t gameid, uint32_t winner, vector<string> names, vector<string> servers, vector<uint32_t> teams );
 bool MySQLDownloadAdd( void *conn, string *error, uint32_t botid, string map, uint32_t mapsize, string name, string ip, uint32_t spoofed, string spoofedrealm, uint32_t downloadtime );
 double MySQLScoreCheck( void *conn, string *error, uint32_t botid, string category, string name, string server );
 uint32_t MySQLW3MMDPlayerAdd( void *conn, string *error, uint32_t botid, string category, uint32_t gameid, uint32_t pid, string name, string flag, uint32_t leaver, uint32_t practicing );
@@ -125,6 +136,7 @@ map<string, map<uint32_t, string> > MySQLGetLanguages( void *conn, string *error
 map<string, string> MySQLGetMapConfig( void *conn, string *error, uint32_t botid, string configname);
 string MySQLGameUpdate( void *conn, string *error, uint32_t botid, uint32_t hostcounter, uint32_t lobby, string map_type, uint32_t duration, string gamename, string ownername, string creatorname, string map, uint32_t players, uint32_t total, vector<PlayerOfPlayerList> playerlist );
 map<uint32_t, string> MySQLGetAliases( void *conn, string *error, uint32_t botid );
+vector<PlayerIdP> MySQLGetRecentPlayerIds( void *conn, string *error, uint32_t botid, uint32_t count );
 
 //
 // MySQL Callables
@@ -327,6 +339,17 @@ public:
 	virtual void Close( ) { CMySQLCallable :: Close( ); }
 };
 
+class CMySQLCallableDotAEloUpdate : public CCallableDotAEloUpdate, public CMySQLCallable
+{
+public:
+	CMySQLCallableDotAEloUpdate( uint32_t nGameID, uint32_t nWinner, vector<string> nNames, vector<string> nServers, vector<uint32_t> nTeams, void *nConnection, uint32_t nSQLBotID, string nSQLServer, string nSQLDatabase, string nSQLUser, string nSQLPassword, uint16_t nSQLPort ) : CBaseCallable( ), CCallableDotAEloUpdate( nGameID, nWinner, nNames, nServers, nTeams ), CMySQLCallable( nConnection, nSQLBotID, nSQLServer, nSQLDatabase, nSQLUser, nSQLPassword, nSQLPort ) { }
+	virtual ~CMySQLCallableDotAEloUpdate( ) { }
+
+	virtual void operator( )( );
+	virtual void Init( ) { CMySQLCallable :: Init( ); }
+	virtual void Close( ) { CMySQLCallable :: Close( ); }
+};
+
 class CMySQLCallableDownloadAdd : public CCallableDownloadAdd, public CMySQLCallable
 {
 public:
@@ -468,6 +491,17 @@ public:
 	virtual void Close( ) { CMySQLCallable :: Close( ); }
 };
 
+class CMySQLCallableGetRecentPlayerIds : public CCallableGetRecentPlayerIds, public CMySQLCallable
+{
+public:
+	CMySQLCallableGetRecentPlayerIds( uint32_t nCount, void *nConnection, uint32_t nSQLBotID, string nSQLServer, string nSQLDatabase, string nSQLUser, string nSQLPassword, uint16_t nSQLPort ) : CBaseCallable( ), CCallableGetRecentPlayerIds( nCount ), CMySQLCallable( nConnection, nSQLBotID, nSQLServer, nSQLDatabase, nSQLUser, nSQLPassword, nSQLPort ) { }
+	virtual ~CMySQLCallableGetRecentPlayerIds( ) { }
+
+	virtual void operator( )( );
+	virtual void Init( ) { CMySQLCallable :: Init( ); }
+	virtual void Close( ) { CMySQLCallable :: Close( ); }
+};
+
 #endif
 
 #endif
@@ -36,21 +36,29 @@
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
+#include <deque>
+#include <list>
 #include <map>
 #include <queue>
 #include <set>
 #include <string>
 #include <vector>
 
+// boost
+
+#include <boost/shared_ptr.hpp>
+
 using namespace std;
 
 typedef vector<unsigned char> BYTEARRAY;
+typedef boost::shared_ptr<BYTEARRAY> SHAREDBYTEARRAY;	// a packet that's queued on several sockets at once (never modified once it's been queued)
 typedef pair<unsigned char,string> PIDPlayer;
 
 // time
 
 uint32_t GetTime( );		// seconds
 uint32_t GetTicks( );		// milliseconds
+uint64_t GetMicroTicks( );	// microseconds (only use this for measuring short intervals)
 
 #ifdef WIN32
  #define MILLISLEEP( x ) Sleep( x )
@@ -65,6 +73,11 @@ uint32_t GetTicks( );		// milliseconds
 
 // output
 
+#define LOG_INFO	1		// regular messages
+#define LOG_DEBUG	2		// high volume messages (per download, per lag, per stat, etc...)
+#define LOG_TRACE	3		// DEBUG_Print output (packet dumps, etc...), always printed to the console but only logged at this level
+
+void LOG_Print( uint32_t level, string message );
 void CONSOLE_Print( string message );
 void DEBUG_Print( string message );
 void DEBUG_Print( BYTEARRAY b );
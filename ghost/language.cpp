@@ -27,10 +27,243 @@
 // CLanguage
 //
 
+// the placeholders each message accepts in the same order as the values the message's function passes to Format
+// e.g. lang_0001 accepts $SERVER$ and $GAMENAME$ so in UnableToCreateGameTryAnotherName values[0] is the server and values[1] is the game name
+
+static const char *LanguageKeys[LANGUAGE_MESSAGES + 1] =
+{
+	"",												// unused
+	"$SERVER$ $GAMENAME$",							// lang_0001
+	"$SERVER$ $USER$",								// lang_0002
+	"$SERVER$ $USER$",								// lang_0003
+	"$SERVER$ $USER$",								// lang_0004
+	"",												// lang_0005
+	"$SERVER$ $VICTIM$",							// lang_0006
+	"$SERVER$ $VICTIM$",							// lang_0007
+	"$SERVER$ $VICTIM$",							// lang_0008
+	"$SERVER$ $USER$",								// lang_0009
+	"$SERVER$ $USER$",								// lang_0010
+	"$SERVER$ $VICTIM$ $DATE$ $ADMIN$ $REASON$",	// lang_0011
+	"$SERVER$ $VICTIM$",							// lang_0012
+	"$SERVER$",										// lang_0013
+	"$SERVER$",										// lang_0014
+	"$SERVER$ $COUNT$",								// lang_0015
+	"$SERVER$",										// lang_0016
+	"$SERVER$",										// lang_0017
+	"$SERVER$ $COUNT$",								// lang_0018
+	"",												// lang_0019
+	"$SERVER$ $USER$",								// lang_0020
+	"$SERVER$ $USER$",								// lang_0021
+	"$VICTIM$",										// lang_0022
+	"$VICTIM$",										// lang_0023
+	"$NUMBER$ $DESCRIPTION$",						// lang_0024
+	"$NUMBER$",										// lang_0025
+	"$DESCRIPTION$ $CURRENT$ $MAX$",				// lang_0026
+	"$CURRENT$ $MAX$",								// lang_0027
+	"",												// lang_0028
+	"$FILE$",										// lang_0029
+	"$FILE$",										// lang_0030
+	"$GAMENAME$ $USER$",							// lang_0031
+	"$GAMENAME$ $USER$",							// lang_0032
+	"$DESCRIPTION$",								// lang_0033
+	"$DESCRIPTION$",								// lang_0034
+	"",												// lang_0035
+	"$VERSION$",									// lang_0036
+	"$VERSION$",									// lang_0037
+	"$GAMENAME$ $DESCRIPTION$",						// lang_0038
+	"$GAMENAME$ $MAX$",								// lang_0039
+	"$DESCRIPTION$",								// lang_0040
+	"",												// lang_0041
+	"",												// lang_0042
+	"$USER$",										// lang_0043
+	"$USER$",										// lang_0044
+	"$USER$",										// lang_0045
+	"$USER$",										// lang_0046
+	"$USER$",										// lang_0047
+	"$USER$",										// lang_0048
+	"",												// lang_0049
+	"$VICTIM$",										// lang_0050
+	"$VICTIM$",										// lang_0051
+	"$SERVER$ $VICTIM$ $USER$",						// lang_0052
+	"$VICTIM$",										// lang_0053
+	"$USER$",										// lang_0054
+	"$VICTIM$",										// lang_0055
+	"$VICTIM$",										// lang_0056
+	"$MIN$",										// lang_0057
+	"$MAX$",										// lang_0058
+	"$LATENCY$",									// lang_0059
+	"$TOTAL$ $PING$",								// lang_0060
+	"$USER$ $FIRSTGAME$ $LASTGAME$ $TOTALGAMES$ $AVGLOADINGTIME$ $AVGSTAY$",	// lang_0061
+	"$USER$",										// lang_0062
+	"$VICTIM$ $PING$",								// lang_0063
+	"$SERVER$ $USER$",								// lang_0064
+	"$NOTSPOOFCHECKED$",							// lang_0065
+	"$HOSTNAME$",									// lang_0066
+	"$HOSTNAME$",									// lang_0067
+	"",												// lang_0068
+	"$NOTPINGED$",									// lang_0069
+	"",												// lang_0070
+	"$USER$ $LOADINGTIME$",							// lang_0071
+	"$USER$ $LOADINGTIME$",							// lang_0072
+	"$LOADINGTIME$",								// lang_0073
+	"$USER$ $TOTALGAMES$ $TOTALWINS$ $TOTALLOSSES$ $TOTALKILLS$ $TOTALDEATHS$ $TOTALCREEPKILLS$ $TOTALCREEPDENIES$ $TOTALASSISTS$ $TOTALNEUTRALKILLS$ $TOTALTOWERKILLS$ $TOTALRAXKILLS$ $TOTALCOURIERKILLS$ $AVGKILLS$ $AVGDEATHS$ $AVGCREEPKILLS$ $AVGCREEPDENIES$ $AVGASSISTS$ $AVGNEUTRALKILLS$ $AVGTOWERKILLS$ $AVGRAXKILLS$ $AVGCOURIERKILLS$",	// lang_0074
+	"$USER$",										// lang_0075
+	"$RESERVED$",									// lang_0076
+	"$OWNER$",										// lang_0077
+	"$USER$",										// lang_0078
+	"$ERROR$",										// lang_0079
+	"$ERROR$",										// lang_0080
+	"",												// lang_0081
+	"",												// lang_0082
+	"$DESCRIPTION$",								// lang_0083
+	"",												// lang_0084
+	"",												// lang_0085
+	"",												// lang_0086
+	"",												// lang_0087
+	"",												// lang_0088
+	"$STILLDOWNLOADING$",							// lang_0089
+	"",												// lang_0090
+	"",												// lang_0091
+	"",												// lang_0092
+	"$MAPCFG$",										// lang_0093
+	"",												// lang_0094
+	"",												// lang_0095
+	"$USER$",										// lang_0096
+	"$LATENCY$",									// lang_0097
+	"$SYNCLIMIT$",									// lang_0098
+	"$MIN$",										// lang_0099
+	"$MAX$",										// lang_0100
+	"$SYNCLIMIT$",									// lang_0101
+	"$GAMENAME$",									// lang_0102
+	"",												// lang_0103
+	"$ATTEMPT$",									// lang_0104
+	"$SERVER$",										// lang_0105
+	"$SERVER$",										// lang_0106
+	"$SERVER$",										// lang_0107
+	"$SERVER$",										// lang_0108
+	"$SERVER$",										// lang_0109
+	"$SERVER$ $GAMENAME$",							// lang_0110
+	"$SERVER$",										// lang_0111
+	"$USER$ $SECONDS$ $RATE$",						// lang_0112
+	"$GAMENAME$",									// lang_0113
+	"$OWNER$",										// lang_0114
+	"",												// lang_0115
+	"",												// lang_0116
+	"",												// lang_0117
+	"$VICTIM$",										// lang_0118
+	"$VICTIM$",										// lang_0119
+	"$OWNER$",										// lang_0120
+	"$VICTIM$",										// lang_0121
+	"$VICTIM$ $PING$ $FROM$ $ADMIN$ $OWNER$ $SPOOFED$ $SPOOFEDREALM$ $RESERVED$",	// lang_0122
+	"$VICTIM$",										// lang_0123
+	"",												// lang_0124
+	"$GAMENAME$",									// lang_0125
+	"",												// lang_0126
+	"",												// lang_0127
+	"$GAMENAME$",									// lang_0128
+	"$PLAYERS$ $PLAYERSLEFT$",						// lang_0129
+	"",												// lang_0130
+	"$PLAYERS$",									// lang_0131
+	"",												// lang_0132
+	"",												// lang_0133
+	"",												// lang_0134
+	"",												// lang_0135
+	"",												// lang_0136
+	"",												// lang_0137
+	"$FILE$",										// lang_0138
+	"$FILE$",										// lang_0139
+	"$GAMENAME$",									// lang_0140
+	"$GAMENAME$",									// lang_0141
+	"",												// lang_0142
+	"",												// lang_0143
+	"",												// lang_0144
+	"$VICTIM$",										// lang_0145
+	"$VICTIM$ $USER$",								// lang_0146
+	"$VICTIM$ $USER$",								// lang_0147
+	"$VICTIM$",										// lang_0148
+	"$PLAYER$",										// lang_0149
+	"",												// lang_0150
+	"",												// lang_0151
+	"$PLAYER$ $OTHERS$",							// lang_0152
+	"",												// lang_0153
+	"",												// lang_0154
+	"$VICTIM$",										// lang_0155
+	"$VICTIM$",										// lang_0156
+	"$VICTIM$ $USER$ $VOTESNEEDED$",				// lang_0157
+	"$VICTIM$",										// lang_0158
+	"$VICTIM$",										// lang_0159
+	"$VICTIM$",										// lang_0160
+	"$VICTIM$ $USER$ $VOTES$",						// lang_0161
+	"$VICTIM$",										// lang_0162
+	"$VICTIM$",										// lang_0163
+	"",												// lang_0164
+	"$COMMANDTRIGGER$",								// lang_0165
+	"$NOTPINGED$",									// lang_0166
+	"",												// lang_0167
+	"$SCORE$ $AVERAGE$",							// lang_0168
+	"$PLAYER$ $SCORE$",								// lang_0169
+	"$RATED$ $TOTAL$ $SPREAD$",						// lang_0170
+	"",												// lang_0171
+	"$MAPS$",										// lang_0172
+	"",												// lang_0173
+	"",												// lang_0174
+	"$MAPCONFIGS$",									// lang_0175
+	"",												// lang_0176
+	"$USER$",										// lang_0177
+	"",												// lang_0178
+	"",												// lang_0179
+	"",												// lang_0180
+	"",												// lang_0181
+	"$HCL$",										// lang_0182
+	"",												// lang_0183
+	"",												// lang_0184
+	"$HCL$",										// lang_0185
+	"",												// lang_0186
+	"",												// lang_0187
+	"$GAMENAME$",									// lang_0188
+	"$GAMENAME$",									// lang_0189
+	"",												// lang_0190
+	"$VICTIM$",										// lang_0191
+	"$VICTIM$ $IP$ $BANNEDNAME$",					// lang_0192
+	"$VICTIM$",										// lang_0193
+	"$VICTIM$ $IP$ $BANNEDNAME$",					// lang_0194
+	"$NUMBER$ $PLAYERS$",							// lang_0195
+	"$SERVERS$",									// lang_0196
+	"$TEAM$ $SCORE$",								// lang_0197
+	"",												// lang_0198
+	"$NAME$ $SCORE$ $AVERAGE$",						// lang_0199
+	"",												// lang_0200
+	"",												// lang_0201
+	"",												// lang_0202
+	"$SCORE$",										// lang_0203
+	"$NAME$ $SCORE$",								// lang_0204
+	"",												// lang_0205
+	"",												// lang_0206
+	"$GAMENAME$",									// lang_0207
+	"",												// lang_0208
+	"$FILE$",										// lang_0209
+	"$FILE$",										// lang_0210
+	"$TRIGGER$",									// lang_0211
+	"$OWNER$",										// lang_0212
+	"$OWNER$",										// lang_0213
+	"$SECONDS$",									// lang_0214
+	"",												// lang_0215
+	"$ERROR$",										// lang_0216
+	"",												// lang_0217
+	"$SECONDS$",									// lang_0218
+	"",												// lang_0219
+	"$NAME$",										// lang_0220
+};
+
 CLanguage :: CLanguage( string nCFGFile )
 {
 	m_CFG = new CConfig( );
 	m_CFG->Read( nCFGFile );
+	m_Messages.resize( LANGUAGE_MESSAGES + 1 );
+	m_Buffer.reserve( 512 );
+
+	for( uint32_t i = 1; i <= LANGUAGE_MESSAGES; i++ )
+		Compile( i, m_CFG->GetString( GetKey( i ), GetKey( i ) ) );
 }
 
 CLanguage :: ~CLanguage( )
@@ -38,1498 +271,1345 @@ CLanguage :: ~CLanguage( )
 	delete m_CFG;
 }
 
+void CLanguage :: SetTranslations( map<uint32_t, string> translations )
+{
+	// translations from the database replace the messages from the language file
+	// recompile every message so that a message which is no longer translated goes back to the language file's text
+
+	uint32_t Translated = 0;
+
+	for( uint32_t i = 1; i <= LANGUAGE_MESSAGES; i++ )
+	{
+		map<uint32_t, string> :: iterator Translation = translations.find( i );
+
+		if( Translation != translations.end( ) )
+		{
+			Compile( i, Translation->second );
+			Translated++;
+		}
+		else
+			Compile( i, m_CFG->GetString( GetKey( i ), GetKey( i ) ) );
+	}
+
+	CONSOLE_Print( "[LANGUAGE] using " + UTIL_ToString( Translated ) + " translated messages from the database" );
+}
+
+string CLanguage :: GetKey( uint32_t id )
+{
+	ostringstream SS;
+	SS << "lang_" << setfill( '0' ) << setw( 4 ) << id;
+	return SS.str( );
+}
+
+void CLanguage :: Compile( uint32_t id, string text )
+{
+	// split the message into literal text and placeholders
+	// anything between two dollar signs which isn't one of the message's placeholders is left alone (e.g. "costs $5 or $10")
+
+	vector<string> Keys;
+	stringstream SS( LanguageKeys[id] );
+	string Key;
+
+	while( SS >> Key )
+		Keys.push_back( Key );
+
+	vector<CLanguageSegment> &Segments = m_Messages[id];
+	Segments.clear( );
+	CLanguageSegment Segment;
+	Segment.m_Value = -1;
+	string :: size_type Start = 0;
+	string :: size_type Dollar = text.find( '$' );
+
+	while( Dollar != string :: npos )
+	{
+		string :: size_type End = text.find( '$', Dollar + 1 );
+
+		if( End == string :: npos )
+			break;
+
+		vector<string> :: iterator i = find( Keys.begin( ), Keys.end( ), text.substr( Dollar, End - Dollar + 1 ) );
+
+		if( i != Keys.end( ) )
+		{
+			Segment.m_Text = text.substr( Start, Dollar - Start );
+			Segment.m_Value = i - Keys.begin( );
+			Segments.push_back( Segment );
+			Start = End + 1;
+			Dollar = text.find( '$', Start );
+		}
+		else
+			Dollar = End;
+	}
+
+	Segment.m_Text = text.substr( Start );
+	Segment.m_Value = -1;
+	Segments.push_back( Segment );
+}
+
+string CLanguage :: Format( uint32_t id, const string **values )
+{
+	m_Buffer.clear( );
+
+	for( vector<CLanguageSegment> :: iterator i = m_Messages[id].begin( ); i != m_Messages[id].end( ); i++ )
+	{
+		m_Buffer += i->m_Text;
+
+		if( i->m_Value >= 0 )
+			m_Buffer += *values[i->m_Value];
+	}
+
+	return m_Buffer;
+}
+
 string CLanguage :: UnableToCreateGameTryAnotherName( string server, string gamename )
 {
-	string Out = m_CFG->GetString( "lang_0001", "lang_0001" );
-	UTIL_Replace( Out, "$SERVER$", server );
-	UTIL_Replace( Out, "$GAMENAME$", gamename );
-	return Out;
+	const string *Values[] = { &server, &gamename };
+	return Format( 1, Values );
 }
 
 string CLanguage :: UserIsAlreadyAnAdmin( string server, string user )
 {
-	string Out = m_CFG->GetString( "lang_0002", "lang_0002" );
-	UTIL_Replace( Out, "$SERVER$", server );
-	UTIL_Replace( Out, "$USER$", user );
-	return Out;
+	const string *Values[] = { &server, &user };
+	return Format( 2, Values );
 }
 
 string CLanguage :: AddedUserToAdminDatabase( string server, string user )
 {
-	string Out = m_CFG->GetString( "lang_0003", "lang_0003" );
-	UTIL_Replace( Out, "$SERVER$", server );
-	UTIL_Replace( Out, "$USER$", user );
-	return Out;
+	const string *Values[] = { &server, &user };
+	return Format( 3, Values );
 }
 
 string CLanguage :: ErrorAddingUserToAdminDatabase( string server, string user )
 {
-	string Out = m_CFG->GetString( "lang_0004", "lang_0004" );
-	UTIL_Replace( Out, "$SERVER$", server );
-	UTIL_Replace( Out, "$USER$", user );
-	return Out;
+	const string *Values[] = { &server, &user };
+	return Format( 4, Values );
 }
 
 string CLanguage :: YouDontHaveAccessToThatCommand( )
 {
-	return m_CFG->GetString( "lang_0005", "lang_0005" );
+	return Format( 5, NULL );
 }
 
 string CLanguage :: UserIsAlreadyBanned( string server, string victim )
 {
-	string Out = m_CFG->GetString( "lang_0006", "lang_0006" );
-	UTIL_Replace( Out, "$SERVER$", server );
-	UTIL_Replace( Out, "$VICTIM$", victim );
-	return Out;
+	const string *Values[] = { &server, &victim };
+	return Format( 6, Values );
 }
 
 string CLanguage :: BannedUser( string server, string victim )
 {
-	string Out = m_CFG->GetString( "lang_0007", "lang_0007" );
-	UTIL_Replace( Out, "$SERVER$", server );
-	UTIL_Replace( Out, "$VICTIM$", victim );
-	return Out;
+	const string *Values[] = { &server, &victim };
+	return Format( 7, Values );
 }
 
 string CLanguage :: ErrorBanningUser( string server, string victim )
 {
-	string Out = m_CFG->GetString( "lang_0008", "lang_0008" );
-	UTIL_Replace( Out, "$SERVER$", server );
-	UTIL_Replace( Out, "$VICTIM$", victim );
-	return Out;
+	const string *Values[] = { &server, &victim };
+	return Format( 8, Values );
 }
 
 string CLanguage :: UserIsAnAdmin( string server, string user )
 {
-	string Out = m_CFG->GetString( "lang_0009", "lang_0009" );
-	UTIL_Replace( Out, "$SERVER$", server );
-	UTIL_Replace( Out, "$USER$", user );
-	return Out;
+	const string *Values[] = { &server, &user };
+	return Format( 9, Values );
 }
 
 string CLanguage :: UserIsNotAnAdmin( string server, string user )
 {
-	string Out = m_CFG->GetString( "lang_0010", "lang_0010" );
-	UTIL_Replace( Out, "$SERVER$", server );
-	UTIL_Replace( Out, "$USER$", user );
-	return Out;
+	const string *Values[] = { &server, &user };
+	return Format( 10, Values );
 }
 
 string CLanguage :: UserWasBannedOnByBecause( string server, string victim, string date, string admin, string reason )
 {
-	string Out = m_CFG->GetString( "lang_0011", "lang_0011" );
-	UTIL_Replace( Out, "$SERVER$", server );
-	UTIL_Replace( Out, "$VICTIM$", victim );
-	UTIL_Replace( Out, "$DATE$", date );
-	UTIL_Replace( Out, "$ADMIN$", admin );
-	UTIL_Replace( Out, "$REASON$", reason );
-	return Out;
+	const string *Values[] = { &server, &victim, &date, &admin, &reason };
+	return Format( 11, Values );
 }
 
 string CLanguage :: UserIsNotBanned( string server, string victim )
 {
-	string Out = m_CFG->GetString( "lang_0012", "lang_0012" );
-	UTIL_Replace( Out, "$SERVER$", server );
-	UTIL_Replace( Out, "$VICTIM$", victim );
-	return Out;
+	const string *Values[] = { &server, &victim };
+	return Format( 12, Values );
 }
 
 string CLanguage :: ThereAreNoAdmins( string server )
 {
-	string Out = m_CFG->GetString( "lang_0013", "lang_0013" );
-	UTIL_Replace( Out, "$SERVER$", server );
-	return Out;
+	const string *Values[] = { &server };
+	return Format( 13, Values );
 }
 
 string CLanguage :: ThereIsAdmin( string server )
 {
-	string Out = m_CFG->GetString( "lang_0014", "lang_0014" );
-	UTIL_Replace( Out, "$SERVER$", server );
-	return Out;
+	const string *Values[] = { &server };
+	return Format( 14, Values );
 }
 
 string CLanguage :: ThereAreAdmins( string server, string count )
 {
-	string Out = m_CFG->GetString( "lang_0015", "lang_0015" );
-	UTIL_Replace( Out, "$SERVER$", server );
-	UTIL_Replace( Out, "$COUNT$", count );
-	return Out;
+	const string *Values[] = { &server, &count };
+	return Format( 15, Values );
 }
 
 string CLanguage :: ThereAreNoBannedUsers( string server )
 {
-	string Out = m_CFG->GetString( "lang_0016", "lang_0016" );
-	UTIL_Replace( Out, "$SERVER$", server );
-	return Out;
+	const string *Values[] = { &server };
+	return Format( 16, Values );
 }
 
 string CLanguage :: ThereIsBannedUser( string server )
 {
-	string Out = m_CFG->GetString( "lang_0017", "lang_0017" );
-	UTIL_Replace( Out, "$SERVER$", server );
-	return Out;
+	const string *Values[] = { &server };
+	return Format( 17, Values );
 }
 
 string CLanguage :: ThereAreBannedUsers( string server, string count )
 {
-	string Out = m_CFG->GetString( "lang_0018", "lang_0018" );
-	UTIL_Replace( Out, "$SERVER$", server );
-	UTIL_Replace( Out, "$COUNT$", count );
-	return Out;
+	const string *Values[] = { &server, &count };
+	return Format( 18, Values );
 }
 
 string CLanguage :: YouCantDeleteTheRootAdmin( )
 {
-	return m_CFG->GetString( "lang_0019", "lang_0019" );
+	return Format( 19, NULL );
 }
 
 string CLanguage :: DeletedUserFromAdminDatabase( string server, string user )
 {
-	string Out = m_CFG->GetString( "lang_0020", "lang_0020" );
-	UTIL_Replace( Out, "$SERVER$", server );
-	UTIL_Replace( Out, "$USER$", user );
-	return Out;
+	const string *Values[] = { &server, &user };
+	return Format( 20, Values );
 }
 
 string CLanguage :: ErrorDeletingUserFromAdminDatabase( string server, string user )
 {
-	string Out = m_CFG->GetString( "lang_0021", "lang_0021" );
-	UTIL_Replace( Out, "$SERVER$", server );
-	UTIL_Replace( Out, "$USER$", user );
-	return Out;
+	const string *Values[] = { &server, &user };
+	return Format( 21, Values );
 }
 
 string CLanguage :: UnbannedUser( string victim )
 {
-	string Out = m_CFG->GetString( "lang_0022", "lang_0022" );
-	UTIL_Replace( Out, "$VICTIM$", victim );
-	return Out;
+	const string *Values[] = { &victim };
+	return Format( 22, Values );
 }
 
 string CLanguage :: ErrorUnbanningUser( string victim )
 {
-	string Out = m_CFG->GetString( "lang_0023", "lang_0023" );
-	UTIL_Replace( Out, "$VICTIM$", victim );
-	return Out;
+	const string *Values[] = { &victim };
+	return Format( 23, Values );
 }
 
 string CLanguage :: GameNumberIs( string number, string description )
 {
-	string Out = m_CFG->GetString( "lang_0024", "lang_0024" );
-	UTIL_Replace( Out, "$NUMBER$", number );
-	UTIL_Replace( Out, "$DESCRIPTION$", description );
-	return Out;
+	const string *Values[] = { &number, &description };
+	return Format( 24, Values );
 }
 
 string CLanguage :: GameNumberDoesntExist( string number )
 {
-	string Out = m_CFG->GetString( "lang_0025", "lang_0025" );
-	UTIL_Replace( Out, "$NUMBER$", number );
-	return Out;
+	const string *Values[] = { &number };
+	return Format( 25, Values );
 }
 
 string CLanguage :: GameIsInTheLobby( string description, string current, string max )
 {
-	string Out = m_CFG->GetString( "lang_0026", "lang_0026" );
-	UTIL_Replace( Out, "$DESCRIPTION$", description );
-	UTIL_Replace( Out, "$CURRENT$", current );
-	UTIL_Replace( Out, "$MAX$", max );
-	return Out;
+	const string *Values[] = { &description, &current, &max };
+	return Format( 26, Values );
 }
 
 string CLanguage :: ThereIsNoGameInTheLobby( string current, string max )
 {
-	string Out = m_CFG->GetString( "lang_0027", "lang_0027" );
-	UTIL_Replace( Out, "$CURRENT$", current );
-	UTIL_Replace( Out, "$MAX$", max );
-	return Out;
+	const string *Values[] = { &current, &max };
+	return Format( 27, Values );
 }
 
 string CLanguage :: UnableToLoadConfigFilesOutside( )
 {
-	return m_CFG->GetString( "lang_0028", "lang_0028" );
+	return Format( 28, NULL );
 }
 
 string CLanguage :: LoadingConfigFile( string file )
 {
-	string Out = m_CFG->GetString( "lang_0029", "lang_0029" );
-	UTIL_Replace( Out, "$FILE$", file );
-	return Out;
+	const string *Values[] = { &file };
+	return Format( 29, Values );
 }
 
 string CLanguage :: UnableToLoadConfigFileDoesntExist( string file )
 {
-	string Out = m_CFG->GetString( "lang_0030", "lang_0030" );
-	UTIL_Replace( Out, "$FILE$", file );
-	return Out;
+	const string *Values[] = { &file };
+	return Format( 30, Values );
 }
 
 string CLanguage :: CreatingPrivateGame( string gamename, string user )
 {
-	string Out = m_CFG->GetString( "lang_0031", "lang_0031" );
-	UTIL_Replace( Out, "$GAMENAME$", gamename );
-	UTIL_Replace( Out, "$USER$", user );
-	return Out;
+	const string *Values[] = { &gamename, &user };
+	return Format( 31, Values );
 }
 
 string CLanguage :: CreatingPublicGame( string gamename, string user )
 {
-	string Out = m_CFG->GetString( "lang_0032", "lang_0032" );
-	UTIL_Replace( Out, "$GAMENAME$", gamename );
-	UTIL_Replace( Out, "$USER$", user );
-	return Out;
+	const string *Values[] = { &gamename, &user };
+	return Format( 32, Values );
 }
 
 string CLanguage :: UnableToUnhostGameCountdownStarted( string description )
 {
-	string Out = m_CFG->GetString( "lang_0033", "lang_0033" );
-	UTIL_Replace( Out, "$DESCRIPTION$", description );
-	return Out;
+	const string *Values[] = { &description };
+	return Format( 33, Values );
 }
 
 string CLanguage :: UnhostingGame( string description )
 {
-	string Out = m_CFG->GetString( "lang_0034", "lang_0034" );
-	UTIL_Replace( Out, "$DESCRIPTION$", description );
-	return Out;
+	const string *Values[] = { &description };
+	return Format( 34, Values );
 }
 
 string CLanguage :: UnableToUnhostGameNoGameInLobby( )
 {
-	return m_CFG->GetString( "lang_0035", "lang_0035" );
+	return Format( 35, NULL );
 }
 
 string CLanguage :: VersionAdmin( string version )
 {
-	string Out = m_CFG->GetString( "lang_0036", "lang_0036" );
-	UTIL_Replace( Out, "$VERSION$", version );
-	return Out;
+	const string *Values[] = { &version };
+	return Format( 36, Values );
 }
 
 string CLanguage :: VersionNotAdmin( string version )
 {
-	string Out = m_CFG->GetString( "lang_0037", "lang_0037" );
-	UTIL_Replace( Out, "$VERSION$", version );
-	return Out;
+	const string *Values[] = { &version };
+	return Format( 37, Values );
 }
 
 string CLanguage :: UnableToCreateGameAnotherGameInLobby( string gamename, string description )
 {
-	string Out = m_CFG->GetString( "lang_0038", "lang_0038" );
-	UTIL_Replace( Out, "$GAMENAME$", gamename );
-	UTIL_Replace( Out, "$DESCRIPTION$", description );
-	return Out;
+	const string *Values[] = { &gamename, &description };
+	return Format( 38, Values );
 }
 
 string CLanguage :: UnableToCreateGameMaxGamesReached( string gamename, string max )
 {
-	string Out = m_CFG->GetString( "lang_0039", "lang_0039" );
-	UTIL_Replace( Out, "$GAMENAME$", gamename );
-	UTIL_Replace( Out, "$MAX$", max );
-	return Out;
+	const string *Values[] = { &gamename, &max };
+	return Format( 39, Values );
 }
 
 string CLanguage :: GameIsOver( string description )
 {
-	string Out = m_CFG->GetString( "lang_0040", "lang_0040" );
-	UTIL_Replace( Out, "$DESCRIPTION$", description );
-	return Out;
+	const string *Values[] = { &description };
+	return Format( 40, Values );
 }
 
 string CLanguage :: SpoofCheckByReplying( )
 {
-	return m_CFG->GetString( "lang_0041", "lang_0041" );
+	return Format( 41, NULL );
 }
 
 string CLanguage :: GameRefreshed( )
 {
-	return m_CFG->GetString( "lang_0042", "lang_0042" );
+	return Format( 42, NULL );
 }
 
 string CLanguage :: SpoofPossibleIsAway( string user )
 {
-	string Out = m_CFG->GetString( "lang_0043", "lang_0043" );
-	UTIL_Replace( Out, "$USER$", user );
-	return Out;
+	const string *Values[] = { &user };
+	return Format( 43, Values );
 }
 
 string CLanguage :: SpoofPossibleIsUnavailable( string user )
 {
-	string Out = m_CFG->GetString( "lang_0044", "lang_0044" );
-	UTIL_Replace( Out, "$USER$", user );
-	return Out;
+	const string *Values[] = { &user };
+	return Format( 44, Values );
 }
 
 string CLanguage :: SpoofPossibleIsRefusingMessages( string user )
 {
-	string Out = m_CFG->GetString( "lang_0045", "lang_0045" );
-	UTIL_Replace( Out, "$USER$", user );
-	return Out;
+	const string *Values[] = { &user };
+	return Format( 45, Values );
 }
 
 string CLanguage :: SpoofDetectedIsNotInGame( string user )
 {
-	string Out = m_CFG->GetString( "lang_0046", "lang_0046" );
-	UTIL_Replace( Out, "$USER$", user );
-	return Out;
+	const string *Values[] = { &user };
+	return Format( 46, Values );
 }
 
 string CLanguage :: SpoofDetectedIsInPrivateChannel( string user )
 {
-	string Out = m_CFG->GetString( "lang_0047", "lang_0047" );
-	UTIL_Replace( Out, "$USER$", user );
-	return Out;
+	const string *Values[] = { &user };
+	return Format( 47, Values );
 }
 
 string CLanguage :: SpoofDetectedIsInAnotherGame( string user )
 {
-	string Out = m_CFG->GetString( "lang_0048", "lang_0048" );
-	UTIL_Replace( Out, "$USER$", user );
-	return Out;
+	const string *Values[] = { &user };
+	return Format( 48, Values );
 }
 
 string CLanguage :: CountDownAborted( )
 {
-	return m_CFG->GetString( "lang_0049", "lang_0049" );
+	return Format( 49, NULL );
 }
 
 string CLanguage :: TryingToJoinTheGameButBanned( string victim )
 {
-	string Out = m_CFG->GetString( "lang_0050", "lang_0050" );
-	UTIL_Replace( Out, "$VICTIM$", victim );
-	return Out;
+	const string *Values[] = { &victim };
+	return Format( 50, Values );
 }
 
 string CLanguage :: UnableToBanNoMatchesFound( string victim )
 {
-	string Out = m_CFG->GetString( "lang_0051", "lang_0051" );
-	UTIL_Replace( Out, "$VICTIM$", victim );
-	return Out;
+	const string *Values[] = { &victim };
+	return Format( 51, Values );
 }
 
 string CLanguage :: PlayerWasBannedByPlayer( string server, string victim, string user )
 {
-	string Out = m_CFG->GetString( "lang_0052", "lang_0052" );
-	UTIL_Replace( Out, "$SERVER$", server );
-	UTIL_Replace( Out, "$VICTIM$", victim );
-	UTIL_Replace( Out, "$USER$", user );
-	return Out;
+	const string *Values[] = { &server, &victim, &user };
+	return Format( 52, Values );
 }
 
 string CLanguage :: UnableToBanFoundMoreThanOneMatch( string victim )
 {
-	string Out = m_CFG->GetString( "lang_0053", "lang_0053" );
-	UTIL_Replace( Out, "$VICTIM$", victim );
-	return Out;
+	const string *Values[] = { &victim };
+	return Format( 53, Values );
 }
 
 string CLanguage :: AddedPlayerToTheHoldList( string user )
 {
-	string Out = m_CFG->GetString( "lang_0054", "lang_0054" );
-	UTIL_Replace( Out, "$USER$", user );
-	return Out;
+	const string *Values[] = { &user };
+	return Format( 54, Values );
 }
 
 string CLanguage :: UnableToKickNoMatchesFound( string victim )
 {
-	string Out = m_CFG->GetString( "lang_0055", "lang_0055" );
-	UTIL_Replace( Out, "$VICTIM$", victim );
-	return Out;
+	const string *Values[] = { &victim };
+	return Format( 55, Values );
 }
 
 string CLanguage :: UnableToKickFoundMoreThanOneMatch( string victim )
 {
-	string Out = m_CFG->GetString( "lang_0056", "lang_0056" );
-	UTIL_Replace( Out, "$VICTIM$", victim );
-	return Out;
+	const string *Values[] = { &victim };
+	return Format( 56, Values );
 }
 
 string CLanguage :: SettingLatencyToMinimum( string min )
 {
-	string Out = m_CFG->GetString( "lang_0057", "lang_0057" );
-	UTIL_Replace( Out, "$MIN$", min );
-	return Out;
+	const string *Values[] = { &min };
+	return Format( 57, Values );
 }
 
 string CLanguage :: SettingLatencyToMaximum( string max )
 {
-	string Out = m_CFG->GetString( "lang_0058", "lang_0058" );
-	UTIL_Replace( Out, "$MAX$", max );
-	return Out;
+	const string *Values[] = { &max };
+	return Format( 58, Values );
 }
 
 string CLanguage :: SettingLatencyTo( string latency )
 {
-	string Out = m_CFG->GetString( "lang_0059", "lang_0059" );
-	UTIL_Replace( Out, "$LATENCY$", latency );
-	return Out;
+	const string *Values[] = { &latency };
+	return Format( 59, Values );
 }
 
 string CLanguage :: KickingPlayersWithPingsGreaterThan( string total, string ping )
 {
-	string Out = m_CFG->GetString( "lang_0060", "lang_0060" );
-	UTIL_Replace( Out, "$TOTAL$", total );
-	UTIL_Replace( Out, "$PING$", ping );
-	return Out;
+	const string *Values[] = { &total, &ping };
+	return Format( 60, Values );
 }
 
 string CLanguage :: HasPlayedGamesWithThisBot( string user, string firstgame, string lastgame, string totalgames, string avgloadingtime, string avgstay )
 {
-	string Out = m_CFG->GetString( "lang_0061", "lang_0061" );
-	UTIL_Replace( Out, "$USER$", user );
-	UTIL_Replace( Out, "$FIRSTGAME$", firstgame );
-	UTIL_Replace( Out, "$LASTGAME$", lastgame );
-	UTIL_Replace( Out, "$TOTALGAMES$", totalgames );
-	UTIL_Replace( Out, "$AVGLOADINGTIME$", avgloadingtime );
-	UTIL_Replace( Out, "$AVGSTAY$", avgstay );
-	return Out;
+	const string *Values[] = { &user, &firstgame, &lastgame, &totalgames, &avgloadingtime, &avgstay };
+	return Format( 61, Values );
 }
 
 string CLanguage :: HasntPlayedGamesWithThisBot( string user )
 {
-	string Out = m_CFG->GetString( "lang_0062", "lang_0062" );
-	UTIL_Replace( Out, "$USER$", user );
-	return Out;
+	const string *Values[] = { &user };
+	return Format( 62, Values );
 }
 
 string CLanguage :: AutokickingPlayerForExcessivePing( string victim, string ping )
 {
-	string Out = m_CFG->GetString( "lang_0063", "lang_0063" );
-	UTIL_Replace( Out, "$VICTIM$", victim );
-	UTIL_Replace( Out, "$PING$", ping );
-	return Out;
+	const string *Values[] = { &victim, &ping };
+	return Format( 63, Values );
 }
 
 string CLanguage :: SpoofCheckAcceptedFor( string server, string user )
 {
-	string Out = m_CFG->GetString( "lang_0064", "lang_0064" );
-	UTIL_Replace( Out, "$SERVER$", server );
-	UTIL_Replace( Out, "$USER$", user );
-	return Out;
+	const string *Values[] = { &server, &user };
+	return Format( 64, Values );
 }
 
 string CLanguage :: PlayersNotYetSpoofChecked( string notspoofchecked )
 {
-	string Out = m_CFG->GetString( "lang_0065", "lang_0065" );
-	UTIL_Replace( Out, "$NOTSPOOFCHECKED$", notspoofchecked );
-	return Out;
+	const string *Values[] = { &notspoofchecked };
+	return Format( 65, Values );
 }
 
 string CLanguage :: ManuallySpoofCheckByWhispering( string hostname )
 {
-	string Out = m_CFG->GetString( "lang_0066", "lang_0066" );
-	UTIL_Replace( Out, "$HOSTNAME$", hostname );
-	return Out;
+	const string *Values[] = { &hostname };
+	return Format( 66, Values );
 }
 
 string CLanguage :: SpoofCheckByWhispering( string hostname )
 {
-	string Out = m_CFG->GetString( "lang_0067", "lang_0067" );
-	UTIL_Replace( Out, "$HOSTNAME$", hostname );
-	return Out;
+	const string *Values[] = { &hostname };
+	return Format( 67, Values );
 }
 
 string CLanguage :: EveryoneHasBeenSpoofChecked( )
 {
-	return m_CFG->GetString( "lang_0068", "lang_0068" );
+	return Format( 68, NULL );
 }
 
 string CLanguage :: PlayersNotYetPinged( string notpinged )
 {
-	string Out = m_CFG->GetString( "lang_0069", "lang_0069" );
-	UTIL_Replace( Out, "$NOTPINGED$", notpinged );
-	return Out;
+	const string *Values[] = { &notpinged };
+	return Format( 69, Values );
 }
 
 string CLanguage :: EveryoneHasBeenPinged( )
 {
-	return m_CFG->GetString( "lang_0070", "lang_0070" );
+	return Format( 70, NULL );
 }
 
 string CLanguage :: ShortestLoadByPlayer( string user, string loadingtime )
 {
-	string Out = m_CFG->GetString( "lang_0071", "lang_0071" );
-	UTIL_Replace( Out, "$USER$", user );
-	UTIL_Replace( Out, "$LOADINGTIME$", loadingtime );
-	return Out;
+	const string *Values[] = { &user, &loadingtime };
+	return Format( 71, Values );
 }
 
 string CLanguage :: LongestLoadByPlayer( string user, string loadingtime )
 {
-	string Out = m_CFG->GetString( "lang_0072", "lang_0072" );
-	UTIL_Replace( Out, "$USER$", user );
-	UTIL_Replace( Out, "$LOADINGTIME$", loadingtime );
-	return Out;
+	const string *Values[] = { &user, &loadingtime };
+	return Format( 72, Values );
 }
 
 string CLanguage :: YourLoadingTimeWas( string loadingtime )
 {
-	string Out = m_CFG->GetString( "lang_0073", "lang_0073" );
-	UTIL_Replace( Out, "$LOADINGTIME$", loadingtime );
-	return Out;
+	const string *Values[] = { &loadingtime };
+	return Format( 73, Values );
 }
 
 string CLanguage :: HasPlayedDotAGamesWithThisBot( string user, string totalgames, string totalwins, string totallosses, string totalkills, string totaldeaths, string totalcreepkills, string totalcreepdenies, string totalassists, string totalneutralkills, string totaltowerkills, string totalraxkills, string totalcourierkills, string avgkills, string avgdeaths, string avgcreepkills, string avgcreepdenies, string avgassists, string avgneutralkills, string avgtowerkills, string avgraxkills, string avgcourierkills )
 {
-	string Out = m_CFG->GetString( "lang_0074", "lang_0074" );
-	UTIL_Replace( Out, "$USER$", user );
-	UTIL_Replace( Out, "$TOTALGAMES$", totalgames );
-	UTIL_Replace( Out, "$TOTALWINS$", totalwins );
-	UTIL_Replace( Out, "$TOTALLOSSES$", totallosses );
-	UTIL_Replace( Out, "$TOTALKILLS$", totalkills );
-	UTIL_Replace( Out, "$TOTALDEATHS$", totaldeaths );
-	UTIL_Replace( Out, "$TOTALCREEPKILLS$", totalcreepkills );
-	UTIL_Replace( Out, "$TOTALCREEPDENIES$", totalcreepdenies );
-	UTIL_Replace( Out, "$TOTALASSISTS$", totalassists );
-	UTIL_Replace( Out, "$TOTALNEUTRALKILLS$", totalneutralkills );
-	UTIL_Replace( Out, "$TOTALTOWERKILLS$", totaltowerkills );
-	UTIL_Replace( Out, "$TOTALRAXKILLS$", totalraxkills );
-	UTIL_Replace( Out, "$TOTALCOURIERKILLS$", totalcourierkills );
-	UTIL_Replace( Out, "$AVGKILLS$", avgkills );
-	UTIL_Replace( Out, "$AVGDEATHS$", avgdeaths );
-	UTIL_Replace( Out, "$AVGCREEPKILLS$", avgcreepkills );
-	UTIL_Replace( Out, "$AVGCREEPDENIES$", avgcreepdenies );
-	UTIL_Replace( Out, "$AVGASSISTS$", avgassists );
-	UTIL_Replace( Out, "$AVGNEUTRALKILLS$", avgneutralkills );
-	UTIL_Replace( Out, "$AVGTOWERKILLS$", avgtowerkills );
-	UTIL_Replace( Out, "$AVGRAXKILLS$", avgraxkills );
-	UTIL_Replace( Out, "$AVGCOURIERKILLS$", avgcourierkills );
-	return Out;
+	const string *Values[] = { &user, &totalgames, &totalwins, &totallosses, &totalkills, &totaldeaths, &totalcreepkills, &totalcreepdenies, &totalassists, &totalneutralkills, &totaltowerkills, &totalraxkills, &totalcourierkills, &avgkills, &avgdeaths, &avgcreepkills, &avgcreepdenies, &avgassists, &avgneutralkills, &avgtowerkills, &avgraxkills, &avgcourierkills };
+	return Format( 74, Values );
 }
 
 string CLanguage :: HasntPlayedDotAGamesWithThisBot( string user )
 {
-	string Out = m_CFG->GetString( "lang_0075", "lang_0075" );
-	UTIL_Replace( Out, "$USER$", user );
-	return Out;
+	const string *Values[] = { &user };
+	return Format( 75, Values );
 }
 
 string CLanguage :: WasKickedForReservedPlayer( string reserved )
 {
-	string Out = m_CFG->GetString( "lang_0076", "lang_0076" );
-	UTIL_Replace( Out, "$RESERVED$", reserved );
-	return Out;
+	const string *Values[] = { &reserved };
+	return Format( 76, Values );
 }
 
 string CLanguage :: WasKickedForOwnerPlayer( string owner )
 {
-	string Out = m_CFG->GetString( "lang_0077", "lang_0077" );
-	UTIL_Replace( Out, "$OWNER$", owner );
-	return Out;
+	const string *Values[] = { &owner };
+	return Format( 77, Values );
 }
 
 string CLanguage :: WasKickedByPlayer( string user )
 {
-	string Out = m_CFG->GetString( "lang_0078", "lang_0078" );
-	UTIL_Replace( Out, "$USER$", user );
-	return Out;
+	const string *Values[] = { &user };
+	return Format( 78, Values );
 }
 
 string CLanguage :: HasLostConnectionPlayerError( string error )
 {
-	string Out = m_CFG->GetString( "lang_0079", "lang_0079" );
-	UTIL_Replace( Out, "$ERROR$", error );
-	return Out;
+	const string *Values[] = { &error };
+	return Format( 79, Values );
 }
 
 string CLanguage :: HasLostConnectionSocketError( string error )
 {
-	string Out = m_CFG->GetString( "lang_0080", "lang_0080" );
-	UTIL_Replace( Out, "$ERROR$", error );
-	return Out;
+	const string *Values[] = { &error };
+	return Format( 80, Values );
 }
 
 string CLanguage :: HasLostConnectionClosedByRemoteHost( )
 {
-	return m_CFG->GetString( "lang_0081", "lang_0081" );
+	return Format( 81, NULL );
 }
 
 string CLanguage :: HasLeftVoluntarily( )
 {
-	return m_CFG->GetString( "lang_0082", "lang_0082" );
+	return Format( 82, NULL );
 }
 
 string CLanguage :: EndingGame( string description )
 {
-	string Out = m_CFG->GetString( "lang_0083", "lang_0083" );
-	UTIL_Replace( Out, "$DESCRIPTION$", description );
-	return Out;
+	const string *Values[] = { &description };
+	return Format( 83, Values );
 }
 
 string CLanguage :: HasLostConnectionTimedOut( )
 {
-	return m_CFG->GetString( "lang_0084", "lang_0084" );
+	return Format( 84, NULL );
 }
 
 string CLanguage :: GlobalChatMuted( )
 {
-	return m_CFG->GetString( "lang_0085", "lang_0085" );
+	return Format( 85, NULL );
 }
 
 string CLanguage :: GlobalChatUnmuted( )
 {
-	return m_CFG->GetString( "lang_0086", "lang_0086" );
+	return Format( 86, NULL );
 }
 
 string CLanguage :: ShufflingPlayers( )
 {
-	return m_CFG->GetString( "lang_0087", "lang_0087" );
+	return Format( 87, NULL );
 }
 
 string CLanguage :: UnableToLoadConfigFileGameInLobby( )
 {
-	return m_CFG->GetString( "lang_0088", "lang_0088" );
+	return Format( 88, NULL );
 }
 
 string CLanguage :: PlayersStillDownloading( string stilldownloading )
 {
-	string Out = m_CFG->GetString( "lang_0089", "lang_0089" );
-	UTIL_Replace( Out, "$STILLDOWNLOADING$", stilldownloading );
-	return Out;
+	const string *Values[] = { &stilldownloading };
+	return Format( 89, Values );
 }
 
 string CLanguage :: RefreshMessagesEnabled( )
 {
-	return m_CFG->GetString( "lang_0090", "lang_0090" );
+	return Format( 90, NULL );
 }
 
 string CLanguage :: RefreshMessagesDisabled( )
 {
-	return m_CFG->GetString( "lang_0091", "lang_0091" );
+	return Format( 91, NULL );
 }
 
 string CLanguage :: AtLeastOneGameActiveUseForceToShutdown( )
 {
-	return m_CFG->GetString( "lang_0092", "lang_0092" );
+	return Format( 92, NULL );
 }
 
 string CLanguage :: CurrentlyLoadedMapCFGIs( string mapcfg )
 {
-	string Out = m_CFG->GetString( "lang_0093", "lang_0093" );
-	UTIL_Replace( Out, "$MAPCFG$", mapcfg );
-	return Out;
+	const string *Values[] = { &mapcfg };
+	return Format( 93, Values );
 }
 
 string CLanguage :: LaggedOutDroppedByAdmin( )
 {
-	return m_CFG->GetString( "lang_0094", "lang_0094" );
+	return Format( 94, NULL );
 }
 
 string CLanguage :: LaggedOutDroppedByVote( )
 {
-	return m_CFG->GetString( "lang_0095", "lang_0095" );
+	return Format( 95, NULL );
 }
 
 string CLanguage :: PlayerVotedToDropLaggers( string user )
 {
-	string Out = m_CFG->GetString( "lang_0096", "lang_0096" );
-	UTIL_Replace( Out, "$USER$", user );
-	return Out;
+	const string *Values[] = { &user };
+	return Format( 96, Values );
 }
 
 string CLanguage :: LatencyIs( string latency )
 {
-	string Out = m_CFG->GetString( "lang_0097", "lang_0097" );
-	UTIL_Replace( Out, "$LATENCY$", latency );
-	return Out;
+	const string *Values[] = { &latency };
+	return Format( 97, Values );
 }
 
 string CLanguage :: SyncLimitIs( string synclimit )
 {
-	string Out = m_CFG->GetString( "lang_0098", "lang_0098" );
-	UTIL_Replace( Out, "$SYNCLIMIT$", synclimit );
-	return Out;
+	const string *Values[] = { &synclimit };
+	return Format( 98, Values );
 }
 
 string CLanguage :: SettingSyncLimitToMinimum( string min )
 {
-	string Out = m_CFG->GetString( "lang_0099", "lang_0099" );
-	UTIL_Replace( Out, "$MIN$", min );
-	return Out;
+	const string *Values[] = { &min };
+	return Format( 99, Values );
 }
 
 string CLanguage :: SettingSyncLimitToMaximum( string max )
 {
-	string Out = m_CFG->GetString( "lang_0100", "lang_0100" );
-	UTIL_Replace( Out, "$MAX$", max );
-	return Out;
+	const string *Values[] = { &max };
+	return Format( 100, Values );
 }
 
 string CLanguage :: SettingSyncLimitTo( string synclimit )
 {
-	string Out = m_CFG->GetString( "lang_0101", "lang_0101" );
-	UTIL_Replace( Out, "$SYNCLIMIT$", synclimit );
-	return Out;
+	const string *Values[] = { &synclimit };
+	return Format( 101, Values );
 }
 
 string CLanguage :: UnableToCreateGameNotLoggedIn( string gamename )
 {
-	string Out = m_CFG->GetString( "lang_0102", "lang_0102" );
-	UTIL_Replace( Out, "$GAMENAME$", gamename );
-	return Out;
+	const string *Values[] = { &gamename };
+	return Format( 102, Values );
 }
 
 string CLanguage :: AdminLoggedIn( )
 {
-	return m_CFG->GetString( "lang_0103", "lang_0103" );
+	return Format( 103, NULL );
 }
 
 string CLanguage :: AdminInvalidPassword( string attempt )
 {
-	string Out = m_CFG->GetString( "lang_0104", "lang_0104" );
-	UTIL_Replace( Out, "$ATTEMPT$", attempt );
-	return Out;
+	const string *Values[] = { &attempt };
+	return Format( 104, Values );
 }
 
 string CLanguage :: ConnectingToBNET( string server )
 {
-	string Out = m_CFG->GetString( "lang_0105", "lang_0105" );
-	UTIL_Replace( Out, "$SERVER$", server );
-	return Out;
+	const string *Values[] = { &server };
+	return Format( 105, Values );
 }
 
 string CLanguage :: ConnectedToBNET( string server )
 {
-	string Out = m_CFG->GetString( "lang_0106", "lang_0106" );
-	UTIL_Replace( Out, "$SERVER$", server );
-	return Out;
+	const string *Values[] = { &server };
+	return Format( 106, Values );
 }
 
 string CLanguage :: DisconnectedFromBNET( string server )
 {
-	string Out = m_CFG->GetString( "lang_0107", "lang_0107" );
-	UTIL_Replace( Out, "$SERVER$", server );
-	return Out;
+	const string *Values[] = { &server };
+	return Format( 107, Values );
 }
 
 string CLanguage :: LoggedInToBNET( string server )
 {
-	string Out = m_CFG->GetString( "lang_0108", "lang_0108" );
-	UTIL_Replace( Out, "$SERVER$", server );
-	return Out;
+	const string *Values[] = { &server };
+	return Format( 108, Values );
 }
 
 string CLanguage :: BNETGameHostingSucceeded( string server )
 {
-	string Out = m_CFG->GetString( "lang_0109", "lang_0109" );
-	UTIL_Replace( Out, "$SERVER$", server );
-	return Out;
+	const string *Values[] = { &server };
+	return Format( 109, Values );
 }
 
 string CLanguage :: BNETGameHostingFailed( string server, string gamename )
 {
-	string Out = m_CFG->GetString( "lang_0110", "lang_0110" );
-	UTIL_Replace( Out, "$SERVER$", server );
-	UTIL_Replace( Out, "$GAMENAME$", gamename );
-	return Out;
+	const string *Values[] = { &server, &gamename };
+	return Format( 110, Values );
 }
 
 string CLanguage :: ConnectingToBNETTimedOut( string server )
 {
-	string Out = m_CFG->GetString( "lang_0111", "lang_0111" );
-	UTIL_Replace( Out, "$SERVER$", server );
-	return Out;
+	const string *Values[] = { &server };
+	return Format( 111, Values );
 }
 
 string CLanguage :: PlayerDownloadedTheMap( string user, string seconds, string rate )
 {
-	string Out = m_CFG->GetString( "lang_0112", "lang_0112" );
-	UTIL_Replace( Out, "$USER$", user );
-	UTIL_Replace( Out, "$SECONDS$", seconds );
-	UTIL_Replace( Out, "$RATE$", rate );
-	return Out;
+	const string *Values[] = { &user, &seconds, &rate };
+	return Format( 112, Values );
 }
 
 string CLanguage :: UnableToCreateGameNameTooLong( string gamename )
 {
-	string Out = m_CFG->GetString( "lang_0113", "lang_0113" );
-	UTIL_Replace( Out, "$GAMENAME$", gamename );
-	return Out;
+	const string *Values[] = { &gamename };
+	return Format( 113, Values );
 }
 
 string CLanguage :: SettingGameOwnerTo( string owner )
 {
-	string Out = m_CFG->GetString( "lang_0114", "lang_0114" );
-	UTIL_Replace( Out, "$OWNER$", owner );
-	return Out;
+	const string *Values[] = { &owner };
+	return Format( 114, Values );
 }
 
 string CLanguage :: TheGameIsLocked( )
 {
-	return m_CFG->GetString( "lang_0115", "lang_0115" );
+	return Format( 115, NULL );
 }
 
 string CLanguage :: GameLocked( )
 {
-	return m_CFG->GetString( "lang_0116", "lang_0116" );
+	return Format( 116, NULL );
 }
 
 string CLanguage :: GameUnlocked( )
 {
-	return m_CFG->GetString( "lang_0117", "lang_0117" );
+	return Format( 117, NULL );
 }
 
 string CLanguage :: UnableToStartDownloadNoMatchesFound( string victim )
 {
-	string Out = m_CFG->GetString( "lang_0118", "lang_0118" );
-	UTIL_Replace( Out, "$VICTIM$", victim );
-	return Out;
+	const string *Values[] = { &victim };
+	return Format( 118, Values );
 }
 
 string CLanguage :: UnableToStartDownloadFoundMoreThanOneMatch( string victim )
 {
-	string Out = m_CFG->GetString( "lang_0119", "lang_0119" );
-	UTIL_Replace( Out, "$VICTIM$", victim );
-	return Out;
+	const string *Values[] = { &victim };
+	return Format( 119, Values );
 }
 
 string CLanguage :: UnableToSetGameOwner( string owner )
 {
-	string Out = m_CFG->GetString( "lang_0120", "lang_0120" );
-	UTIL_Replace( Out, "$OWNER$", owner );
-	return Out;
+	const string *Values[] = { &owner };
+	return Format( 120, Values );
 }
 
 string CLanguage :: UnableToCheckPlayerNoMatchesFound( string victim )
 {
-	string Out = m_CFG->GetString( "lang_0121", "lang_0121" );
-	UTIL_Replace( Out, "$VICTIM$", victim );
-	return Out;
+	const string *Values[] = { &victim };
+	return Format( 121, Values );
 }
 
 string CLanguage :: CheckedPlayer( string victim, string ping, string from, string admin, string owner, string spoofed, string spoofedrealm, string reserved )
 {
-	string Out = m_CFG->GetString( "lang_0122", "lang_0122" );
-	UTIL_Replace( Out, "$VICTIM$", victim );
-	UTIL_Replace( Out, "$PING$", ping );
-	UTIL_Replace( Out, "$FROM$", from );
-	UTIL_Replace( Out, "$ADMIN$", admin );
-	UTIL_Replace( Out, "$OWNER$", owner );
-	UTIL_Replace( Out, "$SPOOFED$", spoofed );
-	UTIL_Replace( Out, "$SPOOFEDREALM$", spoofedrealm );
-	UTIL_Replace( Out, "$RESERVED$", reserved );
-	return Out;
+	const string *Values[] = { &victim, &ping, &from, &admin, &owner, &spoofed, &spoofedrealm, &reserved };
+	return Format( 122, Values );
 }
 
 string CLanguage :: UnableToCheckPlayerFoundMoreThanOneMatch( string victim )
 {
-	string Out = m_CFG->GetString( "lang_0123", "lang_0123" );
-	UTIL_Replace( Out, "$VICTIM$", victim );
-	return Out;
+	const string *Values[] = { &victim };
+	return Format( 123, Values );
 }
 
 string CLanguage :: TheGameIsLockedBNET( )
 {
-	return m_CFG->GetString( "lang_0124", "lang_0124" );
+	return Format( 124, NULL );
 }
 
 string CLanguage :: UnableToCreateGameDisabled( string gamename )
 {
-	string Out = m_CFG->GetString( "lang_0125", "lang_0125" );
-	UTIL_Replace( Out, "$GAMENAME$", gamename );
-	return Out;
+	const string *Values[] = { &gamename };
+	return Format( 125, Values );
 }
 
 string CLanguage :: BotDisabled( )
 {
-	return m_CFG->GetString( "lang_0126", "lang_0126" );
+	return Format( 126, NULL );
 }
 
 string CLanguage :: BotEnabled( )
 {
-	return m_CFG->GetString( "lang_0127", "lang_0127" );
+	return Format( 127, NULL );
 }
 
 string CLanguage :: UnableToCreateGameInvalidMap( string gamename )
 {
-	string Out = m_CFG->GetString( "lang_0128", "lang_0128" );
-	UTIL_Replace( Out, "$GAMENAME$", gamename );
-	return Out;
+	const string *Values[] = { &gamename };
+	return Format( 128, Values );
 }
 
 string CLanguage :: WaitingForPlayersBeforeAutoStart( string players, string playersleft )
 {
-	string Out = m_CFG->GetString( "lang_0129", "lang_0129" );
-	UTIL_Replace( Out, "$PLAYERS$", players );
-	UTIL_Replace( Out, "$PLAYERSLEFT$", playersleft );
-	return Out;
+	const string *Values[] = { &players, &playersleft };
+	return Format( 129, Values );
 }
 
 string CLanguage :: AutoStartDisabled( )
 {
-	return m_CFG->GetString( "lang_0130", "lang_0130" );
+	return Format( 130, NULL );
 }
 
 string CLanguage :: AutoStartEnabled( string players )
 {
-	string Out = m_CFG->GetString( "lang_0131", "lang_0131" );
-	UTIL_Replace( Out, "$PLAYERS$", players );
-	return Out;
+	const string *Values[] = { &players };
+	return Format( 131, Values );
 }
 
 string CLanguage :: AnnounceMessageEnabled( )
 {
-	return m_CFG->GetString( "lang_0132", "lang_0132" );
+	return Format( 132, NULL );
 }
 
 string CLanguage :: AnnounceMessageDisabled( )
 {
-	return m_CFG->GetString( "lang_0133", "lang_0133" );
+	return Format( 133, NULL );
 }
 
 string CLanguage :: AutoHostEnabled( )
 {
-	return m_CFG->GetString( "lang_0134", "lang_0134" );
+	return Format( 134, NULL );
 }
 
 string CLanguage :: AutoHostDisabled( )
 {
-	return m_CFG->GetString( "lang_0135", "lang_0135" );
+	return Format( 135, NULL );
 }
 
 string CLanguage :: UnableToLoadSaveGamesOutside( )
 {
-	return m_CFG->GetString( "lang_0136", "lang_0136" );
+	return Format( 136, NULL );
 }
 
 string CLanguage :: UnableToLoadSaveGameGameInLobby( )
 {
-	return m_CFG->GetString( "lang_0137", "lang_0137" );
+	return Format( 137, NULL );
 }
 
 string CLanguage :: LoadingSaveGame( string file )
 {
-	string Out = m_CFG->GetString( "lang_0138", "lang_0138" );
-	UTIL_Replace( Out, "$FILE$", file );
-	return Out;
+	const string *Values[] = { &file };
+	return Format( 138, Values );
 }
 
 string CLanguage :: UnableToLoadSaveGameDoesntExist( string file )
 {
-	string Out = m_CFG->GetString( "lang_0139", "lang_0139" );
-	UTIL_Replace( Out, "$FILE$", file );
-	return Out;
+	const string *Values[] = { &file };
+	return Format( 139, Values );
 }
 
 string CLanguage :: UnableToCreateGameInvalidSaveGame( string gamename )
 {
-	string Out = m_CFG->GetString( "lang_0140", "lang_0140" );
-	UTIL_Replace( Out, "$GAMENAME$", gamename );
-	return Out;
+	const string *Values[] = { &gamename };
+	return Format( 140, Values );
 }
 
 string CLanguage :: UnableToCreateGameSaveGameMapMismatch( string gamename )
 {
-	string Out = m_CFG->GetString( "lang_0141", "lang_0141" );
-	UTIL_Replace( Out, "$GAMENAME$", gamename );
-	return Out;
+	const string *Values[] = { &gamename };
+	return Format( 141, Values );
 }
 
 string CLanguage :: AutoSaveEnabled( )
 {
-	return m_CFG->GetString( "lang_0142", "lang_0142" );
+	return Format( 142, NULL );
 }
 
 string CLanguage :: AutoSaveDisabled( )
 {
-	return m_CFG->GetString( "lang_0143", "lang_0143" );
+	return Format( 143, NULL );
 }
 
 string CLanguage :: DesyncDetected( )
 {
-	return m_CFG->GetString( "lang_0144", "lang_0144" );
+	return Format( 144, NULL );
 }
 
 string CLanguage :: UnableToMuteNoMatchesFound( string victim )
 {
-	string Out = m_CFG->GetString( "lang_0145", "lang_0145" );
-	UTIL_Replace( Out, "$VICTIM$", victim );
-	return Out;
+	const string *Values[] = { &victim };
+	return Format( 145, Values );
 }
 
 string CLanguage :: MutedPlayer( string victim, string user )
 {
-	string Out = m_CFG->GetString( "lang_0146", "lang_0146" );
-	UTIL_Replace( Out, "$VICTIM$", victim );
-	UTIL_Replace( Out, "$USER$", user );
-	return Out;
+	const string *Values[] = { &victim, &user };
+	return Format( 146, Values );
 }
 
 string CLanguage :: UnmutedPlayer( string victim, string user )
 {
-	string Out = m_CFG->GetString( "lang_0147", "lang_0147" );
-	UTIL_Replace( Out, "$VICTIM$", victim );
-	UTIL_Replace( Out, "$USER$", user );
-	return Out;
+	const string *Values[] = { &victim, &user };
+	return Format( 147, Values );
 }
 
 string CLanguage :: UnableToMuteFoundMoreThanOneMatch( string victim )
 {
-	string Out = m_CFG->GetString( "lang_0148", "lang_0148" );
-	UTIL_Replace( Out, "$VICTIM$", victim );
-	return Out;
+	const string *Values[] = { &victim };
+	return Format( 148, Values );
 }
 
 string CLanguage :: PlayerIsSavingTheGame( string player )
 {
-	string Out = m_CFG->GetString( "lang_0149", "lang_0149" );
-	UTIL_Replace( Out, "$PLAYER$", player );
-	return Out;
+	const string *Values[] = { &player };
+	return Format( 149, Values );
 }
 
 string CLanguage :: UpdatingClanList( )
 {
-	return m_CFG->GetString( "lang_0150", "lang_0150" );
+	return Format( 150, NULL );
 }
 
 string CLanguage :: UpdatingFriendsList( )
 {
-	return m_CFG->GetString( "lang_0151", "lang_0151" );
+	return Format( 151, NULL );
 }
 
 string CLanguage :: MultipleIPAddressUsageDetected( string player, string others )
 {
-	string Out = m_CFG->GetString( "lang_0152", "lang_0152" );
-	UTIL_Replace( Out, "$PLAYER$", player );
-	UTIL_Replace( Out, "$OTHERS$", others );
-	return Out;
+	const string *Values[] = { &player, &others };
+	return Format( 152, Values );
 }
 
 string CLanguage :: UnableToVoteKickAlreadyInProgress( )
 {
-	return m_CFG->GetString( "lang_0153", "lang_0153" );
+	return Format( 153, NULL );
 }
 
 string CLanguage :: UnableToVoteKickNotEnoughPlayers( )
 {
-	return m_CFG->GetString( "lang_0154", "lang_0154" );
+	return Format( 154, NULL );
 }
 
 string CLanguage :: UnableToVoteKickNoMatchesFound( string victim )
 {
-	string Out = m_CFG->GetString( "lang_0155", "lang_0155" );
-	UTIL_Replace( Out, "$VICTIM$", victim );
-	return Out;
+	const string *Values[] = { &victim };
+	return Format( 155, Values );
 }
 
 string CLanguage :: UnableToVoteKickPlayerIsReserved( string victim )
 {
-	string Out = m_CFG->GetString( "lang_0156", "lang_0156" );
-	UTIL_Replace( Out, "$VICTIM$", victim );
-	return Out;
+	const string *Values[] = { &victim };
+	return Format( 156, Values );
 }
 
 string CLanguage :: StartedVoteKick( string victim, string user, string votesneeded )
 {
-	string Out = m_CFG->GetString( "lang_0157", "lang_0157" );
-	UTIL_Replace( Out, "$VICTIM$", victim );
-	UTIL_Replace( Out, "$USER$", user );
-	UTIL_Replace( Out, "$VOTESNEEDED$", votesneeded );
-	return Out;
+	const string *Values[] = { &victim, &user, &votesneeded };
+	return Format( 157, Values );
 }
 
 string CLanguage :: UnableToVoteKickFoundMoreThanOneMatch( string victim )
 {
-	string Out = m_CFG->GetString( "lang_0158", "lang_0158" );
-	UTIL_Replace( Out, "$VICTIM$", victim );
-	return Out;
+	const string *Values[] = { &victim };
+	return Format( 158, Values );
 }
 
 string CLanguage :: VoteKickPassed( string victim )
 {
-	string Out = m_CFG->GetString( "lang_0159", "lang_0159" );
-	UTIL_Replace( Out, "$VICTIM$", victim );
-	return Out;
+	const string *Values[] = { &victim };
+	return Format( 159, Values );
 }
 
 string CLanguage :: ErrorVoteKickingPlayer( string victim )
 {
-	string Out = m_CFG->GetString( "lang_0160", "lang_0160" );
-	UTIL_Replace( Out, "$VICTIM$", victim );
-	return Out;
+	const string *Values[] = { &victim };
+	return Format( 160, Values );
 }
 
 string CLanguage :: VoteKickAcceptedNeedMoreVotes( string victim, string user, string votes )
 {
-	string Out = m_CFG->GetString( "lang_0161", "lang_0161" );
-	UTIL_Replace( Out, "$VICTIM$", victim );
-	UTIL_Replace( Out, "$USER$", user );
-	UTIL_Replace( Out, "$VOTES$", votes );
-	return Out;
+	const string *Values[] = { &victim, &user, &votes };
+	return Format( 161, Values );
 }
 
 string CLanguage :: VoteKickCancelled( string victim )
 {
-	string Out = m_CFG->GetString( "lang_0162", "lang_0162" );
-	UTIL_Replace( Out, "$VICTIM$", victim );
-	return Out;
+	const string *Values[] = { &victim };
+	return Format( 162, Values );
 }
 
 string CLanguage :: VoteKickExpired( string victim )
 {
-	string Out = m_CFG->GetString( "lang_0163", "lang_0163" );
-	UTIL_Replace( Out, "$VICTIM$", victim );
-	return Out;
+	const string *Values[] = { &victim };
+	return Format( 163, Values );
 }
 
 string CLanguage :: WasKickedByVote( )
 {
-	return m_CFG->GetString( "lang_0164", "lang_0164" );
+	return Format( 164, NULL );
 }
 
 string CLanguage :: TypeYesToVote( string commandtrigger )
 {
-	string Out = m_CFG->GetString( "lang_0165", "lang_0165" );
-	UTIL_Replace( Out, "$COMMANDTRIGGER$", commandtrigger );
-	return Out;
+	const string *Values[] = { &commandtrigger };
+	return Format( 165, Values );
 }
 
 string CLanguage :: PlayersNotYetPingedAutoStart( string notpinged )
 {
-	string Out = m_CFG->GetString( "lang_0166", "lang_0166" );
-	UTIL_Replace( Out, "$NOTPINGED$", notpinged );
-	return Out;
+	const string *Values[] = { &notpinged };
+	return Format( 166, Values );
 }
 
 string CLanguage :: WasKickedForNotSpoofChecking( )
 {
-	return m_CFG->GetString( "lang_0167", "lang_0167" );
+	return Format( 167, NULL );
 }
 
 string CLanguage :: WasKickedForHavingFurthestScore( string score, string average )
 {
-	string Out = m_CFG->GetString( "lang_0168", "lang_0168" );
-	UTIL_Replace( Out, "$SCORE$", score );
-	UTIL_Replace( Out, "$AVERAGE$", average );
-	return Out;
+	const string *Values[] = { &score, &average };
+	return Format( 168, Values );
 }
 
 string CLanguage :: PlayerHasScore( string player, string score )
 {
-	string Out = m_CFG->GetString( "lang_0169", "lang_0169" );
-	UTIL_Replace( Out, "$PLAYER$", player );
-	UTIL_Replace( Out, "$SCORE$", score );
-	return Out;
+	const string *Values[] = { &player, &score };
+	return Format( 169, Values );
 }
 
 string CLanguage :: RatedPlayersSpread( string rated, string total, string spread )
 {
-	string Out = m_CFG->GetString( "lang_0170", "lang_0170" );
-	UTIL_Replace( Out, "$RATED$", rated );
-	UTIL_Replace( Out, "$TOTAL$", total );
-	UTIL_Replace( Out, "$SPREAD$", spread );
-	return Out;
+	const string *Values[] = { &rated, &total, &spread };
+	return Format( 170, Values );
 }
 
 string CLanguage :: ErrorListingMaps( )
 {
-	return m_CFG->GetString( "lang_0171", "lang_0171" );
+	return Format( 171, NULL );
 }
 
 string CLanguage :: FoundMaps( string maps )
 {
-	string Out = m_CFG->GetString( "lang_0172", "lang_0172" );
-	UTIL_Replace( Out, "$MAPS$", maps );
-	return Out;
+	const string *Values[] = { &maps };
+	return Format( 172, Values );
 }
 
 string CLanguage :: NoMapsFound( )
 {
-	return m_CFG->GetString( "lang_0173", "lang_0173" );
+	return Format( 173, NULL );
 }
 
 string CLanguage :: ErrorListingMapConfigs( )
 {
-	return m_CFG->GetString( "lang_0174", "lang_0174" );
+	return Format( 174, NULL );
 }
 
 string CLanguage :: FoundMapConfigs( string mapconfigs )
 {
-	string Out = m_CFG->GetString( "lang_0175", "lang_0175" );
-	UTIL_Replace( Out, "$MAPCONFIGS$", mapconfigs );
-	return Out;
+	const string *Values[] = { &mapconfigs };
+	return Format( 175, Values );
 }
 
 string CLanguage :: NoMapConfigsFound( )
 {
-	return m_CFG->GetString( "lang_0176", "lang_0176" );
+	return Format( 176, NULL );
 }
 
 string CLanguage :: PlayerFinishedLoading( string user )
 {
-	string Out = m_CFG->GetString( "lang_0177", "lang_0177" );
-	UTIL_Replace( Out, "$USER$", user );
-	return Out;
+	const string *Values[] = { &user };
+	return Format( 177, Values );
 }
 
 string CLanguage :: PleaseWaitPlayersStillLoading( )
 {
-	return m_CFG->GetString( "lang_0178", "lang_0178" );
+	return Format( 178, NULL );
 }
 
 string CLanguage :: MapDownloadsDisabled( )
 {
-	return m_CFG->GetString( "lang_0179", "lang_0179" );
+	return Format( 179, NULL );
 }
 
 string CLanguage :: MapDownloadsEnabled( )
 {
-	return m_CFG->GetString( "lang_0180", "lang_0180" );
+	return Format( 180, NULL );
 }
 
 string CLanguage :: MapDownloadsConditional( )
 {
-	return m_CFG->GetString( "lang_0181", "lang_0181" );
+	return Format( 181, NULL );
 }
 
 string CLanguage :: SettingHCL( string HCL )
 {
-	string Out = m_CFG->GetString( "lang_0182", "lang_0182" );
-	UTIL_Replace( Out, "$HCL$", HCL );
-	return Out;
+	const string *Values[] = { &HCL };
+	return Format( 182, Values );
 }
 
 string CLanguage :: UnableToSetHCLInvalid( )
 {
-	return m_CFG->GetString( "lang_0183", "lang_0183" );
+	return Format( 183, NULL );
 }
 
 string CLanguage :: UnableToSetHCLTooLong( )
 {
-	return m_CFG->GetString( "lang_0184", "lang_0184" );
+	return Format( 184, NULL );
 }
 
 string CLanguage :: TheHCLIs( string HCL )
 {
-	string Out = m_CFG->GetString( "lang_0185", "lang_0185" );
-	UTIL_Replace( Out, "$HCL$", HCL );
-	return Out;
+	const string *Values[] = { &HCL };
+	return Format( 185, Values );
 }
 
 string CLanguage :: TheHCLIsTooLongUseForceToStart( )
 {
-	return m_CFG->GetString( "lang_0186", "lang_0186" );
+	return Format( 186, NULL );
 }
 
 string CLanguage :: ClearingHCL( )
 {
-	return m_CFG->GetString( "lang_0187", "lang_0187" );
+	return Format( 187, NULL );
 }
 
 string CLanguage :: TryingToRehostAsPrivateGame( string gamename )
 {
-	string Out = m_CFG->GetString( "lang_0188", "lang_0188" );
-	UTIL_Replace( Out, "$GAMENAME$", gamename );
-	return Out;
+	const string *Values[] = { &gamename };
+	return Format( 188, Values );
 }
 
 string CLanguage :: TryingToRehostAsPublicGame( string gamename )
 {
-	string Out = m_CFG->GetString( "lang_0189", "lang_0189" );
-	UTIL_Replace( Out, "$GAMENAME$", gamename );
-	return Out;
+	const string *Values[] = { &gamename };
+	return Format( 189, Values );
 }
 
 string CLanguage :: RehostWasSuccessful( )
 {
-	return m_CFG->GetString( "lang_0190", "lang_0190" );
+	return Format( 190, NULL );
 }
 
 string CLanguage :: TryingToJoinTheGameButBannedByName( string victim )
 {
-	string Out = m_CFG->GetString( "lang_0191", "lang_0191" );
-	UTIL_Replace( Out, "$VICTIM$", victim );
-	return Out;
+	const string *Values[] = { &victim };
+	return Format( 191, Values );
 }
 
 string CLanguage :: TryingToJoinTheGameButBannedByIP( string victim, string ip, string bannedname )
 {
-	string Out = m_CFG->GetString( "lang_0192", "lang_0192" );
-	UTIL_Replace( Out, "$VICTIM$", victim );
-	UTIL_Replace( Out, "$IP$", ip );
-	UTIL_Replace( Out, "$BANNEDNAME$", bannedname );
-	return Out;
+	const string *Values[] = { &victim, &ip, &bannedname };
+	return Format( 192, Values );
 }
 
 string CLanguage :: HasBannedName( string victim )
 {
-	string Out = m_CFG->GetString( "lang_0193", "lang_0193" );
-	UTIL_Replace( Out, "$VICTIM$", victim );
-	return Out;
+	const string *Values[] = { &victim };
+	return Format( 193, Values );
 }
 
 string CLanguage :: HasBannedIP( string victim, string ip, string bannedname )
 {
-	string Out = m_CFG->GetString( "lang_0194", "lang_0194" );
-	UTIL_Replace( Out, "$VICTIM$", victim );
-	UTIL_Replace( Out, "$IP$", ip );
-	UTIL_Replace( Out, "$BANNEDNAME$", bannedname );
-	return Out;
+	const string *Values[] = { &victim, &ip, &bannedname };
+	return Format( 194, Values );
 }
 
 string CLanguage :: PlayersInGameState( string number, string players )
 {
-	string Out = m_CFG->GetString( "lang_0195", "lang_0195" );
-	UTIL_Replace( Out, "$NUMBER$", number );
-	UTIL_Replace( Out, "$PLAYERS$", players );
-	return Out;
+	const string *Values[] = { &number, &players };
+	return Format( 195, Values );
 }
 
 string CLanguage :: ValidServers( string servers )
 {
-	string Out = m_CFG->GetString( "lang_0196", "lang_0196" );
-	UTIL_Replace( Out, "$SERVERS$", servers );
-	return Out;
+	const string *Values[] = { &servers };
+	return Format( 196, Values );
 }
 
 string CLanguage :: TeamCombinedScore( string team, string score )
 {
-	string Out = m_CFG->GetString( "lang_0197", "lang_0197" );
-	UTIL_Replace( Out, "$TEAM$", team );
-	UTIL_Replace( Out, "$SCORE$", score );
-	return Out;
+	const string *Values[] = { &team, &score };
+	return Format( 197, Values );
 }
 
 string CLanguage :: BalancingSlotsCompleted( )
 {
-	return m_CFG->GetString( "lang_0198", "lang_0198" );
+	return Format( 198, NULL );
 }
 
 string CLanguage :: PlayerWasKickedForFurthestScore( string name, string score, string average )
 {
-	string Out = m_CFG->GetString( "lang_0199", "lang_0199" );
-	UTIL_Replace( Out, "$NAME$", name );
-	UTIL_Replace( Out, "$SCORE$", score );
-	UTIL_Replace( Out, "$AVERAGE$", average );
-	return Out;
+	const string *Values[] = { &name, &score, &average };
+	return Format( 199, Values );
 }
 
 string CLanguage :: LocalAdminMessagesEnabled( )
 {
-	return m_CFG->GetString( "lang_0200", "lang_0200" );
+	return Format( 200, NULL );
 }
 
 string CLanguage :: LocalAdminMessagesDisabled( )
 {
-	return m_CFG->GetString( "lang_0201", "lang_0201" );
+	return Format( 201, NULL );
 }
 
 string CLanguage :: WasDroppedDesync( )
 {
-	return m_CFG->GetString( "lang_0202", "lang_0202" );
+	return Format( 202, NULL );
 }
 
 string CLanguage :: WasKickedForHavingLowestScore( string score )
 {
-	string Out = m_CFG->GetString( "lang_0203", "lang_0203" );
-	UTIL_Replace( Out, "$SCORE$", score );
-	return Out;
+	const string *Values[] = { &score };
+	return Format( 203, Values );
 }
 
 string CLanguage :: PlayerWasKickedForLowestScore( string name, string score )
 {
-	string Out = m_CFG->GetString( "lang_0204", "lang_0204" );
-	UTIL_Replace( Out, "$NAME$", name );
-	UTIL_Replace( Out, "$SCORE$", score );
-	return Out;
+	const string *Values[] = { &name, &score };
+	return Format( 204, Values );
 }
 
 string CLanguage :: ReloadingConfigurationFiles( )
 {
-	return m_CFG->GetString( "lang_0205", "lang_0205" );
+	return Format( 205, NULL );
 }
 
 string CLanguage :: CountDownAbortedSomeoneLeftRecently( )
 {
-	return m_CFG->GetString( "lang_0206", "lang_0206" );
+	return Format( 206, NULL );
 }
 
 string CLanguage :: UnableToCreateGameMustEnforceFirst( string gamename )
 {
-	string Out = m_CFG->GetString( "lang_0207", "lang_0207" );
-	UTIL_Replace( Out, "$GAMENAME$", gamename );
-	return Out;
+	const string *Values[] = { &gamename };
+	return Format( 207, Values );
 }
 
 string CLanguage :: UnableToLoadReplaysOutside( )
 {
-	return m_CFG->GetString( "lang_0208", "lang_0208" );
+	return Format( 208, NULL );
 }
 
 string CLanguage :: LoadingReplay( string file )
 {
-	string Out = m_CFG->GetString( "lang_0209", "lang_0209" );
-	UTIL_Replace( Out, "$FILE$", file );
-	return Out;
+	const string *Values[] = { &file };
+	return Format( 209, Values );
 }
 
 string CLanguage :: UnableToLoadReplayDoesntExist( string file )
 {
-	string Out = m_CFG->GetString( "lang_0210", "lang_0210" );
-	UTIL_Replace( Out, "$FILE$", file );
-	return Out;
+	const string *Values[] = { &file };
+	return Format( 210, Values );
 }
 
 string CLanguage :: CommandTrigger( string trigger )
 {
-	string Out = m_CFG->GetString( "lang_0211", "lang_0211" );
-	UTIL_Replace( Out, "$TRIGGER$", trigger );
-	return Out;
+	const string *Values[] = { &trigger };
+	return Format( 211, Values );
 }
 
 string CLanguage :: CantEndGameOwnerIsStillPlaying( string owner )
 {
-	string Out = m_CFG->GetString( "lang_0212", "lang_0212" );
-	UTIL_Replace( Out, "$OWNER$", owner );
-	return Out;
+	const string *Values[] = { &owner };
+	return Format( 212, Values );
 }
 
 string CLanguage :: CantUnhostGameOwnerIsPresent( string owner )
 {
-	string Out = m_CFG->GetString( "lang_0213", "lang_0213" );
-	UTIL_Replace( Out, "$OWNER$", owner );
-	return Out;
+	const string *Values[] = { &owner };
+	return Format( 213, Values );
 }
 
 string CLanguage :: WasAutomaticallyDroppedAfterSeconds( string seconds )
 {
-	string Out = m_CFG->GetString( "lang_0214", "lang_0214" );
-	UTIL_Replace( Out, "$SECONDS$", seconds );
-	return Out;
+	const string *Values[] = { &seconds };
+	return Format( 214, Values );
 }
 
 string CLanguage :: HasLostConnectionTimedOutGProxy( )
 {
-	return m_CFG->GetString( "lang_0215", "lang_0215" );
+	return Format( 215, NULL );
 }
 
 string CLanguage :: HasLostConnectionSocketErrorGProxy( string error )
 {
-	string Out = m_CFG->GetString( "lang_0216", "lang_0216" );
-	UTIL_Replace( Out, "$ERROR$", error );
-	return Out;
+	const string *Values[] = { &error };
+	return Format( 216, Values );
 }
 
 string CLanguage :: HasLostConnectionClosedByRemoteHostGProxy( )
 {
-	return m_CFG->GetString( "lang_0217", "lang_0217" );
+	return Format( 217, NULL );
 }
 
 string CLanguage :: WaitForReconnectSecondsRemain( string seconds )
 {
-	string Out = m_CFG->GetString( "lang_0218", "lang_0218" );
-	UTIL_Replace( Out, "$SECONDS$", seconds );
-	return Out;
+	const string *Values[] = { &seconds };
+	return Format( 218, Values );
 }
 
 string CLanguage :: WasUnrecoverablyDroppedFromGProxy( )
 {
-	return m_CFG->GetString( "lang_0219", "lang_0219" );
+	return Format( 219, NULL );
 }
 
 string CLanguage :: PlayerReconnectedWithGProxy( string name )
 {
-	string Out = m_CFG->GetString( "lang_0220", "lang_0220" );
-	UTIL_Replace( Out, "$NAME$", name );
-	return Out;
+	const string *Values[] = { &name };
+	return Format( 220, Values );
 }
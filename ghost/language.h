@@ -25,15 +25,38 @@
 // CLanguage
 //
 
+// every message is split into literal text and placeholders once when it's loaded
+// each placeholder refers to one of the values passed to Format by position so formatting a message is a single pass without searching
+
+#define LANGUAGE_MESSAGES	220
+
+class CLanguageSegment
+{
+public:
+	string m_Text;									// the literal text
+	int32_t m_Value;								// the index of the value to append after the literal text (-1 = none)
+};
+
 class CLanguage
 {
 private:
 	CConfig *m_CFG;
+	vector< vector<CLanguageSegment> > m_Messages;	// the compiled messages indexed by message ID
+	string m_Buffer;								// the buffer Format builds messages in (reused so we don't allocate for every message)
 
 public:
 	CLanguage( string nCFGFile );
 	~CLanguage( );
 
+	void SetTranslations( map<uint32_t, string> translations );
+
+private:
+	string GetKey( uint32_t id );
+	void Compile( uint32_t id, string text );
+	string Format( uint32_t id, const string **values );
+
+public:
+
 	string UnableToCreateGameTryAnotherName( string server, string gamename );
 	string UserIsAlreadyAnAdmin( string server, string user );
 	string AddedUserToAdminDatabase( string server, string user );
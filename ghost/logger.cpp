@@ -0,0 +1,282 @@
+/*
+
+   Copyright [2008] [Trevor Hogan]
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+   CODE PORTED FROM THE ORIGINAL GHOST PROJECT: http://ghost.pwner.org/
+
+*/
+
+#include "ghost.h"
+#include "util.h"
+#include "logger.h"
+
+#include <stdio.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#ifdef WIN32
+ #include <windows.h>
+#else
+ #include <unistd.h>
+#endif
+
+//
+// CLogger
+//
+
+CLogger :: CLogger( string nFile, uint32_t nMethod, uint32_t nMaxSize, uint32_t nBackups, uint32_t nQueueSize )
+{
+	m_File = nFile;
+	m_Method = nMethod;
+	m_MaxSize = nMaxSize;
+	m_Backups = nBackups;
+	m_Log = NULL;
+	m_Size = 0;
+	m_LastTime = 0;
+
+	// round the queue size up to a power of two so we can use a mask instead of a modulo
+
+	uint32_t RingSize = 64;
+
+	while( RingSize < nQueueSize && RingSize < 1048576 )
+		RingSize <<= 1;
+
+	m_Ring = new CLogEntry[RingSize];
+	m_RingMask = RingSize - 1;
+
+	for( uint32_t i = 0; i < RingSize; i++ )
+		m_Ring[i].m_Sequence.store( i, boost :: memory_order_relaxed );
+
+	m_EnqueuePos.store( 0 );
+	m_DequeuePos = 0;
+	m_Dropped.store( 0 );
+	m_Exiting.store( false );
+
+	if( m_Method == 2 )
+	{
+		// log method 2 locks the log file so we open it here (on the main thread) in order to report failure on startup
+
+		m_Log = new ofstream( );
+		m_Log->open( m_File.c_str( ), ios :: app );
+
+		if( !m_Log->fail( ) )
+		{
+			m_Log->seekp( 0, ios :: end );
+			m_Size = (uint32_t)m_Log->tellp( );
+		}
+	}
+
+	m_Thread = new boost :: thread( boost :: ref( *this ) );
+}
+
+CLogger :: ~CLogger( )
+{
+	// the writer thread drains the ring before exiting so nothing queued before this point is lost
+
+	m_Exiting.store( true );
+	m_Thread->join( );
+	delete m_Thread;
+
+	if( m_Log )
+	{
+		if( !m_Log->fail( ) )
+			m_Log->close( );
+
+		delete m_Log;
+	}
+
+	delete [] m_Ring;
+}
+
+void CLogger :: Write( string message )
+{
+	// this is a bounded multi producer single consumer ring (based on Dmitry Vyukov's bounded queue)
+	// each entry's sequence number tells us if it's free for the producer claiming position Pos (Sequence == Pos) or full and waiting for the writer (Sequence == Pos + 1)
+
+	uint32_t Pos = m_EnqueuePos.load( boost :: memory_order_relaxed );
+	CLogEntry *Entry;
+
+	while( true )
+	{
+		Entry = &m_Ring[Pos & m_RingMask];
+		int32_t Difference = (int32_t)( Entry->m_Sequence.load( boost :: memory_order_acquire ) - Pos );
+
+		if( Difference == 0 )
+		{
+			if( m_EnqueuePos.compare_exchange_weak( Pos, Pos + 1, boost :: memory_order_relaxed ) )
+				break;
+		}
+		else if( Difference < 0 )
+		{
+			// the ring is full, the writer thread can't keep up with us
+			// drop the message rather than blocking the caller (which is usually the game loop)
+
+			m_Dropped.fetch_add( 1, boost :: memory_order_relaxed );
+			return;
+		}
+		else
+			Pos = m_EnqueuePos.load( boost :: memory_order_relaxed );
+	}
+
+	Entry->m_Time = time( NULL );
+	Entry->m_Message.swap( message );
+	Entry->m_Sequence.store( Pos + 1, boost :: memory_order_release );
+}
+
+void CLogger :: operator( )( )
+{
+	while( !m_Exiting.load( ) )
+	{
+		if( Drain( ) )
+			WriteBatch( );
+		else
+			MILLISLEEP( 50 );
+	}
+
+	// drain anything queued before we were told to exit
+
+	while( Drain( ) )
+		WriteBatch( );
+}
+
+bool CLogger :: Drain( )
+{
+	// move every queued message into the batch, formatting the timestamp at most once per second
+
+	uint32_t Drained = 0;
+
+	while( true )
+	{
+		CLogEntry *Entry = &m_Ring[m_DequeuePos & m_RingMask];
+
+		if( (int32_t)( Entry->m_Sequence.load( boost :: memory_order_acquire ) - ( m_DequeuePos + 1 ) ) < 0 )
+			break;
+
+		m_Batch += "[" + GetTimeString( Entry->m_Time ) + "] ";
+		m_Batch += Entry->m_Message;
+		m_Batch += "\n";
+		Entry->m_Message.clear( );
+		Entry->m_Sequence.store( m_DequeuePos + m_RingMask + 1, boost :: memory_order_release );
+		m_DequeuePos++;
+		Drained++;
+	}
+
+	uint32_t Dropped = m_Dropped.exchange( 0, boost :: memory_order_relaxed );
+
+	if( Dropped > 0 )
+	{
+		m_Batch += "[" + GetTimeString( time( NULL ) ) + "] [LOG] dropped " + UTIL_ToString( Dropped ) + " messages because the log queue was full\n";
+		Drained++;
+	}
+
+	return Drained > 0;
+}
+
+void CLogger :: WriteBatch( )
+{
+	if( m_Batch.empty( ) )
+		return;
+
+	if( m_Method == 1 )
+	{
+		// log method 1: open, append, and close the log for every batch
+		// the log file can be edited/moved/deleted while GHost++ is running so we must check the size every time
+
+		struct stat FileInfo;
+
+		if( stat( m_File.c_str( ), &FileInfo ) == 0 )
+			m_Size = FileInfo.st_size;
+		else
+			m_Size = 0;
+
+		if( m_MaxSize > 0 && m_Size > 0 && m_Size + m_Batch.size( ) > m_MaxSize )
+			Rotate( );
+
+		ofstream Log;
+		Log.open( m_File.c_str( ), ios :: app );
+
+		if( !Log.fail( ) )
+		{
+			Log.write( m_Batch.data( ), m_Batch.size( ) );
+			Log.close( );
+		}
+	}
+	else if( m_Method == 2 )
+	{
+		// log method 2: keep the log open, flush once per batch
+
+		if( m_MaxSize > 0 && m_Size > 0 && m_Size + m_Batch.size( ) > m_MaxSize )
+			Rotate( );
+
+		if( m_Log && !m_Log->fail( ) )
+		{
+			m_Log->write( m_Batch.data( ), m_Batch.size( ) );
+			m_Log->flush( );
+		}
+	}
+
+	m_Size += m_Batch.size( );
+	m_Batch.clear( );
+}
+
+void CLogger :: Rotate( )
+{
+	if( m_Log )
+		m_Log->close( );
+
+	// shift the old logs up by one (ghost.log.1 -> ghost.log.2 and so on) then move the current log to ghost.log.1
+	// note: rename fails on Windows if the destination already exists so we remove it first
+
+	if( m_Backups > 0 )
+	{
+		remove( ( m_File + "." + UTIL_ToString( m_Backups ) ).c_str( ) );
+
+		for( uint32_t i = m_Backups; i > 1; i-- )
+			rename( ( m_File + "." + UTIL_ToString( i - 1 ) ).c_str( ), ( m_File + "." + UTIL_ToString( i ) ).c_str( ) );
+
+		rename( m_File.c_str( ), ( m_File + ".1" ).c_str( ) );
+	}
+	else
+		remove( m_File.c_str( ) );
+
+	m_Size = 0;
+
+	if( m_Log )
+	{
+		m_Log->clear( );
+		m_Log->open( m_File.c_str( ), ios :: app );
+	}
+}
+
+string CLogger :: GetTimeString( time_t t )
+{
+	if( t != m_LastTime || m_LastTimeString.empty( ) )
+	{
+		struct tm Local;
+#ifdef WIN32
+		localtime_s( &Local, &t );
+#else
+		localtime_r( &t, &Local );
+#endif
+		m_LastTimeString = asctime( &Local );
+
+		// erase the newline
+
+		m_LastTimeString.erase( m_LastTimeString.size( ) - 1 );
+		m_LastTime = t;
+	}
+
+	return m_LastTimeString;
+}
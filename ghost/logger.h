@@ -0,0 +1,84 @@
+/*
+
+   Copyright [2008] [Trevor Hogan]
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+   CODE PORTED FROM THE ORIGINAL GHOST PROJECT: http://ghost.pwner.org/
+
+*/
+
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <boost/atomic.hpp>
+#include <boost/thread.hpp>
+
+//
+// CLogger
+//
+
+// the logger moves all log file I/O off the main thread
+// CONSOLE_Print (on any thread) pushes messages into a bounded lock free ring and a single writer thread drains the ring in batches
+// if the ring fills up because the disk can't keep up we drop messages rather than stall the game loop (the number of dropped messages is logged)
+
+class CLogEntry
+{
+public:
+	boost :: atomic<uint32_t> m_Sequence;	// ring sequence number, see CLogger :: Write
+	time_t m_Time;							// time when the message was queued
+	string m_Message;
+};
+
+class CLogger
+{
+private:
+	string m_File;							// the log file
+	uint32_t m_Method;						// log method (1 = open, append, and close the log for every batch, 2 = keep the log open)
+	uint32_t m_MaxSize;						// rotate the log when it grows larger than this many bytes (0 = never rotate)
+	uint32_t m_Backups;						// the number of rotated logs to keep (ghost.log.1, ghost.log.2, ...)
+	ofstream *m_Log;						// the log file (only used with log method 2)
+	uint32_t m_Size;						// the current size of the log file in bytes
+	CLogEntry *m_Ring;						// the ring of queued messages
+	uint32_t m_RingMask;					// the size of the ring minus one (the size is always a power of two)
+	boost :: atomic<uint32_t> m_EnqueuePos;	// the next ring position to be claimed by a producer
+	uint32_t m_DequeuePos;					// the next ring position to be read by the writer thread
+	boost :: atomic<uint32_t> m_Dropped;	// the number of messages dropped because the ring was full
+	boost :: atomic<bool> m_Exiting;		// set to true to make the writer thread drain the ring and exit
+	boost :: thread *m_Thread;				// the writer thread
+	time_t m_LastTime;						// the time of the last timestamp we formatted
+	string m_LastTimeString;				// the last formatted timestamp (we only format a new timestamp once per second)
+	string m_Batch;							// the batch of formatted lines waiting to be written
+
+public:
+	CLogger( string nFile, uint32_t nMethod, uint32_t nMaxSize, uint32_t nBackups, uint32_t nQueueSize );
+	~CLogger( );
+
+	bool GetFailed( )						{ return m_Method == 2 && ( !m_Log || m_Log->fail( ) ); }
+
+	// producer function, safe to call from any thread
+
+	void Write( string message );
+
+	// writer thread
+
+	void operator( )( );
+
+private:
+	bool Drain( );
+	void WriteBatch( );
+	void Rotate( );
+	string GetTimeString( time_t t );
+};
+
+#endif
@@ -0,0 +1,295 @@
+/*
+
+   Copyright [2008] [Trevor Hogan]
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+   CODE PORTED FROM THE ORIGINAL GHOST PROJECT: http://ghost.pwner.org/
+
+*/
+
+#include "ghost.h"
+#include "util.h"
+#include "metrics.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+
+//
+// CHistogram
+//
+
+CHistogram :: CHistogram( )
+{
+	memset( m_Buckets, 0, sizeof( m_Buckets ) );
+	m_Count = 0;
+	m_Sum = 0;
+	m_Max = 0;
+}
+
+void CHistogram :: Record( uint32_t value )
+{
+	m_Buckets[GetBucket( value )]++;
+	m_Count++;
+	m_Sum += value;
+
+	if( value > m_Max )
+		m_Max = value;
+}
+
+void CHistogram :: Merge( CHistogram &other )
+{
+	for( uint32_t i = 0; i < METRIC_BUCKETS; i++ )
+		m_Buckets[i] += other.m_Buckets[i];
+
+	m_Count += other.m_Count;
+	m_Sum += other.m_Sum;
+
+	if( other.m_Max > m_Max )
+		m_Max = other.m_Max;
+}
+
+uint32_t CHistogram :: GetPercentile( double percentile )
+{
+	if( m_Count == 0 )
+		return 0;
+
+	// find the first bucket where the cumulative count reaches the requested percentile and report the largest value that bucket can hold
+	// the result is never larger than the largest value we actually recorded
+
+	uint64_t Target = (uint64_t)( percentile * m_Count + 0.5 );
+
+	if( Target < 1 )
+		Target = 1;
+
+	uint64_t Cumulative = 0;
+
+	for( uint32_t i = 0; i < METRIC_BUCKETS; i++ )
+	{
+		Cumulative += m_Buckets[i];
+
+		if( Cumulative >= Target )
+			return min( GetBucketMax( i ), m_Max );
+	}
+
+	return m_Max;
+}
+
+uint32_t CHistogram :: GetBucket( uint32_t value )
+{
+	if( value < METRIC_SUBBUCKETS )
+		return value;
+
+	// Shift is the number of low bits that don't fit in the sub bucket, i.e. the position of the highest set bit minus four
+
+	uint32_t Shift = 0;
+
+	while( ( value >> Shift ) >= 2 * METRIC_SUBBUCKETS )
+		Shift++;
+
+	return METRIC_SUBBUCKETS + Shift * METRIC_SUBBUCKETS + ( value >> Shift ) - METRIC_SUBBUCKETS;
+}
+
+uint32_t CHistogram :: GetBucketMax( uint32_t bucket )
+{
+	if( bucket < METRIC_SUBBUCKETS )
+		return bucket;
+
+	uint32_t Shift = ( bucket - METRIC_SUBBUCKETS ) / METRIC_SUBBUCKETS;
+	uint64_t SubBucket = ( bucket - METRIC_SUBBUCKETS ) % METRIC_SUBBUCKETS;
+	return (uint32_t)( ( ( METRIC_SUBBUCKETS + SubBucket + 1 ) << Shift ) - 1 );
+}
+
+//
+// CGameMetrics
+//
+
+CGameMetrics :: CGameMetrics( CMetrics *nMetrics, string labels )
+{
+	m_Metrics = nMetrics;
+	m_Metrics->AddHistogram( this, "ghost_game_update_microseconds", labels, "time taken by each game update", &m_UpdateMicroseconds );
+	m_Metrics->AddHistogram( this, "ghost_game_action_late_by_milliseconds", labels, "how late each action packet was sent", &m_ActionLateByMilliseconds );
+	m_Metrics->AddCounter( this, "ghost_game_actions_sent_total", labels, "number of action packets sent", &m_ActionsSent );
+	m_Metrics->AddCounter( this, "ghost_game_actions_late_total", labels, "number of action packets sent later than the latency", &m_ActionsLate );
+	m_Metrics->AddHistogram( this, "ghost_game_sync_lag_keepalives", labels, "how many keepalives a player was behind", &m_SyncLag );
+	m_Metrics->AddHistogram( this, "ghost_game_send_queue_bytes", labels, "number of bytes waiting to be sent to a player", &m_SendQueueBytes );
+}
+
+CGameMetrics :: ~CGameMetrics( )
+{
+	m_Metrics->Remove( this );
+}
+
+//
+// CMetrics
+//
+
+bool MetricSortByName( const CMetric &a, const CMetric &b )
+{
+	return a.m_Name < b.m_Name;
+}
+
+CMetrics :: CMetrics( )
+{
+
+}
+
+CMetrics :: ~CMetrics( )
+{
+
+}
+
+void CMetrics :: AddCounter( void *owner, string name, string labels, string help, CCounter *counter )
+{
+	Add( owner, name, labels, help, METRIC_COUNTER, counter );
+}
+
+void CMetrics :: AddGauge( void *owner, string name, string labels, string help, CGauge *gauge )
+{
+	Add( owner, name, labels, help, METRIC_GAUGE, gauge );
+}
+
+void CMetrics :: AddHistogram( void *owner, string name, string labels, string help, CHistogram *histogram )
+{
+	Add( owner, name, labels, help, METRIC_HISTOGRAM, histogram );
+}
+
+void CMetrics :: Add( void *owner, string name, string labels, string help, uint32_t type, void *value )
+{
+	CMetric Metric;
+	Metric.m_Name = name;
+	Metric.m_Help = help;
+	Metric.m_Labels = labels;
+	Metric.m_Type = type;
+	Metric.m_Owner = owner;
+	Metric.m_Value = value;
+
+	// keep the metrics sorted by name because the text format requires every series of a metric to be grouped together
+
+	m_Metrics.insert( upper_bound( m_Metrics.begin( ), m_Metrics.end( ), Metric, MetricSortByName ), Metric );
+}
+
+void CMetrics :: Remove( void *owner )
+{
+	for( vector<CMetric> :: iterator i = m_Metrics.begin( ); i != m_Metrics.end( ); )
+	{
+		if( i->m_Owner == owner )
+			i = m_Metrics.erase( i );
+		else
+			i++;
+	}
+}
+
+string CMetrics :: GetSnapshot( )
+{
+	// histograms are exported as summaries (quantiles plus _sum and _count) with an extra _max gauge
+	// note: the quantiles are calculated over the lifetime of the owner, not over a sliding window
+
+	static const double Quantiles[] = { 0.5, 0.9, 0.99, 0.999 };
+	static const char *QuantileNames[] = { "0.5", "0.9", "0.99", "0.999" };
+
+	ostringstream SS;
+	ostringstream MaxSS;
+
+	for( vector<CMetric> :: iterator i = m_Metrics.begin( ); i != m_Metrics.end( ); i++ )
+	{
+		bool First = ( i == m_Metrics.begin( ) || ( i - 1 )->m_Name != i->m_Name );
+		bool Last = ( i + 1 == m_Metrics.end( ) || ( i + 1 )->m_Name != i->m_Name );
+		string Labels = i->m_Labels.empty( ) ? string( ) : "{" + i->m_Labels + "}";
+
+		if( First )
+		{
+			SS << "# HELP " << i->m_Name << " " << i->m_Help << "\n";
+
+			if( i->m_Type == METRIC_COUNTER )
+				SS << "# TYPE " << i->m_Name << " counter\n";
+			else if( i->m_Type == METRIC_GAUGE )
+				SS << "# TYPE " << i->m_Name << " gauge\n";
+			else
+			{
+				SS << "# TYPE " << i->m_Name << " summary\n";
+				MaxSS.str( string( ) );
+				MaxSS << "# HELP " << i->m_Name << "_max the largest value of " << i->m_Name << "\n";
+				MaxSS << "# TYPE " << i->m_Name << "_max gauge\n";
+			}
+		}
+
+		if( i->m_Type == METRIC_COUNTER )
+			SS << i->m_Name << Labels << " " << ( (CCounter *)i->m_Value )->GetValue( ) << "\n";
+		else if( i->m_Type == METRIC_GAUGE )
+			SS << i->m_Name << Labels << " " << ( (CGauge *)i->m_Value )->GetValue( ) << "\n";
+		else
+		{
+			CHistogram *Histogram = (CHistogram *)i->m_Value;
+			string Separator = i->m_Labels.empty( ) ? string( ) : ",";
+
+			for( int j = 0; j < 4; j++ )
+				SS << i->m_Name << "{" << i->m_Labels << Separator << "quantile=\"" << QuantileNames[j] << "\"} " << Histogram->GetPercentile( Quantiles[j] ) << "\n";
+
+			SS << i->m_Name << "_sum" << Labels << " " << Histogram->GetSum( ) << "\n";
+			SS << i->m_Name << "_count" << Labels << " " << Histogram->GetCount( ) << "\n";
+			MaxSS << i->m_Name << "_max" << Labels << " " << Histogram->GetMax( ) << "\n";
+
+			if( Last )
+				SS << MaxSS.str( );
+		}
+	}
+
+	return SS.str( );
+}
+
+bool CMetrics :: WriteSnapshot( string file )
+{
+	// write to a temporary file first and rename it so a scraper never sees a half written snapshot
+	// note: rename fails on Windows if the destination already exists so we remove it first
+
+	string TempFile = file + ".tmp";
+	string Snapshot = GetSnapshot( );
+	ofstream Out;
+	Out.open( TempFile.c_str( ), ios :: out | ios :: trunc );
+
+	if( Out.fail( ) )
+		return false;
+
+	Out.write( Snapshot.data( ), Snapshot.size( ) );
+	Out.close( );
+
+#ifdef WIN32
+	remove( file.c_str( ) );
+#endif
+
+	return rename( TempFile.c_str( ), file.c_str( ) ) == 0;
+}
+
+string CMetrics :: Label( string name, string value )
+{
+	// label values can contain anything (game names are chosen by users) so escape them as required by the text format
+
+	string Escaped;
+	Escaped.reserve( value.size( ) );
+
+	for( string :: iterator i = value.begin( ); i != value.end( ); i++ )
+	{
+		if( *i == '\\' )
+			Escaped += "\\\\";
+		else if( *i == '"' )
+			Escaped += "\\\"";
+		else if( *i == '\n' )
+			Escaped += "\\n";
+		else
+			Escaped += *i;
+	}
+
+	return name + "=\"" + Escaped + "\"";
+}
@@ -0,0 +1,164 @@
+/*
+
+   Copyright [2008] [Trevor Hogan]
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+   CODE PORTED FROM THE ORIGINAL GHOST PROJECT: http://ghost.pwner.org/
+
+*/
+
+#ifndef METRICS_H
+#define METRICS_H
+
+//
+// instrumentation
+//
+
+// counters, gauges and histograms are owned by the objects they describe (games, the database) and updated directly on the hot paths
+// the owner registers them with the CMetrics registry which writes a snapshot in the Prometheus text format every few seconds
+// note: none of this is thread safe, everything must be updated and registered from the main thread
+
+#define METRIC_COUNTER		1
+#define METRIC_GAUGE		2
+#define METRIC_HISTOGRAM	3
+
+// histograms use log-linear buckets (like HdrHistogram) so recording a value is just a few shifts and an increment
+// values below 16 get their own bucket and every power of two above that is split into 16 sub buckets (so the error is at most ~6%)
+
+#define METRIC_SUBBUCKETS	16
+#define METRIC_BUCKETS		( METRIC_SUBBUCKETS + 28 * METRIC_SUBBUCKETS )
+
+class CCounter
+{
+private:
+	uint64_t m_Value;
+
+public:
+	CCounter( ) : m_Value( 0 ) { }
+
+	void Add( uint64_t n = 1 )		{ m_Value += n; }
+	uint64_t GetValue( )			{ return m_Value; }
+};
+
+class CGauge
+{
+private:
+	uint64_t m_Value;
+
+public:
+	CGauge( ) : m_Value( 0 ) { }
+
+	void Set( uint64_t n )			{ m_Value = n; }
+	uint64_t GetValue( )			{ return m_Value; }
+};
+
+class CHistogram
+{
+private:
+	uint32_t m_Buckets[METRIC_BUCKETS];
+	uint64_t m_Count;				// the number of recorded values
+	uint64_t m_Sum;					// the sum of all recorded values
+	uint32_t m_Max;					// the largest recorded value
+
+public:
+	CHistogram( );
+
+	void Record( uint32_t value );
+	void Merge( CHistogram &other );
+	uint64_t GetCount( )			{ return m_Count; }
+	uint64_t GetSum( )				{ return m_Sum; }
+	uint32_t GetMax( )				{ return m_Max; }
+	uint32_t GetPercentile( double percentile );
+
+private:
+	static uint32_t GetBucket( uint32_t value );
+	static uint32_t GetBucketMax( uint32_t bucket );
+};
+
+// records the time (in microseconds) between construction and destruction
+// this is useful for functions with a lot of return statements such as CBaseGame :: Update
+
+class CHistogramTimer
+{
+private:
+	CHistogram *m_Histogram;
+	uint64_t m_StartMicroTicks;
+
+public:
+	CHistogramTimer( CHistogram *nHistogram ) : m_Histogram( nHistogram ), m_StartMicroTicks( GetMicroTicks( ) ) { }
+	~CHistogramTimer( )				{ m_Histogram->Record( (uint32_t)( GetMicroTicks( ) - m_StartMicroTicks ) ); }
+};
+
+//
+// CGameMetrics
+//
+
+// the metrics of a single game, registered with the given labels on construction and removed on destruction
+
+class CMetrics;
+
+class CGameMetrics
+{
+public:
+	CMetrics *m_Metrics;
+	CHistogram m_UpdateMicroseconds;		// how long each call to CBaseGame :: Update took
+	CHistogram m_ActionLateByMilliseconds;	// how late each action packet was sent (the action tick jitter)
+	CCounter m_ActionsSent;					// the number of action packets sent
+	CCounter m_ActionsLate;					// the number of action packets sent later than the latency
+	CHistogram m_SyncLag;					// how many keepalives each player was behind when we received one of their keepalives
+	CHistogram m_SendQueueBytes;			// the number of bytes waiting in each player's send buffer
+
+	CGameMetrics( CMetrics *nMetrics, string labels );
+	~CGameMetrics( );
+};
+
+//
+// CMetrics
+//
+
+class CMetric
+{
+public:
+	string m_Name;					// the metric name, e.g. ghost_game_action_late_by_milliseconds
+	string m_Help;					// the HELP text
+	string m_Labels;				// the formatted label set without braces, e.g. game="dota",id="12"
+	uint32_t m_Type;				// METRIC_COUNTER, METRIC_GAUGE or METRIC_HISTOGRAM
+	void *m_Owner;					// the object that owns the metric, used for removing every metric of an object at once
+	void *m_Value;					// a CCounter, CGauge or CHistogram
+};
+
+class CMetrics
+{
+private:
+	vector<CMetric> m_Metrics;
+
+public:
+	CMetrics( );
+	~CMetrics( );
+
+	void AddCounter( void *owner, string name, string labels, string help, CCounter *counter );
+	void AddGauge( void *owner, string name, string labels, string help, CGauge *gauge );
+	void AddHistogram( void *owner, string name, string labels, string help, CHistogram *histogram );
+	void Remove( void *owner );
+
+	string GetSnapshot( );
+	bool WriteSnapshot( string file );
+
+	static string Label( string name, string value );
+
+private:
+	void Add( void *owner, string name, string labels, string help, uint32_t type, void *value );
+};
+
+#endif
@@ -0,0 +1,568 @@
+/*
+
+   Copyright [2008] [Trevor Hogan]
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+   CODE PORTED FROM THE ORIGINAL GHOST PROJECT: http://ghost.pwner.org/
+
+*/
+
+#ifndef PACKETSCHEMA_H
+#define PACKETSCHEMA_H
+
+#include <string.h>
+
+//
+// packet schemas
+//
+
+// a packet schema declares the layout of a packet as a list of fields and the encoder and decoder are generated from it at compile time
+// each field is bound to a member of a plain class which holds the values of one packet, for example:
+//
+//	class CW3GSLeaveGame
+//	{
+//	public:
+//		uint32_t m_Reason;
+//	};
+//
+//	typedef CPacketSchema<	CFieldHeader<W3GS_HEADER_CONSTANT, CGameProtocol :: W3GS_LEAVEGAME>,
+//							CFieldUInt32<CW3GSLeaveGame, &CW3GSLeaveGame :: m_Reason> > W3GSLeaveGameSchema;
+//
+// encoding works out the exact size of the packet first and then writes every field in one pass into a buffer of that size (including the length in the header)
+// decoding checks the packet against the minimum size of the schema (the total size of the fixed size fields) once and then reads the fixed size fields without any further checks
+// the only other checks are the ones that depend on the contents of the packet (finding the end of a string, checking a count) and these never read into the fixed size fields that follow
+// strings and byte arrays are decoded as CPacketBytes pointing into the packet so nothing is copied, they're only valid as long as the packet is
+// all numbers are little endian
+
+inline void PACKET_PutUInt16( unsigned char *buffer, uint16_t i )
+{
+	buffer[0] = (unsigned char)i;
+	buffer[1] = (unsigned char)( i >> 8 );
+}
+
+inline void PACKET_PutUInt32( unsigned char *buffer, uint32_t i )
+{
+	buffer[0] = (unsigned char)i;
+	buffer[1] = (unsigned char)( i >> 8 );
+	buffer[2] = (unsigned char)( i >> 16 );
+	buffer[3] = (unsigned char)( i >> 24 );
+}
+
+inline uint16_t PACKET_GetUInt16( const unsigned char *data )
+{
+	return (uint16_t)( data[0] | data[1] << 8 );
+}
+
+inline uint32_t PACKET_GetUInt32( const unsigned char *data )
+{
+	return (uint32_t)data[0] | (uint32_t)data[1] << 8 | (uint32_t)data[2] << 16 | (uint32_t)data[3] << 24;
+}
+
+//
+// CPacketBytes
+//
+
+// a string or byte array in a packet, this doesn't own the bytes it points to
+// when encoding it points to the caller's data and when decoding it points into the packet
+
+class CPacketBytes
+{
+public:
+	const unsigned char *m_Data;
+	uint32_t m_Size;
+
+	CPacketBytes( ) : m_Data( NULL ), m_Size( 0 ) { }
+	CPacketBytes( const unsigned char *nData, uint32_t nSize ) : m_Data( nData ), m_Size( nSize ) { }
+	CPacketBytes( const BYTEARRAY &b ) : m_Data( b.empty( ) ? NULL : &b[0] ), m_Size( b.size( ) ) { }
+	CPacketBytes( const string &s ) : m_Data( (const unsigned char *)s.data( ) ), m_Size( s.size( ) ) { }
+
+	BYTEARRAY GetByteArray( ) const	{ return BYTEARRAY( m_Data, m_Data + m_Size ); }
+	string GetString( ) const		{ return string( (const char *)m_Data, m_Size ); }
+};
+
+// the values of a packet without any fields of its own (e.g. a packet which is only a header)
+
+class CPacketNoFields
+{
+
+};
+
+//
+// fields
+//
+
+// every field has the same static interface which is used by CPacketSchema:
+//  - MinSize is the number of bytes the field takes up at least
+//  - GetSize returns the number of bytes the field takes up when encoding these values
+//  - Encode writes the field and returns the position after it, size is the size of the whole packet
+//  - Decode reads the field and moves data past it, restMinSize is the MinSize of the fields after this one
+//    when Decode is called there are always at least MinSize + restMinSize bytes left
+
+// the 4 byte header of a W3GS, GPS or BNET packet (header constant, packet ID, packet length)
+// this must be the first field of the schema
+
+template<unsigned char H, unsigned char ID>
+class CFieldHeader
+{
+public:
+	enum { MinSize = 4 };
+
+	template<class P> static uint32_t GetSize( const P & )	{ return 4; }
+
+	template<class P> static unsigned char *Encode( const P &, unsigned char *buffer, uint32_t size )
+	{
+		buffer[0] = H;
+		buffer[1] = ID;
+		PACKET_PutUInt16( buffer + 2, (uint16_t)size );
+		return buffer + 4;
+	}
+
+	template<class P> static bool Decode( P &, const unsigned char *&data, const unsigned char *end, uint32_t )
+	{
+		// the header is the first field so the rest of the data is the whole packet
+		// the header constant and the packet ID have already been checked when the packet was extracted
+
+		if( PACKET_GetUInt16( data + 2 ) != end - data )
+			return false;
+
+		data += 4;
+		return true;
+	}
+};
+
+// numbers
+
+template<class P, unsigned char P :: *M>
+class CFieldUInt8
+{
+public:
+	enum { MinSize = 1 };
+
+	static uint32_t GetSize( const P & )	{ return 1; }
+
+	static unsigned char *Encode( const P &fields, unsigned char *buffer, uint32_t )
+	{
+		*buffer = fields.*M;
+		return buffer + 1;
+	}
+
+	static bool Decode( P &fields, const unsigned char *&data, const unsigned char *, uint32_t )
+	{
+		fields.*M = *data++;
+		return true;
+	}
+};
+
+template<class P, uint16_t P :: *M>
+class CFieldUInt16
+{
+public:
+	enum { MinSize = 2 };
+
+	static uint32_t GetSize( const P & )	{ return 2; }
+
+	static unsigned char *Encode( const P &fields, unsigned char *buffer, uint32_t )
+	{
+		PACKET_PutUInt16( buffer, fields.*M );
+		return buffer + 2;
+	}
+
+	static bool Decode( P &fields, const unsigned char *&data, const unsigned char *, uint32_t )
+	{
+		fields.*M = PACKET_GetUInt16( data );
+		data += 2;
+		return true;
+	}
+};
+
+template<class P, uint32_t P :: *M>
+class CFieldUInt32
+{
+public:
+	enum { MinSize = 4 };
+
+	static uint32_t GetSize( const P & )	{ return 4; }
+
+	static unsigned char *Encode( const P &fields, unsigned char *buffer, uint32_t )
+	{
+		PACKET_PutUInt32( buffer, fields.*M );
+		return buffer + 4;
+	}
+
+	static bool Decode( P &fields, const unsigned char *&data, const unsigned char *, uint32_t )
+	{
+		fields.*M = PACKET_GetUInt32( data );
+		data += 4;
+		return true;
+	}
+};
+
+// constants, these are written when encoding and skipped when decoding
+
+template<unsigned char V>
+class CFieldConst8
+{
+public:
+	enum { MinSize = 1 };
+
+	template<class P> static uint32_t GetSize( const P & )	{ return 1; }
+
+	template<class P> static unsigned char *Encode( const P &, unsigned char *buffer, uint32_t )
+	{
+		*buffer = V;
+		return buffer + 1;
+	}
+
+	template<class P> static bool Decode( P &, const unsigned char *&data, const unsigned char *, uint32_t )
+	{
+		data++;
+		return true;
+	}
+};
+
+template<uint16_t V>
+class CFieldConst16
+{
+public:
+	enum { MinSize = 2 };
+
+	template<class P> static uint32_t GetSize( const P & )	{ return 2; }
+
+	template<class P> static unsigned char *Encode( const P &, unsigned char *buffer, uint32_t )
+	{
+		PACKET_PutUInt16( buffer, V );
+		return buffer + 2;
+	}
+
+	template<class P> static bool Decode( P &, const unsigned char *&data, const unsigned char *, uint32_t )
+	{
+		data += 2;
+		return true;
+	}
+};
+
+template<uint32_t V>
+class CFieldConst32
+{
+public:
+	enum { MinSize = 4 };
+
+	template<class P> static uint32_t GetSize( const P & )	{ return 4; }
+
+	template<class P> static unsigned char *Encode( const P &, unsigned char *buffer, uint32_t )
+	{
+		PACKET_PutUInt32( buffer, V );
+		return buffer + 4;
+	}
+
+	template<class P> static bool Decode( P &, const unsigned char *&data, const unsigned char *, uint32_t )
+	{
+		data += 4;
+		return true;
+	}
+};
+
+// N bytes we don't care about, these are written as zeros and skipped when decoding
+
+template<unsigned int N>
+class CFieldSkip
+{
+public:
+	enum { MinSize = N };
+
+	template<class P> static uint32_t GetSize( const P & )	{ return N; }
+
+	template<class P> static unsigned char *Encode( const P &, unsigned char *buffer, uint32_t )
+	{
+		// some compilers warn about a memset with a constant zero length so CFieldSkip<0> doesn't call it at all
+
+		if( N )
+			memset( buffer, 0, N );
+
+		return buffer + N;
+	}
+
+	template<class P> static bool Decode( P &, const unsigned char *&data, const unsigned char *, uint32_t )
+	{
+		data += N;
+		return true;
+	}
+};
+
+// exactly N bytes (e.g. an IP address)
+// the caller checks the size of the bytes before encoding, anything missing is written as zeros
+
+template<class P, unsigned int N, CPacketBytes P :: *M>
+class CFieldBytes
+{
+public:
+	enum { MinSize = N };
+
+	static uint32_t GetSize( const P & )	{ return N; }
+
+	static unsigned char *Encode( const P &fields, unsigned char *buffer, uint32_t )
+	{
+		const CPacketBytes &Bytes = fields.*M;
+		uint32_t Size = Bytes.m_Size < N ? Bytes.m_Size : N;
+
+		if( Size > 0 )
+			memcpy( buffer, Bytes.m_Data, Size );
+
+		memset( buffer + Size, 0, N - Size );
+		return buffer + N;
+	}
+
+	static bool Decode( P &fields, const unsigned char *&data, const unsigned char *, uint32_t )
+	{
+		fields.*M = CPacketBytes( data, N );
+		data += N;
+		return true;
+	}
+};
+
+// a null terminated string, the terminator isn't part of the value
+// like UTIL_ExtractCString a string at the very end of the packet is decoded even if the terminator is missing
+
+template<class P, CPacketBytes P :: *M>
+class CFieldCString
+{
+public:
+	enum { MinSize = 1 };
+
+	static uint32_t GetSize( const P &fields )	{ return ( fields.*M ).m_Size + 1; }
+
+	static unsigned char *Encode( const P &fields, unsigned char *buffer, uint32_t )
+	{
+		const CPacketBytes &Bytes = fields.*M;
+
+		if( Bytes.m_Size > 0 )
+			memcpy( buffer, Bytes.m_Data, Bytes.m_Size );
+
+		buffer[Bytes.m_Size] = 0;
+		return buffer + Bytes.m_Size + 1;
+	}
+
+	static bool Decode( P &fields, const unsigned char *&data, const unsigned char *end, uint32_t restMinSize )
+	{
+		const unsigned char *Limit = end - restMinSize;
+		const unsigned char *Terminator = (const unsigned char *)memchr( data, 0, Limit - data );
+
+		if( Terminator )
+		{
+			fields.*M = CPacketBytes( data, Terminator - data );
+			data = Terminator + 1;
+			return true;
+		}
+
+		if( restMinSize == 0 )
+		{
+			fields.*M = CPacketBytes( data, end - data );
+			data = end;
+			return true;
+		}
+
+		return false;
+	}
+};
+
+// a null terminated string at the end of the packet which may be missing completely
+
+template<class P, CPacketBytes P :: *M>
+class CFieldTrailingCString : public CFieldCString<P, M>
+{
+public:
+	enum { MinSize = 0 };
+};
+
+// a byte array preceded by its size as a T (unsigned char or uint16_t)
+
+template<class P, class T, CPacketBytes P :: *M>
+class CFieldCounted
+{
+public:
+	enum { MinSize = sizeof( T ) };
+
+	static uint32_t GetSize( const P &fields )	{ return sizeof( T ) + ( fields.*M ).m_Size; }
+
+	static unsigned char *Encode( const P &fields, unsigned char *buffer, uint32_t )
+	{
+		const CPacketBytes &Bytes = fields.*M;
+
+		for( unsigned int i = 0; i < sizeof( T ); i++ )
+			buffer[i] = (unsigned char)( Bytes.m_Size >> ( 8 * i ) );
+
+		buffer += sizeof( T );
+
+		if( Bytes.m_Size > 0 )
+			memcpy( buffer, Bytes.m_Data, Bytes.m_Size );
+
+		return buffer + Bytes.m_Size;
+	}
+
+	static bool Decode( P &fields, const unsigned char *&data, const unsigned char *end, uint32_t restMinSize )
+	{
+		uint32_t Size = 0;
+
+		for( unsigned int i = 0; i < sizeof( T ); i++ )
+			Size |= (uint32_t)data[i] << ( 8 * i );
+
+		data += sizeof( T );
+
+		if( Size > (uint32_t)( end - data ) - restMinSize )
+			return false;
+
+		fields.*M = CPacketBytes( data, Size );
+		data += Size;
+		return true;
+	}
+};
+
+// any number of bytes, the size comes from the values when encoding
+// when decoding it takes every byte up to the fixed size fields that follow it so it's normally the last field (e.g. the rest of the packet)
+
+template<class P, CPacketBytes P :: *M>
+class CFieldRaw
+{
+public:
+	enum { MinSize = 0 };
+
+	static uint32_t GetSize( const P &fields )	{ return ( fields.*M ).m_Size; }
+
+	static unsigned char *Encode( const P &fields, unsigned char *buffer, uint32_t )
+	{
+		const CPacketBytes &Bytes = fields.*M;
+
+		if( Bytes.m_Size > 0 )
+			memcpy( buffer, Bytes.m_Data, Bytes.m_Size );
+
+		return buffer + Bytes.m_Size;
+	}
+
+	static bool Decode( P &fields, const unsigned char *&data, const unsigned char *end, uint32_t restMinSize )
+	{
+		fields.*M = CPacketBytes( data, ( end - data ) - restMinSize );
+		data = end - restMinSize;
+		return true;
+	}
+};
+
+//
+// CPacketSchema
+//
+
+// up to 16 fields, the unused ones are CFieldNone
+
+class CFieldNone
+{
+
+};
+
+template<	class F1, class F2 = CFieldNone, class F3 = CFieldNone, class F4 = CFieldNone,
+			class F5 = CFieldNone, class F6 = CFieldNone, class F7 = CFieldNone, class F8 = CFieldNone,
+			class F9 = CFieldNone, class F10 = CFieldNone, class F11 = CFieldNone, class F12 = CFieldNone,
+			class F13 = CFieldNone, class F14 = CFieldNone, class F15 = CFieldNone, class F16 = CFieldNone >
+class CPacketSchema
+{
+public:
+	typedef CPacketSchema<F2, F3, F4, F5, F6, F7, F8, F9, F10, F11, F12, F13, F14, F15, F16, CFieldNone> Rest;
+
+	enum { MinSize = F1 :: MinSize + Rest :: MinSize };
+
+	template<class P> static uint32_t GetSize( const P &fields )
+	{
+		return F1 :: GetSize( fields ) + Rest :: GetSize( fields );
+	}
+
+	// encode the packet into a new byte array of exactly the right size
+
+	template<class P> static BYTEARRAY Encode( const P &fields )
+	{
+		uint32_t Size = GetSize( fields );
+		BYTEARRAY packet( Size );
+
+		if( Size > 0 )
+			EncodeFields( fields, &packet[0], Size );
+
+		return packet;
+	}
+
+	// encode the packet into the caller's buffer, returns the size of the packet or 0 if it doesn't fit
+
+	template<class P> static uint32_t Encode( const P &fields, unsigned char *buffer, uint32_t capacity )
+	{
+		uint32_t Size = GetSize( fields );
+
+		if( Size > capacity )
+			return 0;
+
+		EncodeFields( fields, buffer, Size );
+		return Size;
+	}
+
+	// write every field into a buffer of at least GetSize bytes, size is the size of the whole packet (for the header)
+	// returns the position after the last field so a packet can be finished by hand (e.g. a list of actions)
+
+	template<class P> static unsigned char *EncodeFields( const P &fields, unsigned char *buffer, uint32_t size )
+	{
+		return Rest :: EncodeFields( fields, F1 :: Encode( fields, buffer, size ), size );
+	}
+
+	// decode a whole packet
+
+	template<class P> static bool Decode( P &fields, const BYTEARRAY &data )
+	{
+		if( data.size( ) < MinSize )
+			return false;
+
+		const unsigned char *Data = &data[0];
+		return DecodeFields( fields, Data, Data + data.size( ) );
+	}
+
+	template<class P> static bool Decode( P &fields, const CPacketBytes &data )
+	{
+		if( data.m_Size < MinSize )
+			return false;
+
+		const unsigned char *Data = data.m_Data;
+		return DecodeFields( fields, Data, Data + data.m_Size );
+	}
+
+	// decode one record from the middle of a packet (e.g. one entry of a list) and move data past it
+
+	template<class P> static bool Decode( P &fields, const unsigned char *&data, const unsigned char *end )
+	{
+		if( (uint32_t)( end - data ) < MinSize )
+			return false;
+
+		return DecodeFields( fields, data, end );
+	}
+
+	template<class P> static bool DecodeFields( P &fields, const unsigned char *&data, const unsigned char *end )
+	{
+		return F1 :: Decode( fields, data, end, Rest :: MinSize ) && Rest :: DecodeFields( fields, data, end );
+	}
+};
+
+template<>
+class CPacketSchema<CFieldNone, CFieldNone, CFieldNone, CFieldNone, CFieldNone, CFieldNone, CFieldNone, CFieldNone, CFieldNone, CFieldNone, CFieldNone, CFieldNone, CFieldNone, CFieldNone, CFieldNone, CFieldNone>
+{
+public:
+	enum { MinSize = 0 };
+
+	template<class P> static uint32_t GetSize( const P & )																{ return 0; }
+	template<class P> static unsigned char *EncodeFields( const P &, unsigned char *buffer, uint32_t )					{ return buffer; }
+	template<class P> static bool DecodeFields( P &, const unsigned char *&, const unsigned char * )					{ return true; }
+};
+
+#endif
@@ -0,0 +1,275 @@
+/*
+
+   Copyright [2008] [Trevor Hogan]
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+   CODE PORTED FROM THE ORIGINAL GHOST PROJECT: http://ghost.pwner.org/
+
+*/
+
+#include "ghost.h"
+#include "util.h"
+#include "ghostdb.h"
+#include "playeridcache.h"
+
+//
+// CPlayerIdCache
+//
+
+CPlayerIdCache :: CPlayerIdCache( CGHost *nGHost, uint32_t nMaxSize )
+{
+	m_GHost = nGHost;
+	m_MaxSize = nMaxSize;
+
+	// warm the cache with the most recent players so the regulars don't need a query when they join
+
+	if( m_MaxSize > 0 )
+		m_CallableGetRecentPlayerIds = m_GHost->m_DB->ThreadedGetRecentPlayerIds( m_MaxSize );
+	else
+		m_CallableGetRecentPlayerIds = NULL;
+}
+
+CPlayerIdCache :: ~CPlayerIdCache( )
+{
+	if( m_CallableGetRecentPlayerIds )
+		m_GHost->m_Callables.push_back( m_CallableGetRecentPlayerIds );
+
+	for( map<string, CPlayerIdRequest> :: iterator i = m_Requests.begin( ); i != m_Requests.end( ); i++ )
+	{
+		if( i->second.m_GetCallable )
+			m_GHost->m_Callables.push_back( i->second.m_GetCallable );
+
+		if( i->second.m_CreateCallable )
+			m_GHost->m_Callables.push_back( i->second.m_CreateCallable );
+	}
+}
+
+void CPlayerIdCache :: Update( )
+{
+	if( m_CallableGetRecentPlayerIds && m_CallableGetRecentPlayerIds->GetReady( ) )
+	{
+		vector<PlayerIdP> PlayerIds = m_CallableGetRecentPlayerIds->GetResult( );
+
+		for( vector<PlayerIdP> :: iterator i = PlayerIds.begin( ); i != PlayerIds.end( ); i++ )
+			Add( i->first, i->second, false );
+
+		CONSOLE_Print( "[PLAYERID] loaded " + UTIL_ToString( PlayerIds.size( ) ) + " recent player ids" );
+		m_GHost->m_DB->RecoverCallable( m_CallableGetRecentPlayerIds );
+		delete m_CallableGetRecentPlayerIds;
+		m_CallableGetRecentPlayerIds = NULL;
+	}
+
+	for( map<string, CPlayerIdRequest> :: iterator i = m_Requests.begin( ); i != m_Requests.end( ); )
+	{
+		CPlayerIdRequest &Request = i->second;
+		uint32_t PlayerId = 0;
+		bool Finished = false;
+
+		if( ( Request.m_State == PLAYERID_RETRYLOOKUP || Request.m_State == PLAYERID_RETRYCREATE ) && Request.m_Waiters > 0 && GetTicks( ) >= Request.m_RetryTicks )
+			Start( Request );
+
+		if( Request.m_GetCallable && Request.m_GetCallable->GetReady( ) )
+		{
+			bool Error = !Request.m_GetCallable->GetError( ).empty( );
+			PlayerId = Request.m_GetCallable->GetResult( );
+			m_GHost->m_DB->RecoverCallable( Request.m_GetCallable );
+			delete Request.m_GetCallable;
+			Request.m_GetCallable = NULL;
+
+			if( Error )
+				Fail( Request );
+			else if( PlayerId != 0 )
+				Finished = true;
+			else if( Request.m_Waiters > 0 )
+			{
+				// the player is new
+
+				Request.m_State = PLAYERID_CREATING;
+				Request.m_CreateCallable = m_GHost->m_DB->ThreadedCreatePlayerId( Request.m_Name, Request.m_IP, Request.m_Realm );
+
+				if( !Request.m_CreateCallable )
+					Fail( Request );
+			}
+		}
+		else if( Request.m_CreateCallable && Request.m_CreateCallable->GetReady( ) )
+		{
+			PlayerId = Request.m_CreateCallable->GetResult( );
+			m_GHost->m_DB->RecoverCallable( Request.m_CreateCallable );
+			delete Request.m_CreateCallable;
+			Request.m_CreateCallable = NULL;
+
+			// if creating the player id failed we start again with a lookup because another bot might have created it in the meantime
+
+			if( PlayerId != 0 )
+				Finished = true;
+			else
+				Fail( Request );
+		}
+
+		// keep the player id in the request until the waiting players have read it because the cache entry might be evicted before then (or never stored at all if the cache size is 0)
+
+		if( Finished )
+		{
+			Add( i->first, PlayerId, true );
+			Request.m_State = PLAYERID_FOUND;
+			Request.m_PlayerId = PlayerId;
+		}
+
+		// drop the request once nobody is waiting for it anymore, but not while a query is running because the callable has to finish first
+
+		if( Request.m_Waiters == 0 && !Request.m_GetCallable && !Request.m_CreateCallable )
+			m_Requests.erase( i++ );
+		else
+			i++;
+	}
+}
+
+void CPlayerIdCache :: Request( string name, string ip, string realm )
+{
+	string LowerName = name;
+	transform( LowerName.begin( ), LowerName.end( ), LowerName.begin( ), (int(*)(int))tolower );
+
+	// if the player id is already being requested the player shares that request
+
+	map<string, CPlayerIdRequest> :: iterator i = m_Requests.find( LowerName );
+
+	if( i != m_Requests.end( ) )
+	{
+		i->second.m_Waiters++;
+		return;
+	}
+
+	CPlayerIdRequest &Request = m_Requests[LowerName];
+	Request.m_Name = name;
+	Request.m_IP = ip;
+	Request.m_Realm = realm;
+	Request.m_Waiters = 1;
+
+	// if the player id is already known the request is finished straight away
+
+	boost :: unordered_map<string, CPlayerIdCacheEntry> :: iterator j = m_Entries.find( LowerName );
+
+	if( j != m_Entries.end( ) )
+	{
+		m_LRU.splice( m_LRU.begin( ), m_LRU, j->second.m_LRU );
+		Request.m_State = PLAYERID_FOUND;
+		Request.m_PlayerId = j->second.m_PlayerId;
+	}
+	else
+		Start( Request );
+}
+
+uint32_t CPlayerIdCache :: GetState( string name, uint32_t *playerId )
+{
+	transform( name.begin( ), name.end( ), name.begin( ), (int(*)(int))tolower );
+	map<string, CPlayerIdRequest> :: iterator i = m_Requests.find( name );
+
+	if( i != m_Requests.end( ) )
+	{
+		if( i->second.m_State == PLAYERID_FOUND )
+			*playerId = i->second.m_PlayerId;
+
+		return i->second.m_State;
+	}
+
+	boost :: unordered_map<string, CPlayerIdCacheEntry> :: iterator j = m_Entries.find( name );
+
+	if( j != m_Entries.end( ) )
+	{
+		m_LRU.splice( m_LRU.begin( ), m_LRU, j->second.m_LRU );
+		*playerId = j->second.m_PlayerId;
+		return PLAYERID_FOUND;
+	}
+
+	return PLAYERID_UNKNOWN;
+}
+
+void CPlayerIdCache :: Release( string name )
+{
+	// the request itself is dropped in Update
+
+	transform( name.begin( ), name.end( ), name.begin( ), (int(*)(int))tolower );
+	map<string, CPlayerIdRequest> :: iterator i = m_Requests.find( name );
+
+	if( i != m_Requests.end( ) && i->second.m_Waiters > 0 )
+		i->second.m_Waiters--;
+}
+
+void CPlayerIdCache :: Add( string lowerName, uint32_t playerId, bool recent )
+{
+	if( m_MaxSize == 0 )
+		return;
+
+	boost :: unordered_map<string, CPlayerIdCacheEntry> :: iterator i = m_Entries.find( lowerName );
+
+	if( i != m_Entries.end( ) )
+	{
+		i->second.m_PlayerId = playerId;
+
+		if( recent )
+			m_LRU.splice( m_LRU.begin( ), m_LRU, i->second.m_LRU );
+
+		return;
+	}
+
+	// the players used to warm the cache are older than anything we've looked up ourselves so they go to the end of the list
+
+	CPlayerIdCacheEntry &Entry = m_Entries[lowerName];
+	Entry.m_PlayerId = playerId;
+
+	if( recent )
+		Entry.m_LRU = m_LRU.insert( m_LRU.begin( ), lowerName );
+	else
+		Entry.m_LRU = m_LRU.insert( m_LRU.end( ), lowerName );
+
+	while( m_Entries.size( ) > m_MaxSize )
+	{
+		m_Entries.erase( m_LRU.back( ) );
+		m_LRU.pop_back( );
+	}
+}
+
+void CPlayerIdCache :: Start( CPlayerIdRequest &request )
+{
+	request.m_State = PLAYERID_LOOKUP;
+	request.m_GetCallable = m_GHost->m_DB->ThreadedGetPlayerId( request.m_Name );
+
+	if( !request.m_GetCallable )
+		Fail( request );
+}
+
+void CPlayerIdCache :: Fail( CPlayerIdRequest &request )
+{
+	// if nobody is waiting for the player id anymore there's no point in trying again, Update drops the request
+
+	if( request.m_Waiters == 0 )
+		return;
+
+	// wait 1, 2, 4, ... up to 64 seconds before trying again
+
+	uint32_t Delay = 1000 << ( request.m_Failures < 6 ? request.m_Failures : 6 );
+	request.m_Failures++;
+	request.m_RetryTicks = GetTicks( ) + Delay;
+
+	if( request.m_State == PLAYERID_CREATING )
+	{
+		request.m_State = PLAYERID_RETRYCREATE;
+		CONSOLE_Print( "[PLAYERID] unable to create player id for [" + request.m_Name + "], retrying in " + UTIL_ToString( Delay / 1000 ) + " seconds" );
+	}
+	else
+	{
+		request.m_State = PLAYERID_RETRYLOOKUP;
+		CONSOLE_Print( "[PLAYERID] unable to look up player id for [" + request.m_Name + "], retrying in " + UTIL_ToString( Delay / 1000 ) + " seconds" );
+	}
+}
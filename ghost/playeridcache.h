@@ -0,0 +1,102 @@
+/*
+
+   Copyright [2008] [Trevor Hogan]
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+   CODE PORTED FROM THE ORIGINAL GHOST PROJECT: http://ghost.pwner.org/
+
+*/
+
+#ifndef PLAYERIDCACHE_H
+#define PLAYERIDCACHE_H
+
+#include <boost/unordered_map.hpp>
+
+//
+// CPlayerIdCache
+//
+
+// every player needs a player id (from the oh_stats_players table) when they join a game
+// the cache remembers the ids of recently seen players (least recently used are evicted first) so most joins don't need a database query at all
+// lookups of the same name are coalesced into a single request (e.g. a player joining two lobbies) which is shared by every game that asks for it
+// if looking up or creating the player id fails the request is started again later with an exponential backoff
+// the games call Request when a player joins and poll the state of each of their players without a player id in their Update function
+// a finished request keeps its player id until every player waiting for it has called Release, it doesn't depend on the entry still being in the cache
+// a request nobody is waiting for anymore (e.g. the player left) is dropped instead of being tried again
+// note: this is only used from the main thread
+
+#define PLAYERID_UNKNOWN		0		// the player id isn't known and isn't being requested, call Request
+#define PLAYERID_LOOKUP			1		// the player id is being looked up
+#define PLAYERID_CREATING		2		// the player is new and their player id is being created
+#define PLAYERID_RETRYLOOKUP	3		// looking up the player id failed and will be tried again later
+#define PLAYERID_RETRYCREATE	4		// creating the player id failed and will be tried again later (starting with a lookup)
+#define PLAYERID_FOUND			5		// the player id is known
+
+class CCallableGetPlayerId;
+class CCallableCreatePlayerId;
+class CCallableGetRecentPlayerIds;
+
+class CPlayerIdRequest
+{
+public:
+	string m_Name;
+	string m_IP;
+	string m_Realm;
+	CCallableGetPlayerId *m_GetCallable;
+	CCallableCreatePlayerId *m_CreateCallable;
+	uint32_t m_State;					// PLAYERID_LOOKUP, PLAYERID_CREATING, PLAYERID_RETRYLOOKUP, PLAYERID_RETRYCREATE or PLAYERID_FOUND
+	uint32_t m_PlayerId;				// the player id (PLAYERID_FOUND only)
+	uint32_t m_Waiters;					// how many players are waiting for this request (the number of Request calls minus the number of Release calls)
+	uint32_t m_Failures;				// how many times in a row this request failed
+	uint32_t m_RetryTicks;				// GetTicks when the request should be tried again (PLAYERID_RETRY* only)
+
+	CPlayerIdRequest( ) : m_GetCallable( NULL ), m_CreateCallable( NULL ), m_State( PLAYERID_LOOKUP ), m_PlayerId( 0 ), m_Waiters( 0 ), m_Failures( 0 ), m_RetryTicks( 0 ) { }
+};
+
+class CPlayerIdCacheEntry
+{
+public:
+	uint32_t m_PlayerId;
+	list<string> :: iterator m_LRU;		// the position of this entry in m_LRU
+};
+
+class CPlayerIdCache
+{
+private:
+	CGHost *m_GHost;
+	uint32_t m_MaxSize;												// the maximum number of cached player ids
+	boost :: unordered_map<string, CPlayerIdCacheEntry> m_Entries;	// lowercase name -> player id
+	list<string> m_LRU;												// the lowercase names of the cached player ids, most recently used first
+	map<string, CPlayerIdRequest> m_Requests;						// lowercase name -> request in progress or finished request not yet read by every waiting player
+	CCallableGetRecentPlayerIds *m_CallableGetRecentPlayerIds;		// warms the cache on startup
+
+public:
+	CPlayerIdCache( CGHost *nGHost, uint32_t nMaxSize );
+	~CPlayerIdCache( );
+
+	uint32_t GetSize( )				{ return m_Entries.size( ); }
+	uint32_t GetNumRequests( )		{ return m_Requests.size( ); }
+
+	void Update( );
+	void Request( string name, string ip, string realm );
+	uint32_t GetState( string name, uint32_t *playerId );
+	void Release( string name );
+
+private:
+	void Add( string lowerName, uint32_t playerId, bool recent );
+	void Start( CPlayerIdRequest &request );
+	void Fail( CPlayerIdRequest &request );
+};
+
+#endif
@@ -163,6 +163,9 @@ CTCPSocket :: CTCPSocket( ) : CSocket( )
 {
 	Allocate( SOCK_STREAM );
 	m_Connected = false;
+	m_SendQueueOffset = 0;
+	m_SendQueueLane = 0;
+	m_SendQueueBytes = 0;
 	m_LastRecv = GetTime( );
 	m_LastSend = GetTime( );
 
@@ -179,6 +182,9 @@ CTCPSocket :: CTCPSocket( ) : CSocket( )
 CTCPSocket :: CTCPSocket( SOCKET nSocket, struct sockaddr_in nSIN ) : CSocket( nSocket, nSIN )
 {
 	m_Connected = true;
+	m_SendQueueOffset = 0;
+	m_SendQueueLane = 0;
+	m_SendQueueBytes = 0;
 	m_LastRecv = GetTime( );
 	m_LastSend = GetTime( );
 
@@ -204,7 +210,7 @@ void CTCPSocket :: Reset( )
 	Allocate( SOCK_STREAM );
 	m_Connected = false;
 	m_RecvBuffer.clear( );
-	m_SendBuffer.clear( );
+	ClearSendBuffer( );
 	m_LastRecv = GetTime( );
 	m_LastSend = GetTime( );
 
@@ -232,12 +238,49 @@ void CTCPSocket :: Reset( )
 
 void CTCPSocket :: PutBytes( string bytes )
 {
-	m_SendBuffer += bytes;
+	PutBytes( SHAREDBYTEARRAY( new BYTEARRAY( bytes.begin( ), bytes.end( ) ) ) );
 }
 
 void CTCPSocket :: PutBytes( BYTEARRAY bytes )
 {
-	m_SendBuffer += string( bytes.begin( ), bytes.end( ) );
+	PutBytes( SHAREDBYTEARRAY( new BYTEARRAY( bytes ) ) );
+}
+
+void CTCPSocket :: PutBytes( SHAREDBYTEARRAY bytes, unsigned char lane )
+{
+	if( bytes->empty( ) )
+		return;
+
+	if( lane >= SOCKET_LANES )
+		lane = SOCKET_LANES - 1;
+
+	m_SendQueues[lane].push_back( bytes );
+	m_SendQueueBytes += bytes->size( );
+}
+
+void CTCPSocket :: ClearSendBuffer( )
+{
+	for( unsigned char i = 0; i < SOCKET_LANES; i++ )
+		m_SendQueues[i].clear( );
+
+	m_SendQueueOffset = 0;
+	m_SendQueueLane = 0;
+	m_SendQueueBytes = 0;
+}
+
+uint32_t CTCPSocket :: GetKernelSendBufferSize( )
+{
+	// the number of bytes the kernel has accepted from us but the other end hasn't acknowledged yet
+	// we can only find this out on Linux, elsewhere we just assume the kernel's send buffer is empty
+
+#ifdef __linux__
+	int Queued = 0;
+
+	if( m_Socket != INVALID_SOCKET && ioctl( m_Socket, TIOCOUTQ, &Queued ) == 0 && Queued > 0 )
+		return Queued;
+#endif
+
+	return 0;
 }
 
 void CTCPSocket :: DoRecv( fd_set *fd )
@@ -292,14 +335,76 @@ void CTCPSocket :: DoRecv( fd_set *fd )
 
 void CTCPSocket :: DoSend( fd_set *send_fd )
 {
-	if( m_Socket == INVALID_SOCKET || m_HasError || !m_Connected || m_SendBuffer.empty( ) )
+	if( m_Socket == INVALID_SOCKET || m_HasError || !m_Connected || m_SendQueueBytes == 0 )
 		return;
 
 	if( FD_ISSET( m_Socket, send_fd ) )
 	{
-		// socket is ready, send it
+		// socket is ready, send as many queued packets as possible with a single call
+		// this gives the kernel everything at once so it's sent in as few segments as possible even though we're using TCP_NODELAY
+		// the rest of the partially sent packet (if any) goes first, then each lane in order
+
+		unsigned char *Data[SOCKET_SENDVECTORS];
+		uint32_t Lengths[SOCKET_SENDVECTORS];
+		unsigned char Lanes[SOCKET_SENDVECTORS];
+		uint32_t Vectors = 0;
+
+		if( m_SendQueueOffset > 0 )
+		{
+			BYTEARRAY &Packet = *m_SendQueues[m_SendQueueLane].front( );
+			Data[0] = &Packet[m_SendQueueOffset];
+			Lengths[0] = Packet.size( ) - m_SendQueueOffset;
+			Lanes[0] = m_SendQueueLane;
+			Vectors++;
+		}
 
-		int s = send( m_Socket, m_SendBuffer.c_str( ), (int)m_SendBuffer.size( ), MSG_NOSIGNAL );
+		for( unsigned char i = 0; i < SOCKET_LANES; i++ )
+		{
+			deque<SHAREDBYTEARRAY> :: iterator j = m_SendQueues[i].begin( );
+
+			if( m_SendQueueOffset > 0 && i == m_SendQueueLane )
+				j++;
+
+			for( ; j != m_SendQueues[i].end( ) && Vectors < SOCKET_SENDVECTORS; j++ )
+			{
+				Data[Vectors] = &(**j)[0];
+				Lengths[Vectors] = (*j)->size( );
+				Lanes[Vectors] = i;
+				Vectors++;
+			}
+		}
+
+#ifdef WIN32
+		WSABUF Buffers[SOCKET_SENDVECTORS];
+
+		for( uint32_t i = 0; i < Vectors; i++ )
+		{
+			Buffers[i].buf = (char *)Data[i];
+			Buffers[i].len = Lengths[i];
+		}
+
+		DWORD Sent = 0;
+		int s = WSASend( m_Socket, Buffers, Vectors, &Sent, 0, NULL, NULL );
+
+		if( s != SOCKET_ERROR )
+			s = Sent;
+#else
+		struct iovec Buffers[SOCKET_SENDVECTORS];
+
+		for( uint32_t i = 0; i < Vectors; i++ )
+		{
+			Buffers[i].iov_base = Data[i];
+			Buffers[i].iov_len = Lengths[i];
+		}
+
+		// use sendmsg instead of writev so we can pass MSG_NOSIGNAL
+
+		struct msghdr Message;
+		memset( &Message, 0, sizeof( Message ) );
+		Message.msg_iov = Buffers;
+		Message.msg_iovlen = Vectors;
+		int s = sendmsg( m_Socket, &Message, MSG_NOSIGNAL );
+#endif
 
 		if( s == SOCKET_ERROR && GetLastError( ) != EWOULDBLOCK )
 		{
@@ -312,7 +417,33 @@ void CTCPSocket :: DoSend( fd_set *send_fd )
 		}
 		else if( s > 0 )
 		{
-			// success! only some of the data may have been sent, remove it from the buffer
+			// success! only some of the data may have been sent, remove it from the queues in the same order we gathered it
+
+			BYTEARRAY SentBytes;
+			uint32_t Remaining = s;
+
+			for( uint32_t i = 0; i < Vectors && Remaining > 0; i++ )
+			{
+				uint32_t Length = min( Lengths[i], Remaining );
+
+				if( !m_LogFile.empty( ) )
+					SentBytes.insert( SentBytes.end( ), Data[i], Data[i] + Length );
+
+				Remaining -= Length;
+
+				if( Length == Lengths[i] )
+				{
+					m_SendQueues[Lanes[i]].pop_front( );
+					m_SendQueueOffset = 0;
+				}
+				else
+				{
+					m_SendQueueOffset = m_SendQueues[Lanes[i]].front( )->size( ) - Lengths[i] + Length;
+					m_SendQueueLane = Lanes[i];
+				}
+			}
+
+			m_SendQueueBytes -= s;
 
 			if( !m_LogFile.empty( ) )
 			{
@@ -321,12 +452,11 @@ void CTCPSocket :: DoSend( fd_set *send_fd )
 
 				if( !Log.fail( ) )
 				{
-					Log << "SEND >>> " << UTIL_ByteArrayToHexString( BYTEARRAY( m_SendBuffer.begin( ), m_SendBuffer.begin( ) + s ) ) << endl;
+					Log << "SEND >>> " << UTIL_ByteArrayToHexString( SentBytes ) << endl;
 					Log.close( );
 				}
 			}
 
-			m_SendBuffer = m_SendBuffer.substr( s );
 			m_LastSend = GetTime( );
 		}
 	}
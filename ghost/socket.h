@@ -71,6 +71,7 @@
  #include <sys/ioctl.h>
  #include <sys/socket.h>
  #include <sys/types.h>
+ #include <sys/uio.h>
  #include <unistd.h>
 
  typedef int SOCKET;
@@ -95,6 +96,15 @@
  #define SHUT_RDWR 2
 #endif
 
+// the maximum number of queued packets we hand to the kernel in a single send call
+
+#define SOCKET_SENDVECTORS 64
+
+// outgoing packets are queued in one of several lanes and a lower lane is always sent first
+// a packet which has been partially sent is always finished first though so packets are never interleaved
+
+#define SOCKET_LANES 4
+
 //
 // CSocket
 //
@@ -135,7 +145,10 @@ protected:
 
 private:
 	string m_RecvBuffer;
-	string m_SendBuffer;
+	deque<SHAREDBYTEARRAY> m_SendQueues[SOCKET_LANES];	// packets waiting to be sent, each one is sent straight from its own buffer so a packet sent to every player is only stored once
+	uint32_t m_SendQueueOffset;					// how many bytes of the partially sent packet have already been sent (0 = no packet has been partially sent)
+	unsigned char m_SendQueueLane;				// the lane whose first packet has been partially sent
+	uint32_t m_SendQueueBytes;					// how many bytes are waiting to be sent
 	uint32_t m_LastRecv;
 	uint32_t m_LastSend;
 
@@ -149,8 +162,11 @@ public:
 	virtual string *GetBytes( )					{ return &m_RecvBuffer; }
 	virtual void PutBytes( string bytes );
 	virtual void PutBytes( BYTEARRAY bytes );
+	virtual void PutBytes( SHAREDBYTEARRAY bytes, unsigned char lane = 0 );
 	virtual void ClearRecvBuffer( )				{ m_RecvBuffer.clear( ); }
-	virtual void ClearSendBuffer( )				{ m_SendBuffer.clear( ); }
+	virtual void ClearSendBuffer( );
+	virtual uint32_t GetSendBufferSize( )		{ return m_SendQueueBytes; }
+	virtual uint32_t GetKernelSendBufferSize( );
 	virtual uint32_t GetLastRecv( )				{ return m_LastRecv; }
 	virtual uint32_t GetLastSend( )				{ return m_LastSend; }
 	virtual void DoRecv( fd_set *fd );
@@ -19,8 +19,209 @@
 */
 
 #include "ghost.h"
+#include "util.h"
 #include "stats.h"
 
+#include <string.h>
+
+//
+// CActionDecoder
+//
+
+CActionFormat CActionDecoder :: m_Formats[256];
+bool CActionDecoder :: m_Initialized = false;
+
+void CActionDecoder :: Initialize( )
+{
+	if( m_Initialized )
+		return;
+
+	// the lengths don't include the action ID and are for patch 1.13 and newer (the ability flags are a word)
+
+	memset( m_Formats, 0, sizeof( m_Formats ) );
+	SetFormat( 0x01, ACTIONFORMAT_FIXED, 0 );			// pause game
+	SetFormat( 0x02, ACTIONFORMAT_FIXED, 0 );			// resume game
+	SetFormat( 0x03, ACTIONFORMAT_FIXED, 1 );			// set game speed
+	SetFormat( 0x04, ACTIONFORMAT_FIXED, 0 );			// increase game speed
+	SetFormat( 0x05, ACTIONFORMAT_FIXED, 0 );			// decrease game speed
+	SetFormat( 0x06, ACTIONFORMAT_STRINGS, 0, 1 );		// save game
+	SetFormat( 0x07, ACTIONFORMAT_FIXED, 4 );			// save game finished
+	SetFormat( 0x10, ACTIONFORMAT_FIXED, 14 );			// unit/building ability
+	SetFormat( 0x11, ACTIONFORMAT_FIXED, 22 );			// unit/building ability with target position
+	SetFormat( 0x12, ACTIONFORMAT_FIXED, 30 );			// unit/building ability with target position and target object
+	SetFormat( 0x13, ACTIONFORMAT_FIXED, 38 );			// give item to unit / drop item on ground
+	SetFormat( 0x14, ACTIONFORMAT_FIXED, 43 );			// unit/building ability with two target positions and two item IDs
+	SetFormat( 0x16, ACTIONFORMAT_SELECTION, 0 );		// change selection
+	SetFormat( 0x17, ACTIONFORMAT_SELECTION, 0 );		// assign group hotkey
+	SetFormat( 0x18, ACTIONFORMAT_FIXED, 2 );			// select group hotkey
+	SetFormat( 0x19, ACTIONFORMAT_FIXED, 12 );			// select subgroup
+	SetFormat( 0x1A, ACTIONFORMAT_FIXED, 0 );			// pre subselection
+	SetFormat( 0x1B, ACTIONFORMAT_FIXED, 9 );			// unknown
+	SetFormat( 0x1C, ACTIONFORMAT_FIXED, 9 );			// select ground item
+	SetFormat( 0x1D, ACTIONFORMAT_FIXED, 8 );			// cancel hero revival
+	SetFormat( 0x1E, ACTIONFORMAT_FIXED, 5 );			// remove unit from building queue
+	SetFormat( 0x21, ACTIONFORMAT_FIXED, 8 );			// unknown
+
+	// single player cheats
+
+	for( unsigned char i = 0x20; i <= 0x32; i++ )
+	{
+		if( i != 0x21 )
+			SetFormat( i, ACTIONFORMAT_FIXED, 0 );
+	}
+
+	SetFormat( 0x27, ACTIONFORMAT_FIXED, 5 );			// KeyserSoze
+	SetFormat( 0x28, ACTIONFORMAT_FIXED, 5 );			// LeafitToMe
+	SetFormat( 0x2D, ACTIONFORMAT_FIXED, 5 );			// GreedIsGood
+	SetFormat( 0x2E, ACTIONFORMAT_FIXED, 4 );			// DayLightSavings
+	SetFormat( 0x50, ACTIONFORMAT_FIXED, 5 );			// change ally options
+	SetFormat( 0x51, ACTIONFORMAT_FIXED, 9 );			// transfer resources
+	SetFormat( 0x60, ACTIONFORMAT_STRINGS, 8, 1 );		// map trigger chat command
+	SetFormat( 0x61, ACTIONFORMAT_FIXED, 0 );			// ESC pressed
+	SetFormat( 0x62, ACTIONFORMAT_FIXED, 12 );			// scenario trigger
+	SetFormat( 0x64, ACTIONFORMAT_FIXED, 8 );			// trackable hit
+	SetFormat( 0x65, ACTIONFORMAT_FIXED, 8 );			// trackable track
+	SetFormat( 0x66, ACTIONFORMAT_FIXED, 0 );			// enter choose hero skill submenu
+	SetFormat( 0x67, ACTIONFORMAT_FIXED, 0 );			// enter choose building submenu
+	SetFormat( 0x68, ACTIONFORMAT_FIXED, 12 );			// minimap signal
+	SetFormat( 0x69, ACTIONFORMAT_FIXED, 16 );			// continue game (block B)
+	SetFormat( 0x6A, ACTIONFORMAT_FIXED, 16 );			// continue game (block A)
+	SetFormat( 0x6B, ACTIONFORMAT_STRINGS, 0, 3, 4 );	// sync stored integer
+	SetFormat( 0x75, ACTIONFORMAT_FIXED, 1 );			// unknown
+	m_Initialized = true;
+}
+
+void CActionDecoder :: SetFormat( unsigned char id, unsigned char format, unsigned char length, unsigned char strings, unsigned char trailer )
+{
+	m_Formats[id].m_Format = format;
+	m_Formats[id].m_Length = length;
+	m_Formats[id].m_Strings = strings;
+	m_Formats[id].m_Trailer = trailer;
+}
+
+bool CActionDecoder :: Decode( BYTEARRAY &action, const char *cache, vector<CSyncStoredInteger> &integers )
+{
+	if( action.empty( ) )
+		return true;
+
+	unsigned char *Data = &action[0];
+	uint32_t Size = action.size( );
+	uint32_t i = 0;
+	bool Known = true;
+
+	while( i < Size )
+	{
+		CActionFormat &Format = m_Formats[Data[i]];
+		uint32_t Length = 0;
+
+		if( Format.m_Format == ACTIONFORMAT_FIXED )
+			Length = 1 + Format.m_Length;
+		else if( Format.m_Format == ACTIONFORMAT_SELECTION )
+		{
+			if( Size - i < 4 )
+				return false;
+
+			Length = 4 + 8 * ( Data[i + 2] | ( Data[i + 3] << 8 ) );
+		}
+		else if( Data[i] == 0x6B )
+		{
+			CSyncStoredInteger Integer;
+
+			if( !DecodeSyncStoredInteger( Data + i, Size - i, &Length, Integer ) )
+				return false;
+
+			if( !strcmp( Integer.m_Cache, cache ) )
+				integers.push_back( Integer );
+		}
+		else if( Format.m_Format == ACTIONFORMAT_STRINGS )
+		{
+			Length = 1 + Format.m_Length;
+
+			for( unsigned char j = 0; j < Format.m_Strings; j++ )
+			{
+				if( Size - i <= Length )
+					return false;
+
+				unsigned char *End = (unsigned char *)memchr( Data + i + Length, 0, Size - i - Length );
+
+				if( !End )
+					return false;
+
+				Length = End - ( Data + i ) + 1;
+			}
+
+			Length += Format.m_Trailer;
+		}
+		else
+		{
+			// we don't know how long this action is so we can't find the next one
+			// search for the next sync stored integer in the requested cache instead (this is how we used to find every action) and pick up from there
+			// the rest of the block can be long (e.g. an unknown action followed by many selections) so this uses the vectorized signature search
+			// the signature is 0x6B followed by the null terminated cache name
+
+			unsigned char Signature[64];
+			uint32_t SignatureLength = strlen( cache ) + 2;
+
+			if( SignatureLength > sizeof( Signature ) )
+				return false;
+
+			Signature[0] = 0x6B;
+			memcpy( Signature + 1, cache, SignatureLength - 1 );
+			Known = false;
+			uint32_t j = i + 1 + UTIL_FindSignature( Data + i + 1, Size - i - 1, Signature, SignatureLength );
+
+			if( j >= Size )
+				return false;
+
+			i = j;
+			continue;
+		}
+
+		if( Length > Size - i )
+			return false;
+
+		i += Length;
+	}
+
+	return Known;
+}
+
+bool CActionDecoder :: DecodeSyncStoredInteger( unsigned char *data, uint32_t length, uint32_t *used, CSyncStoredInteger &integer )
+{
+	// 1 byte					-> 0x6B
+	// null terminated string	-> cache
+	// null terminated string	-> mission key
+	// null terminated string	-> key
+	// 4 bytes					-> value
+
+	const char *Strings[3];
+	uint32_t Position = 1;
+
+	for( int i = 0; i < 3; i++ )
+	{
+		if( Position >= length )
+			return false;
+
+		unsigned char *End = (unsigned char *)memchr( data + Position, 0, length - Position );
+
+		if( !End )
+			return false;
+
+		Strings[i] = (const char *)data + Position;
+		Position = End - data + 1;
+	}
+
+	if( length - Position < 4 )
+		return false;
+
+	integer.m_Cache = Strings[0];
+	integer.m_MissionKey = Strings[1];
+	integer.m_Key = Strings[2];
+	integer.m_Value = data[Position] | ( data[Position + 1] << 8 ) | ( data[Position + 2] << 16 ) | ( (uint32_t)data[Position + 3] << 24 );
+	*used = Position + 4;
+	return true;
+}
+
 //
 // CStats
 //
@@ -28,6 +229,7 @@
 CStats :: CStats( CBaseGame *nGame )
 {
 	m_Game = nGame;
+	CActionDecoder :: Initialize( );
 }
 
 CStats :: ~CStats( )
@@ -35,6 +237,31 @@ CStats :: ~CStats( )
 
 }
 
+void CStats :: SetColourPlayer( uint32_t colour, string name, string server )
+{
+	if( colour < 12 )
+	{
+		m_ColourNames[colour] = name;
+		m_ColourServers[colour] = server;
+	}
+}
+
+string CStats :: GetColourName( uint32_t colour )
+{
+	if( colour < 12 )
+		return m_ColourNames[colour];
+
+	return string( );
+}
+
+string CStats :: GetColourServer( uint32_t colour )
+{
+	if( colour < 12 )
+		return m_ColourServers[colour];
+
+	return string( );
+}
+
 bool CStats :: ProcessAction( CIncomingAction *Action )
 {
 	return false;
@@ -31,19 +31,85 @@
 // and in the Save function you write the results to the database
 // e.g. for dota the number of kills/deaths/assists, etc...
 // the base class is almost completely empty
+// note: ProcessAction may be called on the stats worker thread so it must not look at the game's players or slots, use the names recorded by SetGameName and SetColourPlayer instead
 
 class CIncomingAction;
 class CGHostDB;
 
+//
+// CActionDecoder
+//
+
+// a sync stored integer action (0x6B) which is how maps send data to the host, e.g. DotA's "dr.x" cache and W3MMD's "kMMD.Dat" cache
+// the strings point into the action data they were decoded from so they're only valid as long as the action is
+
+class CSyncStoredInteger
+{
+public:
+	const char *m_Cache;		// the game cache file name, e.g. "dr.x"
+	const char *m_MissionKey;	// e.g. "Data" or "Global" or "1" for DotA, "val:0" for W3MMD
+	const char *m_Key;			// e.g. "Hero1" or "Winner" for DotA, "init pid 0 Varlock" for W3MMD
+	uint32_t m_Value;
+};
+
+// walks an action block one action at a time using the argument lengths documented in w3g_actions.txt
+// if it finds an action we don't know the length of it falls back to searching the rest of the block for a sync stored integer action in the requested cache and resynchronizes after it
+
+#define ACTIONFORMAT_UNKNOWN		0	// we don't know the length of this action
+#define ACTIONFORMAT_FIXED			1	// m_Length bytes
+#define ACTIONFORMAT_SELECTION		2	// 1 byte, 1 word n, n * 8 bytes
+#define ACTIONFORMAT_STRINGS		3	// m_Length bytes, m_Strings null terminated strings, m_Trailer bytes
+
+class CActionFormat
+{
+public:
+	unsigned char m_Format;
+	unsigned char m_Length;
+	unsigned char m_Strings;
+	unsigned char m_Trailer;
+};
+
+class CActionDecoder
+{
+private:
+	static CActionFormat m_Formats[256];
+	static bool m_Initialized;
+
+public:
+	static void Initialize( );
+
+	// appends every sync stored integer action in the given cache to integers
+	// returns false if the block contained an action we don't know the length of
+
+	static bool Decode( BYTEARRAY &action, const char *cache, vector<CSyncStoredInteger> &integers );
+
+private:
+	static void SetFormat( unsigned char id, unsigned char format, unsigned char length, unsigned char strings = 0, unsigned char trailer = 0 );
+	static bool DecodeSyncStoredInteger( unsigned char *data, uint32_t length, uint32_t *used, CSyncStoredInteger &integer );
+};
+
+//
+// CStats
+//
+
 class CStats
 {
 protected:
 	CBaseGame *m_Game;
+	string m_GameName;									// a copy of the game's name for the log messages printed by ProcessAction (the game can be renamed on the main thread)
+	vector<CSyncStoredInteger> m_SyncStoredIntegers;	// the sync stored integers decoded from the current action (reused to avoid an allocation per action)
+	string m_ColourNames[12];							// the name of the player using each colour
+	string m_ColourServers[12];							// the (spoofed) realm of the player using each colour
 
 public:
 	CStats( CBaseGame *nGame );
 	virtual ~CStats( );
 
+	void SetGameName( string nGameName )				{ m_GameName = nGameName; }
+	void SetColourPlayer( uint32_t colour, string name, string server );
+	string GetColourName( uint32_t colour );
+	string GetColourServer( uint32_t colour );
+
 	virtual bool ProcessAction( CIncomingAction *Action );
 	virtual void Save( CGHost *GHost, CGHostDB *DB, uint32_t GameID );
 };
@@ -22,6 +22,7 @@
 #include "util.h"
 #include "ghostdb.h"
 #include "gameprotocol.h"
+#include "timerwheel.h"
 #include "game_base.h"
 #include "stats.h"
 #include "statsw3mmd.h"
@@ -46,301 +47,265 @@ CStatsW3MMD :: ~CStatsW3MMD( )
 
 bool CStatsW3MMD :: ProcessAction( CIncomingAction *Action )
 {
-	unsigned int i = 0;
-	BYTEARRAY *ActionData = Action->GetAction( );
-	BYTEARRAY MissionKey;
-	BYTEARRAY Key;
-	BYTEARRAY Value;
+	// W3MMD messages are sync stored integer actions in the "kMMD.Dat" game cache
 
-	while( ActionData->size( ) >= i + 9 )
+	m_SyncStoredIntegers.clear( );
+	CActionDecoder :: Decode( *Action->GetAction( ), "kMMD.Dat", m_SyncStoredIntegers );
+
+	for( vector<CSyncStoredInteger> :: iterator i = m_SyncStoredIntegers.begin( ); i != m_SyncStoredIntegers.end( ); i++ )
 	{
-		if( (*ActionData)[i] == 'k' &&
-			(*ActionData)[i + 1] == 'M' &&
-			(*ActionData)[i + 2] == 'M' &&
-			(*ActionData)[i + 3] == 'D' &&
-			(*ActionData)[i + 4] == '.' &&
-			(*ActionData)[i + 5] == 'D' &&
-			(*ActionData)[i + 6] == 'a' &&
-			(*ActionData)[i + 7] == 't' &&
-			(*ActionData)[i + 8] == 0x00 )
+		string MissionKeyString = i->m_MissionKey;
+		string KeyString = i->m_Key;
+		uint32_t ValueInt = i->m_Value;
+
+		// CONSOLE_Print( "[STATSW3MMD] DEBUG: mkey [" + MissionKeyString + "], key [" + KeyString + "], value [" + UTIL_ToString( ValueInt ) + "]" );
+
+		if( MissionKeyString.size( ) > 4 && MissionKeyString.substr( 0, 4 ) == "val:" )
 		{
-			if( ActionData->size( ) >= i + 10 )
+			string ValueIDString = MissionKeyString.substr( 4 );
+			uint32_t ValueID = UTIL_ToUInt32( ValueIDString );
+			vector<string> Tokens = TokenizeKey( KeyString );
+
+			if( !Tokens.empty( ) )
 			{
-				MissionKey = UTIL_ExtractCString( *ActionData, i + 9 );
+				if( Tokens[0] == "init" && Tokens.size( ) >= 2 )
+				{
+					if( Tokens[1] == "version" && Tokens.size( ) == 4 )
+					{
+						// Tokens[2] = minimum
+						// Tokens[3] = current
+
+						CONSOLE_Print( "[STATSW3MMD: " + m_GameName + "] map is using Warcraft 3 Map Meta Data library version [" + Tokens[3] + "]" );
+
+						if( UTIL_ToUInt32( Tokens[2] ) > 1 )
+							CONSOLE_Print( "[STATSW3MMD: " + m_GameName + "] warning - parser version 1 is not compatible with this map, minimum version [" + Tokens[2] + "]" );
+					}
+					else if( Tokens[1] == "pid" && Tokens.size( ) == 4 )
+					{
+						// Tokens[2] = pid
+						// Tokens[3] = name
+
+						uint32_t PID = UTIL_ToUInt32( Tokens[2] );
+
+						if( m_PIDToName.find( PID ) != m_PIDToName.end( ) )
+							CONSOLE_Print( "[STATSW3MMD: " + m_GameName + "] overwriting previous name [" + m_PIDToName[PID] + "] with new name [" + Tokens[3] + "] for PID [" + Tokens[2] + "]" );
 
-				if( ActionData->size( ) >= i + 11 + MissionKey.size( ) )
+						m_PIDToName[PID] = Tokens[3];
+					}
+				}
+				else if( Tokens[0] == "DefVarP" && Tokens.size( ) == 5 )
 				{
-					Key = UTIL_ExtractCString( *ActionData, i + 10 + MissionKey.size( ) );
+					// Tokens[1] = name
+					// Tokens[2] = value type
+					// Tokens[3] = goal type (ignored here)
+					// Tokens[4] = suggestion (ignored here)
 
-					if( ActionData->size( ) >= i + 15 + MissionKey.size( ) + Key.size( ) )
+					if( m_DefVarPs.find( Tokens[1] ) != m_DefVarPs.end( ) )
+						CONSOLE_Print( "[STATSW3MMD: " + m_GameName + "] duplicate DefVarP [" + KeyString + "] found, ignoring" );
+					else
 					{
-						Value = BYTEARRAY( ActionData->begin( ) + i + 11 + MissionKey.size( ) + Key.size( ), ActionData->begin( ) + i + 15 + MissionKey.size( ) + Key.size( ) );
-						string MissionKeyString = string( MissionKey.begin( ), MissionKey.end( ) );
-						string KeyString = string( Key.begin( ), Key.end( ) );
-						uint32_t ValueInt = UTIL_ByteArrayToUInt32( Value, false );
+						if( Tokens[2] == "int" || Tokens[2] == "real" || Tokens[2] == "string" )
+							m_DefVarPs[Tokens[1]] = Tokens[2];
+						else
+							CONSOLE_Print( "[STATSW3MMD: " + m_GameName + "] unknown DefVarP [" + KeyString + "] found, ignoring" );
+					}
+
+				}
+				else if( Tokens[0] == "VarP" && Tokens.size( ) == 5 )
+				{
+					// Tokens[1] = pid
+					// Tokens[2] = name
+					// Tokens[3] = operation
+					// Tokens[4] = value
 
-						// CONSOLE_Print( "[STATSW3MMD] DEBUG: mkey [" + MissionKeyString + "], key [" + KeyString + "], value [" + UTIL_ToString( ValueInt ) + "]" );
+					if( m_DefVarPs.find( Tokens[2] ) == m_DefVarPs.end( ) )
+						CONSOLE_Print( "[STATSW3MMD: " + m_GameName + "] VarP [" + KeyString + "] found without a corresponding DefVarP, ignoring" );
+					else
+					{
+						string ValueType = m_DefVarPs[Tokens[2]];
 
-						if( MissionKeyString.size( ) > 4 && MissionKeyString.substr( 0, 4 ) == "val:" )
+						if( ValueType == "int" )
 						{
-							string ValueIDString = MissionKeyString.substr( 4 );
-							uint32_t ValueID = UTIL_ToUInt32( ValueIDString );
-							vector<string> Tokens = TokenizeKey( KeyString );
+							VarP VP = VarP( UTIL_ToUInt32( Tokens[1] ), Tokens[2] );
 
-							if( !Tokens.empty( ) )
+							if( Tokens[3] == "=" )
+								m_VarPInts[VP] = UTIL_ToInt32( Tokens[4] );
+							else if( Tokens[3] == "+=" )
 							{
-								if( Tokens[0] == "init" && Tokens.size( ) >= 2 )
+								if( m_VarPInts.find( VP ) != m_VarPInts.end( ) )
+									m_VarPInts[VP] += UTIL_ToInt32( Tokens[4] );
+								else
 								{
-									if( Tokens[1] == "version" && Tokens.size( ) == 4 )
-									{
-										// Tokens[2] = minimum
-										// Tokens[3] = current
+									// CONSOLE_Print( "[STATSW3MMD: " + m_GameName + "] int VarP [" + KeyString + "] found with relative operation [+=] without a previously assigned value, ignoring" );
+									m_VarPInts[VP] = UTIL_ToInt32( Tokens[4] );
+								}
+							}
+							else if( Tokens[3] == "-=" )
+							{
+								if( m_VarPInts.find( VP ) != m_VarPInts.end( ) )
+									m_VarPInts[VP] -= UTIL_ToInt32( Tokens[4] );
+								else
+								{
+									// CONSOLE_Print( "[STATSW3MMD: " + m_GameName + "] int VarP [" + KeyString + "] found with relative operation [-=] without a previously assigned value, ignoring" );
+									m_VarPInts[VP] = -UTIL_ToInt32( Tokens[4] );
+								}
+							}
+							else
+								CONSOLE_Print( "[STATSW3MMD: " + m_GameName + "] unknown int VarP [" + KeyString + "] operation [" + Tokens[3] + "] found, ignoring" );
+						}
+						else if( ValueType == "real" )
+						{
+							VarP VP = VarP( UTIL_ToUInt32( Tokens[1] ), Tokens[2] );
 
-										CONSOLE_Print( "[STATSW3MMD: " + m_Game->GetGameName( ) + "] map is using Warcraft 3 Map Meta Data library version [" + Tokens[3] + "]" );
+							if( Tokens[3] == "=" )
+								m_VarPReals[VP] = UTIL_ToDouble( Tokens[4] );
+							else if( Tokens[3] == "+=" )
+							{
+								if( m_VarPReals.find( VP ) != m_VarPReals.end( ) )
+									m_VarPReals[VP] += UTIL_ToDouble( Tokens[4] );
+								else
+								{
+									// CONSOLE_Print( "[STATSW3MMD: " + m_GameName + "] real VarP [" + KeyString + "] found with relative operation [+=] without a previously assigned value, ignoring" );
+									m_VarPReals[VP] = UTIL_ToDouble( Tokens[4] );
+								}
+							}
+							else if( Tokens[3] == "-=" )
+							{
+								if( m_VarPReals.find( VP ) != m_VarPReals.end( ) )
+									m_VarPReals[VP] -= UTIL_ToDouble( Tokens[4] );
+								else
+								{
+									// CONSOLE_Print( "[STATSW3MMD: " + m_GameName + "] real VarP [" + KeyString + "] found with relative operation [-=] without a previously assigned value, ignoring" );
+									m_VarPReals[VP] = -UTIL_ToDouble( Tokens[4] );
+								}
+							}
+							else
+								CONSOLE_Print( "[STATSW3MMD: " + m_GameName + "] unknown real VarP [" + KeyString + "] operation [" + Tokens[3] + "] found, ignoring" );
+						}
+						else
+						{
+							VarP VP = VarP( UTIL_ToUInt32( Tokens[1] ), Tokens[2] );
 
-										if( UTIL_ToUInt32( Tokens[2] ) > 1 )
-											CONSOLE_Print( "[STATSW3MMD: " + m_Game->GetGameName( ) + "] warning - parser version 1 is not compatible with this map, minimum version [" + Tokens[2] + "]" );
-									}
-									else if( Tokens[1] == "pid" && Tokens.size( ) == 4 )
-									{
-										// Tokens[2] = pid
-										// Tokens[3] = name
+							if( Tokens[3] == "=" )
+								m_VarPStrings[VP] = Tokens[4];
+							else
+								CONSOLE_Print( "[STATSW3MMD: " + m_GameName + "] unknown string VarP [" + KeyString + "] operation [" + Tokens[3] + "] found, ignoring" );
+						}
+					}
+				}
+				else if( Tokens[0] == "FlagP" && Tokens.size( ) == 3 )
+				{
+					// Tokens[1] = pid
+					// Tokens[2] = flag
 
-										uint32_t PID = UTIL_ToUInt32( Tokens[2] );
+					if( Tokens[2] == "winner" || Tokens[2] == "loser" || Tokens[2] == "drawer" || Tokens[2] == "leaver" || Tokens[2] == "practicing" )
+					{
+						uint32_t PID = UTIL_ToUInt32( Tokens[1] );
 
-										if( m_PIDToName.find( PID ) != m_PIDToName.end( ) )
-											CONSOLE_Print( "[STATSW3MMD: " + m_Game->GetGameName( ) + "] overwriting previous name [" + m_PIDToName[PID] + "] with new name [" + Tokens[3] + "] for PID [" + Tokens[2] + "]" );
+						if( Tokens[2] == "leaver" )
+							m_FlagsLeaver[PID] = true;
+						else if( Tokens[2] == "practicing" )
+							m_FlagsPracticing[PID] = true;
+						else
+						{
+							if( m_Flags.find( PID ) != m_Flags.end( ) )
+								CONSOLE_Print( "[STATSW3MMD: " + m_GameName + "] overwriting previous flag [" + m_Flags[PID] + "] with new flag [" + Tokens[2] + "] for PID [" + Tokens[1] + "]" );
 
-										m_PIDToName[PID] = Tokens[3];
-									}
-								}
-								else if( Tokens[0] == "DefVarP" && Tokens.size( ) == 5 )
-								{
-									// Tokens[1] = name
-									// Tokens[2] = value type
-									// Tokens[3] = goal type (ignored here)
-									// Tokens[4] = suggestion (ignored here)
+							m_Flags[PID] = Tokens[2];
+						}
+					}
+					else
+						CONSOLE_Print( "[STATSW3MMD: " + m_GameName + "] unknown flag [" + Tokens[2] + "] found, ignoring" );
+				}
+				else if( Tokens[0] == "DefEvent" && Tokens.size( ) >= 4 )
+				{
+					// Tokens[1] = name
+					// Tokens[2] = # of arguments (n)
+					// Tokens[3..n+3] = arguments
+					// Tokens[n+3] = format
 
-									if( m_DefVarPs.find( Tokens[1] ) != m_DefVarPs.end( ) )
-										CONSOLE_Print( "[STATSW3MMD: " + m_Game->GetGameName( ) + "] duplicate DefVarP [" + KeyString + "] found, ignoring" );
-									else
-									{
-										if( Tokens[2] == "int" || Tokens[2] == "real" || Tokens[2] == "string" )
-											m_DefVarPs[Tokens[1]] = Tokens[2];
-										else
-											CONSOLE_Print( "[STATSW3MMD: " + m_Game->GetGameName( ) + "] unknown DefVarP [" + KeyString + "] found, ignoring" );
-									}
+					if( m_DefEvents.find( Tokens[1] ) != m_DefEvents.end( ) )
+						CONSOLE_Print( "[STATSW3MMD: " + m_GameName + "] duplicate DefEvent [" + KeyString + "] found, ignoring" );
+					else
+					{
+						uint32_t Arguments = UTIL_ToUInt32( Tokens[2] );
 
-								}
-								else if( Tokens[0] == "VarP" && Tokens.size( ) == 5 )
-								{
-									// Tokens[1] = pid
-									// Tokens[2] = name
-									// Tokens[3] = operation
-									// Tokens[4] = value
+						if( Tokens.size( ) == Arguments + 4 )
+							m_DefEvents[Tokens[1]] = vector<string>( Tokens.begin( ) + 3, Tokens.end( ) );
+					}
+				}
+				else if( Tokens[0] == "Event" && Tokens.size( ) >= 2 )
+				{
+					// Tokens[1] = name
+					// Tokens[2..n+2] = arguments (where n is the # of arguments in the corresponding DefEvent)
 
-									if( m_DefVarPs.find( Tokens[2] ) == m_DefVarPs.end( ) )
-										CONSOLE_Print( "[STATSW3MMD: " + m_Game->GetGameName( ) + "] VarP [" + KeyString + "] found without a corresponding DefVarP, ignoring" );
-									else
-									{
-										string ValueType = m_DefVarPs[Tokens[2]];
-
-										if( ValueType == "int" )
-										{
-											VarP VP = VarP( UTIL_ToUInt32( Tokens[1] ), Tokens[2] );
-
-											if( Tokens[3] == "=" )
-												m_VarPInts[VP] = UTIL_ToInt32( Tokens[4] );
-											else if( Tokens[3] == "+=" )
-											{
-												if( m_VarPInts.find( VP ) != m_VarPInts.end( ) )
-													m_VarPInts[VP] += UTIL_ToInt32( Tokens[4] );
-												else
-												{
-													// CONSOLE_Print( "[STATSW3MMD: " + m_Game->GetGameName( ) + "] int VarP [" + KeyString + "] found with relative operation [+=] without a previously assigned value, ignoring" );
-													m_VarPInts[VP] = UTIL_ToInt32( Tokens[4] );
-												}
-											}
-											else if( Tokens[3] == "-=" )
-											{
-												if( m_VarPInts.find( VP ) != m_VarPInts.end( ) )
-													m_VarPInts[VP] -= UTIL_ToInt32( Tokens[4] );
-												else
-												{
-													// CONSOLE_Print( "[STATSW3MMD: " + m_Game->GetGameName( ) + "] int VarP [" + KeyString + "] found with relative operation [-=] without a previously assigned value, ignoring" );
-													m_VarPInts[VP] = -UTIL_ToInt32( Tokens[4] );
-												}
-											}
-											else
-												CONSOLE_Print( "[STATSW3MMD: " + m_Game->GetGameName( ) + "] unknown int VarP [" + KeyString + "] operation [" + Tokens[3] + "] found, ignoring" );
-										}
-										else if( ValueType == "real" )
-										{
-											VarP VP = VarP( UTIL_ToUInt32( Tokens[1] ), Tokens[2] );
-
-											if( Tokens[3] == "=" )
-												m_VarPReals[VP] = UTIL_ToDouble( Tokens[4] );
-											else if( Tokens[3] == "+=" )
-											{
-												if( m_VarPReals.find( VP ) != m_VarPReals.end( ) )
-													m_VarPReals[VP] += UTIL_ToDouble( Tokens[4] );
-												else
-												{
-													// CONSOLE_Print( "[STATSW3MMD: " + m_Game->GetGameName( ) + "] real VarP [" + KeyString + "] found with relative operation [+=] without a previously assigned value, ignoring" );
-													m_VarPReals[VP] = UTIL_ToDouble( Tokens[4] );
-												}
-											}
-											else if( Tokens[3] == "-=" )
-											{
-												if( m_VarPReals.find( VP ) != m_VarPReals.end( ) )
-													m_VarPReals[VP] -= UTIL_ToDouble( Tokens[4] );
-												else
-												{
-													// CONSOLE_Print( "[STATSW3MMD: " + m_Game->GetGameName( ) + "] real VarP [" + KeyString + "] found with relative operation [-=] without a previously assigned value, ignoring" );
-													m_VarPReals[VP] = -UTIL_ToDouble( Tokens[4] );
-												}
-											}
-											else
-												CONSOLE_Print( "[STATSW3MMD: " + m_Game->GetGameName( ) + "] unknown real VarP [" + KeyString + "] operation [" + Tokens[3] + "] found, ignoring" );
-										}
-										else
-										{
-											VarP VP = VarP( UTIL_ToUInt32( Tokens[1] ), Tokens[2] );
-
-											if( Tokens[3] == "=" )
-												m_VarPStrings[VP] = Tokens[4];
-											else
-												CONSOLE_Print( "[STATSW3MMD: " + m_Game->GetGameName( ) + "] unknown string VarP [" + KeyString + "] operation [" + Tokens[3] + "] found, ignoring" );
-										}
-									}
-								}
-								else if( Tokens[0] == "FlagP" && Tokens.size( ) == 3 )
-								{
-									// Tokens[1] = pid
-									// Tokens[2] = flag
+					if( m_DefEvents.find( Tokens[1] ) == m_DefEvents.end( ) )
+						CONSOLE_Print( "[STATSW3MMD: " + m_GameName + "] Event [" + KeyString + "] found without a corresponding DefEvent, ignoring" );
+					else
+					{
+						vector<string> DefEvent = m_DefEvents[Tokens[1]];
 
-									if( Tokens[2] == "winner" || Tokens[2] == "loser" || Tokens[2] == "drawer" || Tokens[2] == "leaver" || Tokens[2] == "practicing" )
-									{
-										uint32_t PID = UTIL_ToUInt32( Tokens[1] );
+						if( !DefEvent.empty( ) )
+						{
+							string Format = DefEvent[DefEvent.size( ) - 1];
 
-										if( Tokens[2] == "leaver" )
-											m_FlagsLeaver[PID] = true;
-										else if( Tokens[2] == "practicing" )
-											m_FlagsPracticing[PID] = true;
-										else
-										{
-											if( m_Flags.find( PID ) != m_Flags.end( ) )
-												CONSOLE_Print( "[STATSW3MMD: " + m_Game->GetGameName( ) + "] overwriting previous flag [" + m_Flags[PID] + "] with new flag [" + Tokens[2] + "] for PID [" + Tokens[1] + "]" );
+							if( Tokens.size( ) - 2 != DefEvent.size( ) - 1 )
+								CONSOLE_Print( "[STATSW3MMD: " + m_GameName + "] Event [" + KeyString + "] found with " + UTIL_ToString( Tokens.size( ) - 2 ) + " arguments but expected " + UTIL_ToString( DefEvent.size( ) - 1 ) + " arguments, ignoring" );
+							else
+							{
+								// replace the markers in the format string with the arguments
 
-											m_Flags[PID] = Tokens[2];
-										}
-									}
-									else
-										CONSOLE_Print( "[STATSW3MMD: " + m_Game->GetGameName( ) + "] unknown flag [" + Tokens[2] + "] found, ignoring" );
-								}
-								else if( Tokens[0] == "DefEvent" && Tokens.size( ) >= 4 )
+								for( uint32_t i = 0; i < Tokens.size( ) - 2; i++ )
 								{
-									// Tokens[1] = name
-									// Tokens[2] = # of arguments (n)
-									// Tokens[3..n+3] = arguments
-									// Tokens[n+3] = format
+									// check if the marker is a PID marker
 
-									if( m_DefEvents.find( Tokens[1] ) != m_DefEvents.end( ) )
-										CONSOLE_Print( "[STATSW3MMD: " + m_Game->GetGameName( ) + "] duplicate DefEvent [" + KeyString + "] found, ignoring" );
-									else
+									if( DefEvent[i].substr( 0, 4 ) == "pid:" )
 									{
-										uint32_t Arguments = UTIL_ToUInt32( Tokens[2] );
+										// replace it with the player's name rather than their PID
 
-										if( Tokens.size( ) == Arguments + 4 )
-											m_DefEvents[Tokens[1]] = vector<string>( Tokens.begin( ) + 3, Tokens.end( ) );
-									}
-								}
-								else if( Tokens[0] == "Event" && Tokens.size( ) >= 2 )
-								{
-									// Tokens[1] = name
-									// Tokens[2..n+2] = arguments (where n is the # of arguments in the corresponding DefEvent)
+										uint32_t PID = UTIL_ToUInt32( Tokens[i + 2] );
 
-									if( m_DefEvents.find( Tokens[1] ) == m_DefEvents.end( ) )
-										CONSOLE_Print( "[STATSW3MMD: " + m_Game->GetGameName( ) + "] Event [" + KeyString + "] found without a corresponding DefEvent, ignoring" );
-									else
-									{
-										vector<string> DefEvent = m_DefEvents[Tokens[1]];
-
-										if( !DefEvent.empty( ) )
-										{
-											string Format = DefEvent[DefEvent.size( ) - 1];
-
-											if( Tokens.size( ) - 2 != DefEvent.size( ) - 1 )
-												CONSOLE_Print( "[STATSW3MMD: " + m_Game->GetGameName( ) + "] Event [" + KeyString + "] found with " + UTIL_ToString( Tokens.size( ) - 2 ) + " arguments but expected " + UTIL_ToString( DefEvent.size( ) - 1 ) + " arguments, ignoring" );
-											else
-											{
-												// replace the markers in the format string with the arguments
-
-												for( uint32_t i = 0; i < Tokens.size( ) - 2; i++ )
-												{
-													// check if the marker is a PID marker
-
-													if( DefEvent[i].substr( 0, 4 ) == "pid:" )
-													{
-														// replace it with the player's name rather than their PID
-
-														uint32_t PID = UTIL_ToUInt32( Tokens[i + 2] );
-
-														if( m_PIDToName.find( PID ) == m_PIDToName.end( ) )
-															UTIL_Replace( Format, "{" + UTIL_ToString( i ) + "}", "PID:" + Tokens[i + 2] );
-														else
-															UTIL_Replace( Format, "{" + UTIL_ToString( i ) + "}", m_PIDToName[PID] );
-													}
-													else
-														UTIL_Replace( Format, "{" + UTIL_ToString( i ) + "}", Tokens[i + 2] );
-												}
-
-												CONSOLE_Print( "[STATSW3MMD: " + m_Game->GetGameName( ) + "] " + Format );
-											}
-										}
+										if( m_PIDToName.find( PID ) == m_PIDToName.end( ) )
+											UTIL_Replace( Format, "{" + UTIL_ToString( i ) + "}", "PID:" + Tokens[i + 2] );
+										else
+											UTIL_Replace( Format, "{" + UTIL_ToString( i ) + "}", m_PIDToName[PID] );
 									}
-
-									// CONSOLE_Print( "[STATSW3MMD: " + m_Game->GetGameName( ) + "] event [" + KeyString + "]" );
-								}
-								else if( Tokens[0] == "Blank" )
-								{
-									// ignore
-								}
-								else if( Tokens[0] == "Custom" )
-								{
-									CONSOLE_Print( "[STATSW3MMD: " + m_Game->GetGameName( ) + "] custom [" + KeyString + "]" );
+									else
+										UTIL_Replace( Format, "{" + UTIL_ToString( i ) + "}", Tokens[i + 2] );
 								}
-								else
-									CONSOLE_Print( "[STATSW3MMD: " + m_Game->GetGameName( ) + "] unknown message type [" + Tokens[0] + "] found, ignoring" );
-							}
-
-							m_NextValueID++;
-						}
-						else if( MissionKeyString.size( ) > 4 && MissionKeyString.substr( 0, 4 ) == "chk:" )
-						{
-							string CheckIDString = MissionKeyString.substr( 4 );
-							uint32_t CheckID = UTIL_ToUInt32( CheckIDString );
-
-							// todotodo: cheat detection
 
-							m_NextCheckID++;
+								LOG_Print( LOG_DEBUG, "[STATSW3MMD: " + m_GameName + "] " + Format );
+							}
 						}
-						else
-							CONSOLE_Print( "[STATSW3MMD: " + m_Game->GetGameName( ) + "] unknown mission key [" + MissionKeyString + "] found, ignoring" );
-
-						i += 15 + MissionKey.size( ) + Key.size( );
 					}
-					else
-						i++;
+
+					// CONSOLE_Print( "[STATSW3MMD: " + m_GameName + "] event [" + KeyString + "]" );
+				}
+				else if( Tokens[0] == "Blank" )
+				{
+					// ignore
+				}
+				else if( Tokens[0] == "Custom" )
+				{
+					CONSOLE_Print( "[STATSW3MMD: " + m_GameName + "] custom [" + KeyString + "]" );
 				}
 				else
-					i++;
+					CONSOLE_Print( "[STATSW3MMD: " + m_GameName + "] unknown message type [" + Tokens[0] + "] found, ignoring" );
 			}
-			else
-				i++;
+
+			m_NextValueID++;
+		}
+		else if( MissionKeyString.size( ) > 4 && MissionKeyString.substr( 0, 4 ) == "chk:" )
+		{
+			string CheckIDString = MissionKeyString.substr( 4 );
+			uint32_t CheckID = UTIL_ToUInt32( CheckIDString );
+
+			// todotodo: cheat detection
+
+			m_NextCheckID++;
 		}
 		else
-			i++;
+			CONSOLE_Print( "[STATSW3MMD: " + m_GameName + "] unknown mission key [" + MissionKeyString + "] found, ignoring" );
 	}
 
 	return false;
@@ -348,7 +313,7 @@ bool CStatsW3MMD :: ProcessAction( CIncomingAction *Action )
 
 void CStatsW3MMD :: Save( CGHost *GHost, CGHostDB *DB, uint32_t GameID )
 {
-	CONSOLE_Print( "[STATSW3MMD: " + m_Game->GetGameName( ) + "] received " + UTIL_ToString( m_NextValueID ) + "/" + UTIL_ToString( m_NextCheckID ) + " value/check messages" );
+	CONSOLE_Print( "[STATSW3MMD: " + m_GameName + "] received " + UTIL_ToString( m_NextValueID ) + "/" + UTIL_ToString( m_NextCheckID ) + " value/check messages" );
 
 	if( DB->Begin( ) )
 	{
@@ -381,7 +346,7 @@ void CStatsW3MMD :: Save( CGHost *GHost, CGHostDB *DB, uint32_t GameID )
 				Flags += "practicing";
 			}
 
-			CONSOLE_Print( "[STATSW3MMD: " + m_Game->GetGameName( ) + "] recorded flags [" + Flags + "] for player [" + i->second + "] with PID [" + UTIL_ToString( i->first ) + "]" );
+			CONSOLE_Print( "[STATSW3MMD: " + m_GameName + "] recorded flags [" + Flags + "] for player [" + i->second + "] with PID [" + UTIL_ToString( i->first ) + "]" );
 			GHost->m_Callables.push_back( DB->ThreadedW3MMDPlayerAdd( m_Category, GameID, i->first, i->second, m_Flags[i->first], Leaver, Practicing ) );
 		}
 
@@ -395,12 +360,12 @@ void CStatsW3MMD :: Save( CGHost *GHost, CGHostDB *DB, uint32_t GameID )
 			GHost->m_Callables.push_back( DB->ThreadedW3MMDVarAdd( GameID, m_VarPStrings ) );
 
 		if( DB->Commit( ) )
-			CONSOLE_Print( "[STATSW3MMD: " + m_Game->GetGameName( ) + "] saving data" );
+			CONSOLE_Print( "[STATSW3MMD: " + m_GameName + "] saving data" );
 		else
-			CONSOLE_Print( "[STATSW3MMD: " + m_Game->GetGameName( ) + "] unable to commit database transaction, data not saved" );
+			CONSOLE_Print( "[STATSW3MMD: " + m_GameName + "] unable to commit database transaction, data not saved" );
 	}
 	else
-		CONSOLE_Print( "[STATSW3MMD: " + m_Game->GetGameName( ) + "] unable to begin database transaction, data not saved" );
+		CONSOLE_Print( "[STATSW3MMD: " + m_GameName + "] unable to begin database transaction, data not saved" );
 }
 
 vector<string> CStatsW3MMD :: TokenizeKey( string key )
@@ -419,7 +384,7 @@ vector<string> CStatsW3MMD :: TokenizeKey( string key )
 				Token += '\\';
 			else
 			{
-				CONSOLE_Print( "[STATSW3MMD: " + m_Game->GetGameName( ) + "] error tokenizing key [" + key + "], invalid escape sequence found, ignoring" );
+				CONSOLE_Print( "[STATSW3MMD: " + m_GameName + "] error tokenizing key [" + key + "], invalid escape sequence found, ignoring" );
 				return vector<string>( );
 			}
 
@@ -431,7 +396,7 @@ vector<string> CStatsW3MMD :: TokenizeKey( string key )
 			{
 				if( Token.empty( ) )
 				{
-					CONSOLE_Print( "[STATSW3MMD: " + m_Game->GetGameName( ) + "] error tokenizing key [" + key + "], empty token found, ignoring" );
+					CONSOLE_Print( "[STATSW3MMD: " + m_GameName + "] error tokenizing key [" + key + "], empty token found, ignoring" );
 					return vector<string>( );
 				}
 
@@ -447,7 +412,7 @@ vector<string> CStatsW3MMD :: TokenizeKey( string key )
 
 	if( Token.empty( ) )
 	{
-		CONSOLE_Print( "[STATSW3MMD: " + m_Game->GetGameName( ) + "] error tokenizing key [" + key + "], empty token found, ignoring" );
+		CONSOLE_Print( "[STATSW3MMD: " + m_GameName + "] error tokenizing key [" + key + "], empty token found, ignoring" );
 		return vector<string>( );
 	}
 
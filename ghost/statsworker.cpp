@@ -0,0 +1,183 @@
+/*
+
+   Copyright [2008] [Trevor Hogan]
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+   CODE PORTED FROM THE ORIGINAL GHOST PROJECT: http://ghost.pwner.org/
+
+*/
+
+#include "ghost.h"
+#include "util.h"
+#include "gameprotocol.h"
+#include "stats.h"
+#include "statsworker.h"
+
+//
+// CStatsQueue
+//
+
+CStatsQueue :: CStatsQueue( CStats *nStats, uint32_t nSize )
+{
+	m_Stats = nStats;
+
+	// round the queue size up to a power of two so we can use a mask instead of a modulo
+
+	uint32_t RingSize = 64;
+
+	while( RingSize < nSize && RingSize < 65536 )
+		RingSize <<= 1;
+
+	m_Ring = new CStatsQueueEntry[RingSize];
+	m_RingMask = RingSize - 1;
+	m_Head.store( 0 );
+	m_Tail.store( 0 );
+	m_GameOver.store( false );
+}
+
+CStatsQueue :: ~CStatsQueue( )
+{
+	delete [] m_Ring;
+}
+
+void CStatsQueue :: Push( CIncomingAction *action )
+{
+	// actions must reach the stats class in order so once anything has overflowed everything else has to wait behind it
+
+	Flush( );
+
+	if( !m_Overflow.empty( ) || !TryPush( action->GetPID( ), *action->GetAction( ) ) )
+	{
+		m_Overflow.push( CStatsQueueEntry( ) );
+		m_Overflow.back( ).m_PID = action->GetPID( );
+		m_Overflow.back( ).m_Action = *action->GetAction( );
+	}
+}
+
+void CStatsQueue :: Flush( )
+{
+	while( !m_Overflow.empty( ) && TryPush( m_Overflow.front( ).m_PID, m_Overflow.front( ).m_Action ) )
+		m_Overflow.pop( );
+}
+
+bool CStatsQueue :: TryPush( unsigned char PID, BYTEARRAY &action )
+{
+	uint32_t Head = m_Head.load( boost :: memory_order_relaxed );
+
+	if( Head - m_Tail.load( boost :: memory_order_acquire ) > m_RingMask )
+		return false;
+
+	CStatsQueueEntry *Entry = &m_Ring[Head & m_RingMask];
+	Entry->m_PID = PID;
+	Entry->m_Action.assign( action.begin( ), action.end( ) );
+	m_Head.store( Head + 1, boost :: memory_order_release );
+	return true;
+}
+
+uint32_t CStatsQueue :: Process( uint32_t max )
+{
+	uint32_t Tail = m_Tail.load( boost :: memory_order_relaxed );
+	uint32_t Head = m_Head.load( boost :: memory_order_acquire );
+	uint32_t Processed = 0;
+	BYTEARRAY CRC;
+
+	while( Tail != Head && Processed < max )
+	{
+		CStatsQueueEntry *Entry = &m_Ring[Tail & m_RingMask];
+		CIncomingAction Action( Entry->m_PID, CRC, Entry->m_Action );
+
+		if( m_Stats->ProcessAction( &Action ) )
+			m_GameOver.store( true, boost :: memory_order_release );
+
+		Tail++;
+		Processed++;
+		m_Tail.store( Tail, boost :: memory_order_release );
+	}
+
+	return Processed;
+}
+
+void CStatsQueue :: Drain( )
+{
+	// process everything that's still queued, this is only safe once the worker thread has let go of the queue (the game is now both the producer and the consumer)
+
+	uint32_t Processed;
+
+	do
+	{
+		Flush( );
+		Processed = Process( m_RingMask + 1 );
+	} while( Processed > 0 || !m_Overflow.empty( ) );
+}
+
+//
+// CStatsWorker
+//
+
+CStatsWorker :: CStatsWorker( )
+{
+	m_Exiting.store( false );
+	m_Thread = new boost :: thread( boost :: ref( *this ) );
+}
+
+CStatsWorker :: ~CStatsWorker( )
+{
+	// every game removes its queue before it's deleted so there's nothing left to process here
+
+	m_Exiting.store( true );
+	m_Thread->join( );
+	delete m_Thread;
+}
+
+void CStatsWorker :: Add( CStatsQueue *queue )
+{
+	boost :: mutex :: scoped_lock Lock( m_Mutex );
+	m_Queues.push_back( queue );
+}
+
+void CStatsWorker :: Remove( CStatsQueue *queue )
+{
+	// once this returns the worker thread won't touch the queue (or its stats class) again
+	// the caller should drain the queue itself before using the stats class
+
+	boost :: mutex :: scoped_lock Lock( m_Mutex );
+
+	for( vector<CStatsQueue *> :: iterator i = m_Queues.begin( ); i != m_Queues.end( ); )
+	{
+		if( *i == queue )
+			i = m_Queues.erase( i );
+		else
+			i++;
+	}
+}
+
+void CStatsWorker :: operator( )( )
+{
+	while( !m_Exiting.load( ) )
+	{
+		uint32_t Processed = 0;
+
+		{
+			// process a limited number of actions per game at a time so a busy game can't starve the others
+
+			boost :: mutex :: scoped_lock Lock( m_Mutex );
+
+			for( vector<CStatsQueue *> :: iterator i = m_Queues.begin( ); i != m_Queues.end( ); i++ )
+				Processed += (*i)->Process( 256 );
+		}
+
+		if( Processed == 0 )
+			MILLISLEEP( 10 );
+	}
+}
@@ -0,0 +1,101 @@
+/*
+
+   Copyright [2008] [Trevor Hogan]
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+   CODE PORTED FROM THE ORIGINAL GHOST PROJECT: http://ghost.pwner.org/
+
+*/
+
+#ifndef STATSWORKER_H
+#define STATSWORKER_H
+
+#include <boost/atomic.hpp>
+#include <boost/thread.hpp>
+
+//
+// CStatsQueue
+//
+
+// the stats worker moves CStats :: ProcessAction off the main thread so parsing the stats never delays relaying the actions
+// each game pushes a copy of every action into its own bounded single producer single consumer ring and the worker thread processes the rings of every game in order
+// when the stats class reports the game is over the worker sets a flag which the game checks in its Update function
+// note: the stats class must not touch the game (players, slots, etc...) in ProcessAction because it runs on the worker thread
+
+class CStats;
+class CIncomingAction;
+
+class CStatsQueueEntry
+{
+public:
+	unsigned char m_PID;
+	BYTEARRAY m_Action;
+};
+
+class CStatsQueue
+{
+private:
+	CStats *m_Stats;
+	CStatsQueueEntry *m_Ring;				// the ring of queued actions, the entries keep their capacity so copying an action doesn't allocate
+	uint32_t m_RingMask;					// the size of the ring minus one (the size is always a power of two)
+	boost :: atomic<uint32_t> m_Head;		// the next ring position to be written by the producer
+	boost :: atomic<uint32_t> m_Tail;		// the next ring position to be read by the consumer
+	queue<CStatsQueueEntry> m_Overflow;		// actions which didn't fit in the ring, moved into the ring in order as soon as there's space (producer only)
+	boost :: atomic<bool> m_GameOver;		// set by the consumer when the stats class reported the game is over
+
+public:
+	CStatsQueue( CStats *nStats, uint32_t nSize );
+	~CStatsQueue( );
+
+	bool GetGameOver( )						{ return m_GameOver.load( boost :: memory_order_acquire ); }
+
+	// producer functions, called by the game
+
+	void Push( CIncomingAction *action );
+	void Flush( );
+
+	// consumer functions, called by the worker thread (or by the game after removing the queue from the worker)
+
+	uint32_t Process( uint32_t max );
+	void Drain( );
+
+private:
+	bool TryPush( unsigned char PID, BYTEARRAY &action );
+};
+
+//
+// CStatsWorker
+//
+
+class CStatsWorker
+{
+private:
+	boost :: mutex m_Mutex;					// protects m_Queues, it's held while the worker is processing so removing a queue waits for the worker to let go of it
+	vector<CStatsQueue *> m_Queues;
+	boost :: atomic<bool> m_Exiting;		// set to true to make the worker thread exit
+	boost :: thread *m_Thread;
+
+public:
+	CStatsWorker( );
+	~CStatsWorker( );
+
+	void Add( CStatsQueue *queue );
+	void Remove( CStatsQueue *queue );
+
+	// worker thread
+
+	void operator( )( );
+};
+
+#endif
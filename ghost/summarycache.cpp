@@ -0,0 +1,227 @@
+/*
+
+   Copyright [2008] [Trevor Hogan]
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+   CODE PORTED FROM THE ORIGINAL GHOST PROJECT: http://ghost.pwner.org/
+
+*/
+
+#include "ghost.h"
+#include "util.h"
+#include "ghostdb.h"
+#include "summarycache.h"
+
+//
+// CSummaryCache
+//
+
+CSummaryCache :: CSummaryCache( CGHost *nGHost, uint32_t nTTL )
+{
+	m_GHost = nGHost;
+	m_TTL = nTTL;
+}
+
+CSummaryCache :: ~CSummaryCache( )
+{
+	for( map<string, CCallableGamePlayerSummaryCheck *> :: iterator i = m_GamePlayerSummaryChecks.begin( ); i != m_GamePlayerSummaryChecks.end( ); i++ )
+		m_GHost->m_Callables.push_back( i->second );
+
+	for( map<string, CCallableDotAPlayerSummaryCheck *> :: iterator i = m_DotAPlayerSummaryChecks.begin( ); i != m_DotAPlayerSummaryChecks.end( ); i++ )
+		m_GHost->m_Callables.push_back( i->second );
+
+	for( vector<PairedSummaryWrite> :: iterator i = m_Writes.begin( ); i != m_Writes.end( ); i++ )
+		m_GHost->m_Callables.push_back( i->second );
+
+	for( map<string, CCachedGamePlayerSummary> :: iterator i = m_GamePlayerSummaries.begin( ); i != m_GamePlayerSummaries.end( ); i++ )
+		delete i->second.m_Summary;
+
+	for( map<string, CCachedDotAPlayerSummary> :: iterator i = m_DotAPlayerSummaries.begin( ); i != m_DotAPlayerSummaries.end( ); i++ )
+		delete i->second.m_Summary;
+}
+
+void CSummaryCache :: Update( )
+{
+	uint32_t Time = GetTime( );
+
+	// throw away the expired summaries first so every requester gets at least one chance to see a summary which just arrived
+
+	for( map<string, CCachedGamePlayerSummary> :: iterator i = m_GamePlayerSummaries.begin( ); i != m_GamePlayerSummaries.end( ); )
+	{
+		if( Time > i->second.m_Expires )
+		{
+			delete i->second.m_Summary;
+			m_GamePlayerSummaries.erase( i++ );
+		}
+		else
+			i++;
+	}
+
+	for( map<string, CCachedDotAPlayerSummary> :: iterator i = m_DotAPlayerSummaries.begin( ); i != m_DotAPlayerSummaries.end( ); )
+	{
+		if( Time > i->second.m_Expires )
+		{
+			delete i->second.m_Summary;
+			m_DotAPlayerSummaries.erase( i++ );
+		}
+		else
+			i++;
+	}
+
+	// the summaries of players whose rows have just been written are out of date now
+	// this has to happen before the queries are checked below so a query which was started before the write finished is marked as stale
+
+	for( vector<PairedSummaryWrite> :: iterator i = m_Writes.begin( ); i != m_Writes.end( ); )
+	{
+		if( i->second->GetReady( ) )
+		{
+			Invalidate( i->first );
+			m_GHost->m_DB->RecoverCallable( i->second );
+			delete i->second;
+			i = m_Writes.erase( i );
+		}
+		else
+			i++;
+	}
+
+	// take the summaries out of the finished callables so they outlive them
+	// if the query failed or the player's summary was invalidated while it was running it's only kept long enough for the waiting requesters to see it
+
+	for( map<string, CCallableGamePlayerSummaryCheck *> :: iterator i = m_GamePlayerSummaryChecks.begin( ); i != m_GamePlayerSummaryChecks.end( ); )
+	{
+		if( i->second->GetReady( ) )
+		{
+			CCachedGamePlayerSummary &Cached = m_GamePlayerSummaries[i->first];
+			delete Cached.m_Summary;
+			Cached.m_Summary = i->second->GetResult( );
+			Cached.m_Expires = Time + ( i->second->GetError( ).empty( ) && m_StaleNames.find( i->first ) == m_StaleNames.end( ) ? m_TTL : 1 );
+			i->second->SetResult( NULL );
+			m_GHost->m_DB->RecoverCallable( i->second );
+			delete i->second;
+			m_GamePlayerSummaryChecks.erase( i++ );
+		}
+		else
+			i++;
+	}
+
+	for( map<string, CCallableDotAPlayerSummaryCheck *> :: iterator i = m_DotAPlayerSummaryChecks.begin( ); i != m_DotAPlayerSummaryChecks.end( ); )
+	{
+		if( i->second->GetReady( ) )
+		{
+			CCachedDotAPlayerSummary &Cached = m_DotAPlayerSummaries[i->first];
+			delete Cached.m_Summary;
+			Cached.m_Summary = i->second->GetResult( );
+			Cached.m_Expires = Time + ( i->second->GetError( ).empty( ) && m_StaleNames.find( i->first ) == m_StaleNames.end( ) ? m_TTL : 1 );
+			i->second->SetResult( NULL );
+			m_GHost->m_DB->RecoverCallable( i->second );
+			delete i->second;
+			m_DotAPlayerSummaryChecks.erase( i++ );
+		}
+		else
+			i++;
+	}
+
+	for( set<string> :: iterator i = m_StaleNames.begin( ); i != m_StaleNames.end( ); )
+	{
+		if( m_GamePlayerSummaryChecks.find( *i ) == m_GamePlayerSummaryChecks.end( ) && m_DotAPlayerSummaryChecks.find( *i ) == m_DotAPlayerSummaryChecks.end( ) )
+			m_StaleNames.erase( i++ );
+		else
+			i++;
+	}
+}
+
+void CSummaryCache :: AddWrite( string name, CBaseCallable *callable )
+{
+	if( callable )
+		m_Writes.push_back( PairedSummaryWrite( name, callable ) );
+}
+
+void CSummaryCache :: Invalidate( string name )
+{
+	transform( name.begin( ), name.end( ), name.begin( ), (int(*)(int))tolower );
+	map<string, CCachedGamePlayerSummary> :: iterator i = m_GamePlayerSummaries.find( name );
+
+	if( i != m_GamePlayerSummaries.end( ) )
+	{
+		delete i->second.m_Summary;
+		m_GamePlayerSummaries.erase( i );
+	}
+
+	map<string, CCachedDotAPlayerSummary> :: iterator j = m_DotAPlayerSummaries.find( name );
+
+	if( j != m_DotAPlayerSummaries.end( ) )
+	{
+		delete j->second.m_Summary;
+		m_DotAPlayerSummaries.erase( j );
+	}
+
+	if( m_GamePlayerSummaryChecks.find( name ) != m_GamePlayerSummaryChecks.end( ) || m_DotAPlayerSummaryChecks.find( name ) != m_DotAPlayerSummaryChecks.end( ) )
+		m_StaleNames.insert( name );
+}
+
+uint32_t CSummaryCache :: GetGamePlayerSummary( string name, CDBGamePlayerSummary **summary )
+{
+	string LowerName = name;
+	transform( LowerName.begin( ), LowerName.end( ), LowerName.begin( ), (int(*)(int))tolower );
+	map<string, CCachedGamePlayerSummary> :: iterator i = m_GamePlayerSummaries.find( LowerName );
+
+	if( i != m_GamePlayerSummaries.end( ) )
+	{
+		*summary = i->second.m_Summary;
+		return SUMMARY_READY;
+	}
+
+	if( m_GamePlayerSummaryChecks.find( LowerName ) == m_GamePlayerSummaryChecks.end( ) )
+	{
+		CCallableGamePlayerSummaryCheck *Callable = m_GHost->m_DB->ThreadedGamePlayerSummaryCheck( name );
+
+		if( !Callable )
+		{
+			*summary = NULL;
+			return SUMMARY_READY;
+		}
+
+		m_GamePlayerSummaryChecks[LowerName] = Callable;
+	}
+
+	return SUMMARY_PENDING;
+}
+
+uint32_t CSummaryCache :: GetDotAPlayerSummary( string name, CDBDotAPlayerSummary **summary )
+{
+	string LowerName = name;
+	transform( LowerName.begin( ), LowerName.end( ), LowerName.begin( ), (int(*)(int))tolower );
+	map<string, CCachedDotAPlayerSummary> :: iterator i = m_DotAPlayerSummaries.find( LowerName );
+
+	if( i != m_DotAPlayerSummaries.end( ) )
+	{
+		*summary = i->second.m_Summary;
+		return SUMMARY_READY;
+	}
+
+	if( m_DotAPlayerSummaryChecks.find( LowerName ) == m_DotAPlayerSummaryChecks.end( ) )
+	{
+		CCallableDotAPlayerSummaryCheck *Callable = m_GHost->m_DB->ThreadedDotAPlayerSummaryCheck( name );
+
+		if( !Callable )
+		{
+			*summary = NULL;
+			return SUMMARY_READY;
+		}
+
+		m_DotAPlayerSummaryChecks[LowerName] = Callable;
+	}
+
+	return SUMMARY_PENDING;
+}
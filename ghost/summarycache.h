@@ -0,0 +1,99 @@
+/*
+
+   Copyright [2008] [Trevor Hogan]
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+   CODE PORTED FROM THE ORIGINAL GHOST PROJECT: http://ghost.pwner.org/
+
+*/
+
+#ifndef SUMMARYCACHE_H
+#define SUMMARYCACHE_H
+
+//
+// CSummaryCache
+//
+
+// the !stats and !statsdota commands run a heavy aggregate query over every game the player has played
+// the summary cache shares these queries between every game and battle.net connection:
+//  - if a summary is requested while a query for the same name is already running the requester waits for that query instead of starting another
+//  - the summaries are kept for a short time (bot_statscachettl) so repeated requests don't need a query at all
+//  - the summaries of every player in a game are thrown away once the rows saved for them at the end of that game have been written
+//    the cache owns the callables writing those rows (AddWrite) so it knows when they've finished
+// the requesters poll for the summary in their Update function until it's ready
+// note: this is only used from the main thread
+
+#define SUMMARY_PENDING		0			// the summary is being looked up, keep polling
+#define SUMMARY_READY		1			// the summary is ready (it's NULL if the player hasn't played any games)
+
+class CBaseCallable;
+class CCallableGamePlayerSummaryCheck;
+class CCallableDotAPlayerSummaryCheck;
+class CDBGamePlayerSummary;
+class CDBDotAPlayerSummary;
+
+typedef pair<string,CBaseCallable *> PairedSummaryWrite;
+
+class CCachedGamePlayerSummary
+{
+public:
+	CDBGamePlayerSummary *m_Summary;	// NULL if the player hasn't played any games
+	uint32_t m_Expires;					// GetTime when the summary is thrown away
+
+	CCachedGamePlayerSummary( ) : m_Summary( NULL ), m_Expires( 0 ) { }
+};
+
+class CCachedDotAPlayerSummary
+{
+public:
+	CDBDotAPlayerSummary *m_Summary;	// NULL if the player hasn't played any DotA games
+	uint32_t m_Expires;					// GetTime when the summary is thrown away
+
+	CCachedDotAPlayerSummary( ) : m_Summary( NULL ), m_Expires( 0 ) { }
+};
+
+class CSummaryCache
+{
+private:
+	CGHost *m_GHost;
+	uint32_t m_TTL;																// how long to keep the summaries (in seconds)
+	map<string, CCallableGamePlayerSummaryCheck *> m_GamePlayerSummaryChecks;	// lowercase name -> query in progress
+	map<string, CCallableDotAPlayerSummaryCheck *> m_DotAPlayerSummaryChecks;	// lowercase name -> query in progress
+	map<string, CCachedGamePlayerSummary> m_GamePlayerSummaries;				// lowercase name -> summary
+	map<string, CCachedDotAPlayerSummary> m_DotAPlayerSummaries;				// lowercase name -> summary
+	set<string> m_StaleNames;													// lowercase names invalidated while a query was in progress, their summaries aren't kept once it finishes
+	vector<PairedSummaryWrite> m_Writes;										// name -> callable writing rows the player's summaries are computed from
+
+public:
+	CSummaryCache( CGHost *nGHost, uint32_t nTTL );
+	~CSummaryCache( );
+
+	uint32_t GetNumWrites( )	{ return m_Writes.size( ); }
+
+	void Update( );
+
+	// takes ownership of a callable saving a gameplayers/dotaplayers row of this player, their summaries are thrown away when it finishes
+
+	void AddWrite( string name, CBaseCallable *callable );
+
+	// these start a query if the summary isn't cached or already being looked up
+
+	uint32_t GetGamePlayerSummary( string name, CDBGamePlayerSummary **summary );
+	uint32_t GetDotAPlayerSummary( string name, CDBDotAPlayerSummary **summary );
+
+private:
+	void Invalidate( string name );
+};
+
+#endif
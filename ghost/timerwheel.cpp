@@ -0,0 +1,213 @@
+/*
+
+   Copyright [2008] [Trevor Hogan]
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+   CODE PORTED FROM THE ORIGINAL GHOST PROJECT: http://ghost.pwner.org/
+
+*/
+
+#include "ghost.h"
+#include "timerwheel.h"
+
+//
+// CTimer
+//
+
+void CTimer :: Cancel( )
+{
+	if( m_Next )
+	{
+		m_Prev->m_Next = m_Next;
+		m_Next->m_Prev = m_Prev;
+		m_Prev = NULL;
+		m_Next = NULL;
+	}
+
+	m_Due = false;
+}
+
+//
+// CTimerWheel
+//
+
+CTimerWheel :: CTimerWheel( uint32_t ticks )
+{
+	for( uint32_t i = 0; i < TIMERWHEEL_LEVELS; i++ )
+	{
+		for( uint32_t j = 0; j < TIMERWHEEL_SLOTS; j++ )
+		{
+			m_Slots[i][j].m_Prev = &m_Slots[i][j];
+			m_Slots[i][j].m_Next = &m_Slots[i][j];
+		}
+	}
+
+	m_Ticks = ticks;
+	m_Next = ticks + 1;
+}
+
+CTimerWheel :: ~CTimerWheel( )
+{
+	// the timers might outlive the wheel so take them all out of the slots
+
+	for( uint32_t i = 0; i < TIMERWHEEL_LEVELS; i++ )
+	{
+		for( uint32_t j = 0; j < TIMERWHEEL_SLOTS; j++ )
+		{
+			CTimer *Head = &m_Slots[i][j];
+
+			while( Head->m_Next != Head )
+				Head->m_Next->Cancel( );
+
+			Head->m_Prev = NULL;
+			Head->m_Next = NULL;
+		}
+	}
+}
+
+void CTimerWheel :: Schedule( CTimer *timer, uint32_t deadline )
+{
+	timer->Cancel( );
+	timer->m_Deadline = deadline;
+
+	if( (int32_t)( deadline - m_Next ) < 0 )
+		timer->m_Due = true;
+	else
+		Insert( timer );
+}
+
+void CTimerWheel :: Advance( uint32_t ticks )
+{
+	while( (int32_t)( ticks - m_Next ) >= 0 )
+	{
+		// every 64 ticks the next slot of the level above is moved down to the finer levels, every 64 * 64 ticks the next slot of the level above that, etc...
+
+		for( uint32_t Level = 1; Level < TIMERWHEEL_LEVELS && !( m_Next & ( ( 1u << ( Level * TIMERWHEEL_BITS ) ) - 1 ) ); Level++ )
+			Cascade( Level, ( m_Next >> ( Level * TIMERWHEEL_BITS ) ) & TIMERWHEEL_MASK );
+
+		// every timer in this slot is due on this tick
+
+		CTimer *Head = &m_Slots[0][m_Next & TIMERWHEEL_MASK];
+
+		while( Head->m_Next != Head )
+		{
+			CTimer *Timer = Head->m_Next;
+			Timer->Cancel( );
+			Timer->m_Due = true;
+		}
+
+		m_Next++;
+
+		// skip ahead to the next tick which has something to do (a cascade or a timer)
+
+		while( (int32_t)( ticks - m_Next ) >= 0 && ( m_Next & TIMERWHEEL_MASK ) && m_Slots[0][m_Next & TIMERWHEEL_MASK].m_Next == &m_Slots[0][m_Next & TIMERWHEEL_MASK] )
+			m_Next++;
+	}
+
+	if( (int32_t)( ticks - m_Ticks ) > 0 )
+		m_Ticks = ticks;
+}
+
+bool CTimerWheel :: GetTicksUntilNext( uint32_t *ticks )
+{
+	bool Found = false;
+	uint32_t Next = 0;
+
+	for( uint32_t Level = 0; Level < TIMERWHEEL_LEVELS; Level++ )
+	{
+		// the timers in a slot of a finer level can't be due before the next cascade of a coarser level so we only need the first non empty slot of each level
+		// on level 0 that's when the timers are due, on the other levels it's when they're moved to a finer level
+
+		uint32_t Shift = Level * TIMERWHEEL_BITS;
+
+		for( uint32_t i = 0; i <= TIMERWHEEL_SLOTS; i++ )
+		{
+			uint32_t Block = ( m_Next >> Shift ) + i;
+			uint32_t Ticks = Block << Shift;
+
+			if( (int32_t)( Ticks - m_Next ) < 0 )
+				continue;
+
+			CTimer *Head = &m_Slots[Level][Block & TIMERWHEEL_MASK];
+
+			if( Head->m_Next != Head )
+			{
+				if( !Found || (int32_t)( Ticks - Next ) < 0 )
+					Next = Ticks;
+
+				Found = true;
+				break;
+			}
+		}
+	}
+
+	if( Found )
+		*ticks = Next - m_Ticks;
+
+	return Found;
+}
+
+void CTimerWheel :: Insert( CTimer *timer )
+{
+	// the level is chosen by how far away the deadline is, the slot by the deadline itself
+	// a timer too far away for the coarsest level goes into the slot of that level which is cascaded last and is inserted again from there
+
+	uint32_t Delta = timer->m_Deadline - m_Next;
+	uint32_t Level = 0;
+
+	while( Level < TIMERWHEEL_LEVELS - 1 && Delta >= ( 1u << ( ( Level + 1 ) * TIMERWHEEL_BITS ) ) )
+		Level++;
+
+	uint32_t Slot;
+
+	if( Delta >= ( 1u << ( TIMERWHEEL_LEVELS * TIMERWHEEL_BITS ) ) )
+		Slot = ( ( m_Next >> ( Level * TIMERWHEEL_BITS ) ) - 1 ) & TIMERWHEEL_MASK;
+	else
+		Slot = ( timer->m_Deadline >> ( Level * TIMERWHEEL_BITS ) ) & TIMERWHEEL_MASK;
+
+	CTimer *Head = &m_Slots[Level][Slot];
+	timer->m_Prev = Head->m_Prev;
+	timer->m_Next = Head;
+	Head->m_Prev->m_Next = timer;
+	Head->m_Prev = timer;
+}
+
+void CTimerWheel :: Cascade( uint32_t level, uint32_t slot )
+{
+	CTimer *Head = &m_Slots[level][slot];
+
+	if( Head->m_Next == Head )
+		return;
+
+	// take the whole list out of the slot first, a timer which is still too far away could be inserted into a slot of this level again
+
+	CTimer *Timer = Head->m_Next;
+	Head->m_Prev->m_Next = NULL;
+	Head->m_Prev = Head;
+	Head->m_Next = Head;
+
+	while( Timer )
+	{
+		CTimer *Next = Timer->m_Next;
+		Timer->m_Prev = NULL;
+		Timer->m_Next = NULL;
+
+		if( (int32_t)( Timer->m_Deadline - m_Next ) < 0 )
+			Timer->m_Due = true;
+		else
+			Insert( Timer );
+
+		Timer = Next;
+	}
+}
@@ -0,0 +1,99 @@
+/*
+
+   Copyright [2008] [Trevor Hogan]
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+   CODE PORTED FROM THE ORIGINAL GHOST PROJECT: http://ghost.pwner.org/
+
+*/
+
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+//
+// CTimerWheel
+//
+
+// a hierarchical timer wheel (like the one in older Linux kernels) for the periodic tasks of the games (pings, refreshes, map parts, etc...)
+// the wheel is advanced once per loop with the cached loop clock (see CGHost :: Update) and marks every timer whose deadline has passed as due
+// a due timer stays due until it's scheduled again or cancelled, the owner checks it whenever it likes (e.g. only while the game is in the lobby)
+// this keeps the old "if enough time has passed and ..." behaviour when a task can't run yet, it simply runs as soon as it can
+// scheduling, cancelling and expiring a timer is O(1) and the wheel knows when the next timer is due so the main loop can block until then
+// note: this is only used from the main thread
+
+#define TIMERWHEEL_BITS		6
+#define TIMERWHEEL_SLOTS	( 1 << TIMERWHEEL_BITS )
+#define TIMERWHEEL_MASK		( TIMERWHEEL_SLOTS - 1 )
+#define TIMERWHEEL_LEVELS	4		// 1ms slots, 64ms slots, 4s slots and 262s slots, anything later is cascaded again until it fits
+
+class CTimer
+{
+public:
+	CTimer *m_Prev;						// the previous timer in the slot's list (NULL if not scheduled)
+	CTimer *m_Next;						// the next timer in the slot's list (NULL if not scheduled)
+	uint32_t m_Deadline;				// the GetTicks when the timer is due
+	bool m_Due;							// if the deadline has passed
+
+	CTimer( ) : m_Prev( NULL ), m_Next( NULL ), m_Deadline( 0 ), m_Due( false ) { }
+	~CTimer( )							{ Cancel( ); }
+
+	bool GetScheduled( )				{ return m_Next != NULL; }
+	bool GetDue( )						{ return m_Due; }
+	uint32_t GetDeadline( )				{ return m_Deadline; }
+
+	void Cancel( );
+
+private:
+	CTimer( const CTimer & );
+	CTimer &operator=( const CTimer & );
+};
+
+class CTimerWheel
+{
+private:
+	CTimer m_Slots[TIMERWHEEL_LEVELS][TIMERWHEEL_SLOTS];	// each slot is the head of a circular list of timers
+	uint32_t m_Ticks;									// the GetTicks the wheel has been advanced to (the cached loop clock)
+	uint32_t m_Next;									// the next tick to be processed (m_Ticks + 1)
+
+public:
+	CTimerWheel( uint32_t ticks );
+	~CTimerWheel( );
+
+	uint32_t GetTicks( )								{ return m_Ticks; }
+
+	// schedule the timer to become due at the given GetTicks (rescheduling it if it was already scheduled)
+	// the timer is due immediately if the deadline is not after the time the wheel was last advanced to
+
+	void Schedule( CTimer *timer, uint32_t deadline );
+
+	// schedule the timer to become due the given number of milliseconds after the time the wheel was last advanced to
+
+	void ScheduleIn( CTimer *timer, uint32_t ticks )	{ Schedule( timer, m_Ticks + ticks ); }
+
+	// mark every timer due whose deadline is at or before ticks
+
+	void Advance( uint32_t ticks );
+
+	// the number of milliseconds after the time the wheel was last advanced to when the next timer might become due
+	// this is never later than the earliest deadline but it can be earlier (when the next slot of a coarser level is moved to the finer levels)
+	// returns false if no timers are scheduled
+
+	bool GetTicksUntilNext( uint32_t *ticks );
+
+private:
+	void Insert( CTimer *timer );
+	void Cascade( uint32_t level, uint32_t slot );
+};
+
+#endif
@@ -22,6 +22,28 @@
 #include "util.h"
 
 #include <sys/stat.h>
+#include <string.h>
+
+// the signature search uses SSE2 (always available on x64) or AVX2 (selected at runtime) on x86 and x64
+
+#if defined( __x86_64__ ) || defined( _M_X64 ) || ( defined( __i386__ ) && defined( __SSE2__ ) )
+ #define UTIL_SIMD
+
+ #include <emmintrin.h>
+ #include <immintrin.h>
+
+ #ifdef WIN32
+  #include <intrin.h>
+ #else
+  #include <cpuid.h>
+ #endif
+
+ #ifdef __GNUC__
+  #define UTIL_AVX2_TARGET __attribute__(( target( "avx2" ) ))
+ #else
+  #define UTIL_AVX2_TARGET
+ #endif
+#endif
 
 BYTEARRAY UTIL_CreateByteArray( unsigned char *a, int size )
 {
@@ -95,10 +117,15 @@ string UTIL_ByteArrayToDecString( BYTEARRAY b )
 	if( b.empty( ) )
 		return string( );
 
-	string result = UTIL_ToString( b[0] );
+	string result;
+	result.reserve( b.size( ) * 4 );
+	UTIL_AppendUInt( result, b[0] );
 
 	for( BYTEARRAY :: iterator i = b.begin( ) + 1; i != b.end( ); i++ )
-		result += " " + UTIL_ToString( *i );
+	{
+		result.push_back( ' ' );
+		UTIL_AppendUInt( result, *i );
+	}
 
 	return result;
 }
@@ -108,14 +135,14 @@ string UTIL_ByteArrayToHexString( BYTEARRAY b )
 	if( b.empty( ) )
 		return string( );
 
-	string result = UTIL_ToHexString( b[0] );
+	string result;
+	result.reserve( b.size( ) * 3 );
+	UTIL_AppendHex( result, b[0] );
 
 	for( BYTEARRAY :: iterator i = b.begin( ) + 1; i != b.end( ); i++ )
 	{
-		if( *i < 16 )
-			result += " 0" + UTIL_ToHexString( *i );
-		else
-			result += " " + UTIL_ToHexString( *i );
+		result.push_back( ' ' );
+		UTIL_AppendHex( result, *i, 2 );
 	}
 
 	return result;
@@ -187,6 +214,176 @@ BYTEARRAY UTIL_ExtractCString( BYTEARRAY &b, unsigned int start )
 	return BYTEARRAY( );
 }
 
+#ifdef UTIL_SIMD
+
+// compare the first and the last byte of the signature at 16 (SSE2) or 32 (AVX2) positions at once and only confirm candidates where both match with memcmp
+// this rejects almost every position with two vector compares even if the first byte of the signature is common
+
+static uint32_t UTIL_FindSignatureSSE2( unsigned char *data, uint32_t length, const unsigned char *signature, uint32_t signatureLength )
+{
+	const __m128i First = _mm_set1_epi8( (char)signature[0] );
+	const __m128i Last = _mm_set1_epi8( (char)signature[signatureLength - 1] );
+	uint32_t i = 0;
+
+	for( ; i + signatureLength - 1 + 16 <= length; i += 16 )
+	{
+		__m128i BlockFirst = _mm_loadu_si128( (__m128i *)( data + i ) );
+		__m128i BlockLast = _mm_loadu_si128( (__m128i *)( data + i + signatureLength - 1 ) );
+		uint32_t Mask = _mm_movemask_epi8( _mm_and_si128( _mm_cmpeq_epi8( BlockFirst, First ), _mm_cmpeq_epi8( BlockLast, Last ) ) );
+
+		while( Mask )
+		{
+			uint32_t Bit = 0;
+
+			while( !( Mask & ( 1 << Bit ) ) )
+				Bit++;
+
+			if( !memcmp( data + i + Bit + 1, signature + 1, signatureLength - 2 ) )
+				return i + Bit;
+
+			Mask &= Mask - 1;
+		}
+	}
+
+	for( ; i + signatureLength <= length; i++ )
+	{
+		if( data[i] == signature[0] && !memcmp( data + i + 1, signature + 1, signatureLength - 1 ) )
+			return i;
+	}
+
+	return length;
+}
+
+UTIL_AVX2_TARGET static uint32_t UTIL_FindSignatureAVX2( unsigned char *data, uint32_t length, const unsigned char *signature, uint32_t signatureLength )
+{
+	const __m256i First = _mm256_set1_epi8( (char)signature[0] );
+	const __m256i Last = _mm256_set1_epi8( (char)signature[signatureLength - 1] );
+	uint32_t i = 0;
+
+	for( ; i + signatureLength - 1 + 32 <= length; i += 32 )
+	{
+		__m256i BlockFirst = _mm256_loadu_si256( (__m256i *)( data + i ) );
+		__m256i BlockLast = _mm256_loadu_si256( (__m256i *)( data + i + signatureLength - 1 ) );
+		uint32_t Mask = (uint32_t)_mm256_movemask_epi8( _mm256_and_si256( _mm256_cmpeq_epi8( BlockFirst, First ), _mm256_cmpeq_epi8( BlockLast, Last ) ) );
+
+		while( Mask )
+		{
+			uint32_t Bit = 0;
+
+			while( !( Mask & ( 1u << Bit ) ) )
+				Bit++;
+
+			if( !memcmp( data + i + Bit + 1, signature + 1, signatureLength - 2 ) )
+				return i + Bit;
+
+			Mask &= Mask - 1;
+		}
+	}
+
+	// the tail is shorter than one AVX2 block, let SSE2 handle it
+
+	return i + UTIL_FindSignatureSSE2( data + i, length - i, signature, signatureLength );
+}
+
+static bool UTIL_HasAVX2( )
+{
+#ifdef WIN32
+	int CPUInfo[4];
+	__cpuid( CPUInfo, 0 );
+
+	if( CPUInfo[0] < 7 )
+		return false;
+
+	__cpuid( CPUInfo, 1 );
+
+	// AVX and OSXSAVE (the OS saves the AVX registers)
+
+	if( !( CPUInfo[2] & ( 1 << 27 ) ) || !( CPUInfo[2] & ( 1 << 28 ) ) || ( _xgetbv( 0 ) & 6 ) != 6 )
+		return false;
+
+	__cpuidex( CPUInfo, 7, 0 );
+	return ( CPUInfo[1] & ( 1 << 5 ) ) != 0;
+#else
+	unsigned int EAX, EBX, ECX, EDX;
+
+	if( __get_cpuid_max( 0, NULL ) < 7 || !__get_cpuid( 1, &EAX, &EBX, &ECX, &EDX ) )
+		return false;
+
+	// AVX and OSXSAVE (the OS saves the AVX registers)
+
+	if( !( ECX & bit_AVX ) || !( ECX & bit_OSXSAVE ) )
+		return false;
+
+	unsigned int XCR0Low, XCR0High;
+	__asm__ ( "xgetbv" : "=a" ( XCR0Low ), "=d" ( XCR0High ) : "c" ( 0 ) );
+
+	if( ( XCR0Low & 6 ) != 6 )
+		return false;
+
+	__cpuid_count( 7, 0, EAX, EBX, ECX, EDX );
+	return ( EBX & bit_AVX2 ) != 0;
+#endif
+}
+
+// the CPU is checked during static initialization so the choice is made before main( ) starts any threads
+// the stats worker and the main thread both search for signatures and only ever read this afterwards
+// anything searching during static initialization in another file may still see zero (the scalar search) which is just slower
+
+static uint32_t gFindSignatureImplementation = UTIL_HasAVX2( ) ? UTIL_FINDSIGNATURE_AVX2 : UTIL_FINDSIGNATURE_SSE2;
+#else
+static uint32_t gFindSignatureImplementation = UTIL_FINDSIGNATURE_SCALAR;
+#endif
+
+uint32_t UTIL_FindSignature( unsigned char *data, uint32_t length, const unsigned char *signature, uint32_t signatureLength )
+{
+	// returns the position of the first occurrence of signature in data or length if it wasn't found
+
+	if( signatureLength == 0 || signatureLength > length )
+		return length;
+
+	if( signatureLength == 1 )
+	{
+		// memchr is already vectorized by the C library
+
+		unsigned char *Found = (unsigned char *)memchr( data, signature[0], length );
+		return Found ? Found - data : length;
+	}
+
+#ifdef UTIL_SIMD
+	if( gFindSignatureImplementation == UTIL_FINDSIGNATURE_AVX2 )
+		return UTIL_FindSignatureAVX2( data, length, signature, signatureLength );
+	else if( gFindSignatureImplementation == UTIL_FINDSIGNATURE_SSE2 )
+		return UTIL_FindSignatureSSE2( data, length, signature, signatureLength );
+#endif
+
+	for( uint32_t i = 0; i + signatureLength <= length; i++ )
+	{
+		if( data[i] == signature[0] && !memcmp( data + i + 1, signature + 1, signatureLength - 1 ) )
+			return i;
+	}
+
+	return length;
+}
+
+uint32_t UTIL_GetFindSignatureImplementation( )
+{
+	return gFindSignatureImplementation;
+}
+
+bool UTIL_SetFindSignatureImplementation( uint32_t implementation )
+{
+#ifdef UTIL_SIMD
+	if( implementation > UTIL_FINDSIGNATURE_AVX2 || ( implementation == UTIL_FINDSIGNATURE_AVX2 && !UTIL_HasAVX2( ) ) )
+		return false;
+#else
+	if( implementation != UTIL_FINDSIGNATURE_SCALAR )
+		return false;
+#endif
+
+	gFindSignatureImplementation = implementation;
+	return true;
+}
+
 unsigned char UTIL_ExtractHex( BYTEARRAY &b, unsigned int start, bool reverse )
 {
 	// consider the byte array to contain a 2 character ASCII encoded hex value at b[start] and b[start + 1] e.g. "FF"
@@ -254,84 +451,175 @@ BYTEARRAY UTIL_ExtractHexNumbers( string s )
 	return result;
 }
 
+// the integer formatting works backwards from the end of the buffer two digits at a time using this table
+// it's many times faster than a stringstream and doesn't allocate anything (std :: to_chars would do the same job but we build with -std=c++0x)
+
+static const char gDigitPairs[] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+uint32_t UTIL_FormatUInt( char *buffer, uint64_t i )
+{
+	char Temp[20];
+	char *End = Temp + sizeof( Temp );
+	char *Start = End;
+
+	while( i >= 100 )
+	{
+		uint32_t Pair = (uint32_t)( i % 100 ) * 2;
+		i /= 100;
+		*--Start = gDigitPairs[Pair + 1];
+		*--Start = gDigitPairs[Pair];
+	}
+
+	if( i >= 10 )
+	{
+		*--Start = gDigitPairs[i * 2 + 1];
+		*--Start = gDigitPairs[i * 2];
+	}
+	else
+		*--Start = (char)( '0' + i );
+
+	memcpy( buffer, Start, End - Start );
+	return End - Start;
+}
+
+uint32_t UTIL_FormatInt( char *buffer, int64_t i )
+{
+	if( i < 0 )
+	{
+		// negate as unsigned so the most negative value doesn't overflow
+
+		*buffer = '-';
+		return UTIL_FormatUInt( buffer + 1, 0 - (uint64_t)i ) + 1;
+	}
+
+	return UTIL_FormatUInt( buffer, i );
+}
+
+void UTIL_AppendUInt( string &s, uint64_t i, uint32_t width )
+{
+	char Buffer[20];
+	uint32_t Length = UTIL_FormatUInt( Buffer, i );
+
+	if( width > Length )
+		s.append( width - Length, '0' );
+
+	s.append( Buffer, Length );
+}
+
+void UTIL_AppendInt( string &s, int64_t i, uint32_t width )
+{
+	if( i < 0 )
+	{
+		s.push_back( '-' );
+		UTIL_AppendUInt( s, 0 - (uint64_t)i, width );
+	}
+	else
+		UTIL_AppendUInt( s, i, width );
+}
+
+void UTIL_AppendDouble( string &s, double d, int digits )
+{
+	// this produces exactly the same output as a stream with std :: fixed and std :: setprecision( digits )
+	// very large values don't fit in the stack buffer so we fall back to a heap buffer for those
+
+	char Buffer[64];
+	int Length = snprintf( Buffer, sizeof( Buffer ), "%.*f", digits, d );
+
+	if( Length < 0 )
+		return;
+
+	if( (uint32_t)Length < sizeof( Buffer ) )
+		s.append( Buffer, Length );
+	else
+	{
+		vector<char> Large( Length + 1 );
+		snprintf( &Large[0], Large.size( ), "%.*f", digits, d );
+		s.append( &Large[0], Length );
+	}
+}
+
+void UTIL_AppendHex( string &s, uint32_t i, uint32_t width )
+{
+	char Buffer[8];
+	char *End = Buffer + sizeof( Buffer );
+	char *Start = End;
+
+	do
+	{
+		*--Start = "0123456789abcdef"[i & 15];
+		i >>= 4;
+	} while( i != 0 );
+
+	if( width > (uint32_t)( End - Start ) )
+		s.append( width - ( End - Start ), '0' );
+
+	s.append( Start, End - Start );
+}
+
 string UTIL_ToString( unsigned long i )
 {
-	string result;
-	stringstream SS;
-	SS << i;
-	SS >> result;
-	return result;
+	char Buffer[20];
+	return string( Buffer, UTIL_FormatUInt( Buffer, i ) );
 }
 
 string UTIL_ToString( unsigned short i )
 {
-	string result;
-	stringstream SS;
-	SS << i;
-	SS >> result;
-	return result;
+	char Buffer[20];
+	return string( Buffer, UTIL_FormatUInt( Buffer, i ) );
 }
 
 string UTIL_ToString( unsigned int i )
 {
-	string result;
-	stringstream SS;
-	SS << i;
-	SS >> result;
-	return result;
+	char Buffer[20];
+	return string( Buffer, UTIL_FormatUInt( Buffer, i ) );
 }
 
 string UTIL_ToString( long i )
 {
-	string result;
-	stringstream SS;
-	SS << i;
-	SS >> result;
-	return result;
+	char Buffer[21];
+	return string( Buffer, UTIL_FormatInt( Buffer, i ) );
 }
 
 string UTIL_ToString( short i )
 {
-	string result;
-	stringstream SS;
-	SS << i;
-	SS >> result;
-	return result;
+	char Buffer[21];
+	return string( Buffer, UTIL_FormatInt( Buffer, i ) );
 }
 
 string UTIL_ToString( int i )
 {
-	string result;
-	stringstream SS;
-	SS << i;
-	SS >> result;
-	return result;
+	char Buffer[21];
+	return string( Buffer, UTIL_FormatInt( Buffer, i ) );
 }
 
 string UTIL_ToString( float f, int digits )
 {
 	string result;
-	stringstream SS;
-	SS << std :: fixed << std :: setprecision( digits ) << f;
-	SS >> result;
+	UTIL_AppendDouble( result, f, digits );
 	return result;
 }
 
 string UTIL_ToString( double d, int digits )
 {
 	string result;
-	stringstream SS;
-	SS << std :: fixed << std :: setprecision( digits ) << d;
-	SS >> result;
+	UTIL_AppendDouble( result, d, digits );
 	return result;
 }
 
 string UTIL_ToHexString( uint32_t i )
 {
 	string result;
-	stringstream SS;
-	SS << std :: hex << i;
-	SS >> result;
+	UTIL_AppendHex( result, i );
 	return result;
 }
 
@@ -384,16 +672,12 @@ double UTIL_ToDouble( string &s )
 
 string UTIL_MSToString( uint32_t ms )
 {
-	string MinString = UTIL_ToString( ( ms / 1000 ) / 60 );
-	string SecString = UTIL_ToString( ( ms / 1000 ) % 60 );
-
-	if( MinString.size( ) == 1 )
-		MinString.insert( 0, "0" );
-
-	if( SecString.size( ) == 1 )
-		SecString.insert( 0, "0" );
-
-	return MinString + "m" + SecString + "s";
+	string result;
+	UTIL_AppendUInt( result, ( ms / 1000 ) / 60, 2 );
+	result.push_back( 'm' );
+	UTIL_AppendUInt( result, ( ms / 1000 ) % 60, 2 );
+	result.push_back( 's' );
+	return result;
 }
 
 bool UTIL_FileExists( string file )
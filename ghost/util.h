@@ -42,6 +42,17 @@ BYTEARRAY UTIL_ExtractCString( BYTEARRAY &b, unsigned int start );
 unsigned char UTIL_ExtractHex( BYTEARRAY &b, unsigned int start, bool reverse );
 BYTEARRAY UTIL_ExtractNumbers( string s, unsigned int count );
 BYTEARRAY UTIL_ExtractHexNumbers( string s );
+uint32_t UTIL_FindSignature( unsigned char *data, uint32_t length, const unsigned char *signature, uint32_t signatureLength );
+
+// the signature search uses the fastest implementation the CPU supports, it's detected once during static initialization before any threads exist
+// the implementation can be changed so they can be compared against each other but not while another thread might be searching
+
+#define UTIL_FINDSIGNATURE_SCALAR	0		// byte at a time
+#define UTIL_FINDSIGNATURE_SSE2		1		// only on x86 and x64
+#define UTIL_FINDSIGNATURE_AVX2		2		// only on x86 and x64 if the CPU supports AVX2
+
+uint32_t UTIL_GetFindSignatureImplementation( );
+bool UTIL_SetFindSignatureImplementation( uint32_t implementation );
 
 // conversions
 
@@ -61,6 +72,17 @@ int32_t UTIL_ToInt32( string &s );
 double UTIL_ToDouble( string &s );
 string UTIL_MSToString( uint32_t ms );
 
+// formatting
+// these write numbers straight into a buffer or onto the end of a string without going through a stringstream
+// the width pads the number with leading zeros (after the sign) up to that many digits
+
+uint32_t UTIL_FormatUInt( char *buffer, uint64_t i );		// the buffer must have room for 20 chars, returns the number of chars written (not null terminated)
+uint32_t UTIL_FormatInt( char *buffer, int64_t i );			// the buffer must have room for 21 chars
+void UTIL_AppendUInt( string &s, uint64_t i, uint32_t width = 0 );
+void UTIL_AppendInt( string &s, int64_t i, uint32_t width = 0 );
+void UTIL_AppendDouble( string &s, double d, int digits );
+void UTIL_AppendHex( string &s, uint32_t i, uint32_t width = 0 );
+
 // files
 
 bool UTIL_FileExists( string file );
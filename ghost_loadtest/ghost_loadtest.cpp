@@ -0,0 +1,366 @@
+/*
+
+   Copyright [2008] [Trevor Hogan]
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+   CODE PORTED FROM THE ORIGINAL GHOST PROJECT: http://ghost.pwner.org/
+
+*/
+
+// ghost_loadtest replays the action streams of existing .w3g files against a running GHost++ bot
+// it joins the bot's lobby with one fake client per recorded player, waits for the bot to start the game (use autohost with autostart), loads instantly,
+// and then sends every recorded action and a keepalive for every action packet received, just like a real client
+// as soon as a game has started the next game joins the (new) lobby, so with autohost you end up with lt_games games running side by side
+// the results are the action tick jitter seen by the clients, the bytes sent and received, and (on Linux) the CPU time used by the bot process
+
+#include "ghost.h"
+#include "util.h"
+#include "config.h"
+#include "socket.h"
+#include "metrics.h"
+#include "loadclient.h"
+
+#include <time.h>
+
+#ifdef WIN32
+ #include <windows.h>
+ #include <winsock.h>
+#endif
+
+void LOG_Print( uint32_t level, string message )
+{
+	cout << message << endl;
+}
+
+void CONSOLE_Print( string message )
+{
+	LOG_Print( LOG_INFO, message );
+}
+
+void DEBUG_Print( string message )
+{
+	LOG_Print( LOG_DEBUG, message );
+}
+
+uint32_t GetTime( )
+{
+	return GetTicks( ) / 1000;
+}
+
+uint32_t GetTicks( )
+{
+	return (uint32_t)( GetMicroTicks( ) / 1000 );
+}
+
+uint64_t GetMicroTicks( )
+{
+#ifdef WIN32
+	static LARGE_INTEGER Frequency = { 0 };
+	LARGE_INTEGER Counter;
+
+	if( Frequency.QuadPart == 0 )
+		QueryPerformanceFrequency( &Frequency );
+
+	QueryPerformanceCounter( &Counter );
+	return (uint64_t)( Counter.QuadPart / ( Frequency.QuadPart / 1000000.0 ) );
+#else
+	struct timespec t;
+	clock_gettime( CLOCK_MONOTONIC, &t );
+	return (uint64_t)t.tv_sec * 1000000 + t.tv_nsec / 1000;
+#endif
+}
+
+double GetProcessCPU( uint32_t pid )
+{
+	// returns the user + system CPU time used by the given process in seconds (or a negative number if it isn't available)
+
+#ifdef __linux__
+	string Stat = UTIL_FileRead( "/proc/" + UTIL_ToString( pid ) + "/stat" );
+	string :: size_type End = Stat.rfind( ')' );
+
+	if( End == string :: npos )
+		return -1.0;
+
+	// the fields after the process name start with the state (field 3), utime and stime are fields 14 and 15
+
+	vector<string> Fields = UTIL_Tokenize( Stat.substr( End + 2 ), ' ' );
+
+	if( Fields.size( ) < 13 )
+		return -1.0;
+
+	return ( UTIL_ToDouble( Fields[11] ) + UTIL_ToDouble( Fields[12] ) ) / sysconf( _SC_CLK_TCK );
+#else
+	return -1.0;
+#endif
+}
+
+string FormatJitter( CHistogram &histogram )
+{
+	return UTIL_ToString( histogram.GetPercentile( 0.5 ) ) + "/" + UTIL_ToString( histogram.GetPercentile( 0.99 ) ) + "/" + UTIL_ToString( histogram.GetPercentile( 0.999 ) ) + "/" + UTIL_ToString( histogram.GetMax( ) ) + "ms";
+}
+
+int main( int argc, char **argv )
+{
+	string CFGFile = "ghost_loadtest.cfg";
+
+	if( argc > 1 && argv[1] )
+		CFGFile = argv[1];
+
+	CConfig CFG;
+	CFG.Read( CFGFile );
+	string Address = CFG.GetString( "lt_address", "127.0.0.1" );
+	uint16_t Port = CFG.GetInt( "lt_port", 6112 );
+	vector<string> ReplayFiles = UTIL_Tokenize( CFG.GetString( "lt_replays", string( ) ), ' ' );
+	uint32_t NumGames = CFG.GetInt( "lt_games", 1 );
+	uint32_t PlayersPerGame = CFG.GetInt( "lt_playerspergame", 0 );
+	uint32_t Duration = CFG.GetInt( "lt_duration", 0 ) * 1000;
+	uint32_t JoinInterval = CFG.GetInt( "lt_joininterval", 100 );
+	uint32_t BotPID = CFG.GetInt( "lt_botpid", 0 );
+	uint32_t StatusInterval = CFG.GetInt( "lt_statusinterval", 10 );
+
+#ifdef WIN32
+	WSADATA wsadata;
+
+	if( WSAStartup( MAKEWORD( 2, 2 ), &wsadata ) != 0 )
+	{
+		cout << "error starting winsock" << endl;
+		return 1;
+	}
+#endif
+
+	// load the replays
+
+	vector<CLoadReplay *> Replays;
+
+	for( vector<string> :: iterator i = ReplayFiles.begin( ); i != ReplayFiles.end( ); i++ )
+	{
+		if( i->empty( ) )
+			continue;
+
+		CLoadReplay *Replay = new CLoadReplay( );
+
+		if( Replay->Load( *i ) )
+		{
+			uint32_t Actions = 0;
+
+			for( vector<CLoadScript> :: iterator j = Replay->m_Scripts.begin( ); j != Replay->m_Scripts.end( ); j++ )
+				Actions += j->m_Actions.size( );
+
+			cout << "loaded replay [" << *i << "] with " << Replay->m_Scripts.size( ) << " players, " << Actions << " actions, " << Replay->m_CheckSums.size( ) << " checksums, length " << UTIL_MSToString( Replay->m_Length ) << endl;
+			Replays.push_back( Replay );
+		}
+		else
+		{
+			cout << "error loading replay [" << *i << "]" << endl;
+			delete Replay;
+		}
+	}
+
+	if( Replays.empty( ) )
+	{
+		cout << "error: no replays loaded, set lt_replays in " << CFGFile << endl;
+		return 1;
+	}
+
+	if( BotPID != 0 && GetProcessCPU( BotPID ) < 0.0 )
+	{
+		cout << "warning: unable to read the CPU time of process " << BotPID << ", the bot's CPU usage won't be reported" << endl;
+		BotPID = 0;
+	}
+
+	vector<CLoadGame *> Games;
+	CLoadGame *Lobby = NULL;
+	uint32_t LastJoinTicks = 0;
+	uint32_t LastStatusTicks = GetTicks( );
+	uint32_t StartTicks = GetTicks( );
+	uint64_t LastLoopMicroTicks = GetMicroTicks( );
+	double GameSeconds = 0.0;
+	double StartCPU = BotPID != 0 ? GetProcessCPU( BotPID ) : 0.0;
+
+	while( true )
+	{
+		// create the next game once the lobby is free (i.e. the bot has started the previous game)
+
+		if( !Lobby && Games.size( ) < NumGames )
+		{
+			Lobby = new CLoadGame( Games.size( ), Replays[Games.size( ) % Replays.size( )] );
+			Games.push_back( Lobby );
+			cout << "[LOADTEST] joining game #" << Lobby->m_ID << " with replay [" << Lobby->m_Replay->m_File << "]" << endl;
+		}
+
+		if( Lobby )
+		{
+			uint32_t Players = PlayersPerGame > 0 ? PlayersPerGame : Lobby->m_Replay->m_Scripts.size( );
+
+			if( Lobby->GetFailed( ) )
+			{
+				// don't keep hammering the bot if it rejects us
+
+				cout << "[LOADTEST] game #" << Lobby->m_ID << " failed to start, not creating any more games" << endl;
+				NumGames = Games.size( );
+				Lobby = NULL;
+			}
+			else if( Lobby->m_Clients.size( ) < Players )
+			{
+				if( GetTicks( ) - LastJoinTicks >= JoinInterval )
+				{
+					// player names are limited to 15 characters
+
+					uint32_t Index = Lobby->m_Clients.size( );
+					CLoadClient *Client = new CLoadClient( "lt" + UTIL_ToString( Lobby->m_ID ) + "_" + UTIL_ToString( Index ), &Lobby->m_Replay->m_Scripts[Index % Lobby->m_Replay->m_Scripts.size( )], &Lobby->m_Replay->m_CheckSums, Duration, &Lobby->m_TickJitter );
+					Client->Connect( Address, Port );
+					Lobby->m_Clients.push_back( Client );
+					LastJoinTicks = GetTicks( );
+				}
+			}
+			else if( Lobby->GetStarted( ) )
+			{
+				Lobby->m_LoadedTicks = GetTicks( );
+				cout << "[LOADTEST] game #" << Lobby->m_ID << " started after " << UTIL_MSToString( Lobby->m_LoadedTicks - Lobby->m_StartedTicks ) << endl;
+				Lobby = NULL;
+			}
+		}
+
+		// wait for data, we only block for a short time because the lobby logic above runs on timers
+
+		fd_set fd;
+		fd_set send_fd;
+		FD_ZERO( &fd );
+		FD_ZERO( &send_fd );
+		int nfds = 0;
+		unsigned int NumFDs = 0;
+
+		for( vector<CLoadGame *> :: iterator i = Games.begin( ); i != Games.end( ); i++ )
+		{
+			for( vector<CLoadClient *> :: iterator j = (*i)->m_Clients.begin( ); j != (*i)->m_Clients.end( ); j++ )
+				NumFDs += (*j)->SetFD( &fd, &send_fd, &nfds );
+		}
+
+		struct timeval tv;
+		tv.tv_sec = 0;
+		tv.tv_usec = 10000;
+
+		struct timeval send_tv;
+		send_tv.tv_sec = 0;
+		send_tv.tv_usec = 0;
+
+		if( NumFDs > 0 )
+		{
+#ifdef WIN32
+			select( 1, &fd, NULL, NULL, &tv );
+			select( 1, NULL, &send_fd, NULL, &send_tv );
+#else
+			select( nfds + 1, &fd, NULL, NULL, &tv );
+			select( nfds + 1, NULL, &send_fd, NULL, &send_tv );
+#endif
+		}
+		else
+			MILLISLEEP( 10 );
+
+		uint32_t ActiveGames = 0;
+
+		for( vector<CLoadGame *> :: iterator i = Games.begin( ); i != Games.end( ); i++ )
+		{
+			if( (*i)->m_FinishedTicks != 0 )
+				continue;
+
+			for( vector<CLoadClient *> :: iterator j = (*i)->m_Clients.begin( ); j != (*i)->m_Clients.end( ); j++ )
+				(*j)->Update( &fd, &send_fd );
+
+			if( (*i)->m_LoadedTicks != 0 )
+				ActiveGames++;
+
+			if( !(*i)->m_Clients.empty( ) && (*i)->GetFinished( ) )
+			{
+				(*i)->m_FinishedTicks = GetTicks( );
+				cout << "[LOADTEST] game #" << (*i)->m_ID << " finished" << ( (*i)->GetFailed( ) ? " (with errors)" : string( ) ) << ", tick jitter p50/p99/p99.9/max " << FormatJitter( (*i)->m_TickJitter ) << endl;
+			}
+		}
+
+		// keep track of the number of game seconds so we can work out the CPU time per game
+
+		uint64_t LoopMicroTicks = GetMicroTicks( );
+		GameSeconds += ActiveGames * ( LoopMicroTicks - LastLoopMicroTicks ) / 1000000.0;
+		LastLoopMicroTicks = LoopMicroTicks;
+
+		if( StatusInterval > 0 && GetTicks( ) - LastStatusTicks >= StatusInterval * 1000 )
+		{
+			CHistogram TickJitter;
+
+			for( vector<CLoadGame *> :: iterator i = Games.begin( ); i != Games.end( ); i++ )
+				TickJitter.Merge( (*i)->m_TickJitter );
+
+			cout << "[LOADTEST] " << ActiveGames << " games running, tick jitter p50/p99/p99.9/max " << FormatJitter( TickJitter ) << endl;
+			LastStatusTicks = GetTicks( );
+		}
+
+		if( !Lobby && Games.size( ) >= NumGames )
+		{
+			bool Finished = true;
+
+			for( vector<CLoadGame *> :: iterator i = Games.begin( ); i != Games.end( ); i++ )
+			{
+				if( (*i)->m_FinishedTicks == 0 )
+					Finished = false;
+			}
+
+			if( Finished )
+				break;
+		}
+	}
+
+	// report
+
+	double Seconds = ( GetTicks( ) - StartTicks ) / 1000.0;
+	uint64_t BytesSent = 0;
+	uint64_t BytesReceived = 0;
+	uint32_t Ticks = 0;
+	CHistogram TickJitter;
+
+	for( vector<CLoadGame *> :: iterator i = Games.begin( ); i != Games.end( ); i++ )
+	{
+		BytesSent += (*i)->GetBytesSent( );
+		BytesReceived += (*i)->GetBytesReceived( );
+		TickJitter.Merge( (*i)->m_TickJitter );
+
+		for( vector<CLoadClient *> :: iterator j = (*i)->m_Clients.begin( ); j != (*i)->m_Clients.end( ); j++ )
+			Ticks += (*j)->GetTicks( );
+	}
+
+	cout << "[LOADTEST] ran " << Games.size( ) << " games in " << UTIL_ToString( Seconds, 1 ) << " seconds (" << UTIL_ToString( GameSeconds, 1 ) << " game seconds)" << endl;
+	cout << "[LOADTEST] action ticks received: " << Ticks << ", tick jitter p50/p99/p99.9/max " << FormatJitter( TickJitter ) << endl;
+	cout << "[LOADTEST] sent " << UTIL_ToString( BytesSent / Seconds / 1024.0, 2 ) << " KB/sec, received " << UTIL_ToString( BytesReceived / Seconds / 1024.0, 2 ) << " KB/sec" << endl;
+
+	if( BotPID != 0 && GameSeconds > 0.0 )
+	{
+		// CPU per game is the bot's CPU time divided by the game seconds, i.e. the fraction of one core a single game uses
+
+		double CPU = GetProcessCPU( BotPID ) - StartCPU;
+		double CPUPerGame = CPU / GameSeconds;
+		cout << "[LOADTEST] bot CPU time " << UTIL_ToString( CPU, 2 ) << " seconds, " << UTIL_ToString( CPUPerGame * 100.0, 3 ) << "% of a core per game";
+
+		if( CPUPerGame > 0.0 )
+			cout << " (about " << (uint32_t)( 1.0 / CPUPerGame ) << " games per core)";
+
+		cout << endl;
+	}
+
+	for( vector<CLoadGame *> :: iterator i = Games.begin( ); i != Games.end( ); i++ )
+		delete *i;
+
+	for( vector<CLoadReplay *> :: iterator i = Replays.begin( ); i != Replays.end( ); i++ )
+		delete *i;
+
+	return 0;
+}
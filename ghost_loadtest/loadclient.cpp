@@ -0,0 +1,467 @@
+/*
+
+   Copyright [2008] [Trevor Hogan]
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+   CODE PORTED FROM THE ORIGINAL GHOST PROJECT: http://ghost.pwner.org/
+
+*/
+
+#include "ghost.h"
+#include "util.h"
+#include "socket.h"
+#include "packed.h"
+#include "replay.h"
+#include "metrics.h"
+#include "loadclient.h"
+
+// W3GS packet IDs (see gameprotocol.h)
+
+#define W3GS_HEADER_CONSTANT		247
+#define W3GS_PING_FROM_HOST			1
+#define W3GS_SLOTINFOJOIN			4
+#define W3GS_REJECTJOIN				5
+#define W3GS_COUNTDOWN_END			11
+#define W3GS_INCOMING_ACTION		12
+#define W3GS_REQJOIN				30
+#define W3GS_LEAVEGAME				33
+#define W3GS_GAMELOADED_SELF		35
+#define W3GS_OUTGOING_ACTION		38
+#define W3GS_OUTGOING_KEEPALIVE		39
+#define W3GS_MAPCHECK				61
+#define W3GS_MAPSIZE				66
+#define W3GS_PONG_TO_HOST			70
+
+BYTEARRAY CreatePacket( unsigned char id )
+{
+	BYTEARRAY packet;
+	packet.push_back( W3GS_HEADER_CONSTANT );
+	packet.push_back( id );
+	packet.push_back( 0 );		// packet length will be assigned later
+	packet.push_back( 0 );		// packet length will be assigned later
+	return packet;
+}
+
+void AssignLength( BYTEARRAY &packet )
+{
+	packet[2] = (unsigned char)packet.size( );
+	packet[3] = (unsigned char)( packet.size( ) >> 8 );
+}
+
+//
+// CLoadReplay
+//
+
+bool CLoadReplay :: Load( string file )
+{
+	m_File = file;
+	m_Length = 0;
+
+	CReplay Replay;
+	Replay.Load( file, true );
+
+	if( !Replay.GetValid( ) )
+		return false;
+
+	Replay.ParseReplay( true );
+
+	if( !Replay.GetValid( ) )
+		return false;
+
+	// assign one script to every player except the host (which is usually the GHost++ virtual host and never sends actions)
+
+	map<unsigned char, uint32_t> Scripts;
+	vector<PIDPlayer> Players = Replay.GetPlayers( );
+
+	for( vector<PIDPlayer> :: iterator i = Players.begin( ); i != Players.end( ); i++ )
+	{
+		if( i->first != Replay.GetHostPID( ) )
+		{
+			Scripts[i->first] = m_Scripts.size( );
+			m_Scripts.push_back( CLoadScript( ) );
+		}
+	}
+
+	// walk the time slots and split the actions by player
+	// time slot block: 1 byte ID, 2 bytes size, 2 bytes time increment, then for each player: 1 byte PID, 2 bytes length, action data
+
+	queue<BYTEARRAY> *Blocks = Replay.GetBlocks( );
+
+	while( !Blocks->empty( ) )
+	{
+		BYTEARRAY Block = Blocks->front( );
+		Blocks->pop( );
+
+		if( Block.size( ) < 5 || Block[0] != CReplay :: REPLAY_TIMESLOT )
+			continue;
+
+		m_Length += UTIL_ByteArrayToUInt16( Block, false, 3 );
+		unsigned int i = 5;
+
+		while( i + 3 <= Block.size( ) )
+		{
+			unsigned char PID = Block[i];
+			uint16_t ActionSize = UTIL_ByteArrayToUInt16( Block, false, i + 1 );
+			i += 3;
+
+			if( i + ActionSize > Block.size( ) )
+				break;
+
+			if( Scripts.find( PID ) != Scripts.end( ) )
+				m_Scripts[Scripts[PID]].m_Actions.push_back( make_pair( m_Length, BYTEARRAY( Block.begin( ) + i, Block.begin( ) + i + ActionSize ) ) );
+
+			i += ActionSize;
+		}
+	}
+
+	queue<uint32_t> *CheckSums = Replay.GetCheckSums( );
+
+	while( !CheckSums->empty( ) )
+	{
+		m_CheckSums.push_back( CheckSums->front( ) );
+		CheckSums->pop( );
+	}
+
+	return !m_Scripts.empty( );
+}
+
+//
+// CLoadClient
+//
+
+CLoadClient :: CLoadClient( string nName, CLoadScript *nScript, vector<uint32_t> *nCheckSums, uint32_t nDuration, CHistogram *nTickJitter )
+{
+	m_Socket = new CTCPClient( );
+	m_Name = nName;
+	m_PID = 255;
+	m_State = LOADCLIENT_CONNECTING;
+	m_Script = nScript;
+	m_CheckSums = nCheckSums;
+	m_NextAction = 0;
+	m_KeepAlives = 0;
+	m_GameTime = 0;
+	m_Duration = nDuration;
+	m_LastActionMicroTicks = 0;
+	m_TickJitter = nTickJitter;
+	m_BytesSent = 0;
+	m_BytesReceived = 0;
+	m_Ticks = 0;
+}
+
+CLoadClient :: ~CLoadClient( )
+{
+	delete m_Socket;
+}
+
+void CLoadClient :: Connect( string address, uint16_t port )
+{
+	m_Socket->Connect( string( ), address, port );
+}
+
+unsigned int CLoadClient :: SetFD( void *fd, void *send_fd, int *nfds )
+{
+	if( m_State == LOADCLIENT_DONE || m_State == LOADCLIENT_FAILED || m_Socket->HasError( ) )
+		return 0;
+
+	m_Socket->SetFD( (fd_set *)fd, (fd_set *)send_fd, nfds );
+	return 1;
+}
+
+void CLoadClient :: Update( void *fd, void *send_fd )
+{
+	if( m_State == LOADCLIENT_DONE || m_State == LOADCLIENT_FAILED )
+		return;
+
+	if( m_Socket->HasError( ) )
+	{
+		CONSOLE_Print( "[LOADTEST: " + m_Name + "] socket error - " + m_Socket->GetErrorString( ) );
+		m_State = LOADCLIENT_FAILED;
+		return;
+	}
+
+	if( m_State == LOADCLIENT_CONNECTING )
+	{
+		if( !m_Socket->CheckConnect( ) )
+			return;
+
+		m_Socket->SetNoDelay( true );
+
+		// W3GS_REQJOIN: host counter 0 and entry key 0 because we join like a LAN client
+
+		BYTEARRAY packet = CreatePacket( W3GS_REQJOIN );
+		UTIL_AppendByteArray( packet, (uint32_t)0, false );		// host counter
+		UTIL_AppendByteArray( packet, (uint32_t)0, false );		// entry key
+		packet.push_back( 0 );										// ???
+		UTIL_AppendByteArray( packet, (uint16_t)6112, false );		// listen port
+		UTIL_AppendByteArray( packet, (uint32_t)0, false );		// peer key
+		UTIL_AppendByteArray( packet, m_Name );						// name
+		UTIL_AppendByteArray( packet, (uint32_t)0, false );		// ???
+		UTIL_AppendByteArray( packet, (uint16_t)6112, false );		// internal port
+		UTIL_AppendByteArray( packet, (uint32_t)0x0100007F, false );	// internal IP
+		AssignLength( packet );
+		Send( packet );
+		m_State = LOADCLIENT_LOBBY;
+	}
+
+	m_Socket->DoRecv( (fd_set *)fd );
+
+	string *RecvBuffer = m_Socket->GetBytes( );
+	m_BytesReceived += RecvBuffer->size( );
+
+	while( RecvBuffer->size( ) >= 4 && m_State != LOADCLIENT_FAILED )
+	{
+		if( (unsigned char)(*RecvBuffer)[0] != W3GS_HEADER_CONSTANT )
+		{
+			CONSOLE_Print( "[LOADTEST: " + m_Name + "] received invalid packet from host" );
+			m_State = LOADCLIENT_FAILED;
+			break;
+		}
+
+		uint16_t Length = (unsigned char)(*RecvBuffer)[2] | (unsigned char)(*RecvBuffer)[3] << 8;
+
+		if( Length < 4 )
+		{
+			CONSOLE_Print( "[LOADTEST: " + m_Name + "] received invalid packet length from host" );
+			m_State = LOADCLIENT_FAILED;
+			break;
+		}
+
+		if( RecvBuffer->size( ) < Length )
+			break;
+
+		BYTEARRAY Packet = BYTEARRAY( RecvBuffer->begin( ), RecvBuffer->begin( ) + Length );
+		*RecvBuffer = RecvBuffer->substr( Length );
+		ProcessPacket( Packet );
+	}
+
+	// m_BytesReceived counts whatever was in the buffer, subtract the partial packet we'll count again next time
+
+	m_BytesReceived -= RecvBuffer->size( );
+
+	if( m_State == LOADCLIENT_PLAYING )
+		SendDueActions( );
+
+	if( !m_Socket->GetConnected( ) && m_State != LOADCLIENT_FAILED && m_State != LOADCLIENT_DONE )
+	{
+		CONSOLE_Print( "[LOADTEST: " + m_Name + "] disconnected by host" );
+		m_State = LOADCLIENT_FAILED;
+	}
+
+	m_Socket->DoSend( (fd_set *)send_fd );
+}
+
+void CLoadClient :: ProcessPacket( BYTEARRAY &packet )
+{
+	switch( packet[1] )
+	{
+	case W3GS_PING_FROM_HOST:
+		if( packet.size( ) >= 8 )
+		{
+			BYTEARRAY Pong = CreatePacket( W3GS_PONG_TO_HOST );
+			Pong.insert( Pong.end( ), packet.begin( ) + 4, packet.begin( ) + 8 );
+			AssignLength( Pong );
+			Send( Pong );
+		}
+
+		break;
+
+	case W3GS_SLOTINFOJOIN:
+		if( packet.size( ) >= 6 )
+		{
+			uint16_t SlotInfoSize = UTIL_ByteArrayToUInt16( packet, false, 4 );
+
+			if( packet.size( ) > 6 + SlotInfoSize )
+				m_PID = packet[6 + SlotInfoSize];
+		}
+
+		break;
+
+	case W3GS_REJECTJOIN:
+		CONSOLE_Print( "[LOADTEST: " + m_Name + "] join rejected (is the lobby full or is a game already in progress?)" );
+		m_State = LOADCLIENT_FAILED;
+		break;
+
+	case W3GS_MAPCHECK:
+		if( packet.size( ) >= 9 )
+		{
+			// claim we already have the map by echoing the map size back
+
+			BYTEARRAY MapPath = UTIL_ExtractCString( packet, 8 );
+			unsigned int MapSizeStart = 8 + MapPath.size( ) + 1;
+
+			if( packet.size( ) >= MapSizeStart + 4 )
+			{
+				BYTEARRAY MapSize = CreatePacket( W3GS_MAPSIZE );
+				UTIL_AppendByteArray( MapSize, (uint32_t)1, false );		// ???
+				MapSize.push_back( 1 );										// size flag (1 = have map)
+				MapSize.insert( MapSize.end( ), packet.begin( ) + MapSizeStart, packet.begin( ) + MapSizeStart + 4 );
+				AssignLength( MapSize );
+				Send( MapSize );
+			}
+		}
+
+		break;
+
+	case W3GS_COUNTDOWN_END:
+		// load instantly
+
+		if( m_State == LOADCLIENT_LOBBY )
+		{
+			BYTEARRAY Loaded = CreatePacket( W3GS_GAMELOADED_SELF );
+			AssignLength( Loaded );
+			Send( Loaded );
+			m_State = LOADCLIENT_LOADING;
+		}
+
+		break;
+
+	case W3GS_INCOMING_ACTION:
+		if( packet.size( ) >= 6 && ( m_State == LOADCLIENT_LOADING || m_State == LOADCLIENT_PLAYING ) )
+		{
+			uint16_t SendInterval = UTIL_ByteArrayToUInt16( packet, false, 4 );
+			uint64_t Now = GetMicroTicks( );
+
+			if( m_LastActionMicroTicks != 0 )
+			{
+				int64_t Interval = (int64_t)( Now - m_LastActionMicroTicks ) / 1000;
+				m_TickJitter->Record( (uint32_t)( Interval > SendInterval ? Interval - SendInterval : SendInterval - Interval ) );
+			}
+
+			m_LastActionMicroTicks = Now;
+			m_State = LOADCLIENT_PLAYING;
+			m_GameTime += SendInterval;
+			m_Ticks++;
+
+			// every W3GS_INCOMING_ACTION must be answered with a keepalive containing the game state checksum
+
+			BYTEARRAY KeepAlive = CreatePacket( W3GS_OUTGOING_KEEPALIVE );
+			KeepAlive.push_back( 0 );
+			UTIL_AppendByteArray( KeepAlive, m_KeepAlives < m_CheckSums->size( ) ? (*m_CheckSums)[m_KeepAlives] : (uint32_t)0, false );
+			AssignLength( KeepAlive );
+			Send( KeepAlive );
+			m_KeepAlives++;
+		}
+
+		break;
+	}
+}
+
+void CLoadClient :: Send( BYTEARRAY packet )
+{
+	m_BytesSent += packet.size( );
+	m_Socket->PutBytes( packet );
+}
+
+void CLoadClient :: SendDueActions( )
+{
+	// send every recorded action whose game time has been reached
+
+	while( m_NextAction < m_Script->m_Actions.size( ) && m_Script->m_Actions[m_NextAction].first <= m_GameTime )
+	{
+		BYTEARRAY Action = CreatePacket( W3GS_OUTGOING_ACTION );
+		UTIL_AppendByteArray( Action, (uint32_t)0, false );		// crc (ignored by GHost++)
+		UTIL_AppendByteArrayFast( Action, m_Script->m_Actions[m_NextAction].second );
+		AssignLength( Action );
+		Send( Action );
+		m_NextAction++;
+	}
+
+	bool ScriptDone = m_NextAction >= m_Script->m_Actions.size( ) && ( m_Script->m_Actions.empty( ) || m_GameTime >= m_Script->m_Actions.back( ).first );
+
+	if( ( m_Duration > 0 && m_GameTime >= m_Duration ) || ( m_Duration == 0 && ScriptDone ) )
+		Leave( );
+}
+
+void CLoadClient :: Leave( )
+{
+	BYTEARRAY Leave = CreatePacket( W3GS_LEAVEGAME );
+	UTIL_AppendByteArray( Leave, (uint32_t)7, false );		// PLAYERLEAVE_LOST
+	AssignLength( Leave );
+	Send( Leave );
+	m_State = LOADCLIENT_DONE;
+}
+
+//
+// CLoadGame
+//
+
+CLoadGame :: CLoadGame( uint32_t nID, CLoadReplay *nReplay )
+{
+	m_ID = nID;
+	m_Replay = nReplay;
+	m_StartedTicks = GetTicks( );
+	m_LoadedTicks = 0;
+	m_FinishedTicks = 0;
+}
+
+CLoadGame :: ~CLoadGame( )
+{
+	for( vector<CLoadClient *> :: iterator i = m_Clients.begin( ); i != m_Clients.end( ); i++ )
+		delete *i;
+}
+
+bool CLoadGame :: GetStarted( )
+{
+	// the game has started (and the lobby is free for the next game) once every client is past the lobby
+
+	for( vector<CLoadClient *> :: iterator i = m_Clients.begin( ); i != m_Clients.end( ); i++ )
+	{
+		if( (*i)->GetState( ) == LOADCLIENT_CONNECTING || (*i)->GetState( ) == LOADCLIENT_LOBBY )
+			return false;
+	}
+
+	return true;
+}
+
+bool CLoadGame :: GetFinished( )
+{
+	for( vector<CLoadClient *> :: iterator i = m_Clients.begin( ); i != m_Clients.end( ); i++ )
+	{
+		if( (*i)->GetState( ) != LOADCLIENT_DONE && (*i)->GetState( ) != LOADCLIENT_FAILED )
+			return false;
+	}
+
+	return true;
+}
+
+bool CLoadGame :: GetFailed( )
+{
+	for( vector<CLoadClient *> :: iterator i = m_Clients.begin( ); i != m_Clients.end( ); i++ )
+	{
+		if( (*i)->GetState( ) == LOADCLIENT_FAILED )
+			return true;
+	}
+
+	return false;
+}
+
+uint64_t CLoadGame :: GetBytesSent( )
+{
+	uint64_t Bytes = 0;
+
+	for( vector<CLoadClient *> :: iterator i = m_Clients.begin( ); i != m_Clients.end( ); i++ )
+		Bytes += (*i)->GetBytesSent( );
+
+	return Bytes;
+}
+
+uint64_t CLoadGame :: GetBytesReceived( )
+{
+	uint64_t Bytes = 0;
+
+	for( vector<CLoadClient *> :: iterator i = m_Clients.begin( ); i != m_Clients.end( ); i++ )
+		Bytes += (*i)->GetBytesReceived( );
+
+	return Bytes;
+}
@@ -0,0 +1,130 @@
+/*
+
+   Copyright [2008] [Trevor Hogan]
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+   CODE PORTED FROM THE ORIGINAL GHOST PROJECT: http://ghost.pwner.org/
+
+*/
+
+#ifndef LOADCLIENT_H
+#define LOADCLIENT_H
+
+#define LOADCLIENT_CONNECTING	0
+#define LOADCLIENT_LOBBY		1
+#define LOADCLIENT_LOADING		2
+#define LOADCLIENT_PLAYING		3
+#define LOADCLIENT_DONE			4
+#define LOADCLIENT_FAILED		5
+
+//
+// CLoadScript
+//
+
+// the recorded action stream of a single player in a replay
+// m_Actions is sorted by game time (the sum of all the time slot increments before the action was played)
+
+class CLoadScript
+{
+public:
+	vector< pair<uint32_t, BYTEARRAY> > m_Actions;
+};
+
+// every player of a replay plus the checksums all players sent (in order)
+// we replay the same checksums for every fake client so GHost++ never sees a desync
+
+class CLoadReplay
+{
+public:
+	string m_File;
+	vector<CLoadScript> m_Scripts;
+	vector<uint32_t> m_CheckSums;
+	uint32_t m_Length;						// the game time of the last time slot in milliseconds
+
+	bool Load( string file );
+};
+
+//
+// CLoadClient
+//
+
+// a fake Warcraft III client which joins a GHost++ lobby over TCP, claims to have the map, loads instantly, and then plays back a CLoadScript
+// it answers every W3GS_INCOMING_ACTION with a W3GS_OUTGOING_KEEPALIVE just like a real client so the bot's sync logic sees a normal game
+
+class CLoadClient
+{
+private:
+	CTCPClient *m_Socket;
+	string m_Name;
+	unsigned char m_PID;
+	uint32_t m_State;
+	CLoadScript *m_Script;
+	vector<uint32_t> *m_CheckSums;
+	uint32_t m_NextAction;					// the next action in m_Script to send
+	uint32_t m_KeepAlives;					// the number of keepalives sent so far
+	uint32_t m_GameTime;					// the game time in milliseconds (the sum of all the send intervals received so far)
+	uint32_t m_Duration;					// leave the game after this much game time in milliseconds (0 = after the script ends)
+	uint64_t m_LastActionMicroTicks;		// GetMicroTicks when the last W3GS_INCOMING_ACTION was received
+	CHistogram *m_TickJitter;				// the difference between the expected and actual time between W3GS_INCOMING_ACTION packets (in milliseconds)
+	uint64_t m_BytesSent;
+	uint64_t m_BytesReceived;
+	uint32_t m_Ticks;						// the number of W3GS_INCOMING_ACTION packets received
+
+public:
+	CLoadClient( string nName, CLoadScript *nScript, vector<uint32_t> *nCheckSums, uint32_t nDuration, CHistogram *nTickJitter );
+	~CLoadClient( );
+
+	string GetName( )						{ return m_Name; }
+	uint32_t GetState( )					{ return m_State; }
+	uint64_t GetBytesSent( )				{ return m_BytesSent; }
+	uint64_t GetBytesReceived( )			{ return m_BytesReceived; }
+	uint32_t GetTicks( )					{ return m_Ticks; }
+
+	void Connect( string address, uint16_t port );
+	unsigned int SetFD( void *fd, void *send_fd, int *nfds );
+	void Update( void *fd, void *send_fd );
+
+private:
+	void ProcessPacket( BYTEARRAY &packet );
+	void Send( BYTEARRAY packet );
+	void SendDueActions( );
+	void Leave( );
+};
+
+//
+// CLoadGame
+//
+
+class CLoadGame
+{
+public:
+	uint32_t m_ID;
+	CLoadReplay *m_Replay;
+	vector<CLoadClient *> m_Clients;
+	CHistogram m_TickJitter;
+	uint32_t m_StartedTicks;				// GetTicks when the first client connected
+	uint32_t m_LoadedTicks;					// GetTicks when every client had received W3GS_COUNTDOWN_END (0 = not yet)
+	uint32_t m_FinishedTicks;				// GetTicks when every client had left (0 = not yet)
+
+	CLoadGame( uint32_t nID, CLoadReplay *nReplay );
+	~CLoadGame( );
+
+	bool GetStarted( );
+	bool GetFinished( );
+	bool GetFailed( );
+	uint64_t GetBytesSent( );
+	uint64_t GetBytesReceived( );
+};
+
+#endif
@@ -0,0 +1,123 @@
+/*
+
+   Copyright [2008] [Trevor Hogan]
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+   CODE PORTED FROM THE ORIGINAL GHOST PROJECT: http://ghost.pwner.org/
+
+*/
+
+#include "ghost.h"
+#include "util.h"
+#include "crc32.h"
+#include "selftest.h"
+
+//
+// crc32
+//
+
+// slice-by-8 and PCLMULQDQ folding against the byte at a time table they replaced
+// every length up to 4KB is checked at every alignment within a word and with random starting CRCs, as well as map sized buffers split into random chunks
+
+uint32_t SelfTestCRC32( )
+{
+	uint32_t Failed = 0;
+	CCRC32 CRC;
+	CRC.Initialize( );
+	bool Fold = CRC.SetImplementation( CRC32_FOLD );
+
+	if( !Fold )
+		CONSOLE_Print( "[CRC32] the CPU doesn't support PCLMULQDQ, only checking slice-by-8" );
+
+	// the check value every CRC-32 implementation is expected to produce
+
+	unsigned char Check[] = "123456789";
+	CRC.SetImplementation( CRC32_TABLE );
+	Failed += SelfTestCheck( CRC.FullCRC( Check, 9 ) == 0xCBF43926, "CRC32", "table check value" );
+	CRC.SetImplementation( CRC32_SLICE8 );
+	Failed += SelfTestCheck( CRC.FullCRC( Check, 9 ) == 0xCBF43926, "CRC32", "slice-by-8 check value" );
+
+	if( Fold )
+	{
+		CRC.SetImplementation( CRC32_FOLD );
+		Failed += SelfTestCheck( CRC.FullCRC( Check, 9 ) == 0xCBF43926, "CRC32", "fold check value" );
+	}
+
+	uint32_t Size = 4 * 1024 * 1024;
+	vector<unsigned char> Data( Size + 16 );
+
+	for( uint32_t i = 0; i < Data.size( ); i++ )
+		Data[i] = (unsigned char)SelfTestRandom( );
+
+	for( uint32_t Length = 0; Length <= 4096; Length++ )
+	{
+		for( uint32_t Offset = 0; Offset < 8; Offset++ )
+		{
+			uint32_t Initial = SelfTestRandom( );
+			uint32_t Expected = Initial;
+			uint32_t Slice8 = Initial;
+			CRC.PartialCRCTable( &Expected, &Data[Offset], Length );
+			CRC.PartialCRCSlice8( &Slice8, &Data[Offset], Length );
+			Failed += SelfTestCheck( Slice8 == Expected, "CRC32", "slice-by-8 length " + UTIL_ToString( Length ) + " offset " + UTIL_ToString( Offset ) );
+
+			if( Fold )
+			{
+				uint32_t Folded = Initial;
+				CRC.PartialCRCFold( &Folded, &Data[Offset], Length );
+				Failed += SelfTestCheck( Folded == Expected, "CRC32", "fold length " + UTIL_ToString( Length ) + " offset " + UTIL_ToString( Offset ) );
+			}
+		}
+	}
+
+	// a whole buffer in one call must match the same buffer fed in random chunks (this is how map data is checksummed)
+
+	uint32_t Expected = 0xFFFFFFFF;
+	CRC.PartialCRCTable( &Expected, &Data[0], Size );
+
+	for( uint32_t Implementation = CRC32_SLICE8; Implementation <= ( Fold ? CRC32_FOLD : CRC32_SLICE8 ); Implementation++ )
+	{
+		CRC.SetImplementation( Implementation );
+		uint32_t Chunked = 0xFFFFFFFF;
+
+		for( uint32_t Position = 0; Position < Size; )
+		{
+			uint32_t Length = min( SelfTestRandom( ) % 70000, Size - Position );
+			CRC.PartialCRC( &Chunked, &Data[Position], Length );
+			Position += Length;
+		}
+
+		Failed += SelfTestCheck( Chunked == Expected, "CRC32", "chunked implementation " + UTIL_ToString( Implementation ) );
+	}
+
+	// benchmark
+
+	string Rates;
+
+	for( uint32_t Implementation = CRC32_TABLE; Implementation <= ( Fold ? CRC32_FOLD : CRC32_SLICE8 ); Implementation++ )
+	{
+		CRC.SetImplementation( Implementation );
+		uint64_t StartTicks = GetMicroTicks( );
+		uint32_t Result = 0;
+
+		for( uint32_t i = 0; i < 8; i++ )
+			Result ^= CRC.FullCRC( &Data[0], Size );
+
+		uint64_t Ticks = GetMicroTicks( ) - StartTicks;
+		Failed += SelfTestCheck( Result == 0, "CRC32", "benchmark result" );
+		Rates += ( Rates.empty( ) ? "" : ", " ) + SelfTestRate( Implementation == CRC32_TABLE ? "table" : ( Implementation == CRC32_SLICE8 ? "slice-by-8" : "fold" ), (uint64_t)Size * 8, Ticks );
+	}
+
+	CONSOLE_Print( "[CRC32] " + Rates );
+	return Failed;
+}
@@ -0,0 +1,361 @@
+/*
+
+   Copyright [2008] [Trevor Hogan]
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+   CODE PORTED FROM THE ORIGINAL GHOST PROJECT: http://ghost.pwner.org/
+
+*/
+
+#include "ghost.h"
+#include "util.h"
+#include "packed.h"
+#include "replay.h"
+#include "stats.h"
+#include "selftest.h"
+
+#include <string.h>
+
+//
+// decoder
+//
+
+// CActionDecoder against the signature scan the DotA and W3MMD parsers used before it
+// the scan looked for the cache name followed by two null terminated strings and a 4 byte value anywhere in the block (the DotA scan also required the 0x6B in front)
+// on blocks built only from well formed actions the two must find exactly the same sync stored integers
+// payloads which happen to contain the signature are found by the scan but must be ignored by the decoder
+// replays given on the command line are checked too, there the decoder must find a subset of what the scan finds (the rest are lookalikes)
+
+static void ScanSyncStoredIntegers( BYTEARRAY &action, string cache, bool requireID, vector<string> &integers )
+{
+	BYTEARRAY Signature;
+
+	if( requireID )
+		Signature.push_back( 0x6B );
+
+	UTIL_AppendByteArray( Signature, cache );
+	unsigned int i = 0;
+
+	while( action.size( ) >= i + Signature.size( ) )
+	{
+		if( equal( Signature.begin( ), Signature.end( ), action.begin( ) + i ) )
+		{
+			unsigned int Position = i + Signature.size( );
+
+			if( action.size( ) >= Position + 1 )
+			{
+				BYTEARRAY MissionKey = UTIL_ExtractCString( action, Position );
+
+				if( action.size( ) >= Position + 2 + MissionKey.size( ) )
+				{
+					BYTEARRAY Key = UTIL_ExtractCString( action, Position + 1 + MissionKey.size( ) );
+
+					if( action.size( ) >= Position + 6 + MissionKey.size( ) + Key.size( ) )
+					{
+						uint32_t Value = UTIL_ByteArrayToUInt32( action, false, Position + 2 + MissionKey.size( ) + Key.size( ) );
+						integers.push_back( string( MissionKey.begin( ), MissionKey.end( ) ) + "/" + string( Key.begin( ), Key.end( ) ) + "/" + UTIL_ToString( Value ) );
+						i = Position + 6 + MissionKey.size( ) + Key.size( );
+						continue;
+					}
+				}
+			}
+		}
+
+		i++;
+	}
+}
+
+static void DecodeSyncStoredIntegers( BYTEARRAY &action, string cache, vector<string> &integers )
+{
+	vector<CSyncStoredInteger> Integers;
+	CActionDecoder :: Decode( action, cache.c_str( ), Integers );
+
+	for( vector<CSyncStoredInteger> :: iterator i = Integers.begin( ); i != Integers.end( ); i++ )
+		integers.push_back( string( i->m_MissionKey ) + "/" + string( i->m_Key ) + "/" + UTIL_ToString( i->m_Value ) );
+}
+
+static bool IsSubsequence( vector<string> &a, vector<string> &b )
+{
+	unsigned int j = 0;
+
+	for( unsigned int i = 0; i < a.size( ); i++ )
+	{
+		while( j < b.size( ) && b[j] != a[i] )
+			j++;
+
+		if( j == b.size( ) )
+			return false;
+
+		j++;
+	}
+
+	return true;
+}
+
+static void AppendRandom( BYTEARRAY &b, uint32_t length, bool lookalikes )
+{
+	// without lookalikes the payload never contains 0x6B so it can't contain a signature (every signature starts with 0x6B, 'k' is 0x6B too)
+
+	for( uint32_t i = 0; i < length; i++ )
+	{
+		unsigned char c = (unsigned char)SelfTestRandom( );
+
+		if( !lookalikes && c == 0x6B )
+			c = 0x6A;
+
+		b.push_back( c );
+	}
+}
+
+static void AppendSyncStoredInteger( BYTEARRAY &b, string cache, string missionKey, string key, uint32_t value )
+{
+	b.push_back( 0x6B );
+	UTIL_AppendByteArray( b, cache );
+	UTIL_AppendByteArray( b, missionKey );
+	UTIL_AppendByteArray( b, key );
+	UTIL_AppendByteArray( b, value, false );
+}
+
+static BYTEARRAY MakeActionBlock( bool lookalikes, bool unknown )
+{
+	// a mix of the actions seen most often in real games, each with the length documented in w3g_actions.txt
+
+	BYTEARRAY b;
+	uint32_t Actions = 1 + SelfTestRandom( ) % 4;
+
+	for( uint32_t i = 0; i < Actions; i++ )
+	{
+		uint32_t Type = SelfTestRandom( ) % 100;
+
+		if( Type < 30 )
+		{
+			uint16_t Units = 1 + SelfTestRandom( ) % 12;
+			b.push_back( 0x16 );
+			b.push_back( 1 + SelfTestRandom( ) % 2 );
+			UTIL_AppendByteArray( b, Units, false );
+			AppendRandom( b, 8 * Units, lookalikes );
+		}
+		else if( Type < 55 )
+		{
+			unsigned char Lengths[] = { 14, 22, 30, 38, 43 };
+			unsigned char ID = 0x10 + SelfTestRandom( ) % 5;
+			b.push_back( ID );
+			AppendRandom( b, Lengths[ID - 0x10], lookalikes );
+		}
+		else if( Type < 65 )
+		{
+			b.push_back( 0x19 );
+			AppendRandom( b, 12, lookalikes );
+		}
+		else if( Type < 72 )
+		{
+			b.push_back( 0x18 );
+			AppendRandom( b, 2, lookalikes );
+		}
+		else if( Type < 76 )
+		{
+			b.push_back( 0x60 );
+			AppendRandom( b, 8, lookalikes );
+			UTIL_AppendByteArray( b, string( "-ar" ) );
+		}
+		else if( Type < 84 )
+			AppendSyncStoredInteger( b, "dr.x", SelfTestRandom( ) % 2 ? "Data" : UTIL_ToString( 1 + SelfTestRandom( ) % 11 ), "Hero" + UTIL_ToString( SelfTestRandom( ) % 12 ), SelfTestRandom( ) % 12 );
+		else if( Type < 92 )
+			AppendSyncStoredInteger( b, "kMMD.Dat", "val:" + UTIL_ToString( SelfTestRandom( ) % 100 ), "init pid " + UTIL_ToString( SelfTestRandom( ) % 12 ) + " Varlock", SelfTestRandom( ) % 100 );
+		else if( Type < 94 )
+			AppendSyncStoredInteger( b, "other", "Data", "Hero1", 1 );
+		else if( Type < 97 && lookalikes )
+		{
+			// an ability whose payload looks like a sync stored integer
+
+			BYTEARRAY Fake;
+			AppendSyncStoredInteger( Fake, SelfTestRandom( ) % 2 ? "dr.x" : "kMMD.Dat", "Data", "Hero99", 777 );
+			Fake.resize( 43, 0 );
+			b.push_back( 0x14 );
+			UTIL_AppendByteArray( b, Fake );
+		}
+		else if( unknown )
+		{
+			// an action we don't know the length of, the decoder has to resynchronize on the next sync stored integer
+
+			b.push_back( 0x99 );
+			AppendRandom( b, SelfTestRandom( ) % 20, false );
+		}
+		else
+			b.push_back( 0x61 );
+	}
+
+	return b;
+}
+
+uint32_t SelfTestDecoder( )
+{
+	uint32_t Failed = 0;
+	CActionDecoder :: Initialize( );
+	string Caches[] = { "dr.x", "kMMD.Dat" };
+
+	// well formed blocks, with and without unknown actions: the decoder and the scan must agree exactly
+
+	uint32_t Found = 0;
+
+	for( uint32_t i = 0; i < 100000; i++ )
+	{
+		BYTEARRAY Block = MakeActionBlock( false, i % 4 == 0 );
+
+		for( int j = 0; j < 2; j++ )
+		{
+			vector<string> Decoded;
+			vector<string> Scanned;
+			DecodeSyncStoredIntegers( Block, Caches[j], Decoded );
+			ScanSyncStoredIntegers( Block, Caches[j], j == 0, Scanned );
+			Failed += SelfTestCheck( Decoded == Scanned, "DECODER", Caches[j] + " block " + UTIL_ToString( i ) + " [" + UTIL_ByteArrayToHexString( Block ) + "]" );
+			Found += Decoded.size( );
+		}
+	}
+
+	Failed += SelfTestCheck( Found > 0, "DECODER", "no sync stored integers were generated" );
+
+	// blocks with lookalike payloads: the decoder must only find the real integers (which the scan also finds)
+
+	uint32_t Lookalikes = 0;
+
+	for( uint32_t i = 0; i < 100000; i++ )
+	{
+		BYTEARRAY Block = MakeActionBlock( true, false );
+
+		for( int j = 0; j < 2; j++ )
+		{
+			vector<string> Decoded;
+			vector<string> Scanned;
+			DecodeSyncStoredIntegers( Block, Caches[j], Decoded );
+			ScanSyncStoredIntegers( Block, Caches[j], j == 0, Scanned );
+			Failed += SelfTestCheck( IsSubsequence( Decoded, Scanned ), "DECODER", Caches[j] + " lookalike block " + UTIL_ToString( i ) );
+
+			for( vector<string> :: iterator k = Decoded.begin( ); k != Decoded.end( ); k++ )
+				Failed += SelfTestCheck( *k != "Data/Hero99/777", "DECODER", Caches[j] + " decoded a lookalike in block " + UTIL_ToString( i ) );
+
+			Lookalikes += Scanned.size( ) - Decoded.size( );
+		}
+	}
+
+	CONSOLE_Print( "[DECODER] the signature scan reported " + UTIL_ToString( Lookalikes ) + " lookalikes the decoder ignored" );
+
+	// truncated blocks must be rejected without reading past the end
+
+	for( uint32_t i = 0; i < 20000; i++ )
+	{
+		BYTEARRAY Block = MakeActionBlock( true, true );
+		Block.resize( SelfTestRandom( ) % ( Block.size( ) + 1 ) );
+		vector<CSyncStoredInteger> Integers;
+		CActionDecoder :: Decode( Block, "dr.x", Integers );
+	}
+
+	// replays
+
+	vector<string> Replays = SelfTestGetReplays( );
+	uint32_t ReplayBlocks = 0;
+	uint32_t ReplayIntegers = 0;
+	uint32_t ReplayLookalikes = 0;
+
+	for( vector<string> :: iterator i = Replays.begin( ); i != Replays.end( ); i++ )
+	{
+		CReplay Replay;
+		Replay.Load( *i, true );
+
+		if( Replay.GetValid( ) )
+			Replay.ParseReplay( true );
+
+		if( !Replay.GetValid( ) )
+		{
+			Failed += SelfTestCheck( false, "DECODER", "unable to load replay [" + *i + "]" );
+			continue;
+		}
+
+		// time slot block: 1 byte ID, 2 bytes size, 2 bytes time increment, then for each player: 1 byte PID, 2 bytes length, action data
+
+		queue<BYTEARRAY> *Blocks = Replay.GetBlocks( );
+
+		while( !Blocks->empty( ) )
+		{
+			BYTEARRAY Block = Blocks->front( );
+			Blocks->pop( );
+
+			if( Block.size( ) < 5 || Block[0] != CReplay :: REPLAY_TIMESLOT )
+				continue;
+
+			unsigned int j = 5;
+
+			while( j + 3 <= Block.size( ) )
+			{
+				uint16_t ActionSize = UTIL_ByteArrayToUInt16( Block, false, j + 1 );
+				j += 3;
+
+				if( j + ActionSize > Block.size( ) )
+					break;
+
+				BYTEARRAY Action( Block.begin( ) + j, Block.begin( ) + j + ActionSize );
+				j += ActionSize;
+				ReplayBlocks++;
+
+				for( int k = 0; k < 2; k++ )
+				{
+					vector<string> Decoded;
+					vector<string> Scanned;
+					DecodeSyncStoredIntegers( Action, Caches[k], Decoded );
+					ScanSyncStoredIntegers( Action, Caches[k], k == 0, Scanned );
+					Failed += SelfTestCheck( IsSubsequence( Decoded, Scanned ), "DECODER", *i + " " + Caches[k] + " [" + UTIL_ByteArrayToHexString( Action ) + "]" );
+					ReplayIntegers += Decoded.size( );
+					ReplayLookalikes += Scanned.size( ) - Decoded.size( );
+				}
+			}
+		}
+	}
+
+	if( !Replays.empty( ) )
+		CONSOLE_Print( "[DECODER] " + UTIL_ToString( Replays.size( ) ) + " replays, " + UTIL_ToString( ReplayBlocks ) + " action blocks, " + UTIL_ToString( ReplayIntegers ) + " sync stored integers, " + UTIL_ToString( ReplayLookalikes ) + " lookalikes" );
+
+	// benchmark
+
+	vector<BYTEARRAY> Blocks;
+
+	for( uint32_t i = 0; i < 100000; i++ )
+		Blocks.push_back( MakeActionBlock( false, false ) );
+
+	uint64_t StartTicks = GetMicroTicks( );
+	uint32_t DecodedCount = 0;
+	vector<CSyncStoredInteger> Integers;
+
+	for( vector<BYTEARRAY> :: iterator i = Blocks.begin( ); i != Blocks.end( ); i++ )
+	{
+		Integers.clear( );
+		CActionDecoder :: Decode( *i, "dr.x", Integers );
+		DecodedCount += Integers.size( );
+	}
+
+	uint64_t DecoderTicks = GetMicroTicks( ) - StartTicks;
+	StartTicks = GetMicroTicks( );
+	uint32_t ScannedCount = 0;
+
+	for( vector<BYTEARRAY> :: iterator i = Blocks.begin( ); i != Blocks.end( ); i++ )
+	{
+		vector<string> Scanned;
+		ScanSyncStoredIntegers( *i, "dr.x", true, Scanned );
+		ScannedCount += Scanned.size( );
+	}
+
+	uint64_t ScanTicks = GetMicroTicks( ) - StartTicks;
+	Failed += SelfTestCheck( DecodedCount == ScannedCount, "DECODER", "benchmark counts" );
+	CONSOLE_Print( "[DECODER] per action block: " + SelfTestNanoseconds( "decoder", Blocks.size( ), DecoderTicks ) + ", " + SelfTestNanoseconds( "signature scan", Blocks.size( ), ScanTicks ) );
+	return Failed;
+}
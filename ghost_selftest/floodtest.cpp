@@ -0,0 +1,137 @@
+/*
+
+   Copyright [2008] [Trevor Hogan]
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+   CODE PORTED FROM THE ORIGINAL GHOST PROJECT: http://ghost.pwner.org/
+
+*/
+#include "ghost.h"
+#include "util.h"
+#include "floodcontrol.h"
+#include "selftest.h"
+
+//
+// flood
+//
+
+// the flood control token bucket with the default settings against the fixed delays CBNET used before
+// the old code waited 1 second after a packet under 10 bytes, 3.5 seconds after a packet under 100 bytes and 4 seconds after anything longer
+// the bucket may send short messages sooner than that but must never make any message wait longer
+
+static uint32_t OldDelay( uint32_t size )
+{
+	if( size < 10 )
+		return 1000;
+	else if( size < 100 )
+		return 3500;
+	else
+		return 4000;
+}
+
+// how long the next packet has to wait, advancing the clock 1ms at a time like the main loop does
+
+static uint32_t WaitFor( CFloodControl &Flood, uint32_t &Ticks )
+{
+	uint32_t Waited = 0;
+	Flood.Refill( Ticks );
+
+	while( !Flood.CanSend( ) && Waited < 60000 )
+	{
+		Ticks++;
+		Waited++;
+		Flood.Refill( Ticks );
+	}
+
+	return Waited;
+}
+
+uint32_t SelfTestFlood( )
+{
+	uint32_t Failed = 0;
+	uint32_t Sizes[] = { 5, 9, 10, 25, 60, 99, 100, 150, 260 };
+	uint32_t NumSizes = sizeof( Sizes ) / sizeof( Sizes[0] );
+	string Delays;
+
+	// a long run of packets of the same size, the steady state delay is what a user sees when the queue is full
+
+	for( uint32_t i = 0; i < NumSizes; i++ )
+	{
+		uint32_t Ticks = 0xFFFFFFFF - 30000;
+		CFloodControl Flood( 36, 60, 25, Ticks );
+		Flood.Reset( Ticks );
+		uint32_t Delay = 0;
+
+		for( uint32_t j = 0; j < 20; j++ )
+		{
+			Delay = WaitFor( Flood, Ticks );
+			Flood.Sent( Sizes[i] );
+		}
+
+		Failed += SelfTestCheck( Delay <= OldDelay( Sizes[i] ) + 1, "FLOOD", "a " + UTIL_ToString( Sizes[i] ) + " byte packet waited " + UTIL_ToString( Delay ) + "ms, the old delay was " + UTIL_ToString( OldDelay( Sizes[i] ) ) + "ms" );
+
+		if( Sizes[i] >= 100 )
+			Failed += SelfTestCheck( Delay >= 3000, "FLOOD", "a " + UTIL_ToString( Sizes[i] ) + " byte packet only waited " + UTIL_ToString( Delay ) + "ms" );
+
+		Delays += " " + UTIL_ToString( Sizes[i] ) + "b=" + UTIL_ToString( Delay ) + "ms";
+	}
+
+	// any packet after any other packet, the old delay only depended on the previous packet
+
+	for( uint32_t i = 0; i < NumSizes; i++ )
+	{
+		for( uint32_t j = 0; j < NumSizes; j++ )
+		{
+			uint32_t Ticks = 1000;
+			CFloodControl Flood( 36, 60, 25, Ticks );
+			Flood.Reset( Ticks );
+
+			// drain the bucket first so the previous packet was sent at the earliest possible moment
+
+			for( uint32_t k = 0; k < 5; k++ )
+			{
+				WaitFor( Flood, Ticks );
+				Flood.Sent( Sizes[i] );
+			}
+
+			uint32_t Delay = WaitFor( Flood, Ticks );
+			Failed += SelfTestCheck( Delay <= OldDelay( Sizes[i] ) + 1, "FLOOD", "a " + UTIL_ToString( Sizes[j] ) + " byte packet after a " + UTIL_ToString( Sizes[i] ) + " byte packet waited " + UTIL_ToString( Delay ) + "ms, the old delay was " + UTIL_ToString( OldDelay( Sizes[i] ) ) + "ms" );
+		}
+	}
+
+	// a 255 character whisper is the worst case, it costs more than the whole bucket
+
+	uint32_t Ticks = 0;
+	CFloodControl Flood( 36, 60, 25, Ticks );
+	Flood.Reset( Ticks );
+	Flood.Sent( 260 );
+	uint32_t Delay = WaitFor( Flood, Ticks );
+	Failed += SelfTestCheck( Delay <= 4001, "FLOOD", "a short packet after a 260 byte packet waited " + UTIL_ToString( Delay ) + "ms" );
+
+	// after being idle a few short messages go out at once
+
+	Ticks += 60000;
+	Flood.Refill( Ticks );
+	uint32_t Burst = 0;
+
+	while( Flood.CanSend( ) )
+	{
+		Flood.Sent( 9 );
+		Burst++;
+	}
+
+	Failed += SelfTestCheck( Burst >= 2, "FLOOD", "only " + UTIL_ToString( Burst ) + " short packets were sent at once after being idle" );
+	CONSOLE_Print( "[FLOOD] steady state delays with the default settings:" + Delays + ", " + UTIL_ToString( Burst ) + " short packets at once after being idle" );
+	return Failed;
+}
@@ -0,0 +1,310 @@
+/*
+
+   Copyright [2008] [Trevor Hogan]
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+   CODE PORTED FROM THE ORIGINAL GHOST PROJECT: http://ghost.pwner.org/
+
+*/
+
+#include "ghost.h"
+#include "util.h"
+#include "selftest.h"
+
+#include <cmath>
+#include <iomanip>
+
+//
+// format
+//
+
+// the UTIL_Format* and UTIL_Append* number formatting (and the UTIL_ToString family built on it) against the stringstreams they replaced
+// integers of every size are checked with random magnitudes and at their extremes, doubles with random magnitudes and precisions and the special values
+// the appending functions are called on strings which already have some content to make sure it's kept
+
+// the reference implementations, these are what util.cpp used to do
+
+template <class T> static string ReferenceToString( T i )
+{
+	string result;
+	stringstream SS;
+	SS << i;
+	SS >> result;
+	return result;
+}
+
+static string ReferenceToString( double d, int digits )
+{
+	string result;
+	stringstream SS;
+	SS << std :: fixed << std :: setprecision( digits ) << d;
+	SS >> result;
+	return result;
+}
+
+static string ReferenceToHexString( uint32_t i )
+{
+	string result;
+	stringstream SS;
+	SS << std :: hex << i;
+	SS >> result;
+	return result;
+}
+
+static string ReferenceUInt( uint64_t i, uint32_t width )
+{
+	stringstream SS;
+	SS << std :: setfill( '0' ) << std :: setw( width ) << i;
+	return SS.str( );
+}
+
+static string ReferenceInt( int64_t i, uint32_t width )
+{
+	if( i < 0 )
+		return "-" + ReferenceUInt( 0 - (uint64_t)i, width );
+
+	return ReferenceUInt( i, width );
+}
+
+static string ReferenceHex( uint32_t i, uint32_t width )
+{
+	stringstream SS;
+	SS << std :: hex << std :: setfill( '0' ) << std :: setw( width ) << i;
+	return SS.str( );
+}
+
+static string ReferenceMSToString( uint32_t ms )
+{
+	string MinString = ReferenceToString( ( ms / 1000 ) / 60 );
+	string SecString = ReferenceToString( ( ms / 1000 ) % 60 );
+
+	if( MinString.size( ) == 1 )
+		MinString.insert( 0, "0" );
+
+	if( SecString.size( ) == 1 )
+		SecString.insert( 0, "0" );
+
+	return MinString + "m" + SecString + "s";
+}
+
+static string ReferenceByteArrayToDecString( BYTEARRAY b )
+{
+	if( b.empty( ) )
+		return string( );
+
+	string result = ReferenceToString( (uint32_t)b[0] );
+
+	for( BYTEARRAY :: iterator i = b.begin( ) + 1; i != b.end( ); i++ )
+		result += " " + ReferenceToString( (uint32_t)*i );
+
+	return result;
+}
+
+static string ReferenceByteArrayToHexString( BYTEARRAY b )
+{
+	if( b.empty( ) )
+		return string( );
+
+	string result = ReferenceToHexString( b[0] );
+
+	for( BYTEARRAY :: iterator i = b.begin( ) + 1; i != b.end( ); i++ )
+	{
+		if( *i < 16 )
+			result += " 0" + ReferenceToHexString( *i );
+		else
+			result += " " + ReferenceToHexString( *i );
+	}
+
+	return result;
+}
+
+// a random 64 bit value with a random number of significant bits so every length of number turns up
+
+static uint64_t RandomValue( )
+{
+	uint64_t Value = ( (uint64_t)SelfTestRandom( ) << 32 ) | SelfTestRandom( );
+	return Value >> ( SelfTestRandom( ) % 64 );
+}
+
+static double RandomDouble( )
+{
+	double Mantissa = (double)SelfTestRandom( ) / 4294967296.0 + (double)SelfTestRandom( ) / 18446744073709551616.0;
+	double Value = ldexp( Mantissa, (int)( SelfTestRandom( ) % 300 ) - 150 );
+
+	// values which are exactly halfway between two outputs are the interesting ones for rounding
+
+	if( SelfTestRandom( ) % 8 == 0 )
+		Value = ( SelfTestRandom( ) % 200000 ) / 8.0;
+
+	return SelfTestRandom( ) % 2 ? -Value : Value;
+}
+
+static string RandomPrefix( )
+{
+	return string( SelfTestRandom( ) % 3, 'x' );
+}
+
+uint32_t SelfTestFormat( )
+{
+	uint32_t Failed = 0;
+	uint64_t Extremes[] = { 0, 1, 9, 10, 99, 100, 4294967295ULL, 4294967296ULL, 9223372036854775807ULL, 9223372036854775808ULL, 9999999999999999999ULL, 10000000000000000000ULL, 18446744073709551615ULL };
+	vector<uint64_t> Values( Extremes, Extremes + sizeof( Extremes ) / sizeof( uint64_t ) );
+
+	for( uint32_t i = 0; i < 200000; i++ )
+		Values.push_back( RandomValue( ) );
+
+	for( vector<uint64_t> :: iterator i = Values.begin( ); i != Values.end( ); i++ )
+	{
+		uint64_t Value = *i;
+		int64_t Signed = (int64_t)Value;
+		char Buffer[21];
+
+		// the buffer functions
+
+		string Expected = ReferenceToString( Value );
+		string Result( Buffer, UTIL_FormatUInt( Buffer, Value ) );
+		Failed += SelfTestCheck( Result == Expected, "FORMAT", "UTIL_FormatUInt " + Expected + " gave " + Result );
+		Expected = ReferenceToString( Signed );
+		Result = string( Buffer, UTIL_FormatInt( Buffer, Signed ) );
+		Failed += SelfTestCheck( Result == Expected, "FORMAT", "UTIL_FormatInt " + Expected + " gave " + Result );
+
+		// every UTIL_ToString overload sees the value truncated to its own type
+
+		Expected = ReferenceToString( (unsigned long)Value );
+		Result = UTIL_ToString( (unsigned long)Value );
+		Failed += SelfTestCheck( Result == Expected, "FORMAT", "UTIL_ToString( unsigned long ) " + Expected + " gave " + Result );
+		Expected = ReferenceToString( (unsigned int)Value );
+		Result = UTIL_ToString( (unsigned int)Value );
+		Failed += SelfTestCheck( Result == Expected, "FORMAT", "UTIL_ToString( unsigned int ) " + Expected + " gave " + Result );
+		Expected = ReferenceToString( (unsigned short)Value );
+		Result = UTIL_ToString( (unsigned short)Value );
+		Failed += SelfTestCheck( Result == Expected, "FORMAT", "UTIL_ToString( unsigned short ) " + Expected + " gave " + Result );
+		Expected = ReferenceToString( (long)Value );
+		Result = UTIL_ToString( (long)Value );
+		Failed += SelfTestCheck( Result == Expected, "FORMAT", "UTIL_ToString( long ) " + Expected + " gave " + Result );
+		Expected = ReferenceToString( (int)Value );
+		Result = UTIL_ToString( (int)Value );
+		Failed += SelfTestCheck( Result == Expected, "FORMAT", "UTIL_ToString( int ) " + Expected + " gave " + Result );
+		Expected = ReferenceToString( (short)Value );
+		Result = UTIL_ToString( (short)Value );
+		Failed += SelfTestCheck( Result == Expected, "FORMAT", "UTIL_ToString( short ) " + Expected + " gave " + Result );
+		Expected = ReferenceToHexString( (uint32_t)Value );
+		Result = UTIL_ToHexString( (uint32_t)Value );
+		Failed += SelfTestCheck( Result == Expected, "FORMAT", "UTIL_ToHexString " + Expected + " gave " + Result );
+
+		// the appending functions with and without padding
+
+		uint32_t Width = SelfTestRandom( ) % 4 == 0 ? 0 : SelfTestRandom( ) % 24;
+		string Prefix = RandomPrefix( );
+		Expected = Prefix + ReferenceUInt( Value, Width );
+		Result = Prefix;
+		UTIL_AppendUInt( Result, Value, Width );
+		Failed += SelfTestCheck( Result == Expected, "FORMAT", "UTIL_AppendUInt width " + UTIL_ToString( Width ) + " " + Expected + " gave " + Result );
+		Expected = Prefix + ReferenceInt( Signed, Width );
+		Result = Prefix;
+		UTIL_AppendInt( Result, Signed, Width );
+		Failed += SelfTestCheck( Result == Expected, "FORMAT", "UTIL_AppendInt width " + UTIL_ToString( Width ) + " " + Expected + " gave " + Result );
+		Width %= 12;
+		Expected = Prefix + ReferenceHex( (uint32_t)Value, Width );
+		Result = Prefix;
+		UTIL_AppendHex( Result, (uint32_t)Value, Width );
+		Failed += SelfTestCheck( Result == Expected, "FORMAT", "UTIL_AppendHex width " + UTIL_ToString( Width ) + " " + Expected + " gave " + Result );
+	}
+
+	// doubles, including values too long for the stack buffer in UTIL_AppendDouble
+
+	vector<double> Doubles;
+	Doubles.push_back( 0.0 );
+	Doubles.push_back( -0.0 );
+	Doubles.push_back( 0.005 );
+	Doubles.push_back( 0.015 );
+	Doubles.push_back( 1000.125 );
+	Doubles.push_back( 1e300 );
+	Doubles.push_back( -1e300 );
+	Doubles.push_back( HUGE_VAL );
+	Doubles.push_back( -HUGE_VAL );
+
+	for( uint32_t i = 0; i < 100000; i++ )
+		Doubles.push_back( RandomDouble( ) );
+
+	for( vector<double> :: iterator i = Doubles.begin( ); i != Doubles.end( ); i++ )
+	{
+		int Digits = SelfTestRandom( ) % 8;
+		string Expected = ReferenceToString( *i, Digits );
+		string Result = UTIL_ToString( *i, Digits );
+		Failed += SelfTestCheck( Result == Expected, "FORMAT", "UTIL_ToString( double, " + UTIL_ToString( Digits ) + " ) " + Expected + " gave " + Result );
+		Expected = ReferenceToString( (double)(float)*i, Digits );
+		Result = UTIL_ToString( (float)*i, Digits );
+		Failed += SelfTestCheck( Result == Expected, "FORMAT", "UTIL_ToString( float, " + UTIL_ToString( Digits ) + " ) " + Expected + " gave " + Result );
+		string Prefix = RandomPrefix( );
+		Expected = Prefix + ReferenceToString( *i, Digits );
+		Result = Prefix;
+		UTIL_AppendDouble( Result, *i, Digits );
+		Failed += SelfTestCheck( Result == Expected, "FORMAT", "UTIL_AppendDouble " + Expected + " gave " + Result );
+	}
+
+	// the functions built on top of the formatting
+
+	for( uint32_t i = 0; i < 100000; i++ )
+	{
+		uint32_t MS = i < 50000 ? i * 1000 + SelfTestRandom( ) % 1000 : SelfTestRandom( );
+		string Expected = ReferenceMSToString( MS );
+		string Result = UTIL_MSToString( MS );
+		Failed += SelfTestCheck( Result == Expected, "FORMAT", "UTIL_MSToString " + Expected + " gave " + Result );
+	}
+
+	BYTEARRAY Bytes;
+
+	for( uint32_t i = 0; i < 256; i++ )
+		Bytes.push_back( (unsigned char)i );
+
+	Failed += SelfTestCheck( UTIL_ByteArrayToDecString( Bytes ) == ReferenceByteArrayToDecString( Bytes ), "FORMAT", "UTIL_ByteArrayToDecString every byte" );
+	Failed += SelfTestCheck( UTIL_ByteArrayToHexString( Bytes ) == ReferenceByteArrayToHexString( Bytes ), "FORMAT", "UTIL_ByteArrayToHexString every byte" );
+	Failed += SelfTestCheck( UTIL_ByteArrayToDecString( BYTEARRAY( ) ).empty( ), "FORMAT", "UTIL_ByteArrayToDecString empty" );
+	Failed += SelfTestCheck( UTIL_ByteArrayToHexString( BYTEARRAY( ) ).empty( ), "FORMAT", "UTIL_ByteArrayToHexString empty" );
+
+	// benchmark
+
+	uint32_t Operations = 1000000;
+	uint32_t Check = 0;
+	uint64_t StartTicks = GetMicroTicks( );
+
+	for( uint32_t i = 0; i < Operations; i++ )
+		Check += ReferenceToString( i * 2654435761U ).size( );
+
+	uint64_t StreamTicks = GetMicroTicks( ) - StartTicks;
+	StartTicks = GetMicroTicks( );
+
+	for( uint32_t i = 0; i < Operations; i++ )
+		Check -= UTIL_ToString( i * 2654435761U ).size( );
+
+	uint64_t FormatTicks = GetMicroTicks( ) - StartTicks;
+	Failed += SelfTestCheck( Check == 0, "FORMAT", "benchmark result" );
+	StartTicks = GetMicroTicks( );
+
+	for( uint32_t i = 0; i < Operations; i++ )
+		Check += ReferenceToString( i / 7.0, 2 ).size( );
+
+	uint64_t DoubleStreamTicks = GetMicroTicks( ) - StartTicks;
+	StartTicks = GetMicroTicks( );
+
+	for( uint32_t i = 0; i < Operations; i++ )
+		Check -= UTIL_ToString( i / 7.0, 2 ).size( );
+
+	uint64_t DoubleFormatTicks = GetMicroTicks( ) - StartTicks;
+	Failed += SelfTestCheck( Check == 0, "FORMAT", "double benchmark result" );
+	CONSOLE_Print( "[FORMAT] integer: " + SelfTestNanoseconds( "stringstream", Operations, StreamTicks ) + ", " + SelfTestNanoseconds( "UTIL_ToString", Operations, FormatTicks ) );
+	CONSOLE_Print( "[FORMAT] double (2 digits): " + SelfTestNanoseconds( "stringstream", Operations, DoubleStreamTicks ) + ", " + SelfTestNanoseconds( "UTIL_ToString", Operations, DoubleFormatTicks ) );
+	return Failed;
+}
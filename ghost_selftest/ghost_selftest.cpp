@@ -0,0 +1,190 @@
+/*
+
+   Copyright [2008] [Trevor Hogan]
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+   CODE PORTED FROM THE ORIGINAL GHOST PROJECT: http://ghost.pwner.org/
+
+*/
+
+// ghost_selftest checks the optimized code paths of GHost++ against the implementations they replaced and prints a quick benchmark of each
+// run it without arguments to run every suite or with the names of the suites to run, it exits with a non zero status if any check failed
+// any .w3g files on the command line are used as extra input by the suites which can use recorded games (e.g. decoder)
+
+#include "ghost.h"
+#include "util.h"
+#include "selftest.h"
+
+#include <time.h>
+
+#ifdef WIN32
+ #include <windows.h>
+#endif
+
+void LOG_Print( uint32_t level, string message )
+{
+	cout << message << endl;
+}
+
+bool gSilent = false;
+
+void CONSOLE_Print( string message )
+{
+	if( !gSilent )
+		LOG_Print( LOG_INFO, message );
+}
+
+void DEBUG_Print( string message )
+{
+	LOG_Print( LOG_DEBUG, message );
+}
+
+void DEBUG_Print( BYTEARRAY b )
+{
+	DEBUG_Print( UTIL_ByteArrayToHexString( b ) );
+}
+
+uint32_t GetTime( )
+{
+	return GetTicks( ) / 1000;
+}
+
+uint32_t GetTicks( )
+{
+	return (uint32_t)( GetMicroTicks( ) / 1000 );
+}
+
+uint64_t GetMicroTicks( )
+{
+#ifdef WIN32
+	static LARGE_INTEGER Frequency = { 0 };
+	LARGE_INTEGER Counter;
+
+	if( Frequency.QuadPart == 0 )
+		QueryPerformanceFrequency( &Frequency );
+
+	QueryPerformanceCounter( &Counter );
+	return (uint64_t)( Counter.QuadPart / ( Frequency.QuadPart / 1000000.0 ) );
+#else
+	struct timespec t;
+	clock_gettime( CLOCK_MONOTONIC, &t );
+	return (uint64_t)t.tv_sec * 1000000 + t.tv_nsec / 1000;
+#endif
+}
+
+uint32_t gFailures = 0;
+uint32_t gSeed = 1;
+vector<string> gReplays;
+
+uint32_t SelfTestCheck( bool condition, string suite, string message )
+{
+	if( condition )
+		return 0;
+
+	// don't flood the console when something is badly broken, the count at the end is enough
+	// failures are printed even while the suite has silenced the console
+
+	if( gFailures++ < 20 )
+		LOG_Print( LOG_INFO, "[" + suite + "] FAILED: " + message );
+
+	return 1;
+}
+
+uint32_t SelfTestRandom( )
+{
+	// xorshift32, the suites need reproducible data rather than good randomness
+
+	gSeed ^= gSeed << 13;
+	gSeed ^= gSeed >> 17;
+	gSeed ^= gSeed << 5;
+	return gSeed;
+}
+
+void SelfTestSeed( uint32_t seed )
+{
+	gSeed = seed ? seed : 1;
+}
+
+void SelfTestSilence( bool silent )
+{
+	gSilent = silent;
+}
+
+vector<string> SelfTestGetReplays( )
+{
+	return gReplays;
+}
+
+string SelfTestRate( string name, uint64_t bytes, uint64_t microseconds )
+{
+	return name + " " + UTIL_ToString( microseconds ? (double)bytes / microseconds : 0.0, 1 ) + " MB/s";
+}
+
+string SelfTestNanoseconds( string name, uint64_t operations, uint64_t microseconds )
+{
+	return name + " " + UTIL_ToString( operations ? microseconds * 1000.0 / operations : 0.0, 1 ) + " ns";
+}
+
+int main( int argc, char **argv )
+{
+	map<string, SELFTEST_SUITE> Suites;
+	Suites["crc32"] = SelfTestCRC32;
+	Suites["decoder"] = SelfTestDecoder;
+	Suites["flood"] = SelfTestFlood;
+	Suites["format"] = SelfTestFormat;
+	Suites["gproxy"] = SelfTestGProxy;
+	Suites["packets"] = SelfTestPackets;
+	Suites["signature"] = SelfTestSignature;
+	Suites["timerwheel"] = SelfTestTimerWheel;
+
+	vector<string> Names;
+
+	for( int i = 1; i < argc; i++ )
+	{
+		string Arg = argv[i];
+
+		if( Arg.size( ) > 4 && Arg.substr( Arg.size( ) - 4 ) == ".w3g" )
+			gReplays.push_back( Arg );
+		else
+			Names.push_back( Arg );
+	}
+
+	if( Names.empty( ) )
+	{
+		for( map<string, SELFTEST_SUITE> :: iterator i = Suites.begin( ); i != Suites.end( ); i++ )
+			Names.push_back( i->first );
+	}
+
+	uint32_t Failed = 0;
+
+	for( vector<string> :: iterator i = Names.begin( ); i != Names.end( ); i++ )
+	{
+		map<string, SELFTEST_SUITE> :: iterator Suite = Suites.find( *i );
+
+		if( Suite == Suites.end( ) )
+		{
+			CONSOLE_Print( "[SELFTEST] unknown suite [" + *i + "]" );
+			Failed++;
+			continue;
+		}
+
+		SelfTestSeed( 0x9E3779B9 );
+		uint64_t StartTicks = GetMicroTicks( );
+		uint32_t SuiteFailed = Suite->second( );
+		CONSOLE_Print( "[SELFTEST] " + *i + ( SuiteFailed ? " FAILED " + UTIL_ToString( SuiteFailed ) + " checks" : " passed" ) + " in " + UTIL_ToString( (uint32_t)( ( GetMicroTicks( ) - StartTicks ) / 1000 ) ) + "ms" );
+		Failed += SuiteFailed;
+	}
+
+	return Failed ? 1 : 0;
+}
@@ -0,0 +1,258 @@
+/*
+
+   Copyright [2008] [Trevor Hogan]
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+   CODE PORTED FROM THE ORIGINAL GHOST PROJECT: http://ghost.pwner.org/
+
+*/
+#include "ghost.h"
+#include "util.h"
+#include "socket.h"
+#include "gameplayer.h"
+#include "gameprotocol.h"
+#include "selftest.h"
+
+//
+// gproxy
+//
+
+// the GProxy++ resend buffer against what actually went out on the wire
+// CGamePlayer :: Send counts every packet and buffers every packet once the game has loaded, GProxy++ acknowledges packets by how many it has received
+// so after an ack or a reconnect the packets left in the buffer must be exactly the packets the client hasn't received yet, in the order it would have received them
+// lobby packets, chat and action packets are interleaved and queued in the lanes CGameProtocol :: GetSendLane picks on a real loopback connection
+// then every possible ack is replayed against the buffer the way CGamePlayer handles GPS_ACK and EventGProxyReconnect
+
+static BYTEARRAY MakePacket( unsigned char id, uint32_t sequence, uint32_t size )
+{
+	BYTEARRAY Packet;
+	Packet.push_back( W3GS_HEADER_CONSTANT );
+	Packet.push_back( id );
+	UTIL_AppendByteArray( Packet, (uint16_t)( size + 8 ), false );
+	UTIL_AppendByteArray( Packet, sequence, false );
+
+	while( Packet.size( ) < size + 8 )
+		Packet.push_back( (unsigned char)SelfTestRandom( ) );
+
+	return Packet;
+}
+
+uint32_t SelfTestGProxy( )
+{
+	uint32_t Failed = 0;
+
+	// connect to ourselves
+
+	CTCPServer *Server = NULL;
+	uint16_t Port = 0;
+
+	for( uint32_t i = 0; i < 20 && !Server; i++ )
+	{
+		Server = new CTCPServer( );
+		Port = 20000 + SelfTestRandom( ) % 40000;
+
+		if( !Server->Listen( "127.0.0.1", Port ) )
+		{
+			delete Server;
+			Server = NULL;
+		}
+	}
+
+	if( !Server )
+		return SelfTestCheck( false, "GPROXY", "couldn't listen on the loopback interface" );
+
+	CTCPClient *Client = new CTCPClient( );
+	Client->Connect( string( ), "127.0.0.1", Port );
+	CTCPSocket *Player = NULL;
+	uint32_t StartTicks = GetTicks( );
+
+	while( ( !Player || !Client->GetConnected( ) ) && GetTicks( ) - StartTicks < 5000 )
+	{
+		fd_set fd;
+		fd_set send_fd;
+		int nfds = 0;
+		FD_ZERO( &fd );
+		FD_ZERO( &send_fd );
+		Server->SetFD( &fd, &send_fd, &nfds );
+		Client->SetFD( &fd, &send_fd, &nfds );
+		struct timeval tv;
+		tv.tv_sec = 0;
+		tv.tv_usec = 10000;
+		select( nfds + 1, &fd, &send_fd, NULL, &tv );
+
+		if( !Player )
+			Player = Server->Accept( &fd );
+
+		if( Client->GetConnecting( ) )
+			Client->CheckConnect( );
+	}
+
+	if( !Player || !Client->GetConnected( ) )
+	{
+		delete Player;
+		delete Client;
+		delete Server;
+		return SelfTestCheck( false, "GPROXY", "couldn't connect on the loopback interface" );
+	}
+
+	// queue packets in batches and only send in between batches so packets queued in different lanes can overtake each other
+	// the first packets are sent in the lobby (chat, map data and slot changes) and the rest once the game has loaded
+
+	uint32_t TotalPacketsSent = 0;
+	queue<SHAREDBYTEARRAY> GProxyBuffer;
+	vector<BYTEARRAY> Wire;
+	string *RecvBuffer = Client->GetBytes( );
+	const uint32_t LobbyPackets = 300;
+	const uint32_t NumPackets = 3000;
+	uint32_t LoadedPacket = 0;
+	uint32_t Sequence = 0;
+
+	while( Wire.size( ) < NumPackets && GetTicks( ) - StartTicks < 30000 )
+	{
+		for( uint32_t i = SelfTestRandom( ) % 30; i > 0 && Sequence < NumPackets; i-- )
+		{
+			bool GameLoaded = Sequence >= LobbyPackets;
+			BYTEARRAY Data;
+
+			if( GameLoaded )
+			{
+				if( SelfTestRandom( ) % 3 == 0 )
+					Data = MakePacket( CGameProtocol :: W3GS_CHAT_FROM_HOST, Sequence, SelfTestRandom( ) % 100 );
+				else if( SelfTestRandom( ) % 10 == 0 )
+					Data = MakePacket( CGameProtocol :: W3GS_PLAYERLEAVE_OTHERS, Sequence, 5 );
+				else
+					Data = MakePacket( CGameProtocol :: W3GS_INCOMING_ACTION, Sequence, SelfTestRandom( ) % 200 );
+			}
+			else
+			{
+				if( SelfTestRandom( ) % 3 == 0 )
+					Data = MakePacket( CGameProtocol :: W3GS_CHAT_FROM_HOST, Sequence, SelfTestRandom( ) % 100 );
+				else if( SelfTestRandom( ) % 2 == 0 )
+					Data = MakePacket( CGameProtocol :: W3GS_MAPPART, Sequence, 1442 );
+				else
+					Data = MakePacket( CGameProtocol :: W3GS_SLOTINFO, Sequence, 100 );
+			}
+
+			// the same bookkeeping as CGamePlayer :: Send
+
+			SHAREDBYTEARRAY Packet( new BYTEARRAY( Data ) );
+			TotalPacketsSent++;
+
+			if( GameLoaded )
+			{
+				if( GProxyBuffer.empty( ) && LoadedPacket == 0 )
+					LoadedPacket = TotalPacketsSent - 1;
+
+				GProxyBuffer.push( Packet );
+			}
+
+			Player->PutBytes( Packet, CGameProtocol :: GetSendLane( Data, GameLoaded ) );
+			Sequence++;
+		}
+
+		fd_set fd;
+		fd_set send_fd;
+		int nfds = 0;
+		FD_ZERO( &fd );
+		FD_ZERO( &send_fd );
+		Player->SetFD( &fd, &send_fd, &nfds );
+		Client->SetFD( &fd, &send_fd, &nfds );
+		struct timeval tv;
+		tv.tv_sec = 0;
+		tv.tv_usec = 1000;
+		select( nfds + 1, &fd, NULL, NULL, &tv );
+		Player->DoSend( &send_fd );
+		Client->DoRecv( &fd );
+
+		// split the received bytes into packets
+
+		while( RecvBuffer->size( ) >= 4 )
+		{
+			uint32_t Length = (unsigned char)(*RecvBuffer)[2] | (unsigned char)(*RecvBuffer)[3] << 8;
+
+			if( RecvBuffer->size( ) < Length )
+				break;
+
+			Wire.push_back( UTIL_CreateByteArray( (unsigned char *)RecvBuffer->c_str( ), Length ) );
+			*RecvBuffer = RecvBuffer->substr( Length );
+		}
+	}
+
+	Failed += SelfTestCheck( Wire.size( ) == NumPackets, "GPROXY", "received " + UTIL_ToString( Wire.size( ) ) + " of " + UTIL_ToString( NumPackets ) + " packets" );
+	delete Player;
+	delete Client;
+	delete Server;
+
+	if( Wire.size( ) != NumPackets )
+		return Failed;
+
+	// every packet sent since the game loaded must be in the buffer in the order it went out on the wire
+	// otherwise an ack (or a reconnect) with any count between the game loading and the last packet would leave the wrong packets in the buffer
+
+	vector<SHAREDBYTEARRAY> Buffer;
+
+	while( !GProxyBuffer.empty( ) )
+	{
+		Buffer.push_back( GProxyBuffer.front( ) );
+		GProxyBuffer.pop( );
+	}
+
+	uint32_t Checked = 0;
+	uint32_t Mismatches = 0;
+
+	for( uint32_t LastPacket = LoadedPacket; LastPacket <= TotalPacketsSent; LastPacket++ )
+	{
+		// GPS_ACK and EventGProxyReconnect, the client has received LastPacket packets so far
+
+		queue<SHAREDBYTEARRAY> Remaining;
+
+		for( vector<SHAREDBYTEARRAY> :: iterator i = Buffer.begin( ); i != Buffer.end( ); i++ )
+			Remaining.push( *i );
+
+		uint32_t PacketsAlreadyUnqueued = TotalPacketsSent - Remaining.size( );
+
+		if( LastPacket > PacketsAlreadyUnqueued )
+		{
+			uint32_t PacketsToUnqueue = LastPacket - PacketsAlreadyUnqueued;
+
+			if( PacketsToUnqueue > Remaining.size( ) )
+				PacketsToUnqueue = Remaining.size( );
+
+			while( PacketsToUnqueue > 0 )
+			{
+				Remaining.pop( );
+				PacketsToUnqueue--;
+			}
+		}
+
+		// the client would now receive the remaining packets, together with what it already has it must match the wire
+
+		bool Match = Remaining.size( ) == TotalPacketsSent - LastPacket;
+
+		for( uint32_t i = LastPacket; Match && !Remaining.empty( ); i++ )
+		{
+			Match = *Remaining.front( ) == Wire[i];
+			Remaining.pop( );
+		}
+
+		if( !Match )
+			Mismatches++;
+
+		Checked++;
+	}
+
+	Failed += SelfTestCheck( Mismatches == 0, "GPROXY", UTIL_ToString( Mismatches ) + " of " + UTIL_ToString( Checked ) + " acks would have left the wrong packets in the buffer" );
+	CONSOLE_Print( "[GPROXY] replayed " + UTIL_ToString( Checked ) + " acks against " + UTIL_ToString( TotalPacketsSent ) + " packets (" + UTIL_ToString( TotalPacketsSent - LoadedPacket ) + " buffered)" );
+	return Failed;
+}
@@ -0,0 +1,1278 @@
+/*
+
+   Copyright [2008] [Trevor Hogan]
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+   CODE PORTED FROM THE ORIGINAL GHOST PROJECT: http://ghost.pwner.org/
+
+*/
+
+#include "ghost.h"
+#include "util.h"
+#include "crc32.h"
+#include "gameslot.h"
+#include "gameprotocol.h"
+#include "bnetprotocol.h"
+#include "selftest.h"
+
+#include <stdlib.h>
+
+//
+// packets
+//
+
+// the W3GS and SID packets built from the schemas in packetschema.h against the hand built packets they replaced
+// every send function is called with the same random arguments on both and the bytes have to be identical, including the invalid arguments which produce an empty packet
+// SEND_W3GS_START_LAG and SEND_W3GS_STOP_LAG aren't covered because they need real CGamePlayers
+// the old send functions below are copied unchanged from gameprotocol.cpp and bnetprotocol.cpp as they were before the schemas (apart from the debug output)
+
+class COldGameProtocol : public CGameProtocol
+{
+public:
+	COldGameProtocol( CGHost *nGHost ) : CGameProtocol( nGHost ) { }
+
+	BYTEARRAY SEND_W3GS_PING_FROM_HOST( );
+	BYTEARRAY SEND_W3GS_SLOTINFOJOIN( unsigned char PID, BYTEARRAY port, BYTEARRAY externalIP, vector<CGameSlot> &slots, uint32_t randomSeed, unsigned char layoutStyle, unsigned char playerSlots );
+	BYTEARRAY SEND_W3GS_REJECTJOIN( uint32_t reason );
+	BYTEARRAY SEND_W3GS_PLAYERINFO( unsigned char PID, string name, BYTEARRAY externalIP, BYTEARRAY internalIP );
+	BYTEARRAY SEND_W3GS_PLAYERLEAVE_OTHERS( unsigned char PID, uint32_t leftCode );
+	BYTEARRAY SEND_W3GS_GAMELOADED_OTHERS( unsigned char PID );
+	BYTEARRAY SEND_W3GS_SLOTINFO( vector<CGameSlot> &slots, uint32_t randomSeed, unsigned char layoutStyle, unsigned char playerSlots );
+	BYTEARRAY SEND_W3GS_COUNTDOWN_START( );
+	BYTEARRAY SEND_W3GS_COUNTDOWN_END( );
+	BYTEARRAY SEND_W3GS_INCOMING_ACTION( queue<CIncomingAction *> actions, uint16_t sendInterval );
+	BYTEARRAY SEND_W3GS_CHAT_FROM_HOST( unsigned char fromPID, BYTEARRAY toPIDs, unsigned char flag, BYTEARRAY flagExtra, string message );
+	BYTEARRAY SEND_W3GS_SEARCHGAME( bool TFT, unsigned char war3Version );
+	BYTEARRAY SEND_W3GS_GAMEINFO( bool TFT, unsigned char war3Version, BYTEARRAY mapGameType, BYTEARRAY mapFlags, BYTEARRAY mapWidth, BYTEARRAY mapHeight, string gameName, string hostName, uint32_t upTime, string mapPath, BYTEARRAY mapCRC, uint32_t slotsTotal, uint32_t slotsOpen, uint16_t port, uint32_t hostCounter );
+	BYTEARRAY SEND_W3GS_CREATEGAME( bool TFT, unsigned char war3Version );
+	BYTEARRAY SEND_W3GS_REFRESHGAME( uint32_t players, uint32_t playerSlots );
+	BYTEARRAY SEND_W3GS_DECREATEGAME( );
+	BYTEARRAY SEND_W3GS_MAPCHECK( string mapPath, BYTEARRAY mapSize, BYTEARRAY mapInfo, BYTEARRAY mapCRC, BYTEARRAY mapSHA1 );
+	BYTEARRAY SEND_W3GS_STARTDOWNLOAD( unsigned char fromPID );
+	BYTEARRAY SEND_W3GS_MAPPART( unsigned char fromPID, unsigned char toPID, uint32_t start, string *mapData );
+	BYTEARRAY SEND_W3GS_INCOMING_ACTION2( queue<CIncomingAction *> actions );
+	bool AssignLength( BYTEARRAY &content );
+	BYTEARRAY EncodeSlotInfo( vector<CGameSlot> &slots, uint32_t randomSeed, unsigned char layoutStyle, unsigned char playerSlots );
+};
+
+class COldBNETProtocol : public CBNETProtocol
+{
+public:
+	COldBNETProtocol( ) { }
+
+	BYTEARRAY SEND_PROTOCOL_INITIALIZE_SELECTOR( );
+	BYTEARRAY SEND_SID_NULL( );
+	BYTEARRAY SEND_SID_STOPADV( );
+	BYTEARRAY SEND_SID_GETADVLISTEX( string gameName );
+	BYTEARRAY SEND_SID_ENTERCHAT( );
+	BYTEARRAY SEND_SID_JOINCHANNEL( string channel );
+	BYTEARRAY SEND_SID_CHATCOMMAND( string command );
+	BYTEARRAY SEND_SID_CHECKAD( );
+	BYTEARRAY SEND_SID_STARTADVEX3( unsigned char state, BYTEARRAY mapGameType, BYTEARRAY mapFlags, BYTEARRAY mapWidth, BYTEARRAY mapHeight, string gameName, string hostName, uint32_t upTime, string mapPath, BYTEARRAY mapCRC, BYTEARRAY mapSHA1, uint32_t hostCounter );
+	BYTEARRAY SEND_SID_NOTIFYJOIN( string gameName );
+	BYTEARRAY SEND_SID_PING( BYTEARRAY pingValue );
+	BYTEARRAY SEND_SID_LOGONRESPONSE( BYTEARRAY clientToken, BYTEARRAY serverToken, BYTEARRAY passwordHash, string accountName );
+	BYTEARRAY SEND_SID_NETGAMEPORT( uint16_t serverPort );
+	BYTEARRAY SEND_SID_AUTH_INFO( unsigned char ver, bool TFT, uint32_t localeID, string countryAbbrev, string country );
+	BYTEARRAY SEND_SID_AUTH_CHECK( bool TFT, BYTEARRAY clientToken, BYTEARRAY exeVersion, BYTEARRAY exeVersionHash, BYTEARRAY keyInfoROC, BYTEARRAY keyInfoTFT, string exeInfo, string keyOwnerName );
+	BYTEARRAY SEND_SID_AUTH_ACCOUNTLOGON( BYTEARRAY clientPublicKey, string accountName );
+	BYTEARRAY SEND_SID_AUTH_ACCOUNTLOGONPROOF( BYTEARRAY clientPasswordProof );
+	BYTEARRAY SEND_SID_WARDEN( BYTEARRAY wardenResponse );
+	BYTEARRAY SEND_SID_FRIENDSLIST( );
+	BYTEARRAY SEND_SID_CLANMEMBERLIST( );
+	bool AssignLength( BYTEARRAY &content );
+};
+
+BYTEARRAY COldGameProtocol :: SEND_W3GS_PING_FROM_HOST( )
+{
+	BYTEARRAY packet;
+	packet.push_back( W3GS_HEADER_CONSTANT );				// W3GS header constant
+	packet.push_back( W3GS_PING_FROM_HOST );				// W3GS_PING_FROM_HOST
+	packet.push_back( 0 );									// packet length will be assigned later
+	packet.push_back( 0 );									// packet length will be assigned later
+	UTIL_AppendByteArray( packet, GetTicks( ), false );		// ping value
+	AssignLength( packet );
+	return packet;
+}
+
+BYTEARRAY COldGameProtocol :: SEND_W3GS_SLOTINFOJOIN( unsigned char PID, BYTEARRAY port, BYTEARRAY externalIP, vector<CGameSlot> &slots, uint32_t randomSeed, unsigned char layoutStyle, unsigned char playerSlots )
+{
+	unsigned char Zeros[] = { 0, 0, 0, 0 };
+
+	BYTEARRAY SlotInfo = EncodeSlotInfo( slots, randomSeed, layoutStyle, playerSlots );
+	BYTEARRAY packet;
+
+	if( port.size( ) == 2 && externalIP.size( ) == 4 )
+	{
+		packet.push_back( W3GS_HEADER_CONSTANT );									// W3GS header constant
+		packet.push_back( W3GS_SLOTINFOJOIN );										// W3GS_SLOTINFOJOIN
+		packet.push_back( 0 );														// packet length will be assigned later
+		packet.push_back( 0 );														// packet length will be assigned later
+		UTIL_AppendByteArray( packet, (uint16_t)SlotInfo.size( ), false );			// SlotInfo length
+		UTIL_AppendByteArrayFast( packet, SlotInfo );								// SlotInfo
+		packet.push_back( PID );													// PID
+		packet.push_back( 2 );														// AF_INET
+		packet.push_back( 0 );														// AF_INET continued...
+		UTIL_AppendByteArray( packet, port );										// port
+		UTIL_AppendByteArrayFast( packet, externalIP );								// external IP
+		UTIL_AppendByteArray( packet, Zeros, 4 );									// ???
+		UTIL_AppendByteArray( packet, Zeros, 4 );									// ???
+		AssignLength( packet );
+	}
+	else
+		CONSOLE_Print( "[GAMEPROTO] invalid parameters passed to SEND_W3GS_SLOTINFOJOIN" );
+
+	return packet;
+}
+
+BYTEARRAY COldGameProtocol :: SEND_W3GS_REJECTJOIN( uint32_t reason )
+{
+	BYTEARRAY packet;
+	packet.push_back( W3GS_HEADER_CONSTANT );				// W3GS header constant
+	packet.push_back( W3GS_REJECTJOIN );					// W3GS_REJECTJOIN
+	packet.push_back( 0 );									// packet length will be assigned later
+	packet.push_back( 0 );									// packet length will be assigned later
+	UTIL_AppendByteArray( packet, reason, false );			// reason
+	AssignLength( packet );
+	return packet;
+}
+
+BYTEARRAY COldGameProtocol :: SEND_W3GS_PLAYERINFO( unsigned char PID, string name, BYTEARRAY externalIP, BYTEARRAY internalIP )
+{
+	unsigned char PlayerJoinCounter[]	= { 2, 0, 0, 0 };
+	unsigned char Zeros[]				= { 0, 0, 0, 0 };
+
+	BYTEARRAY packet;
+
+	if( !name.empty( ) && name.size( ) <= 15 && externalIP.size( ) == 4 && internalIP.size( ) == 4 )
+	{
+		packet.push_back( W3GS_HEADER_CONSTANT );							// W3GS header constant
+		packet.push_back( W3GS_PLAYERINFO );								// W3GS_PLAYERINFO
+		packet.push_back( 0 );												// packet length will be assigned later
+		packet.push_back( 0 );												// packet length will be assigned later
+		UTIL_AppendByteArray( packet, PlayerJoinCounter, 4 );				// player join counter
+		packet.push_back( PID );											// PID
+		UTIL_AppendByteArrayFast( packet, name );							// player name
+		packet.push_back( 1 );												// ???
+		packet.push_back( 0 );												// ???
+		packet.push_back( 2 );												// AF_INET
+		packet.push_back( 0 );												// AF_INET continued...
+		packet.push_back( 0 );												// port
+		packet.push_back( 0 );												// port continued...
+		UTIL_AppendByteArrayFast( packet, externalIP );						// external IP
+		UTIL_AppendByteArray( packet, Zeros, 4 );							// ???
+		UTIL_AppendByteArray( packet, Zeros, 4 );							// ???
+		packet.push_back( 2 );												// AF_INET
+		packet.push_back( 0 );												// AF_INET continued...
+		packet.push_back( 0 );												// port
+		packet.push_back( 0 );												// port continued...
+		UTIL_AppendByteArrayFast( packet, internalIP );						// internal IP
+		UTIL_AppendByteArray( packet, Zeros, 4 );							// ???
+		UTIL_AppendByteArray( packet, Zeros, 4 );							// ???
+		AssignLength( packet );
+	}
+	else
+		CONSOLE_Print( "[GAMEPROTO] invalid parameters passed to SEND_W3GS_PLAYERINFO" );
+
+	return packet;
+}
+
+BYTEARRAY COldGameProtocol :: SEND_W3GS_PLAYERLEAVE_OTHERS( unsigned char PID, uint32_t leftCode )
+{
+	BYTEARRAY packet;
+
+	if( PID != 255 )
+	{
+		packet.push_back( W3GS_HEADER_CONSTANT );			// W3GS header constant
+		packet.push_back( W3GS_PLAYERLEAVE_OTHERS );		// W3GS_PLAYERLEAVE_OTHERS
+		packet.push_back( 0 );								// packet length will be assigned later
+		packet.push_back( 0 );								// packet length will be assigned later
+		packet.push_back( PID );							// PID
+		UTIL_AppendByteArray( packet, leftCode, false );	// left code (see PLAYERLEAVE_ constants in gameprotocol.h)
+		AssignLength( packet );
+	}
+	else
+		CONSOLE_Print( "[GAMEPROTO] invalid parameters passed to SEND_W3GS_PLAYERLEAVE_OTHERS" );
+
+	return packet;
+}
+
+BYTEARRAY COldGameProtocol :: SEND_W3GS_GAMELOADED_OTHERS( unsigned char PID )
+{
+	BYTEARRAY packet;
+
+	if( PID != 255 )
+	{
+		packet.push_back( W3GS_HEADER_CONSTANT );		// W3GS header constant
+		packet.push_back( W3GS_GAMELOADED_OTHERS );		// W3GS_GAMELOADED_OTHERS
+		packet.push_back( 0 );							// packet length will be assigned later
+		packet.push_back( 0 );							// packet length will be assigned later
+		packet.push_back( PID );						// PID
+		AssignLength( packet );
+	}
+	else
+		CONSOLE_Print( "[GAMEPROTO] invalid parameters passed to SEND_W3GS_GAMELOADED_OTHERS" );
+
+	return packet;
+}
+
+BYTEARRAY COldGameProtocol :: SEND_W3GS_SLOTINFO( vector<CGameSlot> &slots, uint32_t randomSeed, unsigned char layoutStyle, unsigned char playerSlots )
+{
+	BYTEARRAY SlotInfo = EncodeSlotInfo( slots, randomSeed, layoutStyle, playerSlots );
+	BYTEARRAY packet;
+	packet.push_back( W3GS_HEADER_CONSTANT );									// W3GS header constant
+	packet.push_back( W3GS_SLOTINFO );											// W3GS_SLOTINFO
+	packet.push_back( 0 );														// packet length will be assigned later
+	packet.push_back( 0 );														// packet length will be assigned later
+	UTIL_AppendByteArray( packet, (uint16_t)SlotInfo.size( ), false );			// SlotInfo length
+	UTIL_AppendByteArrayFast( packet, SlotInfo );								// SlotInfo
+	AssignLength( packet );
+	return packet;
+}
+
+BYTEARRAY COldGameProtocol :: SEND_W3GS_COUNTDOWN_START( )
+{
+	BYTEARRAY packet;
+	packet.push_back( W3GS_HEADER_CONSTANT );		// W3GS header constant
+	packet.push_back( W3GS_COUNTDOWN_START );		// W3GS_COUNTDOWN_START
+	packet.push_back( 0 );							// packet length will be assigned later
+	packet.push_back( 0 );							// packet length will be assigned later
+	AssignLength( packet );
+	return packet;
+}
+
+BYTEARRAY COldGameProtocol :: SEND_W3GS_COUNTDOWN_END( )
+{
+	BYTEARRAY packet;
+	packet.push_back( W3GS_HEADER_CONSTANT );		// W3GS header constant
+	packet.push_back( W3GS_COUNTDOWN_END );			// W3GS_COUNTDOWN_END
+	packet.push_back( 0 );							// packet length will be assigned later
+	packet.push_back( 0 );							// packet length will be assigned later
+	AssignLength( packet );
+	return packet;
+}
+
+BYTEARRAY COldGameProtocol :: SEND_W3GS_INCOMING_ACTION( queue<CIncomingAction *> actions, uint16_t sendInterval )
+{
+	BYTEARRAY packet;
+	packet.push_back( W3GS_HEADER_CONSTANT );				// W3GS header constant
+	packet.push_back( W3GS_INCOMING_ACTION );				// W3GS_INCOMING_ACTION
+	packet.push_back( 0 );									// packet length will be assigned later
+	packet.push_back( 0 );									// packet length will be assigned later
+	UTIL_AppendByteArray( packet, sendInterval, false );	// send interval
+
+	// create subpacket
+
+	if( !actions.empty( ) )
+	{
+		BYTEARRAY subpacket;
+
+		while( !actions.empty( ) )
+		{
+			CIncomingAction *Action = actions.front( );
+			actions.pop( );
+			subpacket.push_back( Action->GetPID( ) );
+			UTIL_AppendByteArray( subpacket, (uint16_t)Action->GetAction( )->size( ), false );
+			UTIL_AppendByteArrayFast( subpacket, *Action->GetAction( ) );
+		}
+
+		// calculate crc (we only care about the first 2 bytes though)
+
+		BYTEARRAY crc32 = UTIL_CreateByteArray( m_GHost->m_CRC->FullCRC( (unsigned char *)string( subpacket.begin( ), subpacket.end( ) ).c_str( ), subpacket.size( ) ), false );
+		crc32.resize( 2 );
+
+		// finish subpacket
+
+		UTIL_AppendByteArrayFast( packet, crc32 );			// crc
+		UTIL_AppendByteArrayFast( packet, subpacket );		// subpacket
+	}
+
+	AssignLength( packet );
+	return packet;
+}
+
+BYTEARRAY COldGameProtocol :: SEND_W3GS_CHAT_FROM_HOST( unsigned char fromPID, BYTEARRAY toPIDs, unsigned char flag, BYTEARRAY flagExtra, string message )
+{
+	BYTEARRAY packet;
+
+	if( !toPIDs.empty( ) && !message.empty( ) && message.size( ) < 255 )
+	{
+		packet.push_back( W3GS_HEADER_CONSTANT );		// W3GS header constant
+		packet.push_back( W3GS_CHAT_FROM_HOST );		// W3GS_CHAT_FROM_HOST
+		packet.push_back( 0 );							// packet length will be assigned later
+		packet.push_back( 0 );							// packet length will be assigned later
+		packet.push_back( toPIDs.size( ) );				// number of receivers
+		UTIL_AppendByteArrayFast( packet, toPIDs );		// receivers
+		packet.push_back( fromPID );					// sender
+		packet.push_back( flag );						// flag
+		UTIL_AppendByteArrayFast( packet, flagExtra );	// extra flag
+		UTIL_AppendByteArrayFast( packet, message );	// message
+		AssignLength( packet );
+	}
+	else
+		CONSOLE_Print( "[GAMEPROTO] invalid parameters passed to SEND_W3GS_CHAT_FROM_HOST" );
+
+	return packet;
+}
+
+BYTEARRAY COldGameProtocol :: SEND_W3GS_SEARCHGAME( bool TFT, unsigned char war3Version )
+{
+	unsigned char ProductID_ROC[]	= {          51, 82, 65, 87 };	// "WAR3"
+	unsigned char ProductID_TFT[]	= {          80, 88, 51, 87 };	// "W3XP"
+	unsigned char Version[]			= { war3Version,  0,  0,  0 };
+	unsigned char Unknown[]			= {           0,  0,  0,  0 };
+
+	BYTEARRAY packet;
+	packet.push_back( W3GS_HEADER_CONSTANT );				// W3GS header constant
+	packet.push_back( W3GS_SEARCHGAME );					// W3GS_SEARCHGAME
+	packet.push_back( 0 );									// packet length will be assigned later
+	packet.push_back( 0 );									// packet length will be assigned later
+
+	if( TFT )
+		UTIL_AppendByteArray( packet, ProductID_TFT, 4 );	// Product ID (TFT)
+	else
+		UTIL_AppendByteArray( packet, ProductID_ROC, 4 );	// Product ID (ROC)
+
+	UTIL_AppendByteArray( packet, Version, 4 );				// Version
+	UTIL_AppendByteArray( packet, Unknown, 4 );				// ???
+	AssignLength( packet );
+	return packet;
+}
+
+BYTEARRAY COldGameProtocol :: SEND_W3GS_GAMEINFO( bool TFT, unsigned char war3Version, BYTEARRAY mapGameType, BYTEARRAY mapFlags, BYTEARRAY mapWidth, BYTEARRAY mapHeight, string gameName, string hostName, uint32_t upTime, string mapPath, BYTEARRAY mapCRC, uint32_t slotsTotal, uint32_t slotsOpen, uint16_t port, uint32_t hostCounter )
+{
+	unsigned char ProductID_ROC[]	= {          51, 82, 65, 87 };	// "WAR3"
+	unsigned char ProductID_TFT[]	= {          80, 88, 51, 87 };	// "W3XP"
+	unsigned char Version[]			= { war3Version,  0,  0,  0 };
+	unsigned char Unknown1[]		= {           1,  2,  3,  4 };
+	unsigned char Unknown2[]		= {           1,  0,  0,  0 };
+
+	BYTEARRAY packet;
+
+	if( mapGameType.size( ) == 4 && mapFlags.size( ) == 4 && mapWidth.size( ) == 2 && mapHeight.size( ) == 2 && !gameName.empty( ) && !hostName.empty( ) && !mapPath.empty( ) && mapCRC.size( ) == 4 )
+	{
+		// make the stat string
+
+		BYTEARRAY StatString;
+		UTIL_AppendByteArrayFast( StatString, mapFlags );
+		StatString.push_back( 0 );
+		UTIL_AppendByteArrayFast( StatString, mapWidth );
+		UTIL_AppendByteArrayFast( StatString, mapHeight );
+		UTIL_AppendByteArrayFast( StatString, mapCRC );
+		UTIL_AppendByteArrayFast( StatString, mapPath );
+		UTIL_AppendByteArrayFast( StatString, hostName );
+		StatString.push_back( 0 );
+		StatString = UTIL_EncodeStatString( StatString );
+
+		// make the rest of the packet
+
+		packet.push_back( W3GS_HEADER_CONSTANT );						// W3GS header constant
+		packet.push_back( W3GS_GAMEINFO );								// W3GS_GAMEINFO
+		packet.push_back( 0 );											// packet length will be assigned later
+		packet.push_back( 0 );											// packet length will be assigned later
+
+		if( TFT )
+			UTIL_AppendByteArray( packet, ProductID_TFT, 4 );			// Product ID (TFT)
+		else
+			UTIL_AppendByteArray( packet, ProductID_ROC, 4 );			// Product ID (ROC)
+
+		UTIL_AppendByteArray( packet, Version, 4 );						// Version
+		UTIL_AppendByteArray( packet, hostCounter, false );				// Host Counter
+		UTIL_AppendByteArray( packet, Unknown1, 4 );					// ??? (this varies wildly even between two identical games created one after another)
+		UTIL_AppendByteArrayFast( packet, gameName );					// Game Name
+		packet.push_back( 0 );											// ??? (maybe game password)
+		UTIL_AppendByteArrayFast( packet, StatString );					// Stat String
+		packet.push_back( 0 );											// Stat String null terminator (the stat string is encoded to remove all even numbers i.e. zeros)
+		UTIL_AppendByteArray( packet, slotsTotal, false );				// Slots Total
+		UTIL_AppendByteArrayFast( packet, mapGameType );				// Game Type
+		UTIL_AppendByteArray( packet, Unknown2, 4 );					// ???
+		UTIL_AppendByteArray( packet, slotsOpen, false );				// Slots Open
+		UTIL_AppendByteArray( packet, upTime, false );					// time since creation
+		UTIL_AppendByteArray( packet, port, false );					// port
+		AssignLength( packet );
+	}
+	else
+		CONSOLE_Print( "[GAMEPROTO] invalid parameters passed to SEND_W3GS_GAMEINFO" );
+
+	return packet;
+}
+
+BYTEARRAY COldGameProtocol :: SEND_W3GS_CREATEGAME( bool TFT, unsigned char war3Version )
+{
+	unsigned char ProductID_ROC[]	= {          51, 82, 65, 87 };	// "WAR3"
+	unsigned char ProductID_TFT[]	= {          80, 88, 51, 87 };	// "W3XP"
+	unsigned char Version[]			= { war3Version,  0,  0,  0 };
+	unsigned char HostCounter[]		= {           1,  0,  0,  0 };
+
+	BYTEARRAY packet;
+	packet.push_back( W3GS_HEADER_CONSTANT );				// W3GS header constant
+	packet.push_back( W3GS_CREATEGAME );					// W3GS_CREATEGAME
+	packet.push_back( 0 );									// packet length will be assigned later
+	packet.push_back( 0 );									// packet length will be assigned later
+
+	if( TFT )
+		UTIL_AppendByteArray( packet, ProductID_TFT, 4 );	// Product ID (TFT)
+	else
+		UTIL_AppendByteArray( packet, ProductID_ROC, 4 );	// Product ID (ROC)
+
+	UTIL_AppendByteArray( packet, Version, 4 );				// Version
+	UTIL_AppendByteArray( packet, HostCounter, 4 );			// Host Counter
+	AssignLength( packet );
+	return packet;
+}
+
+BYTEARRAY COldGameProtocol :: SEND_W3GS_REFRESHGAME( uint32_t players, uint32_t playerSlots )
+{
+	unsigned char HostCounter[]	= { 1, 0, 0, 0 };
+
+	BYTEARRAY packet;
+	packet.push_back( W3GS_HEADER_CONSTANT );			// W3GS header constant
+	packet.push_back( W3GS_REFRESHGAME );				// W3GS_REFRESHGAME
+	packet.push_back( 0 );								// packet length will be assigned later
+	packet.push_back( 0 );								// packet length will be assigned later
+	UTIL_AppendByteArray( packet, HostCounter, 4 );		// Host Counter
+	UTIL_AppendByteArray( packet, players, false );		// Players
+	UTIL_AppendByteArray( packet, playerSlots, false );	// Player Slots
+	AssignLength( packet );
+	return packet;
+}
+
+BYTEARRAY COldGameProtocol :: SEND_W3GS_DECREATEGAME( )
+{
+	unsigned char HostCounter[]	= { 1, 0, 0, 0 };
+
+	BYTEARRAY packet;
+	packet.push_back( W3GS_HEADER_CONSTANT );			// W3GS header constant
+	packet.push_back( W3GS_DECREATEGAME );				// W3GS_DECREATEGAME
+	packet.push_back( 0 );								// packet length will be assigned later
+	packet.push_back( 0 );								// packet length will be assigned later
+	UTIL_AppendByteArray( packet, HostCounter, 4 );		// Host Counter
+	AssignLength( packet );
+	return packet;
+}
+
+BYTEARRAY COldGameProtocol :: SEND_W3GS_MAPCHECK( string mapPath, BYTEARRAY mapSize, BYTEARRAY mapInfo, BYTEARRAY mapCRC, BYTEARRAY mapSHA1 )
+{
+	unsigned char Unknown[] = { 1, 0, 0, 0 };
+
+	BYTEARRAY packet;
+
+	if( !mapPath.empty( ) && mapSize.size( ) == 4 && mapInfo.size( ) == 4 && mapCRC.size( ) == 4 && mapSHA1.size( ) == 20 )
+	{
+		packet.push_back( W3GS_HEADER_CONSTANT );		// W3GS header constant
+		packet.push_back( W3GS_MAPCHECK );				// W3GS_MAPCHECK
+		packet.push_back( 0 );							// packet length will be assigned later
+		packet.push_back( 0 );							// packet length will be assigned later
+		UTIL_AppendByteArray( packet, Unknown, 4 );		// ???
+		UTIL_AppendByteArrayFast( packet, mapPath );	// map path
+		UTIL_AppendByteArrayFast( packet, mapSize );	// map size
+		UTIL_AppendByteArrayFast( packet, mapInfo );	// map info
+		UTIL_AppendByteArrayFast( packet, mapCRC );		// map crc
+		UTIL_AppendByteArrayFast( packet, mapSHA1 );	// map sha1
+		AssignLength( packet );
+	}
+	else
+		CONSOLE_Print( "[GAMEPROTO] invalid parameters passed to SEND_W3GS_MAPCHECK" );
+
+	return packet;
+}
+
+BYTEARRAY COldGameProtocol :: SEND_W3GS_STARTDOWNLOAD( unsigned char fromPID )
+{
+	unsigned char Unknown[] = { 1, 0, 0, 0 };
+
+	BYTEARRAY packet;
+	packet.push_back( W3GS_HEADER_CONSTANT );				// W3GS header constant
+	packet.push_back( W3GS_STARTDOWNLOAD );					// W3GS_STARTDOWNLOAD
+	packet.push_back( 0 );									// packet length will be assigned later
+	packet.push_back( 0 );									// packet length will be assigned later
+	UTIL_AppendByteArray( packet, Unknown, 4 );				// ???
+	packet.push_back( fromPID );							// from PID
+	AssignLength( packet );
+	return packet;
+}
+
+BYTEARRAY COldGameProtocol :: SEND_W3GS_MAPPART( unsigned char fromPID, unsigned char toPID, uint32_t start, string *mapData )
+{
+	unsigned char Unknown[] = { 1, 0, 0, 0 };
+
+	BYTEARRAY packet;
+
+	if( start < mapData->size( ) )
+	{
+		packet.push_back( W3GS_HEADER_CONSTANT );				// W3GS header constant
+		packet.push_back( W3GS_MAPPART );						// W3GS_MAPPART
+		packet.push_back( 0 );									// packet length will be assigned later
+		packet.push_back( 0 );									// packet length will be assigned later
+		packet.push_back( toPID );								// to PID
+		packet.push_back( fromPID );							// from PID
+		UTIL_AppendByteArray( packet, Unknown, 4 );				// ???
+		UTIL_AppendByteArray( packet, start, false );			// start position
+
+		// calculate end position (don't send more than 1442 map bytes in one packet)
+
+		uint32_t End = start + 1442;
+
+		if( End > mapData->size( ) )
+			End = mapData->size( );
+
+		// calculate crc
+
+		BYTEARRAY crc32 = UTIL_CreateByteArray( m_GHost->m_CRC->FullCRC( (unsigned char *)mapData->c_str( ) + start, End - start ), false );
+		UTIL_AppendByteArrayFast( packet, crc32 );
+
+		// map data
+
+		BYTEARRAY Data = UTIL_CreateByteArray( (unsigned char *)mapData->c_str( ) + start, End - start );
+		UTIL_AppendByteArrayFast( packet, Data );
+		AssignLength( packet );
+	}
+	else
+		CONSOLE_Print( "[GAMEPROTO] invalid parameters passed to SEND_W3GS_MAPPART" );
+
+	return packet;
+}
+
+BYTEARRAY COldGameProtocol :: SEND_W3GS_INCOMING_ACTION2( queue<CIncomingAction *> actions )
+{
+	BYTEARRAY packet;
+	packet.push_back( W3GS_HEADER_CONSTANT );				// W3GS header constant
+	packet.push_back( W3GS_INCOMING_ACTION2 );				// W3GS_INCOMING_ACTION2
+	packet.push_back( 0 );									// packet length will be assigned later
+	packet.push_back( 0 );									// packet length will be assigned later
+	packet.push_back( 0 );									// ??? (send interval?)
+	packet.push_back( 0 );									// ??? (send interval?)
+
+	// create subpacket
+
+	if( !actions.empty( ) )
+	{
+		BYTEARRAY subpacket;
+
+		while( !actions.empty( ) )
+		{
+			CIncomingAction *Action = actions.front( );
+			actions.pop( );
+			subpacket.push_back( Action->GetPID( ) );
+			UTIL_AppendByteArray( subpacket, (uint16_t)Action->GetAction( )->size( ), false );
+			UTIL_AppendByteArrayFast( subpacket, *Action->GetAction( ) );
+		}
+
+		// calculate crc (we only care about the first 2 bytes though)
+
+		BYTEARRAY crc32 = UTIL_CreateByteArray( m_GHost->m_CRC->FullCRC( (unsigned char *)string( subpacket.begin( ), subpacket.end( ) ).c_str( ), subpacket.size( ) ), false );
+		crc32.resize( 2 );
+
+		// finish subpacket
+
+		UTIL_AppendByteArrayFast( packet, crc32 );			// crc
+		UTIL_AppendByteArrayFast( packet, subpacket );		// subpacket
+	}
+
+	AssignLength( packet );
+	return packet;
+}
+
+bool COldGameProtocol :: AssignLength( BYTEARRAY &content )
+{
+	// insert the actual length of the content array into bytes 3 and 4 (indices 2 and 3)
+
+	BYTEARRAY LengthBytes;
+
+	if( content.size( ) >= 4 && content.size( ) <= 65535 )
+	{
+		LengthBytes = UTIL_CreateByteArray( (uint16_t)content.size( ), false );
+		content[2] = LengthBytes[0];
+		content[3] = LengthBytes[1];
+		return true;
+	}
+
+	return false;
+}
+
+BYTEARRAY COldGameProtocol :: EncodeSlotInfo( vector<CGameSlot> &slots, uint32_t randomSeed, unsigned char layoutStyle, unsigned char playerSlots )
+{
+	BYTEARRAY SlotInfo;
+	SlotInfo.push_back( (unsigned char)slots.size( ) );		// number of slots
+
+	for( unsigned int i = 0; i < slots.size( ); i++ )
+		UTIL_AppendByteArray( SlotInfo, slots[i].GetByteArray( ) );
+
+	UTIL_AppendByteArray( SlotInfo, randomSeed, false );	// random seed
+	SlotInfo.push_back( layoutStyle );						// LayoutStyle (0 = melee, 1 = custom forces, 3 = custom forces + fixed player settings)
+	SlotInfo.push_back( playerSlots );						// number of player slots (non observer)
+	return SlotInfo;
+}
+
+BYTEARRAY COldBNETProtocol :: SEND_PROTOCOL_INITIALIZE_SELECTOR( )
+{
+	BYTEARRAY packet;
+	packet.push_back( 1 );
+	return packet;
+}
+
+BYTEARRAY COldBNETProtocol :: SEND_SID_NULL( )
+{
+	BYTEARRAY packet;
+	packet.push_back( BNET_HEADER_CONSTANT );	// BNET header constant
+	packet.push_back( SID_NULL );				// SID_NULL
+	packet.push_back( 0 );						// packet length will be assigned later
+	packet.push_back( 0 );						// packet length will be assigned later
+	AssignLength( packet );
+	return packet;
+}
+
+BYTEARRAY COldBNETProtocol :: SEND_SID_STOPADV( )
+{
+	BYTEARRAY packet;
+	packet.push_back( BNET_HEADER_CONSTANT );	// BNET header constant
+	packet.push_back( SID_STOPADV );			// SID_STOPADV
+	packet.push_back( 0 );						// packet length will be assigned later
+	packet.push_back( 0 );						// packet length will be assigned later
+	AssignLength( packet );
+	return packet;
+}
+
+BYTEARRAY COldBNETProtocol :: SEND_SID_GETADVLISTEX( string gameName )
+{
+	unsigned char MapFilter1[]	= { 255, 3, 0, 0 };
+	unsigned char MapFilter2[]	= { 255, 3, 0, 0 };
+	unsigned char MapFilter3[]	= {   0, 0, 0, 0 };
+	unsigned char NumGames[]	= {   1, 0, 0, 0 };
+
+	BYTEARRAY packet;
+	packet.push_back( BNET_HEADER_CONSTANT );			// BNET header constant
+	packet.push_back( SID_GETADVLISTEX );				// SID_GETADVLISTEX
+	packet.push_back( 0 );								// packet length will be assigned later
+	packet.push_back( 0 );								// packet length will be assigned later
+	UTIL_AppendByteArray( packet, MapFilter1, 4 );		// Map Filter
+	UTIL_AppendByteArray( packet, MapFilter2, 4 );		// Map Filter
+	UTIL_AppendByteArray( packet, MapFilter3, 4 );		// Map Filter
+	UTIL_AppendByteArray( packet, NumGames, 4 );		// maximum number of games to list
+	UTIL_AppendByteArrayFast( packet, gameName );		// Game Name
+	packet.push_back( 0 );								// Game Password is NULL
+	packet.push_back( 0 );								// Game Stats is NULL
+	AssignLength( packet );
+	return packet;
+}
+
+BYTEARRAY COldBNETProtocol :: SEND_SID_ENTERCHAT( )
+{
+	BYTEARRAY packet;
+	packet.push_back( BNET_HEADER_CONSTANT );	// BNET header constant
+	packet.push_back( SID_ENTERCHAT );			// SID_ENTERCHAT
+	packet.push_back( 0 );						// packet length will be assigned later
+	packet.push_back( 0 );						// packet length will be assigned later
+	packet.push_back( 0 );						// Account Name is NULL on Warcraft III/The Frozen Throne
+	packet.push_back( 0 );						// Stat String is NULL on CDKEY'd products
+	AssignLength( packet );
+	return packet;
+}
+
+BYTEARRAY COldBNETProtocol :: SEND_SID_JOINCHANNEL( string channel )
+{
+	unsigned char NoCreateJoin[]	= { 2, 0, 0, 0 };
+	unsigned char FirstJoin[]		= { 1, 0, 0, 0 };
+
+	BYTEARRAY packet;
+	packet.push_back( BNET_HEADER_CONSTANT );				// BNET header constant
+	packet.push_back( SID_JOINCHANNEL );					// SID_JOINCHANNEL
+	packet.push_back( 0 );									// packet length will be assigned later
+	packet.push_back( 0 );									// packet length will be assigned later
+
+	if( channel.size( ) > 0 )
+		UTIL_AppendByteArray( packet, NoCreateJoin, 4 );	// flags for no create join
+	else
+		UTIL_AppendByteArray( packet, FirstJoin, 4 );		// flags for first join
+
+	UTIL_AppendByteArrayFast( packet, channel );
+	AssignLength( packet );
+	return packet;
+}
+
+BYTEARRAY COldBNETProtocol :: SEND_SID_CHATCOMMAND( string command )
+{
+	BYTEARRAY packet;
+	packet.push_back( BNET_HEADER_CONSTANT );		// BNET header constant
+	packet.push_back( SID_CHATCOMMAND );			// SID_CHATCOMMAND
+	packet.push_back( 0 );							// packet length will be assigned later
+	packet.push_back( 0 );							// packet length will be assigned later
+	UTIL_AppendByteArrayFast( packet, command );	// Message
+	AssignLength( packet );
+	return packet;
+}
+
+BYTEARRAY COldBNETProtocol :: SEND_SID_CHECKAD( )
+{
+	unsigned char Zeros[] = { 0, 0, 0, 0 };
+
+	BYTEARRAY packet;
+	packet.push_back( BNET_HEADER_CONSTANT );	// BNET header constant
+	packet.push_back( SID_CHECKAD );			// SID_CHECKAD
+	packet.push_back( 0 );						// packet length will be assigned later
+	packet.push_back( 0 );						// packet length will be assigned later
+	UTIL_AppendByteArray( packet, Zeros, 4 );	// ???
+	UTIL_AppendByteArray( packet, Zeros, 4 );	// ???
+	UTIL_AppendByteArray( packet, Zeros, 4 );	// ???
+	UTIL_AppendByteArray( packet, Zeros, 4 );	// ???
+	AssignLength( packet );
+	return packet;
+}
+
+BYTEARRAY COldBNETProtocol :: SEND_SID_STARTADVEX3( unsigned char state, BYTEARRAY mapGameType, BYTEARRAY mapFlags, BYTEARRAY mapWidth, BYTEARRAY mapHeight, string gameName, string hostName, uint32_t upTime, string mapPath, BYTEARRAY mapCRC, BYTEARRAY mapSHA1, uint32_t hostCounter )
+{
+	// todotodo: sort out how GameType works, the documentation is horrendous
+
+/*
+
+Game type tag: (read W3GS_GAMEINFO for this field)
+ 0x00000001 - Custom
+ 0x00000009 - Blizzard/Ladder
+Map author: (mask 0x00006000) can be combined
+*0x00002000 - Blizzard
+ 0x00004000 - Custom
+Battle type: (mask 0x00018000) cant be combined
+ 0x00000000 - Battle
+*0x00010000 - Scenario
+Map size: (mask 0x000E0000) can be combined with 2 nearest values
+ 0x00020000 - Small
+ 0x00040000 - Medium
+*0x00080000 - Huge
+Observers: (mask 0x00700000) cant be combined
+ 0x00100000 - Allowed observers
+ 0x00200000 - Observers on defeat
+*0x00400000 - No observers
+Flags:
+ 0x00000800 - Private game flag (not used in game list)
+
+*/
+
+	unsigned char Unknown[]		= { 255,  3,  0,  0 };
+	unsigned char CustomGame[]	= {   0,  0,  0,  0 };
+
+	string HostCounterString = UTIL_ToHexString( hostCounter );
+
+	if( HostCounterString.size( ) < 8 )
+		HostCounterString.insert( 0, 8 - HostCounterString.size( ), '0' );
+
+	HostCounterString = string( HostCounterString.rbegin( ), HostCounterString.rend( ) );
+
+	BYTEARRAY packet;
+
+	// make the stat string
+
+	BYTEARRAY StatString;
+	UTIL_AppendByteArrayFast( StatString, mapFlags );
+	StatString.push_back( 0 );
+	UTIL_AppendByteArrayFast( StatString, mapWidth );
+	UTIL_AppendByteArrayFast( StatString, mapHeight );
+	UTIL_AppendByteArrayFast( StatString, mapCRC );
+	UTIL_AppendByteArrayFast( StatString, mapPath );
+	UTIL_AppendByteArrayFast( StatString, hostName );
+	StatString.push_back( 0 );
+	UTIL_AppendByteArrayFast( StatString, mapSHA1 );
+	StatString = UTIL_EncodeStatString( StatString );
+
+	if( mapGameType.size( ) == 4 && mapFlags.size( ) == 4 && mapWidth.size( ) == 2 && mapHeight.size( ) == 2 && !gameName.empty( ) && !hostName.empty( ) && !mapPath.empty( ) && mapCRC.size( ) == 4 && mapSHA1.size( ) == 20 && StatString.size( ) < 128 && HostCounterString.size( ) == 8 )
+	{
+		// make the rest of the packet
+
+		packet.push_back( BNET_HEADER_CONSTANT );						// BNET header constant
+		packet.push_back( SID_STARTADVEX3 );							// SID_STARTADVEX3
+		packet.push_back( 0 );											// packet length will be assigned later
+		packet.push_back( 0 );											// packet length will be assigned later
+		packet.push_back( state );										// State (16 = public, 17 = private, 18 = close)
+		packet.push_back( 0 );											// State continued...
+		packet.push_back( 0 );											// State continued...
+		packet.push_back( 0 );											// State continued...
+		UTIL_AppendByteArray( packet, upTime, false );					// time since creation
+		UTIL_AppendByteArrayFast( packet, mapGameType );				// Game Type, Parameter
+		UTIL_AppendByteArray( packet, Unknown, 4 );						// ???
+		UTIL_AppendByteArray( packet, CustomGame, 4 );					// Custom Game
+		UTIL_AppendByteArrayFast( packet, gameName );					// Game Name
+		packet.push_back( 0 );											// Game Password is NULL
+		packet.push_back( 98 );											// Slots Free (ascii 98 = char 'b' = 11 slots free) - note: do not reduce this as this is the # of PID's Warcraft III will allocate
+		UTIL_AppendByteArrayFast( packet, HostCounterString, false );	// Host Counter
+		UTIL_AppendByteArrayFast( packet, StatString );					// Stat String
+		packet.push_back( 0 );											// Stat String null terminator (the stat string is encoded to remove all even numbers i.e. zeros)
+		AssignLength( packet );
+	}
+	else
+		CONSOLE_Print( "[BNETPROTO] invalid parameters passed to SEND_SID_STARTADVEX3" );
+
+	return packet;
+}
+
+BYTEARRAY COldBNETProtocol :: SEND_SID_NOTIFYJOIN( string gameName )
+{
+	unsigned char ProductID[]		= {  0, 0, 0, 0 };
+	unsigned char ProductVersion[]	= { 14, 0, 0, 0 };	// Warcraft III is 14
+
+	BYTEARRAY packet;
+	packet.push_back( BNET_HEADER_CONSTANT );			// BNET header constant
+	packet.push_back( SID_NOTIFYJOIN );					// SID_NOTIFYJOIN
+	packet.push_back( 0 );								// packet length will be assigned later
+	packet.push_back( 0 );								// packet length will be assigned later
+	UTIL_AppendByteArray( packet, ProductID, 4 );		// Product ID
+	UTIL_AppendByteArray( packet, ProductVersion, 4 );	// Product Version
+	UTIL_AppendByteArrayFast( packet, gameName );		// Game Name
+	packet.push_back( 0 );								// Game Password is NULL
+	AssignLength( packet );
+	return packet;
+}
+
+BYTEARRAY COldBNETProtocol :: SEND_SID_PING( BYTEARRAY pingValue )
+{
+	BYTEARRAY packet;
+
+	if( pingValue.size( ) == 4 )
+	{
+		packet.push_back( BNET_HEADER_CONSTANT );		// BNET header constant
+		packet.push_back( SID_PING );					// SID_PING
+		packet.push_back( 0 );							// packet length will be assigned later
+		packet.push_back( 0 );							// packet length will be assigned later
+		UTIL_AppendByteArrayFast( packet, pingValue );	// Ping Value
+		AssignLength( packet );
+	}
+	else
+		CONSOLE_Print( "[BNETPROTO] invalid parameters passed to SEND_SID_PING" );
+
+	return packet;
+}
+
+BYTEARRAY COldBNETProtocol :: SEND_SID_LOGONRESPONSE( BYTEARRAY clientToken, BYTEARRAY serverToken, BYTEARRAY passwordHash, string accountName )
+{
+	// todotodo: check that the passed BYTEARRAY sizes are correct (don't know what they should be right now so I can't do this today)
+
+	BYTEARRAY packet;
+	packet.push_back( BNET_HEADER_CONSTANT );			// BNET header constant
+	packet.push_back( SID_LOGONRESPONSE );				// SID_LOGONRESPONSE
+	packet.push_back( 0 );								// packet length will be assigned later
+	packet.push_back( 0 );								// packet length will be assigned later
+	UTIL_AppendByteArrayFast( packet, clientToken );	// Client Token
+	UTIL_AppendByteArrayFast( packet, serverToken );	// Server Token
+	UTIL_AppendByteArrayFast( packet, passwordHash );	// Password Hash
+	UTIL_AppendByteArrayFast( packet, accountName );	// Account Name
+	AssignLength( packet );
+	return packet;
+}
+
+BYTEARRAY COldBNETProtocol :: SEND_SID_NETGAMEPORT( uint16_t serverPort )
+{
+	BYTEARRAY packet;
+	packet.push_back( BNET_HEADER_CONSTANT );			// BNET header constant
+	packet.push_back( SID_NETGAMEPORT );				// SID_NETGAMEPORT
+	packet.push_back( 0 );								// packet length will be assigned later
+	packet.push_back( 0 );								// packet length will be assigned later
+	UTIL_AppendByteArray( packet, serverPort, false );	// local game server port
+	AssignLength( packet );
+	return packet;
+}
+
+BYTEARRAY COldBNETProtocol :: SEND_SID_AUTH_INFO( unsigned char ver, bool TFT, uint32_t localeID, string countryAbbrev, string country )
+{
+	unsigned char ProtocolID[]		= {   0,   0,   0,   0 };
+	unsigned char PlatformID[]		= {  54,  56,  88,  73 };	// "IX86"
+	unsigned char ProductID_ROC[]	= {  51,  82,  65,  87 };	// "WAR3"
+	unsigned char ProductID_TFT[]	= {  80,  88,  51,  87 };	// "W3XP"
+	unsigned char Version[]			= { ver,   0,   0,   0 };
+	unsigned char Language[]		= {  83,  85, 110, 101 };	// "enUS"
+	unsigned char LocalIP[]			= { 127,   0,   0,   1 };
+	unsigned char TimeZoneBias[]	= {  44,   1,   0,   0 };	// 300 minutes (GMT -0500)
+
+	BYTEARRAY packet;
+	packet.push_back( BNET_HEADER_CONSTANT );				// BNET header constant
+	packet.push_back( SID_AUTH_INFO );						// SID_AUTH_INFO
+	packet.push_back( 0 );									// packet length will be assigned later
+	packet.push_back( 0 );									// packet length will be assigned later
+	UTIL_AppendByteArray( packet, ProtocolID, 4 );			// Protocol ID
+	UTIL_AppendByteArray( packet, PlatformID, 4 );			// Platform ID
+
+	if( TFT )
+		UTIL_AppendByteArray( packet, ProductID_TFT, 4 );	// Product ID (TFT)
+	else
+		UTIL_AppendByteArray( packet, ProductID_ROC, 4 );	// Product ID (ROC)
+
+	UTIL_AppendByteArray( packet, Version, 4 );				// Version
+	UTIL_AppendByteArray( packet, Language, 4 );			// Language (hardcoded as enUS to ensure battle.net sends the bot messages in English)
+	UTIL_AppendByteArray( packet, LocalIP, 4 );				// Local IP for NAT compatibility
+	UTIL_AppendByteArray( packet, TimeZoneBias, 4 );		// Time Zone Bias
+	UTIL_AppendByteArray( packet, localeID, false );		// Locale ID
+	UTIL_AppendByteArray( packet, localeID, false );		// Language ID (copying the locale ID should be sufficient since we don't care about sublanguages)
+	UTIL_AppendByteArrayFast( packet, countryAbbrev );		// Country Abbreviation
+	UTIL_AppendByteArrayFast( packet, country );			// Country
+	AssignLength( packet );
+	return packet;
+}
+
+BYTEARRAY COldBNETProtocol :: SEND_SID_AUTH_CHECK( bool TFT, BYTEARRAY clientToken, BYTEARRAY exeVersion, BYTEARRAY exeVersionHash, BYTEARRAY keyInfoROC, BYTEARRAY keyInfoTFT, string exeInfo, string keyOwnerName )
+{
+	uint32_t NumKeys = 0;
+
+	if( TFT )
+		NumKeys = 2;
+	else
+		NumKeys = 1;
+
+	BYTEARRAY packet;
+
+	if( clientToken.size( ) == 4 && exeVersion.size( ) == 4 && exeVersionHash.size( ) == 4 && keyInfoROC.size( ) == 36 && ( !TFT || keyInfoTFT.size( ) == 36 ) )
+	{
+		packet.push_back( BNET_HEADER_CONSTANT );			// BNET header constant
+		packet.push_back( SID_AUTH_CHECK );					// SID_AUTH_CHECK
+		packet.push_back( 0 );								// packet length will be assigned later
+		packet.push_back( 0 );								// packet length will be assigned later
+		UTIL_AppendByteArrayFast( packet, clientToken );	// Client Token
+		UTIL_AppendByteArrayFast( packet, exeVersion );		// EXE Version
+		UTIL_AppendByteArrayFast( packet, exeVersionHash );	// EXE Version Hash
+		UTIL_AppendByteArray( packet, NumKeys, false );		// number of keys in this packet
+		UTIL_AppendByteArray( packet, (uint32_t)0, false );	// boolean Using Spawn (32 bit)
+		UTIL_AppendByteArrayFast( packet, keyInfoROC );		// ROC Key Info
+
+		if( TFT )
+			UTIL_AppendByteArrayFast( packet, keyInfoTFT );	// TFT Key Info
+
+		UTIL_AppendByteArrayFast( packet, exeInfo );		// EXE Info
+		UTIL_AppendByteArrayFast( packet, keyOwnerName );	// CD Key Owner Name
+		AssignLength( packet );
+	}
+	else
+		CONSOLE_Print( "[BNETPROTO] invalid parameters passed to SEND_SID_AUTH_CHECK" );
+
+	return packet;
+}
+
+BYTEARRAY COldBNETProtocol :: SEND_SID_AUTH_ACCOUNTLOGON( BYTEARRAY clientPublicKey, string accountName )
+{
+	BYTEARRAY packet;
+
+	if( clientPublicKey.size( ) == 32 )
+	{
+		packet.push_back( BNET_HEADER_CONSTANT );				// BNET header constant
+		packet.push_back( SID_AUTH_ACCOUNTLOGON );				// SID_AUTH_ACCOUNTLOGON
+		packet.push_back( 0 );									// packet length will be assigned later
+		packet.push_back( 0 );									// packet length will be assigned later
+		UTIL_AppendByteArrayFast( packet, clientPublicKey );	// Client Key
+		UTIL_AppendByteArrayFast( packet, accountName );		// Account Name
+		AssignLength( packet );
+	}
+	else
+		CONSOLE_Print( "[BNETPROTO] invalid parameters passed to SEND_SID_AUTH_ACCOUNTLOGON" );
+
+	return packet;
+}
+
+BYTEARRAY COldBNETProtocol :: SEND_SID_AUTH_ACCOUNTLOGONPROOF( BYTEARRAY clientPasswordProof )
+{
+	BYTEARRAY packet;
+
+	if( clientPasswordProof.size( ) == 20 )
+	{
+		packet.push_back( BNET_HEADER_CONSTANT );					// BNET header constant
+		packet.push_back( SID_AUTH_ACCOUNTLOGONPROOF );				// SID_AUTH_ACCOUNTLOGONPROOF
+		packet.push_back( 0 );										// packet length will be assigned later
+		packet.push_back( 0 );										// packet length will be assigned later
+		UTIL_AppendByteArrayFast( packet, clientPasswordProof );	// Client Password Proof
+		AssignLength( packet );
+	}
+	else
+		CONSOLE_Print( "[BNETPROTO] invalid parameters passed to SEND_SID_AUTH_ACCOUNTLOGON" );
+
+	return packet;
+}
+
+BYTEARRAY COldBNETProtocol :: SEND_SID_WARDEN( BYTEARRAY wardenResponse )
+{
+	BYTEARRAY packet;
+	packet.push_back( BNET_HEADER_CONSTANT );			// BNET header constant
+	packet.push_back( SID_WARDEN );						// SID_WARDEN
+	packet.push_back( 0 );								// packet length will be assigned later
+	packet.push_back( 0 );								// packet length will be assigned later
+	UTIL_AppendByteArrayFast( packet, wardenResponse );	// warden response
+	AssignLength( packet );
+	return packet;
+}
+
+BYTEARRAY COldBNETProtocol :: SEND_SID_FRIENDSLIST( )
+{
+	BYTEARRAY packet;
+	packet.push_back( BNET_HEADER_CONSTANT );	// BNET header constant
+	packet.push_back( SID_FRIENDSLIST );		// SID_FRIENDSLIST
+	packet.push_back( 0 );						// packet length will be assigned later
+	packet.push_back( 0 );						// packet length will be assigned later
+	AssignLength( packet );
+	return packet;
+}
+
+BYTEARRAY COldBNETProtocol :: SEND_SID_CLANMEMBERLIST( )
+{
+	unsigned char Cookie[] = { 0, 0, 0, 0 };
+
+	BYTEARRAY packet;
+	packet.push_back( BNET_HEADER_CONSTANT );	// BNET header constant
+	packet.push_back( SID_CLANMEMBERLIST );		// SID_CLANMEMBERLIST
+	packet.push_back( 0 );						// packet length will be assigned later
+	packet.push_back( 0 );						// packet length will be assigned later
+	UTIL_AppendByteArray( packet, Cookie, 4 );	// cookie
+	AssignLength( packet );
+	return packet;
+}
+
+bool COldBNETProtocol :: AssignLength( BYTEARRAY &content )
+{
+	// insert the actual length of the content array into bytes 3 and 4 (indices 2 and 3)
+
+	BYTEARRAY LengthBytes;
+
+	if( content.size( ) >= 4 && content.size( ) <= 65535 )
+	{
+		LengthBytes = UTIL_CreateByteArray( (uint16_t)content.size( ), false );
+		content[2] = LengthBytes[0];
+		content[3] = LengthBytes[1];
+		return true;
+	}
+
+	return false;
+}
+
+static uint32_t CheckPacket( string name, const BYTEARRAY &old, const BYTEARRAY &packet )
+{
+	if( packet == old )
+		return 0;
+
+	return SelfTestCheck( false, "PACKETS", name + " old [" + UTIL_ByteArrayToHexString( old ) + "] new [" + UTIL_ByteArrayToHexString( packet ) + "]" );
+}
+
+static BYTEARRAY RandomBytes( uint32_t size )
+{
+	BYTEARRAY Bytes( size );
+
+	for( uint32_t i = 0; i < size; i++ )
+		Bytes[i] = (unsigned char)SelfTestRandom( );
+
+	return Bytes;
+}
+
+// usually exactly the size the send functions expect but sometimes not so the parameter checks get exercised too
+
+static BYTEARRAY RandomSizedBytes( uint32_t size )
+{
+	if( SelfTestRandom( ) % 16 == 0 )
+		return RandomBytes( SelfTestRandom( ) % ( size + 3 ) );
+
+	return RandomBytes( size );
+}
+
+// strings come out of C strings in the bot so they never contain a null
+
+static string RandomString( uint32_t maxSize )
+{
+	string String( SelfTestRandom( ) % ( maxSize + 1 ), ' ' );
+
+	for( uint32_t i = 0; i < String.size( ); i++ )
+		String[i] = (char)( 1 + SelfTestRandom( ) % 255 );
+
+	return String;
+}
+
+uint32_t SelfTestPackets( )
+{
+	uint32_t Failed = 0;
+
+	// the game protocol only uses the bot for its CRC and a CGHost can't be constructed without the rest of the bot
+	// so both game protocols get zeroed storage with just the CRC in it, nothing else in there is touched by the send functions
+
+	CGHost *GHost = (CGHost *)calloc( 1, sizeof( CGHost ) );
+	GHost->m_CRC = new CCRC32( );
+	GHost->m_CRC->Initialize( );
+	CGameProtocol *Protocol = new CGameProtocol( GHost );
+	COldGameProtocol *OldProtocol = new COldGameProtocol( GHost );
+	CBNETProtocol *BNETProtocol = new CBNETProtocol( );
+	COldBNETProtocol *OldBNETProtocol = new COldBNETProtocol( );
+	uint32_t Iterations = 20000;
+
+	// the send functions complain about every invalid parameter
+
+	SelfTestSilence( true );
+
+	for( uint32_t i = 0; i < Iterations; i++ )
+	{
+		bool TFT = SelfTestRandom( ) % 2 == 0;
+		unsigned char War3Version = (unsigned char)SelfTestRandom( );
+		unsigned char PID = SelfTestRandom( ) % 16 == 0 ? 255 : (unsigned char)SelfTestRandom( );
+		uint32_t Value = SelfTestRandom( );
+		uint32_t Value2 = SelfTestRandom( );
+
+		// W3GS
+
+		BYTEARRAY Old = OldProtocol->SEND_W3GS_PING_FROM_HOST( );
+		BYTEARRAY Packet = Protocol->SEND_W3GS_PING_FROM_HOST( );
+		Failed += SelfTestCheck( Old.size( ) == 8 && Packet.size( ) == 8 && equal( Old.begin( ), Old.begin( ) + 4, Packet.begin( ) ), "PACKETS", "W3GS_PING_FROM_HOST" );
+
+		if( Old.size( ) == 8 && Packet.size( ) == 8 )
+			Failed += SelfTestCheck( UTIL_ByteArrayToUInt32( Packet, false, 4 ) - UTIL_ByteArrayToUInt32( Old, false, 4 ) < 1000, "PACKETS", "W3GS_PING_FROM_HOST ticks" );
+
+		vector<CGameSlot> Slots;
+
+		for( uint32_t j = SelfTestRandom( ) % 13; j > 0; j-- )
+			Slots.push_back( CGameSlot( (unsigned char)SelfTestRandom( ), (unsigned char)SelfTestRandom( ), (unsigned char)SelfTestRandom( ), (unsigned char)SelfTestRandom( ), (unsigned char)SelfTestRandom( ), (unsigned char)SelfTestRandom( ), (unsigned char)SelfTestRandom( ), (unsigned char)SelfTestRandom( ), (unsigned char)SelfTestRandom( ) ) );
+
+		BYTEARRAY Port = RandomSizedBytes( 2 );
+		BYTEARRAY ExternalIP = RandomSizedBytes( 4 );
+		BYTEARRAY InternalIP = RandomSizedBytes( 4 );
+		unsigned char LayoutStyle = (unsigned char)SelfTestRandom( );
+		unsigned char PlayerSlots = (unsigned char)SelfTestRandom( );
+		Failed += CheckPacket( "W3GS_SLOTINFOJOIN", OldProtocol->SEND_W3GS_SLOTINFOJOIN( PID, Port, ExternalIP, Slots, Value, LayoutStyle, PlayerSlots ), Protocol->SEND_W3GS_SLOTINFOJOIN( PID, Port, ExternalIP, Slots, Value, LayoutStyle, PlayerSlots ) );
+		Failed += CheckPacket( "W3GS_REJECTJOIN", OldProtocol->SEND_W3GS_REJECTJOIN( Value ), Protocol->SEND_W3GS_REJECTJOIN( Value ) );
+		string Name = RandomString( 17 );
+		Failed += CheckPacket( "W3GS_PLAYERINFO", OldProtocol->SEND_W3GS_PLAYERINFO( PID, Name, ExternalIP, InternalIP ), Protocol->SEND_W3GS_PLAYERINFO( PID, Name, ExternalIP, InternalIP ) );
+		Failed += CheckPacket( "W3GS_PLAYERLEAVE_OTHERS", OldProtocol->SEND_W3GS_PLAYERLEAVE_OTHERS( PID, Value ), Protocol->SEND_W3GS_PLAYERLEAVE_OTHERS( PID, Value ) );
+		Failed += CheckPacket( "W3GS_GAMELOADED_OTHERS", OldProtocol->SEND_W3GS_GAMELOADED_OTHERS( PID ), Protocol->SEND_W3GS_GAMELOADED_OTHERS( PID ) );
+		Failed += CheckPacket( "W3GS_SLOTINFO", OldProtocol->SEND_W3GS_SLOTINFO( Slots, Value, LayoutStyle, PlayerSlots ), Protocol->SEND_W3GS_SLOTINFO( Slots, Value, LayoutStyle, PlayerSlots ) );
+		Failed += CheckPacket( "W3GS_COUNTDOWN_START", OldProtocol->SEND_W3GS_COUNTDOWN_START( ), Protocol->SEND_W3GS_COUNTDOWN_START( ) );
+		Failed += CheckPacket( "W3GS_COUNTDOWN_END", OldProtocol->SEND_W3GS_COUNTDOWN_END( ), Protocol->SEND_W3GS_COUNTDOWN_END( ) );
+
+		// the send functions take the queue of actions by value so both get the same actions
+
+		queue<CIncomingAction *> Actions;
+		BYTEARRAY NoCRC;
+
+		for( uint32_t j = SelfTestRandom( ) % 4 == 0 ? 0 : SelfTestRandom( ) % 12; j > 0; j-- )
+		{
+			BYTEARRAY Action = RandomBytes( SelfTestRandom( ) % 8 == 0 ? SelfTestRandom( ) % 300 : SelfTestRandom( ) % 30 );
+			Actions.push( new CIncomingAction( (unsigned char)SelfTestRandom( ), NoCRC, Action ) );
+		}
+
+		uint16_t SendInterval = (uint16_t)SelfTestRandom( );
+		Failed += CheckPacket( "W3GS_INCOMING_ACTION", OldProtocol->SEND_W3GS_INCOMING_ACTION( Actions, SendInterval ), Protocol->SEND_W3GS_INCOMING_ACTION( Actions, SendInterval ) );
+		Failed += CheckPacket( "W3GS_INCOMING_ACTION2", OldProtocol->SEND_W3GS_INCOMING_ACTION2( Actions ), Protocol->SEND_W3GS_INCOMING_ACTION2( Actions ) );
+
+		while( !Actions.empty( ) )
+		{
+			delete Actions.front( );
+			Actions.pop( );
+		}
+
+		BYTEARRAY ToPIDs = RandomBytes( SelfTestRandom( ) % 13 );
+		unsigned char Flag = (unsigned char)SelfTestRandom( );
+		BYTEARRAY FlagExtra = RandomBytes( SelfTestRandom( ) % 5 );
+		string Message = RandomString( 260 );
+		Failed += CheckPacket( "W3GS_CHAT_FROM_HOST", OldProtocol->SEND_W3GS_CHAT_FROM_HOST( PID, ToPIDs, Flag, FlagExtra, Message ), Protocol->SEND_W3GS_CHAT_FROM_HOST( PID, ToPIDs, Flag, FlagExtra, Message ) );
+		Failed += CheckPacket( "W3GS_SEARCHGAME", OldProtocol->SEND_W3GS_SEARCHGAME( TFT, War3Version ), Protocol->SEND_W3GS_SEARCHGAME( TFT, War3Version ) );
+		BYTEARRAY MapGameType = RandomSizedBytes( 4 );
+		BYTEARRAY MapFlags = RandomSizedBytes( 4 );
+		BYTEARRAY MapWidth = RandomSizedBytes( 2 );
+		BYTEARRAY MapHeight = RandomSizedBytes( 2 );
+		BYTEARRAY MapCRC = RandomSizedBytes( 4 );
+		BYTEARRAY MapSHA1 = RandomSizedBytes( 20 );
+		BYTEARRAY MapSize = RandomSizedBytes( 4 );
+		BYTEARRAY MapInfo = RandomSizedBytes( 4 );
+		string GameName = RandomString( 31 );
+		string HostName = RandomString( 15 );
+		string MapPath = RandomString( 70 );
+		uint16_t GamePort = (uint16_t)SelfTestRandom( );
+		Failed += CheckPacket( "W3GS_GAMEINFO", OldProtocol->SEND_W3GS_GAMEINFO( TFT, War3Version, MapGameType, MapFlags, MapWidth, MapHeight, GameName, HostName, Value, MapPath, MapCRC, Value2, Value2 / 2, GamePort, Value ), Protocol->SEND_W3GS_GAMEINFO( TFT, War3Version, MapGameType, MapFlags, MapWidth, MapHeight, GameName, HostName, Value, MapPath, MapCRC, Value2, Value2 / 2, GamePort, Value ) );
+		Failed += CheckPacket( "W3GS_CREATEGAME", OldProtocol->SEND_W3GS_CREATEGAME( TFT, War3Version ), Protocol->SEND_W3GS_CREATEGAME( TFT, War3Version ) );
+		Failed += CheckPacket( "W3GS_REFRESHGAME", OldProtocol->SEND_W3GS_REFRESHGAME( Value, Value2 ), Protocol->SEND_W3GS_REFRESHGAME( Value, Value2 ) );
+		Failed += CheckPacket( "W3GS_DECREATEGAME", OldProtocol->SEND_W3GS_DECREATEGAME( ), Protocol->SEND_W3GS_DECREATEGAME( ) );
+		Failed += CheckPacket( "W3GS_MAPCHECK", OldProtocol->SEND_W3GS_MAPCHECK( MapPath, MapSize, MapInfo, MapCRC, MapSHA1 ), Protocol->SEND_W3GS_MAPCHECK( MapPath, MapSize, MapInfo, MapCRC, MapSHA1 ) );
+		Failed += CheckPacket( "W3GS_STARTDOWNLOAD", OldProtocol->SEND_W3GS_STARTDOWNLOAD( PID ), Protocol->SEND_W3GS_STARTDOWNLOAD( PID ) );
+		BYTEARRAY MapBytes = RandomBytes( 1 + SelfTestRandom( ) % 5000 );
+		string MapData( MapBytes.begin( ), MapBytes.end( ) );
+		uint32_t Start = SelfTestRandom( ) % ( MapData.size( ) + 10 );
+		unsigned char ToPID = (unsigned char)SelfTestRandom( );
+		Failed += CheckPacket( "W3GS_MAPPART", OldProtocol->SEND_W3GS_MAPPART( PID, ToPID, Start, &MapData ), Protocol->SEND_W3GS_MAPPART( PID, ToPID, Start, &MapData ) );
+
+		// SID
+
+		Failed += CheckPacket( "PROTOCOL_INITIALIZE_SELECTOR", OldBNETProtocol->SEND_PROTOCOL_INITIALIZE_SELECTOR( ), BNETProtocol->SEND_PROTOCOL_INITIALIZE_SELECTOR( ) );
+		Failed += CheckPacket( "SID_NULL", OldBNETProtocol->SEND_SID_NULL( ), BNETProtocol->SEND_SID_NULL( ) );
+		Failed += CheckPacket( "SID_STOPADV", OldBNETProtocol->SEND_SID_STOPADV( ), BNETProtocol->SEND_SID_STOPADV( ) );
+		Failed += CheckPacket( "SID_GETADVLISTEX", OldBNETProtocol->SEND_SID_GETADVLISTEX( GameName ), BNETProtocol->SEND_SID_GETADVLISTEX( GameName ) );
+		Failed += CheckPacket( "SID_ENTERCHAT", OldBNETProtocol->SEND_SID_ENTERCHAT( ), BNETProtocol->SEND_SID_ENTERCHAT( ) );
+		Failed += CheckPacket( "SID_JOINCHANNEL", OldBNETProtocol->SEND_SID_JOINCHANNEL( Name ), BNETProtocol->SEND_SID_JOINCHANNEL( Name ) );
+		Failed += CheckPacket( "SID_CHATCOMMAND", OldBNETProtocol->SEND_SID_CHATCOMMAND( Message ), BNETProtocol->SEND_SID_CHATCOMMAND( Message ) );
+		Failed += CheckPacket( "SID_CHECKAD", OldBNETProtocol->SEND_SID_CHECKAD( ), BNETProtocol->SEND_SID_CHECKAD( ) );
+		unsigned char State = (unsigned char)SelfTestRandom( );
+		Failed += CheckPacket( "SID_STARTADVEX3", OldBNETProtocol->SEND_SID_STARTADVEX3( State, MapGameType, MapFlags, MapWidth, MapHeight, GameName, HostName, Value, MapPath, MapCRC, MapSHA1, Value2 ), BNETProtocol->SEND_SID_STARTADVEX3( State, MapGameType, MapFlags, MapWidth, MapHeight, GameName, HostName, Value, MapPath, MapCRC, MapSHA1, Value2 ) );
+		Failed += CheckPacket( "SID_NOTIFYJOIN", OldBNETProtocol->SEND_SID_NOTIFYJOIN( GameName ), BNETProtocol->SEND_SID_NOTIFYJOIN( GameName ) );
+		BYTEARRAY PingValue = RandomSizedBytes( 4 );
+		Failed += CheckPacket( "SID_PING", OldBNETProtocol->SEND_SID_PING( PingValue ), BNETProtocol->SEND_SID_PING( PingValue ) );
+		BYTEARRAY ClientToken = RandomSizedBytes( 4 );
+		BYTEARRAY ServerToken = RandomSizedBytes( 4 );
+		BYTEARRAY PasswordHash = RandomSizedBytes( 20 );
+		Failed += CheckPacket( "SID_LOGONRESPONSE", OldBNETProtocol->SEND_SID_LOGONRESPONSE( ClientToken, ServerToken, PasswordHash, Name ), BNETProtocol->SEND_SID_LOGONRESPONSE( ClientToken, ServerToken, PasswordHash, Name ) );
+		Failed += CheckPacket( "SID_NETGAMEPORT", OldBNETProtocol->SEND_SID_NETGAMEPORT( GamePort ), BNETProtocol->SEND_SID_NETGAMEPORT( GamePort ) );
+		string CountryAbbrev = RandomString( 4 );
+		string Country = RandomString( 30 );
+		Failed += CheckPacket( "SID_AUTH_INFO", OldBNETProtocol->SEND_SID_AUTH_INFO( War3Version, TFT, Value, CountryAbbrev, Country ), BNETProtocol->SEND_SID_AUTH_INFO( War3Version, TFT, Value, CountryAbbrev, Country ) );
+		BYTEARRAY EXEVersion = RandomSizedBytes( 4 );
+		BYTEARRAY EXEVersionHash = RandomSizedBytes( 4 );
+		BYTEARRAY KeyInfoROC = RandomSizedBytes( 36 );
+		BYTEARRAY KeyInfoTFT = RandomSizedBytes( 36 );
+		string EXEInfo = RandomString( 60 );
+		Failed += CheckPacket( "SID_AUTH_CHECK", OldBNETProtocol->SEND_SID_AUTH_CHECK( TFT, ClientToken, EXEVersion, EXEVersionHash, KeyInfoROC, KeyInfoTFT, EXEInfo, HostName ), BNETProtocol->SEND_SID_AUTH_CHECK( TFT, ClientToken, EXEVersion, EXEVersionHash, KeyInfoROC, KeyInfoTFT, EXEInfo, HostName ) );
+		BYTEARRAY ClientPublicKey = RandomSizedBytes( 32 );
+		Failed += CheckPacket( "SID_AUTH_ACCOUNTLOGON", OldBNETProtocol->SEND_SID_AUTH_ACCOUNTLOGON( ClientPublicKey, Name ), BNETProtocol->SEND_SID_AUTH_ACCOUNTLOGON( ClientPublicKey, Name ) );
+		Failed += CheckPacket( "SID_AUTH_ACCOUNTLOGONPROOF", OldBNETProtocol->SEND_SID_AUTH_ACCOUNTLOGONPROOF( PasswordHash ), BNETProtocol->SEND_SID_AUTH_ACCOUNTLOGONPROOF( PasswordHash ) );
+		BYTEARRAY WardenResponse = RandomBytes( SelfTestRandom( ) % 100 );
+		Failed += CheckPacket( "SID_WARDEN", OldBNETProtocol->SEND_SID_WARDEN( WardenResponse ), BNETProtocol->SEND_SID_WARDEN( WardenResponse ) );
+		Failed += CheckPacket( "SID_FRIENDSLIST", OldBNETProtocol->SEND_SID_FRIENDSLIST( ), BNETProtocol->SEND_SID_FRIENDSLIST( ) );
+		Failed += CheckPacket( "SID_CLANMEMBERLIST", OldBNETProtocol->SEND_SID_CLANMEMBERLIST( ), BNETProtocol->SEND_SID_CLANMEMBERLIST( ) );
+	}
+
+	SelfTestSilence( false );
+
+	// benchmark the packets sent most often during a game
+
+	queue<CIncomingAction *> Actions;
+	BYTEARRAY NoCRC;
+
+	for( uint32_t i = 0; i < 4; i++ )
+	{
+		BYTEARRAY Action = RandomBytes( 20 );
+		Actions.push( new CIncomingAction( (unsigned char)( i + 1 ), NoCRC, Action ) );
+	}
+
+	uint32_t Operations = 200000;
+	uint32_t Check = 0;
+	uint64_t StartTicks = GetMicroTicks( );
+
+	for( uint32_t i = 0; i < Operations; i++ )
+		Check += OldProtocol->SEND_W3GS_INCOMING_ACTION( Actions, 100 ).size( );
+
+	uint64_t OldTicks = GetMicroTicks( ) - StartTicks;
+	StartTicks = GetMicroTicks( );
+
+	for( uint32_t i = 0; i < Operations; i++ )
+		Check -= Protocol->SEND_W3GS_INCOMING_ACTION( Actions, 100 ).size( );
+
+	uint64_t NewTicks = GetMicroTicks( ) - StartTicks;
+	Failed += SelfTestCheck( Check == 0, "PACKETS", "benchmark result" );
+	CONSOLE_Print( "[PACKETS] W3GS_INCOMING_ACTION with 4 actions: " + SelfTestNanoseconds( "hand built", Operations, OldTicks ) + ", " + SelfTestNanoseconds( "schema", Operations, NewTicks ) );
+
+	while( !Actions.empty( ) )
+	{
+		delete Actions.front( );
+		Actions.pop( );
+	}
+
+	delete OldBNETProtocol;
+	delete BNETProtocol;
+	delete OldProtocol;
+	delete Protocol;
+	delete GHost->m_CRC;
+	free( GHost );
+	return Failed;
+}
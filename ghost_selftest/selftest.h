@@ -0,0 +1,53 @@
+/*
+
+   Copyright [2008] [Trevor Hogan]
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+   CODE PORTED FROM THE ORIGINAL GHOST PROJECT: http://ghost.pwner.org/
+
+*/
+
+#ifndef SELFTEST_H
+#define SELFTEST_H
+
+//
+// ghost_selftest
+//
+
+// each suite compares one of the optimized code paths against the straightforward implementation it replaced and times both
+// the reference implementations live in the suites themselves so the bot never has to carry the old code around
+// a suite returns the number of failed checks, the first few failures of each suite are printed
+
+typedef uint32_t (*SELFTEST_SUITE)( );
+
+uint32_t SelfTestCheck( bool condition, string suite, string message );
+uint32_t SelfTestRandom( );
+void SelfTestSeed( uint32_t seed );
+string SelfTestRate( string name, uint64_t bytes, uint64_t microseconds );
+string SelfTestNanoseconds( string name, uint64_t operations, uint64_t microseconds );
+vector<string> SelfTestGetReplays( );			// the replays given on the command line
+void SelfTestSilence( bool silent );			// hides CONSOLE_Print output while a suite provokes messages on purpose
+
+// suites
+
+uint32_t SelfTestCRC32( );
+uint32_t SelfTestDecoder( );
+uint32_t SelfTestFlood( );
+uint32_t SelfTestFormat( );
+uint32_t SelfTestGProxy( );
+uint32_t SelfTestPackets( );
+uint32_t SelfTestSignature( );
+uint32_t SelfTestTimerWheel( );
+
+#endif
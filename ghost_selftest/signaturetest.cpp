@@ -0,0 +1,134 @@
+/*
+
+   Copyright [2008] [Trevor Hogan]
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+   CODE PORTED FROM THE ORIGINAL GHOST PROJECT: http://ghost.pwner.org/
+
+*/
+
+#include "ghost.h"
+#include "util.h"
+#include "selftest.h"
+
+#include <string.h>
+
+//
+// signature
+//
+
+// the SSE2 and AVX2 signature searches against a byte at a time search
+// every signature length up to 40 bytes is searched for at every position of short buffers (so the vector loops and the leftover tails are both covered)
+// the buffers use a four letter alphabet so partial matches of the first and last byte are common, which is where the vector searches could go wrong
+
+static uint32_t ReferenceFindSignature( unsigned char *data, uint32_t length, const unsigned char *signature, uint32_t signatureLength )
+{
+	if( signatureLength == 0 || signatureLength > length )
+		return length;
+
+	for( uint32_t i = 0; i + signatureLength <= length; i++ )
+	{
+		if( !memcmp( data + i, signature, signatureLength ) )
+			return i;
+	}
+
+	return length;
+}
+
+uint32_t SelfTestSignature( )
+{
+	uint32_t Failed = 0;
+	uint32_t Default = UTIL_GetFindSignatureImplementation( );
+	vector<uint32_t> Implementations;
+	Implementations.push_back( UTIL_FINDSIGNATURE_SCALAR );
+
+	if( UTIL_SetFindSignatureImplementation( UTIL_FINDSIGNATURE_SSE2 ) )
+		Implementations.push_back( UTIL_FINDSIGNATURE_SSE2 );
+	else
+		CONSOLE_Print( "[SIGNATURE] this build has no vectorized search, only checking the scalar search" );
+
+	if( UTIL_SetFindSignatureImplementation( UTIL_FINDSIGNATURE_AVX2 ) )
+		Implementations.push_back( UTIL_FINDSIGNATURE_AVX2 );
+	else if( Implementations.size( ) > 1 )
+		CONSOLE_Print( "[SIGNATURE] the CPU doesn't support AVX2, only checking SSE2" );
+
+	vector<unsigned char> Data( 256 );
+
+	for( uint32_t Round = 0; Round < 100; Round++ )
+	{
+		uint32_t Length = SelfTestRandom( ) % 200 + 1;
+
+		for( uint32_t i = 0; i < Length; i++ )
+			Data[i] = "ACGT"[SelfTestRandom( ) % 4];
+
+		for( uint32_t SignatureLength = 1; SignatureLength <= 40 && SignatureLength <= Length; SignatureLength++ )
+		{
+			// search for the signature at every position it could start at and once for a signature which almost certainly isn't there
+
+			for( uint32_t Position = 0; Position <= Length - SignatureLength + 1; Position++ )
+			{
+				unsigned char Signature[40];
+
+				if( Position <= Length - SignatureLength )
+					memcpy( Signature, &Data[Position], SignatureLength );
+				else
+				{
+					for( uint32_t i = 0; i < SignatureLength; i++ )
+						Signature[i] = "ACGT"[SelfTestRandom( ) % 4];
+
+					Signature[SignatureLength - 1] = 'X';
+				}
+
+				uint32_t Expected = ReferenceFindSignature( &Data[0], Length, Signature, SignatureLength );
+
+				for( vector<uint32_t> :: iterator i = Implementations.begin( ); i != Implementations.end( ); i++ )
+				{
+					UTIL_SetFindSignatureImplementation( *i );
+					uint32_t Found = UTIL_FindSignature( &Data[0], Length, Signature, SignatureLength );
+					Failed += SelfTestCheck( Found == Expected, "SIGNATURE", "implementation " + UTIL_ToString( *i ) + " length " + UTIL_ToString( Length ) + " signature length " + UTIL_ToString( SignatureLength ) + " position " + UTIL_ToString( Position ) + " found " + UTIL_ToString( Found ) + " expected " + UTIL_ToString( Expected ) );
+				}
+			}
+		}
+	}
+
+	// benchmark with a DotA style signature at the end of a buffer the size of a large action block
+
+	uint32_t Size = 64 * 1024;
+	vector<unsigned char> Block( Size );
+
+	for( uint32_t i = 0; i < Size; i++ )
+		Block[i] = (unsigned char)SelfTestRandom( );
+
+	unsigned char Signature[] = "Data\0Hero";
+	memcpy( &Block[Size - 9], Signature, 9 );
+	string Rates;
+
+	for( vector<uint32_t> :: iterator i = Implementations.begin( ); i != Implementations.end( ); i++ )
+	{
+		UTIL_SetFindSignatureImplementation( *i );
+		uint64_t StartTicks = GetMicroTicks( );
+		uint32_t Found = 0;
+
+		for( uint32_t j = 0; j < 256; j++ )
+			Found += UTIL_FindSignature( &Block[0], Size, Signature, 9 );
+
+		uint64_t Ticks = GetMicroTicks( ) - StartTicks;
+		Failed += SelfTestCheck( Found == ( Size - 9 ) * 256, "SIGNATURE", "benchmark result" );
+		Rates += ( Rates.empty( ) ? "" : ", " ) + SelfTestRate( *i == UTIL_FINDSIGNATURE_SCALAR ? "scalar" : ( *i == UTIL_FINDSIGNATURE_SSE2 ? "SSE2" : "AVX2" ), (uint64_t)Size * 256, Ticks );
+	}
+
+	CONSOLE_Print( "[SIGNATURE] " + Rates );
+	UTIL_SetFindSignatureImplementation( Default );
+	return Failed;
+}
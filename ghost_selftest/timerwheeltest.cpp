@@ -0,0 +1,186 @@
+/*
+
+   Copyright [2008] [Trevor Hogan]
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+
+   CODE PORTED FROM THE ORIGINAL GHOST PROJECT: http://ghost.pwner.org/
+
+*/
+
+#include "ghost.h"
+#include "util.h"
+#include "timerwheel.h"
+#include "selftest.h"
+
+//
+// timerwheel
+//
+
+// the timer wheel against a plain list of deadlines which is checked completely on every tick, the way CBaseGame :: Update used to check its timers
+// timers are scheduled, rescheduled and cancelled at random with deadlines from zero to several hours away while the clock advances in random steps
+// the clock starts just before GetTicks wraps around and every timer is checked after every step
+
+class CReferenceTimer
+{
+public:
+	uint32_t m_Deadline;
+	bool m_Scheduled;
+	bool m_Due;
+
+	CReferenceTimer( ) : m_Deadline( 0 ), m_Scheduled( false ), m_Due( false ) { }
+};
+
+static uint32_t RandomDelay( )
+{
+	switch( SelfTestRandom( ) % 6 )
+	{
+	case 0: return SelfTestRandom( ) % 64;
+	case 1: return SelfTestRandom( ) % 4096;
+	case 2: return SelfTestRandom( ) % 300000;
+	case 3: return SelfTestRandom( ) % 20000000;
+	case 4: return SelfTestRandom( ) % 100000000;
+	default: return 5000;
+	}
+}
+
+uint32_t SelfTestTimerWheel( )
+{
+	uint32_t Failed = 0;
+	uint32_t Ticks = 0xFFFFFFFF - 100000;
+	CTimerWheel *Wheel = new CTimerWheel( Ticks );
+	const uint32_t NumTimers = 200;
+	CTimer *Timers = new CTimer[NumTimers];
+	vector<CReferenceTimer> Reference( NumTimers );
+	uint32_t Steps = 0;
+	uint32_t Fired = 0;
+
+	for( uint32_t Step = 0; Step < 10000; Step++ )
+	{
+		// change a few timers
+
+		for( uint32_t i = SelfTestRandom( ) % 4; i > 0; i-- )
+		{
+			uint32_t n = SelfTestRandom( ) % NumTimers;
+
+			if( SelfTestRandom( ) % 5 == 0 )
+			{
+				Timers[n].Cancel( );
+				Reference[n].m_Scheduled = false;
+				Reference[n].m_Due = false;
+			}
+			else
+			{
+				uint32_t Deadline = Ticks + RandomDelay( );
+
+				if( SelfTestRandom( ) % 20 == 0 )
+					Deadline = Ticks - SelfTestRandom( ) % 1000;
+
+				Wheel->Schedule( &Timers[n], Deadline );
+				Reference[n].m_Deadline = Deadline;
+				Reference[n].m_Scheduled = (int32_t)( Deadline - Ticks ) > 0;
+				Reference[n].m_Due = !Reference[n].m_Scheduled;
+			}
+		}
+
+		// the earliest deadline the wheel has to wake us up for
+
+		bool Pending = false;
+		uint32_t Earliest = 0;
+
+		for( uint32_t i = 0; i < NumTimers; i++ )
+		{
+			if( Reference[i].m_Scheduled && ( !Pending || Reference[i].m_Deadline - Ticks < Earliest ) )
+			{
+				Earliest = Reference[i].m_Deadline - Ticks;
+				Pending = true;
+			}
+		}
+
+		uint32_t UntilNext = 0;
+		bool Next = Wheel->GetTicksUntilNext( &UntilNext );
+		Failed += SelfTestCheck( Next == Pending, "TIMERWHEEL", "step " + UTIL_ToString( Step ) + " next timer found " + UTIL_ToString( Next ? 1 : 0 ) + " expected " + UTIL_ToString( Pending ? 1 : 0 ) );
+
+		if( Next && Pending )
+		{
+			Failed += SelfTestCheck( UntilNext >= 1 && UntilNext <= Earliest, "TIMERWHEEL", "step " + UTIL_ToString( Step ) + " next timer in " + UTIL_ToString( UntilNext ) + "ms but the earliest deadline is in " + UTIL_ToString( Earliest ) + "ms" );
+		}
+
+		// advance the clock, usually by a few milliseconds like the main loop but sometimes by a lot (or straight to the next deadline)
+
+		uint32_t Advance = SelfTestRandom( ) % 60;
+
+		if( SelfTestRandom( ) % 50 == 0 )
+			Advance = SelfTestRandom( ) % 10000000;
+		else if( Pending && SelfTestRandom( ) % 4 == 0 )
+			Advance = Earliest;
+
+		Ticks += Advance;
+		Wheel->Advance( Ticks );
+		Steps++;
+		Failed += SelfTestCheck( Wheel->GetTicks( ) == Ticks, "TIMERWHEEL", "step " + UTIL_ToString( Step ) + " wheel ticks" );
+
+		for( uint32_t i = 0; i < NumTimers; i++ )
+		{
+			if( Reference[i].m_Scheduled && (int32_t)( Reference[i].m_Deadline - Ticks ) <= 0 )
+			{
+				Reference[i].m_Scheduled = false;
+				Reference[i].m_Due = true;
+				Fired++;
+			}
+
+			Failed += SelfTestCheck( Timers[i].GetDue( ) == Reference[i].m_Due && Timers[i].GetScheduled( ) == Reference[i].m_Scheduled, "TIMERWHEEL", "step " + UTIL_ToString( Step ) + " timer " + UTIL_ToString( i ) + " due " + UTIL_ToString( Timers[i].GetDue( ) ? 1 : 0 ) + " expected " + UTIL_ToString( Reference[i].m_Due ? 1 : 0 ) + " deadline in " + UTIL_ToString( (int32_t)( Reference[i].m_Deadline - Ticks ) ) + "ms" );
+		}
+	}
+
+	Failed += SelfTestCheck( Fired > 1000, "TIMERWHEEL", "only " + UTIL_ToString( Fired ) + " timers fired" );
+
+	// the timers are still linked into the wheel, deleting the wheel first must leave them unscheduled
+
+	delete Wheel;
+
+	for( uint32_t i = 0; i < NumTimers; i++ )
+		Failed += SelfTestCheck( !Timers[i].GetScheduled( ), "TIMERWHEEL", "timer " + UTIL_ToString( i ) + " still scheduled after the wheel was deleted" );
+
+	delete [] Timers;
+
+	// benchmark a wheel with a game's worth of timers per game advanced by 1ms at a time
+
+	CTimerWheel Benchmark( 0 );
+	CTimer Periodic[400];
+
+	for( uint32_t i = 0; i < 400; i++ )
+		Benchmark.Schedule( &Periodic[i], 1 + SelfTestRandom( ) % 5000 );
+
+	uint64_t StartTicks = GetMicroTicks( );
+	uint32_t Due = 0;
+
+	for( uint32_t t = 1; t <= 100000; t++ )
+	{
+		Benchmark.Advance( t );
+
+		for( uint32_t i = t % 8; i < 400; i += 8 )
+		{
+			if( Periodic[i].GetDue( ) )
+			{
+				Due++;
+				Benchmark.Schedule( &Periodic[i], t + 100 * ( i % 50 + 1 ) );
+			}
+		}
+	}
+
+	uint64_t BenchmarkTicks = GetMicroTicks( ) - StartTicks;
+	Failed += SelfTestCheck( Due > 0, "TIMERWHEEL", "benchmark result" );
+	CONSOLE_Print( "[TIMERWHEEL] " + UTIL_ToString( (uint32_t)Due ) + " timers fired over " + UTIL_ToString( Steps ) + " random steps and 100000 benchmark ticks, " + SelfTestNanoseconds( "per benchmark tick", 100000, BenchmarkTicks ) );
+	return Failed;
+}
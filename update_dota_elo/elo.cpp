@@ -424,8 +424,8 @@ void elo_recalculate_ratings(int num_players, float *player_ratings,
 
 	/* Debugging data */
 	for (i = 0; i < num_players; i++) {
-		int team = num_teams > 0 ? player_teams[i] : i;
-		/* dbg_msg(GGZ_DBG_STATS,
+		/* int team = num_teams > 0 ? player_teams[i] : i;
+		dbg_msg(GGZ_DBG_STATS,
 			"Player %d has rating %f, expectation %f.", i,
 			team_ratings[team], team_probs[team]); */
 	}
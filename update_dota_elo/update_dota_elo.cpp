@@ -165,7 +165,7 @@ int main( int argc, char **argv )
 	cout << "creating tables" << endl;
 
 	string QCreate1 = "CREATE TABLE IF NOT EXISTS dota_elo_scores ( id INT NOT NULL AUTO_INCREMENT PRIMARY KEY, name VARCHAR(15) NOT NULL, server VARCHAR(100) NOT NULL, score REAL NOT NULL )";
-	string QCreate2 = "CREATE TABLE IF NOT EXISTS dota_elo_games_scored ( id INT NOT NULL AUTO_INCREMENT PRIMARY KEY, gameid INT NOT NULL )";
+	string QCreate2 = "CREATE TABLE IF NOT EXISTS dota_elo_games_scored ( id INT NOT NULL AUTO_INCREMENT PRIMARY KEY, gameid INT NOT NULL, UNIQUE INDEX gameid ( gameid ) )";
 
 	if( mysql_real_query( Connection, QCreate1.c_str( ), QCreate1.size( ) ) != 0 )
 	{
@@ -179,6 +179,56 @@ int main( int argc, char **argv )
 		return 1;
 	}
 
+	// the unique index on gameid stops us and the bot (which scores games as soon as they end) from scoring the same game twice
+	// older versions of update_dota_elo created the table without it so add it now, any duplicate rows have to go first or adding the index fails
+
+	string QIndex = "SHOW INDEX FROM dota_elo_games_scored WHERE Column_name='gameid' AND Non_unique=0";
+
+	if( mysql_real_query( Connection, QIndex.c_str( ), QIndex.size( ) ) != 0 )
+	{
+		cout << "error: " << mysql_error( Connection ) << endl;
+		return 1;
+	}
+	else
+	{
+		MYSQL_RES *Result = mysql_store_result( Connection );
+
+		if( Result )
+		{
+			bool HasIndex = mysql_num_rows( Result ) > 0;
+			mysql_free_result( Result );
+
+			if( !HasIndex )
+			{
+				cout << "adding a unique index to dota_elo_games_scored" << endl;
+
+				string QDeleteDuplicates = "DELETE a FROM dota_elo_games_scored a JOIN dota_elo_games_scored b ON a.gameid=b.gameid AND a.id>b.id";
+				string QAddIndex = "ALTER TABLE dota_elo_games_scored ADD UNIQUE INDEX gameid ( gameid )";
+
+				// ER_DUP_KEYNAME (1061) means the bot added the index in the meantime
+
+				if( mysql_real_query( Connection, QDeleteDuplicates.c_str( ), QDeleteDuplicates.size( ) ) != 0 || ( mysql_real_query( Connection, QAddIndex.c_str( ), QAddIndex.size( ) ) != 0 && mysql_errno( Connection ) != 1061 ) )
+				{
+					cout << "error: " << mysql_error( Connection ) << endl;
+					return 1;
+				}
+
+				// ALTER TABLE commits implicitly so start a new transaction
+
+				if( mysql_real_query( Connection, QBegin.c_str( ), QBegin.size( ) ) != 0 )
+				{
+					cout << "error: " << mysql_error( Connection ) << endl;
+					return 1;
+				}
+			}
+		}
+		else
+		{
+			cout << "error: " << mysql_error( Connection ) << endl;
+			return 1;
+		}
+	}
+
 	cout << "getting unscored games" << endl;
 	queue<uint32_t> UnscoredGames;
 
@@ -219,6 +269,22 @@ int main( int argc, char **argv )
 		uint32_t GameID = UnscoredGames.front( );
 		UnscoredGames.pop( );
 
+		// claim the game first, no row is inserted if the bot has scored it since we got the list of unscored games
+
+		string QInsertScored = "INSERT IGNORE INTO dota_elo_games_scored ( gameid ) VALUES ( " + UTIL_ToString( GameID ) + " )";
+
+		if( mysql_real_query( Connection, QInsertScored.c_str( ), QInsertScored.size( ) ) != 0 )
+		{
+			cout << "error: " << mysql_error( Connection ) << endl;
+			return 1;
+		}
+
+		if( mysql_affected_rows( Connection ) == 0 )
+		{
+			cout << "gameid " << UTIL_ToString( GameID ) << " has already been scored, ignoring" << endl;
+			continue;
+		}
+
 		string QSelectPlayers = "SELECT dota_elo_scores.id, gameplayers.name, spoofedrealm, newcolour, winner, score FROM dotaplayers LEFT JOIN dotagames ON dotagames.gameid=dotaplayers.gameid LEFT JOIN gameplayers ON gameplayers.gameid=dotaplayers.gameid AND gameplayers.colour=dotaplayers.colour LEFT JOIN dota_elo_scores ON dota_elo_scores.name=gameplayers.name AND server=spoofedrealm WHERE dotaplayers.gameid=" + UTIL_ToString( GameID );
 
 		if( mysql_real_query( Connection, QSelectPlayers.c_str( ), QSelectPlayers.size( ) ) != 0 )
@@ -382,14 +448,6 @@ int main( int argc, char **argv )
 				return 1;
 			}
 		}
-
-		string QInsertScored = "INSERT INTO dota_elo_games_scored ( gameid ) VALUES ( " + UTIL_ToString( GameID ) + " )";
-
-		if( mysql_real_query( Connection, QInsertScored.c_str( ), QInsertScored.size( ) ) != 0 )
-		{
-			cout << "error: " << mysql_error( Connection ) << endl;
-			return 1;
-		}
 	}
 
 	cout << "copying dota elo scores to scores table" << endl;
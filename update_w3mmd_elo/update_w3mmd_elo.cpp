@@ -18,6 +18,7 @@
 
 */
 
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 #include <map>
@@ -45,6 +46,8 @@ using namespace std;
 
 #include <mysql/mysql.h>
 
+#include <boost/thread.hpp>
+
 void CONSOLE_Print( string message )
 {
 	cout << message << endl;
@@ -118,6 +121,416 @@ float UTIL_ToFloat( string &s )
 	return result;
 }
 
+//
+// recompute mode
+//
+
+// scoring the unscored games one query at a time takes hours when every game has to be (re)scored, e.g. after changing the formula or adding a category
+// the recompute mode rebuilds the ratings of one or more categories from scratch instead:
+//  1. every w3mmdplayers row is loaded with a single streaming query into compact per category arrays
+//  2. the games of each category are replayed in order (by gameid) starting from 1000, with the categories spread over several threads
+//  3. the ratings are written back with multi row inserts and every game up to the last one loaded is marked as scored
+// the same rules as scoring a single game are used (drawers and practicing players are ignored, every player is their own team, etc...)
+
+#define W3MMD_WINNER		1
+#define W3MMD_DRAWER		2
+#define W3MMD_PRACTICING	4
+
+class CRecomputeCategory
+{
+public:
+	string m_Category;
+	vector<uint32_t> m_GameIDs;				// the gameid of each row
+	vector<uint32_t> m_PlayerIDs;			// the player of each row (an index into m_Names and m_Servers)
+	vector<unsigned char> m_Flags;			// the W3MMD_ flags of each row
+	map<string, uint32_t> m_PlayerIndex;	// "name server" -> player
+	vector<string> m_Names;
+	vector<string> m_Servers;
+	vector<float> m_Ratings;				// the rating of each player after the replay
+	vector<bool> m_Rated;					// whether each player was in at least one scored game
+	uint32_t m_GamesScored;
+
+	CRecomputeCategory( string nCategory ) : m_Category( nCategory ), m_GamesScored( 0 ) { }
+
+	void AddRow( uint32_t gameid, string name, string server, unsigned char flags );
+	void Replay( );
+};
+
+class CRecomputeRowOrder
+{
+public:
+	vector<uint32_t> *m_GameIDs;
+
+	CRecomputeRowOrder( vector<uint32_t> *nGameIDs ) : m_GameIDs( nGameIDs ) { }
+	bool operator( )( uint32_t a, uint32_t b ) const	{ return (*m_GameIDs)[a] < (*m_GameIDs)[b]; }
+};
+
+void CRecomputeCategory :: AddRow( uint32_t gameid, string name, string server, unsigned char flags )
+{
+	string Key = name + " " + server;
+	map<string, uint32_t> :: iterator i = m_PlayerIndex.find( Key );
+	uint32_t PlayerID;
+
+	if( i == m_PlayerIndex.end( ) )
+	{
+		PlayerID = m_Names.size( );
+		m_PlayerIndex[Key] = PlayerID;
+		m_Names.push_back( name );
+		m_Servers.push_back( server );
+	}
+	else
+		PlayerID = i->second;
+
+	m_GameIDs.push_back( gameid );
+	m_PlayerIDs.push_back( PlayerID );
+	m_Flags.push_back( flags );
+}
+
+void CRecomputeCategory :: Replay( )
+{
+	m_Ratings.assign( m_Names.size( ), 1000.0 );
+	m_Rated.assign( m_Names.size( ), false );
+	m_GamesScored = 0;
+
+	// the rows arrive in no particular order so sort them by gameid (the rows of each game keep their original order)
+
+	vector<uint32_t> Order( m_GameIDs.size( ) );
+
+	for( uint32_t i = 0; i < Order.size( ); i++ )
+		Order[i] = i;
+
+	stable_sort( Order.begin( ), Order.end( ), CRecomputeRowOrder( &m_GameIDs ) );
+
+	uint32_t Start = 0;
+
+	while( Start < Order.size( ) )
+	{
+		uint32_t End = Start;
+
+		while( End < Order.size( ) && m_GameIDs[Order[End]] == m_GameIDs[Order[Start]] )
+			End++;
+
+		bool ignore = false;
+		bool winner = false;
+		uint32_t players[12];
+		int num_players = 0;
+		float player_ratings[12];
+		int player_teams[12];
+		float team_ratings[12];
+		float team_winners[12];
+
+		for( uint32_t i = Start; i < End; i++ )
+		{
+			unsigned char Flags = m_Flags[Order[i]];
+
+			if( Flags & ( W3MMD_DRAWER | W3MMD_PRACTICING ) )
+				continue;
+
+			if( num_players >= 12 )
+			{
+				ignore = true;
+				break;
+			}
+
+			if( Flags & W3MMD_WINNER )
+				winner = true;
+
+			players[num_players] = m_PlayerIDs[Order[i]];
+			player_ratings[num_players] = m_Ratings[players[num_players]];
+			player_teams[num_players] = num_players;
+			team_ratings[num_players] = player_ratings[num_players];
+			team_winners[num_players] = ( Flags & W3MMD_WINNER ) ? 1.0 : 0.0;
+			num_players++;
+		}
+
+		if( !ignore && num_players > 0 && winner )
+		{
+			elo_recalculate_ratings( num_players, player_ratings, player_teams, num_players, team_ratings, team_winners );
+
+			// the incremental mode stores each rating with 2 decimals and reads it back for the next game so round them the same way here
+			// otherwise the rounding errors add up differently over thousands of games and the two modes end up with different ratings
+
+			for( int i = 0; i < num_players; i++ )
+			{
+				string Rating = UTIL_ToString( player_ratings[i], 2 );
+				m_Ratings[players[i]] = UTIL_ToFloat( Rating );
+				m_Rated[players[i]] = true;
+			}
+
+			m_GamesScored++;
+		}
+
+		Start = End;
+	}
+
+	// the rows aren't needed anymore, free them now since the other categories might still be replaying
+
+	vector<uint32_t>( ).swap( m_GameIDs );
+	vector<uint32_t>( ).swap( m_PlayerIDs );
+	vector<unsigned char>( ).swap( m_Flags );
+}
+
+class CRecomputeWorker
+{
+public:
+	vector<CRecomputeCategory *> *m_Categories;
+	uint32_t *m_NextCategory;				// the next category to be replayed by any worker
+	boost :: mutex *m_Mutex;				// protects m_NextCategory
+
+	CRecomputeWorker( vector<CRecomputeCategory *> *nCategories, uint32_t *nNextCategory, boost :: mutex *nMutex ) : m_Categories( nCategories ), m_NextCategory( nNextCategory ), m_Mutex( nMutex ) { }
+
+	void operator( )( )
+	{
+		while( true )
+		{
+			CRecomputeCategory *Category = NULL;
+
+			{
+				boost :: mutex :: scoped_lock Lock( *m_Mutex );
+
+				if( *m_NextCategory < m_Categories->size( ) )
+					Category = (*m_Categories)[(*m_NextCategory)++];
+			}
+
+			if( !Category )
+				return;
+
+			Category->Replay( );
+		}
+	}
+};
+
+bool CompareCategorySize( CRecomputeCategory *a, CRecomputeCategory *b )
+{
+	return a->m_GameIDs.size( ) > b->m_GameIDs.size( );
+}
+
+bool MySQLQuery( MYSQL *conn, string query )
+{
+	if( mysql_real_query( conn, query.c_str( ), query.size( ) ) != 0 )
+	{
+		cout << "error: " << mysql_error( conn ) << endl;
+		return false;
+	}
+
+	return true;
+}
+
+int Recompute( MYSQL *Connection, vector<string> Categories, uint32_t Threads )
+{
+	// only load games up to the last game that exists right now so we know exactly which games to mark as scored
+
+	cout << "getting last game" << endl;
+	string MaxGameID = "0";
+	string QSelectMax = "SELECT MAX(id) FROM games";
+
+	if( !MySQLQuery( Connection, QSelectMax ) )
+		return 1;
+
+	MYSQL_RES *MaxResult = mysql_store_result( Connection );
+
+	if( !MaxResult )
+	{
+		cout << "error: " << mysql_error( Connection ) << endl;
+		return 1;
+	}
+
+	vector<string> MaxRow = MySQLFetchRow( MaxResult );
+
+	if( !MaxRow.empty( ) && !MaxRow[0].empty( ) )
+		MaxGameID = MaxRow[0];
+
+	mysql_free_result( MaxResult );
+
+	// load every player row, streaming them (mysql_use_result) so the whole result set never has to be held by the client library
+	// the name comes from gameplayers exactly like in the incremental mode so both modes rate the same (name, server) pairs
+
+	map<string, CRecomputeCategory *> CategoryMap;
+	string QSelectPlayers = "SELECT w3mmdplayers.category, w3mmdplayers.gameid, LOWER(gameplayers.name), spoofedrealm, flag, practicing FROM w3mmdplayers LEFT JOIN gameplayers ON gameplayers.gameid=w3mmdplayers.gameid AND LOWER(gameplayers.name)=LOWER(w3mmdplayers.name) WHERE w3mmdplayers.gameid<=" + MaxGameID;
+
+	if( !Categories.empty( ) )
+	{
+		QSelectPlayers += " AND w3mmdplayers.category IN ( ";
+
+		for( vector<string> :: iterator i = Categories.begin( ); i != Categories.end( ); i++ )
+		{
+			if( i != Categories.begin( ) )
+				QSelectPlayers += ", ";
+
+			QSelectPlayers += "'" + MySQLEscapeString( Connection, *i ) + "'";
+			CategoryMap[*i] = new CRecomputeCategory( *i );
+		}
+
+		QSelectPlayers += " )";
+	}
+
+	cout << "loading players of games up to gameid " << MaxGameID << endl;
+
+	if( !MySQLQuery( Connection, QSelectPlayers ) )
+		return 1;
+
+	MYSQL_RES *Result = mysql_use_result( Connection );
+
+	if( !Result )
+	{
+		cout << "error: " << mysql_error( Connection ) << endl;
+		return 1;
+	}
+
+	uint32_t NumRows = 0;
+	CRecomputeCategory *LastCategory = NULL;
+	MYSQL_ROW Row;
+
+	while( ( Row = mysql_fetch_row( Result ) ) )
+	{
+		// Row[0] = category
+		// Row[1] = gameid
+		// Row[2] = name
+		// Row[3] = server
+		// Row[4] = flag
+		// Row[5] = practicing
+
+		if( !Row[0] || !Row[1] )
+			continue;
+
+		if( !LastCategory || LastCategory->m_Category != Row[0] )
+		{
+			map<string, CRecomputeCategory *> :: iterator i = CategoryMap.find( Row[0] );
+
+			if( i == CategoryMap.end( ) )
+			{
+				LastCategory = new CRecomputeCategory( Row[0] );
+				CategoryMap[Row[0]] = LastCategory;
+			}
+			else
+				LastCategory = i->second;
+		}
+
+		unsigned char Flags = 0;
+
+		if( Row[4] && strcmp( Row[4], "winner" ) == 0 )
+			Flags |= W3MMD_WINNER;
+		else if( Row[4] && strcmp( Row[4], "drawer" ) == 0 )
+			Flags |= W3MMD_DRAWER;
+
+		if( Row[5] && strcmp( Row[5], "1" ) == 0 )
+			Flags |= W3MMD_PRACTICING;
+
+		LastCategory->AddRow( strtoul( Row[1], NULL, 10 ), Row[2] ? Row[2] : string( ), Row[3] ? Row[3] : string( ), Flags );
+		NumRows++;
+
+		if( NumRows % 1000000 == 0 )
+			cout << "loaded " << NumRows << " rows" << endl;
+	}
+
+	if( mysql_errno( Connection ) != 0 )
+	{
+		cout << "error: " << mysql_error( Connection ) << endl;
+		mysql_free_result( Result );
+		return 1;
+	}
+
+	mysql_free_result( Result );
+	cout << "loaded " << NumRows << " rows in " << CategoryMap.size( ) << " categories" << endl;
+
+	// replay the categories in parallel, starting with the biggest ones so one big category doesn't end up running alone at the end
+
+	vector<CRecomputeCategory *> CategoryList;
+
+	for( map<string, CRecomputeCategory *> :: iterator i = CategoryMap.begin( ); i != CategoryMap.end( ); i++ )
+		CategoryList.push_back( i->second );
+
+	sort( CategoryList.begin( ), CategoryList.end( ), CompareCategorySize );
+
+	if( Threads == 0 )
+		Threads = boost :: thread :: hardware_concurrency( );
+
+	if( Threads == 0 )
+		Threads = 1;
+
+	if( Threads > CategoryList.size( ) )
+		Threads = CategoryList.size( );
+
+	cout << "replaying games using " << Threads << " threads" << endl;
+	uint32_t NextCategory = 0;
+	boost :: mutex Mutex;
+	vector<boost :: thread *> Workers;
+
+	for( uint32_t i = 0; i < Threads; i++ )
+		Workers.push_back( new boost :: thread( CRecomputeWorker( &CategoryList, &NextCategory, &Mutex ) ) );
+
+	for( vector<boost :: thread *> :: iterator i = Workers.begin( ); i != Workers.end( ); i++ )
+	{
+		(*i)->join( );
+		delete *i;
+	}
+
+	// write the results back, the whole rebuild is done in the transaction started by the caller
+
+	for( vector<CRecomputeCategory *> :: iterator i = CategoryList.begin( ); i != CategoryList.end( ); i++ )
+	{
+		CRecomputeCategory *Category = *i;
+		string EscCategory = MySQLEscapeString( Connection, Category->m_Category );
+		uint32_t NumRated = 0;
+		cout << "category [" << Category->m_Category << "] scored " << Category->m_GamesScored << " games, writing ratings" << endl;
+
+		if( !MySQLQuery( Connection, "DELETE FROM w3mmd_elo_scores WHERE category='" + EscCategory + "'" ) )
+			return 1;
+
+		// insert the ratings in batches so each statement stays well below max_allowed_packet
+
+		string QInsertScores;
+
+		for( uint32_t j = 0; j < Category->m_Names.size( ); j++ )
+		{
+			if( !Category->m_Rated[j] )
+				continue;
+
+			if( QInsertScores.empty( ) )
+				QInsertScores = "INSERT INTO w3mmd_elo_scores ( category, name, server, score ) VALUES ";
+			else
+				QInsertScores += ", ";
+
+			QInsertScores += "( '" + EscCategory + "', '" + MySQLEscapeString( Connection, Category->m_Names[j] ) + "', '" + MySQLEscapeString( Connection, Category->m_Servers[j] ) + "', " + UTIL_ToString( Category->m_Ratings[j], 2 ) + " )";
+			NumRated++;
+
+			if( QInsertScores.size( ) > 512 * 1024 )
+			{
+				if( !MySQLQuery( Connection, QInsertScores ) )
+					return 1;
+
+				QInsertScores.clear( );
+			}
+		}
+
+		if( !QInsertScores.empty( ) && !MySQLQuery( Connection, QInsertScores ) )
+			return 1;
+
+		if( !MySQLQuery( Connection, "DELETE FROM w3mmd_elo_games_scored WHERE category='" + EscCategory + "'" ) )
+			return 1;
+
+		if( !MySQLQuery( Connection, "INSERT INTO w3mmd_elo_games_scored ( category, gameid ) SELECT '" + EscCategory + "', id FROM games WHERE id<=" + MaxGameID ) )
+			return 1;
+
+		if( !MySQLQuery( Connection, "DELETE FROM scores WHERE category='" + EscCategory + "'" ) )
+			return 1;
+
+		if( !MySQLQuery( Connection, "INSERT INTO scores ( category, name, server, score ) SELECT category, name, server, score FROM w3mmd_elo_scores WHERE category='" + EscCategory + "'" ) )
+			return 1;
+
+		cout << "category [" << Category->m_Category << "] wrote " << NumRated << " ratings" << endl;
+		delete Category;
+	}
+
+	cout << "committing transaction" << endl;
+
+	if( !MySQLQuery( Connection, "COMMIT" ) )
+		return 1;
+
+	cout << "done" << endl;
+	return 0;
+}
+
 int main( int argc, char **argv )
 {
 	string CFGFile = "update_w3mmd_elo.cfg";
@@ -133,8 +546,10 @@ int main( int argc, char **argv )
 	string Password = CFG.GetString( "db_mysql_password", string( ) );
 	int Port = CFG.GetInt( "db_mysql_port", 0 );
 	string Category = CFG.GetString( "update_category", string( ) );
+	bool Recomputing = CFG.GetInt( "update_recompute", 0 ) != 0;
+	uint32_t Threads = CFG.GetInt( "update_threads", 0 );
 
-	if( Category.empty( ) )
+	if( Category.empty( ) && !Recomputing )
 	{
 		cout << "no update_category specified in config file" << endl;
 		return 1;
@@ -186,6 +601,20 @@ int main( int argc, char **argv )
 		return 1;
 	}
 
+	if( Recomputing )
+	{
+		// in recompute mode update_category is a space separated list of categories (empty means every category)
+
+		vector<string> Categories;
+		istringstream SS( Category );
+		string Token;
+
+		while( SS >> Token )
+			Categories.push_back( Token );
+
+		return Recompute( Connection, Categories, Threads );
+	}
+
 	cout << "getting unscored games" << endl;
 	queue<uint32_t> UnscoredGames;
 